@@ -0,0 +1,359 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/bench/executor/executorBench.cpp - Executor benchmarks ---===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the benchmarks of the execution: the interpreter
+/// throughput with and without the metering, the threaded code against the
+/// switch loop of the interpreter, the per-opcode microbenchmarks, the host function call round trip of the interpreter, the
+/// JIT, and the AOT, the memory access throughput of the 32-bit and the
+/// 64-bit memories, the module instantiation latency, and the allocation
+/// throughput and the collection pauses of the GC objects.
+///
+//===----------------------------------------------------------------------===//
+
+#include "common/configure.h"
+#include "common/defines.h"
+#include "common/filesystem.h"
+#include "common/spdlog.h"
+#include "executor/executor.h"
+#include "loader/loader.h"
+#include "runtime/hostfunc.h"
+#include "runtime/instance/module.h"
+#include "runtime/storemgr.h"
+#include "validator/validator.h"
+#include "vm/vm.h"
+
+#ifdef WASMEDGE_USE_LLVM
+#include "llvm/codegen.h"
+#include "llvm/compiler.h"
+#endif
+
+#include "../helper.h"
+
+#include <array>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using namespace std::literals;
+using namespace WasmEdge;
+
+constexpr uint32_t LoopIterations = 1U << 20;
+
+enum class Metering : uint8_t {
+  None,
+  /// Counting and charging every instruction.
+  PerInstruction,
+  /// Counting and charging per basic block.
+  Batched,
+};
+
+Configure makeConf(Metering M, bool JIT) {
+  Configure Conf;
+  if (M != Metering::None) {
+    Conf.getStatisticsConfigure().setInstructionCounting(true);
+    Conf.getStatisticsConfigure().setCostMeasuring(true);
+    Conf.getStatisticsConfigure().setBatchedMetering(M == Metering::Batched);
+  }
+  if (JIT) {
+    Conf.getRuntimeConfigure().setEnableJIT(true);
+    Conf.getCompilerConfigure().setOptimizationLevel(
+        CompilerConfigure::OptimizationLevel::O1);
+  }
+  return Conf;
+}
+
+class HostIncrement : public Runtime::HostFunction<HostIncrement> {
+public:
+  Expect<uint32_t> body(const Runtime::CallingFrame &, uint32_t Value) {
+    return Value + 1;
+  }
+};
+
+/// Invoke the function with the iteration count of its loop, and report the
+/// iterations per second.
+void runLoop(benchmark::State &State, VM::VM &VM, std::string_view Func) {
+  const std::array<ValVariant, 1> Params = {LoopIterations};
+  const std::array<ValType, 1> ParamTypes = {ValType(TypeCode::I32)};
+  for (auto _ : State) {
+    if (auto Res = VM.execute(Func, Params, ParamTypes); !Res) {
+      State.SkipWithError("execution failed");
+      return;
+    }
+  }
+  State.SetItemsProcessed(static_cast<int64_t>(State.iterations()) *
+                          LoopIterations);
+}
+
+bool prepare(benchmark::State &State, VM::VM &VM,
+             const std::vector<uint8_t> &Wasm) {
+  if (!VM.loadWasm(Wasm) || !VM.validate() || !VM.instantiate()) {
+    State.SkipWithError("instantiation failed");
+    return false;
+  }
+  return true;
+}
+
+void BM_Loop(benchmark::State &State, Metering M, bool JIT) {
+  VM::VM VM(makeConf(M, JIT));
+  if (prepare(State, VM, Bench::makeLoopModule())) {
+    runLoop(State, VM, "bench"sv);
+  }
+}
+
+/// Dispatch of the interpreter without the statistics.
+enum class Dispatch : uint8_t {
+  /// The register code of the lowered functions.
+  Register,
+  /// The threaded code of the stack machine.
+  Threaded,
+  /// The switch loop of the stack machine.
+  Switch,
+};
+
+/// Compare the register code, the threaded code, and the switch loop of the
+/// interpreter, and report the instructions per second counted by a separate
+/// invocation.
+void BM_Dispatch(benchmark::State &State, Dispatch D) {
+  const auto Wasm = Bench::makeDispatchModule();
+  uint64_t Instrs = 0;
+  {
+    Configure Conf = makeConf(Metering::None, false);
+    Conf.getStatisticsConfigure().setInstructionCounting(true);
+    VM::VM VM(Conf);
+    if (!prepare(State, VM, Wasm) ||
+        !VM.execute("bench"sv, std::array<ValVariant, 1>{LoopIterations},
+                    std::array<ValType, 1>{ValType(TypeCode::I32)})) {
+      return;
+    }
+    Instrs = VM.getStatistics().getInstrCount();
+  }
+  Configure Conf = makeConf(Metering::None, false);
+  Conf.getRuntimeConfigure().setEnableRegisterInterpreter(D ==
+                                                         Dispatch::Register);
+  Conf.getRuntimeConfigure().setEnableThreadedInterpreter(D !=
+                                                         Dispatch::Switch);
+  VM::VM VM(Conf);
+  if (prepare(State, VM, Wasm)) {
+    runLoop(State, VM, "bench"sv);
+    State.counters["Instrs"] = benchmark::Counter(
+        static_cast<double>(Instrs) * static_cast<double>(State.iterations()),
+        benchmark::Counter::kIsRate);
+  }
+}
+
+void BM_Opcode(benchmark::State &State, const std::string &Name) {
+  VM::VM VM(makeConf(Metering::None, false));
+  if (prepare(State, VM, Bench::makeOpcodeModule())) {
+    runLoop(State, VM, Name);
+  }
+}
+
+void BM_HostCall(benchmark::State &State, Metering M, bool JIT) {
+  Runtime::Instance::ModuleInstance HostMod("env"sv);
+  HostMod.addHostFunc("host"sv, std::make_unique<HostIncrement>());
+  VM::VM VM(makeConf(M, JIT));
+  if (!VM.registerModule(HostMod)) {
+    State.SkipWithError("registration failed");
+    return;
+  }
+  if (prepare(State, VM, Bench::makeHostCallModule())) {
+    runLoop(State, VM, "bench"sv);
+  }
+}
+
+/// The accesses of the 64-bit memories are bound checked explicitly instead
+/// of by the guard regions.
+void BM_Memory(benchmark::State &State, bool Is64, bool JIT) {
+  Configure Conf = makeConf(Metering::None, JIT);
+  Conf.addProposal(Proposal::Memory64);
+  VM::VM VM(Conf);
+  if (prepare(State, VM, Bench::makeMemoryModule(Is64))) {
+    runLoop(State, VM, "bench"sv);
+  }
+}
+
+#ifdef WASMEDGE_USE_LLVM
+void BM_HostCallAOT(benchmark::State &State) {
+  // Compile the module into a shared library in the temporary directory.
+  Configure Conf = makeConf(Metering::None, false);
+  Conf.getCompilerConfigure().setOptimizationLevel(
+      CompilerConfigure::OptimizationLevel::O1);
+  const auto Wasm = Bench::makeHostCallModule();
+  const auto Path = std::filesystem::temp_directory_path() /
+                    ("wasmedge-host-call-bench"s + WASMEDGE_LIB_EXTENSION);
+  {
+    Loader::Loader Loader(Conf);
+    Validator::Validator Validator(Conf);
+    LLVM::Compiler Compiler(Conf);
+    LLVM::CodeGen CodeGen(Conf);
+    auto Mod = Loader.parseModule(Wasm);
+    if (!Mod || !Validator.validate(**Mod)) {
+      State.SkipWithError("validation failed");
+      return;
+    }
+    auto Data = Compiler.compile(**Mod);
+    if (!Data || !CodeGen.codegen(Wasm, std::move(*Data), Path)) {
+      State.SkipWithError("compilation failed");
+      return;
+    }
+  }
+
+  Runtime::Instance::ModuleInstance HostMod("env"sv);
+  HostMod.addHostFunc("host"sv, std::make_unique<HostIncrement>());
+  VM::VM VM(Conf);
+  if (!VM.registerModule(HostMod)) {
+    State.SkipWithError("registration failed");
+  } else if (!VM.loadWasm(Path) || !VM.validate() || !VM.instantiate()) {
+    State.SkipWithError("instantiation failed");
+  } else {
+    runLoop(State, VM, "bench"sv);
+  }
+  VM.cleanup();
+  std::error_code Error;
+  std::filesystem::remove(Path, Error);
+}
+#endif
+
+void BM_Instantiate(benchmark::State &State) {
+  const Configure Conf;
+  Loader::Loader Loader(Conf);
+  Validator::Validator Validator(Conf);
+  Executor::Executor Executor(Conf);
+  Runtime::StoreManager Store;
+  const auto Wasm =
+      Bench::makeLargeModule(static_cast<uint32_t>(State.range(0)));
+  auto Mod = Loader.parseModule(Wasm);
+  if (!Mod || !Validator.validate(**Mod)) {
+    State.SkipWithError("validation failed");
+    return;
+  }
+  for (auto _ : State) {
+    auto ModInst = Executor.instantiateModule(Store, **Mod);
+    if (!ModInst) {
+      State.SkipWithError("instantiation failed");
+      return;
+    }
+    // Destroy the instance in the measurement.
+    ModInst->reset();
+  }
+}
+
+/// Instantiate and destroy a module with a memory on every thread, which
+/// stresses the reservation and the release of the linear memories. The pool
+/// is process-wide and never released, so the pooled variant is registered
+/// after the unpooled one.
+void BM_InstantiateChurn(benchmark::State &State, bool Pooled) {
+  Configure Conf;
+  if (Pooled) {
+    Conf.getRuntimeConfigure().setMemoryPoolSize(64);
+  }
+  Loader::Loader Loader(Conf);
+  Validator::Validator Validator(Conf);
+  Executor::Executor Executor(Conf);
+  Runtime::StoreManager Store;
+  auto Mod = Loader.parseModule(Bench::makeMemoryModule(false));
+  if (!Mod || !Validator.validate(**Mod)) {
+    State.SkipWithError("validation failed");
+    return;
+  }
+  for (auto _ : State) {
+    auto ModInst = Executor.instantiateModule(Store, **Mod);
+    if (!ModInst) {
+      State.SkipWithError("instantiation failed");
+      return;
+    }
+    ModInst->reset();
+  }
+  State.SetItemsProcessed(static_cast<int64_t>(State.iterations()));
+}
+
+/// Allocate the GC objects in the function, and report the collections and
+/// their pauses in the measurement.
+void BM_GC(benchmark::State &State, std::string_view Func) {
+  Configure Conf;
+  Conf.addProposal(Proposal::GC);
+  VM::VM VM(Conf);
+  if (!prepare(State, VM, Bench::makeGCModule())) {
+    return;
+  }
+  auto &GC = Executor::Collector::getInstance();
+  const auto Before = GC.getStatistics();
+  runLoop(State, VM, Func);
+  const auto After = GC.getStatistics();
+  const auto Count = static_cast<double>(
+      After.MinorCount + After.FullCount - Before.MinorCount - Before.FullCount);
+  State.counters["MinorGCs"] =
+      static_cast<double>(After.MinorCount - Before.MinorCount);
+  State.counters["FullGCs"] =
+      static_cast<double>(After.FullCount - Before.FullCount);
+  State.counters["AvgPauseUs"] =
+      Count > 0
+          ? static_cast<double>(After.TotalPauseNs - Before.TotalPauseNs) /
+                Count / 1000.0
+          : 0.0;
+  State.counters["MaxPauseUs"] = static_cast<double>(After.MaxPauseNs) / 1000.0;
+  State.counters["LiveKiB"] = static_cast<double>(After.LiveBytes) / 1024.0;
+}
+
+BENCHMARK_CAPTURE(BM_Loop, Interpreter, Metering::None, false);
+BENCHMARK_CAPTURE(BM_Loop, InterpreterMetered, Metering::PerInstruction,
+                  false);
+BENCHMARK_CAPTURE(BM_Loop, InterpreterBatchedMetered, Metering::Batched,
+                  false);
+BENCHMARK_CAPTURE(BM_Dispatch, Register, Dispatch::Register);
+BENCHMARK_CAPTURE(BM_Dispatch, Threaded, Dispatch::Threaded);
+BENCHMARK_CAPTURE(BM_Dispatch, Switch, Dispatch::Switch);
+BENCHMARK_CAPTURE(BM_HostCall, Interpreter, Metering::None, false);
+BENCHMARK_CAPTURE(BM_HostCall, InterpreterMetered, Metering::PerInstruction,
+                  false);
+BENCHMARK_CAPTURE(BM_Memory, Interpreter32, false, false);
+BENCHMARK_CAPTURE(BM_Memory, Interpreter64, true, false);
+#ifdef WASMEDGE_USE_LLVM
+BENCHMARK_CAPTURE(BM_Loop, JIT, Metering::None, true);
+BENCHMARK_CAPTURE(BM_Loop, JITMetered, Metering::PerInstruction, true);
+BENCHMARK_CAPTURE(BM_Loop, JITBatchedMetered, Metering::Batched, true);
+BENCHMARK_CAPTURE(BM_HostCall, JIT, Metering::None, true);
+BENCHMARK_CAPTURE(BM_Memory, JIT32, false, true);
+BENCHMARK_CAPTURE(BM_Memory, JIT64, true, true);
+BENCHMARK(BM_HostCallAOT);
+#endif
+BENCHMARK(BM_Instantiate)->Arg(1)->Arg(64)->Arg(1024);
+BENCHMARK_CAPTURE(BM_InstantiateChurn, Individual, false)
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_InstantiateChurn, Pooled, true)
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_GC, Alloc, "alloc"sv)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_GC, Retain, "retain"sv)->Unit(benchmark::kMillisecond);
+
+} // namespace
+
+int main(int Argc, char **Argv) {
+  // Keep the statistics dumps of the metered runs out of the reports.
+  spdlog::set_level(spdlog::level::warn);
+  // The per-opcode microbenchmarks are named by the exported functions.
+  for (const auto &Name : Bench::getOpcodeBenchNames()) {
+    benchmark::RegisterBenchmark(("BM_Opcode/" + Name).c_str(), BM_Opcode,
+                                 Name);
+  }
+  benchmark::Initialize(&Argc, Argv);
+  if (benchmark::ReportUnrecognizedArguments(Argc, Argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,606 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "helper.h"
+#include "aot/version.h"
+
+#include <cstring>
+#include <utility>
+
+namespace WasmEdge {
+namespace Bench {
+
+using namespace std::literals;
+
+namespace {
+
+constexpr uint8_t I32 = 0x7F;
+constexpr uint8_t I64 = 0x7E;
+constexpr uint8_t F32 = 0x7D;
+constexpr uint8_t F64 = 0x7C;
+
+void writeName(std::vector<uint8_t> &Out, std::string_view Name) {
+  writeU32(Out, static_cast<uint32_t>(Name.size()));
+  Out.insert(Out.end(), Name.begin(), Name.end());
+}
+
+void writeU64(std::vector<uint8_t> &Out, uint64_t Value) {
+  do {
+    uint8_t Byte = Value & 0x7F;
+    Value >>= 7;
+    if (Value != 0) {
+      Byte |= 0x80;
+    }
+    Out.push_back(Byte);
+  } while (Value != 0);
+}
+
+void writeSection(std::vector<uint8_t> &Out, uint8_t Id,
+                  const std::vector<std::vector<uint8_t>> &Items) {
+  if (Items.empty()) {
+    return;
+  }
+  std::vector<uint8_t> Content;
+  writeU32(Content, static_cast<uint32_t>(Items.size()));
+  for (const auto &Item : Items) {
+    Content.insert(Content.end(), Item.begin(), Item.end());
+  }
+  Out.push_back(Id);
+  writeU32(Out, static_cast<uint32_t>(Content.size()));
+  Out.insert(Out.end(), Content.begin(), Content.end());
+}
+
+/// Append the `T.const` instruction of the value type.
+void writeConst(std::vector<uint8_t> &Out, uint8_t Type, int32_t Value) {
+  switch (Type) {
+  case I32:
+    Out.push_back(0x41);
+    writeS64(Out, Value);
+    break;
+  case I64:
+    Out.push_back(0x42);
+    writeS64(Out, Value);
+    break;
+  case F32: {
+    const float F = static_cast<float>(Value);
+    uint8_t Bytes[sizeof(F)];
+    std::memcpy(Bytes, &F, sizeof(F));
+    Out.push_back(0x43);
+    Out.insert(Out.end(), Bytes, Bytes + sizeof(F));
+    break;
+  }
+  case F64: {
+    const double D = static_cast<double>(Value);
+    uint8_t Bytes[sizeof(D)];
+    std::memcpy(Bytes, &D, sizeof(D));
+    Out.push_back(0x44);
+    Out.insert(Out.end(), Bytes, Bytes + sizeof(D));
+    break;
+  }
+  default:
+    break;
+  }
+}
+
+/// Per-opcode microbenchmark. The unary and binary opcodes are applied to the
+/// accumulator local, and the raw snippets are inserted as they are.
+struct OpcodeBench {
+  enum class Kind : uint8_t { Unary, Binary, Raw };
+  std::string Name;
+  uint8_t Type;
+  Kind K;
+  std::vector<uint8_t> Code;
+};
+
+// Locals of the per-opcode functions.
+constexpr uint8_t LocalN = 0;
+constexpr uint8_t LocalI = 1;
+constexpr uint8_t LocalAcc = 2;
+constexpr uint8_t LocalX = 3;
+// The identity function for the call benchmarks.
+constexpr uint8_t IdentityFunc = 0;
+
+std::vector<OpcodeBench> getOpcodeBenches() {
+  using K = OpcodeBench::Kind;
+  std::vector<OpcodeBench> Benches;
+  auto Add = [&Benches](std::string Name, uint8_t Type, K Kind,
+                        std::vector<uint8_t> Code) {
+    Benches.push_back({std::move(Name), Type, Kind, std::move(Code)});
+  };
+  const std::pair<const char *, uint8_t> I32Unary[] = {
+      {"clz", 0x67}, {"ctz", 0x68}, {"popcnt", 0x69}, {"eqz", 0x45}};
+  const std::pair<const char *, uint8_t> I32Binary[] = {
+      {"add", 0x6A},   {"sub", 0x6B},   {"mul", 0x6C},   {"div_s", 0x6D},
+      {"div_u", 0x6E}, {"rem_s", 0x6F}, {"rem_u", 0x70}, {"and", 0x71},
+      {"or", 0x72},    {"xor", 0x73},   {"shl", 0x74},   {"shr_s", 0x75},
+      {"shr_u", 0x76}, {"rotl", 0x77},  {"rotr", 0x78},  {"lt_u", 0x49}};
+  const std::pair<const char *, uint8_t> I64Unary[] = {
+      {"clz", 0x79}, {"ctz", 0x7A}, {"popcnt", 0x7B}};
+  const std::pair<const char *, uint8_t> I64Binary[] = {
+      {"add", 0x7C},   {"sub", 0x7D},   {"mul", 0x7E},   {"div_s", 0x7F},
+      {"div_u", 0x80}, {"rem_s", 0x81}, {"rem_u", 0x82}, {"and", 0x83},
+      {"or", 0x84},    {"xor", 0x85},   {"shl", 0x86},   {"shr_s", 0x87},
+      {"shr_u", 0x88}, {"rotl", 0x89},  {"rotr", 0x8A}};
+  const std::pair<const char *, uint8_t> F32Unary[] = {
+      {"abs", 0x8B},   {"neg", 0x8C},   {"ceil", 0x8D},    {"floor", 0x8E},
+      {"trunc", 0x8F}, {"nearest", 0x90}, {"sqrt", 0x91}};
+  const std::pair<const char *, uint8_t> F32Binary[] = {
+      {"add", 0x92}, {"sub", 0x93}, {"mul", 0x94},     {"div", 0x95},
+      {"min", 0x96}, {"max", 0x97}, {"copysign", 0x98}};
+  const std::pair<const char *, uint8_t> F64Unary[] = {
+      {"abs", 0x99},   {"neg", 0x9A},   {"ceil", 0x9B},    {"floor", 0x9C},
+      {"trunc", 0x9D}, {"nearest", 0x9E}, {"sqrt", 0x9F}};
+  const std::pair<const char *, uint8_t> F64Binary[] = {
+      {"add", 0xA0}, {"sub", 0xA1}, {"mul", 0xA2},     {"div", 0xA3},
+      {"min", 0xA4}, {"max", 0xA5}, {"copysign", 0xA6}};
+
+  for (const auto &[Name, Op] : I32Unary) {
+    Add("i32."s + Name, I32, K::Unary, {Op});
+  }
+  for (const auto &[Name, Op] : I32Binary) {
+    Add("i32."s + Name, I32, K::Binary, {Op});
+  }
+  for (const auto &[Name, Op] : I64Unary) {
+    Add("i64."s + Name, I64, K::Unary, {Op});
+  }
+  for (const auto &[Name, Op] : I64Binary) {
+    Add("i64."s + Name, I64, K::Binary, {Op});
+  }
+  for (const auto &[Name, Op] : F32Unary) {
+    Add("f32."s + Name, F32, K::Unary, {Op});
+  }
+  for (const auto &[Name, Op] : F32Binary) {
+    Add("f32."s + Name, F32, K::Binary, {Op});
+  }
+  for (const auto &[Name, Op] : F64Unary) {
+    Add("f64."s + Name, F64, K::Unary, {Op});
+  }
+  for (const auto &[Name, Op] : F64Binary) {
+    Add("f64."s + Name, F64, K::Binary, {Op});
+  }
+
+  // acc = x = acc
+  Add("local.tee", I32, K::Raw,
+      {0x20, LocalAcc, 0x22, LocalX, 0x21, LocalAcc});
+  // acc = i ? acc : x
+  Add("select", I32, K::Raw,
+      {0x20, LocalAcc, 0x20, LocalX, 0x20, LocalI, 0x1B, 0x21, LocalAcc});
+  // g0 = g0 + acc
+  Add("global.get.set", I32, K::Raw, {0x23, 0, 0x20, LocalAcc, 0x6A, 0x24, 0});
+  // acc = mem[0] + acc
+  Add("i32.load", I32, K::Raw,
+      {0x41, 0, 0x28, 2, 0, 0x20, LocalAcc, 0x6A, 0x21, LocalAcc});
+  // mem[0] = acc
+  Add("i32.store", I32, K::Raw, {0x41, 0, 0x20, LocalAcc, 0x36, 2, 0});
+  // acc = identity(acc)
+  Add("call", I32, K::Raw, {0x20, LocalAcc, 0x10, IdentityFunc, 0x21, LocalAcc});
+  // acc = table[0](acc)
+  Add("call_indirect", I32, K::Raw,
+      {0x20, LocalAcc, 0x41, 0, 0x11, 0, 0, 0x21, LocalAcc});
+  return Benches;
+}
+
+} // namespace
+
+void writeU32(std::vector<uint8_t> &Out, uint32_t Value) {
+  do {
+    uint8_t Byte = Value & 0x7F;
+    Value >>= 7;
+    if (Value != 0) {
+      Byte |= 0x80;
+    }
+    Out.push_back(Byte);
+  } while (Value != 0);
+}
+
+void writeS64(std::vector<uint8_t> &Out, int64_t Value) {
+  while (true) {
+    const uint8_t Byte = Value & 0x7F;
+    Value >>= 7;
+    if ((Value == 0 && (Byte & 0x40) == 0) ||
+        (Value == -1 && (Byte & 0x40) != 0)) {
+      Out.push_back(Byte);
+      return;
+    }
+    Out.push_back(Byte | 0x80);
+  }
+}
+
+uint32_t ModuleBuilder::addType(Span<const uint8_t> Params,
+                                Span<const uint8_t> Results) {
+  std::vector<uint8_t> Type = {0x60};
+  writeU32(Type, static_cast<uint32_t>(Params.size()));
+  Type.insert(Type.end(), Params.begin(), Params.end());
+  writeU32(Type, static_cast<uint32_t>(Results.size()));
+  Type.insert(Type.end(), Results.begin(), Results.end());
+  Types.push_back(std::move(Type));
+  return static_cast<uint32_t>(Types.size() - 1);
+}
+
+uint32_t ModuleBuilder::addCompositeType(std::vector<uint8_t> Type) {
+  Types.push_back(std::move(Type));
+  return static_cast<uint32_t>(Types.size() - 1);
+}
+
+uint32_t ModuleBuilder::addImportFunc(std::string_view Module,
+                                      std::string_view Name,
+                                      uint32_t TypeIdx) {
+  std::vector<uint8_t> Import;
+  writeName(Import, Module);
+  writeName(Import, Name);
+  Import.push_back(0x00);
+  writeU32(Import, TypeIdx);
+  Imports.push_back(std::move(Import));
+  return static_cast<uint32_t>(Imports.size() - 1);
+}
+
+uint32_t ModuleBuilder::addFunc(uint32_t TypeIdx, Span<const uint8_t> Locals,
+                                std::vector<uint8_t> Body) {
+  std::vector<uint8_t> Func;
+  writeU32(Func, static_cast<uint32_t>(Locals.size()));
+  for (const auto Local : Locals) {
+    Func.push_back(1);
+    Func.push_back(Local);
+  }
+  Func.insert(Func.end(), Body.begin(), Body.end());
+  Func.push_back(0x0B);
+  std::vector<uint8_t> Code;
+  writeU32(Code, static_cast<uint32_t>(Func.size()));
+  Code.insert(Code.end(), Func.begin(), Func.end());
+  Funcs.push_back(TypeIdx);
+  Codes.push_back(std::move(Code));
+  return static_cast<uint32_t>(Imports.size() + Funcs.size() - 1);
+}
+
+void ModuleBuilder::addExport(std::string_view Name, uint32_t FuncIdx) {
+  std::vector<uint8_t> Export;
+  writeName(Export, Name);
+  Export.push_back(0x00);
+  writeU32(Export, FuncIdx);
+  Exports.push_back(std::move(Export));
+}
+
+void ModuleBuilder::addData(uint32_t Offset, std::vector<uint8_t> Data) {
+  // i32.const or i64.const of the offset.
+  std::vector<uint8_t> Seg = {0x00,
+                              static_cast<uint8_t>(Memory64 ? 0x42 : 0x41)};
+  writeS64(Seg, Offset);
+  Seg.push_back(0x0B);
+  writeU32(Seg, static_cast<uint32_t>(Data.size()));
+  Seg.insert(Seg.end(), Data.begin(), Data.end());
+  Datas.push_back(std::move(Seg));
+}
+
+std::vector<uint8_t> ModuleBuilder::build() const {
+  std::vector<uint8_t> Out = {0x00, 0x61, 0x73, 0x6D, 0x01, 0x00, 0x00, 0x00};
+  writeSection(Out, 0x01, Types);
+  writeSection(Out, 0x02, Imports);
+  {
+    std::vector<std::vector<uint8_t>> Items;
+    for (const auto TypeIdx : Funcs) {
+      writeU32(Items.emplace_back(), TypeIdx);
+    }
+    writeSection(Out, 0x03, Items);
+  }
+  if (!TableElems.empty()) {
+    std::vector<uint8_t> Table = {0x70, 0x00};
+    writeU32(Table, static_cast<uint32_t>(TableElems.size()));
+    writeSection(Out, 0x04, {Table});
+  }
+  if (MemoryPage > 0) {
+    std::vector<uint8_t> Memory = {
+        static_cast<uint8_t>(Memory64 ? 0x04 : 0x00)};
+    writeU32(Memory, MemoryPage);
+    writeSection(Out, 0x05, {Memory});
+  }
+  {
+    std::vector<std::vector<uint8_t>> Items(GlobalNum,
+                                            {I32, 0x01, 0x41, 0x00, 0x0B});
+    writeSection(Out, 0x06, Items);
+  }
+  writeSection(Out, 0x07, Exports);
+  if (!TableElems.empty()) {
+    std::vector<uint8_t> Elem = {0x00, 0x41, 0x00, 0x0B};
+    writeU32(Elem, static_cast<uint32_t>(TableElems.size()));
+    for (const auto FuncIdx : TableElems) {
+      writeU32(Elem, FuncIdx);
+    }
+    writeSection(Out, 0x09, {Elem});
+  }
+  writeSection(Out, 0x0A, Codes);
+  writeSection(Out, 0x0B, Datas);
+  return Out;
+}
+
+std::vector<uint8_t> makeLoopModule() {
+  ModuleBuilder Builder;
+  const auto Type = Builder.addType(std::initializer_list<uint8_t>{I32},
+                                    std::initializer_list<uint8_t>{I32});
+  // acc = (acc + i) * 3 for i in [0, n)
+  const auto Func = Builder.addFunc(
+      Type, std::initializer_list<uint8_t>{I32, I32},
+      {0x03, 0x40,                                           // loop
+       0x20, 2, 0x20, 1, 0x6A, 0x41, 3, 0x6C, 0x21, 2,       // acc
+       0x20, 1, 0x41, 1, 0x6A, 0x22, 1, 0x20, 0, 0x49, 0x0D, // i
+       0, 0x0B,                                              // end
+       0x20, 2});
+  Builder.addExport("bench"sv, Func);
+  return Builder.build();
+}
+
+std::vector<uint8_t> makeDispatchModule() {
+  ModuleBuilder Builder;
+  const auto Type = Builder.addType(std::initializer_list<uint8_t>{I32},
+                                    std::initializer_list<uint8_t>{I32});
+  // acc = ((3 * acc) ^ 7) + i for i in [0, n)
+  const auto Func = Builder.addFunc(
+      Type, std::initializer_list<uint8_t>{I32, I32},
+      {0x03, 0x40,                                                 // loop
+       0x41, 3, 0x20, 2, 0x6C, 0x41, 7, 0x73, 0x20, 1, 0x6A, 0x21, // acc
+       2, 0x41, 1, 0x20, 1, 0x6A, 0x22, 1, 0x20, 0, 0x49, 0x0D, 0, // i
+       0x0B,                                                       // end
+       0x20, 2});
+  Builder.addExport("bench"sv, Func);
+  return Builder.build();
+}
+
+std::vector<std::string> getOpcodeBenchNames() {
+  std::vector<std::string> Names;
+  for (auto &Bench : getOpcodeBenches()) {
+    Names.push_back(std::move(Bench.Name));
+  }
+  return Names;
+}
+
+std::vector<uint8_t> makeOpcodeModule() {
+  ModuleBuilder Builder;
+  const auto IdentityType = Builder.addType(
+      std::initializer_list<uint8_t>{I32}, std::initializer_list<uint8_t>{I32});
+  const auto BenchType = Builder.addType(std::initializer_list<uint8_t>{I32},
+                                         std::initializer_list<uint8_t>{});
+  Builder.addFunc(IdentityType, {}, {0x20, 0});
+  Builder.setMemory(1);
+  Builder.setTable({IdentityFunc});
+  Builder.addGlobal();
+
+  for (const auto &Bench : getOpcodeBenches()) {
+    std::vector<uint8_t> Body;
+    writeConst(Body, Bench.Type, 7);
+    Body.insert(Body.end(), {0x21, LocalAcc});
+    writeConst(Body, Bench.Type, 3);
+    Body.insert(Body.end(), {0x21, LocalX});
+    // block loop br_if (i >= n) 1
+    Body.insert(Body.end(), {0x02, 0x40, 0x03, 0x40, 0x20, LocalI, 0x20, LocalN,
+                             0x4F, 0x0D, 1});
+    switch (Bench.K) {
+    case OpcodeBench::Kind::Unary:
+      Body.insert(Body.end(), {0x20, LocalAcc});
+      break;
+    case OpcodeBench::Kind::Binary:
+      Body.insert(Body.end(), {0x20, LocalAcc, 0x20, LocalX});
+      break;
+    default:
+      break;
+    }
+    Body.insert(Body.end(), Bench.Code.begin(), Bench.Code.end());
+    if (Bench.K != OpcodeBench::Kind::Raw) {
+      Body.insert(Body.end(), {0x21, LocalAcc});
+    }
+    // i = i + 1 br 0 end end
+    Body.insert(Body.end(), {0x20, LocalI, 0x41, 1, 0x6A, 0x21, LocalI, 0x0C, 0,
+                             0x0B, 0x0B});
+    const auto Func =
+        Builder.addFunc(BenchType,
+                        std::initializer_list<uint8_t>{I32, Bench.Type,
+                                                       Bench.Type},
+                        std::move(Body));
+    Builder.addExport(Bench.Name, Func);
+  }
+  return Builder.build();
+}
+
+std::vector<uint8_t> makeHostCallModule() {
+  ModuleBuilder Builder;
+  const auto Type = Builder.addType(std::initializer_list<uint8_t>{I32},
+                                    std::initializer_list<uint8_t>{I32});
+  const auto Host = Builder.addImportFunc("env"sv, "host"sv, Type);
+  // acc = host(acc) for i in [0, n)
+  const auto Func = Builder.addFunc(
+      Type, std::initializer_list<uint8_t>{I32, I32},
+      {0x03, 0x40,                                                 // loop
+       0x20, 2, 0x10, static_cast<uint8_t>(Host), 0x21, 2,         // acc
+       0x20, 1, 0x41, 1, 0x6A, 0x22, 1, 0x20, 0, 0x49, 0x0D, 0,    // i
+       0x0B,                                                       // end
+       0x20, 2});
+  Builder.addExport("bench"sv, Func);
+  return Builder.build();
+}
+
+std::vector<uint8_t> makeGCModule() {
+  ModuleBuilder Builder;
+  // (struct (field (mut i32)) (field (mut (ref null 0))))
+  const auto Node = Builder.addCompositeType(
+      {0x5F, 0x02, I32, 0x01, 0x63, 0x00, 0x01});
+  // (array (mut (ref null 0)))
+  const auto Slots =
+      Builder.addCompositeType({0x5E, 0x63, static_cast<uint8_t>(Node), 0x01});
+  const auto Type = Builder.addType(std::initializer_list<uint8_t>{I32},
+                                    std::initializer_list<uint8_t>{I32});
+  // drop(struct.new_default) for i in [0, n)
+  const auto Alloc = Builder.addFunc(
+      Type, std::initializer_list<uint8_t>{I32},
+      {0x03, 0x40,                                              // loop
+       0xFB, 0x01, static_cast<uint8_t>(Node), 0x1A,            // alloc
+       0x20, 1, 0x41, 1, 0x6A, 0x22, 1, 0x20, 0, 0x49, 0x0D, 0, // i
+       0x0B,                                                    // end
+       0x20, 1});
+  // slots = array.new_default(1024)
+  // slots[i & 1023] = struct.new(i, null) for i in [0, n)
+  constexpr uint8_t ArrayRef = 0x6A;
+  const auto Retain = Builder.addFunc(
+      Type, std::initializer_list<uint8_t>{I32, ArrayRef},
+      {0x41, 0x80, 0x08, 0xFB, 0x07, static_cast<uint8_t>(Slots), 0x21, 2,
+       0x03, 0x40,                                              // loop
+       0x20, 2, 0xFB, 0x16, static_cast<uint8_t>(Slots),        // slots
+       0x20, 1, 0x41, 0xFF, 0x07, 0x71,                         // index
+       0x20, 1, 0xD0, static_cast<uint8_t>(Node),               // fields
+       0xFB, 0x00, static_cast<uint8_t>(Node),                  // alloc
+       0xFB, 0x0E, static_cast<uint8_t>(Slots),                 // store
+       0x20, 1, 0x41, 1, 0x6A, 0x22, 1, 0x20, 0, 0x49, 0x0D, 0, // i
+       0x0B,                                                    // end
+       0x20, 1});
+  Builder.addExport("alloc"sv, Alloc);
+  Builder.addExport("retain"sv, Retain);
+  return Builder.build();
+}
+
+std::vector<uint8_t> makeMemoryModule(bool Is64) {
+  ModuleBuilder Builder;
+  const auto Type = Builder.addType(std::initializer_list<uint8_t>{I32},
+                                    std::initializer_list<uint8_t>{I32});
+  Builder.setMemory(4, Is64);
+  // addr = (i & 0xFFFF) << 2, extended to i64 for the 64-bit memory.
+  std::vector<uint8_t> Addr = {0x20, 1, 0x41, 0xFF, 0xFF,
+                               0x03, 0x71, 0x41, 2, 0x74};
+  if (Is64) {
+    Addr.push_back(0xAD);
+  }
+  // acc = acc + mem[addr]; mem[addr] = acc for i in [0, n)
+  std::vector<uint8_t> Body = {0x03, 0x40, 0x20, 2};
+  Body.insert(Body.end(), Addr.begin(), Addr.end());
+  Body.insert(Body.end(), {0x28, 2, 0, 0x6A, 0x21, 2});
+  Body.insert(Body.end(), Addr.begin(), Addr.end());
+  Body.insert(Body.end(), {0x20, 2, 0x36, 2, 0});
+  Body.insert(Body.end(), {0x20, 1, 0x41, 1, 0x6A, 0x22, 1, 0x20, 0, 0x49,
+                           0x0D, 0, 0x0B, 0x20, 2});
+  const auto Func = Builder.addFunc(
+      Type, std::initializer_list<uint8_t>{I32, I32}, std::move(Body));
+  Builder.addExport("bench"sv, Func);
+  return Builder.build();
+}
+
+std::vector<uint8_t> makeLargeModule(uint32_t FuncNum) {
+  ModuleBuilder Builder;
+  const auto Type = Builder.addType(std::initializer_list<uint8_t>{I32, I32},
+                                    std::initializer_list<uint8_t>{I32});
+  Builder.setMemory(16);
+  for (uint32_t I = 0; I < 16; ++I) {
+    Builder.addGlobal();
+    Builder.addData(I * 1024, std::vector<uint8_t>(256, static_cast<uint8_t>(I)));
+  }
+
+  std::vector<uint32_t> Elems;
+  for (uint32_t I = 0; I < FuncNum; ++I) {
+    std::vector<uint8_t> Body;
+    for (uint32_t J = 0; J < 4; ++J) {
+      // x = a + b
+      Body.insert(Body.end(), {0x20, 0, 0x20, 1, 0x6A, 0x21, 2});
+      // block loop (br_if 1 (x = x - 1) == 0)
+      Body.insert(Body.end(), {0x02, 0x40, 0x03, 0x40, 0x20, 2, 0x41, 1, 0x6B,
+                               0x22, 2, 0x45, 0x0D, 1});
+      // b = mem[(x & 1023) * 4] ^ b
+      Body.insert(Body.end(), {0x20, 2, 0x41, 0xFF, 0x07, 0x71, 0x41, 4, 0x6C,
+                               0x28, 2, 0, 0x20, 1, 0x73, 0x21, 1});
+      // mem[x & 1023] = b
+      Body.insert(Body.end(), {0x20, 2, 0x41, 0xFF, 0x07, 0x71, 0x20, 1, 0x36,
+                               2, 0});
+      // g[J] = g[J] + b
+      Body.insert(Body.end(), {0x23, static_cast<uint8_t>(J), 0x20, 1, 0x6A,
+                               0x24, static_cast<uint8_t>(J)});
+      // br 0 end end
+      Body.insert(Body.end(), {0x0C, 0, 0x0B, 0x0B});
+      // a = b != 0 ? a : b
+      Body.insert(Body.end(), {0x20, 1, 0x41, 0, 0x47, 0x04, I32, 0x20, 0, 0x05,
+                               0x20, 1, 0x0B, 0x21, 0});
+    }
+    if (I > 0) {
+      // a = f[I - 1](a, b)
+      Body.insert(Body.end(), {0x20, 0, 0x20, 1, 0x10});
+      writeU32(Body, I - 1);
+      Body.insert(Body.end(), {0x21, 0});
+    }
+    Body.insert(Body.end(), {0x20, 0});
+    Elems.push_back(Builder.addFunc(
+        Type, std::initializer_list<uint8_t>{I32}, std::move(Body)));
+  }
+  Builder.setTable(std::move(Elems));
+  Builder.addExport("entry"sv, FuncNum - 1);
+  return Builder.build();
+}
+
+std::vector<uint8_t> makeUniversalModule(uint64_t TextSize) {
+  // Alignment of the text content, the same as the compiler.
+  constexpr uint64_t Alignment = 16384;
+  constexpr uint64_t DataSize = 4096;
+  std::vector<uint8_t> Content;
+  writeName(Content, "wasmedge"sv);
+  // Binary version, OS type, and arch type.
+  writeU32(Content, AOT::kBinaryVersion);
+#if defined(__linux__)
+  Content.push_back(1);
+#elif defined(__APPLE__)
+  Content.push_back(2);
+#elif defined(_WIN32)
+  Content.push_back(3);
+#else
+  Content.push_back(0xFF);
+#endif
+#if defined(__x86_64__) || defined(_M_X64)
+  Content.push_back(1);
+#elif defined(__aarch64__)
+  Content.push_back(2);
+#else
+  Content.push_back(0xFF);
+#endif
+  // Version and intrinsics addresses in the data section, and no types and
+  // codes.
+  writeU64(Content, TextSize + 8);
+  writeU64(Content, TextSize);
+  writeU64(Content, 0);
+  writeU64(Content, 0);
+  writeU32(Content, 2);
+  // Text section at address 0.
+  Content.push_back(1);
+  writeU64(Content, 0);
+  writeU64(Content, TextSize);
+  writeU32(Content, static_cast<uint32_t>(TextSize));
+  const uint64_t TextPos = Content.size();
+  Content.resize(Content.size() + TextSize, 0xCC);
+  // Data section of the intrinsics table pointer and the version.
+  Content.push_back(2);
+  writeU64(Content, TextSize);
+  writeU64(Content, DataSize);
+  writeU32(Content, static_cast<uint32_t>(DataSize));
+  std::vector<uint8_t> Data(DataSize, 0);
+  Data[8] = 1;
+  Content.insert(Content.end(), Data.begin(), Data.end());
+
+  std::vector<uint8_t> Out = ModuleBuilder().build();
+  std::vector<uint8_t> Header;
+  writeU32(Header, static_cast<uint32_t>(Content.size()));
+  const uint64_t Pos = Out.size() + 1 + Header.size() + TextPos;
+  if (Pos % Alignment != 0) {
+    // Pad by a custom section before the AOT section.
+    std::vector<uint8_t> Padding;
+    writeName(Padding, "wasmedge.padding"sv);
+    const uint64_t NameSize = Padding.size();
+    for (uint64_t Size = NameSize;; ++Size) {
+      std::vector<uint8_t> SizeBytes;
+      writeU32(SizeBytes, static_cast<uint32_t>(Size));
+      if ((Pos + 1 + SizeBytes.size() + Size) % Alignment == 0) {
+        Padding.resize(Size, 0);
+        Out.push_back(0x00);
+        Out.insert(Out.end(), SizeBytes.begin(), SizeBytes.end());
+        Out.insert(Out.end(), Padding.begin(), Padding.end());
+        break;
+      }
+    }
+  }
+  Out.push_back(0x00);
+  Out.insert(Out.end(), Header.begin(), Header.end());
+  Out.insert(Out.end(), Content.begin(), Content.end());
+  return Out;
+}
+
+} // namespace Bench
+} // namespace WasmEdge
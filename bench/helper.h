@@ -0,0 +1,135 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/bench/helper.h - Benchmark helpers -----------------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the generators of the wasm modules used by the
+/// benchmarks. The modules are generated in memory, so that the benchmarks do
+/// not depend on the files in the source tree or any external toolchain.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/span.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace WasmEdge {
+namespace Bench {
+
+/// Minimal wasm binary writer. Only the sections used by the benchmark
+/// modules are supported.
+class ModuleBuilder {
+public:
+  /// Add a function type and return the type index.
+  uint32_t addType(Span<const uint8_t> Params, Span<const uint8_t> Results);
+
+  /// Add an encoded composite type, such as a struct or an array type, and
+  /// return the type index.
+  uint32_t addCompositeType(std::vector<uint8_t> Type);
+
+  /// Import a function from the module and return the function index. All the
+  /// imports should be added before the defined functions.
+  uint32_t addImportFunc(std::string_view Module, std::string_view Name,
+                         uint32_t TypeIdx);
+
+  /// Add a function with the locals and the body expression excluding the
+  /// `end` opcode, and return the function index.
+  uint32_t addFunc(uint32_t TypeIdx, Span<const uint8_t> Locals,
+                   std::vector<uint8_t> Body);
+
+  /// Export the function.
+  void addExport(std::string_view Name, uint32_t FuncIdx);
+
+  /// Add a memory with the minimum page count. The 64-bit memory of the
+  /// memory64 proposal takes the i64 addresses, and should be set before
+  /// adding the data segments.
+  void setMemory(uint32_t MinPage, bool Is64 = false) {
+    MemoryPage = MinPage;
+    Memory64 = Is64;
+  }
+
+  /// Add a funcref table initialized with the functions from index 0.
+  void setTable(std::vector<uint32_t> Elems) { TableElems = std::move(Elems); }
+
+  /// Add a mutable i32 global initialized to 0.
+  void addGlobal() { ++GlobalNum; }
+
+  /// Add an active data segment at the offset of the memory.
+  void addData(uint32_t Offset, std::vector<uint8_t> Data);
+
+  /// Serialize the module.
+  std::vector<uint8_t> build() const;
+
+private:
+  std::vector<std::vector<uint8_t>> Types;
+  std::vector<std::vector<uint8_t>> Imports;
+  std::vector<uint32_t> Funcs;
+  std::vector<std::vector<uint8_t>> Codes;
+  std::vector<std::vector<uint8_t>> Exports;
+  std::vector<std::vector<uint8_t>> Datas;
+  std::vector<uint32_t> TableElems;
+  uint32_t MemoryPage = 0;
+  bool Memory64 = false;
+  uint32_t GlobalNum = 0;
+};
+
+/// Append the unsigned and signed LEB128 encodings.
+void writeU32(std::vector<uint8_t> &Out, uint32_t Value);
+void writeS64(std::vector<uint8_t> &Out, int64_t Value);
+
+/// Module exporting `bench: [i32] -> [i32]`, which runs a loop of arithmetic
+/// instructions for the given iterations.
+std::vector<uint8_t> makeLoopModule();
+
+/// Module exporting `bench: [i32] -> [i32]`, which runs a loop of stack
+/// instructions mostly not fused into superinstructions, to measure the
+/// instruction dispatch of the interpreter.
+std::vector<uint8_t> makeDispatchModule();
+
+/// Name list of the per-opcode microbenchmarks in makeOpcodeModule.
+std::vector<std::string> getOpcodeBenchNames();
+
+/// Module exporting the per-opcode microbenchmarks `[i32] -> []`, named by
+/// getOpcodeBenchNames. Each runs a loop executing the opcode for the given
+/// iterations.
+std::vector<uint8_t> makeOpcodeModule();
+
+/// Module importing `env.host: [i32] -> [i32]` and exporting
+/// `bench: [i32] -> [i32]`, which calls the host function for the given
+/// iterations.
+std::vector<uint8_t> makeHostCallModule();
+
+/// Module of the GC proposal exporting `alloc: [i32] -> [i32]`, which
+/// allocates the given count of short-lived structs, and
+/// `retain: [i32] -> [i32]`, which stores the given count of structs into the
+/// slots of a 1024-element array, so that each struct lives for 1024
+/// allocations.
+std::vector<uint8_t> makeGCModule();
+
+/// Module exporting `bench: [i32] -> [i32]`, which loads, accumulates, and
+/// stores back the words of a 256 KiB buffer in the memory for the given
+/// iterations. The memory is a 64-bit one of the memory64 proposal if Is64.
+std::vector<uint8_t> makeMemoryModule(bool Is64);
+
+/// Module with FuncNum functions of mixed instructions, a memory, a table,
+/// globals, and data segments, for the loading, validation, compilation, and
+/// instantiation benchmarks.
+std::vector<uint8_t> makeLargeModule(uint32_t FuncNum);
+
+/// Universal wasm of an empty module for the host, whose AOT section has a
+/// text section of TextSize bytes and a data section of the intrinsics table.
+/// The content of the text section is aligned in the file as the compiler
+/// emits.
+std::vector<uint8_t> makeUniversalModule(uint64_t TextSize);
+
+} // namespace Bench
+} // namespace WasmEdge
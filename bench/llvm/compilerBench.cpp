@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/bench/llvm/compilerBench.cpp - Compiler benchmarks -------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the benchmarks of the LLVM compilation of the wasm
+/// modules in the optimization levels.
+///
+//===----------------------------------------------------------------------===//
+
+#include "common/configure.h"
+#include "llvm/compiler.h"
+#include "loader/loader.h"
+#include "validator/validator.h"
+
+#include "../helper.h"
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+using namespace WasmEdge;
+
+void BM_Compile(benchmark::State &State,
+                CompilerConfigure::OptimizationLevel Level) {
+  Configure Conf;
+  Conf.getCompilerConfigure().setOptimizationLevel(Level);
+  Loader::Loader Loader(Conf);
+  Validator::Validator Validator(Conf);
+  const auto Wasm =
+      Bench::makeLargeModule(static_cast<uint32_t>(State.range(0)));
+  auto Mod = Loader.parseModule(Wasm);
+  if (!Mod || !Validator.validate(**Mod)) {
+    State.SkipWithError("validation failed");
+    return;
+  }
+  LLVM::Compiler Compiler(Conf);
+  for (auto _ : State) {
+    if (auto Data = Compiler.compile(**Mod); !Data) {
+      State.SkipWithError("compilation failed");
+      return;
+    }
+  }
+  State.SetBytesProcessed(static_cast<int64_t>(State.iterations()) *
+                          static_cast<int64_t>(Wasm.size()));
+}
+
+BENCHMARK_CAPTURE(BM_Compile, O0, CompilerConfigure::OptimizationLevel::O0)
+    ->Arg(64)
+    ->Arg(1024)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_Compile, O2, CompilerConfigure::OptimizationLevel::O2)
+    ->Arg(64)
+    ->Arg(1024)
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,265 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/bench/loader/loaderBench.cpp - Loader benchmarks ---------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the benchmarks of the loading and the validation of the
+/// wasm modules, reported in bytes per second of the binary, and the memory
+/// footprint of the loaded instructions of the generated and the real modules,
+/// and the loading of the AOT sections of the universal wasm files.
+///
+//===----------------------------------------------------------------------===//
+
+#include "common/configure.h"
+#include "common/defines.h"
+#include "loader/loader.h"
+#include "validator/validator.h"
+
+#include "../helper.h"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using namespace WasmEdge;
+
+/// The arguments are the function count and the thread count.
+Configure makeConf(const benchmark::State &State) {
+  Configure Conf;
+  Conf.getRuntimeConfigure().setLoadThreads(
+      static_cast<uint32_t>(State.range(1)));
+  return Conf;
+}
+
+void BM_Parse(benchmark::State &State) {
+  const Configure Conf = makeConf(State);
+  Loader::Loader Loader(Conf);
+  const auto Wasm =
+      Bench::makeLargeModule(static_cast<uint32_t>(State.range(0)));
+  for (auto _ : State) {
+    auto Mod = Loader.parseModule(Wasm);
+    if (!Mod) {
+      State.SkipWithError("loading failed");
+      return;
+    }
+    benchmark::DoNotOptimize(*Mod);
+  }
+  State.SetBytesProcessed(static_cast<int64_t>(State.iterations()) *
+                          static_cast<int64_t>(Wasm.size()));
+}
+
+/// Count the instructions of the loaded function bodies, and the side buffers
+/// of their immediates, and report the footprint in the counters.
+void measureFootprint(benchmark::State &State, const Configure &Conf,
+                      Span<const uint8_t> Wasm) {
+  Loader::Loader Loader(Conf);
+  auto Mod = Loader.parseModule(Wasm);
+  if (!Mod) {
+    State.SkipWithError("loading failed");
+    return;
+  }
+  uint64_t Count = 0, Bytes = 0;
+  for (auto _ : State) {
+    Count = 0;
+    Bytes = 0;
+    for (const auto &Seg : (*Mod)->getCodeSection().getContent()) {
+      const auto &Expr = Seg.getExpr();
+      Bytes += Expr.getInstrs().size() * sizeof(AST::Instruction) +
+               Expr.getImmediates().size();
+      Count += Expr.getInstrs().size();
+    }
+    benchmark::DoNotOptimize(Bytes);
+  }
+  State.counters["instrs"] = static_cast<double>(Count);
+  State.counters["bytes_per_instr"] =
+      static_cast<double>(Bytes) / static_cast<double>(Count);
+  State.counters["bytes_per_wasm_byte"] =
+      static_cast<double>(Bytes) / static_cast<double>(Wasm.size());
+}
+
+void BM_Footprint(benchmark::State &State) {
+  measureFootprint(
+      State, makeConf(State),
+      Bench::makeLargeModule(static_cast<uint32_t>(State.range(0))));
+}
+
+/// The footprint of a real module read from the file.
+void BM_FootprintFile(benchmark::State &State,
+                      const std::vector<uint8_t> &Wasm) {
+  measureFootprint(State, Configure(), Wasm);
+}
+
+void BM_Validate(benchmark::State &State) {
+  const Configure Conf = makeConf(State);
+  Loader::Loader Loader(Conf);
+  Validator::Validator Validator(Conf);
+  const auto Wasm =
+      Bench::makeLargeModule(static_cast<uint32_t>(State.range(0)));
+  for (auto _ : State) {
+    // The validator annotates the instructions, so validate a new module in
+    // every iteration.
+    State.PauseTiming();
+    auto Mod = Loader.parseModule(Wasm);
+    State.ResumeTiming();
+    if (!Mod || !Validator.validate(**Mod)) {
+      State.SkipWithError("validation failed");
+      return;
+    }
+  }
+  State.SetBytesProcessed(static_cast<int64_t>(State.iterations()) *
+                          static_cast<int64_t>(Wasm.size()));
+}
+
+/// Resident anonymous memory in KiB, or 0 if unknown.
+uint64_t getRssAnon() {
+  std::ifstream Status("/proc/self/status");
+  std::string Line;
+  while (std::getline(Status, Line)) {
+    if (Line.rfind("RssAnon:", 0) == 0) {
+      return std::stoull(Line.substr(8));
+    }
+  }
+  return 0;
+}
+
+/// The arguments are the text size in MiB and whether to load from the file,
+/// which maps the aligned text pages, or from the copied bytes.
+void BM_LoadUniversal(benchmark::State &State) {
+  const uint64_t TextSize = static_cast<uint64_t>(State.range(0)) << 20;
+  const bool FromFile = State.range(1) != 0;
+  const auto Wasm = Bench::makeUniversalModule(TextSize);
+  const auto Path =
+      std::filesystem::temp_directory_path() / "wasmedge_universal_bench.wasm";
+  {
+    std::ofstream OS(Path, std::ios_base::binary);
+    OS.write(reinterpret_cast<const char *>(Wasm.data()),
+             static_cast<std::streamsize>(Wasm.size()));
+  }
+  Configure Conf;
+  Loader::Loader Loader(Conf);
+  const auto Load = [&]() {
+    return FromFile ? Loader.parseModule(Path) : Loader.parseModule(Wasm);
+  };
+  for (auto _ : State) {
+    auto Mod = Load();
+    if (!Mod || !(*Mod)->getSymbol()) {
+      State.SkipWithError("AOT loading failed");
+      break;
+    }
+    benchmark::DoNotOptimize(*Mod);
+  }
+  // Touch the text pages of a loaded module, and count the anonymous memory.
+  const uint64_t Before = getRssAnon();
+  if (auto Mod = Load(); Mod && (*Mod)->getSymbol()) {
+    // The intrinsics table pointer follows the text.
+    const auto *Text = reinterpret_cast<const volatile uint8_t *>(
+                           (*Mod)->getSymbol().get()) -
+                       TextSize;
+    uint64_t Sum = 0;
+    for (uint64_t I = 0; I < TextSize; I += 4096) {
+      Sum += Text[I];
+    }
+    benchmark::DoNotOptimize(Sum);
+    State.counters["rss_anon_kib"] =
+        static_cast<double>(getRssAnon() - Before);
+  }
+  std::filesystem::remove(Path);
+  State.SetBytesProcessed(static_cast<int64_t>(State.iterations()) *
+                          static_cast<int64_t>(Wasm.size()));
+}
+
+// The wall time is measured for the worker threads.
+BENCHMARK(BM_Parse)
+    ->ArgsProduct({{64, 1024}, {1, 4}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+// The footprint is reported in the counters.
+BENCHMARK(BM_Footprint)
+    ->ArgsProduct({{64, 1024}, {1}})
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Validate)
+    ->ArgsProduct({{64, 1024}, {1, 4}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+// The anonymous memory of the text is reported in the counters.
+BENCHMARK(BM_LoadUniversal)
+    ->ArgsProduct({{16}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+/// Register the footprint benchmarks of the real modules. The modules are the
+/// wasm files in the source tree, and the files or the directories of the
+/// files listed in the WASMEDGE_BENCH_MODULES environment variable, such as
+/// the qjs.wasm of the examples/js and the wasm32-wasi build of the
+/// examples/wasm/hello.
+void registerModuleBenchmarks() {
+  std::vector<std::filesystem::path> Paths = {WASMEDGE_BENCH_MODULE_DIR};
+  if (const char *Env = std::getenv("WASMEDGE_BENCH_MODULES")) {
+#if WASMEDGE_OS_WINDOWS
+    const char Separator = ';';
+#else
+    const char Separator = ':';
+#endif
+    std::string_view List(Env);
+    while (!List.empty()) {
+      const auto End = std::min(List.find(Separator), List.size());
+      if (End > 0) {
+        Paths.emplace_back(std::string(List.substr(0, End)));
+      }
+      List.remove_prefix(std::min(End + 1, List.size()));
+    }
+  }
+
+  std::vector<std::filesystem::path> Files;
+  for (const auto &Path : Paths) {
+    std::error_code EC;
+    if (std::filesystem::is_directory(Path, EC)) {
+      for (const auto &Entry : std::filesystem::directory_iterator(Path, EC)) {
+        if (Entry.path().extension() == ".wasm") {
+          Files.push_back(Entry.path());
+        }
+      }
+    } else if (std::filesystem::is_regular_file(Path, EC)) {
+      Files.push_back(Path);
+    }
+  }
+  std::sort(Files.begin(), Files.end());
+
+  for (const auto &File : Files) {
+    std::ifstream IS(File, std::ios_base::binary);
+    std::vector<uint8_t> Wasm((std::istreambuf_iterator<char>(IS)),
+                              std::istreambuf_iterator<char>());
+    const auto Name = "BM_FootprintFile/" + File.filename().u8string();
+    benchmark::RegisterBenchmark(Name.c_str(), BM_FootprintFile,
+                                 std::move(Wasm))
+        ->Unit(benchmark::kMicrosecond);
+  }
+}
+
+} // namespace
+
+int main(int Argc, char **Argv) {
+  registerModuleBenchmarks();
+  benchmark::Initialize(&Argc, Argv);
+  if (benchmark::ReportUnrecognizedArguments(Argc, Argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
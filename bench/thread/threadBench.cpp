@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/bench/thread/threadBench.cpp - Thread benchmarks ---------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the contention benchmarks of the parking lot behind
+/// memory.atomic.wait and memory.atomic.notify.
+///
+//===----------------------------------------------------------------------===//
+
+#include "system/parkinglot.h"
+
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace WasmEdge;
+
+constexpr uint32_t RoundTrips = 1U << 12;
+
+ParkingLot Lot;
+
+/// Words of the notifications, each on its own cache line.
+struct alignas(64) Word {
+  std::atomic<uint32_t> Value = 0;
+};
+std::vector<Word> Words(256);
+
+/// Notify the words without waiters, which is the common case of the mutexes
+/// in wasm. The argument selects a shared word or a word per thread.
+void BM_NotifyNoWaiter(benchmark::State &State) {
+  const bool Shared = State.range(0) != 0;
+  const auto &W =
+      Words[Shared ? 0 : static_cast<size_t>(State.thread_index())];
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(Lot.unpark(&W.Value, 1));
+  }
+  State.SetItemsProcessed(static_cast<int64_t>(State.iterations()));
+}
+
+/// Wait on the word until it is the value.
+void waitUntil(std::atomic<uint32_t> &Value, uint32_t Expected) {
+  while (Value.load() != Expected) {
+    Lot.park(
+        &Value, [&]() noexcept { return Value.load() != Expected; },
+        std::nullopt);
+  }
+}
+
+/// Pairs of threads passing a token by the wait and the notify on their own
+/// words. The argument is the count of the pairs.
+void BM_PingPong(benchmark::State &State) {
+  const auto Pairs = static_cast<uint32_t>(State.range(0));
+  for (auto _ : State) {
+    std::vector<std::thread> Threads;
+    Threads.reserve(Pairs * 2);
+    for (uint32_t I = 0; I < Pairs; ++I) {
+      auto &Value = Words[I].Value;
+      Value.store(0);
+      // The ping thread takes the even values and the pong thread takes the
+      // odd values.
+      for (uint32_t Side = 0; Side < 2; ++Side) {
+        Threads.emplace_back([&Value, Side]() {
+          for (uint32_t N = Side; N < RoundTrips * 2; N += 2) {
+            waitUntil(Value, N);
+            Value.store(N + 1);
+            Lot.unpark(&Value, 1);
+          }
+        });
+      }
+    }
+    for (auto &Thread : Threads) {
+      Thread.join();
+    }
+  }
+  State.SetItemsProcessed(static_cast<int64_t>(State.iterations()) * Pairs *
+                          RoundTrips);
+}
+
+BENCHMARK(BM_NotifyNoWaiter)->Arg(0)->Arg(1)->ThreadRange(1, 32);
+BENCHMARK(BM_PingPong)
+    ->RangeMultiplier(4)
+    ->Range(1, 16)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,434 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/bench/wasi/wasiBench.cpp - WASI benchmarks ---------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the benchmarks of the WASI file reading and writing and
+/// the socket echo through the host functions, reported in bytes per second,
+/// and of the poll_oneoff loop, with the epoll and the io_uring backends.
+///
+//===----------------------------------------------------------------------===//
+
+#include "common/configure.h"
+#include "common/filesystem.h"
+#include "executor/executor.h"
+#include "host/wasi/environ.h"
+#include "host/wasi/wasifunc.h"
+#include "runtime/callingframe.h"
+#include "runtime/instance/memory.h"
+#include "runtime/instance/module.h"
+
+#include <algorithm>
+#include <array>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+using namespace std::literals;
+using namespace WasmEdge;
+
+// Layout of the memory.
+constexpr uint32_t IOVecPtr = 0;
+constexpr uint32_t OutPtr = 16;
+constexpr uint32_t PathPtr = 64;
+constexpr uint32_t SubscriptionPtr = 128;
+constexpr uint32_t EventPtr = 256;
+constexpr uint32_t BufPtr = 4096;
+
+Configure makeConfigure(bool IOUring) {
+  Configure Conf;
+  Conf.getRuntimeConfigure().setEnableIOUring(IOUring);
+  return Conf;
+}
+
+/// Opened file in a temporary preopened directory, and the host functions
+/// with the memory to call them.
+class WasiFile {
+public:
+  WasiFile(bool IOUring)
+      : Exec(makeConfigure(IOUring)), Mod(""sv), Frame(&Exec, &Mod),
+        FdRead(Env), FdWrite(Env), FdSeek(Env), PathOpen(Env) {
+    Dir = std::filesystem::temp_directory_path() / "wasmedge-wasi-bench"sv;
+    std::filesystem::create_directories(Dir);
+    Env.init({"/:"s + Dir.u8string()}, "wasiBench"s, {}, {});
+    Mod.addHostMemory("memory"sv,
+                      std::make_unique<Runtime::Instance::MemoryInstance>(
+                          AST::MemoryType(32)));
+    Mem = Mod.findMemoryExports("memory"sv);
+    Fd = open("bench.dat"sv);
+    CopyFd = open("copy.dat"sv);
+  }
+  ~WasiFile() noexcept {
+    Env.fini();
+    std::error_code Error;
+    std::filesystem::remove_all(Dir, Error);
+  }
+
+  bool valid() const noexcept { return Fd >= 0 && CopyFd >= 0; }
+
+  /// Rewind the file, and read or write the buffer of the size.
+  bool run(bool Write, uint32_t Size) {
+    return seek(Fd) && transfer(Write, Fd, Size);
+  }
+
+  /// Rewind the files, and copy the file to the other one in the chunks of
+  /// the size.
+  bool copy(uint32_t Size, uint32_t Total) {
+    if (!seek(Fd) || !seek(CopyFd)) {
+      return false;
+    }
+    for (uint32_t Copied = 0; Copied < Total; Copied += Size) {
+      if (!transfer(false, Fd, Size) || !transfer(true, CopyFd, Size)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+private:
+  int32_t open(std::string_view Path) {
+    std::copy(Path.begin(), Path.end(), Mem->getPointer<char *>(PathPtr));
+    const uint64_t Rights = static_cast<uint64_t>(__WASI_RIGHTS_FD_READ) |
+                            static_cast<uint64_t>(__WASI_RIGHTS_FD_WRITE) |
+                            static_cast<uint64_t>(__WASI_RIGHTS_FD_SEEK);
+    const uint32_t OFlags = static_cast<uint32_t>(__WASI_OFLAGS_CREAT) |
+                            static_cast<uint32_t>(__WASI_OFLAGS_TRUNC);
+    std::array<ValVariant, 1> Errno;
+    const std::array<ValVariant, 9> Args = {
+        UINT32_C(3), UINT32_C(0), PathPtr,
+        static_cast<uint32_t>(Path.size()), OFlags, Rights,
+        Rights, UINT32_C(0), OutPtr};
+    if (PathOpen.run(Frame, Args, Errno) &&
+        Errno[0].get<uint32_t>() == __WASI_ERRNO_SUCCESS) {
+      return *Mem->getPointer<int32_t *>(OutPtr);
+    }
+    return -1;
+  }
+
+  bool seek(int32_t File) {
+    std::array<ValVariant, 1> Errno;
+    const std::array<ValVariant, 4> SeekArgs = {
+        static_cast<uint32_t>(File), UINT64_C(0),
+        static_cast<uint32_t>(__WASI_WHENCE_SET), OutPtr};
+    return FdSeek.run(Frame, SeekArgs, Errno) &&
+           Errno[0].get<uint32_t>() == __WASI_ERRNO_SUCCESS;
+  }
+
+  bool transfer(bool Write, int32_t File, uint32_t Size) {
+    std::array<ValVariant, 1> Errno;
+    const __wasi_ciovec_t IOVec = {BufPtr, Size};
+    std::memcpy(Mem->getPointer<__wasi_ciovec_t *>(IOVecPtr), &IOVec,
+                sizeof(IOVec));
+    const std::array<ValVariant, 4> Args = {static_cast<uint32_t>(File),
+                                            IOVecPtr, UINT32_C(1), OutPtr};
+    auto Res = Write ? FdWrite.run(Frame, Args, Errno)
+                     : FdRead.run(Frame, Args, Errno);
+    return Res && Errno[0].get<uint32_t>() == __WASI_ERRNO_SUCCESS &&
+           *Mem->getPointer<uint32_t *>(OutPtr) == Size;
+  }
+
+  std::filesystem::path Dir;
+  Host::WASI::Environ Env;
+  Executor::Executor Exec;
+  Runtime::Instance::ModuleInstance Mod;
+  Runtime::CallingFrame Frame;
+  Runtime::Instance::MemoryInstance *Mem = nullptr;
+  Host::WasiFdRead FdRead;
+  Host::WasiFdWrite FdWrite;
+  Host::WasiFdSeek FdSeek;
+  Host::WasiPathOpen PathOpen;
+  int32_t Fd = -1;
+  int32_t CopyFd = -1;
+};
+
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+/// Connected socket to an echo peer in a host thread, and the host functions
+/// with the memory to call them.
+class WasiSocket {
+public:
+  WasiSocket(bool IOUring)
+      : Exec(makeConfigure(IOUring)), Mod(""sv), Frame(&Exec, &Mod),
+        SockOpen(Env), SockConnect(Env), SockSend(Env), SockRecv(Env),
+        PollOneoff(Env) {
+    Env.init({}, "wasiBench"s, {}, {});
+    Mod.addHostMemory("memory"sv,
+                      std::make_unique<Runtime::Instance::MemoryInstance>(
+                          AST::MemoryType(32)));
+    Mem = Mod.findMemoryExports("memory"sv);
+
+    sockaddr_in Addr{};
+    Addr.sin_family = AF_INET;
+    Addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t AddrLen = sizeof(Addr);
+    Listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (Listener < 0 ||
+        ::bind(Listener, reinterpret_cast<sockaddr *>(&Addr), AddrLen) != 0 ||
+        ::listen(Listener, 1) != 0 ||
+        ::getsockname(Listener, reinterpret_cast<sockaddr *>(&Addr),
+                      &AddrLen) != 0) {
+      return;
+    }
+    Peer = std::thread([this]() {
+      const int Conn = ::accept(Listener, nullptr, nullptr);
+      if (Conn < 0) {
+        return;
+      }
+      std::array<char, 65536> Buffer;
+      ssize_t Size;
+      while ((Size = ::read(Conn, Buffer.data(), Buffer.size())) > 0) {
+        for (ssize_t Sent = 0, Res; Sent < Size; Sent += Res) {
+          if (Res = ::write(Conn, Buffer.data() + Sent, Size - Sent);
+              Res <= 0) {
+            break;
+          }
+        }
+      }
+      ::close(Conn);
+    });
+
+    std::array<ValVariant, 1> Errno;
+    const std::array<ValVariant, 3> OpenArgs = {
+        static_cast<uint32_t>(__WASI_ADDRESS_FAMILY_INET4),
+        static_cast<uint32_t>(__WASI_SOCK_TYPE_SOCK_STREAM), OutPtr};
+    if (!SockOpen.run(Frame, OpenArgs, Errno) ||
+        Errno[0].get<uint32_t>() != __WASI_ERRNO_SUCCESS) {
+      return;
+    }
+    const auto NewFd = *Mem->getPointer<int32_t *>(OutPtr);
+    const __wasi_address_t Address = {PathPtr + 8, 4};
+    std::memcpy(Mem->getPointer<__wasi_address_t *>(PathPtr), &Address,
+                sizeof(Address));
+    std::memcpy(Mem->getPointer<uint8_t *>(PathPtr + 8), &Addr.sin_addr, 4);
+    const std::array<ValVariant, 3> ConnectArgs = {
+        static_cast<uint32_t>(NewFd), PathPtr,
+        static_cast<uint32_t>(ntohs(Addr.sin_port))};
+    if (SockConnect.run(Frame, ConnectArgs, Errno) &&
+        Errno[0].get<uint32_t>() == __WASI_ERRNO_SUCCESS) {
+      Fd = NewFd;
+    }
+
+    // Wait for the readiness of the socket, with a timeout as the event loops.
+    std::array<__wasi_subscription_t, 2> Subscriptions{};
+    Subscriptions[0].u.tag = __WASI_EVENTTYPE_FD_READ;
+    Subscriptions[0].u.u.fd_read.file_descriptor = static_cast<__wasi_fd_t>(Fd);
+    Subscriptions[1].userdata = 1;
+    Subscriptions[1].u.tag = __WASI_EVENTTYPE_CLOCK;
+    Subscriptions[1].u.u.clock.id = __WASI_CLOCKID_MONOTONIC;
+    Subscriptions[1].u.u.clock.timeout = UINT64_C(1000000000);
+    std::memcpy(Mem->getPointer<__wasi_subscription_t *>(SubscriptionPtr),
+                Subscriptions.data(), sizeof(Subscriptions));
+  }
+  ~WasiSocket() noexcept {
+    // Closing the socket ends the peer.
+    Env.fini();
+    if (Peer.joinable()) {
+      Peer.join();
+    }
+    if (Listener >= 0) {
+      ::close(Listener);
+    }
+  }
+
+  bool valid() const noexcept { return Fd >= 0; }
+
+  /// Send the buffer of the size.
+  bool send(uint32_t Size) {
+    std::array<ValVariant, 1> Errno;
+    const __wasi_ciovec_t IOVec = {BufPtr, Size};
+    std::memcpy(Mem->getPointer<__wasi_ciovec_t *>(IOVecPtr), &IOVec,
+                sizeof(IOVec));
+    const std::array<ValVariant, 5> SendArgs = {
+        static_cast<uint32_t>(Fd), IOVecPtr, UINT32_C(1), UINT32_C(0), OutPtr};
+    return SockSend.run(Frame, SendArgs, Errno) &&
+           Errno[0].get<uint32_t>() == __WASI_ERRNO_SUCCESS &&
+           *Mem->getPointer<uint32_t *>(OutPtr) == Size;
+  }
+
+  /// Poll until the socket is readable.
+  bool poll() {
+    std::array<ValVariant, 1> Errno;
+    const std::array<ValVariant, 4> PollArgs = {SubscriptionPtr, EventPtr,
+                                                UINT32_C(2), OutPtr};
+    return PollOneoff.run(Frame, PollArgs, Errno) &&
+           Errno[0].get<uint32_t>() == __WASI_ERRNO_SUCCESS &&
+           *Mem->getPointer<uint32_t *>(OutPtr) == 1 &&
+           Mem->getPointer<__wasi_event_t *>(EventPtr)->userdata == 0;
+  }
+
+  /// Send the buffer of the size, and receive it back after polling.
+  bool run(uint32_t Size) {
+    if (!send(Size)) {
+      return false;
+    }
+
+    std::array<ValVariant, 1> Errno;
+    const std::array<ValVariant, 6> RecvArgs = {static_cast<uint32_t>(Fd),
+                                                IOVecPtr,
+                                                UINT32_C(1),
+                                                UINT32_C(0),
+                                                OutPtr,
+                                                OutPtr + 4};
+    for (uint32_t Received = 0; Received < Size;) {
+      if (!poll()) {
+        return false;
+      }
+      const __wasi_iovec_t RecvIOVec = {BufPtr + Received, Size - Received};
+      std::memcpy(Mem->getPointer<__wasi_iovec_t *>(IOVecPtr), &RecvIOVec,
+                  sizeof(RecvIOVec));
+      if (!SockRecv.run(Frame, RecvArgs, Errno) ||
+          Errno[0].get<uint32_t>() != __WASI_ERRNO_SUCCESS ||
+          *Mem->getPointer<uint32_t *>(OutPtr) == 0) {
+        return false;
+      }
+      Received += *Mem->getPointer<uint32_t *>(OutPtr);
+    }
+    return true;
+  }
+
+private:
+  Host::WASI::Environ Env;
+  Executor::Executor Exec;
+  Runtime::Instance::ModuleInstance Mod;
+  Runtime::CallingFrame Frame;
+  Runtime::Instance::MemoryInstance *Mem = nullptr;
+  Host::WasiSockOpenV2 SockOpen;
+  Host::WasiSockConnectV2 SockConnect;
+  Host::WasiSockSendV2 SockSend;
+  Host::WasiSockRecvV2 SockRecv;
+  Host::WasiPollOneoff<Host::WASI::TriggerType::Level> PollOneoff;
+  int Listener = -1;
+  std::thread Peer;
+  int32_t Fd = -1;
+};
+#endif
+
+void BM_WasiFdWrite(benchmark::State &State) {
+  WasiFile File(State.range(1) != 0);
+  const auto Size = static_cast<uint32_t>(State.range(0));
+  if (!File.valid()) {
+    State.SkipWithError("opening file failed");
+    return;
+  }
+  for (auto _ : State) {
+    if (!File.run(true, Size)) {
+      State.SkipWithError("writing file failed");
+      return;
+    }
+  }
+  State.SetBytesProcessed(static_cast<int64_t>(State.iterations()) * Size);
+}
+
+void BM_WasiFdRead(benchmark::State &State) {
+  WasiFile File(State.range(1) != 0);
+  const auto Size = static_cast<uint32_t>(State.range(0));
+  if (!File.valid() || !File.run(true, Size)) {
+    State.SkipWithError("preparing file failed");
+    return;
+  }
+  for (auto _ : State) {
+    if (!File.run(false, Size)) {
+      State.SkipWithError("reading file failed");
+      return;
+    }
+  }
+  State.SetBytesProcessed(static_cast<int64_t>(State.iterations()) * Size);
+}
+
+void BM_WasiFdCopy(benchmark::State &State) {
+  WasiFile File(State.range(1) != 0);
+  const auto Size = static_cast<uint32_t>(State.range(0));
+  constexpr uint32_t Total = UINT32_C(1) << 20;
+  if (!File.valid() || !File.run(true, Total)) {
+    State.SkipWithError("preparing file failed");
+    return;
+  }
+  for (auto _ : State) {
+    if (!File.copy(Size, Total)) {
+      State.SkipWithError("copying file failed");
+      return;
+    }
+  }
+  State.SetBytesProcessed(static_cast<int64_t>(State.iterations()) * Total);
+}
+
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+void BM_WasiSockEcho(benchmark::State &State) {
+  WasiSocket Socket(State.range(1) != 0);
+  const auto Size = static_cast<uint32_t>(State.range(0));
+  if (!Socket.valid()) {
+    State.SkipWithError("connecting socket failed");
+    return;
+  }
+  for (auto _ : State) {
+    if (!Socket.run(Size)) {
+      State.SkipWithError("echoing socket failed");
+      return;
+    }
+  }
+  State.SetBytesProcessed(static_cast<int64_t>(State.iterations()) * Size);
+}
+
+void BM_WasiPollOneoff(benchmark::State &State) {
+  WasiSocket Socket(State.range(0) != 0);
+  // The echoed byte is left unread, so that every poll finds the socket
+  // readable at once.
+  if (!Socket.valid() || !Socket.send(1) || !Socket.poll()) {
+    State.SkipWithError("preparing socket failed");
+    return;
+  }
+  for (auto _ : State) {
+    if (!Socket.poll()) {
+      State.SkipWithError("polling socket failed");
+      return;
+    }
+  }
+  State.SetItemsProcessed(static_cast<int64_t>(State.iterations()));
+}
+#endif
+
+// Each iteration includes a fd_seek call to rewind the file. The second
+// argument selects the io_uring backend, which falls back to the epoll one
+// where unsupported. The real time includes the work of the kernel threads.
+BENCHMARK(BM_WasiFdWrite)
+    ->ArgsProduct({benchmark::CreateRange(64, 1 << 20, 16), {0, 1}})
+    ->ArgNames({"size"s, "io_uring"s})
+    ->UseRealTime();
+BENCHMARK(BM_WasiFdRead)
+    ->ArgsProduct({benchmark::CreateRange(64, 1 << 20, 16), {0, 1}})
+    ->ArgNames({"size"s, "io_uring"s})
+    ->UseRealTime();
+// Copy 1 MiB in the chunks of the size.
+BENCHMARK(BM_WasiFdCopy)
+    ->ArgsProduct({benchmark::CreateRange(4096, 1 << 20, 16), {0, 1}})
+    ->ArgNames({"size"s, "io_uring"s})
+    ->UseRealTime();
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+BENCHMARK(BM_WasiSockEcho)
+    ->ArgsProduct({benchmark::CreateRange(64, 1 << 16, 32), {0, 1}})
+    ->ArgNames({"size"s, "io_uring"s})
+    ->UseRealTime();
+// Poll a readable socket with a timeout, as an iteration of an event loop.
+BENCHMARK(BM_WasiPollOneoff)->ArgName("io_uring"s)->Arg(0)->Arg(1);
+#endif
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -30,8 +30,12 @@ public:
     Global,
     Local,
   };
+  /// Get the cache path of Data. The Salt is hashed along with the Data to
+  /// distinguish the compiled results of the same module with different
+  /// options.
   static Expect<std::filesystem::path>
-  getPath(Span<const Byte> Data, StorageScope Scope, std::string_view Key = {});
+  getPath(Span<const Byte> Data, StorageScope Scope, std::string_view Key = {},
+          std::string_view Salt = {});
   static void clear(StorageScope Scope, std::string_view Key = {});
 };
 
@@ -96,6 +96,16 @@ typedef struct WasmEdge_Limit {
   uint32_t Max;
 } WasmEdge_Limit;
 
+/// Struct of an asynchronous invocation in a batch.
+typedef struct WasmEdge_AsyncInvocation {
+  /// Function name.
+  WasmEdge_String FuncName;
+  /// Parameter values.
+  const WasmEdge_Value *Params;
+  /// Length of the parameter values.
+  uint32_t ParamLen;
+} WasmEdge_AsyncInvocation;
+
 /// Opaque struct of WasmEdge configure.
 typedef struct WasmEdge_ConfigureContext WasmEdge_ConfigureContext;
 
@@ -524,6 +534,29 @@ WasmEdge_ValueGetFuncRef(const WasmEdge_Value Val);
 WASMEDGE_CAPI_EXPORT extern void *
 WasmEdge_ValueGetExternRef(const WasmEdge_Value Val);
 
+/// Add a root of the struct or array reference kept by the host.
+///
+/// The struct and array objects are collected when they are unreachable.
+/// The references in the returns of `WasmEdge_VMExecute`,
+/// `WasmEdge_ExecutorInvoke`, and the other invocations are rooted once each,
+/// and kept until released by `WasmEdge_ValueUnroot` or their module instance
+/// is deleted. The references in the arguments of a host function, and in the
+/// returns of the invocations in a host function, are only kept until the host
+/// function returns. Root them by this function to keep them longer. Nothing
+/// is done for the other values.
+///
+/// \param Val the WasmEdge_Value struct.
+WASMEDGE_CAPI_EXPORT extern void WasmEdge_ValueRoot(const WasmEdge_Value Val);
+
+/// Release a root of the struct or array reference kept by the host.
+///
+/// The reference should not be used after releasing its last root. Nothing is
+/// done if the reference has no root.
+///
+/// \param Val the WasmEdge_Value struct.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ValueUnroot(const WasmEdge_Value Val);
+
 // <<<<<<<< WasmEdge value functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 // >>>>>>>> WasmEdge string functions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
@@ -829,6 +862,243 @@ WasmEdge_ConfigureSetMaxMemoryPage(WasmEdge_ConfigureContext *Cxt,
 WASMEDGE_CAPI_EXPORT extern uint32_t
 WasmEdge_ConfigureGetMaxMemoryPage(const WasmEdge_ConfigureContext *Cxt);
 
+/// Set the slot count of the linear memory pool.
+///
+/// The memory instances take the pre-reserved guard-paged slots from the pool
+/// and recycle them when deleted instead of reserving and unmapping the
+/// virtual memory every time. The pool is shared in the process and reserved
+/// at the first instantiation with this option set. Set 0 to disable it.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the memory pool size.
+/// \param SlotCount the slot count of the memory pool.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureSetMemoryPoolSize(WasmEdge_ConfigureContext *Cxt,
+                                    const uint32_t SlotCount);
+
+/// Get the setting of the slot count of the linear memory pool.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the memory pool size
+/// setting.
+///
+/// \returns the slot count of the memory pool.
+WASMEDGE_CAPI_EXPORT extern uint32_t
+WasmEdge_ConfigureGetMemoryPoolSize(const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the tier-up threshold of the tiered execution.
+///
+/// With the threshold set, the functions start in the interpreter, and are
+/// compiled by the JIT in the background when their calls and loop iterations
+/// reach the threshold. The following calls of these functions run the
+/// compiled code. Set 0 to disable it.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the tier-up threshold.
+/// \param Threshold the count of calls and loop iterations to compile a
+/// function.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureSetTierUpThreshold(WasmEdge_ConfigureContext *Cxt,
+                                     const uint32_t Threshold);
+
+/// Get the setting of the tier-up threshold of the tiered execution.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the tier-up threshold
+/// setting.
+///
+/// \returns the tier-up threshold, 0 for disabled.
+WASMEDGE_CAPI_EXPORT extern uint32_t
+WasmEdge_ConfigureGetTierUpThreshold(const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the lazy JIT option.
+///
+/// With the lazy JIT, the VM runs the loaded WASM by the JIT, and each function
+/// is optimized and compiled at its first call instead of compiling the whole
+/// module at the instantiation. The functions never called are never compiled.
+/// Disabling the option also disables the JIT. The lazy compiled modules are
+/// not cached, and the option is not applied with the tiered execution.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the boolean value.
+/// \param IsEnableLazyJIT the boolean value to determine to compile the
+/// functions at their first calls by the JIT or not.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureSetEnableLazyJIT(WasmEdge_ConfigureContext *Cxt,
+                                   const bool IsEnableLazyJIT);
+
+/// Get the lazy JIT option.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the boolean value.
+///
+/// \returns the boolean value to determine to compile the functions at their
+/// first calls by the JIT or not.
+WASMEDGE_CAPI_EXPORT extern bool
+WasmEdge_ConfigureIsEnableLazyJIT(const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the thread count of loading and validating the code section.
+///
+/// With more than one thread, the function bodies are decoded and validated
+/// in parallel. The results and the reported errors are the same as the
+/// serial loading and validation.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the thread count.
+/// \param Threads the thread count. 0 will be treated as 1.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureSetLoadThreads(WasmEdge_ConfigureContext *Cxt,
+                                 const uint32_t Threads);
+
+/// Get the thread count of loading and validating the code section.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the thread count.
+///
+/// \returns the thread count.
+WASMEDGE_CAPI_EXPORT extern uint32_t
+WasmEdge_ConfigureGetLoadThreads(const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the thread count of the asynchronous executions.
+///
+/// With 0 thread, which is the default, every asynchronous execution runs on
+/// its own thread. Otherwise, the asynchronous executions of a VM context
+/// share a thread pool of the thread count. The executions waiting for the
+/// results of the others run the queued ones meanwhile, but the executions
+/// waiting on each other through the shared memories should not exceed the
+/// thread count in this case.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the thread count.
+/// \param Threads the thread count.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureSetAsyncThreads(WasmEdge_ConfigureContext *Cxt,
+                                  const uint32_t Threads);
+
+/// Get the thread count of the asynchronous executions.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the thread count.
+///
+/// \returns the thread count.
+WASMEDGE_CAPI_EXPORT extern uint32_t
+WasmEdge_ConfigureGetAsyncThreads(const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the stack size of an execution in bytes.
+///
+/// The stack holds the call frames, the exception handlers, and the values of
+/// the interpreter, and is never grown. An execution exhausting the stack
+/// fails with the `call stack exhausted` error. The default is 32 MiB, and the
+/// size is rounded up to a multiple of 64 KiB.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the stack size.
+/// \param Size the stack size in bytes.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureSetStackSize(WasmEdge_ConfigureContext *Cxt,
+                               const uint64_t Size);
+
+/// Get the stack size of an execution in bytes.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the stack size.
+///
+/// \returns the stack size in bytes.
+WASMEDGE_CAPI_EXPORT extern uint64_t
+WasmEdge_ConfigureGetStackSize(const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the lazy loading option.
+///
+/// With the lazy loading, the loader keeps only the bytes of the function
+/// bodies. A body is decoded and validated at the first call in the
+/// interpreter, and the malformed or invalid body is reported as the error of
+/// the call. The option is not applied with the JIT and the tiered execution.
+/// The lazy loaded AST module cannot be compiled by the AOT compiler.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the boolean value.
+/// \param IsEnableLazyLoading the boolean value to determine to decode the
+/// function bodies at their first calls or not.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureSetEnableLazyLoading(WasmEdge_ConfigureContext *Cxt,
+                                       const bool IsEnableLazyLoading);
+
+/// Get the lazy loading option.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the boolean value.
+///
+/// \returns the boolean value to determine to decode the function bodies at
+/// their first calls or not.
+WASMEDGE_CAPI_EXPORT extern bool
+WasmEdge_ConfigureIsEnableLazyLoading(const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the io_uring option.
+///
+/// With the io_uring option on Linux, the WASI reads, the socket I/O, and the
+/// polling are submitted through io_uring. The small writes and the writes to
+/// the regular files keep the syscalls. The epoll backend is used if io_uring
+/// is unsupported.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the boolean value.
+/// \param IsEnableIOUring the boolean value to determine to use io_uring for
+/// the WASI I/O or not.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureSetEnableIOUring(WasmEdge_ConfigureContext *Cxt,
+                                   const bool IsEnableIOUring);
+
+/// Get the io_uring option.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the boolean value.
+///
+/// \returns the boolean value to determine to use io_uring for the WASI I/O or
+/// not.
+WASMEDGE_CAPI_EXPORT extern bool
+WasmEdge_ConfigureIsEnableIOUring(const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the maximum size of the io_uring fixed buffer.
+///
+/// With the io_uring option, the linear memory is registered as the fixed
+/// buffer only if its size is not larger than this value, since the
+/// registration pins all of its pages. The default value is 0, which disables
+/// the registration.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the maximum size.
+/// \param Size the maximum size in bytes of the registered linear memory.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureSetMaxIOUringBufferSize(WasmEdge_ConfigureContext *Cxt,
+                                          const uint64_t Size);
+
+/// Get the maximum size of the io_uring fixed buffer.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the maximum size.
+///
+/// \returns the maximum size in bytes of the registered linear memory.
+WASMEDGE_CAPI_EXPORT extern uint64_t
+WasmEdge_ConfigureGetMaxIOUringBufferSize(const WasmEdge_ConfigureContext *Cxt);
+
 /// Set the force interpreter mode execution option.
 ///
 /// This function is thread-safe.
@@ -851,6 +1121,56 @@ WasmEdge_ConfigureSetForceInterpreter(WasmEdge_ConfigureContext *Cxt,
 WASMEDGE_CAPI_EXPORT extern bool
 WasmEdge_ConfigureIsForceInterpreter(const WasmEdge_ConfigureContext *Cxt);
 
+/// Set the threaded interpreter option.
+///
+/// The interpreter runs the instructions without the statistics in the
+/// threaded code, where the common instructions jump to each other by the
+/// computed gotos, instead of the switch loop. Enabled by default, and only
+/// supported by the GCC and Clang builds.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the boolean value.
+/// \param IsEnableThreadedInterpreter the boolean value to determine to run
+/// the threaded code or not.
+WASMEDGE_CAPI_EXPORT extern void WasmEdge_ConfigureSetEnableThreadedInterpreter(
+    WasmEdge_ConfigureContext *Cxt, const bool IsEnableThreadedInterpreter);
+
+/// Get the threaded interpreter option.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the boolean value.
+///
+/// \returns the boolean value to determine to run the threaded code or not.
+WASMEDGE_CAPI_EXPORT extern bool WasmEdge_ConfigureIsEnableThreadedInterpreter(
+    const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the register interpreter option.
+///
+/// The interpreter runs the native functions without the statistics in the
+/// register code, where the operands are lowered to the slots of the frame.
+/// The functions which cannot be lowered, such as the ones with the calls, run
+/// by the stack machine. Enabled by default.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the boolean value.
+/// \param IsEnableRegisterInterpreter the boolean value to determine to run
+/// the register code or not.
+WASMEDGE_CAPI_EXPORT extern void WasmEdge_ConfigureSetEnableRegisterInterpreter(
+    WasmEdge_ConfigureContext *Cxt, const bool IsEnableRegisterInterpreter);
+
+/// Get the register interpreter option.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the boolean value.
+///
+/// \returns the boolean value to determine to run the register code or not.
+WASMEDGE_CAPI_EXPORT extern bool WasmEdge_ConfigureIsEnableRegisterInterpreter(
+    const WasmEdge_ConfigureContext *Cxt);
+
 /// Set the option of enabling/disabling AF_UNIX support in the WASI socket.
 ///
 /// This function is thread-safe.
@@ -980,6 +1300,30 @@ WasmEdge_ConfigureCompilerSetInterruptible(WasmEdge_ConfigureContext *Cxt,
 WASMEDGE_CAPI_EXPORT extern bool
 WasmEdge_ConfigureCompilerIsInterruptible(const WasmEdge_ConfigureContext *Cxt);
 
+/// Set the thread count of the AOT compiler.
+///
+/// With more than one thread, the AOT compiler splits the module into
+/// partitions and optimizes and emits them in parallel. The default value is 1.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the thread count.
+/// \param Threads the thread count. 0 for the hardware concurrency, the same
+/// as the `--threads 0` option of `wasmedgec`.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureCompilerSetThreads(WasmEdge_ConfigureContext *Cxt,
+                                     const uint32_t Threads);
+
+/// Get the thread count of the AOT compiler.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the thread count.
+///
+/// \returns the thread count of the AOT compiler.
+WASMEDGE_CAPI_EXPORT extern uint32_t
+WasmEdge_ConfigureCompilerGetThreads(const WasmEdge_ConfigureContext *Cxt);
+
 /// Set the instruction counting option for the statistics.
 ///
 /// This function is thread-safe.
@@ -1047,6 +1391,36 @@ WasmEdge_ConfigureStatisticsSetTimeMeasuring(WasmEdge_ConfigureContext *Cxt,
 WASMEDGE_CAPI_EXPORT extern bool WasmEdge_ConfigureStatisticsIsTimeMeasuring(
     const WasmEdge_ConfigureContext *Cxt);
 
+/// Set the batched metering option for the statistics.
+///
+/// In the batched metering mode, the instruction counts and the costs are
+/// accumulated per basic block by the executing thread, and only charged and
+/// checked against the cost limit at loop headers, calls, and function exits.
+/// The execution may exceed the cost limit by the costs of the instructions
+/// after the last check before it traps.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the boolean value.
+/// \param IsBatched the boolean value to determine to batch the instruction
+/// counting and cost measuring when execution or not after compilation by the
+/// AOT compiler.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureStatisticsSetBatchedMetering(WasmEdge_ConfigureContext *Cxt,
+                                               const bool IsBatched);
+
+/// Get the batched metering option for the statistics.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the boolean value.
+///
+/// \returns the boolean value to determine to batch the instruction counting
+/// and cost measuring when execution or not after compilation by the AOT
+/// compiler.
+WASMEDGE_CAPI_EXPORT extern bool WasmEdge_ConfigureStatisticsIsBatchedMetering(
+    const WasmEdge_ConfigureContext *Cxt);
+
 /// Deletion of the WasmEdge_ConfigureContext.
 ///
 /// After calling this function, the context will be destroyed and should
@@ -2902,6 +3276,36 @@ WASMEDGE_CAPI_EXPORT extern WasmEdge_Result
 WasmEdge_MemoryInstanceGrowPage(WasmEdge_MemoryInstanceContext *Cxt,
                                 const uint32_t Page);
 
+/// Capture the current data and page size of a memory instance.
+///
+/// The captured image can be restored by
+/// `WasmEdge_MemoryInstanceResetToSnapshot`. Capturing again replaces the
+/// previous image. This is usually called right after the instantiation to
+/// reuse the instantiated module for many executions. Shared memories are not
+/// supported, because other threads may still be accessing them.
+///
+/// \param Cxt the WasmEdge_MemoryInstanceContext.
+///
+/// \returns WasmEdge_Result. Call `WasmEdge_ResultGetMessage` for the error
+/// message.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_Result
+WasmEdge_MemoryInstanceSnapshot(WasmEdge_MemoryInstanceContext *Cxt);
+
+/// Reset a memory instance to the image captured by
+/// `WasmEdge_MemoryInstanceSnapshot`.
+///
+/// The data and the page size are restored. On Linux, only the pages modified
+/// after the capture are discarded, so the cost is proportional to the dirty
+/// pages instead of the memory size. The pointers got by
+/// `WasmEdge_MemoryInstanceGetPointer` before may be invalidated.
+///
+/// \param Cxt the WasmEdge_MemoryInstanceContext.
+///
+/// \returns WasmEdge_Result. Call `WasmEdge_ResultGetMessage` for the error
+/// message.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_Result
+WasmEdge_MemoryInstanceResetToSnapshot(WasmEdge_MemoryInstanceContext *Cxt);
+
 /// Deletion of the WasmEdge_MemoryInstanceContext.
 ///
 /// After calling this function, the context will be destroyed and should
@@ -3057,7 +3461,8 @@ WASMEDGE_CAPI_EXPORT void WasmEdge_AsyncWait(const WasmEdge_Async *Cxt);
 WASMEDGE_CAPI_EXPORT bool WasmEdge_AsyncWaitFor(const WasmEdge_Async *Cxt,
                                                 uint64_t Milliseconds);
 
-/// Cancel a WasmEdge_Async execution.
+/// Cancel a WasmEdge_Async execution. The other executions of the same VM or
+/// executor context keep running.
 ///
 /// \param Cxt the WasmEdge_ASync.
 WASMEDGE_CAPI_EXPORT void WasmEdge_AsyncCancel(WasmEdge_Async *Cxt);
@@ -3673,6 +4078,26 @@ WASMEDGE_CAPI_EXPORT extern WasmEdge_Async *WasmEdge_VMAsyncExecuteRegistered(
     const WasmEdge_String FuncName, const WasmEdge_Value *Params,
     const uint32_t ParamLen);
 
+/// Asynchronous invoke WASM functions by names in a batch.
+///
+/// The same as calling `WasmEdge_VMAsyncExecute` for each invocation, but the
+/// invocations are submitted at once to the thread pool set by
+/// `WasmEdge_ConfigureSetAsyncThreads`.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_VMContext.
+/// \param Invocations the WasmEdge_AsyncInvocation buffer with the function
+/// names and the parameter values.
+/// \param Len the length of the invocation buffer.
+/// \param [out] Asyncs the WasmEdge_Async buffer to fill the results of the
+/// invocations in order. Call `WasmEdge_AsyncGet` for each result, and call
+/// `WasmEdge_AsyncDelete` to destroy each object. Filled with NULL if the VM
+/// context is NULL.
+WASMEDGE_CAPI_EXPORT extern void WasmEdge_VMAsyncExecuteBatch(
+    WasmEdge_VMContext *Cxt, const WasmEdge_AsyncInvocation *Invocations,
+    const uint32_t Len, WasmEdge_Async **Asyncs);
+
 /// Get the function type by function name.
 ///
 /// After instantiating a WASM module in the VM context, the WASM module is
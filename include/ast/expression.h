@@ -26,10 +26,16 @@ public:
   InstrView getInstrs() const noexcept { return Instrs; }
   InstrVec &getInstrs() noexcept { return Instrs; }
 
+  /// Getter of the side buffer of the immediates of the instructions. The
+  /// copies of the instructions should keep a copy of the buffer.
+  const ImmediateBuffer &getImmediates() const noexcept { return Immediates; }
+  ImmediateBuffer &getImmediates() noexcept { return Immediates; }
+
 private:
   /// \name Data of Expression.
   /// @{
   InstrVec Instrs;
+  ImmediateBuffer Immediates;
   /// @}
 };
 
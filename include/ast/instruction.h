@@ -18,11 +18,59 @@
 #include "common/types.h"
 
 #include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <type_traits>
 #include <vector>
 
 namespace WasmEdge {
 namespace AST {
 
+/// Side buffer of the variable-length immediates of the instructions in an
+/// expression: the label lists, the value type lists, the cast descriptors,
+/// and the try descriptors. The instructions refer to the immediates by
+/// pointers, and the copies of the buffer share the same chunks, which are
+/// never moved and are released with the last copy.
+class ImmediateBuffer {
+public:
+  /// Allocate N value-initialized objects.
+  template <typename T> T *allocate(uint32_t N) {
+    static_assert(std::is_trivially_destructible_v<T>);
+    static_assert(alignof(T) <= alignof(std::max_align_t));
+    if (!Storage) {
+      Storage = std::make_shared<Chunks>();
+    }
+    const size_t Size = sizeof(T) * N;
+    size_t Pos = (Storage->Used + alignof(T) - 1) / alignof(T) * alignof(T);
+    if (Storage->List.empty() || Pos + Size > Storage->Capacity) {
+      Storage->Capacity = std::max(kChunkSize, Size);
+      Storage->List.emplace_back(new std::byte[Storage->Capacity]);
+      Storage->Total += Storage->Capacity;
+      Pos = 0;
+    }
+    Storage->Used = Pos + Size;
+    T *Ptr = reinterpret_cast<T *>(Storage->List.back().get() + Pos);
+    std::uninitialized_value_construct_n(Ptr, N);
+    return Ptr;
+  }
+
+  /// Getter of the allocated bytes of the chunks.
+  size_t size() const noexcept { return Storage ? Storage->Total : 0; }
+
+private:
+  /// Size of the chunks, except the larger immediates in their own chunks.
+  static inline constexpr const size_t kChunkSize = 1024;
+
+  struct Chunks {
+    std::vector<std::unique_ptr<std::byte[]>> List;
+    size_t Used = 0;
+    size_t Capacity = 0;
+    size_t Total = 0;
+  };
+  std::shared_ptr<Chunks> Storage;
+};
+
 /// Instruction node class.
 class Instruction {
 public:
@@ -49,7 +97,7 @@ public:
     BlockType ResType;
     uint32_t BlockParamNum;
     uint32_t JumpEnd;
-    std::vector<CatchDescriptor> Catch;
+    Span<CatchDescriptor> Catch;
   };
   // LEGACY-EH: remove this struct after deprecating legacy EH.
   struct CatchDescriptorLegacy {
@@ -58,71 +106,53 @@ public:
     uint32_t CatchIndex;
     uint32_t CatchPCOffset;
   };
+  /// Superinstruction kinds. The validator tags the first instruction of a
+  /// fusible sequence, and the interpreter runs the whole sequence in a single
+  /// dispatch.
+  enum class FusedKind : uint8_t {
+    None,
+    // local.get, local.get, binop
+    LocalLocalBinOp,
+    // local.get, const, binop
+    LocalConstBinOp,
+    // local.get, const, binop, local.set or local.tee
+    LocalConstBinOpSet,
+    // relop or eqz, br_if
+    CompareBrIf,
+  };
 
 public:
   /// Constructor assigns the OpCode and the Offset.
   Instruction(OpCode Byte, uint32_t Off = 0) noexcept
-      : Offset(Off), Code(Byte) {
-#if defined(__x86_64__) || defined(__aarch64__) ||                             \
-    (defined(__riscv) && __riscv_xlen == 64)
-    Data.Num = static_cast<uint128_t>(0);
-#else
-    Data.Num.Low = static_cast<uint64_t>(0);
-    Data.Num.High = static_cast<uint64_t>(0);
-#endif
-    Flags.IsAllocLabelList = false;
-    Flags.IsAllocValTypeList = false;
-    Flags.IsAllocBrCast = false;
-    Flags.IsAllocTryCatch = false;
-  }
-
-  /// Copy constructor.
-  Instruction(const Instruction &Instr) noexcept
-      : Data(Instr.Data), Offset(Instr.Offset), Code(Instr.Code),
-        Flags(Instr.Flags) {
-    if (Flags.IsAllocLabelList) {
-      Data.BrTable.LabelList = new JumpDescriptor[Data.BrTable.LabelListSize];
-      std::copy_n(Instr.Data.BrTable.LabelList, Data.BrTable.LabelListSize,
-                  Data.BrTable.LabelList);
-    } else if (Flags.IsAllocValTypeList) {
-      Data.SelectT.ValTypeList = new ValType[Data.SelectT.ValTypeListSize];
-      std::copy_n(Instr.Data.SelectT.ValTypeList, Data.SelectT.ValTypeListSize,
-                  Data.SelectT.ValTypeList);
-    } else if (Flags.IsAllocBrCast) {
-      Data.BrCast = new BrCastDescriptor(*Instr.Data.BrCast);
-    } else if (Flags.IsAllocTryCatch) {
-      Data.TryCatch = new TryDescriptor(*Instr.Data.TryCatch);
-    }
-  }
-
-  /// Move constructor.
-  Instruction(Instruction &&Instr) noexcept
-      : Data(Instr.Data), Offset(Instr.Offset), Code(Instr.Code),
-        Flags(Instr.Flags) {
-    Instr.Flags.IsAllocLabelList = false;
-    Instr.Flags.IsAllocValTypeList = false;
-    Instr.Flags.IsAllocBrCast = false;
-    Instr.Flags.IsAllocTryCatch = false;
-  }
-
-  /// Destructor.
-  ~Instruction() { reset(); }
-
-  /// Copy assignment.
-  Instruction &operator=(const Instruction &Instr) {
-    if (this != &Instr) {
-      Instruction Tmp(Instr);
-      Tmp.swap(*this);
-    }
-    return *this;
+      : Offset(Off), Code(static_cast<uint16_t>(Byte)) {
+    Data.Num[0] = static_cast<uint64_t>(0);
+    Data.Num[1] = static_cast<uint64_t>(0);
+    Flags.Fused = static_cast<uint8_t>(FusedKind::None);
+    Flags.IsBlockLeader = false;
   }
 
   /// Getter of OpCode.
-  OpCode getOpCode() const noexcept { return Code; }
+  OpCode getOpCode() const noexcept { return static_cast<OpCode>(Code); }
 
   /// Getter of Offset.
   uint32_t getOffset() const noexcept { return Offset; }
 
+  /// Getter and setter of the superinstruction kind.
+  FusedKind getFusedKind() const noexcept {
+    return static_cast<FusedKind>(Flags.Fused);
+  }
+  void setFusedKind(FusedKind Kind) noexcept {
+    Flags.Fused = static_cast<uint8_t>(Kind);
+  }
+
+  /// Getter and setter of the basic block leader flag. The validator marks the
+  /// first instruction of every basic block, and the interpreter charges the
+  /// whole block at it in the batched metering mode.
+  bool isBlockLeader() const noexcept { return Flags.IsBlockLeader; }
+  void setBlockLeader(bool Leader = true) noexcept {
+    Flags.IsBlockLeader = Leader;
+  }
+
   /// Getter and setter of block type.
   const BlockType &getBlockType() const noexcept { return Data.Blocks.ResType; }
   BlockType &getBlockType() noexcept { return Data.Blocks.ResType; }
@@ -139,24 +169,18 @@ public:
   const ValType &getValType() const noexcept { return Data.VType; }
   void setValType(const ValType &VType) noexcept { Data.VType = VType; }
 
-  /// Getter and setter of label list.
-  void setLabelListSize(uint32_t Size) {
-    reset();
-    if (Size > 0) {
-      Data.BrTable.LabelListSize = Size;
-      Data.BrTable.LabelList = new JumpDescriptor[Size];
-      Flags.IsAllocLabelList = true;
-    }
+  /// Getter and setter of label list, allocated in the side buffer.
+  void setLabelListSize(uint32_t Size, ImmediateBuffer &Buffer) {
+    Data.BrTable.LabelListSize = Size;
+    Data.BrTable.LabelList = Buffer.allocate<JumpDescriptor>(Size);
   }
   Span<const JumpDescriptor> getLabelList() const noexcept {
-    return Span<const JumpDescriptor>(
-        Data.BrTable.LabelList,
-        Flags.IsAllocLabelList ? Data.BrTable.LabelListSize : 0);
+    return Span<const JumpDescriptor>(Data.BrTable.LabelList,
+                                      Data.BrTable.LabelListSize);
   }
   Span<JumpDescriptor> getLabelList() noexcept {
-    return Span<JumpDescriptor>(
-        Data.BrTable.LabelList,
-        Flags.IsAllocLabelList ? Data.BrTable.LabelListSize : 0);
+    return Span<JumpDescriptor>(Data.BrTable.LabelList,
+                                Data.BrTable.LabelListSize);
   }
 
   /// Getter and setter of expression end for End instruction.
@@ -180,24 +204,39 @@ public:
     Data.EndFlags.IsLegacyTryBlockLast = Last;
   }
 
+  /// Getter and setter of the max operand stack height of the function body
+  /// for the End instruction of the expression end. Set by the validator.
+  uint32_t getStackHeight() const noexcept {
+    return Data.EndFlags.StackHeight;
+  }
+  void setStackHeight(uint32_t Height) noexcept {
+    Data.EndFlags.StackHeight = Height;
+  }
+
   /// Getter and setter of Jump for Br* instruction.
   const JumpDescriptor &getJump() const noexcept { return Data.Jump; }
   JumpDescriptor &getJump() noexcept { return Data.Jump; }
 
-  /// Getter and setter of selecting value types list.
-  void setValTypeListSize(uint32_t Size) {
-    reset();
-    if (Size > 0) {
-      Data.SelectT.ValTypeListSize = Size;
-      Data.SelectT.ValTypeList = new ValType[Size];
-      Flags.IsAllocValTypeList = true;
+  /// Getter and setter of selecting value types list. The list of a single
+  /// value type, which is the only valid case, is stored inline instead of in
+  /// the side buffer.
+  void setValTypeListSize(uint32_t Size, ImmediateBuffer &Buffer) {
+    Data.SelectT.ValTypeListSize = Size;
+    if (Size > 1) {
+      Data.SelectT.ValTypeList = Buffer.allocate<ValType>(Size);
     }
   }
   Span<const ValType> getValTypeList() const noexcept {
+    if (Data.SelectT.ValTypeListSize == 1) {
+      return Span<const ValType>(&Data.SelectT.ValTypeInline, 1);
+    }
     return Span<const ValType>(Data.SelectT.ValTypeList,
                                Data.SelectT.ValTypeListSize);
   }
   Span<ValType> getValTypeList() noexcept {
+    if (Data.SelectT.ValTypeListSize == 1) {
+      return Span<ValType>(&Data.SelectT.ValTypeInline, 1);
+    }
     return Span<ValType>(Data.SelectT.ValTypeList,
                          Data.SelectT.ValTypeListSize);
   }
@@ -218,13 +257,13 @@ public:
   uint32_t getMemoryAlign() const noexcept { return Data.Memories.MemAlign; }
   uint32_t &getMemoryAlign() noexcept { return Data.Memories.MemAlign; }
 
-  /// Getter of memory offset.
-  uint32_t getMemoryOffset() const noexcept { return Data.Memories.MemOffset; }
-  uint32_t &getMemoryOffset() noexcept { return Data.Memories.MemOffset; }
+  /// Getter of memory offset. The offset is 64-bit for the memory64 proposal.
+  uint64_t getMemoryOffset() const noexcept { return Data.Memories.MemOffset; }
+  uint64_t &getMemoryOffset() noexcept { return Data.Memories.MemOffset; }
 
   /// Getter of memory lane.
-  uint8_t getMemoryLane() const noexcept { return Data.Memories.MemLane; }
-  uint8_t &getMemoryLane() noexcept { return Data.Memories.MemLane; }
+  uint8_t getMemoryLane() const noexcept { return MemLane; }
+  uint8_t &getMemoryLane() noexcept { return MemLane; }
 
   // LEGACY-EH: remove these functions after deprecating legacy EH.
   /// Getter and setter of legacy Catch for Catch* instructions.
@@ -235,70 +274,32 @@ public:
 
   /// Getter and setter of the constant value.
   ValVariant getNum() const noexcept {
-#if defined(__x86_64__) || defined(__aarch64__) ||                             \
-    (defined(__riscv) && __riscv_xlen == 64)
-    return ValVariant(Data.Num);
-#else
-    uint128_t N(Data.Num.High, Data.Num.Low);
+    uint128_t N;
+    std::memcpy(&N, Data.Num, sizeof(uint128_t));
     return ValVariant(N);
-#endif
   }
   void setNum(ValVariant N) noexcept {
-#if defined(__x86_64__) || defined(__aarch64__) ||                             \
-    (defined(__riscv) && __riscv_xlen == 64)
-    Data.Num = N.get<uint128_t>();
-#else
-    std::memcpy(&Data.Num, &N.get<uint128_t>(), sizeof(uint128_t));
-#endif
+    std::memcpy(Data.Num, &N.get<uint128_t>(), sizeof(uint128_t));
   }
 
-  /// Getter and setter of BrCast info for Br_cast instructions.
-  void setBrCast(uint32_t LabelIdx) {
-    reset();
-    Data.BrCast = new BrCastDescriptor();
+  /// Getter and setter of BrCast info for Br_cast instructions, allocated in
+  /// the side buffer.
+  void setBrCast(uint32_t LabelIdx, ImmediateBuffer &Buffer) {
+    Data.BrCast = Buffer.allocate<BrCastDescriptor>(1);
     Data.BrCast->Jump.TargetIndex = LabelIdx;
-    Flags.IsAllocBrCast = true;
   }
   const BrCastDescriptor &getBrCast() const noexcept { return *Data.BrCast; }
   BrCastDescriptor &getBrCast() noexcept { return *Data.BrCast; }
 
-  /// Getter and setter of try block info for try_table instruction.
-  void setTryCatch() {
-    reset();
-    Data.TryCatch = new TryDescriptor();
-    Flags.IsAllocTryCatch = true;
+  /// Getter and setter of try block info for try_table instruction, allocated
+  /// in the side buffer.
+  void setTryCatch(ImmediateBuffer &Buffer) {
+    Data.TryCatch = Buffer.allocate<TryDescriptor>(1);
   }
   const TryDescriptor &getTryCatch() const noexcept { return *Data.TryCatch; }
   TryDescriptor &getTryCatch() noexcept { return *Data.TryCatch; }
 
 private:
-  /// Release allocated resources.
-  void reset() noexcept {
-    if (Flags.IsAllocLabelList) {
-      Data.BrTable.LabelListSize = 0;
-      delete[] Data.BrTable.LabelList;
-    } else if (Flags.IsAllocValTypeList) {
-      Data.SelectT.ValTypeListSize = 0;
-      delete[] Data.SelectT.ValTypeList;
-    } else if (Flags.IsAllocBrCast) {
-      delete Data.BrCast;
-    } else if (Flags.IsAllocTryCatch) {
-      delete Data.TryCatch;
-    }
-    Flags.IsAllocLabelList = false;
-    Flags.IsAllocValTypeList = false;
-    Flags.IsAllocBrCast = false;
-    Flags.IsAllocTryCatch = false;
-  }
-
-  /// Swap function.
-  void swap(Instruction &Instr) noexcept {
-    std::swap(Data, Instr.Data);
-    std::swap(Offset, Instr.Offset);
-    std::swap(Code, Instr.Code);
-    std::swap(Flags, Instr.Flags);
-  }
-
   /// \name Data of instructions.
   /// @{
   union Inner {
@@ -326,31 +327,28 @@ private:
     // Type 6: ValTypeList.
     struct {
       uint32_t ValTypeListSize;
-      ValType *ValTypeList;
+      union {
+        ValType *ValTypeList;
+        ValType ValTypeInline;
+      };
     } SelectT;
-    // Type 7: TargetIdx, MemAlign, MemOffset, and MemLane.
+    // Type 7: TargetIdx, MemAlign, and MemOffset. The MemLane is stored out of
+    // the union.
     struct {
       uint32_t TargetIdx;
       uint32_t MemAlign;
-      uint32_t MemOffset;
-      uint8_t MemLane;
+      uint64_t MemOffset;
     } Memories;
-    // Type 8: Num.
-#if defined(__x86_64__) || defined(__aarch64__) ||                             \
-    (defined(__riscv) && __riscv_xlen == 64)
-    uint128_t Num;
-#else
-    struct {
-      uint64_t Low;
-      uint64_t High;
-    } Num;
-#endif
+    // Type 8: Num. Stored in the 8-byte words, for the 16-byte alignment of
+    // the uint128_t pads every instruction.
+    uint64_t Num[2];
     // Type 9: End flags.
     struct {
       bool IsExprLast : 1;
       bool IsTryBlockLast : 1;
       // LEGACY-EH: remove this flag after deprecating legacy EH.
       bool IsLegacyTryBlockLast : 1;
+      uint32_t StackHeight;
     } EndFlags;
     // Type 10: TypeCastBranch.
     BrCastDescriptor *BrCast;
@@ -361,16 +359,21 @@ private:
     CatchDescriptorLegacy CatchLegacy;
   } Data;
   uint32_t Offset = 0;
-  OpCode Code = OpCode::End;
+  /// The OpCode enumeration is stored in 2 bytes.
+  uint16_t Code = static_cast<uint16_t>(OpCode::End);
   struct {
-    bool IsAllocLabelList : 1;
-    bool IsAllocValTypeList : 1;
-    bool IsAllocBrCast : 1;
-    bool IsAllocTryCatch : 1;
+    uint8_t Fused : 3;
+    bool IsBlockLeader : 1;
   } Flags;
+  uint8_t MemLane = 0;
   /// @}
 };
 
+static_assert(sizeof(void *) != 8 || sizeof(Instruction) == 24,
+              "Instruction should be 24 bytes on the 64-bit platforms");
+static_assert(std::is_trivially_copyable_v<Instruction>,
+              "Instruction should own no immediates");
+
 // Type aliasing
 using InstrVec = std::vector<Instruction>;
 using InstrView = Span<const Instruction>;
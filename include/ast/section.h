@@ -23,6 +23,7 @@
 #include "ast/segment.h"
 
 #include <optional>
+#include <utility>
 #include <vector>
 
 namespace WasmEdge {
@@ -288,6 +289,12 @@ public:
   constexpr const auto &getSections() const noexcept { return Sections; }
   constexpr auto &getSections() noexcept { return Sections; }
 
+  /// Getter of the offsets and the sizes of the section contents in the input
+  /// file. The contents of the sections with non-empty ranges are left in the
+  /// file to be mapped instead of copied into the sections.
+  constexpr const auto &getFileRanges() const noexcept { return FileRanges; }
+  constexpr auto &getFileRanges() noexcept { return FileRanges; }
+
 private:
   /// \name Data of AOTSection.
   /// @{
@@ -300,6 +307,7 @@ private:
   std::vector<uintptr_t> CodesAddress;
   std::vector<std::tuple<uint8_t, uint64_t, uint64_t, std::vector<Byte>>>
       Sections;
+  std::vector<std::pair<uint64_t, uint64_t>> FileRanges;
   std::vector<uint8_t> Bytecodes;
   /// @}
 };
@@ -16,7 +16,9 @@
 
 #include "ast/expression.h"
 #include "ast/type.h"
+#include "common/errcode.h"
 
+#include <functional>
 #include <vector>
 
 namespace WasmEdge {
@@ -100,6 +102,9 @@ private:
 /// AST CodeSegment node.
 class CodeSegment : public Segment {
 public:
+  /// Decoder of the lazy loaded function body.
+  using LazyBody = std::function<Expect<Expression>()>;
+
   /// Getter and setter of segment size.
   uint32_t getSegSize() const noexcept { return SegSize; }
   void setSegSize(uint32_t Size) noexcept { SegSize = Size; }
@@ -116,12 +121,24 @@ public:
   const auto &getSymbol() const noexcept { return FuncSymbol; }
   void setSymbol(Symbol<void> S) noexcept { FuncSymbol = std::move(S); }
 
+  /// Getter and setter of lazy loaded body. The expression is empty if the
+  /// body is lazy loaded, and the decoder returns the expression.
+  const LazyBody &getLazyBody() const noexcept { return Lazy; }
+  void setLazyBody(LazyBody Body) noexcept { Lazy = std::move(Body); }
+
+  /// Getter and setter of the validated flag. The body validated while the
+  /// module is loading is skipped by the validation of the module.
+  bool getIsValidated() const noexcept { return IsValidated; }
+  void setIsValidated(bool V = true) noexcept { IsValidated = V; }
+
 private:
   /// \name Data of CodeSegment node.
   /// @{
   uint32_t SegSize = 0;
   std::vector<std::pair<uint32_t, ValType>> Locals;
   Symbol<void> FuncSymbol;
+  LazyBody Lazy;
+  bool IsValidated = false;
   /// @}
 };
 
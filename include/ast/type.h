@@ -33,14 +33,18 @@ public:
     HasMin = 0x00,
     HasMinMax = 0x01,
     SharedNoMax = 0x02,
-    Shared = 0x03
+    Shared = 0x03,
+    I64HasMin = 0x04,
+    I64HasMinMax = 0x05,
+    I64SharedNoMax = 0x06,
+    I64Shared = 0x07
   };
 
   /// Constructors.
   Limit() noexcept : Type(LimitType::HasMin), Min(0U), Max(0U) {}
-  Limit(uint32_t MinVal) noexcept
+  Limit(uint64_t MinVal) noexcept
       : Type(LimitType::HasMin), Min(MinVal), Max(MinVal) {}
-  Limit(uint32_t MinVal, uint32_t MaxVal, bool Shared = false) noexcept
+  Limit(uint64_t MinVal, uint64_t MaxVal, bool Shared = false) noexcept
       : Min(MinVal), Max(MaxVal) {
     if (Shared) {
       Type = LimitType::Shared;
@@ -51,25 +55,31 @@ public:
 
   /// Getter and setter of limit mode.
   bool hasMax() const noexcept {
-    return Type == LimitType::HasMinMax || Type == LimitType::Shared;
+    return (static_cast<uint8_t>(Type) & 0x01U) != 0U;
+  }
+  bool isShared() const noexcept {
+    return Type == LimitType::Shared || Type == LimitType::I64Shared;
+  }
+  /// The 64-bit limits are of the memories with the i64 addresses.
+  bool is64() const noexcept {
+    return (static_cast<uint8_t>(Type) & 0x04U) != 0U;
   }
-  bool isShared() const noexcept { return Type == LimitType::Shared; }
   void setType(LimitType TargetType) noexcept { Type = TargetType; }
 
   /// Getter and setter of min value.
-  uint32_t getMin() const noexcept { return Min; }
-  void setMin(uint32_t Val) noexcept { Min = Val; }
+  uint64_t getMin() const noexcept { return Min; }
+  void setMin(uint64_t Val) noexcept { Min = Val; }
 
   /// Getter and setter of max value.
-  uint32_t getMax() const noexcept { return Max; }
-  void setMax(uint32_t Val) noexcept { Max = Val; }
+  uint64_t getMax() const noexcept { return Max; }
+  void setMax(uint64_t Val) noexcept { Max = Val; }
 
 private:
   /// \name Data of Limit.
   /// @{
   LimitType Type;
-  uint32_t Min;
-  uint32_t Max;
+  uint64_t Min;
+  uint64_t Max;
   /// @}
 };
 
@@ -661,6 +671,11 @@ public:
   const Limit &getLimit() const noexcept { return Lim; }
   Limit &getLimit() noexcept { return Lim; }
 
+  /// Getter of the address type, which is i64 for the 64-bit memories.
+  ValType getAddrType() const noexcept {
+    return Lim.is64() ? TypeCode::I64 : TypeCode::I32;
+  }
+
 private:
   /// \name Data of MemoryType.
   /// @{
@@ -14,9 +14,16 @@
 #pragma once
 
 #include "errcode.h"
+#include "system/threadpool.h"
 
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <future>
+#include <memory>
 #include <thread>
+#include <tuple>
+#include <utility>
 
 namespace WasmEdge {
 
@@ -24,18 +31,35 @@ namespace WasmEdge {
 template <typename T> class Async {
 public:
   Async() noexcept = default;
+  /// Run the function on a new detached thread.
   template <typename Inst, typename... FArgsT, typename... ArgsT>
-  Async(T (Inst::*FPtr)(FArgsT...), Inst &TargetInst, ArgsT &&...Args)
-      : StopFunc([&TargetInst]() { TargetInst.stop(); }) {
+  Async(T (Inst::*FPtr)(FArgsT...), Inst &TargetInst, ArgsT &&...Args) {
+    std::packaged_task<void()> Task;
+    *this = Async(Task, FPtr, TargetInst, std::forward<ArgsT>(Args)...);
+    std::thread(std::move(Task)).detach();
+  }
+  /// Prepare the task to run the function, which is run later by the caller,
+  /// for example on a thread pool. The task has its own stop token, so
+  /// cancelling it does not interrupt the other tasks of the instance.
+  template <typename Inst, typename... FArgsT, typename... ArgsT>
+  Async(std::packaged_task<void()> &Task, T (Inst::*FPtr)(FArgsT...),
+        Inst &TargetInst, ArgsT &&...Args) {
+    auto Token = std::make_shared<std::atomic_uint32_t>(0);
+    StopFunc = [&TargetInst, Token]() { TargetInst.stop(*Token); };
     std::promise<T> Promise;
     Future = Promise.get_future();
-    Thread =
-        std::thread([FPtr, P = std::move(Promise),
-                     Tuple = std::tuple(
-                         &TargetInst, std::forward<ArgsT>(Args)...)]() mutable {
-          P.set_value(std::apply(FPtr, Tuple));
+    Task = std::packaged_task<void()>(
+        [FPtr, P = std::move(Promise), Token = std::move(Token),
+         Tuple = std::tuple(&TargetInst, std::forward<ArgsT>(Args)...)]()
+            mutable {
+          // Leave the scope before setting the result, after which the
+          // instance may be destroyed by the waiting thread.
+          auto Result = [&]() {
+            typename Inst::StopScope Scope(*std::get<0>(Tuple), *Token);
+            return std::apply(FPtr, Tuple);
+          }();
+          P.set_value(std::move(Result));
         });
-    Thread.detach();
   }
   Async(const Async &) noexcept = delete;
   Async(Async &&Other) noexcept : Async() { swap(*this, Other); }
@@ -47,24 +71,40 @@ public:
 
   bool valid() const noexcept { return Future.valid(); }
 
-  T get() const { return Future.get(); }
+  T get() const {
+    wait();
+    return Future.get();
+  }
 
-  void wait() const { Future.wait(); }
+  /// Wait for the result. On a worker of the thread pool, the queued tasks
+  /// are run in place meanwhile, because the waited task may be one of them.
+  void wait() const {
+    while (!ready()) {
+      if (!ThreadPool::runQueuedTask()) {
+        Future.wait();
+        return;
+      }
+    }
+  }
 
   template <typename RT, typename PT>
   bool waitFor(const std::chrono::duration<RT, PT> &Timeout) const {
-    return Future.wait_for(Timeout) == std::future_status::ready;
+    return waitUntil(std::chrono::steady_clock::now() + Timeout);
   }
 
   template <typename CT, typename DT>
   bool waitUntil(const std::chrono::time_point<CT, DT> &Timeout) const {
-    return Future.wait_until(Timeout) == std::future_status::ready;
+    while (!ready() && CT::now() < Timeout) {
+      if (!ThreadPool::runQueuedTask()) {
+        return Future.wait_until(Timeout) == std::future_status::ready;
+      }
+    }
+    return ready();
   }
 
   friend void swap(Async &LHS, Async &RHS) noexcept {
     using std::swap;
     swap(LHS.Future, RHS.Future);
-    swap(LHS.Thread, RHS.Thread);
     swap(LHS.StopFunc, RHS.StopFunc);
   }
 
@@ -75,8 +115,12 @@ public:
   }
 
 protected:
+  bool ready() const {
+    return Future.wait_for(std::chrono::seconds(0)) ==
+           std::future_status::ready;
+  }
+
   std::shared_future<T> Future;
-  std::thread Thread;
   std::function<void()> StopFunc;
 };
 
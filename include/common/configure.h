@@ -18,6 +18,7 @@
 #include "common/enum_configure.hpp"
 #include "common/errcode.h"
 
+#include <algorithm>
 #include <atomic>
 #include <bitset>
 #include <cstdint>
@@ -25,6 +26,7 @@
 #include <mutex>
 #include <optional>
 #include <shared_mutex>
+#include <thread>
 #include <unordered_set>
 
 namespace WasmEdge {
@@ -37,7 +39,8 @@ public:
         OFormat(RHS.OFormat.load(std::memory_order_relaxed)),
         DumpIR(RHS.DumpIR.load(std::memory_order_relaxed)),
         GenericBinary(RHS.GenericBinary.load(std::memory_order_relaxed)),
-        Interruptible(RHS.Interruptible.load(std::memory_order_relaxed)) {}
+        Interruptible(RHS.Interruptible.load(std::memory_order_relaxed)),
+        Threads(RHS.Threads.load(std::memory_order_relaxed)) {}
 
   /// AOT compiler optimization level enum class.
   enum class OptimizationLevel : uint8_t {
@@ -101,12 +104,28 @@ public:
     return Interruptible.load(std::memory_order_relaxed);
   }
 
+  /// Set the thread count of the AOT compiler. With more than one thread, the
+  /// module is split into partitions which are optimized and emitted in
+  /// parallel. The optimizations do not cross the partitions. 0 for the
+  /// hardware concurrency.
+  void setThreads(uint32_t Count) noexcept {
+    if (Count == 0) {
+      Count = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    Threads.store(Count, std::memory_order_relaxed);
+  }
+
+  uint32_t getThreads() const noexcept {
+    return Threads.load(std::memory_order_relaxed);
+  }
+
 private:
   std::atomic<OptimizationLevel> OptLevel = OptimizationLevel::O3;
   std::atomic<OutputFormat> OFormat = OutputFormat::Wasm;
   std::atomic<bool> DumpIR = false;
   std::atomic<bool> GenericBinary = false;
   std::atomic<bool> Interruptible = false;
+  std::atomic<uint32_t> Threads = 1;
 };
 
 class RuntimeConfigure {
@@ -115,8 +134,24 @@ public:
   RuntimeConfigure(const RuntimeConfigure &RHS) noexcept
       : MaxMemPage(RHS.MaxMemPage.load(std::memory_order_relaxed)),
         EnableJIT(RHS.EnableJIT.load(std::memory_order_relaxed)),
+        EnableJITCache(RHS.EnableJITCache.load(std::memory_order_relaxed)),
+        EnableLazyJIT(RHS.EnableLazyJIT.load(std::memory_order_relaxed)),
         ForceInterpreter(RHS.ForceInterpreter.load(std::memory_order_relaxed)),
-        AllowAFUNIX(RHS.AllowAFUNIX.load(std::memory_order_relaxed)) {}
+        EnableThreadedInterpreter(
+            RHS.EnableThreadedInterpreter.load(std::memory_order_relaxed)),
+        EnableRegisterInterpreter(
+            RHS.EnableRegisterInterpreter.load(std::memory_order_relaxed)),
+        AllowAFUNIX(RHS.AllowAFUNIX.load(std::memory_order_relaxed)),
+        EnableIOUring(RHS.EnableIOUring.load(std::memory_order_relaxed)),
+        MaxIOUringBufferSize(
+            RHS.MaxIOUringBufferSize.load(std::memory_order_relaxed)),
+        MemoryPoolSize(RHS.MemoryPoolSize.load(std::memory_order_relaxed)),
+        TierUpThreshold(RHS.TierUpThreshold.load(std::memory_order_relaxed)),
+        LoadThreads(RHS.LoadThreads.load(std::memory_order_relaxed)),
+        EnableLazyLoading(
+            RHS.EnableLazyLoading.load(std::memory_order_relaxed)),
+        AsyncThreads(RHS.AsyncThreads.load(std::memory_order_relaxed)),
+        StackSize(RHS.StackSize.load(std::memory_order_relaxed)) {}
 
   void setMaxMemoryPage(const uint32_t Page) noexcept {
     MaxMemPage.store(Page, std::memory_order_relaxed);
@@ -134,6 +169,27 @@ public:
     return EnableJIT.load(std::memory_order_relaxed);
   }
 
+  /// Set whether the JIT mode caches the compiled modules on disk and reuses
+  /// them for the same module and configuration.
+  void setEnableJITCache(bool IsEnableJITCache) noexcept {
+    EnableJITCache.store(IsEnableJITCache, std::memory_order_relaxed);
+  }
+
+  bool isEnableJITCache() const noexcept {
+    return EnableJITCache.load(std::memory_order_relaxed);
+  }
+
+  /// Set whether the JIT mode compiles the functions on demand at their first
+  /// calls instead of the whole module at instantiation. The lazy compiled
+  /// modules are not cached.
+  void setEnableLazyJIT(bool IsEnableLazyJIT) noexcept {
+    EnableLazyJIT.store(IsEnableLazyJIT, std::memory_order_relaxed);
+  }
+
+  bool isEnableLazyJIT() const noexcept {
+    return EnableLazyJIT.load(std::memory_order_relaxed);
+  }
+
   void setForceInterpreter(bool IsForceInterpreter) noexcept {
     ForceInterpreter.store(IsForceInterpreter, std::memory_order_relaxed);
   }
@@ -142,6 +198,33 @@ public:
     return ForceInterpreter.load(std::memory_order_relaxed);
   }
 
+  /// Set whether the interpreter runs the instructions without the statistics
+  /// in the threaded code, where the common instructions jump to each other by
+  /// the computed gotos, instead of the switch loop. Only supported by the GCC
+  /// and Clang builds, and ignored otherwise.
+  void setEnableThreadedInterpreter(bool IsEnableThreadedInterpreter) noexcept {
+    EnableThreadedInterpreter.store(IsEnableThreadedInterpreter,
+                                    std::memory_order_relaxed);
+  }
+
+  bool isEnableThreadedInterpreter() const noexcept {
+    return EnableThreadedInterpreter.load(std::memory_order_relaxed);
+  }
+
+  /// Set whether the interpreter runs the native functions without the
+  /// statistics in the register code, where the operands are lowered to the
+  /// slots of the frame. The functions which cannot be lowered, such as the
+  /// ones with the calls, run by the stack machine.
+  void
+  setEnableRegisterInterpreter(bool IsEnableRegisterInterpreter) noexcept {
+    EnableRegisterInterpreter.store(IsEnableRegisterInterpreter,
+                                    std::memory_order_relaxed);
+  }
+
+  bool isEnableRegisterInterpreter() const noexcept {
+    return EnableRegisterInterpreter.load(std::memory_order_relaxed);
+  }
+
   void setAllowAFUNIX(bool IsAllowAFUNIX) noexcept {
     AllowAFUNIX.store(IsAllowAFUNIX, std::memory_order_relaxed);
   }
@@ -150,11 +233,112 @@ public:
     return AllowAFUNIX.load(std::memory_order_relaxed);
   }
 
+  /// Set whether the WASI socket I/O, the large writes to the non-regular
+  /// files, the reads, and the polling are submitted through io_uring on
+  /// Linux. Falls back to the epoll backend if unsupported.
+  void setEnableIOUring(bool IsEnableIOUring) noexcept {
+    EnableIOUring.store(IsEnableIOUring, std::memory_order_relaxed);
+  }
+
+  bool isEnableIOUring() const noexcept {
+    return EnableIOUring.load(std::memory_order_relaxed);
+  }
+
+  /// Set the bytes of the largest linear memory registered as the fixed
+  /// buffer of io_uring. The registration pins all the pages of the memory,
+  /// and slows down the copies of the syscalls from it, so it is disabled by
+  /// default with 0.
+  void setMaxIOUringBufferSize(const uint64_t Size) noexcept {
+    MaxIOUringBufferSize.store(Size, std::memory_order_relaxed);
+  }
+
+  uint64_t getMaxIOUringBufferSize() const noexcept {
+    return MaxIOUringBufferSize.load(std::memory_order_relaxed);
+  }
+
+  /// Set the slot count of the process-wide linear memory pool. The pool is
+  /// reserved by the first instantiation requesting it. 0 disables pooling.
+  void setMemoryPoolSize(const uint32_t SlotCount) noexcept {
+    MemoryPoolSize.store(SlotCount, std::memory_order_relaxed);
+  }
+
+  uint32_t getMemoryPoolSize() const noexcept {
+    return MemoryPoolSize.load(std::memory_order_relaxed);
+  }
+
+  /// Set the threshold of the tiered execution. The functions start in the
+  /// interpreter, and are compiled by the JIT in the background when their
+  /// calls and loop back-edges reach the threshold. 0 disables tiering.
+  void setTierUpThreshold(const uint32_t Threshold) noexcept {
+    TierUpThreshold.store(Threshold, std::memory_order_relaxed);
+  }
+
+  uint32_t getTierUpThreshold() const noexcept {
+    return TierUpThreshold.load(std::memory_order_relaxed);
+  }
+
+  /// Set the thread count of loading and validating the code section. With
+  /// more than one thread, the function bodies are decoded and validated in
+  /// parallel.
+  void setLoadThreads(const uint32_t Count) noexcept {
+    LoadThreads.store(Count, std::memory_order_relaxed);
+  }
+
+  uint32_t getLoadThreads() const noexcept {
+    return LoadThreads.load(std::memory_order_relaxed);
+  }
+
+  /// Set whether the loader keeps only the bytes of the function bodies. The
+  /// bodies are decoded and validated at their first calls in the interpreter.
+  /// Not applied with the JIT and the tiered execution, which compile the
+  /// whole module.
+  void setEnableLazyLoading(bool IsEnableLazyLoading) noexcept {
+    EnableLazyLoading.store(IsEnableLazyLoading, std::memory_order_relaxed);
+  }
+
+  bool isEnableLazyLoading() const noexcept {
+    return EnableLazyLoading.load(std::memory_order_relaxed);
+  }
+
+  /// Set the thread count of the pool running the asynchronous invocations.
+  /// The pool is started at the first asynchronous invocation. With 0, every
+  /// asynchronous invocation runs on a new thread.
+  void setAsyncThreads(const uint32_t Count) noexcept {
+    AsyncThreads.store(Count, std::memory_order_relaxed);
+  }
+
+  uint32_t getAsyncThreads() const noexcept {
+    return AsyncThreads.load(std::memory_order_relaxed);
+  }
+
+  /// Set the bytes of the stack of an execution, which holds the frames, the
+  /// exception handlers, and the values of the interpreter. The execution
+  /// traps when the stack is exhausted.
+  void setStackSize(const uint64_t Size) noexcept {
+    StackSize.store(Size, std::memory_order_relaxed);
+  }
+
+  uint64_t getStackSize() const noexcept {
+    return StackSize.load(std::memory_order_relaxed);
+  }
+
 private:
   std::atomic<uint32_t> MaxMemPage = 65536;
   std::atomic<bool> EnableJIT = false;
+  std::atomic<bool> EnableJITCache = false;
+  std::atomic<bool> EnableLazyJIT = false;
   std::atomic<bool> ForceInterpreter = false;
+  std::atomic<bool> EnableThreadedInterpreter = true;
+  std::atomic<bool> EnableRegisterInterpreter = true;
   std::atomic<bool> AllowAFUNIX = false;
+  std::atomic<bool> EnableIOUring = false;
+  std::atomic<uint64_t> MaxIOUringBufferSize = 0;
+  std::atomic<uint32_t> MemoryPoolSize = 0;
+  std::atomic<uint32_t> TierUpThreshold = 0;
+  std::atomic<uint32_t> LoadThreads = 1;
+  std::atomic<bool> EnableLazyLoading = false;
+  std::atomic<uint32_t> AsyncThreads = 0;
+  std::atomic<uint64_t> StackSize = UINT64_C(32) << 20;
 };
 
 class StatisticsConfigure {
@@ -163,7 +347,9 @@ public:
   StatisticsConfigure(const StatisticsConfigure &RHS) noexcept
       : InstrCounting(RHS.InstrCounting.load(std::memory_order_relaxed)),
         CostMeasuring(RHS.CostMeasuring.load(std::memory_order_relaxed)),
-        TimeMeasuring(RHS.TimeMeasuring.load(std::memory_order_relaxed)) {}
+        TimeMeasuring(RHS.TimeMeasuring.load(std::memory_order_relaxed)),
+        BatchedMetering(RHS.BatchedMetering.load(std::memory_order_relaxed)) {
+  }
 
   void setInstructionCounting(bool IsCount) noexcept {
     InstrCounting.store(IsCount, std::memory_order_relaxed);
@@ -189,6 +375,18 @@ public:
     return TimeMeasuring.load(std::memory_order_relaxed);
   }
 
+  /// Setter and getter of the batched metering mode. In this mode, the
+  /// instruction counts and costs are accumulated per basic block in a
+  /// thread-private counter, and only charged to the statistics and checked
+  /// against the cost limit at loop headers, calls, and the function exits.
+  void setBatchedMetering(bool IsBatched) noexcept {
+    BatchedMetering.store(IsBatched, std::memory_order_relaxed);
+  }
+
+  bool isBatchedMetering() const noexcept {
+    return BatchedMetering.load(std::memory_order_relaxed);
+  }
+
   void setCostLimit(uint64_t Cost) noexcept {
     CostLimit.store(Cost, std::memory_order_relaxed);
   }
@@ -201,6 +399,7 @@ private:
   std::atomic<bool> InstrCounting = false;
   std::atomic<bool> CostMeasuring = false;
   std::atomic<bool> TimeMeasuring = false;
+  std::atomic<bool> BatchedMetering = false;
 
   std::atomic<uint64_t> CostLimit = std::numeric_limits<uint64_t>::max();
 };
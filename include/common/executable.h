@@ -63,6 +63,17 @@ public:
     kMemoryAtomicWait,
     kCallRef,
     kRefGetFuncSymbol,
+    kStructNew,
+    kArrayNew,
+    kArrayNewData,
+    kArrayNewElem,
+    kArrayFill,
+    kArrayCopy,
+    kArrayInitData,
+    kArrayInitElem,
+    kRefTest,
+    kWriteBarrier,
+    kSafepoint,
     kIntrinsicMax,
   };
   using IntrinsicsTable = void * [uint32_t(Intrinsics::kIntrinsicMax)];
@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/common/parallel.h - Parallel loop helper -----------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the helper to run independent tasks on a short-lived
+/// pool of worker threads.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace WasmEdge {
+
+/// Run Func with the indices in [0, Count) on at most Threads threads. The
+/// calling thread is one of the workers, and the indices are taken in the
+/// ascending order.
+inline void parallelFor(uint32_t Count, uint32_t Threads,
+                        const std::function<void(uint32_t)> &Func) noexcept {
+  std::atomic<uint32_t> Next = 0;
+  auto Worker = [&]() {
+    for (uint32_t I = Next.fetch_add(1); I < Count; I = Next.fetch_add(1)) {
+      Func(I);
+    }
+  };
+  std::vector<std::thread> Pool;
+  const uint32_t PoolSize = std::min(Threads, Count);
+  if (PoolSize > 1) {
+    Pool.reserve(PoolSize - 1);
+  }
+  for (uint32_t I = 1; I < PoolSize; ++I) {
+    Pool.emplace_back(Worker);
+  }
+  Worker();
+  for (auto &Thread : Pool) {
+    Thread.join();
+  }
+}
+
+} // namespace WasmEdge
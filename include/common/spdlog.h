@@ -30,6 +30,20 @@ void setWarnLoggingLevel();
 
 void setErrorLoggingLevel();
 
+/// Turn off the logging of the current thread during the lifetime of the
+/// object. The worker threads use it when their errors are reported again by
+/// the calling thread.
+class ScopedThreadLogOff {
+public:
+  ScopedThreadLogOff() noexcept;
+  ~ScopedThreadLogOff() noexcept;
+  ScopedThreadLogOff(const ScopedThreadLogOff &) = delete;
+  ScopedThreadLogOff &operator=(const ScopedThreadLogOff &) = delete;
+
+private:
+  bool Prev;
+};
+
 } // namespace Log
 } // namespace WasmEdge
 
@@ -29,20 +29,26 @@ namespace Statistics {
 class Statistics {
 public:
   Statistics(const uint64_t Lim = UINT64_MAX)
-      : CostTab(UINT16_MAX + 1, 1ULL), InstrCnt(0), CostLimit(Lim), CostSum(0) {
-  }
+      : CostTab(UINT16_MAX + 1, 1ULL), CostTabHash(hashCostTable(CostTab)),
+        InstrCnt(0), CostLimit(Lim), CostSum(0) {}
   Statistics(Span<const uint64_t> Tab, const uint64_t Lim = UINT64_MAX)
-      : CostTab(Tab.begin(), Tab.end()), InstrCnt(0), CostLimit(Lim),
-        CostSum(0) {
+      : CostTab(Tab.begin(), Tab.end()), CostTabHash(0), InstrCnt(0),
+        CostLimit(Lim), CostSum(0) {
     if (CostTab.size() < UINT16_MAX + 1) {
       CostTab.resize(UINT16_MAX + 1, 0ULL);
     }
+    CostTabHash = hashCostTable(CostTab);
   }
   ~Statistics() = default;
 
   /// Increment of instruction counter.
   void incInstrCount() { InstrCnt.fetch_add(1, std::memory_order_relaxed); }
 
+  /// Adder of instruction counter.
+  void addInstrCount(uint64_t Count) {
+    InstrCnt.fetch_add(Count, std::memory_order_relaxed);
+  }
+
   /// Getter of instruction counter.
   uint64_t getInstrCount() const {
     return InstrCnt.load(std::memory_order_relaxed);
@@ -61,10 +67,16 @@ public:
     if (unlikely(CostTab.size() < UINT16_MAX + 1)) {
       CostTab.resize(UINT16_MAX + 1, 0ULL);
     }
+    CostTabHash = hashCostTable(CostTab);
   }
   Span<const uint64_t> getCostTable() const noexcept { return CostTab; }
   Span<uint64_t> getCostTable() noexcept { return CostTab; }
 
+  /// Getter of the hash of the cost table contents, renewed by every
+  /// `setCostTable`. The statistics with identical cost tables share the
+  /// costs resolved from the table and cached with it.
+  uint64_t getCostTableHash() const noexcept { return CostTabHash; }
+
   /// Adder of instruction costs.
   bool addInstrCost(OpCode Code) { return addCost(CostTab[uint16_t(Code)]); }
 
@@ -183,7 +195,20 @@ public:
   }
 
 private:
+  static uint64_t hashCostTable(Span<const uint64_t> Tab) noexcept {
+    uint64_t Hash = UINT64_C(0xCBF29CE484222325);
+    for (const uint64_t Cost : Tab) {
+      // Mix each entry with the finalizer of splitmix64.
+      uint64_t X = Hash ^ Cost;
+      X = (X ^ (X >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+      X = (X ^ (X >> 27)) * UINT64_C(0x94D049BB133111EB);
+      Hash = (X ^ (X >> 31)) + UINT64_C(0x9E3779B97F4A7C15);
+    }
+    return Hash;
+  }
+
   std::vector<uint64_t> CostTab;
+  uint64_t CostTabHash;
   std::atomic_uint64_t InstrCnt;
   uint64_t CostLimit;
   std::atomic_uint64_t CostSum;
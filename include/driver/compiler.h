@@ -34,6 +34,8 @@ struct DriverCompilerOptions {
             "Enable generating code for counting gas burned during execution."sv)),
         ConfEnableTimeMeasuring(PO::Description(
             "Enable generating code for counting time during execution."sv)),
+        ConfEnableBatchedMetering(PO::Description(
+            "Enable charging the instruction counts and gas per basic block, and checking the gas limit only at loop headers and calls."sv)),
         ConfEnableAllStatistics(
             PO::Description("Enable generating code for all statistics options "
                             "include instruction "
@@ -58,7 +60,11 @@ struct DriverCompilerOptions {
         PropAll(PO::Description("Enable all features"sv)),
         PropOptimizationLevel(
             PO::Description("Optimization level, one of 0, 1, 2, 3, s, z."sv),
-            PO::DefaultValue(std::string("2"))) {}
+            PO::DefaultValue(std::string("2"))),
+        ConfThreads(
+            PO::Description(
+                "Number of threads to load, validate, and compile the module in parallel, 0 for the hardware concurrency. Default value is 1."sv),
+            PO::MetaVar("THREADS"sv), PO::DefaultValue<uint32_t>(1)) {}
 
   PO::Option<std::string> WasmName;
   PO::Option<std::string> SoName;
@@ -68,6 +74,7 @@ struct DriverCompilerOptions {
   PO::Option<PO::Toggle> ConfEnableInstructionCounting;
   PO::Option<PO::Toggle> ConfEnableGasMeasuring;
   PO::Option<PO::Toggle> ConfEnableTimeMeasuring;
+  PO::Option<PO::Toggle> ConfEnableBatchedMetering;
   PO::Option<PO::Toggle> ConfEnableAllStatistics;
   PO::Option<PO::Toggle> PropMutGlobals;
   PO::Option<PO::Toggle> PropNonTrapF2IConvs;
@@ -83,6 +90,7 @@ struct DriverCompilerOptions {
   PO::Option<PO::Toggle> PropFunctionReference;
   PO::Option<PO::Toggle> PropAll;
   PO::Option<std::string> PropOptimizationLevel;
+  PO::Option<uint32_t> ConfThreads;
 
   void add_option(PO::ArgumentParser &Parser) noexcept {
     Parser.add_option(WasmName)
@@ -92,6 +100,7 @@ struct DriverCompilerOptions {
         .add_option("enable-instruction-count"sv, ConfEnableInstructionCounting)
         .add_option("enable-gas-measuring"sv, ConfEnableGasMeasuring)
         .add_option("enable-time-measuring"sv, ConfEnableTimeMeasuring)
+        .add_option("enable-batched-metering"sv, ConfEnableBatchedMetering)
         .add_option("enable-all-statistics"sv, ConfEnableAllStatistics)
         .add_option("generic-binary"sv, ConfGenericBinary)
         .add_option("disable-import-export-mut-globals"sv, PropMutGlobals)
@@ -107,7 +116,8 @@ struct DriverCompilerOptions {
         .add_option("enable-threads"sv, PropThreads)
         .add_option("enable-function-reference"sv, PropFunctionReference)
         .add_option("enable-all"sv, PropAll)
-        .add_option("optimize"sv, PropOptimizationLevel);
+        .add_option("optimize"sv, PropOptimizationLevel)
+        .add_option("threads"sv, ConfThreads);
   }
 };
 
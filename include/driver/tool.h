@@ -74,12 +74,34 @@ struct DriverToolOptions {
             "Enable generating code for counting gas burned during execution."sv)),
         ConfEnableTimeMeasuring(PO::Description(
             "Enable generating code for counting time during execution."sv)),
+        ConfEnableBatchedMetering(PO::Description(
+            "Enable charging the instruction counts and gas per basic block, and checking the gas limit only at loop headers and calls."sv)),
         ConfEnableAllStatistics(PO::Description(
             "Enable generating code for all statistics options include instruction counting, gas measuring, and execution time"sv)),
         ConfEnableJIT(
             PO::Description("Enable Just-In-Time compiler for running WASM"sv)),
+        ConfEnableJITCache(PO::Description(
+            "Enable caching the Just-In-Time compiled modules on disk."sv)),
+        ConfEnableLazyJIT(PO::Description(
+            "Enable Just-In-Time compiler which compiles the functions at their first calls."sv)),
         ConfForceInterpreter(
             PO::Description("Forcibly run WASM in interpreter mode."sv)),
+        ConfTierUpThreshold(
+            PO::Description(
+                "Start in interpreter mode and compile the functions whose calls and loop iterations reach the threshold with the Just-In-Time compiler in the background, default value is 0 for disabled"sv),
+            PO::MetaVar("COUNT"sv), PO::DefaultValue<uint32_t>(0)),
+        ConfLoadThreads(
+            PO::Description(
+                "Number of threads to load and validate the function bodies in parallel, 0 for the hardware concurrency. Default value is 1."sv),
+            PO::MetaVar("THREADS"sv), PO::DefaultValue<uint32_t>(1)),
+        ConfEnableLazyLoading(PO::Description(
+            "Enable decoding and validating the function bodies at their first calls in interpreter mode."sv)),
+        ConfEnableIOUring(PO::Description(
+            "Enable submitting the WASI file and socket I/O through io_uring on Linux."sv)),
+        ConfMaxIOUringBufferSize(
+            PO::Description(
+                "Maximum size in bytes of the linear memory registered as the io_uring fixed buffer, default value is 0 for no registration"sv),
+            PO::MetaVar("SIZE"sv), PO::DefaultValue<uint64_t>(0)),
         TimeLim(
             PO::Description(
                 "Limitation of maximum time(in milliseconds) for execution, default value is 0 for no limitations"sv),
@@ -120,9 +142,17 @@ struct DriverToolOptions {
   PO::Option<PO::Toggle> ConfEnableInstructionCounting;
   PO::Option<PO::Toggle> ConfEnableGasMeasuring;
   PO::Option<PO::Toggle> ConfEnableTimeMeasuring;
+  PO::Option<PO::Toggle> ConfEnableBatchedMetering;
   PO::Option<PO::Toggle> ConfEnableAllStatistics;
   PO::Option<PO::Toggle> ConfEnableJIT;
+  PO::Option<PO::Toggle> ConfEnableJITCache;
+  PO::Option<PO::Toggle> ConfEnableLazyJIT;
   PO::Option<PO::Toggle> ConfForceInterpreter;
+  PO::Option<uint32_t> ConfTierUpThreshold;
+  PO::Option<uint32_t> ConfLoadThreads;
+  PO::Option<PO::Toggle> ConfEnableLazyLoading;
+  PO::Option<PO::Toggle> ConfEnableIOUring;
+  PO::Option<uint64_t> ConfMaxIOUringBufferSize;
   PO::Option<uint64_t> TimeLim;
   PO::List<int> GasLim;
   PO::List<int> MemLim;
@@ -138,9 +168,17 @@ struct DriverToolOptions {
         .add_option("enable-instruction-count"sv, ConfEnableInstructionCounting)
         .add_option("enable-gas-measuring"sv, ConfEnableGasMeasuring)
         .add_option("enable-time-measuring"sv, ConfEnableTimeMeasuring)
+        .add_option("enable-batched-metering"sv, ConfEnableBatchedMetering)
         .add_option("enable-all-statistics"sv, ConfEnableAllStatistics)
         .add_option("enable-jit"sv, ConfEnableJIT)
+        .add_option("enable-jit-cache"sv, ConfEnableJITCache)
+        .add_option("enable-lazy-jit"sv, ConfEnableLazyJIT)
         .add_option("force-interpreter"sv, ConfForceInterpreter)
+        .add_option("tier-up-threshold"sv, ConfTierUpThreshold)
+        .add_option("load-threads"sv, ConfLoadThreads)
+        .add_option("enable-lazy-loading"sv, ConfEnableLazyLoading)
+        .add_option("enable-io-uring"sv, ConfEnableIOUring)
+        .add_option("io-uring-buffer-size"sv, ConfMaxIOUringBufferSize)
         .add_option("disable-import-export-mut-globals"sv, PropMutGlobals)
         .add_option("disable-non-trap-float-to-int"sv, PropNonTrapF2IConvs)
         .add_option("disable-sign-extension-operators"sv, PropSignExtendOps)
@@ -3,7 +3,6 @@
 
 #include "executor/executor.h"
 #include "runtime/instance/memory.h"
-#include <experimental/scope.hpp>
 
 #include <cstdint>
 
@@ -18,18 +17,11 @@ TypeT<T> Executor::runAtomicWaitOp(Runtime::StackManager &StackMgr,
   ValVariant RawValue = StackMgr.pop();
   ValVariant &RawAddress = StackMgr.getTop();
 
-  uint32_t Address = RawAddress.get<uint32_t>();
-  if (Address >
-      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
-    spdlog::error(ErrCode::Value::MemoryOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(
-        Address + static_cast<uint64_t>(Instr.getMemoryOffset()), sizeof(T),
-        MemInst.getBoundIdx()));
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::MemoryOutOfBounds);
+  auto EA = getEffectiveAddress(MemInst, RawAddress, Instr, sizeof(T));
+  if (unlikely(!EA)) {
+    return Unexpect(EA);
   }
-  Address += Instr.getMemoryOffset();
+  const uint64_t Address = *EA;
 
   if (Address % sizeof(T) != 0) {
     spdlog::error(ErrCode::Value::UnalignedAtomicAccess);
@@ -57,19 +49,11 @@ TypeT<T> Executor::runAtomicLoadOp(Runtime::StackManager &StackMgr,
                                    Runtime::Instance::MemoryInstance &MemInst,
                                    const AST::Instruction &Instr) {
   ValVariant &RawAddress = StackMgr.getTop();
-  uint32_t Address = RawAddress.get<uint32_t>();
-
-  if (Address >
-      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
-    spdlog::error(ErrCode::Value::MemoryOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(
-        Address + static_cast<uint64_t>(Instr.getMemoryOffset()), sizeof(I),
-        MemInst.getBoundIdx()));
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::MemoryOutOfBounds);
+  auto EA = getEffectiveAddress(MemInst, RawAddress, Instr, sizeof(I));
+  if (unlikely(!EA)) {
+    return Unexpect(EA);
   }
-  Address += Instr.getMemoryOffset();
+  const uint64_t Address = *EA;
 
   if (Address % sizeof(I) != 0) {
     spdlog::error(ErrCode::Value::UnalignedAtomicAccess);
@@ -98,19 +82,11 @@ TypeT<T> Executor::runAtomicStoreOp(Runtime::StackManager &StackMgr,
                                     const AST::Instruction &Instr) {
   ValVariant RawValue = StackMgr.pop();
   ValVariant RawAddress = StackMgr.pop();
-  uint32_t Address = RawAddress.get<uint32_t>();
-
-  if (Address >
-      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
-    spdlog::error(ErrCode::Value::MemoryOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(
-        Address + static_cast<uint64_t>(Instr.getMemoryOffset()), sizeof(I),
-        MemInst.getBoundIdx()));
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::MemoryOutOfBounds);
+  auto EA = getEffectiveAddress(MemInst, RawAddress, Instr, sizeof(I));
+  if (unlikely(!EA)) {
+    return Unexpect(EA);
   }
-  Address += Instr.getMemoryOffset();
+  const uint64_t Address = *EA;
 
   if (Address % sizeof(I) != 0) {
     spdlog::error(ErrCode::Value::UnalignedAtomicAccess);
@@ -139,19 +115,11 @@ TypeT<T> Executor::runAtomicAddOp(Runtime::StackManager &StackMgr,
                                   const AST::Instruction &Instr) {
   ValVariant RawValue = StackMgr.pop();
   ValVariant &RawAddress = StackMgr.getTop();
-  uint32_t Address = RawAddress.get<uint32_t>();
-
-  if (Address >
-      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
-    spdlog::error(ErrCode::Value::MemoryOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(
-        Address + static_cast<uint64_t>(Instr.getMemoryOffset()), sizeof(I),
-        MemInst.getBoundIdx()));
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::MemoryOutOfBounds);
+  auto EA = getEffectiveAddress(MemInst, RawAddress, Instr, sizeof(I));
+  if (unlikely(!EA)) {
+    return Unexpect(EA);
   }
-  Address += Instr.getMemoryOffset();
+  const uint64_t Address = *EA;
 
   if (Address % sizeof(I) != 0) {
     spdlog::error(ErrCode::Value::UnalignedAtomicAccess);
@@ -181,19 +149,11 @@ TypeT<T> Executor::runAtomicSubOp(Runtime::StackManager &StackMgr,
                                   const AST::Instruction &Instr) {
   ValVariant RawValue = StackMgr.pop();
   ValVariant &RawAddress = StackMgr.getTop();
-  uint32_t Address = RawAddress.get<uint32_t>();
-
-  if (Address >
-      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
-    spdlog::error(ErrCode::Value::MemoryOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(
-        Address + static_cast<uint64_t>(Instr.getMemoryOffset()), sizeof(I),
-        MemInst.getBoundIdx()));
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::MemoryOutOfBounds);
+  auto EA = getEffectiveAddress(MemInst, RawAddress, Instr, sizeof(I));
+  if (unlikely(!EA)) {
+    return Unexpect(EA);
   }
-  Address += Instr.getMemoryOffset();
+  const uint64_t Address = *EA;
 
   if (Address % sizeof(I) != 0) {
     spdlog::error(ErrCode::Value::UnalignedAtomicAccess);
@@ -223,19 +183,11 @@ TypeT<T> Executor::runAtomicOrOp(Runtime::StackManager &StackMgr,
                                  const AST::Instruction &Instr) {
   ValVariant RawValue = StackMgr.pop();
   ValVariant &RawAddress = StackMgr.getTop();
-  uint32_t Address = RawAddress.get<uint32_t>();
-
-  if (Address >
-      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
-    spdlog::error(ErrCode::Value::MemoryOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(
-        Address + static_cast<uint64_t>(Instr.getMemoryOffset()), sizeof(I),
-        MemInst.getBoundIdx()));
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::MemoryOutOfBounds);
+  auto EA = getEffectiveAddress(MemInst, RawAddress, Instr, sizeof(I));
+  if (unlikely(!EA)) {
+    return Unexpect(EA);
   }
-  Address += Instr.getMemoryOffset();
+  const uint64_t Address = *EA;
 
   if (Address % sizeof(I) != 0) {
     spdlog::error(ErrCode::Value::UnalignedAtomicAccess);
@@ -265,19 +217,11 @@ TypeT<T> Executor::runAtomicAndOp(Runtime::StackManager &StackMgr,
                                   const AST::Instruction &Instr) {
   ValVariant RawValue = StackMgr.pop();
   ValVariant &RawAddress = StackMgr.getTop();
-  uint32_t Address = RawAddress.get<uint32_t>();
-
-  if (Address >
-      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
-    spdlog::error(ErrCode::Value::MemoryOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(
-        Address + static_cast<uint64_t>(Instr.getMemoryOffset()), sizeof(I),
-        MemInst.getBoundIdx()));
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::MemoryOutOfBounds);
+  auto EA = getEffectiveAddress(MemInst, RawAddress, Instr, sizeof(I));
+  if (unlikely(!EA)) {
+    return Unexpect(EA);
   }
-  Address += Instr.getMemoryOffset();
+  const uint64_t Address = *EA;
 
   if (Address % sizeof(I) != 0) {
     spdlog::error(ErrCode::Value::UnalignedAtomicAccess);
@@ -307,19 +251,11 @@ TypeT<T> Executor::runAtomicXorOp(Runtime::StackManager &StackMgr,
                                   const AST::Instruction &Instr) {
   ValVariant RawValue = StackMgr.pop();
   ValVariant &RawAddress = StackMgr.getTop();
-  uint32_t Address = RawAddress.get<uint32_t>();
-
-  if (Address >
-      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
-    spdlog::error(ErrCode::Value::MemoryOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(
-        Address + static_cast<uint64_t>(Instr.getMemoryOffset()), sizeof(I),
-        MemInst.getBoundIdx()));
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::MemoryOutOfBounds);
+  auto EA = getEffectiveAddress(MemInst, RawAddress, Instr, sizeof(I));
+  if (unlikely(!EA)) {
+    return Unexpect(EA);
   }
-  Address += Instr.getMemoryOffset();
+  const uint64_t Address = *EA;
 
   if (Address % sizeof(I) != 0) {
     spdlog::error(ErrCode::Value::UnalignedAtomicAccess);
@@ -350,19 +286,11 @@ Executor::runAtomicExchangeOp(Runtime::StackManager &StackMgr,
                               const AST::Instruction &Instr) {
   ValVariant RawValue = StackMgr.pop();
   ValVariant &RawAddress = StackMgr.getTop();
-  uint32_t Address = RawAddress.get<uint32_t>();
-
-  if (Address >
-      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
-    spdlog::error(ErrCode::Value::MemoryOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(
-        Address + static_cast<uint64_t>(Instr.getMemoryOffset()), sizeof(I),
-        MemInst.getBoundIdx()));
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::MemoryOutOfBounds);
+  auto EA = getEffectiveAddress(MemInst, RawAddress, Instr, sizeof(I));
+  if (unlikely(!EA)) {
+    return Unexpect(EA);
   }
-  Address += Instr.getMemoryOffset();
+  const uint64_t Address = *EA;
 
   if (Address % sizeof(I) != 0) {
     spdlog::error(ErrCode::Value::UnalignedAtomicAccess);
@@ -394,19 +322,11 @@ Executor::runAtomicCompareExchangeOp(Runtime::StackManager &StackMgr,
   ValVariant RawReplacement = StackMgr.pop();
   ValVariant RawExpected = StackMgr.pop();
   ValVariant &RawAddress = StackMgr.getTop();
-  uint32_t Address = RawAddress.get<uint32_t>();
-
-  if (Address >
-      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
-    spdlog::error(ErrCode::Value::MemoryOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(
-        Address + static_cast<uint64_t>(Instr.getMemoryOffset()), sizeof(I),
-        MemInst.getBoundIdx()));
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::MemoryOutOfBounds);
+  auto EA = getEffectiveAddress(MemInst, RawAddress, Instr, sizeof(I));
+  if (unlikely(!EA)) {
+    return Unexpect(EA);
   }
-  Address += Instr.getMemoryOffset();
+  const uint64_t Address = *EA;
 
   if (Address % sizeof(I) != 0) {
     spdlog::error(ErrCode::Value::UnalignedAtomicAccess);
@@ -434,7 +354,7 @@ Executor::runAtomicCompareExchangeOp(Runtime::StackManager &StackMgr,
 template <typename T>
 Expect<uint32_t>
 Executor::atomicWait(Runtime::Instance::MemoryInstance &MemInst,
-                     uint32_t Address, T Expected, int64_t Timeout) noexcept {
+                     uint64_t Address, T Expected, int64_t Timeout) noexcept {
   // The error message should be handled by the caller, or the AOT mode will
   // produce the duplicated messages.
   if (!MemInst.isShared()) {
@@ -446,48 +366,34 @@ Executor::atomicWait(Runtime::Instance::MemoryInstance &MemInst,
     return Unexpect(ErrCode::Value::MemoryOutOfBounds);
   }
 
-  std::optional<std::chrono::time_point<std::chrono::steady_clock>> Until;
+  std::optional<ParkingLot::Clock::time_point> Until;
   if (Timeout >= 0) {
-    Until.emplace(std::chrono::steady_clock::now() +
-                  std::chrono::nanoseconds(Timeout));
+    Until.emplace(ParkingLot::Clock::now() + std::chrono::nanoseconds(Timeout));
   }
 
   auto *AtomicObj = MemInst.getPointer<std::atomic<T> *>(Address);
   assuming(AtomicObj);
 
-  if (AtomicObj->load() != Expected) {
+  // The value and the stop token are checked under the lock of the waiters,
+  // so the following notifications and stops are not lost.
+  auto &Token = getStopToken();
+  const auto Res = Waiters.park(
+      AtomicObj,
+      [&]() noexcept {
+        return Token.load(std::memory_order_relaxed) == 0 &&
+               AtomicObj->load() == Expected;
+      },
+      Until);
+  if (unlikely(Token.load(std::memory_order_relaxed) != 0)) {
+    return Unexpect(ErrCode::Value::Interrupted);
+  }
+  switch (Res) {
+  case ParkingLot::ParkResult::Invalid:
     return UINT32_C(1); // NotEqual
-  }
-
-  decltype(WaiterMap)::iterator WaiterIterator;
-  {
-    std::unique_lock<decltype(WaiterMapMutex)> Locker(WaiterMapMutex);
-    WaiterIterator = WaiterMap.emplace(Address, &MemInst);
-  }
-
-  cxx20::scope_exit ScopeExitHolder([&]() noexcept {
-    std::unique_lock<decltype(WaiterMapMutex)> Locker(WaiterMapMutex);
-    WaiterMap.erase(WaiterIterator);
-  });
-
-  while (true) {
-    std::unique_lock<decltype(WaiterIterator->second.Mutex)> Locker(
-        WaiterIterator->second.Mutex);
-    std::cv_status WaitResult = std::cv_status::no_timeout;
-    if (!Until) {
-      WaiterIterator->second.Cond.wait(Locker);
-    } else {
-      WaitResult = WaiterIterator->second.Cond.wait_until(Locker, *Until);
-    }
-    if (unlikely(StopToken.load(std::memory_order_relaxed) != 0)) {
-      return Unexpect(ErrCode::Value::Interrupted);
-    }
-    if (likely(AtomicObj->load() != Expected)) {
-      return UINT32_C(0); // ok
-    }
-    if (WaitResult == std::cv_status::timeout) {
-      return UINT32_C(2); // Timed-out
-    }
+  case ParkingLot::ParkResult::TimedOut:
+    return UINT32_C(2); // Timed-out
+  default:
+    return UINT32_C(0); // ok
   }
 }
 
@@ -20,13 +20,16 @@
 #include "common/defines.h"
 #include "common/errcode.h"
 #include "common/statistics.h"
+#include "executor/gc.h"
 #include "runtime/callingframe.h"
 #include "runtime/instance/module.h"
 #include "runtime/stackmgr.h"
 #include "runtime/storemgr.h"
+#include "system/parkinglot.h"
+#include "system/threadpool.h"
 
+#include <array>
 #include <atomic>
-#include <condition_variable>
 #include <csignal>
 #include <cstdint>
 #include <functional>
@@ -113,6 +116,9 @@ public:
       PostHostFunc(PostHostData);
     }
   }
+  bool hasHostFuncs() const noexcept {
+    return PreHostFunc.operator bool() || PostHostFunc.operator bool();
+  }
 
 private:
   void *PreHostData = nullptr;
@@ -126,7 +132,7 @@ private:
 class Executor {
 public:
   Executor(const Configure &Conf, Statistics::Statistics *S = nullptr) noexcept
-      : Conf(Conf) {
+      : Conf(Conf), AsyncPool(Conf.getRuntimeConfigure().getAsyncThreads()) {
     if (Conf.getStatisticsConfigure().isInstructionCounting() ||
         Conf.getStatisticsConfigure().isCostMeasuring() ||
         Conf.getStatisticsConfigure().isTimeMeasuring()) {
@@ -136,13 +142,16 @@ public:
     }
     if (Stat) {
       Stat->setCostLimit(Conf.getStatisticsConfigure().getCostLimit());
+      TimeMeasuring = Conf.getStatisticsConfigure().isTimeMeasuring();
     }
   }
   ~Executor() noexcept {
+    stopAsync();
     ExecutionContext.StopToken = nullptr;
     ExecutionContext.InstrCount = nullptr;
     ExecutionContext.CostTable = nullptr;
     ExecutionContext.Gas = nullptr;
+    ExecutionContext.HostFuncs = nullptr;
   }
 
   /// Getter of Configure
@@ -171,6 +180,29 @@ public:
   Expect<void> registerPostHostFunction(void *HostData,
                                         std::function<void(void *)> HostFunc);
 
+  /// Register a callback which will be invoked once for every native wasm
+  /// function reaching the tier-up threshold in the configuration. The
+  /// callback should compile the function and publish its code with
+  /// `FunctionInstance::setTieredSymbol`. An empty callback disables the
+  /// counting. Thread-safe with the running executions, which may still invoke
+  /// the replaced callback once after this returns.
+  void registerTierUpFunction(
+      std::function<void(const Runtime::Instance::FunctionInstance &)>
+          Callback) noexcept {
+    if (Callback) {
+      std::atomic_store(
+          &TierUpFunc,
+          std::make_shared<const std::function<void(
+              const Runtime::Instance::FunctionInstance &)>>(
+              std::move(Callback)));
+      TierUpThreshold.store(Conf.getRuntimeConfigure().getTierUpThreshold(),
+                            std::memory_order_release);
+    } else {
+      TierUpThreshold.store(0, std::memory_order_release);
+      std::atomic_store(&TierUpFunc, {});
+    }
+  }
+
   /// Invoke a WASM function by function instance.
   Expect<std::vector<std::pair<ValVariant, ValType>>>
   invoke(const Runtime::Instance::FunctionInstance *FuncInst,
@@ -181,12 +213,48 @@ public:
   asyncInvoke(const Runtime::Instance::FunctionInstance *FuncInst,
               Span<const ValVariant> Params, Span<const ValType> ParamTypes);
 
-  /// Stop execution
+  /// Stop execution of all the invocations, including the asynchronous tasks.
   void stop() noexcept {
     StopToken.store(1, std::memory_order_relaxed);
+    stopTasks();
+  }
+
+  /// Stop execution of the asynchronous task of the stop token.
+  void stop(std::atomic_uint32_t &Token) noexcept {
+    Token.store(1, std::memory_order_relaxed);
     atomicNotifyAll();
   }
 
+  /// Scope of an asynchronous task on the current thread. The invocations of
+  /// the executor in the scope are interrupted by the stop token of the task
+  /// instead of the one of the executor.
+  class StopScope {
+  public:
+    StopScope(Executor &E, std::atomic_uint32_t &Token) noexcept;
+    ~StopScope() noexcept;
+    StopScope(const StopScope &) = delete;
+    StopScope &operator=(const StopScope &) = delete;
+
+  private:
+    Executor &Engine;
+    Executor *SavedOwner;
+    std::atomic_uint32_t *SavedToken;
+  };
+
+  /// Run the task of an asynchronous invocation on the thread pool, or on a
+  /// new detached thread if the pool is disabled in the configuration.
+  void submitAsync(ThreadPool::Task &&Task);
+
+  /// Run the tasks of the asynchronous invocations in a batch.
+  void submitAsync(std::vector<ThreadPool::Task> &&Tasks);
+
+  /// Stop the asynchronous invocations on the thread pool and wait for them.
+  /// The running invocations are stopped as `stop()`, and the pool is not
+  /// restarted. The invocations on the detached threads are not waited for.
+  void stopAsync() noexcept {
+    AsyncPool.stop([this]() { stopTasks(); });
+  }
+
   // [qdrvm]
   Expect<uint32_t> dataSegmentOffset(Runtime::StackManager &StackMgr, const AST::DataSegment &DataSeg);
 
@@ -265,12 +333,46 @@ private:
 
   /// \name Helper Functions for block controls.
   /// @{
+  /// Helper function for calling host functions with the arguments and the
+  /// return buffers. The arguments are cleaned in place.
+  Expect<void>
+  callHostFunction(const Runtime::Instance::ModuleInstance *ModInst,
+                   const Runtime::Instance::FunctionInstance &Func,
+                   Span<ValVariant> Args, Span<ValVariant> Rets);
+
+  /// Helper function for calling functions from the compiled functions with
+  /// the argument and the return buffers of the caller.
+  Expect<void> callFromCompiled(Runtime::StackManager &StackMgr,
+                                const Runtime::Instance::FunctionInstance &Func,
+                                const ValVariant *Args, ValVariant *Rets);
+
+  /// Helper function for checking the room of FrameNum frames and ValNum
+  /// values on the stack. Trap if the stack is exhausted.
+  Expect<void> checkStack(Runtime::StackManager &StackMgr, uint64_t ValNum,
+                          uint32_t FrameNum = 1) noexcept;
+
   /// Helper function for calling functions. Return the continuation iterator.
   Expect<AST::InstrView::iterator>
   enterFunction(Runtime::StackManager &StackMgr,
                 const Runtime::Instance::FunctionInstance &Func,
                 const AST::InstrView::iterator RetIt, bool IsTailCall = false);
 
+  /// Helper function for counting the hotness of the native wasm function and
+  /// invoking the tier-up callback.
+  void countTierUp(const Runtime::Instance::FunctionInstance &Func) noexcept;
+
+  /// Helper function for lowering the native wasm function into the register
+  /// code. Return nullptr if the function cannot be lowered.
+  std::unique_ptr<Runtime::RegisterCode>
+  lowerRegisterCode(const Runtime::Instance::FunctionInstance &Func) const
+      noexcept;
+
+  /// Helper function for running the register code in the top frame.
+  Expect<void>
+  runRegisterCode(Runtime::StackManager &StackMgr,
+                  const Runtime::Instance::FunctionInstance &Func,
+                  const Runtime::RegisterCode &Code) noexcept;
+
   /// Helper function for branching to label.
   Expect<void> branchToLabel(Runtime::StackManager &StackMgr,
                              const AST::Instruction::JumpDescriptor &JumpDesc,
@@ -322,6 +424,61 @@ private:
 
   /// Helper function for clean the unused bits of numeric values in ValVariant.
   void cleanNumericVal(ValVariant &Val, const ValType &Type) const noexcept;
+
+  /// Helper function for calculating the effective address of the memory
+  /// instructions, which is the address operand of the memory address type
+  /// added with the offset immediate. The overflow of the 64-bit memories is
+  /// reported as out of bounds with the access length.
+  Expect<uint64_t>
+  getEffectiveAddress(const Runtime::Instance::MemoryInstance &MemInst,
+                      const ValVariant &Addr, const AST::Instruction &Instr,
+                      uint64_t Length) const noexcept;
+  /// @}
+
+  /// \name Helper Functions for GC instructions.
+  /// @{
+  /// Helper function for allocating an array instance of the defined type.
+  Expect<Runtime::Instance::ArrayInstance *>
+  allocArray(Runtime::StackManager &StackMgr, uint32_t DefIndex,
+             uint32_t Length) const noexcept;
+
+  /// Helper function for creating an array instance from the data segment.
+  Expect<RefVariant>
+  newArrayFromData(Runtime::StackManager &StackMgr, uint32_t DefIndex,
+                   const Runtime::Instance::DataInstance &DataInst, uint32_t S,
+                   uint32_t N) const noexcept;
+
+  /// Helper function for creating an array instance from the element segment.
+  Expect<RefVariant>
+  newArrayFromElem(Runtime::StackManager &StackMgr, uint32_t DefIndex,
+                   const Runtime::Instance::ElementInstance &ElemInst,
+                   uint32_t S, uint32_t N) const noexcept;
+
+  /// Helper function for filling the elements of an array instance.
+  Expect<void> fillArray(const RefVariant &InstRef, uint32_t D, uint32_t N,
+                         const ValVariant &Val) const noexcept;
+
+  /// Helper function for copying the elements between array instances.
+  Expect<void> copyArray(const RefVariant &DstInstRef, uint32_t D,
+                         const RefVariant &SrcInstRef, uint32_t S,
+                         uint32_t N) const noexcept;
+
+  /// Helper function for initializing an array instance from the data segment.
+  Expect<void>
+  initArrayFromData(const RefVariant &InstRef, uint32_t D,
+                    const Runtime::Instance::DataInstance &DataInst, uint32_t S,
+                    uint32_t N) const noexcept;
+
+  /// Helper function for initializing an array instance from the element
+  /// segment.
+  Expect<void>
+  initArrayFromElem(const RefVariant &InstRef, uint32_t D,
+                    const Runtime::Instance::ElementInstance &ElemInst,
+                    uint32_t S, uint32_t N) const noexcept;
+
+  /// Helper function for matching a reference with the type in the module.
+  bool matchRefType(const Runtime::Instance::ModuleInstance *ModInst,
+                    const ValType &Type, const RefVariant &Ref) const noexcept;
   /// @}
 
   /// \name Run instructions functions
@@ -397,15 +554,15 @@ private:
                               const uint32_t DefIndex,
                               bool IsDefault = false) const noexcept;
   Expect<void> runStructGetOp(ValVariant &Val, const uint32_t Idx,
-                              const AST::CompositeType &CompType,
                               const AST::Instruction &Instr,
                               bool IsSigned = false) const noexcept;
   Expect<void> runStructSetOp(const ValVariant &Val, const RefVariant &InstRef,
-                              const AST::CompositeType &CompType, uint32_t Idx,
+                              uint32_t Idx,
                               const AST::Instruction &Instr) const noexcept;
   Expect<void> runArrayNewOp(Runtime::StackManager &StackMgr,
                              const uint32_t DefIndex, uint32_t InitCnt,
-                             uint32_t ValCnt) const noexcept;
+                             uint32_t ValCnt,
+                             const AST::Instruction &Instr) const noexcept;
   Expect<void>
   runArrayNewDataOp(Runtime::StackManager &StackMgr,
                     const Runtime::Instance::DataInstance &DataInst,
@@ -416,34 +573,27 @@ private:
                     const AST::Instruction &Instr) const noexcept;
   Expect<void> runArraySetOp(const ValVariant &Val, const uint32_t Idx,
                              const RefVariant &InstRef,
-                             const AST::CompositeType &CompType,
                              const AST::Instruction &Instr) const noexcept;
   Expect<void> runArrayGetOp(ValVariant &Val, const uint32_t Idx,
-                             const AST::CompositeType &CompType,
                              const AST::Instruction &Instr,
                              bool IsSigned = false) const noexcept;
   Expect<void> runArrayLenOp(ValVariant &Val,
                              const AST::Instruction &Instr) const noexcept;
   Expect<void> runArrayFillOp(uint32_t N, const ValVariant &Val, uint32_t D,
                               const RefVariant &InstRef,
-                              const AST::CompositeType &CompType,
                               const AST::Instruction &Instr) const noexcept;
   Expect<void> runArrayCopyOp(uint32_t N, uint32_t S,
                               const RefVariant &SrcInstRef, uint32_t D,
                               const RefVariant &DstInstRef,
-                              const AST::CompositeType &SrcCompType,
-                              const AST::CompositeType &DstCompType,
                               const AST::Instruction &Instr) const noexcept;
   Expect<void>
   runArrayInitDataOp(uint32_t N, uint32_t S, uint32_t D,
                      const RefVariant &InstRef,
-                     const AST::CompositeType &CompType,
                      const Runtime::Instance::DataInstance &DataInst,
                      const AST::Instruction &Instr) const noexcept;
   Expect<void>
   runArrayInitElemOp(uint32_t N, uint32_t S, uint32_t D,
                      const RefVariant &InstRef,
-                     const AST::CompositeType &CompType,
                      const Runtime::Instance::ElementInstance &ElemInst,
                      const AST::Instruction &Instr) const noexcept;
   Expect<void> runRefTestOp(const Runtime::Instance::ModuleInstance *ModInst,
@@ -723,6 +873,13 @@ private:
   runAtomicCompareExchangeOp(Runtime::StackManager &StackMgr,
                              Runtime::Instance::MemoryInstance &MemInst,
                              const AST::Instruction &Instr);
+  /// ======= Superinstructions =======
+  Expect<void> runFusedOp(Runtime::StackManager &StackMgr,
+                          AST::InstrView::iterator &PC) noexcept;
+  void runFusedBinaryOp(OpCode Code, ValVariant &Val1,
+                        const ValVariant &Val2) const noexcept;
+  bool runFusedCompareOp(Runtime::StackManager &StackMgr,
+                         OpCode Code) const noexcept;
   /// @}
 
   /// \name Run compiled functions
@@ -736,20 +893,20 @@ public:
                             const uint32_t TableIdx, const uint32_t FuncTypeIdx,
                             const uint32_t FuncIdx, const ValVariant *Args,
                             ValVariant *Rets) noexcept;
-  Expect<uint32_t> memGrow(Runtime::StackManager &StackMgr,
+  Expect<uint64_t> memGrow(Runtime::StackManager &StackMgr,
                            const uint32_t MemIdx,
-                           const uint32_t NewSize) noexcept;
-  Expect<uint32_t> memSize(Runtime::StackManager &StackMgr,
+                           const uint64_t NewSize) noexcept;
+  Expect<uint64_t> memSize(Runtime::StackManager &StackMgr,
                            const uint32_t MemIdx) noexcept;
   Expect<void> memCopy(Runtime::StackManager &StackMgr,
                        const uint32_t DstMemIdx, const uint32_t SrcMemIdx,
-                       const uint32_t DstOff, const uint32_t SrcOff,
-                       const uint32_t Len) noexcept;
+                       const uint64_t DstOff, const uint64_t SrcOff,
+                       const uint64_t Len) noexcept;
   Expect<void> memFill(Runtime::StackManager &StackMgr, const uint32_t MemIdx,
-                       const uint32_t Off, const uint8_t Val,
-                       const uint32_t Len) noexcept;
+                       const uint64_t Off, const uint8_t Val,
+                       const uint64_t Len) noexcept;
   Expect<void> memInit(Runtime::StackManager &StackMgr, const uint32_t MemIdx,
-                       const uint32_t DataIdx, const uint32_t DstOff,
+                       const uint32_t DataIdx, const uint64_t DstOff,
                        const uint32_t SrcOff, const uint32_t Len) noexcept;
   Expect<void> dataDrop(Runtime::StackManager &StackMgr,
                         const uint32_t DataIdx) noexcept;
@@ -785,16 +942,51 @@ public:
                                     const uint32_t FuncIdx) noexcept;
   Expect<uint32_t> memoryAtomicNotify(Runtime::StackManager &StackMgr,
                                       const uint32_t MemIdx,
-                                      const uint32_t Offset,
+                                      const uint64_t Offset,
                                       const uint32_t Count) noexcept;
   Expect<uint32_t>
   memoryAtomicWait(Runtime::StackManager &StackMgr, const uint32_t MemIdx,
-                   const uint32_t Offset, const uint64_t Expected,
+                   const uint64_t Offset, const uint64_t Expected,
                    const int64_t Timeout, const uint32_t BitWidth) noexcept;
   Expect<void> callRef(Runtime::StackManager &StackMgr, const RefVariant Ref,
                        const ValVariant *Args, ValVariant *Rets) noexcept;
   Expect<void *> refGetFuncSymbol(Runtime::StackManager &StackMgr,
                                   const RefVariant Ref) noexcept;
+  Expect<RefVariant> structNew(Runtime::StackManager &StackMgr,
+                               const uint32_t TypeIdx) noexcept;
+  Expect<RefVariant> arrayNew(Runtime::StackManager &StackMgr,
+                              const uint32_t TypeIdx, const uint32_t Length,
+                              const ValVariant *InitVals,
+                              const uint32_t InitCnt) noexcept;
+  Expect<RefVariant> arrayNewData(Runtime::StackManager &StackMgr,
+                                  const uint32_t TypeIdx,
+                                  const uint32_t DataIdx, const uint32_t Off,
+                                  const uint32_t Len) noexcept;
+  Expect<RefVariant> arrayNewElem(Runtime::StackManager &StackMgr,
+                                  const uint32_t TypeIdx,
+                                  const uint32_t ElemIdx, const uint32_t Off,
+                                  const uint32_t Len) noexcept;
+  Expect<void> arrayFill(Runtime::StackManager &StackMgr, const RefVariant Ref,
+                         const uint32_t Off, const ValVariant *Val,
+                         const uint32_t Len) noexcept;
+  Expect<void> arrayCopy(Runtime::StackManager &StackMgr,
+                         const RefVariant DstRef, const uint32_t DstOff,
+                         const RefVariant SrcRef, const uint32_t SrcOff,
+                         const uint32_t Len) noexcept;
+  Expect<void> arrayInitData(Runtime::StackManager &StackMgr,
+                             const uint32_t DataIdx, const RefVariant Ref,
+                             const uint32_t DstOff, const uint32_t SrcOff,
+                             const uint32_t Len) noexcept;
+  Expect<void> arrayInitElem(Runtime::StackManager &StackMgr,
+                             const uint32_t ElemIdx, const RefVariant Ref,
+                             const uint32_t DstOff, const uint32_t SrcOff,
+                             const uint32_t Len) noexcept;
+  Expect<uint32_t> refTest(Runtime::StackManager &StackMgr,
+                           const RefVariant Ref, const uint32_t HTCode,
+                           const uint32_t TypeIdx) noexcept;
+  Expect<void> writeBarrier(Runtime::StackManager &StackMgr,
+                            void *Obj) noexcept;
+  Expect<void> safepoint(Runtime::StackManager &StackMgr) noexcept;
 
   template <typename FuncPtr> struct ProxyHelper;
 
@@ -804,28 +996,33 @@ public:
 private:
   template <typename T>
   Expect<uint32_t> atomicWait(Runtime::Instance::MemoryInstance &MemInst,
-                              uint32_t Address, T Expected,
+                              uint64_t Address, T Expected,
                               int64_t Timeout) noexcept;
   Expect<uint32_t> atomicNotify(Runtime::Instance::MemoryInstance &MemInst,
-                                uint32_t Address, uint32_t Count) noexcept;
+                                uint64_t Address, uint32_t Count) noexcept;
   void atomicNotifyAll() noexcept;
 
-  struct Waiter {
-    std::mutex Mutex;
-    std::condition_variable Cond;
-    Runtime::Instance::MemoryInstance *MemInst;
-    Waiter(Runtime::Instance::MemoryInstance *Inst) noexcept : MemInst(Inst) {}
-  };
-  std::mutex WaiterMapMutex;
-  std::unordered_multimap<uint32_t, Waiter> WaiterMap;
+  /// Waiters of memory.atomic.wait, parked on the addresses in the memories.
+  ParkingLot Waiters;
+
+  /// Stop the running asynchronous tasks.
+  void stopTasks() noexcept;
+
+  /// Stop token of the invocation on the current thread: the one of the
+  /// asynchronous task in a `StopScope`, or the one of the executor.
+  std::atomic_uint32_t &getStopToken() noexcept {
+    return TaskOwner == this ? *TaskToken : StopToken;
+  }
 
 private:
   /// Prepare execution context
   void prepare(Runtime::StackManager &StackMgr, uint8_t *const *Memories,
-               ValVariant *const *Globals) noexcept {
+               const uint64_t *const *MemorySizes, ValVariant *const *Globals,
+               const std::array<void *, 2> *HostFuncs) noexcept {
     This = this;
-    ExecutionContext.StopToken = &StopToken;
+    ExecutionContext.StopToken = &getStopToken();
     ExecutionContext.Memories = Memories;
+    ExecutionContext.MemorySizes = MemorySizes;
     ExecutionContext.Globals = Globals;
     if (Stat) {
       ExecutionContext.InstrCount = &Stat->getInstrCountRef();
@@ -833,6 +1030,15 @@ private:
       ExecutionContext.Gas = &Stat->getTotalCostRef();
       ExecutionContext.GasLimit = Stat->getCostLimit();
     }
+    ExecutionContext.Module = StackMgr.getModule();
+    // The import stubs call the host functions directly only if nothing is
+    // done around the calls. Otherwise they call through the executor for the
+    // statistics and the pre/post host functions.
+    ExecutionContext.HostFuncs =
+        (Stat || HostFuncHelper.hasHostFuncs()) ? nullptr : HostFuncs;
+    ExecutionContext.HostFrame =
+        Runtime::CallingFrame(this, StackMgr.getModule());
+    ExecutionContext.GCRequested = Collector::getRequested();
     CurrentStack = &StackMgr;
   }
 
@@ -845,6 +1051,11 @@ private:
     std::atomic_uint64_t *Gas;
     uint64_t GasLimit;
     std::atomic_uint32_t *StopToken;
+    const Runtime::Instance::ModuleInstance *Module;
+    const uint64_t *const *MemorySizes;
+    const std::array<void *, 2> *HostFuncs;
+    Runtime::CallingFrame HostFrame{nullptr, nullptr};
+    const std::atomic<bool> *GCRequested;
   };
 
   struct SavedThreadLocal {
@@ -871,6 +1082,9 @@ private:
   static thread_local Runtime::StackManager *CurrentStack;
   /// Execution context for compiled functions
   static thread_local ExecutionContextStruct ExecutionContext;
+  /// Executor and stop token of the asynchronous task on the current thread.
+  static thread_local Executor *TaskOwner;
+  static thread_local std::atomic_uint32_t *TaskToken;
   /// @}
 
 private:
@@ -878,10 +1092,28 @@ private:
   const Configure Conf;
   /// Executor statistics
   Statistics::Statistics *Stat;
+  /// Record the execution time of host functions in statistics.
+  bool TimeMeasuring = false;
+  /// Count of the values of host function calls kept on the native stack.
+  static inline constexpr const uint32_t kHostCallInlineVals = 8;
+  /// Count of the values pushed by the instructions above the validated stack
+  /// height, such as the allocated GC objects before popping the operands.
+  static inline constexpr const uint32_t kStackHeadroom = 4;
   /// Stop Execution
   std::atomic_uint32_t StopToken = 0;
+  /// Stop tokens of the running asynchronous tasks.
+  std::mutex TaskMutex;
+  std::vector<std::atomic_uint32_t *> TaskTokens;
   /// Executor Host Function Handler
   HostFuncHandler HostFuncHelper = {};
+  /// Tier-up threshold, 0 if the tiered execution is disabled.
+  std::atomic<uint32_t> TierUpThreshold = 0;
+  /// Tier-up callback of the hot native wasm functions. Accessed atomically.
+  std::shared_ptr<
+      const std::function<void(const Runtime::Instance::FunctionInstance &)>>
+      TierUpFunc;
+  /// Thread pool of the asynchronous invocations, shared with the VM.
+  LazyThreadPool AsyncPool;
 };
 
 } // namespace Executor
@@ -0,0 +1,390 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/executor/gc.h - Garbage collector definition -------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the GC heaps of the struct and array instances and the
+/// collector of the heaps.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/span.h"
+#include "common/types.h"
+#include "runtime/instance/module.h"
+#include "runtime/stackmgr.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace WasmEdge {
+namespace Executor {
+
+/// Heap of the struct and array instances of a module instance. The objects
+/// are bump-allocated in the free holes of the chunks and never moved.
+class GCHeap {
+public:
+  /// Build the layouts of the struct and array types in the defined types.
+  GCHeap(Span<const AST::SubType *const> TypeList);
+
+  /// Getter of the layout of the defined type. nullptr if not a struct or an
+  /// array type.
+  const Runtime::Instance::GCLayout *getLayout(uint32_t TypeIdx) const noexcept {
+    return TypeIdx < Layouts.size() ? Layouts[TypeIdx].get() : nullptr;
+  }
+
+private:
+  friend class Collector;
+
+  struct Chunk {
+    Chunk(uint8_t *D, uint64_t S) noexcept
+        : Data(D), Size(S), Starts((S / 8 + 63) / 64, 0) {}
+    uint8_t *begin() const noexcept { return Data.get(); }
+    uint8_t *end() const noexcept { return Data.get() + Size; }
+    void setStart(const uint8_t *P) noexcept {
+      const uint64_t G = static_cast<uint64_t>(P - begin()) / 8;
+      Starts[G / 64] |= UINT64_C(1) << (G % 64);
+    }
+    void clearStart(const uint8_t *P) noexcept {
+      const uint64_t G = static_cast<uint64_t>(P - begin()) / 8;
+      Starts[G / 64] &= ~(UINT64_C(1) << (G % 64));
+    }
+    bool isStart(const uint8_t *P) const noexcept {
+      const uint64_t G = static_cast<uint64_t>(P - begin()) / 8;
+      return (Starts[G / 64] >> (G % 64)) & 1U;
+    }
+
+    std::unique_ptr<uint8_t[]> Data;
+    uint64_t Size;
+    /// Bitmap of the object starts in 8-byte granules.
+    std::vector<uint64_t> Starts;
+    /// Live bytes after the last sweep.
+    uint64_t LiveBytes = 0;
+    /// Allocated in since the last collection.
+    bool Young = false;
+    /// Holding a large object only.
+    bool Large = false;
+  };
+
+  struct Hole {
+    Chunk *Owner;
+    uint8_t *Begin;
+    uint8_t *End;
+  };
+
+  /// Allocate the bytes, which is a multiple of 8. nullptr if out of memory.
+  uint8_t *allocate(uint64_t Size) noexcept;
+  /// Allocate a new chunk and register it to the collector.
+  Chunk *newChunk(uint64_t Size) noexcept;
+  /// Mark the chunk as allocated in since the last collection.
+  void setYoung(Chunk &C) noexcept;
+
+  /// Mutex of the allocations and the write barriers.
+  std::mutex Mutex;
+  std::vector<std::unique_ptr<Runtime::Instance::GCLayout>> Layouts;
+  std::vector<std::unique_ptr<Chunk>> Chunks;
+  std::vector<Chunk *> YoungChunks;
+  /// Free holes of the chunks for the bump allocation.
+  std::vector<Hole> Holes;
+  /// Current bump allocation range.
+  Chunk *Current = nullptr;
+  uint8_t *Cursor = nullptr;
+  uint8_t *Limit = nullptr;
+  /// Old objects with the reference fields stored since the last collection.
+  std::vector<Runtime::Instance::GCObject *> Remembered;
+};
+
+/// Generational mark-sweep collector of the GC heaps of all module instances.
+///
+/// The objects are allocated young. A minor collection marks the young objects
+/// reachable from the roots and the remembered old objects, and sweeps the
+/// chunks allocated in since the last collection. The surviving objects keep
+/// the mark and become old. A full collection clears the marks and collects
+/// all the heaps when the old objects outgrow the threshold.
+///
+/// The roots are the value stacks of the scopes in all threads, the native
+/// frames of their compiled functions, the globals, tables, and elements of the
+/// linked module instances, and the references held by the host. The value
+/// stack slots are recognized as references by their type tags and the exact
+/// object start addresses. The native frames are untyped and scanned
+/// conservatively for the addresses in the objects.
+///
+/// The collecting thread requests the other running threads to stop, and they
+/// stop at their next function call, loop iteration, allocation, or host
+/// function call, in both the interpreted and the compiled functions. The
+/// threads out of the scopes or in the host functions are already stopped. The
+/// collection is skipped if the threads do not stop in time, such as in a long
+/// host function call in an uncollectable scope.
+class Collector {
+  struct ThreadState;
+
+public:
+  struct Statistics {
+    uint64_t MinorCount = 0;
+    uint64_t FullCount = 0;
+    uint64_t TotalPauseNs = 0;
+    uint64_t MaxPauseNs = 0;
+    uint64_t FreedBytes = 0;
+    uint64_t LiveBytes = 0;
+  };
+
+  /// Scope of an execution or an instantiation, in which the objects are
+  /// reachable from the value stack. The thread is running in the scope. The
+  /// uncollectable scopes, whose references are not all on the value stack,
+  /// block the collections until they end.
+  class Scope {
+  public:
+    Scope(Runtime::StackManager &StackMgr, bool Collectable) noexcept;
+    ~Scope() noexcept;
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+  private:
+    friend class Collector;
+    ThreadState &Thread;
+    Scope *Prev;
+    Runtime::StackManager &StackMgr;
+    bool Collectable;
+    bool WasRunning;
+    /// References pinned by the host function calls in the scope.
+    std::vector<const void *> Pins;
+  };
+
+  /// Call of a host function in the current scope. The references in the
+  /// arguments are pinned until the call returns. The interpreted executions
+  /// are stopped in the call, and so the other threads can collect the heaps.
+  /// Nothing is done before any GC heap exists.
+  class HostCall {
+  public:
+    HostCall(Span<const ValType> Types, const ValVariant *Args) noexcept {
+      if (getInstance().HeapCount.load(std::memory_order_relaxed) != 0) {
+        begin(Types, Args);
+      }
+    }
+    ~HostCall() noexcept {
+      if (Current != nullptr) {
+        end();
+      }
+    }
+    HostCall(const HostCall &) = delete;
+    HostCall &operator=(const HostCall &) = delete;
+
+  private:
+    void begin(Span<const ValType> Types, const ValVariant *Args) noexcept;
+    void end() noexcept;
+
+    ThreadState *Thread = nullptr;
+    Scope *Current = nullptr;
+    size_t PinSize = 0;
+    bool Stopped = false;
+  };
+
+  /// Reference kept by the host. The object is not collected until all of
+  /// its roots are destroyed or its module instance is deleted.
+  class Root {
+  public:
+    Root(const RefVariant &Ref) noexcept;
+    ~Root() noexcept;
+    Root(Root &&R) noexcept : Ptr(R.Ptr) { R.Ptr = nullptr; }
+    Root &operator=(Root &&R) noexcept {
+      std::swap(Ptr, R.Ptr);
+      return *this;
+    }
+    Root(const Root &) = delete;
+    Root &operator=(const Root &) = delete;
+
+  private:
+    const void *Ptr;
+  };
+
+  /// Scope of the compiled functions in the current thread. The compiled
+  /// functions keep the references in the registers and the native frames,
+  /// which are scanned under the outermost scope in the collection.
+  class NativeScope {
+  public:
+    NativeScope() noexcept;
+    ~NativeScope() noexcept;
+    NativeScope(const NativeScope &) = delete;
+    NativeScope &operator=(const NativeScope &) = delete;
+
+  private:
+    const void *Prev;
+  };
+
+  static Collector &getInstance() noexcept;
+
+  /// Link the module instance, whose globals, tables, and elements are roots.
+  void link(const Runtime::Instance::ModuleInstance &Mod) noexcept;
+
+  /// Allocate a struct instance of the defined type in the module of the top
+  /// frame. The fields are default values.
+  Runtime::Instance::StructInstance *
+  newStruct(Runtime::StackManager &StackMgr, uint32_t TypeIdx) noexcept;
+
+  /// Allocate an array instance of the defined type in the module of the top
+  /// frame. The elements are uninitialized. nullptr if out of memory.
+  Runtime::Instance::ArrayInstance *newArray(Runtime::StackManager &StackMgr,
+                                             uint32_t TypeIdx,
+                                             uint32_t Length) noexcept;
+
+  /// Record the old object, whose reference fields are going to be stored.
+  void writeBarrier(Runtime::Instance::GCObject &Obj) noexcept {
+    using Runtime::Instance::GCObject;
+    if (unlikely((Obj.getFlags() & (GCObject::kMarked |
+                                    GCObject::kRemembered)) ==
+                 GCObject::kMarked)) {
+      remember(Obj);
+    }
+  }
+
+  /// Pin the objects in the results of the current invocation, which are
+  /// returned to the host. The results of a nested invocation are pinned until
+  /// the enclosing host function call returns. The results of the outermost
+  /// invocation are rooted once each, and kept until the host releases them
+  /// by `unroot` or their module instance is deleted.
+  void pin(Span<const ValType> Types, const ValVariant *Vals) noexcept {
+    if (HeapCount.load(std::memory_order_relaxed) != 0) {
+      pinRefs(Types, Vals);
+    }
+  }
+
+  /// Add a root of the reference kept by the host. Released by `unroot`.
+  void root(const RefVariant &Ref) noexcept;
+  /// Release a root of the reference. Nothing is done if the reference has no
+  /// root, such as after its module instance is deleted.
+  void unroot(const RefVariant &Ref) noexcept;
+
+  /// Stop the current thread if a collection is requested.
+  static void safepoint() noexcept {
+    if (unlikely(Requested.load(std::memory_order_relaxed))) {
+      getInstance().park();
+    }
+  }
+
+  /// Getter of the flag of the requested collection, which the compiled
+  /// functions poll at their entries and loop headers before calling
+  /// safepoint().
+  static const std::atomic<bool> *getRequested() noexcept {
+    return &Requested;
+  }
+
+  /// Collect the heaps after stopping the other threads. Return false if not
+  /// collected.
+  bool collect(bool Full) noexcept;
+
+  /// Check if the address is the start of a live object.
+  bool isLive(const void *Ptr) const noexcept;
+
+  /// Getter of the statistics.
+  Statistics getStatistics() const noexcept;
+
+private:
+  friend class GCHeap;
+  Collector() noexcept = default;
+
+  /// Chunk size of the small objects.
+  static inline constexpr const uint64_t kChunkSize = UINT64_C(256) << 10;
+  /// The objects larger than this size are allocated in their own chunks.
+  static inline constexpr const uint64_t kLargeSize = kChunkSize / 4;
+  /// The holes smaller than this size are not reused until the next sweep.
+  static inline constexpr const uint64_t kMinHoleSize = 128;
+  /// Allocated bytes between the minor collections.
+  static inline constexpr const uint64_t kNurserySize = UINT64_C(2) << 20;
+  /// Minimum old bytes triggering the full collection.
+  static inline constexpr const uint64_t kMinFullSize = UINT64_C(32) << 20;
+
+  /// Timeout of stopping the other threads for a collection.
+  static inline constexpr const std::chrono::milliseconds kStopTimeout{10};
+
+  GCHeap &getHeap(const Runtime::Instance::ModuleInstance &Mod) noexcept;
+  void maybeCollect() noexcept;
+  void remember(Runtime::Instance::GCObject &Obj) noexcept;
+  void pinRefs(Span<const ValType> Types, const ValVariant *Vals) noexcept;
+  static void unlink(const Runtime::Instance::ModuleInstance *Mod) noexcept;
+
+  /// \name Helpers of stopping the threads.
+  /// @{
+  static ThreadState &getThread() noexcept;
+  /// Set the thread running, after the requested collection.
+  void enterRunning(ThreadState &Thread) noexcept;
+  /// Set the thread stopped, whose roots are visible to the collections.
+  void leaveRunning(ThreadState &Thread) noexcept;
+  /// Stop the current thread until the requested collection ends.
+  void park() noexcept;
+  /// Wait for the other threads to stop. Return false if timeout.
+  bool stopThreads(const ThreadState &Self) noexcept;
+  /// @}
+
+  /// Register and unregister the chunk for looking up the objects.
+  void addChunk(GCHeap::Chunk &C) noexcept;
+  void removeChunk(GCHeap::Chunk &C) noexcept;
+  /// Find the object starting at the address. nullptr if not an object.
+  Runtime::Instance::GCObject *findObject(const void *Ptr) const noexcept;
+  /// Find the object containing the address. nullptr if not in an object.
+  Runtime::Instance::GCObject *
+  findObjectContaining(const void *Ptr) const noexcept;
+
+  /// \name Helpers of the collection, called with the lock held.
+  /// @{
+  void collectLocked(const ThreadState &Self, bool Full) noexcept;
+  void markPtr(const void *Ptr) noexcept;
+  void markObject(Runtime::Instance::GCObject &Obj) noexcept;
+  void traceObject(const Runtime::Instance::GCObject &Obj) noexcept;
+  void markRoots(const ThreadState &Self) noexcept;
+  void markNativeStack(const void *Base) noexcept;
+  void markNativeRange(uintptr_t Begin, uintptr_t End) noexcept;
+  void drain() noexcept;
+  void sweepHeap(GCHeap &Heap, bool Full) noexcept;
+  uint64_t sweepChunk(GCHeap &Heap, GCHeap::Chunk &C) noexcept;
+  /// @}
+
+  mutable std::mutex Mutex;
+  /// Linked module instances and their heaps.
+  std::unordered_map<const Runtime::Instance::ModuleInstance *,
+                     std::unique_ptr<GCHeap>>
+      Modules;
+  std::atomic<uint32_t> HeapCount = 0;
+  /// Chunks by their start addresses.
+  std::map<uintptr_t, GCHeap::Chunk *> ChunkMap;
+  uintptr_t MinAddr = UINTPTR_MAX;
+  uintptr_t MaxAddr = 0;
+
+  /// Threads with the scopes.
+  std::vector<ThreadState *> Threads;
+  /// References kept by the host, and their root counts. The roots of the
+  /// objects are dropped with their module instances.
+  std::unordered_map<const void *, uint32_t> Roots;
+
+  /// Flag of a requested collection. The stopped threads wait on the
+  /// condition for the end of the collection, and the collecting thread waits
+  /// on it for the threads to stop.
+  static inline std::atomic<bool> Requested = false;
+  std::mutex StopMutex;
+  std::condition_variable StopCond;
+
+  /// Allocated bytes since the last collection, and the bytes triggering the
+  /// next one.
+  std::atomic<uint64_t> YoungBytes = 0;
+  std::atomic<uint64_t> NextCollect = kNurserySize;
+  /// Old bytes triggering the next full collection.
+  uint64_t FullThreshold = kMinFullSize;
+
+  std::vector<Runtime::Instance::GCObject *> MarkStack;
+  Statistics Stat;
+};
+
+} // namespace Executor
+} // namespace WasmEdge
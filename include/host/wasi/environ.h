@@ -532,6 +532,7 @@ public:
     } else if (auto It2 = FdMap.find(To); It2 == FdMap.end()) {
       return WasiUnexpect(__WASI_ERRNO_BADF);
     } else {
+      close(It2->second);
       FdMap.erase(It2);
       auto Node = FdMap.extract(It);
       Node.key() = To;
@@ -897,6 +898,19 @@ public:
   /// @return Nothing or WASI error
   WasiExpect<void> schedYield() const noexcept;
 
+  /// Select the I/O backend of the following WASI calls in the calling
+  /// thread.
+  ///
+  /// With io_uring on Linux, the guest memory is registered as the fixed
+  /// buffer of the reads and writes if it is not larger than MaxBufferSize.
+  /// Other platforms always use the default backend.
+  ///
+  /// @param[in] EnableIOUring Whether to use io_uring if supported.
+  /// @param[in] MaxBufferSize The maximum size of the registered memory.
+  /// @param[in] Memory The linear memory of the calling module.
+  static void selectIOBackend(bool EnableIOUring, uint64_t MaxBufferSize,
+                              Span<uint8_t> Memory) noexcept;
+
   /// Write high-quality random data into a buffer.
   ///
   /// This function blocks when the implementation is unable to immediately
@@ -1286,6 +1300,7 @@ Environ::acquirePoller(Span<__wasi_event_t> Events) noexcept {
 
 inline void Environ::close(std::shared_ptr<VINode> Node) noexcept {
   std::unique_lock Lock(PollerMutex);
+  countClose();
   for (auto &Poller : PollerPool) {
     Poller.close(Node);
   }
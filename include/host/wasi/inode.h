@@ -8,6 +8,7 @@
 #include "common/span.h"
 #include "host/wasi/error.h"
 #include "host/wasi/vfs.h"
+#include <atomic>
 #include <functional>
 #include <limits>
 #include <optional>
@@ -54,29 +55,34 @@ struct FdHolder {
   FdHolder &operator=(const FdHolder &) = delete;
   FdHolder(FdHolder &&RHS) noexcept
       : Fd(std::exchange(RHS.Fd, -1)), Cleanup(RHS.Cleanup),
-        Append(RHS.Append) {
+        Append(RHS.Append), NonBlock(RHS.NonBlock) {
     RHS.Cleanup = true;
     RHS.Append = false;
+    RHS.NonBlock = false;
   }
   FdHolder &operator=(FdHolder &&RHS) noexcept {
     using std::swap;
     swap(Fd, RHS.Fd);
     Cleanup = RHS.Cleanup;
     Append = RHS.Append;
+    NonBlock = RHS.NonBlock;
     RHS.Cleanup = true;
     RHS.Append = false;
+    RHS.NonBlock = false;
     return *this;
   }
 
-  constexpr FdHolder() noexcept : Fd(-1), Cleanup(true), Append(false) {}
+  constexpr FdHolder() noexcept
+      : Fd(-1), Cleanup(true), Append(false), NonBlock(false) {}
   ~FdHolder() noexcept {
     if (Cleanup) {
       reset();
     }
   }
   explicit constexpr FdHolder(int Fd, bool Cleanup = true,
-                              bool Append = false) noexcept
-      : Fd(Fd), Cleanup(Cleanup), Append(Append) {}
+                              bool Append = false,
+                              bool NonBlock = false) noexcept
+      : Fd(Fd), Cleanup(Cleanup), Append(Append), NonBlock(NonBlock) {}
   constexpr bool ok() const noexcept { return Fd >= 0; }
   void reset() noexcept;
   int release() noexcept { return std::exchange(Fd, -1); }
@@ -88,6 +94,9 @@ struct FdHolder {
   int Fd = -1;
   bool Cleanup : 1;
   mutable bool Append : 1;
+  /// The `O_NONBLOCK` flag set through WASI, for the I/O backends which do
+  /// not follow the flag of the fd.
+  mutable bool NonBlock : 1;
 };
 
 struct DirHolder {
@@ -827,6 +836,9 @@ private:
 };
 
 class PollerContext;
+#if WASMEDGE_OS_LINUX
+class IOUring;
+#endif
 class Poller
 #if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
     : public FdHolder
@@ -927,8 +939,14 @@ private:
   struct FdData {
     OptionalEvent *ReadEvent = nullptr;
     OptionalEvent *WriteEvent = nullptr;
+#if WASMEDGE_OS_LINUX
+    /// The epoll events of the subscriptions, or 0 for the timers.
+    uint32_t Interest = 0;
+#endif
   };
   std::unordered_map<int, FdData> FdDatas;
+#endif
+#if WASMEDGE_OS_MACOS
   std::unordered_map<int, FdData> OldFdDatas;
 #endif
 
@@ -965,6 +983,43 @@ private:
 
   std::vector<Timer> Timers;
   std::vector<struct epoll_event> EPollEvents;
+
+  /// The interest set of the epoll instance, which persists across the polls.
+  /// An fd stays registered with its last interest until it is closed, or
+  /// until it is reported without a subscription, so a poll repeating the
+  /// subscriptions of the previous one needs no `epoll_ctl`. The interest 0
+  /// marks an fd of unknown state, which is registered again when used.
+  std::unordered_map<int, uint32_t> Registered;
+  /// The count of the closes known to the registrations.
+  uint64_t CloseCount = 0;
+
+  /// The monotonic and relative clocks are folded into the timeout of the
+  /// epoll wait as the deadlines on the monotonic clock, and the other clocks
+  /// use the timers.
+  struct Deadline {
+    __wasi_timestamp_t Time;
+    OptionalEvent *Event;
+  };
+  std::vector<Deadline> Deadlines;
+
+  /// Bring the interest set up to the subscribed fds.
+  void updateInterest() noexcept;
+  /// Deliver the epoll event to the subscriptions of its fd.
+  void processEvent(const struct epoll_event &EPollEvent) noexcept;
+
+  /// The io_uring backend polls the fds with one-shot poll requests, and the
+  /// monotonic and relative clocks with timeout requests in place of the
+  /// timers.
+  struct RingTimeout {
+    /// The timeout in the layout of `__kernel_timespec`.
+    int64_t Seconds;
+    int64_t Nanoseconds;
+    bool Absolute;
+    OptionalEvent *Event;
+  };
+  void waitRing() noexcept;
+  IOUring *Ring = nullptr;
+  std::vector<RingTimeout> RingTimeouts;
 #endif
 
 #if WASMEDGE_OS_MACOS
@@ -978,15 +1033,22 @@ private:
 };
 
 class PollerContext {
-#if WASMEDGE_OS_LINUX
 public:
+  /// Count the closed fds. The pollers out of the pool at the time of a close
+  /// find their cached states outdated by the count.
+  void countClose() noexcept { ++CloseCount; }
+  uint64_t closeCount() const noexcept { return CloseCount.load(); }
+
+#if WASMEDGE_OS_LINUX
   WasiExpect<Poller::Timer> acquireTimer(__wasi_clockid_t Clock) noexcept;
   void releaseTimer(Poller::Timer &&) noexcept;
+#endif
 
 private:
+  std::atomic<uint64_t> CloseCount = 0;
+#if WASMEDGE_OS_LINUX
   std::mutex TimerMutex; ///< Protect TimerPool
   std::unordered_map<__wasi_clockid_t, std::vector<Poller::Timer>> TimerPool;
-#else
 #endif
 };
 
@@ -21,6 +21,7 @@
 #include "llvm/data.h"
 
 #include <mutex>
+#include <string>
 
 namespace WasmEdge::LLVM {
 
@@ -31,9 +32,18 @@ public:
 
   Expect<Data> compile(const AST::Module &Module) noexcept;
 
+  /// Translate the module without running the optimization passes, which are
+  /// left to the lazy JIT to run on the functions on demand.
+  Expect<Data> translate(const AST::Module &Module) noexcept;
+
+  /// Get the string identifying the generated code of this configuration,
+  /// used as the salt of the compiled module cache.
+  std::string fingerprint() const noexcept;
+
   struct CompileContext;
 
 private:
+  Expect<Data> compile(const AST::Module &Module, bool Optimize) noexcept;
   void compile(const AST::ImportSection &ImportSection) noexcept;
   void compile(const AST::ExportSection &ExportSection) noexcept;
   void compile(const AST::TypeSection &TypeSection) noexcept;
@@ -17,6 +17,9 @@
 #include "common/configure.h"
 #include "common/errcode.h"
 #include "llvm/data.h"
+
+#include <memory>
+#include <string_view>
 #include <vector>
 
 namespace WasmEdge::LLVM {
@@ -24,7 +27,11 @@ class OrcLLJIT;
 
 class JITLibrary : public Executable {
 public:
-  JITLibrary(OrcLLJIT JIT) noexcept;
+  /// Names of the functions compiled by the lazy JIT.
+  struct CompiledFunctions;
+
+  JITLibrary(OrcLLJIT JIT,
+             std::shared_ptr<CompiledFunctions> Compiled = {}) noexcept;
   ~JITLibrary() noexcept override;
 
   Symbol<const IntrinsicsTable *> getIntrinsics() noexcept override;
@@ -34,8 +41,19 @@ public:
   std::vector<Symbol<void>> getCodes(size_t Offset,
                                      size_t Size) noexcept override;
 
+  /// Get the code of the function, such as `f0`, and compile it on the
+  /// calling thread first. Unlike the stubs returned by `getCodes`, only the
+  /// partition of the requested function is compiled for the lazy JIT.
+  Symbol<void> getCompiledCode(size_t Index) noexcept;
+
+  /// Check if the function of the symbol name, such as `f0`, is compiled. The
+  /// functions of the lazy JIT are compiled at their first calls, and the
+  /// others are compiled at the load.
+  bool isCompiled(std::string_view Name) const noexcept;
+
 private:
   OrcLLJIT *J;
+  std::shared_ptr<CompiledFunctions> Compiled;
 };
 
 class JIT {
@@ -43,6 +61,10 @@ public:
   JIT(const Configure &Conf) noexcept : Conf(Conf) {}
   Expect<std::shared_ptr<Executable>> load(Data D) noexcept;
 
+  /// Load the module translated by `Compiler::translate`. The functions are
+  /// optimized and compiled individually when they are called the first time.
+  Expect<std::shared_ptr<Executable>> loadLazy(Data D) noexcept;
+
 private:
   const Configure Conf;
 };
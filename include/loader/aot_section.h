@@ -17,6 +17,7 @@
 #include "ast/section.h"
 #include "common/executable.h"
 #include "common/filesystem.h"
+#include "system/mmap.h"
 #include "system/winapi.h"
 
 #include <cstdint>
@@ -31,7 +32,10 @@ class AOTSection : public Executable {
 public:
   AOTSection() noexcept = default;
   ~AOTSection() noexcept override { unload(); }
-  Expect<void> load(const AST::AOTSection &AOTSec) noexcept;
+  /// Load the sections. The contents left in the input file are mapped from
+  /// the File, so the unmodified pages are shared with the page cache.
+  Expect<void> load(const AST::AOTSection &AOTSec,
+                    const MMap *File = nullptr) noexcept;
   void unload() noexcept;
 
   Symbol<const IntrinsicsTable *> getIntrinsics() noexcept override {
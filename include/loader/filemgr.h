@@ -92,6 +92,14 @@ public:
   /// Get the file header type.
   FileHeader getHeaderType();
 
+  /// Get the binary data, which is valid until the next reset.
+  Span<const Byte> getCode() const noexcept { return {Data, Size}; }
+
+  /// Get the mapped file of the binary data. nullptr if not set by the path.
+  const MMap *getFileMap() const noexcept {
+    return FileMap ? &*FileMap : nullptr;
+  }
+
   /// Get current offset.
   uint64_t getOffset() const noexcept { return Pos; }
 
@@ -21,6 +21,7 @@
 #include "loader/serialize.h"
 #include "loader/shared_library.h"
 
+#include <bitset>
 #include <cstdint>
 #include <memory>
 #include <mutex>
@@ -179,6 +180,8 @@ public:
                               std::shared_ptr<Executable> Library);
 
 private:
+  friend class StreamLoader;
+
   /// \name Helper functions to print error log when loading AST nodes
   /// @{
   inline Unexpected<ErrCode> logLoadError(ErrCode Code, uint64_t Off,
@@ -208,6 +211,9 @@ private:
   Expect<void> loadModule(AST::Module &Mod);
   Expect<void> loadModuleInBound(AST::Module &Mod,
                                  std::optional<uint64_t> Bound);
+  Expect<void> loadModuleSection(AST::Module &Mod, uint8_t NewSectionId,
+                                 std::bitset<0x0EU> &Secs);
+  Expect<void> checkModule(AST::Module &Mod);
   Expect<void> loadUniversalWASM(AST::Module &Mod);
   Expect<void> loadModuleAOT(AST::AOTSection &AOTSection);
   Expect<void> loadComponent(AST::Component::Component &Comp);
@@ -306,6 +312,7 @@ private:
   Expect<void> loadSection(AST::StartSection &Sec);
   Expect<void> loadSection(AST::ElementSection &Sec);
   Expect<void> loadSection(AST::CodeSection &Sec);
+  Expect<void> loadSectionParallel(AST::CodeSection &Sec, uint32_t Threads);
   Expect<void> loadSection(AST::DataSection &Sec);
   Expect<void> loadSection(AST::DataCountSection &Sec);
   Expect<void> loadSection(AST::TagSection &Sec);
@@ -320,7 +327,12 @@ private:
   Expect<void> loadSection(AST::Component::CanonSection &Sec);
   Expect<void> loadSection(AST::Component::ImportSection &Sec);
   Expect<void> loadSection(AST::Component::ExportSection &Sec);
-  static Expect<void> loadSection(FileMgr &VecMgr, AST::AOTSection &Sec);
+  /// Load the AOT section from VecMgr. If FileOffset is set, the data of
+  /// VecMgr is at the offset of the mapped input file, and the page-aligned
+  /// section contents are left in the file.
+  static Expect<void>
+  loadSection(FileMgr &VecMgr, AST::AOTSection &Sec,
+              std::optional<uint64_t> FileOffset = std::nullopt);
   Expect<void> loadImport(AST::Component::Import &Im);
   Expect<void> loadExport(AST::Component::Export &Ex);
   Expect<void> loadCanonical(AST::Component::Canon &C);
@@ -421,8 +433,22 @@ private:
   Expect<void> loadExpression(AST::Expression &Expr,
                               std::optional<uint64_t> SizeBound = std::nullopt);
   Expect<OpCode> loadOpCode();
-  Expect<AST::InstrVec> loadInstrSeq(std::optional<uint64_t> SizeBound);
-  Expect<void> loadInstruction(AST::Instruction &Instr);
+  Expect<AST::Expression> loadInstrSeq(std::optional<uint64_t> SizeBound);
+  Expect<void> loadInstruction(AST::Instruction &Instr,
+                               AST::ImmediateBuffer &Buffer);
+  /// @}
+
+  /// \name Helper functions of lazy loaded function bodies.
+  /// @{
+  /// Bytes of the code section with the contexts to decode the bodies.
+  struct LazyCode {
+    const Configure Conf;
+    const std::vector<Byte> Code;
+    const bool HasDataSection;
+  };
+  bool isLazyLoading() const noexcept;
+  static Expect<AST::Expression> loadLazyBody(const LazyCode &Code,
+                                              uint64_t Begin, uint64_t End);
   /// @}
 
   /// \name Loader members
@@ -437,6 +463,9 @@ private:
   /// Input data type enumeration.
   enum class InputType : uint8_t { WASM, UniversalWASM, SharedLibrary };
   InputType WASMType = InputType::WASM;
+  /// Code section of the loading lazy loaded bodies, and its offset.
+  std::shared_ptr<const LazyCode> LazyCodeSec;
+  uint64_t LazyCodeOffset = 0;
   /// @}
 
   // Metadata
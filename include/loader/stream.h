@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/loader/stream.h - Streaming loader definition ------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the declaration of the StreamLoader class, which loads a
+/// WASM module from the chunks of the binary while they are still arriving.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "ast/module.h"
+#include "common/configure.h"
+#include "common/errcode.h"
+#include "common/span.h"
+#include "loader/loader.h"
+
+#include <bitset>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace WasmEdge {
+namespace Loader {
+
+/// Streaming loader of a WASM module. The sections are loaded as soon as their
+/// bytes are complete, and the function bodies of the code section are loaded
+/// one by one while the rest of the section is arriving. Only the WASM module
+/// is supported. The AOT section of the universal WASM is loaded as a custom
+/// section, and the function bodies are always loaded.
+///
+/// The loaded function bodies can be validated through the callback with
+/// Validator::validateCodeSegment() while the binary is arriving. The
+/// compilation is not overlapped, because the compiler works on the whole
+/// module.
+///
+/// The stream loader is not thread-safe.
+class StreamLoader {
+public:
+  StreamLoader(const Configure &Conf) noexcept;
+  ~StreamLoader() noexcept = default;
+
+  /// Append the chunk of the binary and load the completed parts. The parts
+  /// after a malformed one are only buffered, and the error is reported by
+  /// finish() as the one from Loader::parseModule.
+  Expect<void> feed(Span<const Byte> Chunk);
+
+  /// End the binary and get the loaded module. The module should then be
+  /// validated as the ones from Loader::parseModule. The following feeds and
+  /// finishes fail.
+  Expect<std::unique_ptr<AST::Module>> finish();
+
+  /// Set the callback on every function body of the code section loaded while
+  /// the rest of the binary is arriving, e.g. to validate it. The callback gets
+  /// the module with the sections before the code section, and the index of
+  /// the body. The bodies of the code section loaded as a whole are not passed.
+  void setCodeSegmentCallback(
+      std::function<void(const AST::Module &, uint32_t)> Callback) noexcept {
+    CodeSegCallback = std::move(Callback);
+  }
+
+  /// Get the offset of the binary loaded to.
+  uint64_t getLoadedOffset() const noexcept { return Offset; }
+
+private:
+  enum class Stage : uint8_t {
+    /// Waiting for the magic and the version.
+    Preamble,
+    /// Waiting for a complete section.
+    Section,
+    /// Waiting for the function count of the code section.
+    CodeCount,
+    /// Waiting for the complete function bodies of the code section.
+    CodeSegment,
+    /// The binary is malformed and buffered to be loaded as a whole.
+    Malformed,
+    /// The stream is finished or failed.
+    Finished,
+  };
+
+  /// Load the completed parts from the current offset.
+  Expect<void> load();
+  /// Load the function bodies of the code section.
+  Expect<void> loadCodeSegments();
+  /// Wait for the complete code section and load it as a whole, for the
+  /// malformed sizes to be reported as the other loaders.
+  void waitCodeSection() noexcept;
+
+  Loader Load;
+  std::vector<Byte> Buffer;
+  std::unique_ptr<AST::Module> Mod;
+  /// Loaded section types.
+  std::bitset<0x0EU> Secs;
+  Stage CurrStage = Stage::Preamble;
+  /// Offset of the next part to load.
+  uint64_t Offset = 0;
+  /// Offset of the code section ID and the end of the code section.
+  uint64_t CodeOffset = 0;
+  uint64_t CodeEnd = 0;
+  /// Count of the loaded function bodies.
+  uint32_t Loaded = 0;
+  /// Error of the failed stream.
+  std::optional<ErrCode> Error;
+  /// Callback on the loaded function bodies.
+  std::function<void(const AST::Module &, uint32_t)> CodeSegCallback;
+};
+
+} // namespace Loader
+} // namespace WasmEdge
@@ -29,6 +29,15 @@ class CallingFrame;
 
 class HostFunctionBase {
 public:
+  /// Native entry of the host function in the C calling convention, which
+  /// the compiled import stubs call directly. The arguments and the returns
+  /// are in the buffers of the sizes of the function type. Returns 0 on
+  /// success, or the raw error code.
+  using NativeEntry = uint32_t (*)(HostFunctionBase *Func,
+                                   const CallingFrame *CallFrame,
+                                   const ValVariant *Args,
+                                   ValVariant *Rets) noexcept;
+
   HostFunctionBase() = delete;
   HostFunctionBase(const uint64_t FuncCost)
       : DefType(AST::FunctionType()), Cost(FuncCost) {}
@@ -50,15 +59,20 @@ public:
   /// Getter of defined type.
   const AST::SubType &getDefinedType() const noexcept { return DefType; }
 
+  /// Getter of the native entry. nullptr if only called through run().
+  NativeEntry getNativeEntry() const noexcept { return Entry; }
+
 protected:
   AST::SubType DefType;
   const uint64_t Cost;
+  NativeEntry Entry = nullptr;
 };
 
 template <typename T> class HostFunction : public HostFunctionBase {
 public:
   HostFunction(const uint64_t FuncCost = 0) : HostFunctionBase(FuncCost) {
     initializeFuncType();
+    Entry = &HostFunction::nativeEntry;
   }
 
   Expect<void> run(const CallingFrame &CallFrame, Span<const ValVariant> Args,
@@ -74,6 +88,18 @@ public:
   }
 
 protected:
+  /// Native entry specialized with the types of the body.
+  static uint32_t nativeEntry(HostFunctionBase *Func,
+                              const CallingFrame *CallFrame,
+                              const ValVariant *Args,
+                              ValVariant *Rets) noexcept {
+    using F = FuncTraits<decltype(&T::body)>;
+    auto Res = static_cast<HostFunction *>(Func)->invoke(
+        *CallFrame, Span<const ValVariant, F::ArgsN>(Args, F::ArgsN),
+        Span<ValVariant, F::RetsN>(Rets, F::RetsN));
+    return Res ? UINT32_C(0) : static_cast<uint32_t>(Res.error());
+  }
+
   template <typename SpanA, typename SpanR>
   Expect<void> invoke(const CallingFrame &CallFrame, SpanA &&Args,
                       SpanR &&Rets) {
@@ -18,49 +18,93 @@
 #include "common/types.h"
 #include "runtime/instance/composite.h"
 
-#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 
 namespace WasmEdge {
 namespace Runtime {
 namespace Instance {
 
-class ArrayInstance : public CompositeBase {
+/// Array instance in the GC heap. The elements follow the header in the size
+/// of the element storage type.
+class ArrayInstance : public GCObject {
 public:
   ArrayInstance() = delete;
+  /// The elements are uninitialized.
   ArrayInstance(const ModuleInstance *Mod, const uint32_t Idx,
-                const uint32_t Size, const ValVariant &Init) noexcept
-      : CompositeBase(Mod, Idx), Data(Size, Init) {
-    assuming(ModInst);
+                const GCLayout &L, const uint32_t Size) noexcept
+      : GCObject(Mod, Idx, L), Length(Size) {
+    assuming(ModInst && L.IsArray);
+    assuming(reinterpret_cast<const uint8_t *>(&Length) ==
+             reinterpret_cast<const uint8_t *>(this) + kLengthOffset);
   }
-  ArrayInstance(const ModuleInstance *Mod, const uint32_t Idx,
-                std::vector<ValVariant> &&Init) noexcept
-      : CompositeBase(Mod, Idx), Data(std::move(Init)) {
-    assuming(ModInst);
+
+  /// Offset of the length, which is accessed by the compiled code.
+  static inline constexpr const uint32_t kLengthOffset = 24;
+
+  /// Offset of the elements from the start of the array instance.
+  static constexpr uint32_t getDataOffset() noexcept {
+    return (static_cast<uint32_t>(sizeof(ArrayInstance)) + 7U) & ~7U;
   }
 
-  /// Get field data in array instance.
-  ValVariant &getData(uint32_t Idx) noexcept { return Data[Idx]; }
-  const ValVariant &getData(uint32_t Idx) const noexcept { return Data[Idx]; }
+  /// Size of the array instance with the length.
+  static uint64_t getObjectSize(const GCLayout &L, uint32_t Size) noexcept {
+    return (getDataOffset() + static_cast<uint64_t>(L.Size) * Size + 7U) &
+           ~UINT64_C(7);
+  }
+  uint64_t getObjectSize() const noexcept {
+    return getObjectSize(*Layout, Length);
+  }
 
-  /// Get full array.
-  Span<ValVariant> getArray() noexcept { return Data; }
-  Span<const ValVariant> getArray() const noexcept { return Data; }
+  /// Get the element data in array instance. The packed values are extended.
+  ValVariant getData(uint32_t Idx, bool IsSigned = false) const noexcept {
+    return loadValue(getElemPtr(Idx), Layout->Types[0], IsSigned);
+  }
 
-  /// Get array length.
-  uint32_t getLength() const noexcept {
-    return static_cast<uint32_t>(Data.size());
+  /// Set the element data in array instance. The packed values are wrapped.
+  void setData(uint32_t Idx, const ValVariant &Val) noexcept {
+    storeValue(getElemPtr(Idx), Layout->Size, Val);
   }
 
+  /// Fill the elements with the value.
+  void fill(uint32_t Off, uint32_t N, const ValVariant &Val) noexcept {
+    const uint32_t Size = Layout->Size;
+    uint8_t *Ptr = getElemPtr(Off);
+    if (Size == 1) {
+      std::memset(Ptr, static_cast<uint8_t>(Val.get<uint32_t>()), N);
+      return;
+    }
+    for (uint32_t I = 0; I < N; ++I, Ptr += Size) {
+      storeValue(Ptr, Size, Val);
+    }
+  }
+
+  /// Get the pointer to the element.
+  uint8_t *getElemPtr(uint32_t Idx) noexcept {
+    return reinterpret_cast<uint8_t *>(this) + getDataOffset() +
+           static_cast<uint64_t>(Idx) * Layout->Size;
+  }
+  const uint8_t *getElemPtr(uint32_t Idx) const noexcept {
+    return reinterpret_cast<const uint8_t *>(this) + getDataOffset() +
+           static_cast<uint64_t>(Idx) * Layout->Size;
+  }
+
+  /// Get the element size.
+  uint32_t getElemSize() const noexcept { return Layout->Size; }
+
+  /// Get array length.
+  uint32_t getLength() const noexcept { return Length; }
+
   /// Get boundary index.
   uint32_t getBoundIdx() const noexcept {
-    return std::max(static_cast<uint32_t>(Data.size()), UINT32_C(1)) -
-           UINT32_C(1);
+    return std::max(Length, UINT32_C(1)) - UINT32_C(1);
   }
 
 private:
   /// \name Data of array instance.
   /// @{
-  std::vector<ValVariant> Data;
+  uint32_t Length;
   /// @}
 };
 
@@ -17,6 +17,9 @@
 #include "ast/type.h"
 #include "common/types.h"
 
+#include <atomic>
+#include <cstdint>
+#include <cstring>
 #include <vector>
 
 namespace WasmEdge {
@@ -67,6 +70,118 @@ protected:
   /// @}
 };
 
+/// Layout of the struct and array instances of a defined type. The fields are
+/// stored in the sizes of their storage types.
+struct GCLayout {
+  /// Storage types of the fields, or the element type of the array.
+  std::vector<ValType> Types;
+  /// Byte offsets of the fields from the start of the struct instance.
+  std::vector<uint32_t> Offsets;
+  /// Byte offsets of the reference fields, which are traced by the collector.
+  std::vector<uint32_t> RefOffsets;
+  /// Default bytes of the struct instance after the header, or of the array
+  /// element.
+  std::vector<uint8_t> Defaults;
+  /// Size of the struct instance, or of the array element.
+  uint32_t Size = 0;
+  bool IsArray = false;
+};
+
+/// Base class of the struct and array instances allocated in the GC heap.
+class GCObject : public CompositeBase {
+public:
+  /// \name Flags of the collector.
+  /// @{
+  /// Reached in the last collection, or old since then.
+  static inline constexpr const uint8_t kMarked = 0x01;
+  /// Recorded by the write barrier since the last collection.
+  static inline constexpr const uint8_t kRemembered = 0x02;
+  /// @}
+
+  /// \name Offsets of the header data, which are accessed by the compiled
+  /// code.
+  /// @{
+  static inline constexpr const uint32_t kModuleOffset = 0;
+  static inline constexpr const uint32_t kFlagsOffset = 12;
+  /// @}
+
+  /// Getter of the layout.
+  const GCLayout &getLayout() const noexcept { return *Layout; }
+
+  /// Getter and setter of the collector flags.
+  uint8_t getFlags() const noexcept {
+    return Flags.load(std::memory_order_relaxed);
+  }
+  void setFlags(uint8_t F) noexcept {
+    Flags.fetch_or(F, std::memory_order_relaxed);
+  }
+  void clearFlags(uint8_t F) noexcept {
+    Flags.fetch_and(static_cast<uint8_t>(~F), std::memory_order_relaxed);
+  }
+
+  /// Size in bytes of the storage type.
+  static uint32_t getStorageSize(const ValType &SType) noexcept {
+    if (SType.isRefType()) {
+      return static_cast<uint32_t>(sizeof(RefVariant));
+    }
+    return SType.getBitWidth() / 8;
+  }
+
+protected:
+  GCObject(const ModuleInstance *Mod, const uint32_t Idx,
+           const GCLayout &L) noexcept
+      : CompositeBase(Mod, Idx), Flags(0), Layout(&L) {
+    assuming(reinterpret_cast<const uint8_t *>(&ModInst) ==
+             reinterpret_cast<const uint8_t *>(this) + kModuleOffset);
+    assuming(reinterpret_cast<const uint8_t *>(&Flags) ==
+             reinterpret_cast<const uint8_t *>(this) + kFlagsOffset);
+  }
+
+  /// Load the value of the storage type. The packed values are extended to
+  /// i32.
+  static ValVariant loadValue(const uint8_t *Ptr, const ValType &SType,
+                              bool IsSigned) noexcept {
+    switch (SType.getCode()) {
+    case TypeCode::I8: {
+      uint8_t V;
+      std::memcpy(&V, Ptr, 1);
+      return IsSigned ? static_cast<uint32_t>(static_cast<int8_t>(V))
+                      : static_cast<uint32_t>(V);
+    }
+    case TypeCode::I16: {
+      uint16_t V;
+      std::memcpy(&V, Ptr, 2);
+      return IsSigned ? static_cast<uint32_t>(static_cast<int16_t>(V))
+                      : static_cast<uint32_t>(V);
+    }
+    case TypeCode::Ref:
+    case TypeCode::RefNull: {
+      RefVariant V;
+      std::memcpy(&V, Ptr, sizeof(RefVariant));
+      return V;
+    }
+    default: {
+      uint128_t V = 0;
+      std::memcpy(&V, Ptr, SType.getBitWidth() / 8);
+      return V;
+    }
+    }
+  }
+
+  /// Store the value in the size of the storage type, which packs the i8 and
+  /// i16 values.
+  static void storeValue(uint8_t *Ptr, uint32_t Size,
+                         const ValVariant &Val) noexcept {
+    std::memcpy(Ptr, &Val, Size);
+  }
+
+  /// \name Data of GC objects.
+  /// @{
+  std::atomic<uint8_t> Flags;
+  const GCLayout *Layout;
+  /// @}
+};
+
 } // namespace Instance
 } // namespace Runtime
 } // namespace WasmEdge
@@ -14,11 +14,17 @@
 #pragma once
 
 #include "ast/instruction.h"
+#include "ast/segment.h"
 #include "common/symbol.h"
 #include "runtime/hostfunc.h"
 #include "runtime/instance/composite.h"
+#include "runtime/regcode.h"
 
+#include <array>
+#include <atomic>
+#include <iterator>
 #include <memory>
+#include <mutex>
 #include <numeric>
 #include <string>
 #include <vector>
@@ -37,18 +43,30 @@ public:
   /// Move constructor.
   FunctionInstance(FunctionInstance &&Inst) noexcept
       : CompositeBase(Inst.ModInst, Inst.TypeIdx), FuncType(Inst.FuncType),
-        Data(std::move(Inst.Data)) {
+        Data(std::move(Inst.Data)),
+        BodyLoaded(Inst.BodyLoaded.load(std::memory_order_acquire)),
+        BodyError(Inst.BodyError) {
     assuming(ModInst);
   }
   /// Constructor for native function.
   FunctionInstance(const ModuleInstance *Mod, const uint32_t TIdx,
                    const AST::FunctionType &Type,
                    Span<const std::pair<uint32_t, ValType>> Locs,
-                   AST::InstrView Expr) noexcept
+                   const AST::Expression &Expr) noexcept
       : CompositeBase(Mod, TIdx), FuncType(Type),
         Data(std::in_place_type_t<WasmFunction>(), Locs, Expr) {
     assuming(ModInst);
   }
+  /// Constructor for native function with lazy loaded body.
+  FunctionInstance(const ModuleInstance *Mod, const uint32_t TIdx,
+                   const AST::FunctionType &Type,
+                   Span<const std::pair<uint32_t, ValType>> Locs,
+                   AST::CodeSegment::LazyBody Body) noexcept
+      : CompositeBase(Mod, TIdx), FuncType(Type),
+        Data(std::in_place_type_t<WasmFunction>(), Locs, std::move(Body)),
+        BodyLoaded(false) {
+    assuming(ModInst);
+  }
   /// Constructor for compiled function.
   FunctionInstance(const ModuleInstance *Mod, const uint32_t TIdx,
                    const AST::FunctionType &Type,
@@ -77,7 +95,13 @@ public:
 
   /// Getter of checking is compiled function.
   bool isCompiledFunction() const noexcept {
-    return std::holds_alternative<Symbol<CompiledFunction>>(Data);
+    return std::holds_alternative<Symbol<CompiledFunction>>(Data) ||
+           isTieredFunction();
+  }
+
+  /// Getter of checking is native wasm function promoted to compiled code.
+  bool isTieredFunction() const noexcept {
+    return Tiered.load(std::memory_order_acquire);
   }
 
   /// Getter of checking is host function.
@@ -98,6 +122,42 @@ public:
     return std::get_if<WasmFunction>(&Data)->LocalNum;
   }
 
+  /// Getter of the max operand stack height of the function body. Should be
+  /// called after the body is loaded.
+  uint32_t getStackHeight() const noexcept {
+    const auto &Instrs = std::get_if<WasmFunction>(&Data)->Instrs;
+    return Instrs.empty() ? 0 : Instrs.back().getStackHeight();
+  }
+
+  /// Decode and validate the lazy loaded body of the native wasm function.
+  /// Should be called before getting the instructions. The body is loaded once
+  /// under races, and the error is kept for the following calls.
+  Expect<void> loadLazyBody() const noexcept {
+    if (likely(BodyLoaded.load(std::memory_order_acquire))) {
+      return {};
+    }
+    std::unique_lock Lock(BodyMutex);
+    if (BodyLoaded.load(std::memory_order_relaxed)) {
+      return {};
+    }
+    if (BodyError) {
+      return Unexpect(BodyError);
+    }
+    auto &Func = *std::get_if<WasmFunction>(&Data);
+    auto Res = Func.Lazy();
+    if (!Res) {
+      BodyError = Res.error();
+      return Unexpect(Res);
+    }
+    const auto &Instrs = Res->getInstrs();
+    Func.Instrs.reserve(Instrs.size() + 1);
+    Func.Instrs.assign(Instrs.begin(), Instrs.end());
+    Func.Immediates = Res->getImmediates();
+    Func.Lazy = nullptr;
+    BodyLoaded.store(true, std::memory_order_release);
+    return {};
+  }
+
   /// Getter of function body instrs.
   AST::InstrView getInstrs() const noexcept {
     if (std::holds_alternative<WasmFunction>(Data)) {
@@ -108,8 +168,111 @@ public:
   }
 
   /// Getter of symbol
-  auto &getSymbol() const noexcept {
-    return *std::get_if<Symbol<CompiledFunction>>(&Data);
+  const Symbol<CompiledFunction> &getSymbol() const noexcept {
+    if (auto *S = std::get_if<Symbol<CompiledFunction>>(&Data)) {
+      return *S;
+    }
+    return TieredSymbol;
+  }
+
+  /// Getter of the wrapper symbol to call the compiled function.
+  const Symbol<Executable::Wrapper> &getWrapperSymbol() const noexcept {
+    if (std::holds_alternative<Symbol<CompiledFunction>>(Data)) {
+      return FuncType.getSymbol();
+    }
+    return TieredWrapper;
+  }
+
+  /// Count a call or a loop back-edge of the native wasm function for the
+  /// tiered execution. Returns true only when the count reaches the threshold.
+  /// The counting is not exact under races, but never skips the threshold.
+  bool countHotness(uint32_t Threshold) const noexcept {
+    const uint32_t Count = Hotness.load(std::memory_order_relaxed);
+    if (Count >= Threshold) {
+      return false;
+    }
+    Hotness.store(Count + 1, std::memory_order_relaxed);
+    return Count + 1 == Threshold;
+  }
+
+  /// Publish the compiled code of the native wasm function. Can only be set
+  /// once, and the function is executed through the compiled code afterward.
+  void setTieredSymbol(Symbol<CompiledFunction> S,
+                       Symbol<Executable::Wrapper> W) const noexcept {
+    if (isTieredFunction()) {
+      return;
+    }
+    TieredSymbol = std::move(S);
+    TieredWrapper = std::move(W);
+    Tiered.store(true, std::memory_order_release);
+  }
+
+  /// Resolved cost and instruction count of a basic block.
+  struct BlockCost {
+    uint64_t Cost = 0;
+    uint64_t Count = 0;
+  };
+
+  /// Getter of the basic block costs of the native wasm function body, indexed
+  /// by the instructions and only set at the block leaders marked by the
+  /// validator. The costs are resolved once per cost table, keyed by the hash
+  /// of the table contents, and kept with the function instance because the
+  /// executing threads may still refer to them. At most
+  /// `kMaxBlockCostResolutions` tables are resolved, and nullptr is returned
+  /// for the others to charge the instructions one by one.
+  const BlockCost *getBlockCosts(uint64_t TableHash,
+                                 Span<const uint64_t> CostTab) const noexcept {
+    for (const auto &Slot : BlockCosts) {
+      const auto *Res = Slot.load(std::memory_order_acquire);
+      if (Res == nullptr) {
+        break;
+      }
+      if (likely(Res->TableHash == TableHash)) {
+        return Res->Costs.data();
+      }
+    }
+    std::unique_lock Lock(BlockCostMutex);
+    for (auto &Slot : BlockCosts) {
+      const auto *Res = Slot.load(std::memory_order_relaxed);
+      if (Res != nullptr) {
+        if (Res->TableHash == TableHash) {
+          return Res->Costs.data();
+        }
+        continue;
+      }
+      const auto Instrs = getInstrs();
+      auto &Owner = BlockCostResolutions[&Slot - BlockCosts.data()];
+      Owner = std::make_unique<BlockCostResolution>();
+      auto *NewRes = Owner.get();
+      NewRes->TableHash = TableHash;
+      NewRes->Costs.resize(Instrs.size());
+      size_t Leader = 0;
+      for (size_t I = 0; I < Instrs.size(); ++I) {
+        if (Instrs[I].isBlockLeader()) {
+          Leader = I;
+        }
+        NewRes->Costs[Leader].Cost += CostTab[uint16_t(Instrs[I].getOpCode())];
+        NewRes->Costs[Leader].Count++;
+      }
+      Slot.store(NewRes, std::memory_order_release);
+      return NewRes->Costs.data();
+    }
+    return nullptr;
+  }
+
+  /// Getter of the register code of the native wasm function, lowered by Lower
+  /// once after the body is loaded. nullptr if the body cannot be lowered.
+  template <typename LowerFunc>
+  const RegisterCode *getRegisterCode(LowerFunc &&Lower) const noexcept {
+    if (likely(RegCodeLowered.load(std::memory_order_acquire))) {
+      return RegCode.get();
+    }
+    std::unique_lock Lock(RegCodeMutex);
+    if (!RegCodeLowered.load(std::memory_order_relaxed)) {
+      RegCode = Lower(*this);
+      RegCodeLowered.store(true, std::memory_order_release);
+    }
+    return RegCode.get();
   }
 
   /// Getter of host function.
@@ -121,9 +284,13 @@ private:
   struct WasmFunction {
     const std::vector<std::pair<uint32_t, ValType>> Locals;
     const uint32_t LocalNum;
-    AST::InstrVec Instrs;
+    mutable AST::InstrVec Instrs;
+    /// The immediates referred by the instructions, shared with the AST.
+    mutable AST::ImmediateBuffer Immediates;
+    /// Decoder of the lazy loaded body, released after loaded.
+    mutable AST::CodeSegment::LazyBody Lazy;
     WasmFunction(Span<const std::pair<uint32_t, ValType>> Locs,
-                 AST::InstrView Expr) noexcept
+                 const AST::Expression &Expr) noexcept
         : Locals(Locs.begin(), Locs.end()),
           LocalNum(
               std::accumulate(Locals.begin(), Locals.end(), UINT32_C(0),
@@ -131,8 +298,15 @@ private:
                                 return N + Pair.first;
                               })) {
       // FIXME: Modify the capacity to prevent from connection of 2 vectors.
-      Instrs.reserve(Expr.size() + 1);
-      Instrs.assign(Expr.begin(), Expr.end());
+      const auto Body = Expr.getInstrs();
+      Instrs.reserve(Body.size() + 1);
+      Instrs.assign(Body.begin(), Body.end());
+      Immediates = Expr.getImmediates();
+    }
+    WasmFunction(Span<const std::pair<uint32_t, ValType>> Locs,
+                 AST::CodeSegment::LazyBody Body) noexcept
+        : WasmFunction(Locs, AST::Expression()) {
+      Lazy = std::move(Body);
     }
   };
 
@@ -144,6 +318,44 @@ private:
                std::unique_ptr<HostFunctionBase>>
       Data;
   /// @}
+
+  /// \name Data of tiered execution of native wasm function.
+  /// @{
+  mutable std::atomic<uint32_t> Hotness = 0;
+  mutable std::atomic<bool> Tiered = false;
+  mutable Symbol<CompiledFunction> TieredSymbol;
+  mutable Symbol<Executable::Wrapper> TieredWrapper;
+  /// @}
+
+  /// \name Data of basic block costs of native wasm function.
+  /// @{
+  struct BlockCostResolution {
+    uint64_t TableHash = 0;
+    std::vector<BlockCost> Costs;
+  };
+  static inline constexpr size_t kMaxBlockCostResolutions = 4;
+  mutable std::mutex BlockCostMutex;
+  mutable std::array<std::atomic<const BlockCostResolution *>,
+                     kMaxBlockCostResolutions>
+      BlockCosts = {};
+  mutable std::array<std::unique_ptr<BlockCostResolution>,
+                     kMaxBlockCostResolutions>
+      BlockCostResolutions;
+  /// @}
+
+  /// \name Data of register code of native wasm function.
+  /// @{
+  mutable std::mutex RegCodeMutex;
+  mutable std::atomic<bool> RegCodeLowered = false;
+  mutable std::unique_ptr<RegisterCode> RegCode;
+  /// @}
+
+  /// \name Data of lazy loaded body of native wasm function.
+  /// @{
+  mutable std::mutex BodyMutex;
+  mutable std::atomic<bool> BodyLoaded = true;
+  mutable ErrCode BodyError;
+  /// @}
 };
 
 } // namespace Instance
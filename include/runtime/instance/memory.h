@@ -36,10 +36,13 @@ class MemoryInstance {
 public:
   static inline constexpr const uint64_t kPageSize = UINT64_C(65536);
   static inline constexpr const uint64_t k4G = UINT64_C(0x100000000);
+  /// Maximum page count of the 64-bit memories, 2^48 pages for 2^64 bytes.
+  static inline constexpr const uint64_t k64MaxPage = UINT64_C(1) << 48;
   MemoryInstance() = delete;
   MemoryInstance(MemoryInstance &&Inst) noexcept
-      : MemType(Inst.MemType), DataPtr(Inst.DataPtr),
-        PageLimit(Inst.PageLimit) {
+      : MemType(Inst.MemType), DataPtr(Inst.DataPtr), DataSize(Inst.DataSize),
+        ReservedPage(Inst.ReservedPage), PageLimit(Inst.PageLimit),
+        Snap(std::move(Inst.Snap)) {
     Inst.DataPtr = nullptr;
   }
   MemoryInstance(const AST::MemoryType &MType,
@@ -51,20 +54,40 @@ public:
           PageLimit);
       return;
     }
-    DataPtr = Allocator::allocate(MemType.getLimit().getMin());
+    if (is64()) {
+      // The 64-bit memories are not covered by the guard regions. Reserve the
+      // address space up to the maximum pages and check the accesses
+      // explicitly.
+      ReservedPage = PageLimit;
+      if (MemType.getLimit().hasMax()) {
+        ReservedPage = std::min(ReservedPage, MemType.getLimit().getMax());
+      }
+      DataPtr = Allocator::allocate_reserved(MemType.getLimit().getMin(),
+                                             ReservedPage);
+    } else {
+      DataPtr = Allocator::allocate(MemType.getLimit().getMin());
+    }
     if (DataPtr == nullptr) {
       spdlog::error("Unable to find usable memory address");
       return;
     }
+    DataSize = MemType.getLimit().getMin() * kPageSize;
   }
   ~MemoryInstance() noexcept {
-    Allocator::release(DataPtr, MemType.getLimit().getMin());
+    if (is64()) {
+      Allocator::release_reserved(DataPtr, ReservedPage);
+    } else {
+      Allocator::release(DataPtr, MemType.getLimit().getMin());
+    }
   }
 
   bool isShared() const noexcept { return MemType.getLimit().isShared(); }
 
+  /// Check the memory is addressed by i64.
+  bool is64() const noexcept { return MemType.getLimit().is64(); }
+
   /// Get page size of memory.data
-  uint32_t getPageSize() const noexcept {
+  uint64_t getPageSize() const noexcept {
     // The memory page size is binded with the limit in memory type.
     return MemType.getLimit().getMin();
   }
@@ -73,30 +96,30 @@ public:
   const AST::MemoryType &getMemoryType() const noexcept { return MemType; }
 
   /// Check access size is valid.
-  bool checkAccessBound(uint32_t Offset, uint32_t Length) const noexcept {
-    const uint64_t AccessLen =
-        static_cast<uint64_t>(Offset) + static_cast<uint64_t>(Length);
-    return AccessLen <= MemType.getLimit().getMin() * kPageSize;
+  bool checkAccessBound(uint64_t Offset, uint64_t Length) const noexcept {
+    return Offset <= DataSize && Length <= DataSize - Offset;
   }
 
   /// Get boundary index.
-  uint32_t getBoundIdx() const noexcept {
-    return MemType.getLimit().getMin() > 0
-               ? MemType.getLimit().getMin() * kPageSize - 1
-               : 0;
+  uint64_t getBoundIdx() const noexcept {
+    return DataSize > 0 ? DataSize - 1 : 0;
   }
 
+  /// Getter of the pointer to the byte size of the memory, which is read by
+  /// the compiled code for checking the accesses of the 64-bit memories.
+  const uint64_t *getDataSizePtr() const noexcept { return &DataSize; }
+
   /// Grow page
-  bool growPage(const uint32_t Count) {
+  bool growPage(const uint64_t Count) {
     if (Count == 0) {
       return true;
     }
-    // Maximum pages count, 65536
-    uint32_t MaxPageCaped = k4G / kPageSize;
-    uint32_t Min = MemType.getLimit().getMin();
+    // Maximum pages count, 65536 for the 32-bit and 2^48 for the 64-bit.
+    uint64_t MaxPageCaped = is64() ? k64MaxPage : k4G / kPageSize;
+    uint64_t Min = MemType.getLimit().getMin();
     assuming(MaxPageCaped >= Min);
     if (MemType.getLimit().hasMax()) {
-      uint32_t Max = MemType.getLimit().getMax();
+      uint64_t Max = MemType.getLimit().getMax();
       assuming(Max >= Min);
       MaxPageCaped = std::min(Max, MaxPageCaped);
     }
@@ -116,11 +139,54 @@ public:
       DataPtr = NewPtr;
     }
     MemType.getLimit().setMin(Min + Count);
+    DataSize = (Min + Count) * kPageSize;
+    return true;
+  }
+
+  /// Capture the current memory image for resetting later.
+  ///
+  /// Shared memories are rejected, because other threads may still be
+  /// accessing them during the capture and the reset.
+  bool snapshot() noexcept {
+    if (isShared()) {
+      spdlog::error("Memory snapshot failed -- shared memory is not supported");
+      return false;
+    }
+    auto NewSnap = std::make_unique<Allocator::Snapshot>();
+    if (!NewSnap->capture(DataPtr, MemType.getLimit().getMin())) {
+      spdlog::error("Memory snapshot failed -- unable to capture the image");
+      return false;
+    }
+    Snap = std::move(NewSnap);
+    return true;
+  }
+
+  /// Check the memory instance has a captured image.
+  bool hasSnapshot() const noexcept { return Snap != nullptr; }
+
+  /// Reset the memory data and page size to the captured image.
+  bool resetToSnapshot() noexcept {
+    if (isShared()) {
+      spdlog::error("Memory reset failed -- shared memory is not supported");
+      return false;
+    }
+    if (!Snap) {
+      spdlog::error("Memory reset failed -- no snapshot is captured");
+      return false;
+    }
+    auto NewPtr = Snap->restore(DataPtr, MemType.getLimit().getMin());
+    if (NewPtr == nullptr) {
+      spdlog::error("Memory reset failed -- unable to restore the image");
+      return false;
+    }
+    DataPtr = NewPtr;
+    MemType.getLimit().setMin(Snap->getPageCount());
+    DataSize = Snap->getPageCount() * kPageSize;
     return true;
   }
 
   /// Get slice of Data[Offset : Offset + Length - 1]
-  Expect<Span<Byte>> getBytes(uint32_t Offset, uint32_t Length) const noexcept {
+  Expect<Span<Byte>> getBytes(uint64_t Offset, uint64_t Length) const noexcept {
     // Check the memory boundary.
     if (unlikely(!checkAccessBound(Offset, Length))) {
       spdlog::error(ErrCode::Value::MemoryOutOfBounds);
@@ -131,8 +197,8 @@ public:
   }
 
   /// Replace the bytes of Data[Offset :] by Slice[Start : Start + Length - 1]
-  Expect<void> setBytes(Span<const Byte> Slice, uint32_t Offset, uint32_t Start,
-                        uint32_t Length) noexcept {
+  Expect<void> setBytes(Span<const Byte> Slice, uint64_t Offset, uint64_t Start,
+                        uint64_t Length) noexcept {
     // Check the memory boundary.
     if (unlikely(!checkAccessBound(Offset, Length))) {
       spdlog::error(ErrCode::Value::MemoryOutOfBounds);
@@ -141,8 +207,7 @@ public:
     }
 
     // Check the input data validation.
-    if (unlikely(static_cast<uint64_t>(Start) + static_cast<uint64_t>(Length) >
-                 Slice.size())) {
+    if (unlikely(Start > Slice.size() || Length > Slice.size() - Start)) {
       spdlog::error(ErrCode::Value::MemoryOutOfBounds);
       spdlog::error(ErrInfo::InfoBoundary(Offset, Length, getBoundIdx()));
       return Unexpect(ErrCode::Value::MemoryOutOfBounds);
@@ -157,8 +222,8 @@ public:
   }
 
   /// Fill the bytes of Data[Offset : Offset + Length - 1] by Val.
-  Expect<void> fillBytes(uint8_t Val, uint32_t Offset,
-                         uint32_t Length) noexcept {
+  Expect<void> fillBytes(uint8_t Val, uint64_t Offset,
+                         uint64_t Length) noexcept {
     // Check the memory boundary.
     if (unlikely(!checkAccessBound(Offset, Length))) {
       spdlog::error(ErrCode::Value::MemoryOutOfBounds);
@@ -174,7 +239,7 @@ public:
   }
 
   /// Get an uint8 array from Data[Offset : Offset + Length - 1]
-  Expect<void> getArray(uint8_t *Arr, uint32_t Offset, uint32_t Length,
+  Expect<void> getArray(uint8_t *Arr, uint64_t Offset, uint64_t Length,
                         bool IsReverse = false) const noexcept {
     // Check the memory boundary.
     if (unlikely(!checkAccessBound(Offset, Length))) {
@@ -194,7 +259,7 @@ public:
   }
 
   /// Replace Data[Offset : Offset + Length - 1] to an uint8 array
-  Expect<void> setArray(const uint8_t *Arr, uint32_t Offset, uint32_t Length,
+  Expect<void> setArray(const uint8_t *Arr, uint64_t Offset, uint64_t Length,
                         bool IsReverse = false) noexcept {
     // Check the memory boundary.
     if (unlikely(!checkAccessBound(Offset, Length))) {
@@ -216,7 +281,7 @@ public:
   /// Get pointer to specific offset of memory or null.
   template <typename T>
   typename std::enable_if_t<std::is_pointer_v<T>, T>
-  getPointerOrNull(uint32_t Offset) const noexcept {
+  getPointerOrNull(uint64_t Offset) const noexcept {
     if (Offset == 0 ||
         unlikely(!checkAccessBound(Offset, sizeof(std::remove_pointer_t<T>)))) {
       return nullptr;
@@ -227,9 +292,9 @@ public:
   /// Get pointer to specific offset of memory.
   template <typename T>
   typename std::enable_if_t<std::is_pointer_v<T>, T>
-  getPointer(uint32_t Offset) const noexcept {
+  getPointer(uint64_t Offset) const noexcept {
     using Type = std::remove_pointer_t<T>;
-    uint32_t ByteSize = static_cast<uint32_t>(sizeof(Type));
+    uint64_t ByteSize = static_cast<uint64_t>(sizeof(Type));
     if (unlikely(!checkAccessBound(Offset, ByteSize))) {
       return nullptr;
     }
@@ -238,8 +303,8 @@ public:
 
   /// Get array of object at specific offset of memory.
   template <typename T>
-  Span<T> getSpan(uint32_t Offset, uint32_t Size) const noexcept {
-    uint32_t ByteSize = static_cast<uint32_t>(sizeof(T) * Size);
+  Span<T> getSpan(uint64_t Offset, uint32_t Size) const noexcept {
+    uint64_t ByteSize = static_cast<uint64_t>(sizeof(T)) * Size;
     if (unlikely(!checkAccessBound(Offset, ByteSize))) {
       return Span<T>();
     }
@@ -247,7 +312,7 @@ public:
   }
 
   /// Get array of object at specific offset of memory.
-  std::string_view getStringView(uint32_t Offset,
+  std::string_view getStringView(uint64_t Offset,
                                  uint32_t Size) const noexcept {
     if (unlikely(!checkAccessBound(Offset, Size))) {
       return {};
@@ -267,7 +332,7 @@ public:
   /// \returns void when success, ErrCode when failed.
   template <typename T, uint32_t Length = sizeof(T)>
   typename std::enable_if_t<IsWasmNumV<T>, Expect<void>>
-  loadValue(T &Value, uint32_t Offset) const noexcept {
+  loadValue(T &Value, uint64_t Offset) const noexcept {
     // Check the data boundary.
     static_assert(Length <= sizeof(T));
     // Check the memory boundary.
@@ -314,7 +379,7 @@ public:
   /// \returns void when success, ErrCode when failed.
   template <typename T, uint32_t Length = sizeof(T)>
   typename std::enable_if_t<IsWasmNativeNumV<T>, Expect<void>>
-  storeValue(const T &Value, uint32_t Offset) noexcept {
+  storeValue(const T &Value, uint64_t Offset) noexcept {
     // Check the data boundary.
     static_assert(Length <= sizeof(T));
     // Check the memory boundary.
@@ -337,7 +402,12 @@ private:
   /// @{
   AST::MemoryType MemType;
   uint8_t *DataPtr = nullptr;
+  /// Byte size of the memory, kept with the page count in the memory type.
+  uint64_t DataSize = 0;
+  /// Reserved page count of the 64-bit memories.
+  uint64_t ReservedPage = 0;
   const uint32_t PageLimit;
+  std::unique_ptr<Allocator::Snapshot> Snap;
   /// @}
 };
 
@@ -26,6 +26,7 @@
 #include "runtime/instance/table.h"
 #include "runtime/instance/tag.h"
 
+#include <array>
 #include <atomic>
 #include <functional>
 #include <map>
@@ -41,7 +42,9 @@ namespace WasmEdge {
 
 namespace Executor {
 class Executor;
-}
+class Collector;
+class GCHeap;
+} // namespace Executor
 
 namespace Runtime {
 
@@ -73,6 +76,11 @@ public:
                  std::function<void(void *)> Finalizer = nullptr)
       : ModName(Name), HostData(Data), HostDataFinalizer(Finalizer) {}
   virtual ~ModuleInstance() noexcept {
+    // When destroying this module instance, unlink from the collector, which
+    // releases the GC heap of this module instance.
+    if (UnlinkCollector) {
+      UnlinkCollector(this);
+    }
     // When destroying this module instance, call the callbacks to unlink to the
     // store managers.
     for (auto &&Pair : LinkedStore) {
@@ -200,6 +208,15 @@ public:
     return std::forward<CallbackT>(CallBack)(ExpGlobals);
   }
 
+  /// Get the function instances list in the index space, which starts with
+  /// the imported functions.
+  template <typename CallbackT>
+  auto getFuncInstances(CallbackT &&CallBack) const noexcept {
+    std::shared_lock Lock(Mutex);
+    return std::forward<CallbackT>(CallBack)(
+        Span<FunctionInstance *const>(FuncInsts));
+  }
+
 protected:
   friend class Executor::Executor;
   friend class Runtime::CallingFrame;
@@ -241,18 +258,6 @@ protected:
     std::unique_lock Lock(Mutex);
     unsafeAddInstance(OwnedDataInsts, DataInsts, std::forward<Args>(Values)...);
   }
-  template <typename... Args> ArrayInstance *newArray(Args &&...Values) {
-    std::unique_lock Lock(Mutex);
-    OwnedArrayInsts.push_back(
-        std::make_unique<ArrayInstance>(this, std::forward<Args>(Values)...));
-    return OwnedArrayInsts.back().get();
-  }
-  template <typename... Args> StructInstance *newStruct(Args &&...Values) {
-    std::unique_lock Lock(Mutex);
-    OwnedStructInsts.push_back(
-        std::make_unique<StructInstance>(this, std::forward<Args>(Values)...));
-    return OwnedStructInsts.back().get();
-  }
 
   /// Import instances into this module instance.
   void importFunction(FunctionInstance *Func) {
@@ -464,7 +469,12 @@ protected:
   /// \name Data for compiled functions.
   /// @{
   std::vector<uint8_t *> MemoryPtrs;
+  std::vector<const uint64_t *> MemorySizePtrs;
   std::vector<ValVariant *> GlobalPtrs;
+  /// Native entries and the host functions of the imported functions, which
+  /// the import stubs call directly. Null if the import is not a host function
+  /// with a native entry.
+  std::vector<std::array<void *, 2>> HostFuncPtrs;
   /// @}
 
   friend class Runtime::StoreManager;
@@ -483,6 +493,9 @@ protected:
     LinkedStore.erase(Store);
   }
 
+  friend class Executor::Collector;
+  using UnlinkCollectorCallback = void(const ModuleInstance *Mod) noexcept;
+
   /// Mutex.
   mutable std::shared_mutex Mutex;
 
@@ -501,8 +514,6 @@ protected:
   std::vector<std::unique_ptr<GlobalInstance>> OwnedGlobInsts;
   std::vector<std::unique_ptr<ElementInstance>> OwnedElemInsts;
   std::vector<std::unique_ptr<DataInstance>> OwnedDataInsts;
-  std::vector<std::unique_ptr<ArrayInstance>> OwnedArrayInsts;
-  std::vector<std::unique_ptr<StructInstance>> OwnedStructInsts;
 
   /// Imported and added instances in this module.
   std::vector<FunctionInstance *> FuncInsts;
@@ -530,6 +541,11 @@ protected:
   std::map<StoreManager *, std::function<BeforeModuleDestroyCallback>>
       LinkedStore;
 
+  /// GC heap of the struct and array instances, owned by the collector.
+  std::atomic<Executor::GCHeap *> Heap = nullptr;
+  /// Unlink callback of the collector, set when linked to the collector.
+  UnlinkCollectorCallback *UnlinkCollector = nullptr;
+
   /// External data and its finalizer function pointer.
   void *HostData;
   std::function<void(void *)> HostDataFinalizer;
@@ -18,30 +18,69 @@
 #include "common/types.h"
 #include "runtime/instance/composite.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
 #include <vector>
 
 namespace WasmEdge {
 namespace Runtime {
 namespace Instance {
 
-class StructInstance : public CompositeBase {
+/// Struct instance in the GC heap. The fields follow the header at the
+/// offsets of the layout.
+class StructInstance : public GCObject {
 public:
   StructInstance() = delete;
+  /// The fields are initialized with the default values.
   StructInstance(const ModuleInstance *Mod, const uint32_t Idx,
-                 std::vector<ValVariant> &&Init) noexcept
-      : CompositeBase(Mod, Idx), Data(std::move(Init)) {
-    assuming(ModInst);
+                 const GCLayout &L) noexcept
+      : GCObject(Mod, Idx, L) {
+    assuming(ModInst && !L.IsArray);
+    std::memcpy(reinterpret_cast<uint8_t *>(this) + sizeof(StructInstance),
+                L.Defaults.data(), L.Defaults.size());
   }
 
-  /// Get field data in struct instance.
-  ValVariant &getField(uint32_t Idx) noexcept { return Data[Idx]; }
-  const ValVariant &getField(uint32_t Idx) const noexcept { return Data[Idx]; }
+  /// Place the fields of the storage types after the header, and return the
+  /// size of the struct instance. The fields are placed in the descending
+  /// order of the sizes, which leaves no padding between them. The compiled
+  /// code accesses the fields at the same offsets.
+  static uint32_t placeFields(Span<const ValType> Types,
+                              std::vector<uint32_t> &Offsets) noexcept {
+    const auto N = static_cast<uint32_t>(Types.size());
+    std::vector<uint32_t> Order(N);
+    std::iota(Order.begin(), Order.end(), 0U);
+    std::stable_sort(Order.begin(), Order.end(), [&](uint32_t A, uint32_t B) {
+      return getStorageSize(Types[A]) > getStorageSize(Types[B]);
+    });
+    uint64_t Offset = sizeof(StructInstance);
+    Offsets.resize(N);
+    for (const uint32_t I : Order) {
+      const uint32_t Size = getStorageSize(Types[I]);
+      const uint64_t Align = std::min(Size, 8U);
+      Offset = (Offset + Align - 1) & ~(Align - 1);
+      Offsets[I] = static_cast<uint32_t>(Offset);
+      Offset += Size;
+    }
+    return static_cast<uint32_t>((Offset + 7) & ~UINT64_C(7));
+  }
+
+  /// Size of the struct instance.
+  uint64_t getObjectSize() const noexcept { return Layout->Size; }
 
-private:
-  /// \name Data of struct instance.
-  /// @{
-  std::vector<ValVariant> Data;
-  /// @}
+  /// Get field data in struct instance. The packed values are extended.
+  ValVariant getField(uint32_t Idx, bool IsSigned = false) const noexcept {
+    return loadValue(reinterpret_cast<const uint8_t *>(this) +
+                         Layout->Offsets[Idx],
+                     Layout->Types[Idx], IsSigned);
+  }
+
+  /// Set field data in struct instance. The packed values are wrapped.
+  void setField(uint32_t Idx, const ValVariant &Val) noexcept {
+    storeValue(reinterpret_cast<uint8_t *>(this) + Layout->Offsets[Idx],
+               getStorageSize(Layout->Types[Idx]), Val);
+  }
 };
 
 } // namespace Instance
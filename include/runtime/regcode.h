@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/runtime/regcode.h - Register code definition -------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the definition of the register code, which is lowered
+/// from the validated instructions of the native wasm functions and run by the
+/// interpreter instead of the stack machine.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/types.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace WasmEdge {
+namespace Runtime {
+
+/// Register code of a native wasm function. The operands of the instructions
+/// are the slots of the frame, counted from the first local: the locals, the
+/// operand stack resolved to the fixed heights, and the constants copied in
+/// at the function entry.
+struct RegisterCode {
+  struct Instruction {
+    /// The register opcode, defined by the executor.
+    uint16_t Op;
+    /// The branch to a loop start, which checks the interruption.
+    bool BackEdge;
+    /// Index of the lowered instruction, for the trap information and the
+    /// memory arguments.
+    uint32_t Origin;
+    /// The destination slot or the branch target, and the source slots.
+    uint32_t A;
+    uint32_t B;
+    uint32_t C;
+    uint32_t D;
+  };
+
+  /// The instructions.
+  std::vector<Instruction> Instrs;
+  /// The branch targets of the br_table instructions.
+  std::vector<uint32_t> Tables;
+  /// The constants, copied to the slots from `ConstBase` at the entry.
+  std::vector<ValVariant> Consts;
+  uint32_t ConstBase = 0;
+};
+
+static_assert(sizeof(RegisterCode::Instruction) == 24,
+              "Register code instruction should be 24 bytes");
+
+} // namespace Runtime
+} // namespace WasmEdge
@@ -15,8 +15,13 @@
 
 #include "ast/instruction.h"
 #include "runtime/instance/module.h"
+#include "system/allocator.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <new>
 #include <optional>
+#include <type_traits>
 #include <vector>
 
 namespace WasmEdge {
@@ -37,143 +42,190 @@ public:
 
   struct Frame {
     Frame() = delete;
-    Frame(const Instance::ModuleInstance *Mod, AST::InstrView::iterator FromIt,
-          uint32_t L, uint32_t A, uint32_t V) noexcept
-        : Module(Mod), From(FromIt), Locals(L), Arity(A), VPos(V) {}
+    Frame(const Instance::ModuleInstance *Mod,
+          const Instance::FunctionInstance *Func,
+          AST::InstrView::iterator FromIt, uint32_t L, uint32_t A, uint32_t V,
+          uint32_t H) noexcept
+        : Module(Mod), Function(Func), From(FromIt), Locals(L), Arity(A),
+          VPos(V), HPos(H) {}
     const Instance::ModuleInstance *Module;
+    const Instance::FunctionInstance *Function;
     AST::InstrView::iterator From;
     uint32_t Locals;
     uint32_t Arity;
     uint32_t VPos;
-    std::vector<Handler> HandlerStack;
+    /// Handler stack size at the frame entry. The handlers above it belong to
+    /// this frame.
+    uint32_t HPos;
   };
 
   /// Stack manager provides the stack control for Wasm execution with VALIDATED
   /// modules. All operations of instructions passed validation, therefore no
   /// unexpect operations will occur.
-  StackManager() noexcept {
-    ValueStack.reserve(2048U);
-    FrameStack.reserve(16U);
+  ///
+  /// The frames, the handlers, and the values are kept in a single region of
+  /// Size bytes, which is never reallocated. The value stack is at the end of
+  /// the region followed by a guard page. The callers check the capacity by
+  /// `hasCapacity` before pushing the frames and the locals, and the values
+  /// pushed by the instructions are bounded by the validated stack height of
+  /// the functions.
+  explicit StackManager(uint64_t Size) noexcept {
+    static_assert(std::is_trivially_copyable_v<Value>);
+    static_assert(std::is_trivially_destructible_v<Frame>);
+    static_assert(std::is_trivially_destructible_v<Handler>);
+    // The frame and the handler areas take 1/8 and 1/16 of the region.
+    RegionSize = std::max((Size + kGranule - 1) / kGranule, UINT64_C(1)) *
+                 kGranule;
+    Region = Allocator::allocate_stack(RegionSize);
+    if (unlikely(Region == nullptr)) {
+      return;
+    }
+    const uint64_t FrameNum = RegionSize / 8 / sizeof(Frame);
+    const uint64_t HandlerNum = RegionSize / 16 / sizeof(Handler);
+    const uint64_t HandlerOff = alignUp(FrameNum * sizeof(Frame));
+    const uint64_t ValueOff = alignUp(HandlerOff + HandlerNum * sizeof(Handler));
+    FrameBase = FrameTop = reinterpret_cast<Frame *>(Region);
+    FrameLimit = FrameBase + FrameNum;
+    HandlerBase = HandlerTop = reinterpret_cast<Handler *>(Region + HandlerOff);
+    HandlerLimit = HandlerBase + HandlerNum;
+    ValueBase = ValueTop = reinterpret_cast<Value *>(Region + ValueOff);
+    ValueLimit = ValueBase + (RegionSize - ValueOff) / sizeof(Value);
+  }
+  ~StackManager() noexcept {
+    if (Region != nullptr) {
+      Allocator::release_stack(Region, RegionSize);
+    }
   }
-  ~StackManager() = default;
+  StackManager(const StackManager &) = delete;
+  StackManager &operator=(const StackManager &) = delete;
 
   /// Getter of stack size.
-  size_t size() const noexcept { return ValueStack.size(); }
+  size_t size() const noexcept {
+    return static_cast<size_t>(ValueTop - ValueBase);
+  }
+
+  /// Check the room of FrameNum frames and ValNum values above the stack top.
+  bool hasCapacity(uint64_t ValNum, uint32_t FrameNum = 1) const noexcept {
+    return FrameNum <= static_cast<uint64_t>(FrameLimit - FrameTop) &&
+           ValNum <= static_cast<uint64_t>(ValueLimit - ValueTop);
+  }
 
   /// Unsafe getter of top entry of stack.
-  Value &getTop() { return ValueStack.back(); }
+  Value &getTop() { return ValueTop[-1]; }
 
   /// Unsafe getter of top N-th value entry of stack.
   Value &getTopN(uint32_t Offset) noexcept {
-    assuming(0 < Offset && Offset <= ValueStack.size());
-    return ValueStack[ValueStack.size() - Offset];
+    assuming(0 < Offset && Offset <= size());
+    return *(ValueTop - Offset);
   }
 
   /// Unsafe getter of top N value entries of stack.
-  Span<Value> getTopSpan(uint32_t N) {
-    return Span<Value>(ValueStack.end() - N, N);
+  Span<Value> getTopSpan(uint32_t N) { return Span<Value>(ValueTop - N, N); }
+
+  /// Getter of all value entries of stack.
+  Span<const Value> getValues() const noexcept {
+    return Span<const Value>(ValueBase, size());
   }
 
   /// Push a new value entry to stack.
   template <typename T> void push(T &&Val) {
-    ValueStack.push_back(std::forward<T>(Val));
+    assuming(ValueTop != ValueLimit);
+    *ValueTop++ = Value(std::forward<T>(Val));
   }
 
   /// Push a vector of value to stack
   void pushValVec(const std::vector<Value> &ValVec) {
-    ValueStack.insert(ValueStack.end(), ValVec.begin(), ValVec.end());
+    assuming(ValVec.size() <= static_cast<size_t>(ValueLimit - ValueTop));
+    ValueTop = std::copy(ValVec.begin(), ValVec.end(), ValueTop);
   }
 
   /// Unsafe pop and return the top entry.
-  Value pop() {
-    Value V = std::move(ValueStack.back());
-    ValueStack.pop_back();
-    return V;
-  }
+  Value pop() { return *--ValueTop; }
 
   /// Unsafe pop and return the top N entries.
   std::vector<Value> pop(uint32_t N) {
-    std::vector<Value> Vec;
-    Vec.reserve(N);
-    std::move(ValueStack.end() - N, ValueStack.end(), std::back_inserter(Vec));
-    ValueStack.erase(ValueStack.end() - N, ValueStack.end());
+    std::vector<Value> Vec(ValueTop - N, ValueTop);
+    ValueTop -= N;
     return Vec;
   }
 
   /// Push a new frame entry to stack.
   void pushFrame(const Instance::ModuleInstance *Module,
                  AST::InstrView::iterator From, uint32_t LocalNum = 0,
-                 uint32_t Arity = 0, bool IsTailCall = false) noexcept {
+                 uint32_t Arity = 0, bool IsTailCall = false,
+                 const Instance::FunctionInstance *Function = nullptr) noexcept {
     if (!IsTailCall) {
-      FrameStack.emplace_back(Module, From, LocalNum, Arity,
-                              static_cast<uint32_t>(ValueStack.size()));
+      assuming(FrameTop != FrameLimit);
+      new (FrameTop++)
+          Frame(Module, Function, From, LocalNum, Arity,
+                static_cast<uint32_t>(size()),
+                static_cast<uint32_t>(HandlerTop - HandlerBase));
     } else {
-      assuming(!FrameStack.empty());
-      assuming(FrameStack.back().VPos >= FrameStack.back().Locals);
-      assuming(FrameStack.back().VPos - FrameStack.back().Locals <=
-               ValueStack.size() - LocalNum);
-      ValueStack.erase(ValueStack.begin() + FrameStack.back().VPos -
-                           FrameStack.back().Locals,
-                       ValueStack.end() - LocalNum);
-      FrameStack.back().Module = Module;
-      FrameStack.back().Locals = LocalNum;
-      FrameStack.back().Arity = Arity;
-      FrameStack.back().VPos = static_cast<uint32_t>(ValueStack.size());
-      FrameStack.back().HandlerStack.clear();
+      assuming(FrameTop != FrameBase);
+      auto &Top = FrameTop[-1];
+      assuming(Top.VPos >= Top.Locals);
+      assuming(Top.VPos - Top.Locals <= size() - LocalNum);
+      erase(ValueBase + Top.VPos - Top.Locals, ValueTop - LocalNum);
+      Top.Module = Module;
+      Top.Function = Function;
+      Top.Locals = LocalNum;
+      Top.Arity = Arity;
+      Top.VPos = static_cast<uint32_t>(size());
+      HandlerTop = HandlerBase + Top.HPos;
     }
   }
 
   /// Unsafe pop top frame.
   AST::InstrView::iterator popFrame() noexcept {
-    assuming(!FrameStack.empty());
-    assuming(FrameStack.back().VPos >= FrameStack.back().Locals);
-    assuming(FrameStack.back().VPos - FrameStack.back().Locals <=
-             ValueStack.size() - FrameStack.back().Arity);
-    ValueStack.erase(ValueStack.begin() + FrameStack.back().VPos -
-                         FrameStack.back().Locals,
-                     ValueStack.end() - FrameStack.back().Arity);
-    auto From = FrameStack.back().From;
-    FrameStack.pop_back();
-    return From;
-  }
-
-  /// Push handler for try-catch block.
-  void
+    assuming(FrameTop != FrameBase);
+    auto &Top = FrameTop[-1];
+    assuming(Top.VPos >= Top.Locals);
+    assuming(Top.VPos - Top.Locals <= size() - Top.Arity);
+    erase(ValueBase + Top.VPos - Top.Locals, ValueTop - Top.Arity);
+    HandlerTop = HandlerBase + Top.HPos;
+    --FrameTop;
+    return Top.From;
+  }
+
+  /// Push handler for try-catch block. Return false if the handler stack is
+  /// exhausted.
+  bool
   pushHandler(AST::InstrView::iterator TryIt, uint32_t BlockParamNum,
               Span<const AST::Instruction::CatchDescriptor> Catch) noexcept {
-    assuming(!FrameStack.empty());
-    FrameStack.back().HandlerStack.emplace_back(
-        TryIt, static_cast<uint32_t>(ValueStack.size()) - BlockParamNum, Catch);
+    assuming(FrameTop != FrameBase);
+    if (unlikely(HandlerTop == HandlerLimit)) {
+      return false;
+    }
+    new (HandlerTop++) Handler(
+        TryIt, static_cast<uint32_t>(size()) - BlockParamNum, Catch);
+    return true;
   }
 
   /// Pop the top handler on the stack.
   std::optional<Handler> popTopHandler(uint32_t AssocValSize) noexcept {
-    while (!FrameStack.empty()) {
-      auto &Frame = FrameStack.back();
-      if (!Frame.HandlerStack.empty()) {
-        auto TopHandler = std::move(Frame.HandlerStack.back());
-        Frame.HandlerStack.pop_back();
-        assuming(TopHandler.VPos <= ValueStack.size() - AssocValSize);
-        ValueStack.erase(ValueStack.begin() + TopHandler.VPos,
-                         ValueStack.end() - AssocValSize);
+    while (FrameTop != FrameBase) {
+      if (HandlerTop - HandlerBase > FrameTop[-1].HPos) {
+        Handler TopHandler = *--HandlerTop;
+        assuming(TopHandler.VPos <= size() - AssocValSize);
+        erase(ValueBase + TopHandler.VPos, ValueTop - AssocValSize);
         return TopHandler;
       }
-      FrameStack.pop_back();
+      --FrameTop;
     }
     return std::nullopt;
   }
 
   /// Unsafe remove inactive handler.
   void removeInactiveHandler(AST::InstrView::iterator PC) noexcept {
-    assuming(!FrameStack.empty());
+    assuming(FrameTop != FrameBase);
     // First pop the inactive handlers. Br instructions may cause the handlers
     // in current frame becomes inactive.
-    auto &HandlerStack = FrameStack.back().HandlerStack;
-    while (!HandlerStack.empty()) {
-      auto &Handler = HandlerStack.back();
+    Handler *const Bottom = HandlerBase + FrameTop[-1].HPos;
+    while (HandlerTop != Bottom) {
+      auto &Handler = HandlerTop[-1];
       if (PC < Handler.Try ||
           PC > Handler.Try + Handler.Try->getTryCatch().JumpEnd) {
-        HandlerStack.pop_back();
+        --HandlerTop;
       } else {
         break;
       }
@@ -182,41 +234,85 @@ public:
 
   /// Unsafe erase value stack.
   void eraseValueStack(uint32_t EraseBegin, uint32_t EraseEnd) noexcept {
-    assuming(EraseEnd <= EraseBegin && EraseBegin <= ValueStack.size());
-    ValueStack.erase(ValueStack.end() - EraseBegin,
-                     ValueStack.end() - EraseEnd);
+    assuming(EraseEnd <= EraseBegin && EraseBegin <= size());
+    erase(ValueTop - EraseBegin, ValueTop - EraseEnd);
   }
 
   /// Unsafe leave top label.
   AST::InstrView::iterator
   maybePopFrameOrHandler(AST::InstrView::iterator PC) noexcept {
-    if (FrameStack.size() > 1 && PC->isExprLast()) {
+    if (FrameTop - FrameBase > 1 && PC->isExprLast()) {
       // Noted that there's always a base frame in stack.
       return popFrame();
     }
     if (PC->isTryBlockLast()) {
-      FrameStack.back().HandlerStack.pop_back();
+      --HandlerTop;
     }
     return PC;
   }
 
   /// Unsafe getter of module address.
   const Instance::ModuleInstance *getModule() const noexcept {
-    assuming(!FrameStack.empty());
-    return FrameStack.back().Module;
+    assuming(FrameTop != FrameBase);
+    return FrameTop[-1].Module;
+  }
+
+  /// Unsafe getter of the native function of the top frame. nullptr if the
+  /// top frame is not of a native wasm function.
+  const Instance::FunctionInstance *getFunction() const noexcept {
+    assuming(FrameTop != FrameBase);
+    return FrameTop[-1].Function;
+  }
+
+  /// Unsafe getter of the first local of the top frame. The register code
+  /// addresses the slots of the frame from here.
+  Value *getFrameBase() noexcept {
+    assuming(FrameTop != FrameBase);
+    return ValueBase + FrameTop[-1].VPos - FrameTop[-1].Locals;
+  }
+
+  /// Unsafe setter of the number of the values above the locals of the top
+  /// frame, which the register code keeps in the slots.
+  void setFrameValueNum(uint32_t N) noexcept {
+    assuming(FrameTop != FrameBase);
+    assuming(N <= static_cast<uint64_t>(ValueLimit - ValueBase) -
+                      FrameTop[-1].VPos);
+    ValueTop = ValueBase + FrameTop[-1].VPos + N;
   }
 
   /// Reset stack.
   void reset() noexcept {
-    ValueStack.clear();
-    FrameStack.clear();
+    ValueTop = ValueBase;
+    FrameTop = FrameBase;
+    HandlerTop = HandlerBase;
   }
 
 private:
+  /// Granularity of the region size.
+  static inline constexpr const uint64_t kGranule = UINT64_C(65536);
+
+  static uint64_t alignUp(uint64_t Offset) noexcept {
+    return (Offset + alignof(Value) - 1) / alignof(Value) * alignof(Value);
+  }
+
+  /// Remove the values in [First, Last) and move down the values above.
+  void erase(Value *First, Value *Last) noexcept {
+    ValueTop = std::copy(Last, ValueTop, First);
+  }
+
   /// \name Data of stack manager.
   /// @{
-  std::vector<Value> ValueStack;
-  std::vector<Frame> FrameStack;
+  uint8_t *Region = nullptr;
+  uint64_t RegionSize = 0;
+  Frame *FrameBase = nullptr;
+  Frame *FrameTop = nullptr;
+  Frame *FrameLimit = nullptr;
+  Handler *HandlerBase = nullptr;
+  Handler *HandlerTop = nullptr;
+  Handler *HandlerLimit = nullptr;
+  Value *ValueBase = nullptr;
+  Value *ValueTop = nullptr;
+  Value *ValueLimit = nullptr;
   /// @}
 };
 
@@ -15,6 +15,7 @@
 
 #include "common/defines.h"
 #include <cstdint>
+#include <vector>
 
 #if WASMEDGE_OS_WINDOWS
 #define WASMEDGE_EXPORT __declspec(dllexport)
@@ -29,11 +30,40 @@ public:
   WASMEDGE_EXPORT static uint8_t *allocate(uint32_t PageCount) noexcept;
 
   WASMEDGE_EXPORT static uint8_t *resize(uint8_t *Pointer,
-                                         uint32_t OldPageCount,
-                                         uint32_t NewPageCount) noexcept;
+                                         uint64_t OldPageCount,
+                                         uint64_t NewPageCount) noexcept;
 
   WASMEDGE_EXPORT static void release(uint8_t *Pointer,
-                                      uint32_t PageCount) noexcept;
+                                      uint64_t PageCount) noexcept;
+
+  /// Allocate PageCount pages in a reservation of ReservedPageCount pages
+  /// without the guard regions, for the memories whose accesses are checked
+  /// explicitly. The memory is grown by `resize` in the reservation and
+  /// released by `release_reserved`.
+  WASMEDGE_EXPORT static uint8_t *
+  allocate_reserved(uint64_t PageCount, uint64_t ReservedPageCount) noexcept;
+
+  WASMEDGE_EXPORT static void
+  release_reserved(uint8_t *Pointer, uint64_t ReservedPageCount) noexcept;
+
+  /// Pre-reserve SlotCount guard-paged slots for the linear memories.
+  ///
+  /// The pool is shared in the process and reserved at most once: only the
+  /// first call maps the slots, and the later calls check its result without
+  /// locking, and fail if the pool has fewer slots than SlotCount. After
+  /// reserved, `allocate` takes the free slots first and falls back to the
+  /// individual reservation when the pool is exhausted, and `release` returns
+  /// the slots to the pool by discarding the pages instead of unmapping the
+  /// whole reservation. The slots keep their mappings, and their pages are
+  /// only protected and unprotected. Returns false if the pool is not
+  /// supported on this platform or failed to reserve.
+  WASMEDGE_EXPORT static bool reservePool(uint32_t SlotCount) noexcept;
+
+  /// Generation of the linear memory pages, increased whenever the pages of
+  /// a linear memory are released or replaced, such as by `release` and
+  /// `Snapshot::restore`. The users pinning the pages of a memory, such as
+  /// the fixed buffers of io_uring, should pin them again when it changes.
+  WASMEDGE_EXPORT static uint64_t getMappingGeneration() noexcept;
 
   static uint8_t *allocate_chunk(uint64_t Size) noexcept;
   static void release_chunk(uint8_t *Pointer, uint64_t Size) noexcept;
@@ -41,6 +71,45 @@ public:
   static bool set_chunk_readable(uint8_t *Pointer, uint64_t Size) noexcept;
   static bool set_chunk_readable_writable(uint8_t *Pointer,
                                           uint64_t Size) noexcept;
+
+  /// Allocate a stack of Size bytes, which is a multiple of the wasm page
+  /// size, followed by an inaccessible guard region. The stack released last
+  /// in the thread is reused by the next allocation of the same size.
+  WASMEDGE_EXPORT static uint8_t *allocate_stack(uint64_t Size) noexcept;
+  WASMEDGE_EXPORT static void release_stack(uint8_t *Pointer,
+                                            uint64_t Size) noexcept;
+
+  /// Captured image of a linear memory for fast reset.
+  ///
+  /// On Linux, the image is kept in a memfd and restored by remapping it with
+  /// `MAP_PRIVATE` over the linear memory, so the reset only discards the
+  /// pages dirtied since the capture. Other platforms keep a copy of the
+  /// image.
+  class Snapshot {
+  public:
+    Snapshot() noexcept = default;
+    Snapshot(const Snapshot &) = delete;
+    Snapshot &operator=(const Snapshot &) = delete;
+    WASMEDGE_EXPORT ~Snapshot() noexcept;
+
+    /// Capture PageCount pages starting from Pointer.
+    WASMEDGE_EXPORT bool capture(const uint8_t *Pointer,
+                                 uint64_t PageCount) noexcept;
+
+    /// Restore the captured image to the memory allocated by `allocate` which
+    /// currently has PageCount pages. The pages grown after the capture are
+    /// released. Returns the new memory pointer, or nullptr if failed.
+    WASMEDGE_EXPORT uint8_t *restore(uint8_t *Pointer,
+                                     uint64_t PageCount) const noexcept;
+
+    /// Getter of the captured page count.
+    uint64_t getPageCount() const noexcept { return PageCount; }
+
+  private:
+    uint64_t PageCount = 0;
+    int Fd = -1;
+    std::vector<uint8_t> Image;
+  };
 };
 
 } // namespace WasmEdge
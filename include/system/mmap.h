@@ -16,6 +16,8 @@
 
 #include "common/filesystem.h"
 
+#include <cstdint>
+
 namespace WasmEdge {
 
 class MMap {
@@ -23,8 +25,21 @@ public:
   MMap(const std::filesystem::path &Path) noexcept;
   ~MMap() noexcept;
   void *address() const noexcept;
+  /// Getter of the size of the mapped file. 0 if not mapped.
+  uint64_t size() const noexcept;
   static bool supported() noexcept;
 
+  /// Map Size bytes of the file from Offset over the fixed Address as a
+  /// private copy-on-write mapping, so the unmodified pages are shared with
+  /// the page cache. The Address, the Offset, and the Size must be multiples
+  /// of the page size. Returns false if failed or not supported on this
+  /// platform.
+  bool mapPrivate(void *Address, uint64_t Offset, uint64_t Size,
+                  bool Executable) const noexcept;
+
+  /// Getter of the page size of the private mappings. 0 if not supported.
+  static uint64_t pageSize() noexcept;
+
 private:
   void *Handle;
 };
@@ -0,0 +1,130 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/system/parkinglot.h - Address-keyed parking lot ----------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the parking lot, which parks the threads on the keys of
+/// addresses and unparks them by the keys, for various operating system.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/defines.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+
+#if !WASMEDGE_OS_LINUX
+#include <condition_variable>
+#endif
+
+namespace WasmEdge {
+
+/// Parking lot of the threads waiting on the addresses. The waiting queues
+/// are sharded by the hashes of the keys, and each shard has its own lock.
+/// The parked threads sleep on the futexes on Linux, and on the condition
+/// variables of the shards otherwise.
+class ParkingLot {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  enum class ParkResult : uint8_t {
+    /// Unparked by unpark() or unparkAll().
+    Unparked,
+    /// Not parked because the validation failed.
+    Invalid,
+    /// Timed out before unparked.
+    TimedOut,
+  };
+
+  ParkingLot() noexcept = default;
+  ParkingLot(const ParkingLot &) = delete;
+  ParkingLot &operator=(const ParkingLot &) = delete;
+
+  /// Park the thread on the key until it is unparked or the time is reached.
+  /// Validate is called under the lock of the shard before the parking, and
+  /// the thread is not parked if it returns false. The unparking of the key
+  /// after the changes checked by Validate is never lost.
+  template <typename ValidateT>
+  ParkResult park(const void *Key, ValidateT &&Validate,
+                  std::optional<Clock::time_point> Until) noexcept {
+    Bucket &B = getBucket(Key);
+    Waiter W(Key);
+    {
+      std::unique_lock<std::mutex> Lock(B.Mutex);
+      if (!Validate()) {
+        return ParkResult::Invalid;
+      }
+      B.enqueue(W);
+    }
+    return wait(B, W, Until);
+  }
+
+  /// Unpark at most Count threads parked on the key in the parking order, and
+  /// return the count of the unparked threads.
+  uint32_t unpark(const void *Key, uint32_t Count) noexcept;
+
+  /// Unpark all the parked threads.
+  void unparkAll() noexcept;
+
+private:
+  struct Waiter {
+    Waiter(const void *K) noexcept : Key(K) {}
+    const void *Key;
+    Waiter *Prev = nullptr;
+    Waiter *Next = nullptr;
+#if WASMEDGE_OS_LINUX
+    /// Futex word, set to 1 when unparked.
+    std::atomic<uint32_t> Word = 0;
+#else
+    bool Unparked = false;
+    std::condition_variable Cond;
+#endif
+  };
+
+  struct alignas(64) Bucket {
+    std::mutex Mutex;
+    Waiter *Head = nullptr;
+    Waiter *Tail = nullptr;
+
+    void enqueue(Waiter &W) noexcept {
+      W.Prev = Tail;
+      W.Next = nullptr;
+      (Tail ? Tail->Next : Head) = &W;
+      Tail = &W;
+    }
+    void dequeue(Waiter &W) noexcept {
+      (W.Prev ? W.Prev->Next : Head) = W.Next;
+      (W.Next ? W.Next->Prev : Tail) = W.Prev;
+      W.Prev = W.Next = nullptr;
+    }
+  };
+
+  static inline constexpr const uint32_t kBucketBits = 6;
+
+  Bucket &getBucket(const void *Key) noexcept {
+    // Fibonacci hashing of the address.
+    const auto Hash = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(Key)) *
+                      UINT64_C(0x9E3779B97F4A7C15);
+    return Buckets[Hash >> (64 - kBucketBits)];
+  }
+
+  /// Wait for the unparking of the enqueued waiter.
+  ParkResult wait(Bucket &B, Waiter &W,
+                  std::optional<Clock::time_point> Until) noexcept;
+  /// Wake the dequeued waiter with the lock of the bucket held.
+  static void wake(Waiter &W) noexcept;
+
+  std::array<Bucket, 1U << kBucketBits> Buckets;
+};
+
+} // namespace WasmEdge
@@ -0,0 +1,127 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/system/threadpool.h - Work-stealing thread pool ----------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the thread pool with the work-stealing queues, which
+/// runs the asynchronous invocations.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace WasmEdge {
+
+/// Thread pool with a task queue per worker. The submitted tasks are spread
+/// over the queues, and the idle workers steal the tasks from the queues of
+/// the others. The queued tasks are run before the pool is destroyed.
+class ThreadPool {
+public:
+  using Task = std::packaged_task<void()>;
+
+  ThreadPool(uint32_t Threads);
+  ~ThreadPool() noexcept;
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /// Submit the task.
+  void submit(Task &&T);
+
+  /// Submit the tasks at once.
+  void submit(std::vector<Task> &&Tasks);
+
+  /// Stop the workers after the queued tasks are done. Until then, the
+  /// Interrupt function is called every millisecond to stop the running
+  /// tasks.
+  void stop(const std::function<void()> &Interrupt) noexcept;
+
+  /// Run one of the queued tasks if the current thread is a worker of a
+  /// thread pool. Returns false if not a worker or nothing is queued. The
+  /// tasks waiting for the others call this to run them in place, so they do
+  /// not deadlock when all the workers are waiting.
+  static bool runQueuedTask() noexcept;
+
+  /// Getter of the worker count.
+  uint32_t getThreadCount() const noexcept {
+    return static_cast<uint32_t>(Workers.size());
+  }
+
+private:
+  struct alignas(64) Queue {
+    std::mutex Mutex;
+    std::deque<Task> Tasks;
+  };
+
+  /// Run the tasks on the worker thread.
+  void work(uint32_t Index) noexcept;
+  /// Take a task from the queue of the worker or steal one from the others.
+  std::optional<Task> take(uint32_t Index) noexcept;
+  /// Run the taken task and count it as done.
+  void run(Task &T) noexcept;
+
+  /// The pool and the queue index of the current worker thread.
+  static thread_local ThreadPool *CurrentPool;
+  static thread_local uint32_t CurrentIndex;
+
+  std::vector<Queue> Queues;
+  std::vector<std::thread> Workers;
+  /// Index of the queue for the next submission.
+  std::atomic<uint32_t> Next = 0;
+  /// Count of the queued tasks. It is negative for a moment if a task is
+  /// taken before it is counted.
+  std::atomic<int64_t> Pending = 0;
+  std::mutex SleepMutex;
+  std::condition_variable SleepCond;
+  bool Stopped = false;
+  /// Count of the submitted tasks which are not done, guarded by SleepMutex.
+  uint64_t Unfinished = 0;
+  std::condition_variable IdleCond;
+};
+
+/// Holder of the thread pool which is started at the first use.
+class LazyThreadPool {
+public:
+  LazyThreadPool(uint32_t Threads) noexcept : Threads(Threads) {}
+
+  /// Get the thread pool, or nullptr if the thread count is 0.
+  ThreadPool *get() {
+    if (Threads == 0) {
+      return nullptr;
+    }
+    std::call_once(Once,
+                   [this]() { Pool = std::make_unique<ThreadPool>(Threads); });
+    return Pool.get();
+  }
+
+  /// Stop the thread pool if started, as `ThreadPool::stop`. The pool is not
+  /// started after this.
+  void stop(const std::function<void()> &Interrupt) noexcept {
+    std::call_once(Once, []() {});
+    if (Pool) {
+      Pool->stop(Interrupt);
+    }
+  }
+
+private:
+  const uint32_t Threads;
+  std::once_flag Once;
+  std::unique_ptr<ThreadPool> Pool;
+};
+
+} // namespace WasmEdge
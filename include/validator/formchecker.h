@@ -54,6 +54,8 @@ public:
   void addTag(const uint32_t TypeIdx);
 
   std::vector<VType> result() { return ValStack; }
+  /// Getter of the max operand stack height since the last reset.
+  uint32_t getMaxStackHeight() const noexcept { return MaxHeight; }
   auto &getTypes() { return Types; }
   auto &getFunctions() { return Funcs; }
   auto &getTables() { return Tables; }
@@ -129,7 +131,7 @@ private:
   std::vector<const AST::SubType *> Types;
   std::vector<uint32_t> Funcs;
   std::vector<ValType> Tables;
-  uint32_t Mems = 0;
+  std::vector<ValType> Mems;
   std::vector<std::pair<ValType, ValMut>> Globals;
   std::vector<ValType> Elems;
   std::vector<uint32_t> Datas;
@@ -144,6 +146,7 @@ private:
   /// Running stack.
   std::vector<CtrlFrame> CtrlStack;
   std::vector<VType> ValStack;
+  uint32_t MaxHeight = 0;
 };
 
 } // namespace Validator
@@ -20,6 +20,8 @@
 
 #include <cstdint>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 namespace WasmEdge {
 namespace Validator {
@@ -34,8 +36,17 @@ public:
   Expect<void> validate(const AST::Component::Component &Comp);
   /// Validate AST::Module.
   Expect<void> validate(const AST::Module &Mod);
+  /// Validate the function body at the index of the code section while the
+  /// rest of the module is still loading. The sections before the code section
+  /// should be loaded, and the bodies should be validated in order from the
+  /// first one. The valid bodies are marked and skipped by the validation of
+  /// the module, which also logs the errors instead.
+  Expect<void> validateCodeSegment(const AST::Module &Mod, uint32_t Idx);
 
 private:
+  /// Validate the sections of AST::Module before the code section.
+  Expect<void> validateSections(const AST::Module &Mod);
+
   /// Validate AST::Types
   Expect<void> validate(const AST::SubType &Type);
   Expect<void> validate(const AST::Limit &Lim);
@@ -47,7 +58,8 @@ private:
   Expect<void> validate(const AST::TableSegment &TabSeg);
   Expect<void> validate(const AST::GlobalSegment &GlobSeg);
   Expect<void> validate(const AST::ElementSegment &ElemSeg);
-  Expect<void> validate(const AST::CodeSegment &CodeSeg,
+  Expect<void> validate(FormChecker &FuncChecker,
+                        const AST::CodeSegment &CodeSeg,
                         const uint32_t TypeIdx);
   Expect<void> validate(const AST::DataSegment &DataSeg);
 
@@ -68,16 +80,35 @@ private:
   Expect<void> validate(const AST::StartSection &StartSec);
   Expect<void> validate(const AST::ExportSection &ExportSec);
   Expect<void> validate(const AST::TagSection &TagSec);
+  Expect<void> validateParallel(const AST::CodeSection &CodeSec,
+                                uint32_t Threads);
 
   /// Validate const expression
   Expect<void> validateConstExpr(AST::InstrView Instrs,
                                  Span<const ValType> Returns);
 
+  /// Module contexts to validate the lazy loaded function bodies at their
+  /// first calls. The types are copied for the AST module can be released
+  /// after the instantiation.
+  struct LazyContext {
+    LazyContext(const FormChecker &ModChecker);
+    std::vector<std::unique_ptr<AST::SubType>> Types;
+    FormChecker Checker;
+    std::mutex Mutex;
+  };
+
   static inline const uint32_t LIMIT_MEMORYTYPE = 1U << 16;
+  static inline const uint64_t LIMIT_MEMORY64TYPE = UINT64_C(1) << 48;
   /// Proposal configure
   const Configure Conf;
   /// Formal checker
   FormChecker Checker;
+  /// Module contexts of the lazy loaded function bodies
+  std::shared_ptr<LazyContext> LazyCtx;
+  /// Module of the function bodies validated while loading, and the index of
+  /// the next body.
+  const AST::Module *StreamMod = nullptr;
+  uint32_t StreamIdx = 0;
 };
 
 } // namespace Validator
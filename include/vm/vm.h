@@ -26,8 +26,11 @@
 #include "runtime/instance/module.h"
 #include "runtime/storemgr.h"
 
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <shared_mutex>
 #include <string>
 #include <string_view>
@@ -38,13 +41,17 @@
 namespace WasmEdge {
 namespace VM {
 
+class TierUpCompiler;
+
 /// VM execution flow class
 class VM {
 public:
   VM() = delete;
   VM(const Configure &Conf);
   VM(const Configure &Conf, Runtime::StoreManager &S);
-  ~VM() = default;
+  /// Stop the asynchronous executions and wait for them before the VM
+  /// components are destroyed.
+  ~VM() noexcept { ExecutorEngine.stopAsync(); }
 
   /// ======= Functions can be called before instantiated stage. =======
   /// Register wasm modules and host modules.
@@ -161,9 +168,33 @@ public:
                Span<const ValVariant> Params = {},
                Span<const ValType> ParamTypes = {});
 
+  /// Input of an asynchronous execution in a batch.
+  struct AsyncInvocation {
+    std::string_view Func;
+    Span<const ValVariant> Params;
+    Span<const ValType> ParamTypes;
+  };
+
+  /// Asynchronous execute wasm with the given inputs in a batch. The
+  /// executions are submitted at once to the thread pool.
+  std::vector<Async<Expect<std::vector<std::pair<ValVariant, ValType>>>>>
+  asyncExecuteBatch(Span<const AsyncInvocation> Invocations);
+
   /// Stop execution
   void stop() noexcept { ExecutorEngine.stop(); }
 
+  /// Stop execution of the asynchronous task of the stop token.
+  void stop(std::atomic_uint32_t &Token) noexcept {
+    ExecutorEngine.stop(Token);
+  }
+
+  /// Scope of an asynchronous task, see `Executor::StopScope`.
+  class StopScope : public Executor::Executor::StopScope {
+  public:
+    StopScope(VM &V, std::atomic_uint32_t &Token) noexcept
+        : Executor::Executor::StopScope(V.ExecutorEngine, Token) {}
+  };
+
   /// ======= Functions which are stageless. =======
   /// Clean up VM status
   void cleanup() {
@@ -271,6 +302,10 @@ private:
   void unsafeRegisterBuiltInHosts();
   void unsafeRegisterPlugInHosts();
 
+  /// Helper function to load the compiled executable of the loaded module
+  /// from the cache, and compile it into the cache if not found.
+  Expect<void> unsafeLoadCachedExecutable();
+
   /// Helper function for execution.
   Expect<std::vector<std::pair<ValVariant, ValType>>>
   unsafeExecute(const Runtime::Instance::ModuleInstance *ModInst,
@@ -296,8 +331,15 @@ private:
   /// @{
   /// Loaded AST module.
   std::unique_ptr<AST::Module> Mod;
+  /// Hash of the binary of the loaded module, kept as the key of the compiled
+  /// module cache. Empty if the cache is not applicable.
+  std::optional<std::array<Byte, 32>> ModHash;
   /// Active module instance.
   std::unique_ptr<Runtime::Instance::ModuleInstance> ActiveModInst;
+  /// Background compiler of the hot functions of the active module instance
+  /// in the tiered execution. Declared after the loaded module and the active
+  /// module instance to be stopped before them.
+  std::shared_ptr<TierUpCompiler> TierUp;
   /// Registered module instances by user.
   std::vector<std::unique_ptr<Runtime::Instance::ModuleInstance>> RegModInsts;
   /// Built-in module instances mapped to the configurations. For WASI.
@@ -35,7 +35,8 @@ std::filesystem::path getRoot(Cache::StorageScope Scope) {
 
 Expect<std::filesystem::path> Cache::getPath(Span<const Byte> Data,
                                              Cache::StorageScope Scope,
-                                             std::string_view Key) {
+                                             std::string_view Key,
+                                             std::string_view Salt) {
   auto Root = getRoot(Scope);
   if (!Key.empty()) {
     Root /= std::filesystem::u8path(Key);
@@ -43,6 +44,10 @@ Expect<std::filesystem::path> Cache::getPath(Span<const Byte> Data,
 
   Blake3 Hasher;
   Hasher.update(Data);
+  if (!Salt.empty()) {
+    Hasher.update(Span<const Byte>(reinterpret_cast<const Byte *>(Salt.data()),
+                                   Salt.size()));
+  }
   std::array<Byte, 32> Hash;
   Hasher.finalize(Hash);
   std::string HexStr;
@@ -673,6 +673,24 @@ WasmEdge_ValueGetExternRef(const WasmEdge_Value Val) {
           .get<WasmEdge::RefVariant>());
 }
 
+WASMEDGE_CAPI_EXPORT void WasmEdge_ValueRoot(const WasmEdge_Value Val) {
+  if (genValType(Val.Type).isRefType()) {
+    WasmEdge::Executor::Collector::getInstance().root(
+        WasmEdge::ValVariant::wrap<WasmEdge::RefVariant>(
+            to_WasmEdge_128_t<WasmEdge::uint128_t>(Val.Value))
+            .get<WasmEdge::RefVariant>());
+  }
+}
+
+WASMEDGE_CAPI_EXPORT void WasmEdge_ValueUnroot(const WasmEdge_Value Val) {
+  if (genValType(Val.Type).isRefType()) {
+    WasmEdge::Executor::Collector::getInstance().unroot(
+        WasmEdge::ValVariant::wrap<WasmEdge::RefVariant>(
+            to_WasmEdge_128_t<WasmEdge::uint128_t>(Val.Value))
+            .get<WasmEdge::RefVariant>());
+  }
+}
+
 // <<<<<<<< WasmEdge value functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 // >>>>>>>> WasmEdge string functions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
@@ -880,6 +898,153 @@ WasmEdge_ConfigureGetMaxMemoryPage(const WasmEdge_ConfigureContext *Cxt) {
   return 0;
 }
 
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureSetMemoryPoolSize(WasmEdge_ConfigureContext *Cxt,
+                                    const uint32_t SlotCount) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setMemoryPoolSize(SlotCount);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT uint32_t
+WasmEdge_ConfigureGetMemoryPoolSize(const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().getMemoryPoolSize();
+  }
+  return 0;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureSetTierUpThreshold(WasmEdge_ConfigureContext *Cxt,
+                                     const uint32_t Threshold) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setTierUpThreshold(Threshold);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT uint32_t
+WasmEdge_ConfigureGetTierUpThreshold(const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().getTierUpThreshold();
+  }
+  return 0;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureSetEnableLazyJIT(WasmEdge_ConfigureContext *Cxt,
+                                   const bool IsEnableLazyJIT) {
+  if (Cxt) {
+    // The lazy JIT is a mode of the JIT, which has no other switch in the C
+    // API.
+    Cxt->Conf.getRuntimeConfigure().setEnableJIT(IsEnableLazyJIT);
+    Cxt->Conf.getRuntimeConfigure().setEnableLazyJIT(IsEnableLazyJIT);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT bool
+WasmEdge_ConfigureIsEnableLazyJIT(const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().isEnableLazyJIT();
+  }
+  return false;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureSetLoadThreads(WasmEdge_ConfigureContext *Cxt,
+                                 const uint32_t Threads) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setLoadThreads(std::max(Threads, 1U));
+  }
+}
+
+WASMEDGE_CAPI_EXPORT uint32_t
+WasmEdge_ConfigureGetLoadThreads(const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().getLoadThreads();
+  }
+  return 0;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureSetAsyncThreads(WasmEdge_ConfigureContext *Cxt,
+                                  const uint32_t Threads) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setAsyncThreads(Threads);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT uint32_t
+WasmEdge_ConfigureGetAsyncThreads(const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().getAsyncThreads();
+  }
+  return 0;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureSetStackSize(WasmEdge_ConfigureContext *Cxt,
+                               const uint64_t Size) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setStackSize(Size);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT uint64_t
+WasmEdge_ConfigureGetStackSize(const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().getStackSize();
+  }
+  return 0;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureSetEnableLazyLoading(WasmEdge_ConfigureContext *Cxt,
+                                       const bool IsEnableLazyLoading) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setEnableLazyLoading(IsEnableLazyLoading);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT bool
+WasmEdge_ConfigureIsEnableLazyLoading(const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().isEnableLazyLoading();
+  }
+  return false;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureSetEnableIOUring(WasmEdge_ConfigureContext *Cxt,
+                                   const bool IsEnableIOUring) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setEnableIOUring(IsEnableIOUring);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT bool
+WasmEdge_ConfigureIsEnableIOUring(const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().isEnableIOUring();
+  }
+  return false;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureSetMaxIOUringBufferSize(WasmEdge_ConfigureContext *Cxt,
+                                          const uint64_t Size) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setMaxIOUringBufferSize(Size);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT uint64_t WasmEdge_ConfigureGetMaxIOUringBufferSize(
+    const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().getMaxIOUringBufferSize();
+  }
+  return 0;
+}
+
 WASMEDGE_CAPI_EXPORT void
 WasmEdge_ConfigureSetForceInterpreter(WasmEdge_ConfigureContext *Cxt,
                                       const bool IsForceInterpreter) {
@@ -912,6 +1077,38 @@ WasmEdge_ConfigureIsForceInterpreter(const WasmEdge_ConfigureContext *Cxt) {
   return false;
 }
 
+WASMEDGE_CAPI_EXPORT void WasmEdge_ConfigureSetEnableThreadedInterpreter(
+    WasmEdge_ConfigureContext *Cxt, const bool IsEnableThreadedInterpreter) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setEnableThreadedInterpreter(
+        IsEnableThreadedInterpreter);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT bool WasmEdge_ConfigureIsEnableThreadedInterpreter(
+    const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().isEnableThreadedInterpreter();
+  }
+  return false;
+}
+
+WASMEDGE_CAPI_EXPORT void WasmEdge_ConfigureSetEnableRegisterInterpreter(
+    WasmEdge_ConfigureContext *Cxt, const bool IsEnableRegisterInterpreter) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setEnableRegisterInterpreter(
+        IsEnableRegisterInterpreter);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT bool WasmEdge_ConfigureIsEnableRegisterInterpreter(
+    const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().isEnableRegisterInterpreter();
+  }
+  return false;
+}
+
 WASMEDGE_CAPI_EXPORT void WasmEdge_ConfigureCompilerSetOptimizationLevel(
     WasmEdge_ConfigureContext *Cxt,
     const enum WasmEdge_CompilerOptimizationLevel Level) {
@@ -998,6 +1195,22 @@ WASMEDGE_CAPI_EXPORT bool WasmEdge_ConfigureCompilerIsInterruptible(
   return false;
 }
 
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureCompilerSetThreads(WasmEdge_ConfigureContext *Cxt,
+                                     const uint32_t Threads) {
+  if (Cxt) {
+    Cxt->Conf.getCompilerConfigure().setThreads(Threads);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT uint32_t
+WasmEdge_ConfigureCompilerGetThreads(const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getCompilerConfigure().getThreads();
+  }
+  return 0;
+}
+
 WASMEDGE_CAPI_EXPORT void WasmEdge_ConfigureStatisticsSetInstructionCounting(
     WasmEdge_ConfigureContext *Cxt, const bool IsCount) {
   if (Cxt) {
@@ -1045,6 +1258,22 @@ WASMEDGE_CAPI_EXPORT bool WasmEdge_ConfigureStatisticsIsTimeMeasuring(
   return false;
 }
 
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureStatisticsSetBatchedMetering(WasmEdge_ConfigureContext *Cxt,
+                                               const bool IsBatched) {
+  if (Cxt) {
+    Cxt->Conf.getStatisticsConfigure().setBatchedMetering(IsBatched);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT bool WasmEdge_ConfigureStatisticsIsBatchedMetering(
+    const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getStatisticsConfigure().isBatchedMetering();
+  }
+  return false;
+}
+
 WASMEDGE_CAPI_EXPORT void
 WasmEdge_ConfigureDelete(WasmEdge_ConfigureContext *Cxt) {
   delete Cxt;
@@ -1270,8 +1499,8 @@ WasmEdge_TableTypeGetLimit(const WasmEdge_TableTypeContext *Cxt) {
     const auto &Lim = fromTabTypeCxt(Cxt)->getLimit();
     return WasmEdge_Limit{/* HasMax */ Lim.hasMax(),
                           /* Shared */ Lim.isShared(),
-                          /* Min */ Lim.getMin(),
-                          /* Max */ Lim.getMax()};
+                          /* Min */ static_cast<uint32_t>(Lim.getMin()),
+                          /* Max */ static_cast<uint32_t>(Lim.getMax())};
   }
   return WasmEdge_Limit{/* HasMax */ false, /* Shared */ false, /* Min */ 0,
                         /* Max */ 0};
@@ -1304,8 +1533,8 @@ WasmEdge_MemoryTypeGetLimit(const WasmEdge_MemoryTypeContext *Cxt) {
     const auto &Lim = fromMemTypeCxt(Cxt)->getLimit();
     return WasmEdge_Limit{/* HasMax */ Lim.hasMax(),
                           /* Shared */ Lim.isShared(),
-                          /* Min */ Lim.getMin(),
-                          /* Max */ Lim.getMax()};
+                          /* Min */ static_cast<uint32_t>(Lim.getMin()),
+                          /* Max */ static_cast<uint32_t>(Lim.getMax())};
   }
   return WasmEdge_Limit{/* HasMax */ false, /* Shared */ false, /* Min */ 0,
                         /* Max */ 0};
@@ -2575,6 +2804,32 @@ WASMEDGE_CAPI_EXPORT WasmEdge_Result WasmEdge_MemoryInstanceGrowPage(
       EmptyThen, Cxt);
 }
 
+WASMEDGE_CAPI_EXPORT WasmEdge_Result
+WasmEdge_MemoryInstanceSnapshot(WasmEdge_MemoryInstanceContext *Cxt) {
+  return wrap(
+      [&]() -> WasmEdge::Expect<void> {
+        if (fromMemCxt(Cxt)->snapshot()) {
+          return {};
+        } else {
+          return WasmEdge::Unexpect(WasmEdge::ErrCode::Value::RuntimeError);
+        }
+      },
+      EmptyThen, Cxt);
+}
+
+WASMEDGE_CAPI_EXPORT WasmEdge_Result
+WasmEdge_MemoryInstanceResetToSnapshot(WasmEdge_MemoryInstanceContext *Cxt) {
+  return wrap(
+      [&]() -> WasmEdge::Expect<void> {
+        if (fromMemCxt(Cxt)->resetToSnapshot()) {
+          return {};
+        } else {
+          return WasmEdge::Unexpect(WasmEdge::ErrCode::Value::RuntimeError);
+        }
+      },
+      EmptyThen, Cxt);
+}
+
 WASMEDGE_CAPI_EXPORT void
 WasmEdge_MemoryInstanceDelete(WasmEdge_MemoryInstanceContext *Cxt) {
   delete fromMemCxt(Cxt);
@@ -3043,6 +3298,34 @@ WASMEDGE_CAPI_EXPORT WasmEdge_Async *WasmEdge_VMAsyncExecuteRegistered(
   return nullptr;
 }
 
+WASMEDGE_CAPI_EXPORT void WasmEdge_VMAsyncExecuteBatch(
+    WasmEdge_VMContext *Cxt, const WasmEdge_AsyncInvocation *Invocations,
+    const uint32_t Len, WasmEdge_Async **Asyncs) {
+  if (!Asyncs) {
+    return;
+  }
+  if (!Cxt || (!Invocations && Len > 0)) {
+    std::fill_n(Asyncs, Len, nullptr);
+    return;
+  }
+  std::vector<std::pair<std::vector<WasmEdge::ValVariant>,
+                        std::vector<WasmEdge::ValType>>>
+      ParamPairs;
+  std::vector<WasmEdge::VM::VM::AsyncInvocation> Invs;
+  ParamPairs.reserve(Len);
+  Invs.reserve(Len);
+  for (uint32_t I = 0; I < Len; ++I) {
+    ParamPairs.push_back(
+        genParamPair(Invocations[I].Params, Invocations[I].ParamLen));
+    Invs.push_back({genStrView(Invocations[I].FuncName),
+                    ParamPairs.back().first, ParamPairs.back().second});
+  }
+  auto Results = Cxt->VM.asyncExecuteBatch(Invs);
+  for (uint32_t I = 0; I < Len; ++I) {
+    Asyncs[I] = new WasmEdge_Async(std::move(Results[I]));
+  }
+}
+
 WASMEDGE_CAPI_EXPORT const WasmEdge_FunctionTypeContext *
 WasmEdge_VMGetFunctionType(const WasmEdge_VMContext *Cxt,
                            const WasmEdge_String FuncName) {
@@ -3421,7 +3704,8 @@ WASMEDGE_CAPI_EXPORT uint32_t WasmEdge_ASTModuleListDataSegments(
   const auto &DataSegSpan = fromASTModCxt(Cxt)->getDataSection().getContent();
   WasmEdge::Configure Conf;
   WasmEdge::Executor::Executor Executor{Conf};
-  WasmEdge::Runtime::StackManager StackMgr;
+  WasmEdge::Runtime::StackManager StackMgr(
+      Conf.getRuntimeConfigure().getStackSize());
   uint32_t I = 0;
   for (const auto &DataSeg : DataSegSpan) {
     auto Offset = Executor.dataSegmentOffset(StackMgr, DataSeg);
@@ -3,9 +3,77 @@
 
 #include "common/spdlog.h"
 
+#include "spdlog/sinks/sink.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
 namespace WasmEdge {
 namespace Log {
 
+namespace {
+
+thread_local bool ThreadLogOff = false;
+
+/// Sink forwarding the messages to the original sinks of the default logger,
+/// except the ones from the threads with the logging turned off.
+class ThreadFilterSink final : public spdlog::sinks::sink {
+public:
+  explicit ThreadFilterSink(std::vector<spdlog::sink_ptr> S) noexcept
+      : Sinks(std::move(S)) {}
+
+  void log(const spdlog::details::log_msg &Msg) override {
+    if (ThreadLogOff) {
+      return;
+    }
+    for (auto &Sink : Sinks) {
+      if (Sink->should_log(Msg.level)) {
+        Sink->log(Msg);
+      }
+    }
+  }
+  void flush() override {
+    for (auto &Sink : Sinks) {
+      Sink->flush();
+    }
+  }
+  void set_pattern(const std::string &Pattern) override {
+    for (auto &Sink : Sinks) {
+      Sink->set_pattern(Pattern);
+    }
+  }
+  void set_formatter(std::unique_ptr<spdlog::formatter> Formatter) override {
+    for (auto &Sink : Sinks) {
+      Sink->set_formatter(Formatter->clone());
+    }
+  }
+
+private:
+  std::vector<spdlog::sink_ptr> Sinks;
+};
+
+/// Wrap the sinks of the default logger when the library is loaded, before
+/// any thread logs through them.
+struct ThreadFilterInstaller {
+  ThreadFilterInstaller() noexcept {
+    if (auto *Logger = spdlog::default_logger_raw()) {
+      auto &Sinks = Logger->sinks();
+      auto Filter = std::make_shared<ThreadFilterSink>(std::move(Sinks));
+      Sinks = {std::move(Filter)};
+    }
+  }
+} Installer;
+
+} // namespace
+
+ScopedThreadLogOff::ScopedThreadLogOff() noexcept : Prev(ThreadLogOff) {
+  ThreadLogOff = true;
+}
+
+ScopedThreadLogOff::~ScopedThreadLogOff() noexcept { ThreadLogOff = Prev; }
+
 void setLogOff() { spdlog::set_level(spdlog::level::off); }
 
 void setDebugLoggingLevel() { spdlog::set_level(spdlog::level::debug); }
@@ -90,6 +90,12 @@ int Compiler([[maybe_unused]] struct DriverCompilerOptions &Opt) noexcept {
         WasmEdge::CompilerConfigure::OptimizationLevel::O2);
   }
 
+  // 0 for the hardware concurrency.
+  Conf.getCompilerConfigure().setThreads(Opt.ConfThreads.value());
+  // The function bodies are also loaded and validated with the threads.
+  Conf.getRuntimeConfigure().setLoadThreads(
+      Conf.getCompilerConfigure().getThreads());
+
   // Set force interpreter here to load instructions of function body forcibly.
   Conf.getRuntimeConfigure().setForceInterpreter(true);
 
@@ -148,6 +154,9 @@ int Compiler([[maybe_unused]] struct DriverCompilerOptions &Opt) noexcept {
         Conf.getStatisticsConfigure().setTimeMeasuring(true);
       }
     }
+    if (Opt.ConfEnableBatchedMetering.value()) {
+      Conf.getStatisticsConfigure().setBatchedMetering(true);
+    }
     if (Opt.ConfGenericBinary.value()) {
       Conf.getCompilerConfigure().setGenericBinary(true);
     }
@@ -10,6 +10,7 @@
 #include "host/wasi/wasimodule.h"
 #include "vm/vm.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <cstdlib>
@@ -17,6 +18,7 @@
 #include <optional>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <vector>
 
 namespace WasmEdge {
@@ -120,14 +122,43 @@ int Tool(struct DriverToolOptions &Opt) noexcept {
       Conf.getStatisticsConfigure().setTimeMeasuring(true);
     }
   }
-  if (Opt.ConfEnableJIT.value()) {
+  if (Opt.ConfEnableBatchedMetering.value()) {
+    Conf.getStatisticsConfigure().setBatchedMetering(true);
+  }
+  if (Opt.ConfEnableLazyJIT.value()) {
+    Conf.getRuntimeConfigure().setEnableLazyJIT(true);
+  }
+  if (Opt.ConfEnableJIT.value() || Opt.ConfEnableLazyJIT.value()) {
     Conf.getRuntimeConfigure().setEnableJIT(true);
     Conf.getCompilerConfigure().setOptimizationLevel(
         WasmEdge::CompilerConfigure::OptimizationLevel::O1);
   }
+  if (Opt.ConfEnableJITCache.value()) {
+    Conf.getRuntimeConfigure().setEnableJITCache(true);
+  }
   if (Opt.ConfForceInterpreter.value()) {
     Conf.getRuntimeConfigure().setForceInterpreter(true);
   }
+  if (Opt.ConfTierUpThreshold.value() > 0) {
+    Conf.getRuntimeConfigure().setTierUpThreshold(
+        Opt.ConfTierUpThreshold.value());
+    Conf.getCompilerConfigure().setOptimizationLevel(
+        WasmEdge::CompilerConfigure::OptimizationLevel::O1);
+  }
+  if (const uint32_t Threads = Opt.ConfLoadThreads.value(); Threads > 0) {
+    Conf.getRuntimeConfigure().setLoadThreads(Threads);
+  } else {
+    Conf.getRuntimeConfigure().setLoadThreads(
+        std::max(std::thread::hardware_concurrency(), 1U));
+  }
+  if (Opt.ConfEnableLazyLoading.value()) {
+    Conf.getRuntimeConfigure().setEnableLazyLoading(true);
+  }
+  if (Opt.ConfEnableIOUring.value()) {
+    Conf.getRuntimeConfigure().setEnableIOUring(true);
+  }
+  Conf.getRuntimeConfigure().setMaxIOUringBufferSize(
+      Opt.ConfMaxIOUringBufferSize.value());
 
   for (const auto &Name : Opt.ForbiddenPlugins.value()) {
     Conf.addForbiddenPlugins(Name);
@@ -109,23 +109,9 @@ Expect<void> Executor::runBrOnCastOp(Runtime::StackManager &StackMgr,
                                      const AST::Instruction &Instr,
                                      AST::InstrView::iterator &PC,
                                      bool IsReverse) noexcept {
-  // Get value on top of stack.
-  const auto *ModInst = StackMgr.getModule();
-  const auto &Val = StackMgr.getTop().get<RefVariant>();
-  const auto &VT = Val.getType();
-  Span<const AST::SubType *const> GotTypeList = ModInst->getTypeList();
-  if (!VT.isAbsHeapType()) {
-    auto *Inst = Val.getPtr<Runtime::Instance::CompositeBase>();
-    // Reference must not be nullptr here because the null references are typed
-    // with the least abstract heap type.
-    if (Inst->getModule()) {
-      GotTypeList = Inst->getModule()->getTypeList();
-    }
-  }
-
-  if (AST::TypeMatcher::matchType(ModInst->getTypeList(),
-                                  Instr.getBrCast().RType2, GotTypeList,
-                                  VT) != IsReverse) {
+  // Match the value on top of stack.
+  if (matchRefType(StackMgr.getModule(), Instr.getBrCast().RType2,
+                   StackMgr.getTop().get<RefVariant>()) != IsReverse) {
     return branchToLabel(StackMgr, Instr.getBrCast().Jump, PC);
   }
   return {};
@@ -134,7 +120,7 @@ Expect<void> Executor::runBrOnCastOp(Runtime::StackManager &StackMgr,
 Expect<void> Executor::runReturnOp(Runtime::StackManager &StackMgr,
                                    AST::InstrView::iterator &PC) noexcept {
   // Check stop token
-  if (unlikely(StopToken.exchange(0, std::memory_order_relaxed))) {
+  if (unlikely(getStopToken().exchange(0, std::memory_order_relaxed))) {
     spdlog::error(ErrCode::Value::Interrupted);
     return Unexpect(ErrCode::Value::Interrupted);
   }
@@ -251,7 +237,13 @@ Expect<void> Executor::runTryTableOp(Runtime::StackManager &StackMgr,
                                      const AST::Instruction &Instr,
                                      AST::InstrView::iterator &PC) noexcept {
   const auto &TryDesc = Instr.getTryCatch();
-  StackMgr.pushHandler(PC, TryDesc.BlockParamNum, TryDesc.Catch);
+  if (unlikely(
+          !StackMgr.pushHandler(PC, TryDesc.BlockParamNum, TryDesc.Catch))) {
+    spdlog::error(ErrCode::Value::StackOverflow);
+    spdlog::error(
+        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
+    return Unexpect(ErrCode::Value::StackOverflow);
+  }
   return {};
 }
 
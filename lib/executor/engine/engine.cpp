@@ -6,12 +6,81 @@
 #include <array>
 #include <cstdint>
 #include <cstring>
+#include <type_traits>
+#include <utility>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define WASMEDGE_EXECUTOR_ALWAYS_INLINE __attribute__((always_inline))
+// The threaded dispatch needs the labels as values of GCC and Clang.
+#define WASMEDGE_EXECUTOR_THREADED 1
+#else
+#define WASMEDGE_EXECUTOR_ALWAYS_INLINE
+#define WASMEDGE_EXECUTOR_THREADED 0
+#endif
 
 namespace WasmEdge {
 namespace Executor {
 
+#if WASMEDGE_EXECUTOR_THREADED
+// The instructions run by their own handlers in the threaded dispatch. The
+// others are run by the dispatcher of the switch loop.
+#define WASMEDGE_THREADED_OPCODES(X)                                           \
+  X(Nop) X(Block) X(Loop) X(If) X(Else) X(End) X(Br) X(Br_if) X(Return)        \
+  X(Call) X(Drop) X(Local__get) X(Local__set) X(Local__tee) X(Global__get)     \
+  X(Global__set) X(I32__load) X(I64__load) X(I32__store) X(I64__store)         \
+  X(I32__const) X(I64__const) X(I32__eqz) X(I32__eq) X(I32__ne) X(I32__lt_s)   \
+  X(I32__lt_u) X(I32__gt_s) X(I32__gt_u) X(I32__le_s) X(I32__le_u)             \
+  X(I32__ge_s) X(I32__ge_u) X(I64__eqz) X(I64__eq) X(I64__ne) X(I64__lt_s)     \
+  X(I64__lt_u) X(I32__add) X(I32__sub) X(I32__mul) X(I32__and) X(I32__or)      \
+  X(I32__xor) X(I32__shl) X(I32__shr_s) X(I32__shr_u) X(I64__add) X(I64__sub)  \
+  X(I64__mul)
+
+namespace {
+
+/// Handlers of the threaded dispatch. The generic handler runs the other
+/// instructions by the dispatcher.
+enum ThreadedHandler : uint8_t {
+  TH_Generic,
+#define X(NAME) TH_##NAME,
+  WASMEDGE_THREADED_OPCODES(X)
+#undef X
+};
+
+constexpr uint32_t OpCodeCount = 0
+#define UseOpCode
+#define Line(NAME, STRING, PREFIX) +1
+#define Line_FB(NAME, STRING, PREFIX, EXTEND) +1
+#define Line_FC(NAME, STRING, PREFIX, EXTEND) +1
+#define Line_FD(NAME, STRING, PREFIX, EXTEND) +1
+#define Line_FE(NAME, STRING, PREFIX, EXTEND) +1
+#include "common/enum.inc"
+#undef Line
+#undef Line_FB
+#undef Line_FC
+#undef Line_FD
+#undef Line_FE
+#undef UseOpCode
+    ;
+
+/// Handler of every opcode, decoded once at compile time.
+constexpr std::array<ThreadedHandler, OpCodeCount> ThreadedHandlers =
+    []() constexpr {
+      std::array<ThreadedHandler, OpCodeCount> Handlers = {};
+#define X(NAME) Handlers[static_cast<uint32_t>(OpCode::NAME)] = TH_##NAME;
+      WASMEDGE_THREADED_OPCODES(X)
+#undef X
+      return Handlers;
+    }();
+
+} // namespace
+#endif
+
 Expect<void> Executor::runExpression(Runtime::StackManager &StackMgr,
                                      AST::InstrView Instrs) {
+  // The instructions of the constant expressions push at most one value each.
+  if (auto Res = checkStack(StackMgr, Instrs.size(), 0); unlikely(!Res)) {
+    return Unexpect(Res);
+  }
   return execute(StackMgr, Instrs.begin(), Instrs.end());
 }
 
@@ -19,11 +88,21 @@ Expect<void>
 Executor::runFunction(Runtime::StackManager &StackMgr,
                       const Runtime::Instance::FunctionInstance &Func,
                       Span<const ValVariant> Params) {
+  // Load the lazy loaded body for the end of the function body.
+  if (auto Res = Func.loadLazyBody(); !Res) {
+    return Unexpect(Res);
+  }
+
   // Set start time.
   if (Stat && Conf.getStatisticsConfigure().isTimeMeasuring()) {
     Stat->startRecordWasm();
   }
 
+  // Check the room of the dummy frame and the arguments.
+  if (auto Res = checkStack(StackMgr, Params.size()); unlikely(!Res)) {
+    return Unexpect(Res);
+  }
+
   // Reset and push a dummy frame into stack.
   StackMgr.pushFrame(nullptr, AST::InstrView::iterator(), 0, 0);
 
@@ -93,17 +172,19 @@ Expect<void> Executor::execute(Runtime::StackManager &StackMgr,
   AST::InstrView::iterator PC = Start;
   AST::InstrView::iterator PCEnd = End;
 
-  auto Dispatch = [this, &PC, &StackMgr]() -> Expect<void> {
-    const AST::Instruction &Instr = *PC;
+  // The instruction count and the cost accumulated by the executing thread in
+  // the batched metering mode. They are charged to the statistics at the loop
+  // headers, the calls, and the exit of this function.
+  uint64_t PendingCount = 0;
+  uint64_t PendingCost = 0;
 
-    auto GetDstCompType = [&StackMgr, &Instr, this]() {
-      return getDefTypeByIdx(StackMgr, Instr.getTargetIndex())
-          ->getCompositeType();
-    };
-    auto GetSrcCompType = [&StackMgr, &Instr, this]() {
-      return getDefTypeByIdx(StackMgr, Instr.getSourceIndex())
-          ->getCompositeType();
-    };
+  // The dispatcher is force-inlined into every statistics variant of the
+  // instruction loop below, so that each variant owns its jump table and no
+  // call or return is paid per instruction.
+  auto Dispatch = [this, &PC, &StackMgr,
+                   &PendingCost]() WASMEDGE_EXECUTOR_ALWAYS_INLINE
+      -> Expect<void> {
+    const AST::Instruction &Instr = *PC;
 
     switch (Instr.getOpCode()) {
     // Control instructions.
@@ -121,7 +202,13 @@ Expect<void> Executor::execute(Runtime::StackManager &StackMgr,
     case OpCode::If:
       return runIfElseOp(StackMgr, Instr, PC);
     case OpCode::Else:
-      if (Stat && Conf.getStatisticsConfigure().isCostMeasuring()) {
+      if (Stat && Conf.getStatisticsConfigure().isBatchedMetering()) {
+        // Reach here means end of if-statement. The cost of this instruction
+        // is still pending.
+        const auto CostTab = Stat->getCostTable();
+        PendingCost -= CostTab[uint16_t(OpCode::Else)];
+        PendingCost += CostTab[uint16_t(OpCode::End)];
+      } else if (Stat && Conf.getStatisticsConfigure().isCostMeasuring()) {
         // Reach here means end of if-statement.
         if (unlikely(!Stat->subInstrCost(Instr.getOpCode()))) {
           spdlog::error(ErrCode::Value::CostLimitExceeded);
@@ -206,26 +293,25 @@ Expect<void> Executor::execute(Runtime::StackManager &StackMgr,
       return runStructNewOp(StackMgr, Instr.getTargetIndex(), true);
     case OpCode::Struct__get:
     case OpCode::Struct__get_u:
-      return runStructGetOp(StackMgr.getTop(), Instr.getSourceIndex(),
-                            GetDstCompType(), Instr);
+      return runStructGetOp(StackMgr.getTop(), Instr.getSourceIndex(), Instr);
     case OpCode::Struct__get_s:
-      return runStructGetOp(StackMgr.getTop(), Instr.getSourceIndex(),
-                            GetDstCompType(), Instr, true);
+      return runStructGetOp(StackMgr.getTop(), Instr.getSourceIndex(), Instr,
+                            true);
     case OpCode::Struct__set: {
       const ValVariant Val = StackMgr.pop();
       RefVariant StructRef = StackMgr.pop().get<RefVariant>();
-      return runStructSetOp(Val, StructRef, GetDstCompType(),
-                            Instr.getSourceIndex(), Instr);
+      return runStructSetOp(Val, StructRef, Instr.getSourceIndex(), Instr);
     }
     case OpCode::Array__new:
       return runArrayNewOp(StackMgr, Instr.getTargetIndex(), 1,
-                           StackMgr.pop().get<uint32_t>());
+                           StackMgr.pop().get<uint32_t>(), Instr);
     case OpCode::Array__new_default:
       return runArrayNewOp(StackMgr, Instr.getTargetIndex(), 0,
-                           StackMgr.pop().get<uint32_t>());
+                           StackMgr.pop().get<uint32_t>(), Instr);
     case OpCode::Array__new_fixed:
       return runArrayNewOp(StackMgr, Instr.getTargetIndex(),
-                           Instr.getSourceIndex(), Instr.getSourceIndex());
+                           Instr.getSourceIndex(), Instr.getSourceIndex(),
+                           Instr);
     case OpCode::Array__new_data:
       return runArrayNewDataOp(
           StackMgr, *getDataInstByIdx(StackMgr, Instr.getSourceIndex()), Instr);
@@ -235,18 +321,17 @@ Expect<void> Executor::execute(Runtime::StackManager &StackMgr,
     case OpCode::Array__get:
     case OpCode::Array__get_u: {
       const uint32_t Idx = StackMgr.pop().get<uint32_t>();
-      return runArrayGetOp(StackMgr.getTop(), Idx, GetDstCompType(), Instr);
+      return runArrayGetOp(StackMgr.getTop(), Idx, Instr);
     }
     case OpCode::Array__get_s: {
       const uint32_t Idx = StackMgr.pop().get<uint32_t>();
-      return runArrayGetOp(StackMgr.getTop(), Idx, GetDstCompType(), Instr,
-                           true);
+      return runArrayGetOp(StackMgr.getTop(), Idx, Instr, true);
     }
     case OpCode::Array__set: {
       ValVariant Val = StackMgr.pop();
       const uint32_t Idx = StackMgr.pop().get<uint32_t>();
       RefVariant ArrayRef = StackMgr.pop().get<RefVariant>();
-      return runArraySetOp(Val, Idx, ArrayRef, GetDstCompType(), Instr);
+      return runArraySetOp(Val, Idx, ArrayRef, Instr);
     }
     case OpCode::Array__len:
       return runArrayLenOp(StackMgr.getTop(), Instr);
@@ -255,7 +340,7 @@ Expect<void> Executor::execute(Runtime::StackManager &StackMgr,
       const ValVariant Val = StackMgr.pop();
       const uint32_t D = StackMgr.pop().get<uint32_t>();
       RefVariant ArrayRef = StackMgr.pop().get<RefVariant>();
-      return runArrayFillOp(N, Val, D, ArrayRef, GetDstCompType(), Instr);
+      return runArrayFillOp(N, Val, D, ArrayRef, Instr);
     }
     case OpCode::Array__copy: {
       const uint32_t N = StackMgr.pop().get<uint32_t>();
@@ -263,8 +348,7 @@ Expect<void> Executor::execute(Runtime::StackManager &StackMgr,
       RefVariant SrcArrayRef = StackMgr.pop().get<RefVariant>();
       const uint32_t D = StackMgr.pop().get<uint32_t>();
       RefVariant DstArrayRef = StackMgr.pop().get<RefVariant>();
-      return runArrayCopyOp(N, S, SrcArrayRef, D, DstArrayRef, GetSrcCompType(),
-                            GetDstCompType(), Instr);
+      return runArrayCopyOp(N, S, SrcArrayRef, D, DstArrayRef, Instr);
     }
     case OpCode::Array__init_data: {
       const uint32_t N = StackMgr.pop().get<uint32_t>();
@@ -272,7 +356,7 @@ Expect<void> Executor::execute(Runtime::StackManager &StackMgr,
       const uint32_t D = StackMgr.pop().get<uint32_t>();
       RefVariant ArrayRef = StackMgr.pop().get<RefVariant>();
       return runArrayInitDataOp(
-          N, S, D, ArrayRef, GetDstCompType(),
+          N, S, D, ArrayRef,
           *getDataInstByIdx(StackMgr, Instr.getSourceIndex()), Instr);
     }
     case OpCode::Array__init_elem: {
@@ -281,7 +365,7 @@ Expect<void> Executor::execute(Runtime::StackManager &StackMgr,
       const uint32_t D = StackMgr.pop().get<uint32_t>();
       RefVariant ArrayRef = StackMgr.pop().get<RefVariant>();
       return runArrayInitElemOp(
-          N, S, D, ArrayRef, GetDstCompType(),
+          N, S, D, ArrayRef,
           *getElemInstByIdx(StackMgr, Instr.getSourceIndex()), Instr);
     }
     case OpCode::Ref__test:
@@ -2034,28 +2118,295 @@ Expect<void> Executor::execute(Runtime::StackManager &StackMgr,
     }
   };
 
-  while (PC != PCEnd) {
-    if (Stat) {
-      OpCode Code = PC->getOpCode();
-      if (Conf.getStatisticsConfigure().isInstructionCounting()) {
-        Stat->incInstrCount();
+  // Charge the pending instruction count and cost of the batched metering
+  // mode. Returns false if the cost limit is exceeded.
+  auto Flush = [this, &PendingCount, &PendingCost]() -> bool {
+    const auto &StatConf = Conf.getStatisticsConfigure();
+    if (StatConf.isInstructionCounting()) {
+      Stat->addInstrCount(PendingCount);
+    }
+    PendingCount = 0;
+    const uint64_t Cost = std::exchange(PendingCost, 0);
+    return !StatConf.isCostMeasuring() || Stat->addCost(Cost);
+  };
+
+  // Run the instruction loop with the given statistics variant. The loop body
+  // is instantiated once per variant so that the statistics configuration is
+  // only checked at entry instead of on every instruction.
+  auto Run = [&Dispatch, &Flush, &StackMgr, &PC, &PCEnd, &PendingCount,
+              &PendingCost, this](auto IsCount, auto IsCost,
+                                  auto IsBatched) -> Expect<void> {
+    // The cost table and the block costs of the executing function are only
+    // read in the batched variant.
+    const uint64_t *CostTab = nullptr;
+    uint64_t CostHash = 0;
+    const Runtime::Instance::FunctionInstance *BlockFunc = nullptr;
+    const Runtime::Instance::FunctionInstance::BlockCost *Blocks = nullptr;
+    AST::InstrView::iterator BlockBase = PC;
+    if constexpr (decltype(IsBatched)::value) {
+      CostTab = Stat->getCostTable().data();
+      CostHash = Stat->getCostTableHash();
+    }
+    while (PC != PCEnd) {
+      // The superinstructions tagged by the validator are only run when there
+      // is no per-instruction statistics.
+      if constexpr (!decltype(IsCount)::value && !decltype(IsCost)::value) {
+        if (PC->getFusedKind() != AST::Instruction::FusedKind::None) {
+          if (auto Res = runFusedOp(StackMgr, PC); unlikely(!Res)) {
+            return Unexpect(Res);
+          }
+          PC++;
+          continue;
+        }
       }
-      // Add cost. Note: if-else case should be processed additionally.
-      if (Conf.getStatisticsConfigure().isCostMeasuring()) {
-        if (unlikely(!Stat->addInstrCost(Code))) {
-          const AST::Instruction &Instr = *PC;
-          spdlog::error(
-              ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-          return Unexpect(ErrCode::Value::CostLimitExceeded);
+      if constexpr (decltype(IsBatched)::value) {
+        // Accumulate without atomics, and only check the cost limit where the
+        // execution can repeat: the loop headers, which every back-edge jumps
+        // to, and the calls. The function bodies are charged per basic block
+        // at the leaders, and the instructions of the constant expressions
+        // are charged one by one.
+        const OpCode Code = PC->getOpCode();
+        if (PC->isBlockLeader() &&
+            unlikely(StackMgr.getFunction() != BlockFunc)) {
+          // The jumps, calls, and returns always continue at a leader, so the
+          // executing function only needs to be checked here.
+          BlockFunc = StackMgr.getFunction();
+          Blocks = nullptr;
+          if (BlockFunc) {
+            Blocks = BlockFunc->getBlockCosts(
+                CostHash, Span<const uint64_t>(CostTab, UINT16_MAX + 1));
+            BlockBase = BlockFunc->getInstrs().begin();
+          }
+        }
+        if (likely(Blocks != nullptr)) {
+          if (PC->isBlockLeader()) {
+            const auto &Block = Blocks[PC - BlockBase];
+            PendingCount += Block.Count;
+            PendingCost += Block.Cost;
+          }
+        } else {
+          ++PendingCount;
+          PendingCost += CostTab[uint16_t(Code)];
+        }
+        switch (Code) {
+        case OpCode::Loop:
+        case OpCode::Call:
+        case OpCode::Call_indirect:
+        case OpCode::Call_ref:
+        case OpCode::Return_call:
+        case OpCode::Return_call_indirect:
+        case OpCode::Return_call_ref:
+          if (unlikely(!Flush())) {
+            const AST::Instruction &Instr = *PC;
+            spdlog::error(
+                ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
+            return Unexpect(ErrCode::Value::CostLimitExceeded);
+          }
+          break;
+        default:
+          break;
+        }
+      } else {
+        if constexpr (decltype(IsCount)::value) {
+          Stat->incInstrCount();
+        }
+        // Add cost. Note: if-else case should be processed additionally.
+        if constexpr (decltype(IsCost)::value) {
+          if (unlikely(!Stat->addInstrCost(PC->getOpCode()))) {
+            const AST::Instruction &Instr = *PC;
+            spdlog::error(
+                ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
+            return Unexpect(ErrCode::Value::CostLimitExceeded);
+          }
         }
       }
+      if (auto Res = Dispatch(); !Res) {
+        return Unexpect(Res);
+      }
+      PC++;
     }
-    if (auto Res = Dispatch(); !Res) {
-      return Unexpect(Res);
+    return {};
+  };
+
+#if WASMEDGE_EXECUTOR_THREADED
+  // Run the instruction loop without statistics in the threaded code. Every
+  // handler of the common instructions ends with its own indirect jump to the
+  // handler of the next instruction, so the jumps are predicted per handler
+  // instead of all from the single jump of the switch.
+  auto RunThreaded = [&Dispatch, &StackMgr, &PC, &PCEnd,
+                      this]() -> Expect<void> {
+    static const void *const Labels[] = {
+        &&Generic,
+#define X(NAME) &&Handle_##NAME,
+        WASMEDGE_THREADED_OPCODES(X)
+#undef X
+    };
+
+#define WASMEDGE_THREADED_NEXT()                                               \
+  if (unlikely(PC == PCEnd)) {                                                 \
+    return {};                                                                 \
+  }                                                                            \
+  goto *Labels[ThreadedHandlers[static_cast<uint32_t>(PC->getOpCode())]]
+// Only the local.get and the comparisons can start the superinstructions, so
+// only their handlers and the generic one check the fused kinds.
+#define WASMEDGE_THREADED_FUSIBLE()                                            \
+  if (PC->getFusedKind() != AST::Instruction::FusedKind::None) {               \
+    goto Fused;                                                                \
+  }
+#define WASMEDGE_THREADED_RUN(EXPR)                                            \
+  if (auto Res = (EXPR); unlikely(!Res)) {                                     \
+    return Unexpect(Res);                                                      \
+  }                                                                            \
+  ++PC;                                                                        \
+  WASMEDGE_THREADED_NEXT()
+#define WASMEDGE_THREADED_BINARY(NAME, OP, T)                                  \
+  Handle_##NAME : {                                                            \
+    ValVariant Rhs = StackMgr.pop();                                           \
+    WASMEDGE_THREADED_RUN(OP<T>(StackMgr.getTop(), Rhs));                      \
+  }
+#define WASMEDGE_THREADED_COMPARE(NAME, OP, T)                                 \
+  Handle_##NAME : {                                                            \
+    WASMEDGE_THREADED_FUSIBLE()                                                \
+    ValVariant Rhs = StackMgr.pop();                                           \
+    WASMEDGE_THREADED_RUN(OP<T>(StackMgr.getTop(), Rhs));                      \
+  }
+
+    WASMEDGE_THREADED_NEXT();
+
+  Generic:
+    WASMEDGE_THREADED_FUSIBLE()
+    WASMEDGE_THREADED_RUN(Dispatch());
+  Fused:
+    WASMEDGE_THREADED_RUN(runFusedOp(StackMgr, PC));
+
+    // Control instructions.
+  Handle_Nop:
+  Handle_Block:
+  Handle_Loop:
+    ++PC;
+    WASMEDGE_THREADED_NEXT();
+  Handle_If:
+    WASMEDGE_THREADED_RUN(runIfElseOp(StackMgr, *PC, PC));
+  Handle_Else:
+    PC += PC->getJumpEnd();
+    WASMEDGE_THREADED_NEXT();
+  Handle_End:
+    PC = StackMgr.maybePopFrameOrHandler(PC);
+    ++PC;
+    WASMEDGE_THREADED_NEXT();
+  Handle_Br:
+    WASMEDGE_THREADED_RUN(runBrOp(StackMgr, *PC, PC));
+  Handle_Br_if:
+    WASMEDGE_THREADED_RUN(runBrIfOp(StackMgr, *PC, PC));
+  Handle_Return:
+    WASMEDGE_THREADED_RUN(runReturnOp(StackMgr, PC));
+  Handle_Call:
+    WASMEDGE_THREADED_RUN(runCallOp(StackMgr, *PC, PC));
+
+    // Parametric and variable instructions.
+  Handle_Drop:
+    StackMgr.pop();
+    ++PC;
+    WASMEDGE_THREADED_NEXT();
+  Handle_Local__get:
+    WASMEDGE_THREADED_FUSIBLE()
+    WASMEDGE_THREADED_RUN(runLocalGetOp(StackMgr, PC->getStackOffset()));
+  Handle_Local__set:
+    WASMEDGE_THREADED_RUN(runLocalSetOp(StackMgr, PC->getStackOffset()));
+  Handle_Local__tee:
+    WASMEDGE_THREADED_RUN(runLocalTeeOp(StackMgr, PC->getStackOffset()));
+  Handle_Global__get:
+    WASMEDGE_THREADED_RUN(runGlobalGetOp(StackMgr, PC->getTargetIndex()));
+  Handle_Global__set:
+    WASMEDGE_THREADED_RUN(runGlobalSetOp(StackMgr, PC->getTargetIndex()));
+
+    // Memory instructions.
+  Handle_I32__load:
+    WASMEDGE_THREADED_RUN(runLoadOp<uint32_t>(
+        StackMgr, *getMemInstByIdx(StackMgr, PC->getTargetIndex()), *PC));
+  Handle_I64__load:
+    WASMEDGE_THREADED_RUN(runLoadOp<uint64_t>(
+        StackMgr, *getMemInstByIdx(StackMgr, PC->getTargetIndex()), *PC));
+  Handle_I32__store:
+    WASMEDGE_THREADED_RUN(runStoreOp<uint32_t>(
+        StackMgr, *getMemInstByIdx(StackMgr, PC->getTargetIndex()), *PC));
+  Handle_I64__store:
+    WASMEDGE_THREADED_RUN(runStoreOp<uint64_t>(
+        StackMgr, *getMemInstByIdx(StackMgr, PC->getTargetIndex()), *PC));
+
+    // Numeric instructions.
+  Handle_I32__const:
+  Handle_I64__const:
+    StackMgr.push(PC->getNum());
+    ++PC;
+    WASMEDGE_THREADED_NEXT();
+  Handle_I32__eqz:
+    WASMEDGE_THREADED_FUSIBLE()
+    WASMEDGE_THREADED_RUN(runEqzOp<uint32_t>(StackMgr.getTop()));
+  Handle_I64__eqz:
+    WASMEDGE_THREADED_FUSIBLE()
+    WASMEDGE_THREADED_RUN(runEqzOp<uint64_t>(StackMgr.getTop()));
+    WASMEDGE_THREADED_COMPARE(I32__eq, runEqOp, uint32_t)
+    WASMEDGE_THREADED_COMPARE(I32__ne, runNeOp, uint32_t)
+    WASMEDGE_THREADED_COMPARE(I32__lt_s, runLtOp, int32_t)
+    WASMEDGE_THREADED_COMPARE(I32__lt_u, runLtOp, uint32_t)
+    WASMEDGE_THREADED_COMPARE(I32__gt_s, runGtOp, int32_t)
+    WASMEDGE_THREADED_COMPARE(I32__gt_u, runGtOp, uint32_t)
+    WASMEDGE_THREADED_COMPARE(I32__le_s, runLeOp, int32_t)
+    WASMEDGE_THREADED_COMPARE(I32__le_u, runLeOp, uint32_t)
+    WASMEDGE_THREADED_COMPARE(I32__ge_s, runGeOp, int32_t)
+    WASMEDGE_THREADED_COMPARE(I32__ge_u, runGeOp, uint32_t)
+    WASMEDGE_THREADED_COMPARE(I64__eq, runEqOp, uint64_t)
+    WASMEDGE_THREADED_COMPARE(I64__ne, runNeOp, uint64_t)
+    WASMEDGE_THREADED_COMPARE(I64__lt_s, runLtOp, int64_t)
+    WASMEDGE_THREADED_COMPARE(I64__lt_u, runLtOp, uint64_t)
+    WASMEDGE_THREADED_BINARY(I32__add, runAddOp, uint32_t)
+    WASMEDGE_THREADED_BINARY(I32__sub, runSubOp, uint32_t)
+    WASMEDGE_THREADED_BINARY(I32__mul, runMulOp, uint32_t)
+    WASMEDGE_THREADED_BINARY(I32__and, runAndOp, uint32_t)
+    WASMEDGE_THREADED_BINARY(I32__or, runOrOp, uint32_t)
+    WASMEDGE_THREADED_BINARY(I32__xor, runXorOp, uint32_t)
+    WASMEDGE_THREADED_BINARY(I32__shl, runShlOp, uint32_t)
+    WASMEDGE_THREADED_BINARY(I32__shr_s, runShrOp, int32_t)
+    WASMEDGE_THREADED_BINARY(I32__shr_u, runShrOp, uint32_t)
+    WASMEDGE_THREADED_BINARY(I64__add, runAddOp, uint64_t)
+    WASMEDGE_THREADED_BINARY(I64__sub, runSubOp, uint64_t)
+    WASMEDGE_THREADED_BINARY(I64__mul, runMulOp, uint64_t)
+
+#undef WASMEDGE_THREADED_COMPARE
+#undef WASMEDGE_THREADED_BINARY
+#undef WASMEDGE_THREADED_FUSIBLE
+#undef WASMEDGE_THREADED_RUN
+#undef WASMEDGE_THREADED_NEXT
+  };
+#endif
+
+  const bool IsCount =
+      Stat && Conf.getStatisticsConfigure().isInstructionCounting();
+  const bool IsCost = Stat && Conf.getStatisticsConfigure().isCostMeasuring();
+  if (likely(!IsCount && !IsCost)) {
+#if WASMEDGE_EXECUTOR_THREADED
+    if (Conf.getRuntimeConfigure().isEnableThreadedInterpreter()) {
+      return RunThreaded();
     }
-    PC++;
+#endif
+    return Run(std::false_type(), std::false_type(), std::false_type());
+  } else if (Conf.getStatisticsConfigure().isBatchedMetering()) {
+    // The batched variant accumulates both, and the flush only charges the
+    // enabled ones.
+    auto Res = Run(std::true_type(), std::true_type(), std::true_type());
+    if (!Flush() && Res) {
+      spdlog::error(ErrCode::Value::CostLimitExceeded);
+      return Unexpect(ErrCode::Value::CostLimitExceeded);
+    }
+    return Res;
+  } else if (!IsCost) {
+    return Run(std::true_type(), std::false_type(), std::false_type());
+  } else if (!IsCount) {
+    return Run(std::false_type(), std::true_type(), std::false_type());
+  } else {
+    return Run(std::true_type(), std::true_type(), std::false_type());
   }
-  return {};
 }
 
 } // namespace Executor
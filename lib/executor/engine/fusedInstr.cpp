@@ -0,0 +1,208 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "executor/executor.h"
+
+#include <cstdint>
+
+namespace WasmEdge {
+namespace Executor {
+
+void Executor::runFusedBinaryOp(OpCode Code, ValVariant &Val1,
+                                const ValVariant &Val2) const noexcept {
+  // The fused operators are validated to be non-trapping.
+  switch (Code) {
+  case OpCode::I32__add:
+    runAddOp<uint32_t>(Val1, Val2);
+    break;
+  case OpCode::I32__sub:
+    runSubOp<uint32_t>(Val1, Val2);
+    break;
+  case OpCode::I32__mul:
+    runMulOp<uint32_t>(Val1, Val2);
+    break;
+  case OpCode::I32__and:
+    runAndOp<uint32_t>(Val1, Val2);
+    break;
+  case OpCode::I32__or:
+    runOrOp<uint32_t>(Val1, Val2);
+    break;
+  case OpCode::I32__xor:
+    runXorOp<uint32_t>(Val1, Val2);
+    break;
+  case OpCode::I32__shl:
+    runShlOp<uint32_t>(Val1, Val2);
+    break;
+  case OpCode::I32__shr_s:
+    runShrOp<int32_t>(Val1, Val2);
+    break;
+  case OpCode::I32__shr_u:
+    runShrOp<uint32_t>(Val1, Val2);
+    break;
+  case OpCode::I64__add:
+    runAddOp<uint64_t>(Val1, Val2);
+    break;
+  case OpCode::I64__sub:
+    runSubOp<uint64_t>(Val1, Val2);
+    break;
+  case OpCode::I64__mul:
+    runMulOp<uint64_t>(Val1, Val2);
+    break;
+  case OpCode::I64__and:
+    runAndOp<uint64_t>(Val1, Val2);
+    break;
+  case OpCode::I64__or:
+    runOrOp<uint64_t>(Val1, Val2);
+    break;
+  case OpCode::I64__xor:
+    runXorOp<uint64_t>(Val1, Val2);
+    break;
+  case OpCode::I64__shl:
+    runShlOp<uint64_t>(Val1, Val2);
+    break;
+  case OpCode::I64__shr_s:
+    runShrOp<int64_t>(Val1, Val2);
+    break;
+  case OpCode::I64__shr_u:
+    runShrOp<uint64_t>(Val1, Val2);
+    break;
+  default:
+    assumingUnreachable();
+  }
+}
+
+bool Executor::runFusedCompareOp(Runtime::StackManager &StackMgr,
+                                 OpCode Code) const noexcept {
+  ValVariant &Val1 = StackMgr.getTop();
+  switch (Code) {
+  case OpCode::I32__eqz:
+    return Val1.get<uint32_t>() == 0;
+  case OpCode::I64__eqz:
+    return Val1.get<uint64_t>() == 0;
+  default:
+    break;
+  }
+  ValVariant Val2 = StackMgr.pop();
+  ValVariant &Lhs = StackMgr.getTop();
+  switch (Code) {
+  case OpCode::I32__eq:
+    runEqOp<uint32_t>(Lhs, Val2);
+    break;
+  case OpCode::I32__ne:
+    runNeOp<uint32_t>(Lhs, Val2);
+    break;
+  case OpCode::I32__lt_s:
+    runLtOp<int32_t>(Lhs, Val2);
+    break;
+  case OpCode::I32__lt_u:
+    runLtOp<uint32_t>(Lhs, Val2);
+    break;
+  case OpCode::I32__gt_s:
+    runGtOp<int32_t>(Lhs, Val2);
+    break;
+  case OpCode::I32__gt_u:
+    runGtOp<uint32_t>(Lhs, Val2);
+    break;
+  case OpCode::I32__le_s:
+    runLeOp<int32_t>(Lhs, Val2);
+    break;
+  case OpCode::I32__le_u:
+    runLeOp<uint32_t>(Lhs, Val2);
+    break;
+  case OpCode::I32__ge_s:
+    runGeOp<int32_t>(Lhs, Val2);
+    break;
+  case OpCode::I32__ge_u:
+    runGeOp<uint32_t>(Lhs, Val2);
+    break;
+  case OpCode::I64__eq:
+    runEqOp<uint64_t>(Lhs, Val2);
+    break;
+  case OpCode::I64__ne:
+    runNeOp<uint64_t>(Lhs, Val2);
+    break;
+  case OpCode::I64__lt_s:
+    runLtOp<int64_t>(Lhs, Val2);
+    break;
+  case OpCode::I64__lt_u:
+    runLtOp<uint64_t>(Lhs, Val2);
+    break;
+  case OpCode::I64__gt_s:
+    runGtOp<int64_t>(Lhs, Val2);
+    break;
+  case OpCode::I64__gt_u:
+    runGtOp<uint64_t>(Lhs, Val2);
+    break;
+  case OpCode::I64__le_s:
+    runLeOp<int64_t>(Lhs, Val2);
+    break;
+  case OpCode::I64__le_u:
+    runLeOp<uint64_t>(Lhs, Val2);
+    break;
+  case OpCode::I64__ge_s:
+    runGeOp<int64_t>(Lhs, Val2);
+    break;
+  case OpCode::I64__ge_u:
+    runGeOp<uint64_t>(Lhs, Val2);
+    break;
+  default:
+    assumingUnreachable();
+  }
+  return Lhs.get<uint32_t>() != 0;
+}
+
+Expect<void> Executor::runFusedOp(Runtime::StackManager &StackMgr,
+                                  AST::InstrView::iterator &PC) noexcept {
+  // The stack offsets of the fused instructions were resolved by the validator
+  // with the intermediate values pushed. The values are not pushed here, so
+  // the offsets after the first instruction are shifted accordingly. The PC
+  // is left on the last instruction of the sequence.
+  using FusedKind = AST::Instruction::FusedKind;
+  switch (PC->getFusedKind()) {
+  case FusedKind::LocalLocalBinOp: {
+    // local.get, local.get, binop
+    ValVariant Val = StackMgr.getTopN(PC[0].getStackOffset());
+    runFusedBinaryOp(PC[2].getOpCode(), Val,
+                     StackMgr.getTopN(PC[1].getStackOffset() - 1));
+    StackMgr.push(Val);
+    PC += 2;
+    return {};
+  }
+  case FusedKind::LocalConstBinOp: {
+    // local.get, const, binop
+    ValVariant Val = StackMgr.getTopN(PC[0].getStackOffset());
+    runFusedBinaryOp(PC[2].getOpCode(), Val, PC[1].getNum());
+    StackMgr.push(Val);
+    PC += 2;
+    return {};
+  }
+  case FusedKind::LocalConstBinOpSet: {
+    // local.get, const, binop, local.set or local.tee
+    ValVariant Val = StackMgr.getTopN(PC[0].getStackOffset());
+    runFusedBinaryOp(PC[2].getOpCode(), Val, PC[1].getNum());
+    if (PC[3].getOpCode() == OpCode::Local__set) {
+      StackMgr.getTopN(PC[3].getStackOffset() - 1) = Val;
+    } else {
+      StackMgr.push(Val);
+      StackMgr.getTopN(PC[3].getStackOffset()) = Val;
+    }
+    PC += 3;
+    return {};
+  }
+  case FusedKind::CompareBrIf: {
+    // relop or eqz, br_if
+    const bool Cond = runFusedCompareOp(StackMgr, PC->getOpCode());
+    StackMgr.pop();
+    PC += 1;
+    if (Cond) {
+      return runBrOp(StackMgr, *PC, PC);
+    }
+    return {};
+  }
+  default:
+    assumingUnreachable();
+  }
+}
+
+} // namespace Executor
+} // namespace WasmEdge
@@ -6,17 +6,42 @@
 namespace WasmEdge {
 namespace Executor {
 
+namespace {
+// Get the address operand, which is i64 for the 64-bit memories.
+uint64_t toAddress(const ValVariant &Val, bool Is64) noexcept {
+  return Is64 ? Val.get<uint64_t>() : Val.get<uint32_t>();
+}
+} // namespace
+
 Expect<void>
 Executor::runMemorySizeOp(Runtime::StackManager &StackMgr,
                           Runtime::Instance::MemoryInstance &MemInst) {
   // Push SZ = page size to stack.
-  StackMgr.push(MemInst.getPageSize());
+  if (MemInst.is64()) {
+    StackMgr.push(MemInst.getPageSize());
+  } else {
+    StackMgr.push(static_cast<uint32_t>(MemInst.getPageSize()));
+  }
   return {};
 }
 
 Expect<void>
 Executor::runMemoryGrowOp(Runtime::StackManager &StackMgr,
                           Runtime::Instance::MemoryInstance &MemInst) {
+  if (MemInst.is64()) {
+    // Pop N for growing page size.
+    uint64_t &N = StackMgr.getTop().get<uint64_t>();
+
+    // Grow page and push result.
+    const uint64_t CurrPageSize = MemInst.getPageSize();
+    if (MemInst.growPage(N)) {
+      N = CurrPageSize;
+    } else {
+      N = static_cast<uint64_t>(-1);
+    }
+    return {};
+  }
+
   // Pop N for growing page size.
   uint32_t &N = StackMgr.getTop().get<uint32_t>();
 
@@ -36,7 +61,7 @@ Expect<void> Executor::runMemoryInitOp(
   // Pop the length, source, and destination from stack.
   uint32_t Len = StackMgr.pop().get<uint32_t>();
   uint32_t Src = StackMgr.pop().get<uint32_t>();
-  uint32_t Dst = StackMgr.pop().get<uint32_t>();
+  uint64_t Dst = toAddress(StackMgr.pop(), MemInst.is64());
 
   // Replace mem[Dst : Dst + Len] with data[Src : Src + Len].
   if (auto Res = MemInst.setBytes(DataInst.getData(), Dst, Src, Len)) {
@@ -61,9 +86,11 @@ Executor::runMemoryCopyOp(Runtime::StackManager &StackMgr,
                           Runtime::Instance::MemoryInstance &MemInstSrc,
                           const AST::Instruction &Instr) {
   // Pop the length, source, and destination from stack.
-  uint32_t Len = StackMgr.pop().get<uint32_t>();
-  uint32_t Src = StackMgr.pop().get<uint32_t>();
-  uint32_t Dst = StackMgr.pop().get<uint32_t>();
+  // The length is i64 only when both memories are 64-bit.
+  uint64_t Len =
+      toAddress(StackMgr.pop(), MemInstDst.is64() && MemInstSrc.is64());
+  uint64_t Src = toAddress(StackMgr.pop(), MemInstSrc.is64());
+  uint64_t Dst = toAddress(StackMgr.pop(), MemInstDst.is64());
 
   // Replace mem[Dst : Dst + Len] with mem[Src : Src + Len].
   if (auto Data = MemInstSrc.getBytes(Src, Len)) {
@@ -86,9 +113,9 @@ Executor::runMemoryFillOp(Runtime::StackManager &StackMgr,
                           Runtime::Instance::MemoryInstance &MemInst,
                           const AST::Instruction &Instr) {
   // Pop the length, value, and offset from stack.
-  uint32_t Len = StackMgr.pop().get<uint32_t>();
+  uint64_t Len = toAddress(StackMgr.pop(), MemInst.is64());
   uint8_t Val = static_cast<uint8_t>(StackMgr.pop().get<uint32_t>());
-  uint32_t Off = StackMgr.pop().get<uint32_t>();
+  uint64_t Off = toAddress(StackMgr.pop(), MemInst.is64());
 
   // Fill data with Val.
   if (auto Res = MemInst.fillBytes(Val, Off, Len)) {
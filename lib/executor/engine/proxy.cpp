@@ -2,9 +2,14 @@
 // SPDX-FileCopyrightText: 2019-2022 Second State INC
 
 #include "executor/executor.h"
+
+#include "common/spdlog.h"
 #include "system/fault.h"
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
+#include <cstring>
 
 namespace WasmEdge {
 namespace Executor {
@@ -12,6 +17,8 @@ namespace Executor {
 thread_local Executor *Executor::This = nullptr;
 thread_local Runtime::StackManager *Executor::CurrentStack = nullptr;
 thread_local Executor::ExecutionContextStruct Executor::ExecutionContext;
+thread_local Executor *Executor::TaskOwner = nullptr;
+thread_local std::atomic_uint32_t *Executor::TaskToken = nullptr;
 
 template <typename RetT, typename... ArgsT>
 struct Executor::ProxyHelper<Expect<RetT> (Executor::*)(Runtime::StackManager &,
@@ -75,6 +82,17 @@ const Executable::IntrinsicsTable Executor::Intrinsics = {
     ENTRY(kMemoryAtomicWait, memoryAtomicWait),
     ENTRY(kCallRef, callRef),
     ENTRY(kRefGetFuncSymbol, refGetFuncSymbol),
+    ENTRY(kStructNew, structNew),
+    ENTRY(kArrayNew, arrayNew),
+    ENTRY(kArrayNewData, arrayNewData),
+    ENTRY(kArrayNewElem, arrayNewElem),
+    ENTRY(kArrayFill, arrayFill),
+    ENTRY(kArrayCopy, arrayCopy),
+    ENTRY(kArrayInitData, arrayInitData),
+    ENTRY(kArrayInitElem, arrayInitElem),
+    ENTRY(kRefTest, refTest),
+    ENTRY(kWriteBarrier, writeBarrier),
+    ENTRY(kSafepoint, safepoint),
 #undef ENTRY
 };
 
@@ -87,23 +105,44 @@ Expect<void> Executor::trap(Runtime::StackManager &,
   return Unexpect(static_cast<ErrCategory>(Code >> 24), Code);
 }
 
-Expect<void> Executor::call(Runtime::StackManager &StackMgr,
-                            const uint32_t FuncIdx, const ValVariant *Args,
-                            ValVariant *Rets) noexcept {
-  const auto *FuncInst = getFuncInstByIdx(StackMgr, FuncIdx);
-  const auto &FuncType = FuncInst->getFuncType();
+Expect<void>
+Executor::callFromCompiled(Runtime::StackManager &StackMgr,
+                           const Runtime::Instance::FunctionInstance &Func,
+                           const ValVariant *Args, ValVariant *Rets) {
+  const auto &FuncType = Func.getFuncType();
   const uint32_t ParamsSize =
       static_cast<uint32_t>(FuncType.getParamTypes().size());
   const uint32_t ReturnsSize =
       static_cast<uint32_t>(FuncType.getReturnTypes().size());
 
+  // Call the host function with the buffers of the compiled caller, without
+  // the frame and the copies through the stack.
+  if (Func.isHostFunction() && ParamsSize <= kHostCallInlineVals) {
+    if (unlikely(getStopToken().exchange(0, std::memory_order_relaxed))) {
+      spdlog::error(ErrCode::Value::Interrupted);
+      return Unexpect(ErrCode::Value::Interrupted);
+    }
+    std::array<ValVariant, kHostCallInlineVals> ArgsBuf;
+    std::copy_n(Args, ParamsSize, ArgsBuf.begin());
+    return callHostFunction(StackMgr.getModule(), Func,
+                            Span<ValVariant>(ArgsBuf.data(), ParamsSize),
+                            Span<ValVariant>(Rets, ReturnsSize));
+  }
+
+  // Load the lazy loaded body for the end of the function body.
+  if (auto Res = Func.loadLazyBody(); !Res) {
+    return Unexpect(Res);
+  }
+  if (auto Res = checkStack(StackMgr, ParamsSize); unlikely(!Res)) {
+    return Unexpect(Res);
+  }
   for (uint32_t I = 0; I < ParamsSize; ++I) {
     StackMgr.push(Args[I]);
   }
 
-  auto Instrs = FuncInst->getInstrs();
+  auto Instrs = Func.getInstrs();
   AST::InstrView::iterator StartIt;
-  if (auto Res = enterFunction(StackMgr, *FuncInst, Instrs.end())) {
+  if (auto Res = enterFunction(StackMgr, Func, Instrs.end())) {
     StartIt = *Res;
   } else {
     return Unexpect(Res);
@@ -119,6 +158,13 @@ Expect<void> Executor::call(Runtime::StackManager &StackMgr,
   return {};
 }
 
+Expect<void> Executor::call(Runtime::StackManager &StackMgr,
+                            const uint32_t FuncIdx, const ValVariant *Args,
+                            ValVariant *Rets) noexcept {
+  const auto *FuncInst = getFuncInstByIdx(StackMgr, FuncIdx);
+  return callFromCompiled(StackMgr, *FuncInst, Args, Rets);
+}
+
 Expect<void *> Executor::tableGetFuncSymbol(Runtime::StackManager &StackMgr,
                                             const uint32_t TableIdx,
                                             const uint32_t FuncTypeIdx,
@@ -202,48 +248,24 @@ Executor::callIndirect(Runtime::StackManager &StackMgr, const uint32_t TableIdx,
     return Unexpect(ErrCode::Value::IndirectCallTypeMismatch);
   }
 
-  const auto &FuncType = FuncInst->getFuncType();
-  const uint32_t ParamsSize =
-      static_cast<uint32_t>(FuncType.getParamTypes().size());
-  const uint32_t ReturnsSize =
-      static_cast<uint32_t>(FuncType.getReturnTypes().size());
-
-  for (uint32_t I = 0; I < ParamsSize; ++I) {
-    StackMgr.push(Args[I]);
-  }
-
-  auto Instrs = FuncInst->getInstrs();
-  AST::InstrView::iterator StartIt;
-  if (auto Res = enterFunction(StackMgr, *FuncInst, Instrs.end())) {
-    StartIt = *Res;
-  } else {
-    return Unexpect(Res);
-  }
-  if (auto Res = execute(StackMgr, StartIt, Instrs.end()); unlikely(!Res)) {
-    return Unexpect(Res);
-  }
-
-  for (uint32_t I = 0; I < ReturnsSize; ++I) {
-    Rets[ReturnsSize - 1 - I] = StackMgr.pop();
-  }
-
-  return {};
+  return callFromCompiled(StackMgr, *FuncInst, Args, Rets);
 }
 
-Expect<uint32_t> Executor::memGrow(Runtime::StackManager &StackMgr,
+Expect<uint64_t> Executor::memGrow(Runtime::StackManager &StackMgr,
                                    const uint32_t MemIdx,
-                                   const uint32_t NewSize) noexcept {
+                                   const uint64_t NewSize) noexcept {
   auto *MemInst = getMemInstByIdx(StackMgr, MemIdx);
   assuming(MemInst);
-  const uint32_t CurrPageSize = MemInst->getPageSize();
+  // The compiled code truncates the result of the 32-bit memories.
+  const uint64_t CurrPageSize = MemInst->getPageSize();
   if (MemInst->growPage(NewSize)) {
     return CurrPageSize;
   } else {
-    return static_cast<uint32_t>(-1);
+    return static_cast<uint64_t>(-1);
   }
 }
 
-Expect<uint32_t> Executor::memSize(Runtime::StackManager &StackMgr,
+Expect<uint64_t> Executor::memSize(Runtime::StackManager &StackMgr,
                                    const uint32_t MemIdx) noexcept {
   auto *MemInst = getMemInstByIdx(StackMgr, MemIdx);
   assuming(MemInst);
@@ -252,9 +274,9 @@ Expect<uint32_t> Executor::memSize(Runtime::StackManager &StackMgr,
 
 Expect<void> Executor::memCopy(Runtime::StackManager &StackMgr,
                                const uint32_t DstMemIdx,
-                               const uint32_t SrcMemIdx, const uint32_t DstOff,
-                               const uint32_t SrcOff,
-                               const uint32_t Len) noexcept {
+                               const uint32_t SrcMemIdx, const uint64_t DstOff,
+                               const uint64_t SrcOff,
+                               const uint64_t Len) noexcept {
   auto *MemInstDst = getMemInstByIdx(StackMgr, DstMemIdx);
   assuming(MemInstDst);
   auto *MemInstSrc = getMemInstByIdx(StackMgr, SrcMemIdx);
@@ -273,8 +295,8 @@ Expect<void> Executor::memCopy(Runtime::StackManager &StackMgr,
 }
 
 Expect<void> Executor::memFill(Runtime::StackManager &StackMgr,
-                               const uint32_t MemIdx, const uint32_t Off,
-                               const uint8_t Val, const uint32_t Len) noexcept {
+                               const uint32_t MemIdx, const uint64_t Off,
+                               const uint8_t Val, const uint64_t Len) noexcept {
   auto *MemInst = getMemInstByIdx(StackMgr, MemIdx);
   assuming(MemInst);
   if (auto Res = MemInst->fillBytes(Val, Off, Len); unlikely(!Res)) {
@@ -286,7 +308,7 @@ Expect<void> Executor::memFill(Runtime::StackManager &StackMgr,
 
 Expect<void> Executor::memInit(Runtime::StackManager &StackMgr,
                                const uint32_t MemIdx, const uint32_t DataIdx,
-                               const uint32_t DstOff, const uint32_t SrcOff,
+                               const uint64_t DstOff, const uint32_t SrcOff,
                                const uint32_t Len) noexcept {
   auto *MemInst = getMemInstByIdx(StackMgr, MemIdx);
   assuming(MemInst);
@@ -425,7 +447,7 @@ Expect<RefVariant> Executor::refFunc(Runtime::StackManager &StackMgr,
 
 Expect<uint32_t> Executor::memoryAtomicNotify(Runtime::StackManager &StackMgr,
                                               const uint32_t MemIdx,
-                                              const uint32_t Offset,
+                                              const uint64_t Offset,
                                               const uint32_t Count) noexcept {
   auto *MemInst = getMemInstByIdx(StackMgr, MemIdx);
   assuming(MemInst);
@@ -435,7 +457,7 @@ Expect<uint32_t> Executor::memoryAtomicNotify(Runtime::StackManager &StackMgr,
 
 Expect<uint32_t> Executor::memoryAtomicWait(Runtime::StackManager &StackMgr,
                                             const uint32_t MemIdx,
-                                            const uint32_t Offset,
+                                            const uint64_t Offset,
                                             const uint64_t Expected,
                                             const int64_t Timeout,
                                             const uint32_t BitWidth) noexcept {
@@ -456,42 +478,130 @@ Expect<void> Executor::callRef(Runtime::StackManager &StackMgr,
                                const RefVariant Ref, const ValVariant *Args,
                                ValVariant *Rets) noexcept {
   const auto *FuncInst = retrieveFuncRef(Ref);
-  const auto &FuncType = FuncInst->getFuncType();
-  const uint32_t ParamsSize =
-      static_cast<uint32_t>(FuncType.getParamTypes().size());
-  const uint32_t ReturnsSize =
-      static_cast<uint32_t>(FuncType.getReturnTypes().size());
+  return callFromCompiled(StackMgr, *FuncInst, Args, Rets);
+}
 
-  for (uint32_t I = 0; I < ParamsSize; ++I) {
-    StackMgr.push(Args[I]);
+Expect<void *> Executor::refGetFuncSymbol(Runtime::StackManager &,
+                                          const RefVariant Ref) noexcept {
+  const auto *FuncInst = retrieveFuncRef(Ref);
+  assuming(FuncInst);
+  if (unlikely(!FuncInst->isCompiledFunction())) {
+    return nullptr;
   }
+  return FuncInst->getSymbol().get();
+}
 
-  auto Instrs = FuncInst->getInstrs();
-  AST::InstrView::iterator StartIt;
-  if (auto Res = enterFunction(StackMgr, *FuncInst, Instrs.end())) {
-    StartIt = *Res;
-  } else {
-    return Unexpect(Res);
+Expect<RefVariant> Executor::structNew(Runtime::StackManager &StackMgr,
+                                       const uint32_t TypeIdx) noexcept {
+  // The fields are stored by the compiled code after the allocation.
+  auto *Inst = Collector::getInstance().newStruct(StackMgr, TypeIdx);
+  if (unlikely(Inst == nullptr)) {
+    return Unexpect(ErrCode::Value::OutOfMemory);
   }
-  if (auto Res = execute(StackMgr, StartIt, Instrs.end()); unlikely(!Res)) {
+  return RefVariant(Inst->getDefType(), Inst);
+}
+
+Expect<RefVariant> Executor::arrayNew(Runtime::StackManager &StackMgr,
+                                      const uint32_t TypeIdx,
+                                      const uint32_t Length,
+                                      const ValVariant *InitVals,
+                                      const uint32_t InitCnt) noexcept {
+  assuming(InitCnt == 0 || InitCnt == 1 || InitCnt == Length);
+  auto Res = allocArray(StackMgr, TypeIdx, Length);
+  if (unlikely(!Res)) {
     return Unexpect(Res);
   }
-
-  for (uint32_t I = 0; I < ReturnsSize; ++I) {
-    Rets[ReturnsSize - 1 - I] = StackMgr.pop();
+  auto *Inst = *Res;
+  if (InitCnt == 0) {
+    const auto &Defaults = Inst->getLayout().Defaults;
+    ValVariant InitVal = static_cast<uint128_t>(0);
+    std::memcpy(&InitVal, Defaults.data(), Defaults.size());
+    Inst->fill(0, Length, InitVal);
+  } else if (InitCnt == 1) {
+    Inst->fill(0, Length, InitVals[0]);
+  } else {
+    for (uint32_t I = 0; I < Length; I++) {
+      Inst->setData(I, InitVals[I]);
+    }
   }
+  return RefVariant(Inst->getDefType(), Inst);
+}
+
+Expect<RefVariant> Executor::arrayNewData(Runtime::StackManager &StackMgr,
+                                          const uint32_t TypeIdx,
+                                          const uint32_t DataIdx,
+                                          const uint32_t Off,
+                                          const uint32_t Len) noexcept {
+  auto *DataInst = getDataInstByIdx(StackMgr, DataIdx);
+  assuming(DataInst);
+  return newArrayFromData(StackMgr, TypeIdx, *DataInst, Off, Len);
+}
+
+Expect<RefVariant> Executor::arrayNewElem(Runtime::StackManager &StackMgr,
+                                          const uint32_t TypeIdx,
+                                          const uint32_t ElemIdx,
+                                          const uint32_t Off,
+                                          const uint32_t Len) noexcept {
+  auto *ElemInst = getElemInstByIdx(StackMgr, ElemIdx);
+  assuming(ElemInst);
+  return newArrayFromElem(StackMgr, TypeIdx, *ElemInst, Off, Len);
+}
+
+Expect<void> Executor::arrayFill(Runtime::StackManager &,
+                                 const RefVariant Ref, const uint32_t Off,
+                                 const ValVariant *Val,
+                                 const uint32_t Len) noexcept {
+  return fillArray(Ref, Off, Len, *Val);
+}
+
+Expect<void> Executor::arrayCopy(Runtime::StackManager &,
+                                 const RefVariant DstRef, const uint32_t DstOff,
+                                 const RefVariant SrcRef, const uint32_t SrcOff,
+                                 const uint32_t Len) noexcept {
+  return copyArray(DstRef, DstOff, SrcRef, SrcOff, Len);
+}
+
+Expect<void> Executor::arrayInitData(Runtime::StackManager &StackMgr,
+                                     const uint32_t DataIdx,
+                                     const RefVariant Ref,
+                                     const uint32_t DstOff,
+                                     const uint32_t SrcOff,
+                                     const uint32_t Len) noexcept {
+  auto *DataInst = getDataInstByIdx(StackMgr, DataIdx);
+  assuming(DataInst);
+  return initArrayFromData(Ref, DstOff, *DataInst, SrcOff, Len);
+}
+
+Expect<void> Executor::arrayInitElem(Runtime::StackManager &StackMgr,
+                                     const uint32_t ElemIdx,
+                                     const RefVariant Ref,
+                                     const uint32_t DstOff,
+                                     const uint32_t SrcOff,
+                                     const uint32_t Len) noexcept {
+  auto *ElemInst = getElemInstByIdx(StackMgr, ElemIdx);
+  assuming(ElemInst);
+  return initArrayFromElem(Ref, DstOff, *ElemInst, SrcOff, Len);
+}
+
+Expect<uint32_t> Executor::refTest(Runtime::StackManager &StackMgr,
+                                   const RefVariant Ref, const uint32_t HTCode,
+                                   const uint32_t TypeIdx) noexcept {
+  // The null references are handled in the compiled code, so the nullability
+  // of the type does not matter here.
+  const ValType Type(TypeCode::Ref, static_cast<TypeCode>(HTCode), TypeIdx);
+  return matchRefType(StackMgr.getModule(), Type, Ref) ? 1U : 0U;
+}
 
+Expect<void> Executor::writeBarrier(Runtime::StackManager &,
+                                    void *Obj) noexcept {
+  Collector::getInstance().writeBarrier(
+      *static_cast<Runtime::Instance::GCObject *>(Obj));
   return {};
 }
 
-Expect<void *> Executor::refGetFuncSymbol(Runtime::StackManager &,
-                                          const RefVariant Ref) noexcept {
-  const auto *FuncInst = retrieveFuncRef(Ref);
-  assuming(FuncInst);
-  if (unlikely(!FuncInst->isCompiledFunction())) {
-    return nullptr;
-  }
-  return FuncInst->getSymbol().get();
+Expect<void> Executor::safepoint(Runtime::StackManager &) noexcept {
+  Collector::safepoint();
+  return {};
 }
 
 } // namespace Executor
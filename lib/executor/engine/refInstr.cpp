@@ -3,57 +3,11 @@
 
 #include "executor/executor.h"
 
+#include <cstring>
+
 namespace WasmEdge {
 namespace Executor {
 
-namespace {
-ValVariant packVal(const ValType &Type, const ValVariant &Val) {
-  if (Type.isPackType()) {
-    switch (Type.getCode()) {
-    case TypeCode::I8:
-      return ValVariant(Val.get<uint32_t>() & 0xFFU);
-    case TypeCode::I16:
-      return ValVariant(Val.get<uint32_t>() & 0xFFFFU);
-    default:
-      assumingUnreachable();
-    }
-  }
-  return Val;
-}
-
-ValVariant unpackVal(const ValType &Type, const ValVariant &Val,
-                     bool IsSigned = false) {
-  if (Type.isPackType()) {
-    uint32_t Num = Val.get<uint32_t>();
-    switch (Type.getCode()) {
-    case TypeCode::I8:
-      if (IsSigned) {
-        return static_cast<uint32_t>(static_cast<int8_t>(Num));
-      } else {
-        return static_cast<uint32_t>(static_cast<uint8_t>(Num));
-      }
-    case TypeCode::I16:
-      if (IsSigned) {
-        return static_cast<uint32_t>(static_cast<int16_t>(Num));
-      } else {
-        return static_cast<uint32_t>(static_cast<uint16_t>(Num));
-      }
-    default:
-      assumingUnreachable();
-    }
-  }
-  return Val;
-}
-
-std::vector<ValVariant> packVals(const ValType &Type,
-                                 std::vector<ValVariant> &&Vals) {
-  for (uint32_t I = 0; I < Vals.size(); I++) {
-    Vals[I] = packVal(Type, Vals[I]);
-  }
-  return std::move(Vals);
-}
-} // namespace
-
 Expect<void> Executor::runRefNullOp(Runtime::StackManager &StackMgr,
                                     const ValType &Type) const noexcept {
   // A null reference is typed with the least type in its respective hierarchy.
@@ -98,37 +52,26 @@ Executor::runRefAsNonNullOp(RefVariant &Ref,
 Expect<void> Executor::runStructNewOp(Runtime::StackManager &StackMgr,
                                       const uint32_t DefIndex,
                                       bool IsDefault) const noexcept {
-  /// TODO: The array and struct instances are owned by the module instance
-  /// currently because of referring the defined types of the module instances.
-  /// This may be changed after applying the garbage collection mechanism.
-  const auto &CompType =
-      getDefTypeByIdx(StackMgr, DefIndex)->getCompositeType();
-  uint32_t N = static_cast<uint32_t>(CompType.getFieldTypes().size());
-  std::vector<WasmEdge::ValVariant> Vals;
-  if (IsDefault) {
-    Vals.resize(N);
-    for (uint32_t I = 0; I < N; I++) {
-      const auto &VType = CompType.getFieldTypes()[I].getStorageType();
-      Vals[I] = VType.isRefType()
-                    ? ValVariant(RefVariant(toBottomType(StackMgr, VType)))
-                    : ValVariant(static_cast<uint128_t>(0));
-    }
-  } else {
-    Vals = StackMgr.pop(N);
+  // Allocate before popping the field values, which keeps the values reachable
+  // from the value stack during the collection.
+  auto *Inst = Collector::getInstance().newStruct(StackMgr, DefIndex);
+  if (unlikely(Inst == nullptr)) {
+    spdlog::error(ErrCode::Value::OutOfMemory);
+    return Unexpect(ErrCode::Value::OutOfMemory);
+  }
+  if (!IsDefault) {
+    const auto N = static_cast<uint32_t>(Inst->getLayout().Types.size());
+    auto Vals = StackMgr.getTopSpan(N);
     for (uint32_t I = 0; I < N; I++) {
-      Vals[I] = packVal(CompType.getFieldTypes()[I].getStorageType(), Vals[I]);
+      Inst->setField(I, Vals[I]);
     }
+    StackMgr.eraseValueStack(N, 0);
   }
-  auto *Inst =
-      const_cast<Runtime::Instance::ModuleInstance *>(StackMgr.getModule())
-          ->newStruct(DefIndex, std::move(Vals));
   StackMgr.push(RefVariant(Inst->getDefType(), Inst));
-
   return {};
 }
 
 Expect<void> Executor::runStructGetOp(ValVariant &Val, const uint32_t Idx,
-                                      const AST::CompositeType &CompType,
                                       const AST::Instruction &Instr,
                                       bool IsSigned) const noexcept {
   const auto *Inst =
@@ -139,14 +82,13 @@ Expect<void> Executor::runStructGetOp(ValVariant &Val, const uint32_t Idx,
         ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
     return Unexpect(ErrCode::Value::AccessNullStruct);
   }
-  const auto &SType = CompType.getFieldTypes()[Idx].getStorageType();
-  Val = unpackVal(SType, Inst->getField(Idx), IsSigned);
+  Val = Inst->getField(Idx, IsSigned);
   return {};
 }
 
 Expect<void>
 Executor::runStructSetOp(const ValVariant &Val, const RefVariant &InstRef,
-                         const AST::CompositeType &CompType, uint32_t Idx,
+                         uint32_t Idx,
                          const AST::Instruction &Instr) const noexcept {
   auto *Inst = InstRef.getPtr<Runtime::Instance::StructInstance>();
   if (Inst == nullptr) {
@@ -155,38 +97,42 @@ Executor::runStructSetOp(const ValVariant &Val, const RefVariant &InstRef,
         ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
     return Unexpect(ErrCode::Value::AccessNullStruct);
   }
-  const auto &SType = CompType.getFieldTypes()[Idx].getStorageType();
-  Inst->getField(Idx) = packVal(SType, Val);
+  if (Inst->getLayout().Types[Idx].isRefType()) {
+    Collector::getInstance().writeBarrier(*Inst);
+  }
+  Inst->setField(Idx, Val);
   return {};
 }
 
 Expect<void> Executor::runArrayNewOp(Runtime::StackManager &StackMgr,
                                      const uint32_t DefIndex, uint32_t InitCnt,
-                                     uint32_t ValCnt) const noexcept {
-  /// TODO: The array and struct instances are owned by the module instance
-  /// currently because of referring the defined types of the module instances.
-  /// This may be changed after applying the garbage collection mechanism.
+                                     uint32_t ValCnt,
+                                     const AST::Instruction &Instr) const noexcept {
   assuming(InitCnt == 0 || InitCnt == 1 || InitCnt == ValCnt);
-  const auto &CompType =
-      getDefTypeByIdx(StackMgr, DefIndex)->getCompositeType();
-  const auto &VType = CompType.getFieldTypes()[0].getStorageType();
+  // Allocate before popping the initial values, which keeps the values
+  // reachable from the value stack during the collection.
+  auto Res = allocArray(StackMgr, DefIndex, ValCnt);
+  if (unlikely(!Res)) {
+    spdlog::error(
+        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
+    return Unexpect(Res);
+  }
+  auto *Inst = *Res;
   if (InitCnt == 0) {
-    auto InitVal = VType.isRefType()
-                       ? ValVariant(RefVariant(toBottomType(StackMgr, VType)))
-                       : ValVariant(static_cast<uint128_t>(0));
-    auto *Inst =
-        const_cast<Runtime::Instance::ModuleInstance *>(StackMgr.getModule())
-            ->newArray(DefIndex, ValCnt, InitVal);
+    const auto &Defaults = Inst->getLayout().Defaults;
+    ValVariant InitVal = static_cast<uint128_t>(0);
+    std::memcpy(&InitVal, Defaults.data(), Defaults.size());
+    Inst->fill(0, ValCnt, InitVal);
     StackMgr.push(RefVariant(Inst->getDefType(), Inst));
   } else if (InitCnt == 1) {
-    auto *Inst =
-        const_cast<Runtime::Instance::ModuleInstance *>(StackMgr.getModule())
-            ->newArray(DefIndex, ValCnt, packVal(VType, StackMgr.getTop()));
+    Inst->fill(0, ValCnt, StackMgr.getTop());
     StackMgr.getTop().emplace<RefVariant>(Inst->getDefType(), Inst);
   } else {
-    auto *Inst =
-        const_cast<Runtime::Instance::ModuleInstance *>(StackMgr.getModule())
-            ->newArray(DefIndex, packVals(VType, StackMgr.pop(ValCnt)));
+    auto Vals = StackMgr.getTopSpan(ValCnt);
+    for (uint32_t I = 0; I < ValCnt; I++) {
+      Inst->setData(I, Vals[I]);
+    }
+    StackMgr.eraseValueStack(ValCnt, 0);
     StackMgr.push(RefVariant(Inst->getDefType(), Inst));
   }
   return {};
@@ -198,33 +144,13 @@ Executor::runArrayNewDataOp(Runtime::StackManager &StackMgr,
                             const AST::Instruction &Instr) const noexcept {
   const uint32_t N = StackMgr.pop().get<uint32_t>();
   const uint32_t S = StackMgr.getTop().get<uint32_t>();
-  const auto &CompType =
-      getDefTypeByIdx(StackMgr, Instr.getTargetIndex())->getCompositeType();
-  const uint32_t BSize =
-      CompType.getFieldTypes()[0].getStorageType().getBitWidth() / 8;
-  if (static_cast<uint64_t>(S) + static_cast<uint64_t>(N) * BSize >
-      DataInst.getData().size()) {
-    spdlog::error(ErrCode::Value::MemoryOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(
-        static_cast<uint64_t>(S), N * BSize,
-        DataInst.getData().size() > 0
-            ? static_cast<uint32_t>(DataInst.getData().size() - 1)
-            : 0U));
+  auto Res = newArrayFromData(StackMgr, Instr.getTargetIndex(), DataInst, S, N);
+  if (unlikely(!Res)) {
     spdlog::error(
         ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::MemoryOutOfBounds);
+    return Unexpect(Res);
   }
-  /// TODO: The array and struct instances are owned by the module instance
-  /// currently because of referring the defined types of the module instances.
-  /// This may be changed after applying the garbage collection mechanism.
-  auto *Inst =
-      const_cast<Runtime::Instance::ModuleInstance *>(StackMgr.getModule())
-          ->newArray(Instr.getTargetIndex(), N, 0U);
-  for (uint32_t Idx = 0; Idx < N; Idx++) {
-    // The value has been packed.
-    Inst->getData(Idx) = DataInst.loadValue(S + Idx * BSize, BSize);
-  }
-  StackMgr.getTop().emplace<RefVariant>(Inst->getDefType(), Inst);
+  StackMgr.getTop().emplace<RefVariant>(*Res);
   return {};
 }
 
@@ -234,34 +160,19 @@ Executor::runArrayNewElemOp(Runtime::StackManager &StackMgr,
                             const AST::Instruction &Instr) const noexcept {
   const uint32_t N = StackMgr.pop().get<uint32_t>();
   const uint32_t S = StackMgr.getTop().get<uint32_t>();
-  const auto &CompType =
-      getDefTypeByIdx(StackMgr, Instr.getTargetIndex())->getCompositeType();
-  const auto &SType = CompType.getFieldTypes()[0].getStorageType();
-  auto ElemSrc = ElemInst.getRefs();
-  if (static_cast<uint64_t>(S) + static_cast<uint64_t>(N) > ElemSrc.size()) {
-    spdlog::error(ErrCode::Value::TableOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(
-        static_cast<uint64_t>(S), N,
-        ElemSrc.size() > 0 ? static_cast<uint32_t>(ElemSrc.size() - 1) : 0U));
+  auto Res = newArrayFromElem(StackMgr, Instr.getTargetIndex(), ElemInst, S, N);
+  if (unlikely(!Res)) {
     spdlog::error(
         ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::TableOutOfBounds);
+    return Unexpect(Res);
   }
-  std::vector<ValVariant> Refs(ElemSrc.begin() + S, ElemSrc.begin() + S + N);
-  /// TODO: The array and struct instances are owned by the module instance
-  /// currently because of referring the defined types of the module instances.
-  /// This may be changed after applying the garbage collection mechanism.
-  auto *Inst =
-      const_cast<Runtime::Instance::ModuleInstance *>(StackMgr.getModule())
-          ->newArray(Instr.getTargetIndex(), packVals(SType, std::move(Refs)));
-  StackMgr.getTop().emplace<RefVariant>(Inst->getDefType(), Inst);
+  StackMgr.getTop().emplace<RefVariant>(*Res);
   return {};
 }
 
 Expect<void>
 Executor::runArraySetOp(const ValVariant &Val, const uint32_t Idx,
                         const RefVariant &InstRef,
-                        const AST::CompositeType &CompType,
                         const AST::Instruction &Instr) const noexcept {
   auto *Inst = InstRef.getPtr<Runtime::Instance::ArrayInstance>();
   if (Inst == nullptr) {
@@ -277,13 +188,14 @@ Executor::runArraySetOp(const ValVariant &Val, const uint32_t Idx,
         ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
     return Unexpect(ErrCode::Value::ArrayOutOfBounds);
   }
-  const auto &SType = CompType.getFieldTypes()[0].getStorageType();
-  Inst->getData(Idx) = packVal(SType, Val);
+  if (Inst->getLayout().Types[0].isRefType()) {
+    Collector::getInstance().writeBarrier(*Inst);
+  }
+  Inst->setData(Idx, Val);
   return {};
 }
 
 Expect<void> Executor::runArrayGetOp(ValVariant &Val, const uint32_t Idx,
-                                     const AST::CompositeType &CompType,
                                      const AST::Instruction &Instr,
                                      bool IsSigned) const noexcept {
   const auto *Inst =
@@ -301,8 +213,7 @@ Expect<void> Executor::runArrayGetOp(ValVariant &Val, const uint32_t Idx,
         ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
     return Unexpect(ErrCode::Value::ArrayOutOfBounds);
   }
-  const auto &SType = CompType.getFieldTypes()[0].getStorageType();
-  Val = unpackVal(SType, Inst->getData(Idx), IsSigned);
+  Val = Inst->getData(Idx, IsSigned);
   return {};
 }
 
@@ -324,77 +235,23 @@ Executor::runArrayLenOp(ValVariant &Val,
 Expect<void>
 Executor::runArrayFillOp(uint32_t N, const ValVariant &Val, uint32_t D,
                          const RefVariant &InstRef,
-                         const AST::CompositeType &CompType,
                          const AST::Instruction &Instr) const noexcept {
-  auto *Inst = InstRef.getPtr<Runtime::Instance::ArrayInstance>();
-  if (Inst == nullptr) {
-    spdlog::error(ErrCode::Value::AccessNullArray);
+  if (auto Res = fillArray(InstRef, D, N, Val); unlikely(!Res)) {
     spdlog::error(
         ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::AccessNullArray);
+    return Unexpect(Res);
   }
-  if (static_cast<uint64_t>(D) + static_cast<uint64_t>(N) > Inst->getLength()) {
-    spdlog::error(ErrCode::Value::ArrayOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(static_cast<uint64_t>(D), N,
-                                        Inst->getBoundIdx()));
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::ArrayOutOfBounds);
-  }
-  const auto &SType = CompType.getFieldTypes()[0].getStorageType();
-  auto Arr = Inst->getArray();
-  std::fill(Arr.begin() + D, Arr.begin() + D + N, packVal(SType, Val));
   return {};
 }
 
 Expect<void>
 Executor::runArrayCopyOp(uint32_t N, uint32_t S, const RefVariant &SrcInstRef,
                          uint32_t D, const RefVariant &DstInstRef,
-                         const AST::CompositeType &SrcCompType,
-                         const AST::CompositeType &DstCompType,
                          const AST::Instruction &Instr) const noexcept {
-  auto *SrcInst = SrcInstRef.getPtr<Runtime::Instance::ArrayInstance>();
-  auto *DstInst = DstInstRef.getPtr<Runtime::Instance::ArrayInstance>();
-  if (SrcInst == nullptr || DstInst == nullptr) {
-    spdlog::error(ErrCode::Value::AccessNullArray);
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::AccessNullArray);
-  }
-  if (static_cast<uint64_t>(S) + static_cast<uint64_t>(N) >
-      SrcInst->getLength()) {
-    spdlog::error(ErrCode::Value::ArrayOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(static_cast<uint64_t>(S), N,
-                                        SrcInst->getBoundIdx()));
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::ArrayOutOfBounds);
-  }
-  if (static_cast<uint64_t>(D) + static_cast<uint64_t>(N) >
-      DstInst->getLength()) {
-    spdlog::error(ErrCode::Value::ArrayOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(static_cast<uint64_t>(D), N,
-                                        DstInst->getBoundIdx()));
+  if (auto Res = copyArray(DstInstRef, D, SrcInstRef, S, N); unlikely(!Res)) {
     spdlog::error(
         ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::ArrayOutOfBounds);
-  }
-  const auto &SrcSType = SrcCompType.getFieldTypes()[0].getStorageType();
-  const auto &DstSType = DstCompType.getFieldTypes()[0].getStorageType();
-  auto SrcArr = SrcInst->getArray();
-  auto DstArr = DstInst->getArray();
-  if (D <= S) {
-    std::transform(SrcArr.begin() + S, SrcArr.begin() + S + N,
-                   DstArr.begin() + D, [&](const ValVariant &V) {
-                     return packVal(DstSType, unpackVal(SrcSType, V));
-                   });
-  } else {
-    std::transform(std::make_reverse_iterator(SrcArr.begin() + S + N),
-                   std::make_reverse_iterator(SrcArr.begin() + S),
-                   std::make_reverse_iterator(DstArr.begin() + D + N),
-                   [&](const ValVariant &V) {
-                     return packVal(DstSType, unpackVal(SrcSType, V));
-                   });
+    return Unexpect(Res);
   }
   return {};
 }
@@ -402,41 +259,13 @@ Executor::runArrayCopyOp(uint32_t N, uint32_t S, const RefVariant &SrcInstRef,
 Expect<void>
 Executor::runArrayInitDataOp(uint32_t N, uint32_t S, uint32_t D,
                              const RefVariant &InstRef,
-                             const AST::CompositeType &CompType,
                              const Runtime::Instance::DataInstance &DataInst,
                              const AST::Instruction &Instr) const noexcept {
-  const uint32_t BSize =
-      CompType.getFieldTypes()[0].getStorageType().getBitWidth() / 8;
-  auto *Inst = InstRef.getPtr<Runtime::Instance::ArrayInstance>();
-  if (Inst == nullptr) {
-    spdlog::error(ErrCode::Value::AccessNullArray);
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::AccessNullArray);
-  }
-  if (static_cast<uint64_t>(D) + static_cast<uint64_t>(N) > Inst->getLength()) {
-    spdlog::error(ErrCode::Value::ArrayOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(static_cast<uint64_t>(D), N,
-                                        Inst->getBoundIdx()));
+  if (auto Res = initArrayFromData(InstRef, D, DataInst, S, N);
+      unlikely(!Res)) {
     spdlog::error(
         ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::ArrayOutOfBounds);
-  }
-  if (static_cast<uint64_t>(S) + static_cast<uint64_t>(N) * BSize >
-      DataInst.getData().size()) {
-    spdlog::error(ErrCode::Value::MemoryOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(
-        static_cast<uint64_t>(S), N * BSize,
-        DataInst.getData().size() > 0
-            ? static_cast<uint32_t>(DataInst.getData().size() - 1)
-            : 0U));
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::MemoryOutOfBounds);
-  }
-  for (uint32_t Off = 0; Off < N; Off++) {
-    // The value has been packed.
-    Inst->getData(D + Off) = DataInst.loadValue(S + Off * BSize, BSize);
+    return Unexpect(Res);
   }
   return {};
 }
@@ -444,40 +273,14 @@ Executor::runArrayInitDataOp(uint32_t N, uint32_t S, uint32_t D,
 Expect<void>
 Executor::runArrayInitElemOp(uint32_t N, uint32_t S, uint32_t D,
                              const RefVariant &InstRef,
-                             const AST::CompositeType &CompType,
                              const Runtime::Instance::ElementInstance &ElemInst,
                              const AST::Instruction &Instr) const noexcept {
-  auto ElemSrc = ElemInst.getRefs();
-  auto *Inst = InstRef.getPtr<Runtime::Instance::ArrayInstance>();
-  if (Inst == nullptr) {
-    spdlog::error(ErrCode::Value::AccessNullArray);
+  if (auto Res = initArrayFromElem(InstRef, D, ElemInst, S, N);
+      unlikely(!Res)) {
     spdlog::error(
         ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::AccessNullArray);
+    return Unexpect(Res);
   }
-  if (static_cast<uint64_t>(D) + static_cast<uint64_t>(N) > Inst->getLength()) {
-    spdlog::error(ErrCode::Value::ArrayOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(static_cast<uint64_t>(D), N,
-                                        Inst->getBoundIdx()));
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::ArrayOutOfBounds);
-  }
-  if (static_cast<uint64_t>(S) + static_cast<uint64_t>(N) > ElemSrc.size()) {
-    spdlog::error(ErrCode::Value::TableOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(
-        static_cast<uint64_t>(S), N,
-        ElemSrc.size() > 0 ? static_cast<uint32_t>(ElemSrc.size() - 1) : 0U));
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::TableOutOfBounds);
-  }
-  const auto &SType = CompType.getFieldTypes()[0].getStorageType();
-
-  auto Arr = Inst->getArray();
-  // The value has been packed.
-  std::transform(ElemSrc.begin() + S, ElemSrc.begin() + S + N, Arr.begin() + D,
-                 [&](const RefVariant &V) { return packVal(SType, V); });
   return {};
 }
 
@@ -485,31 +288,15 @@ Expect<void>
 Executor::runRefTestOp(const Runtime::Instance::ModuleInstance *ModInst,
                        ValVariant &Val, const AST::Instruction &Instr,
                        bool IsCast) const noexcept {
-  // Copy the value type here due to handling the externalized case.
-  auto &VT = Val.get<RefVariant>().getType();
-  if (VT.isExternalized()) {
-    VT = ValType(TypeCode::Ref, TypeCode::ExternRef);
-  }
-  Span<const AST::SubType *const> GotTypeList = ModInst->getTypeList();
-  if (!VT.isAbsHeapType()) {
-    auto *Inst =
-        Val.get<RefVariant>().getPtr<Runtime::Instance::CompositeBase>();
-    // Reference must not be nullptr here because the null references are typed
-    // with the least abstract heap type.
-    if (Inst->getModule()) {
-      GotTypeList = Inst->getModule()->getTypeList();
-    }
-  }
-
-  if (AST::TypeMatcher::matchType(ModInst->getTypeList(), Instr.getValType(),
-                                  GotTypeList, VT)) {
+  if (matchRefType(ModInst, Instr.getValType(), Val.get<RefVariant>())) {
     if (!IsCast) {
       Val.emplace<uint32_t>(1U);
     }
   } else {
     if (IsCast) {
       spdlog::error(ErrCode::Value::CastFailed);
-      spdlog::error(ErrInfo::InfoMismatch(Instr.getValType(), VT));
+      spdlog::error(ErrInfo::InfoMismatch(Instr.getValType(),
+                                          Val.get<RefVariant>().getType()));
       spdlog::error(
           ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
       return Unexpect(ErrCode::Value::CastFailed);
@@ -0,0 +1,1066 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "executor/executor.h"
+
+#include "common/spdlog.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace WasmEdge {
+namespace Executor {
+
+// The numeric operators lowered one by one. The operators compute on the value
+// V in place, with the right hand side R for the binary ones. The trapping ones
+// refer to the lowered instruction Instr for the error information.
+#define WASMEDGE_REGISTER_UNARY_OPS(X)                                         \
+  X(I32__eqz, runEqzOp<uint32_t>(V))                                           \
+  X(I64__eqz, runEqzOp<uint64_t>(V))                                           \
+  X(I32__clz, runClzOp<uint32_t>(V))                                           \
+  X(I32__ctz, runCtzOp<uint32_t>(V))                                           \
+  X(I32__popcnt, runPopcntOp<uint32_t>(V))                                     \
+  X(I64__clz, runClzOp<uint64_t>(V))                                           \
+  X(I64__ctz, runCtzOp<uint64_t>(V))                                           \
+  X(I64__popcnt, runPopcntOp<uint64_t>(V))                                     \
+  X(F32__abs, runAbsOp<float>(V))                                              \
+  X(F32__neg, runNegOp<float>(V))                                              \
+  X(F32__ceil, runCeilOp<float>(V))                                            \
+  X(F32__floor, runFloorOp<float>(V))                                          \
+  X(F32__trunc, runTruncOp<float>(V))                                          \
+  X(F32__nearest, runNearestOp<float>(V))                                      \
+  X(F32__sqrt, runSqrtOp<float>(V))                                            \
+  X(F64__abs, runAbsOp<double>(V))                                             \
+  X(F64__neg, runNegOp<double>(V))                                             \
+  X(F64__ceil, runCeilOp<double>(V))                                           \
+  X(F64__floor, runFloorOp<double>(V))                                         \
+  X(F64__trunc, runTruncOp<double>(V))                                         \
+  X(F64__nearest, runNearestOp<double>(V))                                     \
+  X(F64__sqrt, runSqrtOp<double>(V))                                           \
+  X(I32__wrap_i64, (runWrapOp<uint64_t, uint32_t>(V)))                         \
+  X(I64__extend_i32_s, (runExtendOp<int32_t, uint64_t>(V)))                    \
+  X(I64__extend_i32_u, (runExtendOp<uint32_t, uint64_t>(V)))                   \
+  X(F32__convert_i32_s, (runConvertOp<int32_t, float>(V)))                     \
+  X(F32__convert_i32_u, (runConvertOp<uint32_t, float>(V)))                    \
+  X(F32__convert_i64_s, (runConvertOp<int64_t, float>(V)))                     \
+  X(F32__convert_i64_u, (runConvertOp<uint64_t, float>(V)))                    \
+  X(F32__demote_f64, (runDemoteOp<double, float>(V)))                          \
+  X(F64__convert_i32_s, (runConvertOp<int32_t, double>(V)))                    \
+  X(F64__convert_i32_u, (runConvertOp<uint32_t, double>(V)))                   \
+  X(F64__convert_i64_s, (runConvertOp<int64_t, double>(V)))                    \
+  X(F64__convert_i64_u, (runConvertOp<uint64_t, double>(V)))                   \
+  X(F64__promote_f32, (runPromoteOp<float, double>(V)))                        \
+  X(I32__reinterpret_f32, (runReinterpretOp<float, uint32_t>(V)))              \
+  X(I64__reinterpret_f64, (runReinterpretOp<double, uint64_t>(V)))             \
+  X(F32__reinterpret_i32, (runReinterpretOp<uint32_t, float>(V)))              \
+  X(F64__reinterpret_i64, (runReinterpretOp<uint64_t, double>(V)))             \
+  X(I32__extend8_s, (runExtendOp<int32_t, uint32_t, 8>(V)))                    \
+  X(I32__extend16_s, (runExtendOp<int32_t, uint32_t, 16>(V)))                  \
+  X(I64__extend8_s, (runExtendOp<int64_t, uint64_t, 8>(V)))                    \
+  X(I64__extend16_s, (runExtendOp<int64_t, uint64_t, 16>(V)))                  \
+  X(I64__extend32_s, (runExtendOp<int64_t, uint64_t, 32>(V)))                  \
+  X(I32__trunc_sat_f32_s, (runTruncateSatOp<float, int32_t>(V)))               \
+  X(I32__trunc_sat_f32_u, (runTruncateSatOp<float, uint32_t>(V)))              \
+  X(I32__trunc_sat_f64_s, (runTruncateSatOp<double, int32_t>(V)))              \
+  X(I32__trunc_sat_f64_u, (runTruncateSatOp<double, uint32_t>(V)))             \
+  X(I64__trunc_sat_f32_s, (runTruncateSatOp<float, int64_t>(V)))               \
+  X(I64__trunc_sat_f32_u, (runTruncateSatOp<float, uint64_t>(V)))              \
+  X(I64__trunc_sat_f64_s, (runTruncateSatOp<double, int64_t>(V)))              \
+  X(I64__trunc_sat_f64_u, (runTruncateSatOp<double, uint64_t>(V)))
+
+#define WASMEDGE_REGISTER_UNARY_TRAP_OPS(X)                                    \
+  X(I32__trunc_f32_s, (runTruncateOp<float, int32_t>(Instr, V)))               \
+  X(I32__trunc_f32_u, (runTruncateOp<float, uint32_t>(Instr, V)))              \
+  X(I32__trunc_f64_s, (runTruncateOp<double, int32_t>(Instr, V)))              \
+  X(I32__trunc_f64_u, (runTruncateOp<double, uint32_t>(Instr, V)))             \
+  X(I64__trunc_f32_s, (runTruncateOp<float, int64_t>(Instr, V)))               \
+  X(I64__trunc_f32_u, (runTruncateOp<float, uint64_t>(Instr, V)))              \
+  X(I64__trunc_f64_s, (runTruncateOp<double, int64_t>(Instr, V)))              \
+  X(I64__trunc_f64_u, (runTruncateOp<double, uint64_t>(Instr, V)))
+
+#define WASMEDGE_REGISTER_BINARY_OPS(X)                                        \
+  X(F32__eq, runEqOp<float>(V, R))                                             \
+  X(F32__ne, runNeOp<float>(V, R))                                             \
+  X(F32__lt, runLtOp<float>(V, R))                                             \
+  X(F32__gt, runGtOp<float>(V, R))                                             \
+  X(F32__le, runLeOp<float>(V, R))                                             \
+  X(F32__ge, runGeOp<float>(V, R))                                             \
+  X(F64__eq, runEqOp<double>(V, R))                                            \
+  X(F64__ne, runNeOp<double>(V, R))                                            \
+  X(F64__lt, runLtOp<double>(V, R))                                            \
+  X(F64__gt, runGtOp<double>(V, R))                                            \
+  X(F64__le, runLeOp<double>(V, R))                                            \
+  X(F64__ge, runGeOp<double>(V, R))                                            \
+  X(I32__add, runAddOp<uint32_t>(V, R))                                        \
+  X(I32__sub, runSubOp<uint32_t>(V, R))                                        \
+  X(I32__mul, runMulOp<uint32_t>(V, R))                                        \
+  X(I32__and, runAndOp<uint32_t>(V, R))                                        \
+  X(I32__or, runOrOp<uint32_t>(V, R))                                          \
+  X(I32__xor, runXorOp<uint32_t>(V, R))                                        \
+  X(I32__shl, runShlOp<uint32_t>(V, R))                                        \
+  X(I32__shr_s, runShrOp<int32_t>(V, R))                                       \
+  X(I32__shr_u, runShrOp<uint32_t>(V, R))                                      \
+  X(I32__rotl, runRotlOp<uint32_t>(V, R))                                      \
+  X(I32__rotr, runRotrOp<uint32_t>(V, R))                                      \
+  X(I64__add, runAddOp<uint64_t>(V, R))                                        \
+  X(I64__sub, runSubOp<uint64_t>(V, R))                                        \
+  X(I64__mul, runMulOp<uint64_t>(V, R))                                        \
+  X(I64__and, runAndOp<uint64_t>(V, R))                                        \
+  X(I64__or, runOrOp<uint64_t>(V, R))                                          \
+  X(I64__xor, runXorOp<uint64_t>(V, R))                                        \
+  X(I64__shl, runShlOp<uint64_t>(V, R))                                        \
+  X(I64__shr_s, runShrOp<int64_t>(V, R))                                       \
+  X(I64__shr_u, runShrOp<uint64_t>(V, R))                                      \
+  X(I64__rotl, runRotlOp<uint64_t>(V, R))                                      \
+  X(I64__rotr, runRotrOp<uint64_t>(V, R))                                      \
+  X(F32__add, runAddOp<float>(V, R))                                           \
+  X(F32__sub, runSubOp<float>(V, R))                                           \
+  X(F32__mul, runMulOp<float>(V, R))                                           \
+  X(F32__min, runMinOp<float>(V, R))                                           \
+  X(F32__max, runMaxOp<float>(V, R))                                           \
+  X(F32__copysign, runCopysignOp<float>(V, R))                                 \
+  X(F64__add, runAddOp<double>(V, R))                                          \
+  X(F64__sub, runSubOp<double>(V, R))                                          \
+  X(F64__mul, runMulOp<double>(V, R))                                          \
+  X(F64__min, runMinOp<double>(V, R))                                          \
+  X(F64__max, runMaxOp<double>(V, R))                                          \
+  X(F64__copysign, runCopysignOp<double>(V, R))
+
+#define WASMEDGE_REGISTER_BINARY_TRAP_OPS(X)                                   \
+  X(I32__div_s, runDivOp<int32_t>(Instr, V, R))                                \
+  X(I32__div_u, runDivOp<uint32_t>(Instr, V, R))                               \
+  X(I32__rem_s, runRemOp<int32_t>(Instr, V, R))                                \
+  X(I32__rem_u, runRemOp<uint32_t>(Instr, V, R))                               \
+  X(I64__div_s, runDivOp<int64_t>(Instr, V, R))                                \
+  X(I64__div_u, runDivOp<uint64_t>(Instr, V, R))                               \
+  X(I64__rem_s, runRemOp<int64_t>(Instr, V, R))                                \
+  X(I64__rem_u, runRemOp<uint64_t>(Instr, V, R))                               \
+  X(F32__div, runDivOp<float>(Instr, V, R))                                    \
+  X(F64__div, runDivOp<double>(Instr, V, R))
+
+// The integer comparisons, which are also fused with the following br_if or
+// if into the conditional branches: the opcode, the negated opcode, the operand
+// type, and the operator.
+#define WASMEDGE_REGISTER_COMPARE_OPS(X)                                       \
+  X(I32__eq, I32__ne, uint32_t, ==)                                            \
+  X(I32__ne, I32__eq, uint32_t, !=)                                            \
+  X(I32__lt_s, I32__ge_s, int32_t, <)                                          \
+  X(I32__lt_u, I32__ge_u, uint32_t, <)                                         \
+  X(I32__gt_s, I32__le_s, int32_t, >)                                          \
+  X(I32__gt_u, I32__le_u, uint32_t, >)                                         \
+  X(I32__le_s, I32__gt_s, int32_t, <=)                                         \
+  X(I32__le_u, I32__gt_u, uint32_t, <=)                                        \
+  X(I32__ge_s, I32__lt_s, int32_t, >=)                                         \
+  X(I32__ge_u, I32__lt_u, uint32_t, >=)                                        \
+  X(I64__eq, I64__ne, uint64_t, ==)                                            \
+  X(I64__ne, I64__eq, uint64_t, !=)                                            \
+  X(I64__lt_s, I64__ge_s, int64_t, <)                                          \
+  X(I64__lt_u, I64__ge_u, uint64_t, <)                                         \
+  X(I64__gt_s, I64__le_s, int64_t, >)                                          \
+  X(I64__gt_u, I64__le_u, uint64_t, >)                                         \
+  X(I64__le_s, I64__gt_s, int64_t, <=)                                         \
+  X(I64__le_u, I64__gt_u, uint64_t, <=)                                        \
+  X(I64__ge_s, I64__lt_s, int64_t, >=)                                         \
+  X(I64__ge_u, I64__lt_u, uint64_t, >=)
+
+// The memory loads and stores: the opcode, the value type, and the bit width.
+#define WASMEDGE_REGISTER_LOAD_OPS(X)                                          \
+  X(I32__load, uint32_t, 32)                                                   \
+  X(I64__load, uint64_t, 64)                                                   \
+  X(F32__load, float, 32)                                                      \
+  X(F64__load, double, 64)                                                     \
+  X(I32__load8_s, int32_t, 8)                                                  \
+  X(I32__load8_u, uint32_t, 8)                                                 \
+  X(I32__load16_s, int32_t, 16)                                                \
+  X(I32__load16_u, uint32_t, 16)                                               \
+  X(I64__load8_s, int64_t, 8)                                                  \
+  X(I64__load8_u, uint64_t, 8)                                                 \
+  X(I64__load16_s, int64_t, 16)                                                \
+  X(I64__load16_u, uint64_t, 16)                                               \
+  X(I64__load32_s, int64_t, 32)                                                \
+  X(I64__load32_u, uint64_t, 32)
+
+#define WASMEDGE_REGISTER_STORE_OPS(X)                                         \
+  X(I32__store, uint32_t, 32)                                                  \
+  X(I64__store, uint64_t, 64)                                                  \
+  X(F32__store, float, 32)                                                     \
+  X(F64__store, double, 64)                                                    \
+  X(I32__store8, uint32_t, 8)                                                  \
+  X(I32__store16, uint32_t, 16)                                                \
+  X(I64__store8, uint64_t, 8)                                                  \
+  X(I64__store16, uint64_t, 16)                                                \
+  X(I64__store32, uint64_t, 32)
+
+namespace {
+
+/// Opcodes of the register code. The operands are in the fields A, B, C, and
+/// D of the instructions:
+///   Move:          A = B
+///   Const:         A = the 64-bit value of C:B
+///   Jump:          jump to A
+///   BrIfZero:      jump to A if B is zero
+///   BrIfNonZero:   jump to A if B is not zero
+///   BrTable:       jump to Tables[B + min(A, C - 1)]
+///   Return:        return the A values from the first operand slot
+///   Unreachable:   trap
+///   Select:        A = D ? B : C
+///   GlobalGet:     A = global B
+///   GlobalSet:     global A = B
+///   operators:     A = op B, or A = B op C
+///   loads:         A = load from B
+///   stores:        store C to B
+///   BrIf_<relop>:  jump to A if B relop C
+enum class RegOp : uint16_t {
+  Move,
+  Const,
+  Jump,
+  BrIfZero,
+  BrIfNonZero,
+  BrTable,
+  Return,
+  Unreachable,
+  Select,
+  GlobalGet,
+  GlobalSet,
+#define X(NAME, ...) NAME,
+  WASMEDGE_REGISTER_UNARY_OPS(X) WASMEDGE_REGISTER_UNARY_TRAP_OPS(X)
+      WASMEDGE_REGISTER_BINARY_OPS(X) WASMEDGE_REGISTER_BINARY_TRAP_OPS(X)
+          WASMEDGE_REGISTER_COMPARE_OPS(X) WASMEDGE_REGISTER_LOAD_OPS(X)
+              WASMEDGE_REGISTER_STORE_OPS(X)
+#undef X
+#define X(NAME, ...) BrIf_##NAME,
+                  WASMEDGE_REGISTER_COMPARE_OPS(X)
+#undef X
+};
+
+/// Check the instruction writes the slot A.
+bool isDefinition(RegOp Op) noexcept {
+  switch (Op) {
+  case RegOp::Move:
+  case RegOp::Const:
+  case RegOp::Select:
+  case RegOp::GlobalGet:
+#define X(NAME, ...) case RegOp::NAME:
+    WASMEDGE_REGISTER_UNARY_OPS(X)
+    WASMEDGE_REGISTER_UNARY_TRAP_OPS(X)
+    WASMEDGE_REGISTER_BINARY_OPS(X)
+    WASMEDGE_REGISTER_BINARY_TRAP_OPS(X)
+    WASMEDGE_REGISTER_COMPARE_OPS(X)
+    WASMEDGE_REGISTER_LOAD_OPS(X)
+#undef X
+    return true;
+  default:
+    return false;
+  }
+}
+
+/// Lowering state of a function body. The operand stack is tracked by the
+/// slots holding the values: the values of local.get and the constants are
+/// left in their slots, and are moved to the slots of their stack heights only
+/// at the block boundaries or before the locals are overwritten.
+class RegisterBuilder {
+public:
+  using Instruction = Runtime::RegisterCode::Instruction;
+
+  RegisterBuilder(uint32_t LocalNum, uint32_t StackHeight, uint32_t RetsN)
+      : Code(std::make_unique<Runtime::RegisterCode>()), LocalNum(LocalNum),
+        MaxHeight(StackHeight) {
+    Code->ConstBase = LocalNum + StackHeight;
+    // The function body is the outermost block, whose branches return.
+    Labels.push_back({0, 0, RetsN, false});
+  }
+
+  struct Label {
+    uint32_t Base;
+    uint32_t Params;
+    uint32_t Results;
+    bool IsLoop;
+    bool IsTargeted = false;
+    uint32_t Start = 0;
+    std::optional<uint32_t> ElseFixup = std::nullopt;
+    std::vector<uint32_t> Fixups = {};
+  };
+
+  bool isFailed() const noexcept { return Failed; }
+  bool isDead() const noexcept { return Dead; }
+  uint32_t getDepth() const noexcept {
+    return static_cast<uint32_t>(Labels.size());
+  }
+
+  /// Skip the dead code after the unconditional branches. Return true for the
+  /// else and end instructions of the current block, which are lowered.
+  bool skip(OpCode Code) noexcept {
+    switch (Code) {
+    case OpCode::Block:
+    case OpCode::Loop:
+    case OpCode::If:
+    case OpCode::Try:
+    case OpCode::Try_table:
+      ++DeadDepth;
+      return false;
+    case OpCode::Else:
+      return DeadDepth == 0;
+    case OpCode::End:
+      if (DeadDepth == 0) {
+        return true;
+      }
+      --DeadDepth;
+      return false;
+    default:
+      return false;
+    }
+  }
+
+  void push(uint32_t Slot) noexcept {
+    if (unlikely(Stack.size() >= MaxHeight)) {
+      Failed = true;
+      return;
+    }
+    Stack.push_back(Slot);
+  }
+  uint32_t pop() noexcept {
+    const uint32_t Slot = Stack.back();
+    Stack.pop_back();
+    return Slot;
+  }
+  void drop() noexcept { Stack.pop_back(); }
+
+  /// Push the value of the local.
+  void getLocal(uint32_t Idx) noexcept { push(Idx); }
+
+  /// Push the value of the global.
+  void getGlobal(uint32_t Idx, uint32_t Origin) noexcept {
+    const uint32_t Dst = getSlot(height());
+    emit(RegOp::GlobalGet, Origin, Dst, Idx);
+    push(Dst);
+  }
+
+  /// Push the constant, from the constant slots if not too many.
+  void pushConst(const ValVariant &Val, uint32_t Origin) noexcept {
+    const auto Bits = Val.get<uint128_t>();
+    const uint64_t Low = static_cast<uint64_t>(Bits);
+    for (uint32_t I = 0; I < Code->Consts.size(); ++I) {
+      if (Code->Consts[I].get<uint128_t>() == Bits) {
+        push(Code->ConstBase + I);
+        return;
+      }
+    }
+    if (Code->Consts.size() < kMaxConsts) {
+      Code->Consts.push_back(Val);
+      push(Code->ConstBase + static_cast<uint32_t>(Code->Consts.size()) - 1);
+      return;
+    }
+    const uint32_t Dst = getSlot(height());
+    emit(RegOp::Const, Origin, Dst, static_cast<uint32_t>(Low),
+         static_cast<uint32_t>(Low >> 32));
+    push(Dst);
+  }
+
+  /// Lower the instruction popping N values and pushing the result.
+  void define(RegOp Op, uint32_t Origin, uint32_t N) noexcept {
+    uint32_t Src[3] = {0, 0, 0};
+    for (uint32_t I = N; I > 0; --I) {
+      Src[I - 1] = pop();
+    }
+    const uint32_t Dst = getSlot(height());
+    if (Op == RegOp::Select) {
+      emit(Op, Origin, Dst, Src[0], Src[1], Src[2]);
+    } else {
+      emit(Op, Origin, Dst, Src[0], Src[1]);
+    }
+    push(Dst);
+  }
+
+  /// Lower the instruction popping N values without the result.
+  void consume(RegOp Op, uint32_t Origin, uint32_t N,
+               uint32_t Target = 0) noexcept {
+    uint32_t Src[2] = {0, 0};
+    for (uint32_t I = N; I > 0; --I) {
+      Src[I - 1] = pop();
+    }
+    emit(Op, Origin, Target, Src[0], Src[1]);
+  }
+
+  /// Lower local.set and local.tee. The producer of the value writes the local
+  /// directly if it is the last instruction.
+  void setLocal(uint32_t Idx, uint32_t Origin, bool IsTee) noexcept {
+    const uint32_t Src = pop();
+    bool Referred = false;
+    for (uint32_t I = 0; I < Stack.size(); ++I) {
+      if (Stack[I] == Idx) {
+        Referred = true;
+        materialize(I);
+      }
+    }
+    if (!Referred && isLastDefinition(Src)) {
+      Code->Instrs.back().A = Idx;
+    } else if (Src != Idx) {
+      emit(RegOp::Move, Origin, Idx, Src);
+    }
+    if (IsTee) {
+      push(Idx);
+    }
+  }
+
+  void enterBlock(uint32_t Params, uint32_t Results) noexcept {
+    materializeAll();
+    Labels.push_back({height() - Params, Params, Results, false});
+  }
+
+  void enterLoop(uint32_t Params, uint32_t Results) noexcept {
+    materializeAll();
+    Labels.push_back({height() - Params, Params, Results, true});
+    Labels.back().Start = here();
+  }
+
+  void enterIf(uint32_t Params, uint32_t Results, uint32_t Origin) noexcept {
+    const uint32_t Cond = pop();
+    auto Compare = takeCompare(Cond);
+    materializeAll();
+    Labels.push_back({height() - Params, Params, Results, false});
+    Labels.back().ElseFixup = emitCondJump(Compare, Cond, true, Origin);
+  }
+
+  void enterElse(uint32_t Origin) noexcept {
+    auto &L = Labels.back();
+    if (!Dead) {
+      materializeAll();
+      L.Fixups.push_back(emit(RegOp::Jump, Origin));
+      L.IsTargeted = true;
+    }
+    patch(*L.ElseFixup, here());
+    L.ElseFixup.reset();
+    resetStack(L.Base + L.Params);
+    Dead = false;
+  }
+
+  void leaveBlock() noexcept {
+    auto L = std::move(Labels.back());
+    Labels.pop_back();
+    if (!Dead) {
+      materializeAll();
+    }
+    const bool Reachable =
+        !Dead || (!L.IsLoop && (L.IsTargeted || L.ElseFixup.has_value()));
+    const uint32_t Target = here();
+    for (const uint32_t Fixup : L.Fixups) {
+      patch(Fixup, Target);
+    }
+    if (L.ElseFixup) {
+      patch(*L.ElseFixup, Target);
+    }
+    resetStack(L.Base + L.Results);
+    Dead = !Reachable;
+  }
+
+  /// Lower the unconditional branch to the label of the depth.
+  void branch(uint32_t Depth, uint32_t Origin) noexcept {
+    auto &L = getLabel(Depth);
+    moveTo(L);
+    if (&L == &Labels.front()) {
+      emit(RegOp::Return, Origin, L.Results);
+    } else if (L.IsLoop) {
+      Code->Instrs[emit(RegOp::Jump, Origin, L.Start)].BackEdge = true;
+    } else {
+      L.Fixups.push_back(emit(RegOp::Jump, Origin));
+      L.IsTargeted = true;
+    }
+    kill();
+  }
+
+  /// Lower br_if. The branch carrying values to the other slots is lowered to
+  /// the moves skipped by the negated condition.
+  void branchIf(uint32_t Depth, uint32_t Origin) noexcept {
+    const uint32_t Cond = pop();
+    auto Compare = takeCompare(Cond);
+    auto &L = getLabel(Depth);
+    if (&L != &Labels.front() && !needMove(L)) {
+      const uint32_t Jump = emitCondJump(Compare, Cond, false, Origin);
+      if (L.IsLoop) {
+        patch(Jump, L.Start);
+        Code->Instrs[Jump].BackEdge = true;
+      } else {
+        L.Fixups.push_back(Jump);
+        L.IsTargeted = true;
+      }
+      return;
+    }
+    const uint32_t Skip = emitCondJump(Compare, Cond, true, Origin);
+    const auto Saved = Stack;
+    branch(Depth, Origin);
+    Stack = Saved;
+    Dead = false;
+    patch(Skip, here());
+  }
+
+  /// Lower br_table. The table entries jump to the branches lowered after it.
+  void branchTable(Span<const AST::Instruction::JumpDescriptor> LabelList,
+                   uint32_t Origin) noexcept {
+    const uint32_t Index = pop();
+    const uint32_t TableOff = static_cast<uint32_t>(Code->Tables.size());
+    emit(RegOp::BrTable, Origin, Index, TableOff,
+         static_cast<uint32_t>(LabelList.size()));
+    Code->Tables.resize(TableOff + LabelList.size());
+    here();
+    const auto Saved = Stack;
+    for (uint32_t I = 0; I < LabelList.size(); ++I) {
+      const uint32_t Depth = LabelList[I].TargetIndex;
+      uint32_t J = 0;
+      while (LabelList[J].TargetIndex != Depth) {
+        ++J;
+      }
+      if (J < I) {
+        Code->Tables[TableOff + I] = Code->Tables[TableOff + J];
+        continue;
+      }
+      Code->Tables[TableOff + I] = static_cast<uint32_t>(Code->Instrs.size());
+      Stack = Saved;
+      branch(Depth, Origin);
+    }
+    kill();
+  }
+
+  void unreachable(uint32_t Origin) noexcept {
+    emit(RegOp::Unreachable, Origin);
+    kill();
+  }
+
+  std::unique_ptr<Runtime::RegisterCode> finish() noexcept {
+    if (Failed) {
+      return nullptr;
+    }
+    return std::move(Code);
+  }
+
+private:
+  /// The constants more than this are set by the instructions, instead of
+  /// being copied at every entry.
+  static inline constexpr const uint32_t kMaxConsts = 16;
+
+  uint32_t height() const noexcept {
+    return static_cast<uint32_t>(Stack.size());
+  }
+  uint32_t getSlot(uint32_t Height) const noexcept {
+    return LocalNum + Height;
+  }
+  Label &getLabel(uint32_t Depth) noexcept {
+    return Labels[Labels.size() - 1 - Depth];
+  }
+
+  uint32_t emit(RegOp Op, uint32_t Origin, uint32_t A = 0, uint32_t B = 0,
+                uint32_t C = 0, uint32_t D = 0) noexcept {
+    Code->Instrs.push_back(
+        {static_cast<uint16_t>(Op), false, Origin, A, B, C, D});
+    return static_cast<uint32_t>(Code->Instrs.size()) - 1;
+  }
+  void patch(uint32_t Idx, uint32_t Target) noexcept {
+    Code->Instrs[Idx].A = Target;
+  }
+  /// Mark the next instruction as a branch target, which is not rewritten by
+  /// the following instructions.
+  uint32_t here() noexcept {
+    Barrier = static_cast<uint32_t>(Code->Instrs.size());
+    return Barrier;
+  }
+  void kill() noexcept {
+    Dead = true;
+    DeadDepth = 0;
+  }
+  void resetStack(uint32_t Height) noexcept {
+    Stack.resize(Height);
+    for (uint32_t I = 0; I < Height; ++I) {
+      Stack[I] = getSlot(I);
+    }
+  }
+
+  void materialize(uint32_t Height) noexcept {
+    const uint32_t Slot = getSlot(Height);
+    if (Stack[Height] != Slot) {
+      emit(RegOp::Move, 0, Slot, Stack[Height]);
+      Stack[Height] = Slot;
+    }
+  }
+  void materializeAll() noexcept {
+    for (uint32_t I = 0; I < Stack.size(); ++I) {
+      materialize(I);
+    }
+  }
+
+  /// Check the popped value is written by the last instruction to the slot of
+  /// its height, and not used by the others.
+  bool isLastDefinition(uint32_t Slot) const noexcept {
+    if (Code->Instrs.size() <= Barrier || Slot != getSlot(height())) {
+      return false;
+    }
+    const auto &Last = Code->Instrs.back();
+    return Last.A == Slot && isDefinition(static_cast<RegOp>(Last.Op));
+  }
+
+  /// Take out the comparison computing the popped condition to fuse it with
+  /// the branch.
+  std::optional<Instruction> takeCompare(uint32_t Cond) noexcept {
+    if (!isLastDefinition(Cond)) {
+      return std::nullopt;
+    }
+    switch (static_cast<RegOp>(Code->Instrs.back().Op)) {
+    case RegOp::I32__eqz:
+#define X(NAME, ...) case RegOp::NAME:
+      WASMEDGE_REGISTER_COMPARE_OPS(X)
+#undef X
+      {
+        auto Compare = Code->Instrs.back();
+        Code->Instrs.pop_back();
+        return Compare;
+      }
+    default:
+      return std::nullopt;
+    }
+  }
+
+  /// Emit the branch taken if the condition is zero or not, and return it for
+  /// patching the target.
+  uint32_t emitCondJump(const std::optional<Instruction> &Compare,
+                        uint32_t Cond, bool OnZero, uint32_t Origin) noexcept {
+    if (!Compare) {
+      return emit(OnZero ? RegOp::BrIfZero : RegOp::BrIfNonZero, Origin, 0,
+                  Cond);
+    }
+    RegOp Op;
+    switch (static_cast<RegOp>(Compare->Op)) {
+    case RegOp::I32__eqz:
+      Op = OnZero ? RegOp::BrIfNonZero : RegOp::BrIfZero;
+      break;
+#define X(NAME, NEGATED, ...)                                                  \
+  case RegOp::NAME:                                                            \
+    Op = OnZero ? RegOp::BrIf_##NEGATED : RegOp::BrIf_##NAME;                  \
+    break;
+      WASMEDGE_REGISTER_COMPARE_OPS(X)
+#undef X
+    default:
+      assumingUnreachable();
+    }
+    return emit(Op, Compare->Origin, 0, Compare->B, Compare->C);
+  }
+
+  /// Check the branch to the label moves the values.
+  bool needMove(const Label &L) const noexcept {
+    const uint32_t Arity = L.IsLoop ? L.Params : L.Results;
+    for (uint32_t I = 0; I < Arity; ++I) {
+      if (Stack[height() - Arity + I] != getSlot(L.Base + I)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// Move the values carried by the branch to the slots of the label. The
+  /// sources are the locals, the constants, or the slots not below the
+  /// destinations, so the moves in order never overwrite the sources.
+  void moveTo(const Label &L) noexcept {
+    const uint32_t Arity = L.IsLoop ? L.Params : L.Results;
+    for (uint32_t I = 0; I < Arity; ++I) {
+      const uint32_t Src = Stack[height() - Arity + I];
+      const uint32_t Dst = getSlot(L.Base + I);
+      if (Src != Dst) {
+        emit(RegOp::Move, 0, Dst, Src);
+      }
+    }
+  }
+
+  std::unique_ptr<Runtime::RegisterCode> Code;
+  const uint32_t LocalNum;
+  const uint32_t MaxHeight;
+  std::vector<uint32_t> Stack;
+  std::vector<Label> Labels;
+  uint32_t Barrier = 0;
+  uint32_t DeadDepth = 0;
+  bool Dead = false;
+  bool Failed = false;
+};
+
+bool isScalarType(const ValType &Type) noexcept {
+  switch (Type.getCode()) {
+  case TypeCode::I32:
+  case TypeCode::I64:
+  case TypeCode::F32:
+  case TypeCode::F64:
+    return true;
+  default:
+    return false;
+  }
+}
+
+bool isScalarTypes(Span<const ValType> Types) noexcept {
+  return std::all_of(Types.begin(), Types.end(), isScalarType);
+}
+
+} // namespace
+
+std::unique_ptr<Runtime::RegisterCode> Executor::lowerRegisterCode(
+    const Runtime::Instance::FunctionInstance &Func) const noexcept {
+  // Only the functions of the scalar values without the calls are lowered.
+  const auto &FuncType = Func.getFuncType();
+  if (!isScalarTypes(FuncType.getParamTypes()) ||
+      !isScalarTypes(FuncType.getReturnTypes())) {
+    return nullptr;
+  }
+  for (const auto &Def : Func.getLocals()) {
+    if (!isScalarType(Def.second)) {
+      return nullptr;
+    }
+  }
+  const auto *ModInst = Func.getModule();
+  const uint32_t LocalNum =
+      static_cast<uint32_t>(FuncType.getParamTypes().size()) +
+      Func.getLocalNum();
+  RegisterBuilder Builder(
+      LocalNum, Func.getStackHeight(),
+      static_cast<uint32_t>(FuncType.getReturnTypes().size()));
+
+  // Resolve the params and the results of the blocks.
+  uint32_t Params = 0;
+  uint32_t Results = 0;
+  auto ResolveBlockType = [&](const BlockType &BType) noexcept {
+    Params = Results = 0;
+    if (BType.isEmpty()) {
+      return true;
+    }
+    if (BType.isValType()) {
+      Results = 1;
+      return isScalarType(BType.getValType());
+    }
+    const auto &CompType =
+        ModInst->unsafeGetType(BType.getTypeIndex())->getCompositeType();
+    if (!CompType.isFunc()) {
+      return false;
+    }
+    const auto &Type = CompType.getFuncType();
+    Params = static_cast<uint32_t>(Type.getParamTypes().size());
+    Results = static_cast<uint32_t>(Type.getReturnTypes().size());
+    return isScalarTypes(Type.getParamTypes()) &&
+           isScalarTypes(Type.getReturnTypes());
+  };
+
+  const auto Instrs = Func.getInstrs();
+  for (uint32_t Idx = 0; Idx < Instrs.size(); ++Idx) {
+    const auto &Instr = Instrs[Idx];
+    if (Builder.isDead() && !Builder.skip(Instr.getOpCode())) {
+      continue;
+    }
+    switch (Instr.getOpCode()) {
+    case OpCode::Unreachable:
+      Builder.unreachable(Idx);
+      break;
+    case OpCode::Nop:
+      break;
+    case OpCode::Block:
+      if (!ResolveBlockType(Instr.getBlockType())) {
+        return nullptr;
+      }
+      Builder.enterBlock(Params, Results);
+      break;
+    case OpCode::Loop:
+      if (!ResolveBlockType(Instr.getBlockType())) {
+        return nullptr;
+      }
+      Builder.enterLoop(Params, Results);
+      break;
+    case OpCode::If:
+      if (!ResolveBlockType(Instr.getBlockType())) {
+        return nullptr;
+      }
+      Builder.enterIf(Params, Results, Idx);
+      break;
+    case OpCode::Else:
+      Builder.enterElse(Idx);
+      break;
+    case OpCode::End:
+      if (Builder.getDepth() > 1) {
+        Builder.leaveBlock();
+      } else if (!Builder.isDead()) {
+        Builder.branch(0, Idx);
+      }
+      break;
+    case OpCode::Br:
+      Builder.branch(Instr.getJump().TargetIndex, Idx);
+      break;
+    case OpCode::Br_if:
+      Builder.branchIf(Instr.getJump().TargetIndex, Idx);
+      break;
+    case OpCode::Br_table:
+      Builder.branchTable(Instr.getLabelList(), Idx);
+      break;
+    case OpCode::Return:
+      Builder.branch(Builder.getDepth() - 1, Idx);
+      break;
+    case OpCode::Drop:
+      Builder.drop();
+      break;
+    case OpCode::Select_t:
+      if (!isScalarTypes(Instr.getValTypeList())) {
+        return nullptr;
+      }
+      [[fallthrough]];
+    case OpCode::Select:
+      Builder.define(RegOp::Select, Idx, 3);
+      break;
+    case OpCode::Local__get:
+      Builder.getLocal(Instr.getTargetIndex());
+      break;
+    case OpCode::Local__set:
+      Builder.setLocal(Instr.getTargetIndex(), Idx, false);
+      break;
+    case OpCode::Local__tee:
+      Builder.setLocal(Instr.getTargetIndex(), Idx, true);
+      break;
+    case OpCode::Global__get:
+      if (!isScalarType(ModInst->unsafeGetGlobal(Instr.getTargetIndex())
+                            ->getGlobalType()
+                            .getValType())) {
+        return nullptr;
+      }
+      Builder.getGlobal(Instr.getTargetIndex(), Idx);
+      break;
+    case OpCode::Global__set:
+      if (!isScalarType(ModInst->unsafeGetGlobal(Instr.getTargetIndex())
+                            ->getGlobalType()
+                            .getValType())) {
+        return nullptr;
+      }
+      Builder.consume(RegOp::GlobalSet, Idx, 1, Instr.getTargetIndex());
+      break;
+    case OpCode::I32__const:
+    case OpCode::I64__const:
+    case OpCode::F32__const:
+    case OpCode::F64__const:
+      Builder.pushConst(Instr.getNum(), Idx);
+      break;
+
+#define X(NAME, ...)                                                           \
+  case OpCode::NAME:                                                           \
+    Builder.define(RegOp::NAME, Idx, 1);                                       \
+    break;
+      WASMEDGE_REGISTER_UNARY_OPS(X)
+      WASMEDGE_REGISTER_UNARY_TRAP_OPS(X)
+      WASMEDGE_REGISTER_LOAD_OPS(X)
+#undef X
+#define X(NAME, ...)                                                           \
+  case OpCode::NAME:                                                           \
+    Builder.define(RegOp::NAME, Idx, 2);                                       \
+    break;
+      WASMEDGE_REGISTER_BINARY_OPS(X)
+      WASMEDGE_REGISTER_BINARY_TRAP_OPS(X)
+      WASMEDGE_REGISTER_COMPARE_OPS(X)
+#undef X
+#define X(NAME, ...)                                                           \
+  case OpCode::NAME:                                                           \
+    Builder.consume(RegOp::NAME, Idx, 2);                                      \
+    break;
+      WASMEDGE_REGISTER_STORE_OPS(X)
+#undef X
+
+    default:
+      // The calls, the references, the vectors, the exceptions, and the
+      // others are run by the stack machine.
+      return nullptr;
+    }
+    if (Builder.isFailed()) {
+      return nullptr;
+    }
+  }
+  return Builder.finish();
+}
+
+Expect<void>
+Executor::runRegisterCode(Runtime::StackManager &StackMgr,
+                          const Runtime::Instance::FunctionInstance &Func,
+                          const Runtime::RegisterCode &Code) noexcept {
+  ValVariant *const F = StackMgr.getFrameBase();
+  std::copy(Code.Consts.begin(), Code.Consts.end(), F + Code.ConstBase);
+  const auto Instrs = Func.getInstrs();
+  const Runtime::RegisterCode::Instruction *const Begin = Code.Instrs.data();
+  const Runtime::RegisterCode::Instruction *PC = Begin;
+
+  // The branches to the loop starts check the interruption, stop at the
+  // collections, and count the back-edges for the tiered execution.
+  auto BackEdge = [this, &Func]() noexcept -> Expect<void> {
+    if (unlikely(getStopToken().exchange(0, std::memory_order_relaxed))) {
+      spdlog::error(ErrCode::Value::Interrupted);
+      return Unexpect(ErrCode::Value::Interrupted);
+    }
+    Collector::safepoint();
+    countTierUp(Func);
+    return {};
+  };
+#define WASMEDGE_REGISTER_JUMP(TARGET)                                         \
+  if (I.BackEdge) {                                                            \
+    if (auto Res = BackEdge(); unlikely(!Res)) {                               \
+      return Unexpect(Res);                                                    \
+    }                                                                          \
+  }                                                                            \
+  PC = Begin + (TARGET);
+
+  while (true) {
+    const auto &I = *PC++;
+    switch (static_cast<RegOp>(I.Op)) {
+    case RegOp::Move:
+      F[I.A] = F[I.B];
+      break;
+    case RegOp::Const:
+      F[I.A] = ValVariant(
+          static_cast<uint128_t>((static_cast<uint64_t>(I.C) << 32) | I.B));
+      break;
+    case RegOp::Jump:
+      WASMEDGE_REGISTER_JUMP(I.A)
+      break;
+    case RegOp::BrIfZero:
+      if (F[I.B].get<uint32_t>() == 0) {
+        WASMEDGE_REGISTER_JUMP(I.A)
+      }
+      break;
+    case RegOp::BrIfNonZero:
+      if (F[I.B].get<uint32_t>() != 0) {
+        WASMEDGE_REGISTER_JUMP(I.A)
+      }
+      break;
+    case RegOp::BrTable:
+      PC = Begin +
+           Code.Tables[I.B + std::min(F[I.A].get<uint32_t>(), I.C - 1)];
+      break;
+    case RegOp::Return:
+      StackMgr.setFrameValueNum(I.A);
+      return {};
+    case RegOp::Unreachable: {
+      const auto &Instr = Instrs[I.Origin];
+      spdlog::error(ErrCode::Value::Unreachable);
+      spdlog::error(
+          ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
+      return Unexpect(ErrCode::Value::Unreachable);
+    }
+    case RegOp::Select:
+      F[I.A] = F[I.D].get<uint32_t>() ? F[I.B] : F[I.C];
+      break;
+    case RegOp::GlobalGet:
+      F[I.A] = getGlobInstByIdx(StackMgr, I.B)->getValue();
+      break;
+    case RegOp::GlobalSet:
+      getGlobInstByIdx(StackMgr, I.A)->setValue(F[I.B]);
+      break;
+
+#define X(NAME, OP)                                                            \
+  case RegOp::NAME: {                                                          \
+    ValVariant V = F[I.B];                                                     \
+    OP;                                                                        \
+    F[I.A] = V;                                                                \
+    break;                                                                     \
+  }
+      WASMEDGE_REGISTER_UNARY_OPS(X)
+#undef X
+#define X(NAME, OP)                                                            \
+  case RegOp::NAME: {                                                          \
+    const auto &Instr = Instrs[I.Origin];                                      \
+    ValVariant V = F[I.B];                                                     \
+    if (auto Res = OP; unlikely(!Res)) {                                       \
+      return Unexpect(Res);                                                    \
+    }                                                                          \
+    F[I.A] = V;                                                                \
+    break;                                                                     \
+  }
+      WASMEDGE_REGISTER_UNARY_TRAP_OPS(X)
+#undef X
+#define X(NAME, OP)                                                            \
+  case RegOp::NAME: {                                                          \
+    ValVariant V = F[I.B];                                                     \
+    const ValVariant &R = F[I.C];                                              \
+    OP;                                                                        \
+    F[I.A] = V;                                                                \
+    break;                                                                     \
+  }
+      WASMEDGE_REGISTER_BINARY_OPS(X)
+#undef X
+#define X(NAME, OP)                                                            \
+  case RegOp::NAME: {                                                          \
+    const auto &Instr = Instrs[I.Origin];                                      \
+    ValVariant V = F[I.B];                                                     \
+    const ValVariant &R = F[I.C];                                              \
+    if (auto Res = OP; unlikely(!Res)) {                                       \
+      return Unexpect(Res);                                                    \
+    }                                                                          \
+    F[I.A] = V;                                                                \
+    break;                                                                     \
+  }
+      WASMEDGE_REGISTER_BINARY_TRAP_OPS(X)
+#undef X
+#define X(NAME, NEGATED, TYPE, OP)                                             \
+  case RegOp::NAME:                                                            \
+    F[I.A].emplace<uint32_t>(F[I.B].get<TYPE>() OP F[I.C].get<TYPE>() ? 1U     \
+                                                                      : 0U);   \
+    break;                                                                     \
+  case RegOp::BrIf_##NAME:                                                     \
+    if (F[I.B].get<TYPE>() OP F[I.C].get<TYPE>()) {                            \
+      WASMEDGE_REGISTER_JUMP(I.A)                                              \
+    }                                                                          \
+    break;
+      WASMEDGE_REGISTER_COMPARE_OPS(X)
+#undef X
+#define X(NAME, TYPE, BITS)                                                    \
+  case RegOp::NAME: {                                                          \
+    const auto &Instr = Instrs[I.Origin];                                      \
+    auto &MemInst = *getMemInstByIdx(StackMgr, Instr.getTargetIndex());        \
+    auto EA = getEffectiveAddress(MemInst, F[I.B], Instr, (BITS) / 8);         \
+    if (unlikely(!EA)) {                                                       \
+      return Unexpect(EA);                                                     \
+    }                                                                          \
+    if (auto Res = MemInst.loadValue<TYPE, (BITS) / 8>(F[I.A].emplace<TYPE>(), \
+                                                       *EA);                   \
+        unlikely(!Res)) {                                                      \
+      spdlog::error(                                                           \
+          ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));     \
+      return Unexpect(Res);                                                    \
+    }                                                                          \
+    break;                                                                     \
+  }
+      WASMEDGE_REGISTER_LOAD_OPS(X)
+#undef X
+#define X(NAME, TYPE, BITS)                                                    \
+  case RegOp::NAME: {                                                          \
+    const auto &Instr = Instrs[I.Origin];                                      \
+    auto &MemInst = *getMemInstByIdx(StackMgr, Instr.getTargetIndex());        \
+    auto EA = getEffectiveAddress(MemInst, F[I.B], Instr, (BITS) / 8);         \
+    if (unlikely(!EA)) {                                                       \
+      return Unexpect(EA);                                                     \
+    }                                                                          \
+    if (auto Res = MemInst.storeValue<TYPE, (BITS) / 8>(F[I.C].get<TYPE>(),    \
+                                                        *EA);                  \
+        unlikely(!Res)) {                                                      \
+      spdlog::error(                                                           \
+          ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));     \
+      return Unexpect(Res);                                                    \
+    }                                                                          \
+    break;                                                                     \
+  }
+      WASMEDGE_REGISTER_STORE_OPS(X)
+#undef X
+
+    default:
+      assumingUnreachable();
+    }
+  }
+#undef WASMEDGE_REGISTER_JUMP
+}
+
+#undef WASMEDGE_REGISTER_STORE_OPS
+#undef WASMEDGE_REGISTER_LOAD_OPS
+#undef WASMEDGE_REGISTER_COMPARE_OPS
+#undef WASMEDGE_REGISTER_BINARY_TRAP_OPS
+#undef WASMEDGE_REGISTER_BINARY_OPS
+#undef WASMEDGE_REGISTER_UNARY_TRAP_OPS
+#undef WASMEDGE_REGISTER_UNARY_OPS
+
+} // namespace Executor
+} // namespace WasmEdge
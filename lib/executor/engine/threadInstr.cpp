@@ -13,19 +13,11 @@ Executor::runAtomicNotifyOp(Runtime::StackManager &StackMgr,
   ValVariant RawCount = StackMgr.pop();
   ValVariant &RawAddress = StackMgr.getTop();
 
-  uint32_t Address = RawAddress.get<uint32_t>();
-
-  if (Address >
-      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
-    spdlog::error(ErrCode::Value::MemoryOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(
-        Address + static_cast<uint64_t>(Instr.getMemoryOffset()),
-        sizeof(uint32_t), MemInst.getBoundIdx()));
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::MemoryOutOfBounds);
+  auto EA = getEffectiveAddress(MemInst, RawAddress, Instr, sizeof(uint32_t));
+  if (unlikely(!EA)) {
+    return Unexpect(EA);
   }
-  Address += Instr.getMemoryOffset();
+  const uint64_t Address = *EA;
 
   if (Address % sizeof(uint32_t) != 0) {
     spdlog::error(ErrCode::Value::UnalignedAtomicAccess);
@@ -53,34 +45,20 @@ Expect<void> Executor::runMemoryFenceOp() {
 
 Expect<uint32_t>
 Executor::atomicNotify(Runtime::Instance::MemoryInstance &MemInst,
-                       uint32_t Address, uint32_t Count) noexcept {
+                       uint64_t Address, uint32_t Count) noexcept {
   // The error message should be handled by the caller, or the AOT mode will
   // produce the duplicated messages.
-  if (auto *AtomicObj = MemInst.getPointer<std::atomic<uint32_t> *>(Address);
-      !AtomicObj) {
+  auto *AtomicObj = MemInst.getPointer<std::atomic<uint32_t> *>(Address);
+  if (!AtomicObj) {
     return Unexpect(ErrCode::Value::MemoryOutOfBounds);
   }
 
-  std::unique_lock<decltype(WaiterMapMutex)> Locker(WaiterMapMutex);
-  uint32_t Total = 0;
-  auto Range = WaiterMap.equal_range(Address);
-  for (auto Iterator = Range.first; Total < Count && Iterator != Range.second;
-       ++Iterator) {
-    if (likely(&MemInst == Iterator->second.MemInst)) {
-      Iterator->second.Cond.notify_all();
-      ++Total;
-    }
-  }
-  return Total;
+  // The waiters are parked on the addresses of the host memory, which are
+  // unique for the memory instances and the offsets.
+  return Waiters.unpark(AtomicObj, Count);
 }
 
-void Executor::atomicNotifyAll() noexcept {
-  std::unique_lock<decltype(WaiterMapMutex)> Locker(WaiterMapMutex);
-  for (auto Iterator = WaiterMap.begin(); Iterator != WaiterMap.end();
-       ++Iterator) {
-    Iterator->second.Cond.notify_all();
-  }
-}
+void Executor::atomicNotifyAll() noexcept { Waiters.unparkAll(); }
 
 } // namespace Executor
 } // namespace WasmEdge
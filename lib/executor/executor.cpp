@@ -6,6 +6,8 @@
 #include "common/errinfo.h"
 #include "common/spdlog.h"
 
+#include <algorithm>
+
 namespace WasmEdge {
 namespace Executor {
 
@@ -52,6 +54,8 @@ Executor::registerModule(Runtime::StoreManager &StoreMgr,
     spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
     return Unexpect(ErrCode::Value::ModuleNameConflict);
   }
+  // The globals and tables of the host modules may refer to the GC objects.
+  Collector::getInstance().link(ModInst);
   return {};
 }
 
@@ -111,12 +115,17 @@ Executor::invoke(const Runtime::Instance::FunctionInstance *FuncInst,
     }
   }
 
-  Runtime::StackManager StackMgr;
+  Runtime::StackManager StackMgr(Conf.getRuntimeConfigure().getStackSize());
+  Collector::Scope GCScope(StackMgr, true);
 
   // Call runFunction.
   if (auto Res = runFunction(StackMgr, *FuncInst, Params); !Res) {
     return Unexpect(Res);
   }
+  // The GC objects returned to the host are rooted until the host unroots them
+  // or the module instance is deleted.
+  Collector::getInstance().pin(RTypes,
+                               StackMgr.getTopSpan(RTypes.size()).data());
 
   // Get return values.
   std::vector<std::pair<ValVariant, ValType>> Returns(RTypes.size());
@@ -169,8 +178,62 @@ Executor::asyncInvoke(const Runtime::Instance::FunctionInstance *FuncInst,
   Expect<std::vector<std::pair<ValVariant, ValType>>> (Executor::*FPtr)(
       const Runtime::Instance::FunctionInstance *, Span<const ValVariant>,
       Span<const ValType>) = &Executor::invoke;
-  return {FPtr, *this, FuncInst, std::vector(Params.begin(), Params.end()),
-          std::vector(ParamTypes.begin(), ParamTypes.end())};
+  ThreadPool::Task Task;
+  Async<Expect<std::vector<std::pair<ValVariant, ValType>>>> Result(
+      Task, FPtr, *this, FuncInst, std::vector(Params.begin(), Params.end()),
+      std::vector(ParamTypes.begin(), ParamTypes.end()));
+  submitAsync(std::move(Task));
+  return Result;
+}
+
+Executor::StopScope::StopScope(Executor &E,
+                                std::atomic_uint32_t &Token) noexcept
+    : Engine(E), SavedOwner(TaskOwner), SavedToken(TaskToken) {
+  TaskOwner = &Engine;
+  TaskToken = &Token;
+  std::unique_lock Lock(Engine.TaskMutex);
+  Engine.TaskTokens.push_back(&Token);
+}
+
+Executor::StopScope::~StopScope() noexcept {
+  {
+    std::unique_lock Lock(Engine.TaskMutex);
+    auto It = std::find(Engine.TaskTokens.begin(), Engine.TaskTokens.end(),
+                        TaskToken);
+    if (It != Engine.TaskTokens.end()) {
+      Engine.TaskTokens.erase(It);
+    }
+  }
+  TaskOwner = SavedOwner;
+  TaskToken = SavedToken;
+}
+
+void Executor::stopTasks() noexcept {
+  {
+    std::unique_lock Lock(TaskMutex);
+    for (auto *Token : TaskTokens) {
+      Token->store(1, std::memory_order_relaxed);
+    }
+  }
+  atomicNotifyAll();
+}
+
+void Executor::submitAsync(ThreadPool::Task &&Task) {
+  if (auto *Pool = AsyncPool.get()) {
+    Pool->submit(std::move(Task));
+  } else {
+    std::thread(std::move(Task)).detach();
+  }
+}
+
+void Executor::submitAsync(std::vector<ThreadPool::Task> &&Tasks) {
+  if (auto *Pool = AsyncPool.get()) {
+    Pool->submit(std::move(Tasks));
+  } else {
+    for (auto &Task : Tasks) {
+      std::thread(std::move(Task)).detach();
+    }
+  }
 }
 
 } // namespace Executor
@@ -0,0 +1,858 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "executor/gc.h"
+
+#if defined(_MSC_VER) && !defined(__clang__) // MSVC
+#include <csetjmp>
+#include <intrin.h>
+#endif // MSVC
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <new>
+
+namespace WasmEdge {
+namespace Executor {
+
+namespace {
+
+using Runtime::Instance::ArrayInstance;
+using Runtime::Instance::GCLayout;
+using Runtime::Instance::GCObject;
+using Runtime::Instance::ModuleInstance;
+using Runtime::Instance::StructInstance;
+
+/// Empty chunks kept in a heap for the next allocations.
+constexpr const size_t kMaxEmptyChunks = 8;
+
+/// Count the trailing zero bits of the nonzero bitmap word.
+inline uint32_t ctz(uint64_t Bits) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__) // MSVC
+  unsigned long Index;
+  _BitScanForward64(&Index, Bits);
+  return static_cast<uint32_t>(Index);
+#else
+  return static_cast<uint32_t>(__builtin_ctzll(Bits));
+#endif // MSVC
+}
+
+/// Count the leading zero bits of the nonzero bitmap word.
+inline uint32_t clz(uint64_t Bits) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__) // MSVC
+  unsigned long Index;
+  _BitScanReverse64(&Index, Bits);
+  return 63U - static_cast<uint32_t>(Index);
+#else
+  return static_cast<uint32_t>(__builtin_clzll(Bits));
+#endif // MSVC
+}
+
+/// Get the address under the frame of the caller.
+#if defined(_MSC_VER) && !defined(__clang__) // MSVC
+__declspec(noinline) const void *getCallerFrameEnd() noexcept {
+  return _AddressOfReturnAddress();
+}
+#else
+[[gnu::noinline]] const void *getCallerFrameEnd() noexcept {
+  return __builtin_frame_address(0);
+}
+#endif // MSVC
+
+/// Get the bottom type of the reference type, which types the null default
+/// values. The same as Executor::toBottomType.
+TypeCode getBottomType(Span<const AST::SubType *const> TypeList,
+                       const ValType &Type) noexcept {
+  if (!Type.isAbsHeapType()) {
+    return TypeList[Type.getTypeIndex()]->getCompositeType().isFunc()
+               ? TypeCode::NullFuncRef
+               : TypeCode::NullRef;
+  }
+  switch (Type.getHeapTypeCode()) {
+  case TypeCode::NullFuncRef:
+  case TypeCode::FuncRef:
+    return TypeCode::NullFuncRef;
+  case TypeCode::NullExternRef:
+  case TypeCode::ExternRef:
+    return TypeCode::NullExternRef;
+  case TypeCode::ExnRef:
+    return TypeCode::ExnRef;
+  default:
+    return TypeCode::NullRef;
+  }
+}
+
+/// Write the default value of the storage type.
+void writeDefault(uint8_t *Ptr, Span<const AST::SubType *const> TypeList,
+                  const ValType &SType) noexcept {
+  if (SType.isRefType()) {
+    const RefVariant Null(getBottomType(TypeList, SType));
+    std::memcpy(Ptr, &Null, sizeof(RefVariant));
+  }
+}
+
+std::unique_ptr<GCLayout>
+makeLayout(Span<const AST::SubType *const> TypeList,
+           const AST::CompositeType &CompType) {
+  auto L = std::make_unique<GCLayout>();
+  const auto &FTypes = CompType.getFieldTypes();
+  L->IsArray = CompType.getContentTypeCode() == TypeCode::Array;
+  for (const auto &FType : FTypes) {
+    L->Types.push_back(FType.getStorageType());
+  }
+  if (L->IsArray) {
+    L->Size = GCObject::getStorageSize(L->Types[0]);
+    L->Defaults.assign(L->Size, 0);
+    writeDefault(L->Defaults.data(), TypeList, L->Types[0]);
+    return L;
+  }
+
+  constexpr const uint64_t HeaderSize = sizeof(StructInstance);
+  L->Size = StructInstance::placeFields(L->Types, L->Offsets);
+  L->Defaults.assign(L->Size - HeaderSize, 0);
+  for (uint32_t I = 0; I < L->Types.size(); ++I) {
+    if (L->Types[I].isRefType()) {
+      L->RefOffsets.push_back(L->Offsets[I]);
+      writeDefault(L->Defaults.data() + (L->Offsets[I] - HeaderSize), TypeList,
+                   L->Types[I]);
+    }
+  }
+  return L;
+}
+
+uint64_t getObjectSize(const GCObject &Obj) noexcept {
+  if (Obj.getLayout().IsArray) {
+    return static_cast<const ArrayInstance &>(Obj).getObjectSize();
+  }
+  return Obj.getLayout().Size;
+}
+
+} // namespace
+
+/// Roots and the running state of a thread.
+struct Collector::ThreadState {
+  ThreadState() noexcept;
+  ~ThreadState() noexcept;
+
+  /// Innermost scope.
+  Scope *Current = nullptr;
+  /// Base of the native frames of the compiled functions.
+  const void *NativeStackBase = nullptr;
+  /// Top of the native frames when stopped at a safepoint.
+  const void *StackTop = nullptr;
+  /// Running in a scope and out of the host functions.
+  std::atomic<bool> Running = false;
+};
+
+Collector::ThreadState::ThreadState() noexcept {
+  auto &GC = getInstance();
+  std::unique_lock<std::mutex> Lock(GC.Mutex);
+  GC.Threads.push_back(this);
+}
+
+Collector::ThreadState::~ThreadState() noexcept {
+  auto &GC = getInstance();
+  std::unique_lock<std::mutex> Lock(GC.Mutex);
+  GC.Threads.erase(std::find(GC.Threads.begin(), GC.Threads.end(), this));
+}
+
+GCHeap::GCHeap(Span<const AST::SubType *const> TypeList) {
+  Layouts.resize(TypeList.size());
+  for (size_t I = 0; I < TypeList.size(); ++I) {
+    const auto &CompType = TypeList[I]->getCompositeType();
+    if (!CompType.isFunc()) {
+      Layouts[I] = makeLayout(TypeList, CompType);
+    }
+  }
+}
+
+uint8_t *GCHeap::allocate(uint64_t Size) noexcept {
+  if (Size > Collector::kLargeSize) {
+    Chunk *C = newChunk(Size);
+    if (C == nullptr) {
+      return nullptr;
+    }
+    C->Large = true;
+    setYoung(*C);
+    C->setStart(C->begin());
+    return C->begin();
+  }
+  while (static_cast<uint64_t>(Limit - Cursor) < Size) {
+    if (!Holes.empty()) {
+      const Hole H = Holes.back();
+      Holes.pop_back();
+      Current = H.Owner;
+      Cursor = H.Begin;
+      Limit = H.End;
+    } else if (Chunk *C = newChunk(Collector::kChunkSize)) {
+      Current = C;
+      Cursor = C->begin();
+      Limit = C->end();
+    } else {
+      return nullptr;
+    }
+    setYoung(*Current);
+  }
+  uint8_t *Ptr = Cursor;
+  Cursor += Size;
+  Current->setStart(Ptr);
+  return Ptr;
+}
+
+GCHeap::Chunk *GCHeap::newChunk(uint64_t Size) noexcept {
+  auto *Data = new (std::nothrow) uint8_t[Size];
+  if (Data == nullptr) {
+    return nullptr;
+  }
+  auto C = std::make_unique<Chunk>(Data, Size);
+  Chunks.push_back(std::move(C));
+  Collector::getInstance().addChunk(*Chunks.back());
+  return Chunks.back().get();
+}
+
+void GCHeap::setYoung(Chunk &C) noexcept {
+  if (!C.Young) {
+    C.Young = true;
+    YoungChunks.push_back(&C);
+  }
+}
+
+Collector::Scope::Scope(Runtime::StackManager &S, bool C) noexcept
+    : Thread(getThread()), Prev(Thread.Current), StackMgr(S), Collectable(C),
+      WasRunning(Thread.Running.load(std::memory_order_relaxed)) {
+  if (!WasRunning) {
+    getInstance().enterRunning(Thread);
+  }
+  Thread.Current = this;
+}
+
+Collector::Scope::~Scope() noexcept {
+  Thread.Current = Prev;
+  if (!WasRunning) {
+    getInstance().leaveRunning(Thread);
+  }
+}
+
+void Collector::HostCall::begin(Span<const ValType> Types,
+                                const ValVariant *Args) noexcept {
+  Thread = &getThread();
+  Current = Thread->Current;
+  if (Current == nullptr) {
+    return;
+  }
+  PinSize = Current->Pins.size();
+  for (size_t I = 0; I < Types.size(); ++I) {
+    if (Types[I].isRefType()) {
+      Current->Pins.push_back(Args[I].get<RefVariant>().getPtr<void>());
+    }
+  }
+  // The compiled functions may keep the references in the registers, which
+  // are only spilled at the safepoints.
+  Stopped = Current->Collectable && Thread->NativeStackBase == nullptr &&
+            Thread->Running.load(std::memory_order_relaxed);
+  if (Stopped) {
+    getInstance().leaveRunning(*Thread);
+  }
+}
+
+void Collector::HostCall::end() noexcept {
+  if (Stopped) {
+    getInstance().enterRunning(*Thread);
+  }
+  Current->Pins.resize(PinSize);
+}
+
+Collector::Root::Root(const RefVariant &Ref) noexcept
+    : Ptr(Ref.getPtr<void>()) {
+  getInstance().root(Ref);
+}
+
+Collector::Root::~Root() noexcept {
+  if (Ptr != nullptr) {
+    getInstance().unroot(RefVariant(Ptr));
+  }
+}
+
+void Collector::root(const RefVariant &Ref) noexcept {
+  if (const void *Ptr = Ref.getPtr<void>()) {
+    std::unique_lock<std::mutex> Lock(Mutex);
+    ++Roots[Ptr];
+  }
+}
+
+void Collector::unroot(const RefVariant &Ref) noexcept {
+  if (const void *Ptr = Ref.getPtr<void>()) {
+    std::unique_lock<std::mutex> Lock(Mutex);
+    if (auto It = Roots.find(Ptr); It != Roots.end() && --It->second == 0) {
+      Roots.erase(It);
+    }
+  }
+}
+
+Collector::NativeScope::NativeScope() noexcept
+    : Prev(getThread().NativeStackBase) {
+  if (Prev == nullptr) {
+    // The native frames of the compiled functions are under this scope.
+    getThread().NativeStackBase = this;
+  }
+}
+
+Collector::NativeScope::~NativeScope() noexcept {
+  getThread().NativeStackBase = Prev;
+}
+
+Collector &Collector::getInstance() noexcept {
+  // Never destroyed, because the module instances may be destroyed after the
+  // static objects in the exit.
+  static Collector *GC = new Collector();
+  return *GC;
+}
+
+Collector::ThreadState &Collector::getThread() noexcept {
+  thread_local ThreadState Thread;
+  return Thread;
+}
+
+void Collector::enterRunning(ThreadState &Thread) noexcept {
+  while (true) {
+    Thread.Running.store(true, std::memory_order_seq_cst);
+    if (likely(!Requested.load(std::memory_order_seq_cst))) {
+      return;
+    }
+    // The collecting thread may have seen this thread stopped.
+    Thread.Running.store(false, std::memory_order_seq_cst);
+    std::unique_lock<std::mutex> Lock(StopMutex);
+    StopCond.notify_all();
+    StopCond.wait(Lock, []() {
+      return !Requested.load(std::memory_order_seq_cst);
+    });
+  }
+}
+
+void Collector::leaveRunning(ThreadState &Thread) noexcept {
+  Thread.Running.store(false, std::memory_order_seq_cst);
+  if (unlikely(Requested.load(std::memory_order_seq_cst))) {
+    std::unique_lock<std::mutex> Lock(StopMutex);
+    StopCond.notify_all();
+  }
+}
+
+#if defined(_MSC_VER) && !defined(__clang__) // MSVC
+__declspec(noinline)
+#else
+[[gnu::noinline]]
+#endif // MSVC
+void Collector::park() noexcept {
+  ThreadState &Thread = getThread();
+  if (Thread.Current == nullptr || !Thread.Current->Collectable ||
+      !Thread.Running.load(std::memory_order_relaxed)) {
+    return;
+  }
+  // Spill the callee-saved registers into this frame, which is on the native
+  // stack scanned by the collecting thread.
+#if defined(_MSC_VER) && !defined(__clang__) // MSVC
+  std::jmp_buf Regs;
+  setjmp(Regs);
+#else
+  __builtin_unwind_init();
+#endif // MSVC
+  Thread.StackTop = getCallerFrameEnd();
+  leaveRunning(Thread);
+  enterRunning(Thread);
+}
+
+bool Collector::stopThreads(const ThreadState &Self) noexcept {
+  const auto Deadline = std::chrono::steady_clock::now() + kStopTimeout;
+  std::unique_lock<std::mutex> Lock(StopMutex);
+  while (true) {
+    {
+      std::unique_lock<std::mutex> ThreadsLock(Mutex);
+      if (std::all_of(Threads.begin(), Threads.end(),
+                      [&Self](const ThreadState *Thread) {
+                        return Thread == &Self ||
+                               !Thread->Running.load(std::memory_order_seq_cst);
+                      })) {
+        return true;
+      }
+    }
+    if (StopCond.wait_until(Lock, Deadline) == std::cv_status::timeout) {
+      return false;
+    }
+  }
+}
+
+void Collector::link(const ModuleInstance &Mod) noexcept {
+  std::unique_lock<std::mutex> Lock(Mutex);
+  if (Modules.try_emplace(&Mod).second) {
+    const_cast<ModuleInstance &>(Mod).UnlinkCollector = &Collector::unlink;
+  }
+}
+
+GCHeap &Collector::getHeap(const ModuleInstance &Mod) noexcept {
+  if (auto *Heap = Mod.Heap.load(std::memory_order_acquire)) {
+    return *Heap;
+  }
+  std::unique_lock<std::mutex> Lock(Mutex);
+  auto [It, Inserted] = Modules.try_emplace(&Mod);
+  auto &ModInst = const_cast<ModuleInstance &>(Mod);
+  if (Inserted) {
+    ModInst.UnlinkCollector = &Collector::unlink;
+  }
+  if (!It->second) {
+    It->second = std::make_unique<GCHeap>(Mod.getTypeList());
+    HeapCount.fetch_add(1, std::memory_order_relaxed);
+    ModInst.Heap.store(It->second.get(), std::memory_order_release);
+  }
+  return *It->second;
+}
+
+void Collector::unlink(const ModuleInstance *Mod) noexcept {
+  auto &GC = getInstance();
+  std::unique_lock<std::mutex> Lock(GC.Mutex);
+  auto It = GC.Modules.find(Mod);
+  if (It == GC.Modules.end()) {
+    return;
+  }
+  if (auto &Heap = It->second) {
+    // Drop the roots of the objects, whose addresses may be reused.
+    for (auto R = GC.Roots.begin(); R != GC.Roots.end();) {
+      const GCObject *Obj = GC.findObject(R->first);
+      if (Obj != nullptr && Obj->getModule() == Mod) {
+        R = GC.Roots.erase(R);
+      } else {
+        ++R;
+      }
+    }
+    for (auto &C : Heap->Chunks) {
+      GC.removeChunk(*C);
+    }
+    GC.HeapCount.fetch_sub(1, std::memory_order_relaxed);
+  }
+  GC.Modules.erase(It);
+}
+
+Runtime::Instance::StructInstance *
+Collector::newStruct(Runtime::StackManager &StackMgr,
+                     uint32_t TypeIdx) noexcept {
+  maybeCollect();
+  const auto &Mod = *StackMgr.getModule();
+  GCHeap &Heap = getHeap(Mod);
+  const GCLayout &L = *Heap.getLayout(TypeIdx);
+  std::unique_lock<std::mutex> Lock(Heap.Mutex);
+  uint8_t *Ptr = Heap.allocate(L.Size);
+  if (unlikely(Ptr == nullptr)) {
+    return nullptr;
+  }
+  YoungBytes.fetch_add(L.Size, std::memory_order_relaxed);
+  return new (Ptr) StructInstance(&Mod, TypeIdx, L);
+}
+
+Runtime::Instance::ArrayInstance *
+Collector::newArray(Runtime::StackManager &StackMgr, uint32_t TypeIdx,
+                    uint32_t Length) noexcept {
+  maybeCollect();
+  const auto &Mod = *StackMgr.getModule();
+  GCHeap &Heap = getHeap(Mod);
+  const GCLayout &L = *Heap.getLayout(TypeIdx);
+  const uint64_t Size = ArrayInstance::getObjectSize(L, Length);
+  std::unique_lock<std::mutex> Lock(Heap.Mutex);
+  uint8_t *Ptr = Heap.allocate(Size);
+  if (unlikely(Ptr == nullptr)) {
+    return nullptr;
+  }
+  YoungBytes.fetch_add(Size, std::memory_order_relaxed);
+  return new (Ptr) ArrayInstance(&Mod, TypeIdx, L, Length);
+}
+
+void Collector::maybeCollect() noexcept {
+  safepoint();
+  const uint64_t Young = YoungBytes.load(std::memory_order_relaxed);
+  if (likely(Young < NextCollect.load(std::memory_order_relaxed))) {
+    return;
+  }
+  if (!collect(false)) {
+    // Retry after the next nursery of allocations.
+    NextCollect.store(Young + kNurserySize, std::memory_order_relaxed);
+  }
+}
+
+void Collector::remember(GCObject &Obj) noexcept {
+  GCHeap &Heap = *Obj.getModule()->Heap.load(std::memory_order_acquire);
+  std::unique_lock<std::mutex> Lock(Heap.Mutex);
+  if (!(Obj.getFlags() & GCObject::kRemembered)) {
+    Obj.setFlags(GCObject::kRemembered);
+    Heap.Remembered.push_back(&Obj);
+  }
+}
+
+void Collector::pinRefs(Span<const ValType> Types,
+                        const ValVariant *Vals) noexcept {
+  // Called in the scope of the invocation, whose thread is running.
+  const Scope *S = getThread().Current;
+  if (S != nullptr && S->Prev != nullptr) {
+    for (size_t I = 0; I < Types.size(); ++I) {
+      if (Types[I].isRefType()) {
+        S->Prev->Pins.push_back(Vals[I].get<RefVariant>().getPtr<void>());
+      }
+    }
+    return;
+  }
+  // Only the GC objects are rooted, and the other references are kept by
+  // their owners.
+  std::unique_lock<std::mutex> Lock(Mutex);
+  for (size_t I = 0; I < Types.size(); ++I) {
+    if (Types[I].isRefType()) {
+      const void *Ptr = Vals[I].get<RefVariant>().getPtr<void>();
+      if (findObject(Ptr) != nullptr) {
+        ++Roots[Ptr];
+      }
+    }
+  }
+}
+
+void Collector::addChunk(GCHeap::Chunk &C) noexcept {
+  std::unique_lock<std::mutex> Lock(Mutex);
+  const auto Begin = reinterpret_cast<uintptr_t>(C.begin());
+  ChunkMap.emplace(Begin, &C);
+  MinAddr = std::min(MinAddr, Begin);
+  MaxAddr = std::max(MaxAddr, Begin + static_cast<uintptr_t>(C.Size));
+}
+
+void Collector::removeChunk(GCHeap::Chunk &C) noexcept {
+  ChunkMap.erase(reinterpret_cast<uintptr_t>(C.begin()));
+}
+
+GCObject *Collector::findObject(const void *Ptr) const noexcept {
+  const auto Addr = reinterpret_cast<uintptr_t>(Ptr);
+  if (Addr < MinAddr || Addr >= MaxAddr || (Addr & 7U) != 0) {
+    return nullptr;
+  }
+  auto It = ChunkMap.upper_bound(Addr);
+  if (It == ChunkMap.begin()) {
+    return nullptr;
+  }
+  const GCHeap::Chunk &C = *(--It)->second;
+  const auto *P = static_cast<const uint8_t *>(Ptr);
+  if (P >= C.end() || !C.isStart(P)) {
+    return nullptr;
+  }
+  return reinterpret_cast<GCObject *>(const_cast<uint8_t *>(P));
+}
+
+GCObject *Collector::findObjectContaining(const void *Ptr) const noexcept {
+  const auto Addr = reinterpret_cast<uintptr_t>(Ptr);
+  if (Addr < MinAddr || Addr >= MaxAddr) {
+    return nullptr;
+  }
+  auto It = ChunkMap.upper_bound(Addr);
+  if (It == ChunkMap.begin()) {
+    return nullptr;
+  }
+  const GCHeap::Chunk &C = *(--It)->second;
+  const auto *P = static_cast<const uint8_t *>(Ptr);
+  if (P >= C.end()) {
+    return nullptr;
+  }
+  // Find the last object start at or before the address.
+  const uint64_t G = static_cast<uint64_t>(P - C.begin()) / 8;
+  size_t W = G / 64;
+  uint64_t Bits = C.Starts[W] & (~UINT64_C(0) >> (63 - G % 64));
+  while (Bits == 0) {
+    if (W == 0) {
+      return nullptr;
+    }
+    Bits = C.Starts[--W];
+  }
+  auto *Obj = reinterpret_cast<GCObject *>(
+      C.begin() + (W * 64 + 63 - static_cast<uint64_t>(clz(Bits))) * 8);
+  if (P >= reinterpret_cast<const uint8_t *>(Obj) + getObjectSize(*Obj)) {
+    return nullptr;
+  }
+  return Obj;
+}
+
+bool Collector::collect(bool Full) noexcept {
+  const ThreadState &Self = getThread();
+  if (Self.Current != nullptr && !Self.Current->Collectable) {
+    return false;
+  }
+  bool Expected = false;
+  if (!Requested.compare_exchange_strong(Expected, true,
+                                         std::memory_order_seq_cst)) {
+    // Stop for the collection of the other thread.
+    park();
+    return false;
+  }
+  // The threads entering the running state wait after seeing the flag, and
+  // the running threads stop at their safepoints.
+  const bool Stopped = stopThreads(Self);
+  if (Stopped) {
+    std::unique_lock<std::mutex> Lock(Mutex);
+    collectLocked(Self, Full);
+  }
+  {
+    std::unique_lock<std::mutex> Lock(StopMutex);
+    Requested.store(false, std::memory_order_seq_cst);
+  }
+  StopCond.notify_all();
+  return Stopped;
+}
+
+bool Collector::isLive(const void *Ptr) const noexcept {
+  std::unique_lock<std::mutex> Lock(Mutex);
+  return findObject(Ptr) != nullptr;
+}
+
+Collector::Statistics Collector::getStatistics() const noexcept {
+  std::unique_lock<std::mutex> Lock(Mutex);
+  return Stat;
+}
+
+void Collector::collectLocked(const ThreadState &Self, bool Full) noexcept {
+  const auto Start = std::chrono::steady_clock::now();
+  Full = Full || Stat.LiveBytes >= FullThreshold;
+
+  if (Full) {
+    // Clear the marks of the old objects to trace all the objects.
+    for (auto &[Mod, Heap] : Modules) {
+      if (!Heap) {
+        continue;
+      }
+      for (auto &C : Heap->Chunks) {
+        for (size_t W = 0; W < C->Starts.size(); ++W) {
+          for (uint64_t Bits = C->Starts[W]; Bits != 0; Bits &= Bits - 1) {
+            auto *Obj = reinterpret_cast<GCObject *>(
+                C->begin() + (W * 64 + static_cast<uint64_t>(ctz(Bits))) * 8);
+            Obj->clearFlags(GCObject::kMarked);
+          }
+        }
+      }
+    }
+  }
+
+  markRoots(Self);
+  for (auto &[Mod, Heap] : Modules) {
+    if (!Heap) {
+      continue;
+    }
+    // The remembered old objects may refer to the young objects.
+    for (GCObject *Obj : Heap->Remembered) {
+      Obj->clearFlags(GCObject::kRemembered);
+      if (!Full) {
+        traceObject(*Obj);
+      }
+    }
+    Heap->Remembered.clear();
+  }
+  drain();
+
+  uint64_t Live = 0;
+  for (auto &[Mod, Heap] : Modules) {
+    if (!Heap) {
+      continue;
+    }
+    sweepHeap(*Heap, Full);
+    for (auto &C : Heap->Chunks) {
+      Live += C->LiveBytes;
+    }
+  }
+  Stat.LiveBytes = Live;
+  if (Full) {
+    FullThreshold = std::max(kMinFullSize, Live * 2);
+    ++Stat.FullCount;
+  } else {
+    ++Stat.MinorCount;
+  }
+  YoungBytes.store(0, std::memory_order_relaxed);
+  NextCollect.store(kNurserySize, std::memory_order_relaxed);
+
+  const auto Pause = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - Start)
+          .count());
+  Stat.TotalPauseNs += Pause;
+  Stat.MaxPauseNs = std::max(Stat.MaxPauseNs, Pause);
+}
+
+void Collector::markPtr(const void *Ptr) noexcept {
+  if (GCObject *Obj = findObject(Ptr)) {
+    markObject(*Obj);
+  }
+}
+
+void Collector::markObject(GCObject &Obj) noexcept {
+  if (!(Obj.getFlags() & GCObject::kMarked)) {
+    Obj.setFlags(GCObject::kMarked);
+    MarkStack.push_back(&Obj);
+  }
+}
+
+void Collector::traceObject(const GCObject &Obj) noexcept {
+  const GCLayout &L = Obj.getLayout();
+  RefVariant Ref;
+  if (!L.IsArray) {
+    const auto *Base = reinterpret_cast<const uint8_t *>(&Obj);
+    for (const uint32_t Offset : L.RefOffsets) {
+      std::memcpy(&Ref, Base + Offset, sizeof(RefVariant));
+      markPtr(Ref.getPtr<void>());
+    }
+  } else if (L.Types[0].isRefType()) {
+    const auto &Arr = static_cast<const ArrayInstance &>(Obj);
+    for (uint32_t I = 0; I < Arr.getLength(); ++I) {
+      std::memcpy(&Ref, Arr.getElemPtr(I), sizeof(RefVariant));
+      markPtr(Ref.getPtr<void>());
+    }
+  }
+}
+
+void Collector::markRoots(const ThreadState &Self) noexcept {
+  for (const ThreadState *Thread : Threads) {
+    for (const Scope *S = Thread->Current; S != nullptr; S = S->Prev) {
+      for (const auto &V : S->StackMgr.getValues()) {
+        // The value slots are untyped. The references are recognized by the
+        // type tags and the exact object starts, and the false ones are only
+        // retained.
+        const auto &Ref = V.get<RefVariant>();
+        if (Ref.getType().isRefType()) {
+          markPtr(Ref.getPtr<void>());
+        }
+      }
+      for (const void *Ptr : S->Pins) {
+        markPtr(Ptr);
+      }
+    }
+    if (Thread == &Self) {
+      markNativeStack(Thread->NativeStackBase);
+    } else if (Thread->NativeStackBase != nullptr) {
+      // The stopped thread spilled its registers under the stack top.
+      markNativeRange(reinterpret_cast<uintptr_t>(Thread->StackTop),
+                      reinterpret_cast<uintptr_t>(Thread->NativeStackBase));
+    }
+  }
+  for (const auto &Root : Roots) {
+    markPtr(Root.first);
+  }
+  for (auto &[Mod, Heap] : Modules) {
+    for (const auto *GlobInst : Mod->GlobInsts) {
+      if (GlobInst->getGlobalType().getValType().isRefType()) {
+        markPtr(GlobInst->getValue().get<RefVariant>().getPtr<void>());
+      }
+    }
+    for (const auto *TabInst : Mod->TabInsts) {
+      if (auto Refs = TabInst->getRefs(0, TabInst->getSize())) {
+        for (const auto &Ref : *Refs) {
+          markPtr(Ref.getPtr<void>());
+        }
+      }
+    }
+    for (const auto *ElemInst : Mod->ElemInsts) {
+      for (const auto &Ref : ElemInst->getRefs()) {
+        markPtr(Ref.getPtr<void>());
+      }
+    }
+  }
+}
+
+void Collector::markNativeStack(const void *Base) noexcept {
+  if (Base == nullptr) {
+    return;
+  }
+  // Spill the callee-saved registers into this frame, which may hold the
+  // references of the compiled functions.
+#if defined(_MSC_VER) && !defined(__clang__) // MSVC
+  std::jmp_buf Regs;
+  setjmp(Regs);
+#else
+  __builtin_unwind_init();
+#endif // MSVC
+  markNativeRange(reinterpret_cast<uintptr_t>(getCallerFrameEnd()),
+                  reinterpret_cast<uintptr_t>(Base));
+}
+
+void Collector::markNativeRange(uintptr_t Begin, uintptr_t End) noexcept {
+  // The compiled code may keep the addresses in the objects only, and so the
+  // words are looked up in the object ranges.
+  Begin = (Begin + 7U) & ~uintptr_t(7);
+  for (uintptr_t Addr = Begin; Addr + sizeof(uintptr_t) <= End;
+       Addr += sizeof(uintptr_t)) {
+    const void *Word;
+    std::memcpy(&Word, reinterpret_cast<const void *>(Addr), sizeof(Word));
+    if (GCObject *Obj = findObjectContaining(Word)) {
+      markObject(*Obj);
+    }
+  }
+}
+
+void Collector::drain() noexcept {
+  while (!MarkStack.empty()) {
+    const GCObject *Obj = MarkStack.back();
+    MarkStack.pop_back();
+    traceObject(*Obj);
+  }
+}
+
+void Collector::sweepHeap(GCHeap &Heap, bool Full) noexcept {
+  // The holes of the swept chunks are recomputed.
+  Heap.Holes.erase(std::remove_if(Heap.Holes.begin(), Heap.Holes.end(),
+                                  [Full](const GCHeap::Hole &H) {
+                                    return Full || H.Owner->Young;
+                                  }),
+                   Heap.Holes.end());
+  Heap.Current = nullptr;
+  Heap.Cursor = Heap.Limit = nullptr;
+
+  size_t EmptyChunks = 0;
+  for (size_t I = 0; I < Heap.Chunks.size();) {
+    GCHeap::Chunk &C = *Heap.Chunks[I];
+    if (!Full && !C.Young) {
+      ++I;
+      continue;
+    }
+    C.Young = false;
+    if (sweepChunk(Heap, C) != 0 ||
+        (!C.Large && ++EmptyChunks <= kMaxEmptyChunks)) {
+      ++I;
+      continue;
+    }
+    // Release the empty chunk and its hole.
+    while (!Heap.Holes.empty() && Heap.Holes.back().Owner == &C) {
+      Heap.Holes.pop_back();
+    }
+    removeChunk(C);
+    Heap.Chunks[I] = std::move(Heap.Chunks.back());
+    Heap.Chunks.pop_back();
+  }
+  Heap.YoungChunks.clear();
+}
+
+uint64_t Collector::sweepChunk(GCHeap &Heap, GCHeap::Chunk &C) noexcept {
+  uint64_t Live = 0;
+  uint8_t *Free = C.begin();
+  for (size_t W = 0; W < C.Starts.size(); ++W) {
+    for (uint64_t Bits = C.Starts[W]; Bits != 0; Bits &= Bits - 1) {
+      uint8_t *Ptr =
+          C.begin() + (W * 64 + static_cast<uint64_t>(ctz(Bits))) * 8;
+      const auto &Obj = *reinterpret_cast<const GCObject *>(Ptr);
+      const uint64_t Size = getObjectSize(Obj);
+      if (!(Obj.getFlags() & GCObject::kMarked)) {
+        C.clearStart(Ptr);
+        Stat.FreedBytes += Size;
+        continue;
+      }
+      if (static_cast<uint64_t>(Ptr - Free) >= kMinHoleSize) {
+        Heap.Holes.push_back({&C, Free, Ptr});
+      }
+      Free = Ptr + Size;
+      Live += Size;
+    }
+  }
+  if (!C.Large && static_cast<uint64_t>(C.end() - Free) >= kMinHoleSize) {
+    Heap.Holes.push_back({&C, Free, C.end()});
+  }
+  C.LiveBytes = Live;
+  return Live;
+}
+
+} // namespace Executor
+} // namespace WasmEdge
@@ -6,13 +6,87 @@
 #include "common/spdlog.h"
 #include "system/fault.h"
 
+#include <array>
 #include <cstdint>
+#include <cstring>
+#include <limits>
 #include <utility>
 #include <vector>
 
 namespace WasmEdge {
 namespace Executor {
 
+Expect<void>
+Executor::callHostFunction(const Runtime::Instance::ModuleInstance *ModInst,
+                           const Runtime::Instance::FunctionInstance &Func,
+                           Span<ValVariant> Args,
+                           Span<ValVariant> Rets) {
+  auto &HostFunc = Func.getHostFunc();
+  const auto &ParamTypes = Func.getFuncType().getParamTypes();
+
+  // Generate CallingFrame from the module instance of the caller.
+  Runtime::CallingFrame CallFrame(this, ModInst);
+
+  // Do the statistics if the statistics turned on.
+  if (Stat) {
+    // Check host function cost.
+    if (unlikely(!Stat->addCost(HostFunc.getCost()))) {
+      spdlog::error(ErrCode::Value::CostLimitExceeded);
+      return Unexpect(ErrCode::Value::CostLimitExceeded);
+    }
+    // Start recording time of running host function.
+    if (TimeMeasuring) {
+      Stat->stopRecordWasm();
+      Stat->startRecordHost();
+    }
+  }
+
+  // Call pre-host-function
+  HostFuncHelper.invokePreHostFunc();
+
+  // Run host function.
+  for (uint32_t I = 0; I < Args.size(); I++) {
+    // For the number type cases of the arguments, the unused bits should be
+    // erased due to the security issue.
+    cleanNumericVal(Args[I], ParamTypes[I]);
+  }
+  Expect<void> Ret;
+  {
+    // The GC objects passed to the host are pinned in this call.
+    Collector::HostCall GCHostCall(ParamTypes, Args.data());
+    Ret = HostFunc.run(CallFrame, Args, Rets);
+  }
+
+  // Call post-host-function
+  HostFuncHelper.invokePostHostFunc();
+
+  // Do the statistics if the statistics turned on.
+  if (Stat && TimeMeasuring) {
+    // Stop recording time of running host function.
+    Stat->stopRecordHost();
+    Stat->startRecordWasm();
+  }
+
+  // Check the host function execution status.
+  if (!Ret) {
+    if (Ret.error() == ErrCode::Value::HostFuncError ||
+        Ret.error().getCategory() != ErrCategory::WASM) {
+      spdlog::error(Ret.error());
+    }
+    return Unexpect(Ret);
+  }
+  return {};
+}
+
+Expect<void> Executor::checkStack(Runtime::StackManager &StackMgr,
+                                  uint64_t ValNum, uint32_t FrameNum) noexcept {
+  if (unlikely(!StackMgr.hasCapacity(ValNum, FrameNum))) {
+    spdlog::error(ErrCode::Value::StackOverflow);
+    return Unexpect(ErrCode::Value::StackOverflow);
+  }
+  return {};
+}
+
 Expect<AST::InstrView::iterator>
 Executor::enterFunction(Runtime::StackManager &StackMgr,
                         const Runtime::Instance::FunctionInstance &Func,
@@ -20,10 +94,12 @@ Executor::enterFunction(Runtime::StackManager &StackMgr,
   // RetIt: the return position when the entered function returns.
 
   // Check if the interruption occurs.
-  if (unlikely(StopToken.exchange(0, std::memory_order_relaxed))) {
+  if (unlikely(getStopToken().exchange(0, std::memory_order_relaxed))) {
     spdlog::error(ErrCode::Value::Interrupted);
     return Unexpect(ErrCode::Value::Interrupted);
   }
+  // Stop here if the other thread is collecting the GC heaps.
+  Collector::safepoint();
 
   // Get function type for the params and returns num.
   const auto &FuncType = Func.getFuncType();
@@ -37,16 +113,19 @@ Executor::enterFunction(Runtime::StackManager &StackMgr,
 
   if (Func.isHostFunction()) {
     // Host function case: Push args and call function.
-    auto &HostFunc = Func.getHostFunc();
 
-    // Generate CallingFrame from current frame.
     // The module instance will be nullptr if current frame is a dummy frame.
     // For this case, use the module instance of this host function.
     const auto *ModInst = StackMgr.getModule();
     if (ModInst == nullptr) {
       ModInst = Func.getModule();
     }
-    Runtime::CallingFrame CallFrame(this, ModInst);
+
+    // Check the room of the frame and the returns.
+    if (auto Res = checkStack(StackMgr, RetsN, IsTailCall ? 0 : 1);
+        unlikely(!Res)) {
+      return Unexpect(Res);
+    }
 
     // Push frame.
     StackMgr.pushFrame(Func.getModule(), // Module instance
@@ -56,53 +135,24 @@ Executor::enterFunction(Runtime::StackManager &StackMgr,
                        IsTailCall        // For tail-call
     );
 
-    // Do the statistics if the statistics turned on.
-    if (Stat) {
-      // Check host function cost.
-      if (unlikely(!Stat->addCost(HostFunc.getCost()))) {
-        spdlog::error(ErrCode::Value::CostLimitExceeded);
-        return Unexpect(ErrCode::Value::CostLimitExceeded);
-      }
-      // Start recording time of running host function.
-      Stat->stopRecordWasm();
-      Stat->startRecordHost();
-    }
-
-    // Call pre-host-function
-    HostFuncHelper.invokePreHostFunc();
-
-    // Run host function.
-    Span<ValVariant> Args = StackMgr.getTopSpan(ArgsN);
-    for (uint32_t I = 0; I < ArgsN; I++) {
-      // For the number type cases of the arguments, the unused bits should be
-      // erased due to the security issue.
-      cleanNumericVal(Args[I], FuncType.getParamTypes()[I]);
+    // Run host function. The returns of the common short lists are kept on
+    // the native stack.
+    std::array<ValVariant, kHostCallInlineVals> RetsBuf;
+    std::vector<ValVariant> RetsVec;
+    Span<ValVariant> Rets(RetsBuf.data(), RetsN);
+    if (unlikely(RetsN > RetsBuf.size())) {
+      RetsVec.resize(RetsN);
+      Rets = RetsVec;
     }
-    std::vector<ValVariant> Rets(RetsN);
-    auto Ret = HostFunc.run(CallFrame, std::move(Args), Rets);
-
-    // Call post-host-function
-    HostFuncHelper.invokePostHostFunc();
-
-    // Do the statistics if the statistics turned on.
-    if (Stat) {
-      // Stop recording time of running host function.
-      Stat->stopRecordHost();
-      Stat->startRecordWasm();
-    }
-
-    // Check the host function execution status.
-    if (!Ret) {
-      if (Ret.error() == ErrCode::Value::HostFuncError ||
-          Ret.error().getCategory() != ErrCategory::WASM) {
-        spdlog::error(Ret.error());
-      }
-      return Unexpect(Ret);
+    if (auto Res = callHostFunction(ModInst, Func, StackMgr.getTopSpan(ArgsN),
+                                    Rets);
+        unlikely(!Res)) {
+      return Unexpect(Res);
     }
 
     // Push returns back to stack.
     for (auto &R : Rets) {
-      StackMgr.push(std::move(R));
+      StackMgr.push(R);
     }
 
     // For host function case, the continuation will be the continuation from
@@ -112,6 +162,12 @@ Executor::enterFunction(Runtime::StackManager &StackMgr,
     // Compiled function case: Execute the function and jump to the
     // continuation.
 
+    // Check the room of the frame and the returns.
+    if (auto Res = checkStack(StackMgr, RetsN, IsTailCall ? 0 : 1);
+        unlikely(!Res)) {
+      return Unexpect(Res);
+    }
+
     // Push frame.
     StackMgr.pushFrame(Func.getModule(), // Module instance
                        RetIt,            // Return PC
@@ -139,9 +195,14 @@ Executor::enterFunction(Runtime::StackManager &StackMgr,
         std::atomic_store_explicit(MemoryPtr, DataPtr,
                                    std::memory_order_relaxed);
       }
-      prepare(StackMgr, ModInst->MemoryPtrs.data(), ModInst->GlobalPtrs.data());
+      prepare(StackMgr, ModInst->MemoryPtrs.data(),
+              ModInst->MemorySizePtrs.data(), ModInst->GlobalPtrs.data(),
+              ModInst->HostFuncPtrs.data());
     }
 
+    // The native frames of the compiled functions are scanned for the
+    // references in the collections.
+    Collector::NativeScope NativeScope;
     ErrCode Err;
     try {
       // Get symbol and execute the function.
@@ -150,7 +211,7 @@ Executor::enterFunction(Runtime::StackManager &StackMgr,
       if (Code != 0) {
         Err = ErrCode(static_cast<ErrCategory>(Code >> 24), Code);
       } else {
-        auto &Wrapper = FuncType.getSymbol();
+        auto &Wrapper = Func.getWrapperSymbol();
         Wrapper(&ExecutionContext, Func.getSymbol().get(), Args.data(),
                 Rets.data());
       }
@@ -175,6 +236,58 @@ Executor::enterFunction(Runtime::StackManager &StackMgr,
   } else {
     // Native function case: Jump to the start of the function body.
 
+    // Decode and validate the lazy loaded body at the first call.
+    if (auto Res = Func.loadLazyBody(); unlikely(!Res)) {
+      return Unexpect(Res);
+    }
+
+    // Count the calls for the tiered execution.
+    countTierUp(Func);
+
+    // Run the register code of the function without the statistics, lowered
+    // at the first call. The frame is popped here, and the continuation is
+    // the next instruction of the caller.
+    if (Conf.getRuntimeConfigure().isEnableRegisterInterpreter() &&
+        !(Stat && (Conf.getStatisticsConfigure().isInstructionCounting() ||
+                   Conf.getStatisticsConfigure().isCostMeasuring()))) {
+      if (const auto *Code = Func.getRegisterCode(
+              [this](const Runtime::Instance::FunctionInstance &F) {
+                return lowerRegisterCode(F);
+              })) {
+        if (auto Res = checkStack(StackMgr,
+                                  static_cast<uint64_t>(Func.getLocalNum()) +
+                                      Func.getStackHeight() +
+                                      Code->Consts.size() + kStackHeadroom,
+                                  IsTailCall ? 0 : 1);
+            unlikely(!Res)) {
+          return Unexpect(Res);
+        }
+        for (auto &Def : Func.getLocals()) {
+          for (uint32_t I = 0; I < Def.first; I++) {
+            StackMgr.push(ValueFromType(Def.second));
+          }
+        }
+        StackMgr.pushFrame(Func.getModule(), RetIt - 1,
+                           ArgsN + Func.getLocalNum(), RetsN, IsTailCall,
+                           &Func);
+        if (auto Res = runRegisterCode(StackMgr, Func, *Code);
+            unlikely(!Res)) {
+          return Unexpect(Res);
+        }
+        return StackMgr.popFrame() + 1;
+      }
+    }
+
+    // Check the room of the frame, the locals, and the operands. The values
+    // pushed by the instructions never exceed the validated stack height.
+    if (auto Res = checkStack(StackMgr,
+                              static_cast<uint64_t>(Func.getLocalNum()) +
+                                  Func.getStackHeight() + kStackHeadroom,
+                              IsTailCall ? 0 : 1);
+        unlikely(!Res)) {
+      return Unexpect(Res);
+    }
+
     // Push local variables into the stack.
     for (auto &Def : Func.getLocals()) {
       for (uint32_t I = 0; I < Def.first; I++) {
@@ -189,7 +302,8 @@ Executor::enterFunction(Runtime::StackManager &StackMgr,
                        RetIt - 1,                  // Return PC
                        ArgsN + Func.getLocalNum(), // Arguments num + local num
                        RetsN,                      // Returns num
-                       IsTailCall                  // For tail-call
+                       IsTailCall,                 // For tail-call
+                       &Func                       // Function instance
     );
 
     // For native function case, the continuation will be the start of the
@@ -198,15 +312,37 @@ Executor::enterFunction(Runtime::StackManager &StackMgr,
   }
 }
 
+void Executor::countTierUp(
+    const Runtime::Instance::FunctionInstance &Func) noexcept {
+  const uint32_t Threshold = TierUpThreshold.load(std::memory_order_acquire);
+  if (likely(Threshold == 0) || !Func.countHotness(Threshold)) {
+    return;
+  }
+  // The callback may be replaced concurrently, so invoke the loaded one.
+  if (const auto Callback = std::atomic_load(&TierUpFunc)) {
+    (*Callback)(Func);
+  }
+}
+
 Expect<void>
 Executor::branchToLabel(Runtime::StackManager &StackMgr,
                         const AST::Instruction::JumpDescriptor &JumpDesc,
                         AST::InstrView::iterator &PC) noexcept {
   // Check the stop token.
-  if (unlikely(StopToken.exchange(0, std::memory_order_relaxed))) {
+  if (unlikely(getStopToken().exchange(0, std::memory_order_relaxed))) {
     spdlog::error(ErrCode::Value::Interrupted);
     return Unexpect(ErrCode::Value::Interrupted);
   }
+  // Stop here if the other thread is collecting the GC heaps.
+  Collector::safepoint();
+
+  // Count the loop back-edges for the tiered execution. The running frame
+  // stays interpreted, and the following calls enter the compiled code.
+  if (JumpDesc.PCOffset < 0) {
+    if (const auto *Func = StackMgr.getFunction()) {
+      countTierUp(*Func);
+    }
+  }
 
   StackMgr.eraseValueStack(JumpDesc.StackEraseBegin, JumpDesc.StackEraseEnd);
   // PC need to -1 here because the PC will increase in the next iteration.
@@ -408,5 +544,228 @@ void Executor::cleanNumericVal(ValVariant &Val,
   }
 }
 
+Expect<uint64_t> Executor::getEffectiveAddress(
+    const Runtime::Instance::MemoryInstance &MemInst, const ValVariant &Addr,
+    const AST::Instruction &Instr, uint64_t Length) const noexcept {
+  // The offset of the 32-bit memories is in the u32 range after validation,
+  // so only the 64-bit addresses may overflow.
+  if (!MemInst.is64()) {
+    return static_cast<uint64_t>(Addr.get<uint32_t>()) +
+           Instr.getMemoryOffset();
+  }
+  const uint64_t A = Addr.get<uint64_t>();
+  if (unlikely(A > std::numeric_limits<uint64_t>::max() -
+                       Instr.getMemoryOffset())) {
+    spdlog::error(ErrCode::Value::MemoryOutOfBounds);
+    spdlog::error(
+        ErrInfo::InfoBoundary(A, Length, MemInst.getBoundIdx()));
+    spdlog::error(
+        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
+    return Unexpect(ErrCode::Value::MemoryOutOfBounds);
+  }
+  return A + Instr.getMemoryOffset();
+}
+
+Expect<Runtime::Instance::ArrayInstance *>
+Executor::allocArray(Runtime::StackManager &StackMgr, uint32_t DefIndex,
+                     uint32_t Length) const noexcept {
+  auto *Inst = Collector::getInstance().newArray(StackMgr, DefIndex, Length);
+  if (unlikely(Inst == nullptr)) {
+    spdlog::error(ErrCode::Value::OutOfMemory);
+    return Unexpect(ErrCode::Value::OutOfMemory);
+  }
+  return Inst;
+}
+
+Expect<RefVariant>
+Executor::newArrayFromData(Runtime::StackManager &StackMgr, uint32_t DefIndex,
+                           const Runtime::Instance::DataInstance &DataInst,
+                           uint32_t S, uint32_t N) const noexcept {
+  const auto &CompType = getDefTypeByIdx(StackMgr, DefIndex)->getCompositeType();
+  const uint32_t BSize =
+      CompType.getFieldTypes()[0].getStorageType().getBitWidth() / 8;
+  if (static_cast<uint64_t>(S) + static_cast<uint64_t>(N) * BSize >
+      DataInst.getData().size()) {
+    spdlog::error(ErrCode::Value::MemoryOutOfBounds);
+    spdlog::error(ErrInfo::InfoBoundary(
+        static_cast<uint64_t>(S), N * BSize,
+        DataInst.getData().size() > 0
+            ? static_cast<uint32_t>(DataInst.getData().size() - 1)
+            : 0U));
+    return Unexpect(ErrCode::Value::MemoryOutOfBounds);
+  }
+  auto Res = allocArray(StackMgr, DefIndex, N);
+  if (unlikely(!Res)) {
+    return Unexpect(Res);
+  }
+  auto *Inst = *Res;
+  // The elements are stored in the same little-endian bytes as the data.
+  std::memcpy(Inst->getElemPtr(0), DataInst.getData().data() + S,
+              static_cast<size_t>(N) * BSize);
+  return RefVariant(Inst->getDefType(), Inst);
+}
+
+Expect<RefVariant>
+Executor::newArrayFromElem(Runtime::StackManager &StackMgr, uint32_t DefIndex,
+                           const Runtime::Instance::ElementInstance &ElemInst,
+                           uint32_t S, uint32_t N) const noexcept {
+  auto ElemSrc = ElemInst.getRefs();
+  if (static_cast<uint64_t>(S) + static_cast<uint64_t>(N) > ElemSrc.size()) {
+    spdlog::error(ErrCode::Value::TableOutOfBounds);
+    spdlog::error(ErrInfo::InfoBoundary(
+        static_cast<uint64_t>(S), N,
+        ElemSrc.size() > 0 ? static_cast<uint32_t>(ElemSrc.size() - 1) : 0U));
+    return Unexpect(ErrCode::Value::TableOutOfBounds);
+  }
+  auto Res = allocArray(StackMgr, DefIndex, N);
+  if (unlikely(!Res)) {
+    return Unexpect(Res);
+  }
+  auto *Inst = *Res;
+  for (uint32_t I = 0; I < N; I++) {
+    Inst->setData(I, ElemSrc[S + I]);
+  }
+  return RefVariant(Inst->getDefType(), Inst);
+}
+
+Expect<void> Executor::fillArray(const RefVariant &InstRef, uint32_t D,
+                                 uint32_t N,
+                                 const ValVariant &Val) const noexcept {
+  auto *Inst = InstRef.getPtr<Runtime::Instance::ArrayInstance>();
+  if (Inst == nullptr) {
+    spdlog::error(ErrCode::Value::AccessNullArray);
+    return Unexpect(ErrCode::Value::AccessNullArray);
+  }
+  if (static_cast<uint64_t>(D) + static_cast<uint64_t>(N) > Inst->getLength()) {
+    spdlog::error(ErrCode::Value::ArrayOutOfBounds);
+    spdlog::error(ErrInfo::InfoBoundary(static_cast<uint64_t>(D), N,
+                                        Inst->getBoundIdx()));
+    return Unexpect(ErrCode::Value::ArrayOutOfBounds);
+  }
+  if (N > 0 && Inst->getLayout().Types[0].isRefType()) {
+    Collector::getInstance().writeBarrier(*Inst);
+  }
+  Inst->fill(D, N, Val);
+  return {};
+}
+
+Expect<void> Executor::copyArray(const RefVariant &DstInstRef, uint32_t D,
+                                 const RefVariant &SrcInstRef, uint32_t S,
+                                 uint32_t N) const noexcept {
+  auto *SrcInst = SrcInstRef.getPtr<Runtime::Instance::ArrayInstance>();
+  auto *DstInst = DstInstRef.getPtr<Runtime::Instance::ArrayInstance>();
+  if (SrcInst == nullptr || DstInst == nullptr) {
+    spdlog::error(ErrCode::Value::AccessNullArray);
+    return Unexpect(ErrCode::Value::AccessNullArray);
+  }
+  if (static_cast<uint64_t>(S) + static_cast<uint64_t>(N) >
+      SrcInst->getLength()) {
+    spdlog::error(ErrCode::Value::ArrayOutOfBounds);
+    spdlog::error(ErrInfo::InfoBoundary(static_cast<uint64_t>(S), N,
+                                        SrcInst->getBoundIdx()));
+    return Unexpect(ErrCode::Value::ArrayOutOfBounds);
+  }
+  if (static_cast<uint64_t>(D) + static_cast<uint64_t>(N) >
+      DstInst->getLength()) {
+    spdlog::error(ErrCode::Value::ArrayOutOfBounds);
+    spdlog::error(ErrInfo::InfoBoundary(static_cast<uint64_t>(D), N,
+                                        DstInst->getBoundIdx()));
+    return Unexpect(ErrCode::Value::ArrayOutOfBounds);
+  }
+  // The element types are matched in validation, and so are the storage sizes.
+  assuming(SrcInst->getElemSize() == DstInst->getElemSize());
+  if (N > 0 && DstInst->getLayout().Types[0].isRefType()) {
+    Collector::getInstance().writeBarrier(*DstInst);
+  }
+  std::memmove(DstInst->getElemPtr(D), SrcInst->getElemPtr(S),
+               static_cast<size_t>(N) * DstInst->getElemSize());
+  return {};
+}
+
+Expect<void>
+Executor::initArrayFromData(const RefVariant &InstRef, uint32_t D,
+                            const Runtime::Instance::DataInstance &DataInst,
+                            uint32_t S, uint32_t N) const noexcept {
+  auto *Inst = InstRef.getPtr<Runtime::Instance::ArrayInstance>();
+  if (Inst == nullptr) {
+    spdlog::error(ErrCode::Value::AccessNullArray);
+    return Unexpect(ErrCode::Value::AccessNullArray);
+  }
+  const uint32_t BSize = Inst->getElemSize();
+  if (static_cast<uint64_t>(D) + static_cast<uint64_t>(N) > Inst->getLength()) {
+    spdlog::error(ErrCode::Value::ArrayOutOfBounds);
+    spdlog::error(ErrInfo::InfoBoundary(static_cast<uint64_t>(D), N,
+                                        Inst->getBoundIdx()));
+    return Unexpect(ErrCode::Value::ArrayOutOfBounds);
+  }
+  if (static_cast<uint64_t>(S) + static_cast<uint64_t>(N) * BSize >
+      DataInst.getData().size()) {
+    spdlog::error(ErrCode::Value::MemoryOutOfBounds);
+    spdlog::error(ErrInfo::InfoBoundary(
+        static_cast<uint64_t>(S), N * BSize,
+        DataInst.getData().size() > 0
+            ? static_cast<uint32_t>(DataInst.getData().size() - 1)
+            : 0U));
+    return Unexpect(ErrCode::Value::MemoryOutOfBounds);
+  }
+  // The elements are stored in the same little-endian bytes as the data.
+  std::memcpy(Inst->getElemPtr(D), DataInst.getData().data() + S,
+              static_cast<size_t>(N) * BSize);
+  return {};
+}
+
+Expect<void>
+Executor::initArrayFromElem(const RefVariant &InstRef, uint32_t D,
+                            const Runtime::Instance::ElementInstance &ElemInst,
+                            uint32_t S, uint32_t N) const noexcept {
+  auto ElemSrc = ElemInst.getRefs();
+  auto *Inst = InstRef.getPtr<Runtime::Instance::ArrayInstance>();
+  if (Inst == nullptr) {
+    spdlog::error(ErrCode::Value::AccessNullArray);
+    return Unexpect(ErrCode::Value::AccessNullArray);
+  }
+  if (static_cast<uint64_t>(D) + static_cast<uint64_t>(N) > Inst->getLength()) {
+    spdlog::error(ErrCode::Value::ArrayOutOfBounds);
+    spdlog::error(ErrInfo::InfoBoundary(static_cast<uint64_t>(D), N,
+                                        Inst->getBoundIdx()));
+    return Unexpect(ErrCode::Value::ArrayOutOfBounds);
+  }
+  if (static_cast<uint64_t>(S) + static_cast<uint64_t>(N) > ElemSrc.size()) {
+    spdlog::error(ErrCode::Value::TableOutOfBounds);
+    spdlog::error(ErrInfo::InfoBoundary(
+        static_cast<uint64_t>(S), N,
+        ElemSrc.size() > 0 ? static_cast<uint32_t>(ElemSrc.size() - 1) : 0U));
+    return Unexpect(ErrCode::Value::TableOutOfBounds);
+  }
+  if (N > 0) {
+    Collector::getInstance().writeBarrier(*Inst);
+  }
+  for (uint32_t Off = 0; Off < N; Off++) {
+    Inst->setData(D + Off, ElemSrc[S + Off]);
+  }
+  return {};
+}
+
+bool Executor::matchRefType(const Runtime::Instance::ModuleInstance *ModInst,
+                            const ValType &Type,
+                            const RefVariant &Ref) const noexcept {
+  // The externalized references are matched as the external references.
+  ValType VT = Ref.getType();
+  if (VT.isExternalized()) {
+    VT = ValType(TypeCode::Ref, TypeCode::ExternRef);
+  }
+  Span<const AST::SubType *const> GotTypeList = ModInst->getTypeList();
+  if (!VT.isAbsHeapType()) {
+    auto *Inst = Ref.getPtr<Runtime::Instance::CompositeBase>();
+    // Reference must not be nullptr here because the null references are typed
+    // with the least abstract heap type.
+    if (Inst->getModule()) {
+      GotTypeList = Inst->getModule()->getTypeList();
+    }
+  }
+  return AST::TypeMatcher::matchType(ModInst->getTypeList(), Type, GotTypeList,
+                                     VT);
+}
+
 } // namespace Executor
 } // namespace WasmEdge
@@ -19,7 +19,7 @@ Expect<void> Executor::instantiate(Runtime::StackManager &StackMgr,
 
   // Iterate through the data segments to instantiate data instances.
   for (const auto &DataSeg : DataSec.getContent()) {
-    uint32_t Offset = 0;
+    uint64_t Offset = 0;
     // Initialize memory if the data mode is active.
     if (DataSeg.getMode() == AST::DataSegment::DataMode::Active) {
       // Run initialize expression.
@@ -29,16 +29,21 @@ Expect<void> Executor::instantiate(Runtime::StackManager &StackMgr,
         spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Seg_Data));
         return Unexpect(Res);
       }
-      Offset = StackMgr.pop().get<uint32_t>();
+      // The offset is of the address type of the memory.
+      auto *MemInst = getMemInstByIdx(StackMgr, DataSeg.getIdx());
+      assuming(MemInst);
+      if (MemInst->is64()) {
+        Offset = StackMgr.pop().get<uint64_t>();
+      } else {
+        Offset = StackMgr.pop().get<uint32_t>();
+      }
 
       // Check boundary unless ReferenceTypes or BulkMemoryOperations proposal
       // enabled.
       if (!Conf.hasProposal(Proposal::ReferenceTypes) &&
           !Conf.hasProposal(Proposal::BulkMemoryOperations)) {
         // Memory index should be 0. Checked in validation phase.
-        auto *MemInst = getMemInstByIdx(StackMgr, DataSeg.getIdx());
         // Check data fits.
-        assuming(MemInst);
         if (!MemInst->checkAccessBound(
                 Offset, static_cast<uint32_t>(DataSeg.getData().size()))) {
           spdlog::error(ErrCode::Value::DataSegDoesNotFit);
@@ -68,7 +73,7 @@ Expect<void> Executor::initMemory(Runtime::StackManager &StackMgr,
 
       auto *DataInst = getDataInstByIdx(StackMgr, Idx);
       assuming(DataInst);
-      const uint32_t Off = DataInst->getOffset();
+      const uint64_t Off = DataInst->getOffset();
 
       // Replace mem[Off : Off + n] with data[0 : n].
       if (auto Res = MemInst->setBytes(
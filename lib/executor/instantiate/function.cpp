@@ -37,10 +37,15 @@ Expect<void> Executor::instantiate(Runtime::Instance::ModuleInstance &ModInst,
     // Iterate through the code segments to instantiate function instances.
     for (uint32_t I = 0; I < CodeSegs.size(); ++I) {
       // Create and add the function instance into the module instance.
-      ModInst.addFunc(
-          TypeIdxs[I],
-          (*ModInst.getType(TypeIdxs[I]))->getCompositeType().getFuncType(),
-          CodeSegs[I].getLocals(), CodeSegs[I].getExpr().getInstrs());
+      const auto &FuncType =
+          (*ModInst.getType(TypeIdxs[I]))->getCompositeType().getFuncType();
+      if (const auto &Lazy = CodeSegs[I].getLazyBody()) {
+        // The lazy loaded body is decoded at the first call.
+        ModInst.addFunc(TypeIdxs[I], FuncType, CodeSegs[I].getLocals(), Lazy);
+      } else {
+        ModInst.addFunc(TypeIdxs[I], FuncType, CodeSegs[I].getLocals(),
+                        CodeSegs[I].getExpr());
+      }
     }
   }
   return {};
@@ -6,6 +6,8 @@
 #include "common/errinfo.h"
 #include "common/spdlog.h"
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
 #include <string_view>
 #include <utility>
@@ -33,7 +35,7 @@ auto logUnknownError(std::string_view ModName, std::string_view ExtName,
 }
 
 bool matchLimit(const AST::Limit &Exp, const AST::Limit &Got) {
-  if (Exp.isShared() != Got.isShared()) {
+  if (Exp.isShared() != Got.isShared() || Exp.is64() != Got.is64()) {
     return false;
   }
   if ((Got.getMin() < Exp.getMin()) || (Exp.hasMax() && !Got.hasMax())) {
@@ -206,6 +208,26 @@ Expect<void> Executor::instantiate(Runtime::StoreManager &StoreMgr,
       }
       // Set the matched function address to module instance.
       ModInst.importFunction(ImpInst);
+      // Bind the import stub of the compiled functions to the native entry of
+      // the host function. The functions with references in the types are
+      // called through the executor, which pins the references.
+      std::array<void *, 2> HostFuncPtr = {nullptr, nullptr};
+      if (ImpInst->isHostFunction()) {
+        auto &HostFunc = ImpInst->getHostFunc();
+        const auto &HostFuncType = HostFunc.getFuncType();
+        auto IsNumType = [](const ValType &VType) {
+          return VType.isNumType();
+        };
+        if (HostFunc.getNativeEntry() &&
+            std::all_of(HostFuncType.getParamTypes().begin(),
+                        HostFuncType.getParamTypes().end(), IsNumType) &&
+            std::all_of(HostFuncType.getReturnTypes().begin(),
+                        HostFuncType.getReturnTypes().end(), IsNumType)) {
+          HostFuncPtr = {reinterpret_cast<void *>(HostFunc.getNativeEntry()),
+                         &HostFunc};
+        }
+      }
+      ModInst.HostFuncPtrs.push_back(HostFuncPtr);
       break;
     }
     case ExternalType::Table: {
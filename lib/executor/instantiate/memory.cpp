@@ -2,6 +2,7 @@
 // SPDX-FileCopyrightText: 2019-2022 Second State INC
 
 #include "executor/executor.h"
+#include "system/allocator.h"
 
 #include <cstdint>
 
@@ -15,11 +16,27 @@ Expect<void> Executor::instantiate(Runtime::Instance::ModuleInstance &ModInst,
   ModInst.MemoryPtrs.resize(ModInst.getMemoryNum() +
                             MemSec.getContent().size());
 
+  // Reserve the linear memory pool if requested. The pool is shared in the
+  // process and only the first call maps it, so the later instantiations only
+  // check the result without locking.
+  if (const uint32_t PoolSize = Conf.getRuntimeConfigure().getMemoryPoolSize();
+      PoolSize > 0 && !MemSec.getContent().empty()) {
+    Allocator::reservePool(PoolSize);
+  }
+
   // Iterate through the memory types to instantiate memory instances.
   for (const auto &MemType : MemSec.getContent()) {
     // Create and add the memory instance into the module instance.
     ModInst.addMemory(MemType, Conf.getRuntimeConfigure().getMaxMemoryPage());
   }
+
+  // The byte sizes of the memories are read by the bound checks of the 64-bit
+  // memories in the compiled functions. The instances are not moved after
+  // added, so the pointers are kept.
+  ModInst.MemorySizePtrs.resize(ModInst.getMemoryNum());
+  for (uint32_t I = 0; I < ModInst.getMemoryNum(); ++I) {
+    ModInst.MemorySizePtrs[I] = (*ModInst.getMemory(I))->getDataSizePtr();
+  }
   return {};
 }
 
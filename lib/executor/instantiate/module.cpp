@@ -24,7 +24,7 @@ Executor::instantiate(Runtime::StoreManager &StoreMgr, const AST::Module &Mod,
   }
 
   // Create the stack manager.
-  Runtime::StackManager StackMgr;
+  Runtime::StackManager StackMgr(Conf.getRuntimeConfigure().getStackSize());
 
   // Check is module name duplicated when trying to registration.
   if (Name.has_value()) {
@@ -44,6 +44,12 @@ Executor::instantiate(Runtime::StoreManager &StoreMgr, const AST::Module &Mod,
     ModInst = std::make_unique<Runtime::Instance::ModuleInstance>("");
   }
 
+  // The globals, tables, and elements of the module instance are the roots of
+  // the GC heaps. The objects in the partially initialized instances are not
+  // collected before the start function.
+  Collector::getInstance().link(*ModInst);
+  std::optional<Collector::Scope> GCScope(std::in_place, StackMgr, false);
+
   // Instantiate Function Types in Module Instance. (TypeSec)
   for (auto &SubType : Mod.getTypeSection().getContent()) {
     // Copy defined types to module instance.
@@ -76,6 +82,10 @@ Executor::instantiate(Runtime::StoreManager &StoreMgr, const AST::Module &Mod,
   instantiate(*ModInst, TagSec);
 
   // Push a new frame {ModInst, locals:none}
+  if (auto Res = checkStack(StackMgr, 0); unlikely(!Res)) {
+    StoreMgr.recycleModule(std::move(ModInst));
+    return Unexpect(Res);
+  }
   StackMgr.pushFrame(ModInst.get(), AST::InstrView::iterator(), 0, 0);
 
   // Instantiate GlobalSection (GlobalSec)
@@ -144,6 +154,10 @@ Executor::instantiate(Runtime::StoreManager &StoreMgr, const AST::Module &Mod,
     // Get function instance.
     const auto *FuncInst = ModInst->getStartFunc();
 
+    // The start function is collectable as the invocations.
+    GCScope.reset();
+    GCScope.emplace(StackMgr, true);
+
     // Execute instruction.
     if (auto Res = runFunction(StackMgr, *FuncInst, {}); unlikely(!Res)) {
       spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
@@ -6,6 +6,7 @@
 
 #include "common/errcode.h"
 #include "host/wasi/environ.h"
+#include "iouring.h"
 #include "linux.h"
 
 namespace WasmEdge {
@@ -122,6 +123,17 @@ WasiExpect<void> Environ::schedYield() const noexcept {
   return {};
 }
 
+void Environ::selectIOBackend(bool EnableIOUring, uint64_t MaxBufferSize,
+                              Span<uint8_t> Memory) noexcept {
+#if WASMEDGE_WASI_IO_URING
+  IOUring::select(EnableIOUring, MaxBufferSize, Memory);
+#else
+  static_cast<void>(EnableIOUring);
+  static_cast<void>(MaxBufferSize);
+  static_cast<void>(Memory);
+#endif
+}
+
 } // namespace WASI
 } // namespace Host
 } // namespace WasmEdge
@@ -118,6 +118,8 @@ WasiExpect<void> Environ::schedYield() const noexcept {
   return {};
 }
 
+void Environ::selectIOBackend(bool, uint64_t, Span<uint8_t>) noexcept {}
+
 } // namespace WASI
 } // namespace Host
 } // namespace WasmEdge
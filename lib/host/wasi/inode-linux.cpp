@@ -9,6 +9,7 @@
 #include "host/wasi/environ.h"
 #include "host/wasi/inode.h"
 #include "host/wasi/vfs.h"
+#include "iouring.h"
 #include "linux.h"
 #include <algorithm>
 #include <cstddef>
@@ -17,6 +18,7 @@
 #include <new>
 #include <string>
 #include <string_view>
+#include <sys/syscall.h>
 #include <vector>
 
 namespace WasmEdge {
@@ -128,6 +130,97 @@ createNullTerminatedString(std::string_view View) noexcept {
   return {CStr, std::move(Buffer)};
 }
 
+bool isNonBlock(int Fd) noexcept {
+  const int Flags = ::fcntl(Fd, F_GETFL);
+  return Flags >= 0 && (Flags & O_NONBLOCK);
+}
+
+#if WASMEDGE_WASI_IO_URING
+/// Get the io_uring backend if selected. The nonblocking fds keep the
+/// syscalls, since the requests wait for the readiness instead of failing
+/// with EAGAIN.
+IOUring *currentRing(const FdHolder &Node) noexcept {
+  return Node.NonBlock ? nullptr : IOUring::current();
+}
+
+/// The writes to the regular files complete in the page cache, and the small
+/// writes rarely wait, but the ring hands them to its io-wq workers. So they
+/// keep the syscalls, and only the writes of at least the pipe buffer size
+/// to the pipes, sockets and devices are submitted.
+inline constexpr const size_t kMinRingWriteSize = 65536;
+
+IOUring *writeRing(const FdHolder &Node,
+                   Span<Span<const uint8_t>> IOVs) noexcept {
+  auto *Ring = currentRing(Node);
+  if (!Ring) {
+    return nullptr;
+  }
+  size_t Size = 0;
+  for (const auto &IOV : IOVs) {
+    Size += IOV.size();
+  }
+  if (Size < kMinRingWriteSize) {
+    return nullptr;
+  }
+  struct stat Stat;
+  if (::fstat(Node.Fd, &Stat) != 0 || S_ISREG(Stat.st_mode)) {
+    return nullptr;
+  }
+  return Ring;
+}
+#endif
+
+/// The socket calls through the io_uring backend if selected.
+WasiExpect<int> sysAccept(const FdHolder &Node) noexcept {
+  const int Fd = Node.Fd;
+#if WASMEDGE_WASI_IO_URING
+  if (auto *Ring = currentRing(Node)) {
+    return Ring->accept(Fd);
+  }
+#endif
+  if (auto NewFd = ::accept(Fd, nullptr, nullptr); unlikely(NewFd < 0)) {
+    return WasiUnexpect(fromErrNo(errno));
+  } else {
+    return NewFd;
+  }
+}
+
+WasiExpect<__wasi_size_t> sysRecvmsg(const FdHolder &Node, msghdr &MsgHdr,
+                                     int Flags) noexcept {
+  const int Fd = Node.Fd;
+#if WASMEDGE_WASI_IO_URING
+  if (auto *Ring = currentRing(Node)) {
+    return Ring->recvmsg(Fd, MsgHdr, Flags);
+  }
+#endif
+  if (auto Res = ::recvmsg(Fd, &MsgHdr, Flags); unlikely(Res < 0)) {
+    return WasiUnexpect(fromErrNo(errno));
+  } else {
+    return static_cast<__wasi_size_t>(Res);
+  }
+}
+
+WasiExpect<__wasi_size_t> sysSendmsg(const FdHolder &Node,
+                                     const msghdr &MsgHdr, int Flags) noexcept {
+  const int Fd = Node.Fd;
+#if WASMEDGE_WASI_IO_URING
+  if (auto *Ring = currentRing(Node)) {
+    size_t Size = 0;
+    for (size_t I = 0; I < MsgHdr.msg_iovlen; ++I) {
+      Size += MsgHdr.msg_iov[I].iov_len;
+    }
+    if (Size >= kMinRingWriteSize) {
+      return Ring->sendmsg(Fd, MsgHdr, Flags);
+    }
+  }
+#endif
+  if (auto Res = ::sendmsg(Fd, &MsgHdr, Flags); unlikely(Res < 0)) {
+    return WasiUnexpect(fromErrNo(errno));
+  } else {
+    return static_cast<__wasi_size_t>(Res);
+  }
+}
+
 } // namespace
 
 void FdHolder::reset() noexcept {
@@ -154,11 +247,17 @@ void DirHolder::reset() noexcept {
   }
 }
 
-INode INode::stdIn() noexcept { return INode(STDIN_FILENO); }
+INode INode::stdIn() noexcept {
+  return INode(STDIN_FILENO, true, false, isNonBlock(STDIN_FILENO));
+}
 
-INode INode::stdOut() noexcept { return INode(STDOUT_FILENO); }
+INode INode::stdOut() noexcept {
+  return INode(STDOUT_FILENO, true, false, isNonBlock(STDOUT_FILENO));
+}
 
-INode INode::stdErr() noexcept { return INode(STDERR_FILENO); }
+INode INode::stdErr() noexcept {
+  return INode(STDERR_FILENO, true, false, isNonBlock(STDERR_FILENO));
+}
 
 WasiExpect<INode> INode::open(std::string Path, __wasi_oflags_t OpenFlags,
                               __wasi_fdflags_t FdFlags,
@@ -168,7 +267,8 @@ WasiExpect<INode> INode::open(std::string Path, __wasi_oflags_t OpenFlags,
   if (auto NewFd = ::open(Path.c_str(), Flags, 0644); unlikely(NewFd < 0)) {
     return WasiUnexpect(fromErrNo(errno));
   } else {
-    INode New(NewFd, true, FdFlags & __WASI_FDFLAGS_APPEND);
+    INode New(NewFd, true, FdFlags & __WASI_FDFLAGS_APPEND,
+              FdFlags & __WASI_FDFLAGS_NONBLOCK);
 
 #ifndef O_CLOEXEC
     if (auto Res = ::fcntl(New.Fd, F_SETFD, FD_CLOEXEC); unlikely(Res != 0)) {
@@ -258,6 +358,7 @@ INode::fdFdstatSetFlags(__wasi_fdflags_t FdFlags) const noexcept {
   }
 
   Append = FdFlags & __WASI_FDFLAGS_APPEND;
+  NonBlock = FdFlags & __WASI_FDFLAGS_NONBLOCK;
   return {};
 }
 
@@ -371,6 +472,21 @@ INode::fdFilestatSetTimes(__wasi_timestamp_t ATim, __wasi_timestamp_t MTim,
 WasiExpect<void> INode::fdPread(Span<Span<uint8_t>> IOVs,
                                 __wasi_filesize_t Offset,
                                 __wasi_size_t &NRead) const noexcept {
+#if WASMEDGE_WASI_IO_URING
+  if (auto *Ring = currentRing(*this)) {
+    if (unlikely(static_cast<int64_t>(Offset) < 0)) {
+      return WasiUnexpect(__WASI_ERRNO_INVAL);
+    }
+    if (auto Res = Ring->read(Fd, IOVs, static_cast<int64_t>(Offset));
+        unlikely(!Res)) {
+      return WasiUnexpect(Res);
+    } else {
+      NRead = *Res;
+    }
+    return {};
+  }
+#endif
+
   iovec SysIOVs[kIOVMax];
   size_t SysIOVsSize = 0;
   for (auto &IOV : IOVs) {
@@ -413,6 +529,21 @@ WasiExpect<void> INode::fdPread(Span<Span<uint8_t>> IOVs,
 WasiExpect<void> INode::fdPwrite(Span<Span<const uint8_t>> IOVs,
                                  __wasi_filesize_t Offset,
                                  __wasi_size_t &NWritten) const noexcept {
+#if WASMEDGE_WASI_IO_URING
+  if (auto *Ring = writeRing(*this, IOVs)) {
+    if (unlikely(static_cast<int64_t>(Offset) < 0)) {
+      return WasiUnexpect(__WASI_ERRNO_INVAL);
+    }
+    if (auto Res = Ring->write(Fd, IOVs, static_cast<int64_t>(Offset));
+        unlikely(!Res)) {
+      return WasiUnexpect(Res);
+    } else {
+      NWritten = *Res;
+    }
+    return {};
+  }
+#endif
+
   iovec SysIOVs[kIOVMax];
   size_t SysIOVsSize = 0;
   for (auto &IOV : IOVs) {
@@ -453,6 +584,17 @@ WasiExpect<void> INode::fdPwrite(Span<Span<const uint8_t>> IOVs,
 
 WasiExpect<void> INode::fdRead(Span<Span<uint8_t>> IOVs,
                                __wasi_size_t &NRead) const noexcept {
+#if WASMEDGE_WASI_IO_URING
+  if (auto *Ring = currentRing(*this)) {
+    if (auto Res = Ring->read(Fd, IOVs, -1); unlikely(!Res)) {
+      return WasiUnexpect(Res);
+    } else {
+      NRead = *Res;
+    }
+    return {};
+  }
+#endif
+
   iovec SysIOVs[kIOVMax];
   size_t SysIOVsSize = 0;
   for (auto &IOV : IOVs) {
@@ -568,6 +710,21 @@ WasiExpect<void> INode::fdTell(__wasi_filesize_t &Size) const noexcept {
 
 WasiExpect<void> INode::fdWrite(Span<Span<const uint8_t>> IOVs,
                                 __wasi_size_t &NWritten) const noexcept {
+  if (Append) {
+    ::lseek(Fd, 0, SEEK_END);
+  }
+
+#if WASMEDGE_WASI_IO_URING
+  if (auto *Ring = writeRing(*this, IOVs)) {
+    if (auto Res = Ring->write(Fd, IOVs, -1); unlikely(!Res)) {
+      return WasiUnexpect(Res);
+    } else {
+      NWritten = *Res;
+    }
+    return {};
+  }
+#endif
+
   iovec SysIOVs[kIOVMax];
   size_t SysIOVsSize = 0;
   for (auto &IOV : IOVs) {
@@ -576,10 +733,6 @@ WasiExpect<void> INode::fdWrite(Span<Span<const uint8_t>> IOVs,
     ++SysIOVsSize;
   }
 
-  if (Append) {
-    ::lseek(Fd, 0, SEEK_END);
-  }
-
   if (auto Res = ::writev(Fd, SysIOVs, SysIOVsSize); unlikely(Res < 0)) {
     return WasiUnexpect(fromErrNo(errno));
   } else {
@@ -735,7 +888,8 @@ WasiExpect<INode> INode::pathOpen(std::string Path, __wasi_oflags_t OpenFlags,
       unlikely(NewFd < 0)) {
     return WasiUnexpect(fromErrNo(errno));
   } else {
-    INode New(NewFd, true, FdFlags & __WASI_FDFLAGS_APPEND);
+    INode New(NewFd, true, FdFlags & __WASI_FDFLAGS_APPEND,
+              FdFlags & __WASI_FDFLAGS_NONBLOCK);
 
 #ifndef O_CLOEXEC
     if (auto Res = ::fcntl(New.Fd, F_SETFD, FD_CLOEXEC); unlikely(Res != 0)) {
@@ -993,8 +1147,10 @@ WasiExpect<void> INode::sockListen(int32_t Backlog) noexcept {
 
 WasiExpect<INode> INode::sockAccept(__wasi_fdflags_t FdFlags) noexcept {
   int NewFd;
-  if (NewFd = ::accept(Fd, nullptr, nullptr); unlikely(NewFd < 0)) {
-    return WasiUnexpect(fromErrNo(errno));
+  if (auto Res = sysAccept(*this); unlikely(!Res)) {
+    return WasiUnexpect(Res);
+  } else {
+    NewFd = *Res;
   }
 
   INode New(NewFd);
@@ -1002,9 +1158,10 @@ WasiExpect<INode> INode::sockAccept(__wasi_fdflags_t FdFlags) noexcept {
   if (FdFlags & __WASI_FDFLAGS_NONBLOCK) {
     int SysFlag = fcntl(NewFd, F_GETFL, 0);
     SysFlag |= O_NONBLOCK;
-    if (auto Res = ::fcntl(Fd, F_SETFL, SysFlag); unlikely(Res != 0)) {
+    if (auto Res = ::fcntl(NewFd, F_SETFL, SysFlag); unlikely(Res != 0)) {
       return WasiUnexpect(fromErrNo(errno));
     }
+    New.NonBlock = true;
   }
 
   return New;
@@ -1018,6 +1175,12 @@ WasiExpect<void> INode::sockConnect(__wasi_address_family_t AddressFamily,
   auto ClientAddr = std::visit(VarAddrBuf(), AddressBuffer);
   int Size = std::visit(VarAddrSize(), AddressBuffer);
 
+#if WASMEDGE_WASI_IO_URING
+  if (auto *Ring = currentRing(*this)) {
+    return Ring->connect(Fd, ClientAddr, static_cast<socklen_t>(Size));
+  }
+#endif
+
   if (auto Res = ::connect(Fd, ClientAddr, Size); unlikely(Res < 0)) {
     return WasiUnexpect(fromErrNo(errno));
   }
@@ -1071,10 +1234,10 @@ WasiExpect<void> INode::sockRecvFrom(Span<Span<uint8_t>> RiData,
   SysMsgHdr.msg_flags = 0;
 
   // Store recv bytes length and flags.
-  if (auto Res = ::recvmsg(Fd, &SysMsgHdr, SysRiFlags); unlikely(Res < 0)) {
-    return WasiUnexpect(fromErrNo(errno));
+  if (auto Res = sysRecvmsg(*this, SysMsgHdr, SysRiFlags); unlikely(!Res)) {
+    return WasiUnexpect(Res);
   } else {
-    NRead = Res;
+    NRead = *Res;
   }
 
   if (NeedAddress) {
@@ -1177,10 +1340,10 @@ WasiExpect<void> INode::sockSendTo(Span<Span<const uint8_t>> SiData,
   SysMsgHdr.msg_controllen = 0;
 
   // Store recv bytes length and flags.
-  if (auto Res = ::sendmsg(Fd, &SysMsgHdr, SysSiFlags); unlikely(Res < 0)) {
-    return WasiUnexpect(fromErrNo(errno));
+  if (auto Res = sysSendmsg(*this, SysMsgHdr, SysSiFlags); unlikely(!Res)) {
+    return WasiUnexpect(Res);
   } else {
-    NWritten = Res;
+    NWritten = *Res;
   }
 
   return {};
@@ -1569,6 +1732,47 @@ WasiExpect<void> Poller::Timer::setTime(__wasi_timestamp_t Timeout,
 }
 #endif
 
+namespace {
+__wasi_timestamp_t monotonicNow() noexcept {
+  timespec Now;
+  ::clock_gettime(CLOCK_MONOTONIC, &Now);
+  return fromTimespec(Now);
+}
+
+/// Wait for the epoll events with the nanosecond timeout of `epoll_pwait2`
+/// (Linux 5.11), or with the timeout rounded up to milliseconds of
+/// `epoll_wait` on the older kernels. A negative timeout waits indefinitely.
+int epollWait(int Fd, struct epoll_event *Events, int MaxEvents,
+              int64_t Timeout) noexcept {
+#if defined(__NR_epoll_pwait2)
+  static std::atomic<bool> NoPWait2 = false;
+  if (likely(!NoPWait2.load(std::memory_order_relaxed))) {
+    // The layout of `__kernel_timespec`.
+    struct {
+      int64_t Seconds;
+      int64_t Nanoseconds;
+    } Spec{Timeout / 1000000000, Timeout % 1000000000};
+    const auto Res =
+        ::syscall(__NR_epoll_pwait2, Fd, Events, MaxEvents,
+                  Timeout < 0 ? nullptr : &Spec, nullptr, size_t(0));
+    // The seccomp filters of the containers may deny the unknown syscalls
+    // with EPERM, which epoll_pwait2 never returns otherwise.
+    if (likely(Res >= 0 || (errno != ENOSYS && errno != EPERM))) {
+      return static_cast<int>(Res);
+    }
+    NoPWait2.store(true, std::memory_order_relaxed);
+  }
+#endif
+  int Milliseconds = -1;
+  if (Timeout >= 0) {
+    Milliseconds = static_cast<int>(std::min<int64_t>(
+        Timeout / 1000000 + (Timeout % 1000000 != 0),
+        std::numeric_limits<int>::max()));
+  }
+  return ::epoll_wait(Fd, Events, MaxEvents, Milliseconds);
+}
+} // namespace
+
 Poller::Poller(PollerContext &C) noexcept
     : FdHolder(
 #if __GLIBC_PREREQ(2, 9)
@@ -1589,14 +1793,29 @@ Poller::Poller(PollerContext &C) noexcept
 
 WasiExpect<void> Poller::prepare(Span<__wasi_event_t> E) noexcept {
   WasiEvents = E;
+#if WASMEDGE_WASI_IO_URING
+  Ring = IOUring::current();
+#endif
   try {
     Events.reserve(E.size());
     Timers.reserve(E.size());
     EPollEvents.reserve(E.size());
+    Deadlines.reserve(E.size());
+    RingTimeouts.reserve(E.size());
   } catch (std::bad_alloc &) {
     return WasiUnexpect(__WASI_ERRNO_NOMEM);
   }
 
+  if (const auto Count = Ctx.get().closeCount();
+      unlikely(CloseCount != Count)) {
+    // Some fds were closed while this poller was out of the pool, and their
+    // numbers may be reused by other files.
+    for (auto &[NodeFd, Interest] : Registered) {
+      Interest = 0;
+    }
+    CloseCount = Count;
+  }
+
   return {};
 }
 
@@ -1609,6 +1828,29 @@ void Poller::clock(__wasi_clockid_t Clock, __wasi_timestamp_t Timeout,
   Event.userdata = UserData;
   Event.type = __WASI_EVENTTYPE_CLOCK;
 
+  // The monotonic clock also serves the relative timeouts of the realtime
+  // clock. The other clocks use the timers.
+  if (Clock == __WASI_CLOCKID_MONOTONIC ||
+      (Clock == __WASI_CLOCKID_REALTIME &&
+       !(Flags & __WASI_SUBCLOCKFLAGS_SUBSCRIPTION_CLOCK_ABSTIME))) {
+    const bool Absolute =
+        (Flags & __WASI_SUBCLOCKFLAGS_SUBSCRIPTION_CLOCK_ABSTIME) != 0;
+#if WASMEDGE_WASI_IO_URING
+    if (Ring) {
+      const auto Spec = toTimespec(Timeout);
+      RingTimeouts.push_back({Spec.tv_sec, Spec.tv_nsec, Absolute, &Event});
+      return;
+    }
+#endif
+    if (!Absolute) {
+      const auto Now = monotonicNow();
+      Timeout =
+          Now + std::min(Timeout, std::numeric_limits<uint64_t>::max() - Now);
+    }
+    Deadlines.push_back({Timeout, &Event});
+    return;
+  }
+
   if (auto Res = Ctx.get().acquireTimer(Clock); unlikely(!Res)) {
     Event.Valid = true;
     Event.error = Res.error();
@@ -1632,6 +1874,9 @@ void Poller::clock(__wasi_clockid_t Clock, __wasi_timestamp_t Timeout,
 
     Iter->second.ReadEvent = &Event;
     assuming(Added);
+    if (Ring) {
+      return;
+    }
 
     epoll_event EPollEvent;
     EPollEvent.events = EPOLLIN;
@@ -1661,8 +1906,17 @@ void Poller::clock(__wasi_clockid_t Clock, __wasi_timestamp_t Timeout,
 }
 
 void Poller::close(const INode &Node) noexcept {
+  ++CloseCount;
   FdDatas.erase(Node.Fd);
-  OldFdDatas.erase(Node.Fd);
+  if (auto Iter = Registered.find(Node.Fd); Iter != Registered.end()) {
+    // Remove the fd before it is closed, the registration outlives the close
+    // if the file is still referred by a duplicated fd. Ignore failed.
+    // In kernel before 2.6.9, EPOLL_CTL_DEL required a non-null pointer. Use
+    // `this` as the dummy parameter.
+    ::epoll_ctl(Fd, EPOLL_CTL_DEL, Node.Fd,
+                reinterpret_cast<struct epoll_event *>(this));
+    Registered.erase(Iter);
+  }
 }
 
 void Poller::read(const INode &Node, TriggerType Trigger,
@@ -1676,44 +1930,20 @@ void Poller::read(const INode &Node, TriggerType Trigger,
   assuming(Node.Fd != Fd);
   try {
     auto [Iter, Added] = FdDatas.try_emplace(Node.Fd);
-    const bool New = OldFdDatas.find(Node.Fd) == OldFdDatas.end();
 
     if (unlikely(!Added && Iter->second.ReadEvent != nullptr)) {
       Event.Valid = true;
       Event.error = __WASI_ERRNO_EXIST;
       return;
     }
+    // The fds are registered in `wait`.
     Iter->second.ReadEvent = &Event;
-
-    epoll_event EPollEvent;
-    EPollEvent.events = EPOLLIN;
-    if (!Added) {
-      assuming(Iter->second.WriteEvent != nullptr);
-      EPollEvent.events |= EPOLLOUT;
-    }
-    if (Trigger == TriggerType::Edge) {
-      EPollEvent.events |= EPOLLET;
-    }
+    Iter->second.Interest |= EPOLLIN;
 #if defined(EPOLLRDHUP)
-    EPollEvent.events |= EPOLLRDHUP;
+    Iter->second.Interest |= EPOLLRDHUP;
 #endif
-    EPollEvent.data.fd = Node.Fd;
-
-    if (likely(Added) && New) {
-      if (auto Res = ::epoll_ctl(Fd, EPOLL_CTL_ADD, Node.Fd, &EPollEvent);
-          unlikely(Res < 0)) {
-        FdDatas.erase(Iter);
-        Event.Valid = true;
-        Event.error = fromErrNo(errno);
-        return;
-      }
-    } else {
-      if (auto Res = ::epoll_ctl(Fd, EPOLL_CTL_MOD, Node.Fd, &EPollEvent);
-          unlikely(Res < 0)) {
-        Event.Valid = true;
-        Event.error = fromErrNo(errno);
-        return;
-      }
+    if (Trigger == TriggerType::Edge) {
+      Iter->second.Interest |= EPOLLET;
     }
   } catch (std::bad_alloc &) {
     Event.Valid = true;
@@ -1733,44 +1963,20 @@ void Poller::write(const INode &Node, TriggerType Trigger,
   assuming(Node.Fd != Fd);
   try {
     auto [Iter, Added] = FdDatas.try_emplace(Node.Fd);
-    const bool New = OldFdDatas.find(Node.Fd) == OldFdDatas.end();
 
     if (unlikely(!Added && Iter->second.WriteEvent != nullptr)) {
       Event.Valid = true;
       Event.error = __WASI_ERRNO_EXIST;
       return;
     }
+    // The fds are registered in `wait`.
     Iter->second.WriteEvent = &Event;
-
-    epoll_event EPollEvent;
-    EPollEvent.events = EPOLLOUT;
-    if (!Added) {
-      assuming(Iter->second.ReadEvent != nullptr);
-      EPollEvent.events |= EPOLLIN;
-    }
-    if (Trigger == TriggerType::Edge) {
-      EPollEvent.events |= EPOLLET;
-    }
+    Iter->second.Interest |= EPOLLOUT;
 #if defined(EPOLLRDHUP)
-    EPollEvent.events |= EPOLLRDHUP;
+    Iter->second.Interest |= EPOLLRDHUP;
 #endif
-    EPollEvent.data.fd = Node.Fd;
-
-    if (likely(Added) && New) {
-      if (auto Res = ::epoll_ctl(Fd, EPOLL_CTL_ADD, Node.Fd, &EPollEvent);
-          unlikely(Res < 0)) {
-        FdDatas.erase(Iter);
-        Event.Valid = true;
-        Event.error = fromErrNo(errno);
-        return;
-      }
-    } else {
-      if (auto Res = ::epoll_ctl(Fd, EPOLL_CTL_MOD, Node.Fd, &EPollEvent);
-          unlikely(Res < 0)) {
-        Event.Valid = true;
-        Event.error = fromErrNo(errno);
-        return;
-      }
+    if (Trigger == TriggerType::Edge) {
+      Iter->second.Interest |= EPOLLET;
     }
   } catch (std::bad_alloc &) {
     Event.Valid = true;
@@ -1779,29 +1985,7 @@ void Poller::write(const INode &Node, TriggerType Trigger,
   }
 }
 
-void Poller::wait() noexcept {
-  for (const auto &[NodeFd, FdData] : OldFdDatas) {
-    if (auto Iter = FdDatas.find(NodeFd); Iter == FdDatas.end()) {
-      // Remove unused event, ignore failed.
-      // In kernel before 2.6.9, EPOLL_CTL_DEL required a non-null pointer. Use
-      // `this` as the dummy parameter.
-      ::epoll_ctl(Fd, EPOLL_CTL_DEL, NodeFd,
-                  reinterpret_cast<struct epoll_event *>(this));
-    }
-  }
-
-  EPollEvents.resize(Events.size());
-  const int Count =
-      ::epoll_wait(Fd, EPollEvents.data(), EPollEvents.size(), -1);
-  if (unlikely(Count < 0)) {
-    const auto Error = fromErrNo(errno);
-    for (auto &Event : Events) {
-      Event.Valid = true;
-      Event.error = Error;
-    }
-    return;
-  }
-
+void Poller::processEvent(const struct epoll_event &EPollEvent) noexcept {
   auto ProcessEvent = [](const struct epoll_event &EPollEvent,
                          OptionalEvent &Event) noexcept {
     Event.Valid = true;
@@ -1855,26 +2039,154 @@ void Poller::wait() noexcept {
     }
   };
 
-  for (int I = 0; I < Count; ++I) {
-    const auto &EPollEvent = EPollEvents[I];
-    const auto Iter = FdDatas.find(EPollEvent.data.fd);
-    assuming(Iter != FdDatas.end());
+  const auto Iter = FdDatas.find(EPollEvent.data.fd);
+  assuming(Iter != FdDatas.end());
+
+  const bool NoInOut = !(EPollEvent.events & (EPOLLIN | EPOLLOUT));
+  if ((EPollEvent.events & EPOLLIN) ||
+      (NoInOut && EPollEvent.events & EPOLLHUP && Iter->second.ReadEvent)) {
+    assuming(Iter->second.ReadEvent);
+    assuming(Iter->second.ReadEvent->type == __WASI_EVENTTYPE_CLOCK ||
+             Iter->second.ReadEvent->type == __WASI_EVENTTYPE_FD_READ);
+    ProcessEvent(EPollEvent, *Iter->second.ReadEvent);
+  }
+  if (EPollEvent.events & EPOLLOUT ||
+      (NoInOut && EPollEvent.events & EPOLLHUP && Iter->second.WriteEvent)) {
+    assuming(Iter->second.WriteEvent);
+    assuming(Iter->second.WriteEvent->type == __WASI_EVENTTYPE_FD_WRITE);
+    ProcessEvent(EPollEvent, *Iter->second.WriteEvent);
+  }
+}
+
+void Poller::updateInterest() noexcept {
+  for (const auto &[NodeFd, FdData] : FdDatas) {
+    if (FdData.Interest == 0) {
+      // The timers are added in `clock`.
+      continue;
+    }
+    auto Fail = [&Data = FdData](__wasi_errno_t Error) noexcept {
+      for (auto *Event : {Data.ReadEvent, Data.WriteEvent}) {
+        if (Event) {
+          Event->Valid = true;
+          Event->error = Error;
+        }
+      }
+    };
+
+    decltype(Registered)::iterator Iter;
+    bool Added;
+    try {
+      std::tie(Iter, Added) = Registered.try_emplace(NodeFd, 0);
+    } catch (std::bad_alloc &) {
+      Fail(__WASI_ERRNO_NOMEM);
+      continue;
+    }
+    if (!Added && Iter->second == FdData.Interest) {
+      continue;
+    }
+
+    epoll_event EPollEvent;
+    EPollEvent.events = FdData.Interest;
+    EPollEvent.data.fd = NodeFd;
+    auto Res = ::epoll_ctl(Fd, Added ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, NodeFd,
+                           &EPollEvent);
+    if (Res < 0 && !Added && errno == ENOENT) {
+      // The fd of unknown state is reused by another file.
+      Res = ::epoll_ctl(Fd, EPOLL_CTL_ADD, NodeFd, &EPollEvent);
+    }
+    if (likely(Res == 0)) {
+      Iter->second = FdData.Interest;
+      continue;
+    }
+
+    const auto Error = errno;
+    Registered.erase(Iter);
+    if (Error == EPERM) {
+      // The regular files and directories are not pollable by epoll, and are
+      // always ready as `poll` reports.
+      EPollEvent.events &= EPOLLIN | EPOLLOUT;
+      processEvent(EPollEvent);
+    } else {
+      Fail(fromErrNo(Error));
+    }
+  }
+}
+
+void Poller::wait() noexcept {
+#if WASMEDGE_WASI_IO_URING
+  if (Ring) {
+    waitRing();
+    return;
+  }
+#endif
+
+  updateInterest();
+
+  // Poll without blocking if some events are known already.
+  bool Ready = std::any_of(
+      Events.begin(), Events.end(),
+      [](const OptionalEvent &Event) noexcept { return Event.Valid; });
+  EPollEvents.resize(Events.size());
+  while (true) {
+    int64_t Timeout = Ready ? 0 : -1;
+    if (!Ready && !Deadlines.empty()) {
+      const auto Now = monotonicNow();
+      const auto Earliest =
+          std::min_element(Deadlines.begin(), Deadlines.end(),
+                           [](const Deadline &L, const Deadline &R) noexcept {
+                             return L.Time < R.Time;
+                           })
+              ->Time;
+      Timeout = Earliest <= Now
+                    ? 0
+                    : static_cast<int64_t>(std::min<uint64_t>(
+                          Earliest - Now,
+                          std::numeric_limits<int64_t>::max()));
+    }
+
+    const int Count = epollWait(Fd, EPollEvents.data(),
+                                static_cast<int>(EPollEvents.size()), Timeout);
+    if (unlikely(Count < 0)) {
+      const auto Error = fromErrNo(errno);
+      for (auto &Event : Events) {
+        if (!Event.Valid) {
+          Event.Valid = true;
+          Event.error = Error;
+        }
+      }
+      break;
+    }
 
-    const bool NoInOut = !(EPollEvent.events & (EPOLLIN | EPOLLOUT));
-    if ((EPollEvent.events & EPOLLIN) ||
-        (NoInOut && EPollEvent.events & EPOLLHUP && Iter->second.ReadEvent)) {
-      assuming(Iter->second.ReadEvent);
-      assuming(Iter->second.ReadEvent->type == __WASI_EVENTTYPE_CLOCK ||
-               Iter->second.ReadEvent->type == __WASI_EVENTTYPE_FD_READ);
-      ProcessEvent(EPollEvent, *Iter->second.ReadEvent);
+    for (int I = 0; I < Count; ++I) {
+      const int NodeFd = EPollEvents[I].data.fd;
+      if (likely(FdDatas.find(NodeFd) != FdDatas.end())) {
+        processEvent(EPollEvents[I]);
+        Ready = true;
+      } else {
+        // The fd is not subscribed in this poll, remove it from the interest
+        // set not to be reported again. Ignore failed.
+        // In kernel before 2.6.9, EPOLL_CTL_DEL required a non-null pointer.
+        // Use `this` as the dummy parameter.
+        ::epoll_ctl(Fd, EPOLL_CTL_DEL, NodeFd,
+                    reinterpret_cast<struct epoll_event *>(this));
+        Registered.erase(NodeFd);
+      }
+    }
+    if (!Deadlines.empty()) {
+      const auto Now = monotonicNow();
+      for (const auto &Deadline : Deadlines) {
+        if (Deadline.Time <= Now) {
+          Deadline.Event->Valid = true;
+          Deadline.Event->error = __WASI_ERRNO_SUCCESS;
+          Ready = true;
+        }
+      }
     }
-    if (EPollEvent.events & EPOLLOUT ||
-        (NoInOut && EPollEvent.events & EPOLLHUP && Iter->second.WriteEvent)) {
-      assuming(Iter->second.WriteEvent);
-      assuming(Iter->second.WriteEvent->type == __WASI_EVENTTYPE_FD_WRITE);
-      ProcessEvent(EPollEvent, *Iter->second.WriteEvent);
+    if (Ready) {
+      break;
     }
   }
+
   for (auto &Timer : Timers) {
     // Remove unused timer event, ignore failed.
     // In kernel before 2.6.9, EPOLL_CTL_DEL required a non-null pointer. Use
@@ -1884,12 +2196,156 @@ void Poller::wait() noexcept {
     Ctx.get().releaseTimer(std::move(Timer));
   }
 
-  std::swap(FdDatas, OldFdDatas);
   FdDatas.clear();
   Timers.clear();
   EPollEvents.clear();
+  Deadlines.clear();
 }
 
+#if WASMEDGE_WASI_IO_URING
+namespace {
+/// User data of the poll requests is the fd, and the timeout requests are
+/// tagged with their indices. The completions of the cancel requests are
+/// ignored.
+inline constexpr const uint64_t kTimeoutTag = UINT64_C(1) << 32;
+} // namespace
+
+void Poller::waitRing() noexcept {
+  static_assert(sizeof(__kernel_timespec) == sizeof(int64_t) * 2 &&
+                offsetof(__kernel_timespec, tv_nsec) == sizeof(int64_t));
+  auto &R = *Ring;
+  auto Fail = [this](__wasi_errno_t Error) noexcept {
+    for (auto &Event : Events) {
+      if (!Event.Valid) {
+        Event.Valid = true;
+        Event.error = Error;
+      }
+    }
+  };
+
+  // The poll requests are one-shot and level-triggered, so the edge-triggered
+  // subscriptions are reported as the level-triggered ones, which only adds
+  // spurious wakeups.
+  uint32_t Outstanding = 0;
+  uint32_t Canceling = 0;
+  bool Submitted = true;
+  for (const auto &[NodeFd, FdData] : FdDatas) {
+    auto *SQE = R.getSQE();
+    if (unlikely(!SQE)) {
+      Submitted = false;
+      break;
+    }
+    // The poll events share the values of the epoll events.
+    uint32_t Mask = 0;
+    if (FdData.ReadEvent) {
+      Mask |= EPOLLIN;
+#if defined(EPOLLRDHUP)
+      Mask |= EPOLLRDHUP;
+#endif
+    }
+    if (FdData.WriteEvent) {
+      Mask |= EPOLLOUT;
+    }
+    SQE->opcode = IORING_OP_POLL_ADD;
+    SQE->fd = NodeFd;
+    // The 16-bit field is compatible with the kernels reading the 32-bit one.
+    SQE->poll_events = static_cast<uint16_t>(Mask);
+    SQE->user_data = static_cast<uint64_t>(NodeFd);
+    ++Outstanding;
+  }
+  for (size_t I = 0; Submitted && I < RingTimeouts.size(); ++I) {
+    auto *SQE = R.getSQE();
+    if (unlikely(!SQE)) {
+      Submitted = false;
+      break;
+    }
+    SQE->opcode = IORING_OP_TIMEOUT;
+    SQE->fd = -1;
+    SQE->addr = reinterpret_cast<uintptr_t>(&RingTimeouts[I]);
+    SQE->len = 1;
+    SQE->timeout_flags = RingTimeouts[I].Absolute ? IORING_TIMEOUT_ABS : 0;
+    SQE->user_data = kTimeoutTag | I;
+    ++Outstanding;
+  }
+
+  auto Complete = [this, &Outstanding, &Canceling](
+                      const io_uring_cqe &CQE) noexcept {
+    if (CQE.user_data == IOUring::kCancelUserData) {
+      --Canceling;
+      return;
+    }
+    --Outstanding;
+    if (CQE.res == -ECANCELED) {
+      return;
+    }
+    if (CQE.user_data & kTimeoutTag) {
+      auto &Event = *RingTimeouts[CQE.user_data & ~kTimeoutTag].Event;
+      Event.Valid = true;
+      Event.error = CQE.res == -ETIME || CQE.res == 0
+                        ? __WASI_ERRNO_SUCCESS
+                        : fromErrNo(-CQE.res);
+      return;
+    }
+    const int NodeFd = static_cast<int>(CQE.user_data);
+    if (unlikely(CQE.res < 0)) {
+      const auto Iter = FdDatas.find(NodeFd);
+      assuming(Iter != FdDatas.end());
+      for (auto *Event : {Iter->second.ReadEvent, Iter->second.WriteEvent}) {
+        if (Event) {
+          Event->Valid = true;
+          Event->error = fromErrNo(-CQE.res);
+        }
+      }
+      return;
+    }
+    epoll_event EPollEvent;
+    EPollEvent.events = static_cast<uint32_t>(CQE.res);
+    EPollEvent.data.fd = NodeFd;
+    processEvent(EPollEvent);
+  };
+  auto Drain = [&R, &Complete]() noexcept {
+    while (const auto *CQE = R.peekCQE()) {
+      Complete(*CQE);
+      R.seenCQE();
+    }
+  };
+
+  if (auto Res = R.submitAndWait(Submitted ? 1 : 0); unlikely(!Res)) {
+    Fail(Res.error());
+  } else if (unlikely(!Submitted)) {
+    Fail(__WASI_ERRNO_IO);
+  }
+  Drain();
+
+  // Cancel the rest of the requests, which still refer to the timeouts, and
+  // wait for all of them to leave the completion queue empty. The requests
+  // not submitted by a failed submission are submitted with their cancels.
+  if (Outstanding > 0) {
+    auto Cancel = [&R, &Canceling](uint64_t UserData) noexcept {
+      if (likely(R.cancel(UserData))) {
+        ++Canceling;
+      }
+    };
+    for (const auto &[NodeFd, FdData] : FdDatas) {
+      Cancel(static_cast<uint64_t>(NodeFd));
+    }
+    for (size_t I = 0; I < RingTimeouts.size(); ++I) {
+      Cancel(kTimeoutTag | I);
+    }
+  }
+  while (Outstanding + Canceling > 0 && R.waitCompletion()) {
+    Drain();
+  }
+
+  for (auto &Timer : Timers) {
+    Ctx.get().releaseTimer(std::move(Timer));
+  }
+  FdDatas.clear();
+  Timers.clear();
+  RingTimeouts.clear();
+}
+#endif
+
 void Poller::reset() noexcept {
   WasiEvents = {};
   Events.clear();
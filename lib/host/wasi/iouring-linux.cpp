@@ -0,0 +1,524 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "common/defines.h"
+#if WASMEDGE_OS_LINUX
+
+#include "iouring.h"
+
+#if WASMEDGE_WASI_IO_URING
+
+#include "common/errcode.h"
+#include "common/spdlog.h"
+#include "host/wasi/environ.h"
+#include "linux.h"
+#include "system/allocator.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+namespace WasmEdge {
+namespace Host {
+namespace WASI {
+
+namespace {
+
+inline constexpr const uint32_t kEntries = 256;
+/// The offset of the file position in the read and write requests.
+inline constexpr const uint64_t kCurrentPosition = ~UINT64_C(0);
+
+enum class State : uint8_t { Unset, Ready, Unsupported };
+
+/// The ring is created at the first selection in the thread, and kept until
+/// the thread exits.
+struct ThreadRing {
+  State Status = State::Unset;
+  bool Selected = false;
+  std::unique_ptr<IOUring> Ring;
+};
+thread_local ThreadRing Local;
+
+int ioUringSetup(uint32_t Entries, io_uring_params &Params) noexcept {
+  return static_cast<int>(::syscall(__NR_io_uring_setup, Entries, &Params));
+}
+
+int ioUringEnter(int Fd, uint32_t ToSubmit, uint32_t MinComplete,
+                 uint32_t Flags) noexcept {
+  return static_cast<int>(::syscall(__NR_io_uring_enter, Fd, ToSubmit,
+                                    MinComplete, Flags, nullptr, 0));
+}
+
+int ioUringRegister(int Fd, uint32_t Opcode, const void *Arg,
+                    uint32_t NrArgs) noexcept {
+  return static_cast<int>(
+      ::syscall(__NR_io_uring_register, Fd, Opcode, Arg, NrArgs));
+}
+
+void prepare(io_uring_sqe &SQE, uint8_t Opcode, int Fd, const void *Addr,
+             uint32_t Len, uint64_t Offset, uint64_t UserData) noexcept {
+  SQE.opcode = Opcode;
+  SQE.fd = Fd;
+  SQE.addr = reinterpret_cast<uintptr_t>(Addr);
+  SQE.len = Len;
+  SQE.off = Offset;
+  SQE.user_data = UserData;
+}
+
+} // namespace
+
+IOUring::~IOUring() noexcept {
+  if (SQEs) {
+    ::munmap(SQEs, SQEntries * sizeof(io_uring_sqe));
+  }
+  if (CQRing && CQRing != SQRing) {
+    ::munmap(CQRing, CQRingSize);
+  }
+  if (SQRing) {
+    ::munmap(SQRing, SQRingSize);
+  }
+}
+
+void IOUring::select(bool Enable, uint64_t MaxBufferSize,
+                     Span<uint8_t> Memory) noexcept {
+  Local.Selected = false;
+  if (!Enable || Local.Status == State::Unsupported) {
+    return;
+  }
+  if (Local.Status == State::Unset) {
+    std::unique_ptr<IOUring> Ring(new (std::nothrow) IOUring());
+    if (!Ring || !Ring->setup()) {
+      spdlog::info("io_uring is not supported, using the epoll backend");
+      Local.Status = State::Unsupported;
+      return;
+    }
+    Local.Ring = std::move(Ring);
+    Local.Status = State::Ready;
+  }
+  Local.Selected = true;
+  Local.Ring->registerBuffer(Memory, MaxBufferSize);
+}
+
+IOUring *IOUring::current() noexcept {
+  return Local.Selected ? Local.Ring.get() : nullptr;
+}
+
+bool IOUring::setup() noexcept {
+  io_uring_params Params;
+  std::memset(&Params, 0, sizeof(Params));
+  if (const auto Fd = ioUringSetup(kEntries, Params); Fd < 0) {
+    return false;
+  } else {
+    Ring.emplace(Fd);
+  }
+  if (!(Params.features & IORING_FEAT_FAST_POLL) ||
+      !(Params.features & IORING_FEAT_NODROP) ||
+      !(Params.features & IORING_FEAT_RW_CUR_POS)) {
+    return false;
+  }
+
+  SQRingSize = Params.sq_off.array + Params.sq_entries * sizeof(uint32_t);
+  CQRingSize = Params.cq_off.cqes + Params.cq_entries * sizeof(io_uring_cqe);
+  const bool Single = Params.features & IORING_FEAT_SINGLE_MMAP;
+  if (Single) {
+    SQRingSize = CQRingSize = std::max(SQRingSize, CQRingSize);
+  }
+  auto Map = [this](size_t Size, off_t Offset) noexcept -> uint8_t * {
+    auto Pointer = ::mmap(nullptr, Size, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE, Ring.Fd, Offset);
+    return Pointer == MAP_FAILED ? nullptr : static_cast<uint8_t *>(Pointer);
+  };
+  if (SQRing = Map(SQRingSize, IORING_OFF_SQ_RING); !SQRing) {
+    return false;
+  }
+  if (CQRing = Single ? SQRing : Map(CQRingSize, IORING_OFF_CQ_RING);
+      !CQRing) {
+    return false;
+  }
+  SQEntries = Params.sq_entries;
+  if (auto Pointer = Map(SQEntries * sizeof(io_uring_sqe), IORING_OFF_SQES);
+      !Pointer) {
+    return false;
+  } else {
+    SQEs = reinterpret_cast<io_uring_sqe *>(Pointer);
+  }
+
+  SQTail = reinterpret_cast<uint32_t *>(SQRing + Params.sq_off.tail);
+  SQMask = *reinterpret_cast<uint32_t *>(SQRing + Params.sq_off.ring_mask);
+  CQHead = reinterpret_cast<uint32_t *>(CQRing + Params.cq_off.head);
+  CQTail = reinterpret_cast<uint32_t *>(CQRing + Params.cq_off.tail);
+  CQMask = *reinterpret_cast<uint32_t *>(CQRing + Params.cq_off.ring_mask);
+  CQEs = reinterpret_cast<io_uring_cqe *>(CQRing + Params.cq_off.cqes);
+  // The submission entries are used in order, so the index array is fixed.
+  auto *Array = reinterpret_cast<uint32_t *>(SQRing + Params.sq_off.array);
+  for (uint32_t I = 0; I < SQEntries; ++I) {
+    Array[I] = I;
+  }
+  FilledTail = *SQTail;
+  return true;
+}
+
+void IOUring::registerBuffer(Span<uint8_t> Memory,
+                             uint64_t MaxBufferSize) noexcept {
+  // Pinning the fixed buffer faults in all of its pages, so the larger
+  // memories, which are usually sparse, are not registered.
+  if (Memory.size() > MaxBufferSize) {
+    Memory = {};
+  }
+  const auto Generation = Allocator::getMappingGeneration();
+  auto Same = [&Memory, Generation](Span<uint8_t> Buffer,
+                                    uint64_t BufferGeneration) noexcept {
+    return Buffer.data() == Memory.data() && Buffer.size() == Memory.size() &&
+           BufferGeneration == Generation;
+  };
+  if (Same(Registered, RegisteredGeneration) ||
+      Same(Failed, FailedGeneration)) {
+    return;
+  }
+  if (!Registered.empty()) {
+    // The memory is grown or the pages are replaced. Unpin the old pages.
+    ioUringRegister(Ring.Fd, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+    Registered = {};
+  }
+  if (Memory.empty()) {
+    return;
+  }
+  const iovec Buffer = {Memory.data(), Memory.size()};
+  if (ioUringRegister(Ring.Fd, IORING_REGISTER_BUFFERS, &Buffer, 1) == 0) {
+    Registered = Memory;
+    RegisteredGeneration = Generation;
+    return;
+  }
+  // Such as exceeding the limit of the locked memory. Use the unregistered
+  // requests for this memory.
+  Failed = Memory;
+  FailedGeneration = Generation;
+}
+
+io_uring_sqe *IOUring::getSQE() noexcept {
+  if (Pending == SQEntries) {
+    // All the entries are consumed by the kernel in the submission, so the
+    // queue is empty after it.
+    if (auto Res = submitAndWait(0); unlikely(!Res)) {
+      return nullptr;
+    }
+  }
+  auto *SQE = &SQEs[FilledTail & SQMask];
+  std::memset(SQE, 0, sizeof(io_uring_sqe));
+  ++FilledTail;
+  ++Pending;
+  return SQE;
+}
+
+WasiExpect<void> IOUring::submitAndWait(uint32_t WaitCount) noexcept {
+  __atomic_store_n(SQTail, FilledTail, __ATOMIC_RELEASE);
+  while (true) {
+    const uint32_t Available =
+        __atomic_load_n(CQTail, __ATOMIC_ACQUIRE) - *CQHead;
+    const uint32_t MinComplete = Available < WaitCount ? WaitCount : 0;
+    if (Pending == 0 && MinComplete == 0) {
+      return {};
+    }
+    const auto Res = ioUringEnter(Ring.Fd, Pending, MinComplete,
+                                  MinComplete ? IORING_ENTER_GETEVENTS : 0);
+    if (unlikely(Res < 0)) {
+      // The requests in flight still refer to the buffers of the caller, so
+      // keep waiting when interrupted.
+      if (errno == EINTR) {
+        continue;
+      }
+      return WasiUnexpect(fromErrNo(errno));
+    }
+    Pending -= static_cast<uint32_t>(Res);
+  }
+}
+
+const io_uring_cqe *IOUring::peekCQE() const noexcept {
+  const uint32_t Head = *CQHead;
+  if (Head == __atomic_load_n(CQTail, __ATOMIC_ACQUIRE)) {
+    return nullptr;
+  }
+  return &CQEs[Head & CQMask];
+}
+
+void IOUring::seenCQE() noexcept {
+  __atomic_store_n(CQHead, *CQHead + 1, __ATOMIC_RELEASE);
+}
+
+bool IOUring::cancel(uint64_t UserData) noexcept {
+  auto *SQE = getSQE();
+  if (unlikely(!SQE)) {
+    return false;
+  }
+  prepare(*SQE, IORING_OP_ASYNC_CANCEL, -1, nullptr, 0, 0, kCancelUserData);
+  SQE->addr = UserData;
+  return true;
+}
+
+bool IOUring::waitCompletion() noexcept {
+  __atomic_store_n(SQTail, FilledTail, __ATOMIC_RELEASE);
+  while (!peekCQE()) {
+    const auto Res =
+        ioUringEnter(Ring.Fd, Pending, 1, IORING_ENTER_GETEVENTS);
+    if (unlikely(Res < 0)) {
+      if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+        continue;
+      }
+      // The requests in flight cannot be waited for. Keep the ring, which
+      // they may still refer to, and use the epoll backend in the thread.
+      spdlog::error("io_uring wait failed: {}, using the epoll backend",
+                    std::strerror(errno));
+      Local.Status = State::Unsupported;
+      Local.Selected = false;
+      return false;
+    }
+    Pending -= static_cast<uint32_t>(Res);
+  }
+  return true;
+}
+
+void IOUring::abort(uint32_t Count) noexcept {
+  // The completions of all the requests and the cancel requests are waited
+  // for, so the completion queue is empty again for the next call.
+  uint32_t Remaining = Count;
+  for (uint32_t I = 0; I < Count; ++I) {
+    Remaining += cancel(I) ? 1 : 0;
+  }
+  while (Remaining > 0 && waitCompletion()) {
+    while (Remaining > 0 && peekCQE()) {
+      seenCQE();
+      --Remaining;
+    }
+  }
+}
+
+WasiExpect<void> IOUring::run(uint32_t Count, Span<int32_t> Results) noexcept {
+  if (auto Res = submitAndWait(Count); unlikely(!Res)) {
+    // The requests in flight still write to the buffers of the caller, and
+    // their completions would be taken by the next call.
+    abort(Count);
+    return WasiUnexpect(Res);
+  }
+  for (uint32_t I = 0; I < Count; ++I) {
+    const auto *CQE = peekCQE();
+    assuming(CQE && CQE->user_data < Results.size());
+    Results[CQE->user_data] = CQE->res;
+    seenCQE();
+  }
+  return {};
+}
+
+WasiExpect<__wasi_size_t> IOUring::read(int Fd, Span<Span<uint8_t>> IOVs,
+                                        int64_t Offset) noexcept {
+  const bool Fixed =
+      IOVs.size() <= SQEntries &&
+      std::all_of(IOVs.begin(), IOVs.end(),
+                  [this](Span<uint8_t> IOV) { return isFixed(IOV); });
+  if (!Fixed) {
+    iovec SysIOVs[kIOVMax];
+    for (size_t I = 0; I < IOVs.size(); ++I) {
+      SysIOVs[I].iov_base = IOVs[I].data();
+      SysIOVs[I].iov_len = IOVs[I].size();
+    }
+    auto *SQE = getSQE();
+    if (unlikely(!SQE)) {
+      return WasiUnexpect(__WASI_ERRNO_IO);
+    }
+    prepare(*SQE, IORING_OP_READV, Fd, SysIOVs,
+            static_cast<uint32_t>(IOVs.size()),
+            Offset < 0 ? kCurrentPosition : static_cast<uint64_t>(Offset), 0);
+    int32_t Result;
+    if (auto Res = run(1, Span<int32_t>(&Result, 1)); unlikely(!Res)) {
+      return WasiUnexpect(Res);
+    }
+    if (Result < 0) {
+      return WasiUnexpect(fromErrNo(-Result));
+    }
+    return static_cast<__wasi_size_t>(Result);
+  }
+
+  // Read each IOV into the fixed buffer in a chain. A short read breaks the
+  // chain and cancels the rest as `readv` stops.
+  int32_t Results[kIOVMax];
+  uint64_t Position = static_cast<uint64_t>(Offset);
+  for (size_t I = 0; I < IOVs.size(); ++I) {
+    auto *SQE = getSQE();
+    if (unlikely(!SQE)) {
+      abort(static_cast<uint32_t>(I));
+      return WasiUnexpect(__WASI_ERRNO_IO);
+    }
+    prepare(*SQE, IORING_OP_READ_FIXED, Fd, IOVs[I].data(),
+            static_cast<uint32_t>(IOVs[I].size()),
+            Offset < 0 ? kCurrentPosition : Position, I);
+    SQE->buf_index = 0;
+    if (I + 1 < IOVs.size()) {
+      SQE->flags = IOSQE_IO_LINK;
+    }
+    Position += IOVs[I].size();
+  }
+  if (auto Res = run(static_cast<uint32_t>(IOVs.size()), Results);
+      unlikely(!Res)) {
+    return WasiUnexpect(Res);
+  }
+  __wasi_size_t NRead = 0;
+  for (size_t I = 0; I < IOVs.size(); ++I) {
+    if (Results[I] < 0) {
+      if (I == 0) {
+        return WasiUnexpect(fromErrNo(-Results[I]));
+      }
+      break;
+    }
+    NRead += static_cast<__wasi_size_t>(Results[I]);
+    if (static_cast<size_t>(Results[I]) < IOVs[I].size()) {
+      break;
+    }
+  }
+  return NRead;
+}
+
+WasiExpect<__wasi_size_t> IOUring::write(int Fd,
+                                         Span<Span<const uint8_t>> IOVs,
+                                         int64_t Offset) noexcept {
+  const bool Fixed =
+      IOVs.size() <= SQEntries &&
+      std::all_of(IOVs.begin(), IOVs.end(),
+                  [this](Span<const uint8_t> IOV) { return isFixed(IOV); });
+  if (!Fixed) {
+    iovec SysIOVs[kIOVMax];
+    for (size_t I = 0; I < IOVs.size(); ++I) {
+      SysIOVs[I].iov_base = const_cast<uint8_t *>(IOVs[I].data());
+      SysIOVs[I].iov_len = IOVs[I].size();
+    }
+    auto *SQE = getSQE();
+    if (unlikely(!SQE)) {
+      return WasiUnexpect(__WASI_ERRNO_IO);
+    }
+    prepare(*SQE, IORING_OP_WRITEV, Fd, SysIOVs,
+            static_cast<uint32_t>(IOVs.size()),
+            Offset < 0 ? kCurrentPosition : static_cast<uint64_t>(Offset), 0);
+    int32_t Result;
+    if (auto Res = run(1, Span<int32_t>(&Result, 1)); unlikely(!Res)) {
+      return WasiUnexpect(Res);
+    }
+    if (Result < 0) {
+      return WasiUnexpect(fromErrNo(-Result));
+    }
+    return static_cast<__wasi_size_t>(Result);
+  }
+
+  // Write each IOV from the fixed buffer in a chain. A short write breaks
+  // the chain and cancels the rest as `writev` stops.
+  int32_t Results[kIOVMax];
+  uint64_t Position = static_cast<uint64_t>(Offset);
+  for (size_t I = 0; I < IOVs.size(); ++I) {
+    auto *SQE = getSQE();
+    if (unlikely(!SQE)) {
+      abort(static_cast<uint32_t>(I));
+      return WasiUnexpect(__WASI_ERRNO_IO);
+    }
+    prepare(*SQE, IORING_OP_WRITE_FIXED, Fd, IOVs[I].data(),
+            static_cast<uint32_t>(IOVs[I].size()),
+            Offset < 0 ? kCurrentPosition : Position, I);
+    SQE->buf_index = 0;
+    if (I + 1 < IOVs.size()) {
+      SQE->flags = IOSQE_IO_LINK;
+    }
+    Position += IOVs[I].size();
+  }
+  if (auto Res = run(static_cast<uint32_t>(IOVs.size()), Results);
+      unlikely(!Res)) {
+    return WasiUnexpect(Res);
+  }
+  __wasi_size_t NWritten = 0;
+  for (size_t I = 0; I < IOVs.size(); ++I) {
+    if (Results[I] < 0) {
+      if (I == 0) {
+        return WasiUnexpect(fromErrNo(-Results[I]));
+      }
+      break;
+    }
+    NWritten += static_cast<__wasi_size_t>(Results[I]);
+    if (static_cast<size_t>(Results[I]) < IOVs[I].size()) {
+      break;
+    }
+  }
+  return NWritten;
+}
+
+WasiExpect<__wasi_size_t> IOUring::recvmsg(int Fd, msghdr &Msg,
+                                           int Flags) noexcept {
+  auto *SQE = getSQE();
+  if (unlikely(!SQE)) {
+    return WasiUnexpect(__WASI_ERRNO_IO);
+  }
+  prepare(*SQE, IORING_OP_RECVMSG, Fd, &Msg, 1, 0, 0);
+  SQE->msg_flags = static_cast<uint32_t>(Flags);
+  int32_t Result;
+  if (auto Res = run(1, Span<int32_t>(&Result, 1)); unlikely(!Res)) {
+    return WasiUnexpect(Res);
+  }
+  if (Result < 0) {
+    return WasiUnexpect(fromErrNo(-Result));
+  }
+  return static_cast<__wasi_size_t>(Result);
+}
+
+WasiExpect<__wasi_size_t> IOUring::sendmsg(int Fd, const msghdr &Msg,
+                                           int Flags) noexcept {
+  auto *SQE = getSQE();
+  if (unlikely(!SQE)) {
+    return WasiUnexpect(__WASI_ERRNO_IO);
+  }
+  prepare(*SQE, IORING_OP_SENDMSG, Fd, &Msg, 1, 0, 0);
+  SQE->msg_flags = static_cast<uint32_t>(Flags);
+  int32_t Result;
+  if (auto Res = run(1, Span<int32_t>(&Result, 1)); unlikely(!Res)) {
+    return WasiUnexpect(Res);
+  }
+  if (Result < 0) {
+    return WasiUnexpect(fromErrNo(-Result));
+  }
+  return static_cast<__wasi_size_t>(Result);
+}
+
+WasiExpect<int> IOUring::accept(int Fd) noexcept {
+  auto *SQE = getSQE();
+  if (unlikely(!SQE)) {
+    return WasiUnexpect(__WASI_ERRNO_IO);
+  }
+  prepare(*SQE, IORING_OP_ACCEPT, Fd, nullptr, 0, 0, 0);
+  int32_t Result;
+  if (auto Res = run(1, Span<int32_t>(&Result, 1)); unlikely(!Res)) {
+    return WasiUnexpect(Res);
+  }
+  if (Result < 0) {
+    return WasiUnexpect(fromErrNo(-Result));
+  }
+  return Result;
+}
+
+WasiExpect<void> IOUring::connect(int Fd, const sockaddr *Addr,
+                                  socklen_t AddrLen) noexcept {
+  auto *SQE = getSQE();
+  if (unlikely(!SQE)) {
+    return WasiUnexpect(__WASI_ERRNO_IO);
+  }
+  prepare(*SQE, IORING_OP_CONNECT, Fd, Addr, 0, AddrLen, 0);
+  int32_t Result;
+  if (auto Res = run(1, Span<int32_t>(&Result, 1)); unlikely(!Res)) {
+    return WasiUnexpect(Res);
+  }
+  if (Result < 0) {
+    return WasiUnexpect(fromErrNo(-Result));
+  }
+  return {};
+}
+
+} // namespace WASI
+} // namespace Host
+} // namespace WasmEdge
+
+#endif
+#endif
@@ -0,0 +1,159 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/lib/host/wasi/iouring.h - io_uring backend ---------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the io_uring backend of the WASI file and socket I/O on
+/// Linux.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/defines.h"
+#if !WASMEDGE_OS_LINUX
+#error
+#endif
+
+#include "common/span.h"
+#include "host/wasi/error.h"
+#include "host/wasi/inode.h"
+
+#if defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#endif
+#endif
+
+#include <cstdint>
+#include <sys/socket.h>
+
+// The operations used here are all supported by the kernels with the fast
+// poll feature (Linux 5.7).
+#if defined(IORING_FEAT_FAST_POLL)
+#define WASMEDGE_WASI_IO_URING 1
+#else
+#define WASMEDGE_WASI_IO_URING 0
+#endif
+
+namespace WasmEdge {
+namespace Host {
+namespace WASI {
+
+#if WASMEDGE_WASI_IO_URING
+/// io_uring instance of a thread.
+///
+/// The WASI calls are synchronous, so each call fills its requests and
+/// waits for all of their completions in a single `io_uring_enter`. The
+/// completion queue is empty between the calls.
+class IOUring {
+public:
+  IOUring(const IOUring &) = delete;
+  IOUring &operator=(const IOUring &) = delete;
+  ~IOUring() noexcept;
+
+  /// Select the backend of the following I/O calls in the current thread.
+  /// If Enable is true and the kernel supports io_uring, the ring of the
+  /// thread is used, and the guest memory not larger than MaxBufferSize is
+  /// registered as its fixed buffer.
+  static void select(bool Enable, uint64_t MaxBufferSize,
+                     Span<uint8_t> Memory) noexcept;
+
+  /// Get the selected ring of the current thread, or nullptr if the epoll
+  /// backend is used.
+  static IOUring *current() noexcept;
+
+  /// Read into the IOVs from the offset, or from the file position if the
+  /// offset is -1, as `preadv` and `readv`.
+  WasiExpect<__wasi_size_t> read(int Fd, Span<Span<uint8_t>> IOVs,
+                                 int64_t Offset) noexcept;
+
+  /// Write the IOVs to the offset, or to the file position if the offset is
+  /// -1, as `pwritev` and `writev`.
+  WasiExpect<__wasi_size_t> write(int Fd, Span<Span<const uint8_t>> IOVs,
+                                  int64_t Offset) noexcept;
+
+  WasiExpect<__wasi_size_t> recvmsg(int Fd, msghdr &Msg, int Flags) noexcept;
+  WasiExpect<__wasi_size_t> sendmsg(int Fd, const msghdr &Msg,
+                                    int Flags) noexcept;
+  WasiExpect<int> accept(int Fd) noexcept;
+  WasiExpect<void> connect(int Fd, const sockaddr *Addr,
+                           socklen_t AddrLen) noexcept;
+
+  /// Get a cleared submission entry. The pending entries are submitted
+  /// first if the submission queue is full.
+  io_uring_sqe *getSQE() noexcept;
+
+  /// Submit the pending entries, and wait until at least WaitCount
+  /// completions are available.
+  WasiExpect<void> submitAndWait(uint32_t WaitCount) noexcept;
+
+  /// Get the next available completion, or nullptr if none. The completion
+  /// should be consumed by `seenCQE` after processed.
+  const io_uring_cqe *peekCQE() const noexcept;
+  void seenCQE() noexcept;
+
+  /// Queue a request to cancel the requests of the user data. The completion
+  /// of the cancel request has the user data `kCancelUserData`. Returns false
+  /// if no entry is available for it.
+  bool cancel(uint64_t UserData) noexcept;
+
+  /// Submit the pending entries, and wait until a completion is available.
+  /// Unlike `submitAndWait`, the interrupted and the busy waits are retried,
+  /// so the requests in flight can always be drained before their buffers are
+  /// released. Returns false if the ring is broken, which is not used by the
+  /// thread afterward.
+  bool waitCompletion() noexcept;
+
+  static inline constexpr const uint64_t kCancelUserData = ~UINT64_C(0);
+
+private:
+  IOUring() noexcept = default;
+  bool setup() noexcept;
+  void registerBuffer(Span<uint8_t> Memory, uint64_t MaxBufferSize) noexcept;
+  bool isFixed(Span<const uint8_t> Buffer) const noexcept {
+    return !Registered.empty() && Buffer.data() >= Registered.data() &&
+           Buffer.size() <= Registered.size() &&
+           static_cast<size_t>(Buffer.data() - Registered.data()) <=
+               Registered.size() - Buffer.size();
+  }
+  /// Submit the Count entries prepared by the caller, and collect their
+  /// results indexed by the user data.
+  WasiExpect<void> run(uint32_t Count, Span<int32_t> Results) noexcept;
+  /// Cancel the Count requests of the caller, whose user data are their
+  /// indices, and drop all of their completions.
+  void abort(uint32_t Count) noexcept;
+
+  FdHolder Ring;
+  uint8_t *SQRing = nullptr;
+  uint8_t *CQRing = nullptr;
+  size_t SQRingSize = 0;
+  size_t CQRingSize = 0;
+  io_uring_sqe *SQEs = nullptr;
+  uint32_t SQEntries = 0;
+  uint32_t *SQTail = nullptr;
+  uint32_t SQMask = 0;
+  uint32_t *CQHead = nullptr;
+  uint32_t *CQTail = nullptr;
+  uint32_t CQMask = 0;
+  io_uring_cqe *CQEs = nullptr;
+  /// Local tail of the filled entries, and the count of them not submitted.
+  uint32_t FilledTail = 0;
+  uint32_t Pending = 0;
+
+  /// The registered fixed buffer, and the failed registration not to be
+  /// retried, with the mapping generations of their registrations.
+  Span<uint8_t> Registered;
+  uint64_t RegisteredGeneration = 0;
+  Span<uint8_t> Failed;
+  uint64_t FailedGeneration = 0;
+};
+#endif
+
+} // namespace WASI
+} // namespace Host
+} // namespace WasmEdge
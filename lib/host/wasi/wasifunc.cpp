@@ -369,6 +369,22 @@ bool AllowAFUNIX(const Runtime::CallingFrame &Frame,
   }
   return true;
 }
+
+/// Select the I/O backend of the WASI call from the runtime configuration.
+void selectIOBackend(const Runtime::CallingFrame &Frame,
+                     const Runtime::Instance::MemoryInstance &MemInst) noexcept {
+  const auto *Executor = Frame.getExecutor();
+  if (!Executor) {
+    WASI::Environ::selectIOBackend(false, 0, {});
+    return;
+  }
+  const auto &Conf = Executor->getConfigure().getRuntimeConfigure();
+  WASI::Environ::selectIOBackend(
+      Conf.isEnableIOUring(), Conf.getMaxIOUringBufferSize(),
+      Span<uint8_t>(MemInst.getDataPtr(),
+                    MemInst.getPageSize() *
+                        Runtime::Instance::MemoryInstance::kPageSize));
+}
 } // namespace
 
 Expect<uint32_t> WasiArgsGet::body(const Runtime::CallingFrame &Frame,
@@ -772,6 +788,7 @@ Expect<uint32_t> WasiFdPread::body(const Runtime::CallingFrame &Frame,
   const __wasi_fd_t WasiFd = Fd;
   const __wasi_filesize_t WasiOffset = Offset;
 
+  selectIOBackend(Frame, *MemInst);
   if (auto Res = Env.fdPread(WasiFd, WasiIOVs, WasiOffset, *NRead);
       unlikely(!Res)) {
     return Res.error();
@@ -874,6 +891,7 @@ Expect<uint32_t> WasiFdPwrite::body(const Runtime::CallingFrame &Frame,
   const __wasi_fd_t WasiFd = Fd;
   const __wasi_filesize_t WasiOffset = Offset;
 
+  selectIOBackend(Frame, *MemInst);
   if (auto Res = Env.fdPwrite(WasiFd, WasiIOVs, WasiOffset, *NWritten);
       unlikely(!Res)) {
     return Res.error();
@@ -928,6 +946,7 @@ Expect<uint32_t> WasiFdRead::body(const Runtime::CallingFrame &Frame,
 
   const __wasi_fd_t WasiFd = Fd;
 
+  selectIOBackend(Frame, *MemInst);
   if (auto Res = Env.fdRead(WasiFd, WasiIOVs, *NRead); unlikely(!Res)) {
     return Res.error();
   }
@@ -1091,6 +1110,7 @@ Expect<uint32_t> WasiFdWrite::body(const Runtime::CallingFrame &Frame,
 
   const __wasi_fd_t WasiFd = Fd;
 
+  selectIOBackend(Frame, *MemInst);
   if (auto Res = Env.fdWrite(WasiFd, WasiIOVs, *NWritten); unlikely(!Res)) {
     return Res.error();
   }
@@ -1487,6 +1507,7 @@ Expect<uint32_t> WasiPollOneoff<Trigger>::body(
     return __WASI_ERRNO_FAULT;
   }
 
+  selectIOBackend(Frame, *MemInst);
   // Validate contents
   if (auto Poll = this->Env.acquirePoller(Events); unlikely(!Poll)) {
     for (__wasi_size_t I = 0; I < WasiNSub; ++I) {
@@ -1718,6 +1739,7 @@ Expect<uint32_t> WasiSockAcceptV1::body(const Runtime::CallingFrame &Frame,
   }
   const __wasi_fd_t WasiFd = Fd;
   const __wasi_fdflags_t WasiFdFlags = static_cast<__wasi_fdflags_t>(0);
+  selectIOBackend(Frame, *MemInst);
   if (auto Res = Env.sockAccept(WasiFd, WasiFdFlags); unlikely(!Res)) {
     return Res.error();
   } else {
@@ -1748,6 +1770,7 @@ Expect<uint32_t> WasiSockAcceptV2::body(const Runtime::CallingFrame &Frame,
     WasiFdFlags = *Res;
   }
 
+  selectIOBackend(Frame, *MemInst);
   if (auto Res = Env.sockAccept(WasiFd, WasiFdFlags); unlikely(!Res)) {
     return Res.error();
   } else {
@@ -1790,6 +1813,7 @@ Expect<uint32_t> WasiSockConnectV1::body(const Runtime::CallingFrame &Frame,
   }
 
   const __wasi_fd_t WasiFd = Fd;
+  selectIOBackend(Frame, *MemInst);
   if (auto Res = Env.sockConnect(WasiFd, WasiAddressFamily, Address,
                                  static_cast<uint16_t>(Port));
       unlikely(!Res)) {
@@ -1860,6 +1884,7 @@ Expect<uint32_t> WasiSockRecvV1::body(const Runtime::CallingFrame &Frame,
 
   const __wasi_fd_t WasiFd = Fd;
 
+  selectIOBackend(Frame, *MemInst);
   if (auto Res =
           Env.sockRecv(WasiFd, WasiRiData, WasiRiFlags, *RoDataLen, *RoFlags);
       unlikely(!Res)) {
@@ -1942,6 +1967,7 @@ Expect<uint32_t> WasiSockRecvFromV1::body(const Runtime::CallingFrame &Frame,
 
   const __wasi_fd_t WasiFd = Fd;
 
+  selectIOBackend(Frame, *MemInst);
   if (auto Res = Env.sockRecvFrom(WasiFd, WasiRiData, WasiRiFlags, nullptr,
                                   Address, nullptr, *RoDataLen, *RoFlags);
       unlikely(!Res)) {
@@ -2006,6 +2032,7 @@ Expect<uint32_t> WasiSockSendV1::body(const Runtime::CallingFrame &Frame,
 
   const __wasi_fd_t WasiFd = Fd;
 
+  selectIOBackend(Frame, *MemInst);
   if (auto Res = Env.sockSend(WasiFd, WasiSiData, WasiSiFlags, *SoDataLen);
       unlikely(!Res)) {
     return Res.error();
@@ -2093,6 +2120,7 @@ Expect<uint32_t> WasiSockSendToV1::body(const Runtime::CallingFrame &Frame,
 
   const __wasi_fd_t WasiFd = Fd;
 
+  selectIOBackend(Frame, *MemInst);
   if (auto Res =
           Env.sockSendTo(WasiFd, WasiSiData, WasiSiFlags, WasiAddressFamily,
                          Address, static_cast<uint16_t>(Port), *SoDataLen);
@@ -2602,6 +2630,7 @@ Expect<uint32_t> WasiSockConnectV2::body(const Runtime::CallingFrame &Frame,
   }
 
   const __wasi_fd_t WasiFd = Fd;
+  selectIOBackend(Frame, *MemInst);
   if (auto Res = Env.sockConnect(WasiFd, WasiAddressFamily, Address,
                                  static_cast<uint16_t>(Port));
       unlikely(!Res)) {
@@ -2671,6 +2700,7 @@ Expect<uint32_t> WasiSockRecvV2::body(const Runtime::CallingFrame &Frame,
 
   const __wasi_fd_t WasiFd = Fd;
 
+  selectIOBackend(Frame, *MemInst);
   if (auto Res =
           Env.sockRecv(WasiFd, WasiRiData, WasiRiFlags, *RoDataLen, *RoFlags);
       unlikely(!Res)) {
@@ -2773,6 +2803,7 @@ Expect<uint32_t> WasiSockRecvFromV2::body(const Runtime::CallingFrame &Frame,
 
   const __wasi_fd_t WasiFd = Fd;
 
+  selectIOBackend(Frame, *MemInst);
   if (auto Res =
           Env.sockRecvFrom(WasiFd, WasiRiData, WasiRiFlags, &WasiAddressFamily,
                            Address, RoPort, *RoDataLen, *RoFlags);
@@ -2840,6 +2871,7 @@ Expect<uint32_t> WasiSockSendV2::body(const Runtime::CallingFrame &Frame,
 
   const __wasi_fd_t WasiFd = Fd;
 
+  selectIOBackend(Frame, *MemInst);
   if (auto Res = Env.sockSend(WasiFd, WasiSiData, WasiSiFlags, *SoDataLen);
       unlikely(!Res)) {
     return Res.error();
@@ -2934,6 +2966,7 @@ Expect<uint32_t> WasiSockSendToV2::body(const Runtime::CallingFrame &Frame,
 
   const __wasi_fd_t WasiFd = Fd;
 
+  selectIOBackend(Frame, *MemInst);
   if (auto Res =
           Env.sockSendTo(WasiFd, WasiSiData, WasiSiFlags, WasiAddressFamily,
                          Address, static_cast<uint16_t>(Port), *SoDataLen);
@@ -7,9 +7,11 @@
 #include "common/defines.h"
 #include "data.h"
 #include "llvm.h"
+#include "parallel.h"
 
 #include <charconv>
 #include <fstream>
+#include <optional>
 #include <lld/Common/Driver.h>
 #include <random>
 #include <sstream>
@@ -50,6 +52,13 @@ namespace {
 
 using namespace WasmEdge;
 
+/// Alignment of the text content in the universal wasm file, which covers the
+/// 4KiB and 16KiB pages.
+static inline constexpr const uint64_t kFileAlignment = UINT64_C(16384);
+/// Name of the custom section padding the AOT section.
+static inline constexpr const std::string_view kPaddingName =
+    "wasmedge.padding"sv;
+
 #if WASMEDGE_OS_MACOS
 // Get current OS version
 std::string getOSVersion() noexcept {
@@ -133,6 +142,14 @@ Expect<void> WriteU64(std::ostream &OS, uint64_t Data) noexcept {
   return {};
 }
 
+uint64_t SizeOfU32(uint32_t Data) noexcept {
+  uint64_t Size = 1;
+  while (Data >>= 7) {
+    ++Size;
+  }
+  return Size;
+}
+
 Expect<void> WriteName(std::ostream &OS, std::string_view Data) noexcept {
   WriteU32(OS, static_cast<uint32_t>(Data.size()));
   for (const auto C : Data) {
@@ -176,12 +193,20 @@ std::filesystem::path createTemp(const std::filesystem::path Model) noexcept {
   }
 }
 
-// Write output object and link
-Expect<void> outputNativeLibrary(const std::filesystem::path &OutputPath,
-                                 const LLVM::MemoryBuffer &OSVec) noexcept {
+// Write output objects and link
+Expect<void>
+outputNativeLibrary(const std::filesystem::path &OutputPath,
+                    Span<const LLVM::MemoryBuffer> Objects) noexcept {
   spdlog::info("output start");
-  std::filesystem::path ObjectName;
-  {
+  std::vector<std::filesystem::path> ObjectNames;
+  std::vector<std::string> ObjectArgs;
+  auto RemoveObjects = [&ObjectNames]() {
+    std::error_code Error;
+    for (const auto &ObjectName : ObjectNames) {
+      std::filesystem::remove(ObjectName, Error);
+    }
+  };
+  for (const auto &OSVec : Objects) {
     // tempfile
     std::filesystem::path OPath(OutputPath);
 #if WASMEDGE_OS_WINDOWS
@@ -189,31 +214,27 @@ Expect<void> outputNativeLibrary(const std::filesystem::path &OutputPath,
 #else
     OPath.replace_extension("%%%%%%%%%%.o"sv);
 #endif
-    ObjectName = createTemp(OPath);
+    auto ObjectName = createTemp(OPath);
     if (ObjectName.empty()) {
       // TODO:return error
       spdlog::error("so file creation failed:{}", OPath.u8string());
+      RemoveObjects();
       return Unexpect(ErrCode::Value::IllegalPath);
     }
     std::ofstream OS(ObjectName, std::ios_base::binary);
     OS.write(OSVec.data(), static_cast<std::streamsize>(OSVec.size()));
     OS.close();
+    ObjectArgs.push_back(ObjectName.u8string());
+    ObjectNames.push_back(std::move(ObjectName));
   }
 
   // link
   bool LinkResult = false;
+  const auto OutputName = OutputPath.u8string();
 #if WASMEDGE_OS_MACOS
   const auto OSVersion = getOSVersion();
   const auto SDKVersion = getSDKVersion();
-#if LLVM_VERSION_MAJOR >= 14
-  // LLVM 14 replaces the older mach_o lld implementation with the new one.
-  // So we need to change the namespace after LLVM 14.x released.
-  // Reference: https://reviews.llvm.org/D114842
-  LinkResult = lld::macho::link(
-#else
-  LinkResult = lld::mach_o::link(
-#endif
-      std::initializer_list<const char *> {
+  std::vector<const char *> Args {
         "lld", "-arch",
 #if defined(__x86_64__)
             "x86_64",
@@ -233,21 +254,34 @@ Expect<void> outputNativeLibrary(const std::filesystem::path &OutputPath,
             "-dylib", "-demangle", "-macosx_version_min", OSVersion.c_str(),
             "-syslibroot",
             "/Library/Developer/CommandLineTools/SDKs/MacOSX.sdk",
-            ObjectName.u8string().c_str(), "-o", OutputPath.u8string().c_str()
-      },
+            "-o", OutputName.c_str()
+      };
+#elif WASMEDGE_OS_LINUX
+  std::vector<const char *> Args{"ld.lld",        "--eh-frame-hdr",
+                                 "--shared",      "--gc-sections",
+                                 "--discard-all", "-o",
+                                 OutputName.c_str()};
+#elif WASMEDGE_OS_WINDOWS
+  const auto OutArg = "-out:" + OutputName;
+  std::vector<const char *> Args{"lld-link", "-dll", "-base:0", "-nologo",
+                                 OutArg.c_str()};
+#endif
+  for (const auto &ObjectArg : ObjectArgs) {
+    Args.push_back(ObjectArg.c_str());
+  }
+
+#if WASMEDGE_OS_MACOS
+#if LLVM_VERSION_MAJOR >= 14
+  LinkResult = lld::macho::link(
+#else
+  LinkResult = lld::mach_o::link(
+#endif
 #elif WASMEDGE_OS_LINUX
   LinkResult = lld::elf::link(
-      std::initializer_list<const char *>{"ld.lld", "--eh-frame-hdr",
-                                          "--shared", "--gc-sections",
-                                          "--discard-all", ObjectName.c_str(),
-                                          "-o", OutputPath.u8string().c_str()},
 #elif WASMEDGE_OS_WINDOWS
   LinkResult = lld::coff::link(
-      std::initializer_list<const char *>{
-          "lld-link", "-dll", "-base:0", "-nologo",
-          ObjectName.u8string().c_str(),
-          ("-out:" + OutputPath.u8string()).c_str()},
 #endif
+      Args,
 
 #if LLVM_VERSION_MAJOR >= 14
       llvm::outs(), llvm::errs(), false, false
@@ -263,9 +297,9 @@ Expect<void> outputNativeLibrary(const std::filesystem::path &OutputPath,
 #endif
 
   if (LinkResult) {
-    std::error_code Error;
-    std::filesystem::remove(ObjectName, Error);
+    RemoveObjects();
 #if WASMEDGE_OS_WINDOWS
+    std::error_code Error;
     std::filesystem::path LibPath(OutputPath);
     LibPath.replace_extension(".lib"sv);
     std::filesystem::remove(LibPath, Error);
@@ -302,7 +336,7 @@ Expect<void> outputNativeLibrary(const std::filesystem::path &OutputPath,
 Expect<void> outputWasmLibrary(LLVM::Context LLContext,
                                const std::filesystem::path &OutputPath,
                                Span<const Byte> Data,
-                               const LLVM::MemoryBuffer &OSVec) noexcept {
+                               Span<const LLVM::MemoryBuffer> Objects) noexcept {
   std::filesystem::path SharedObjectName;
   {
     // tempfile
@@ -314,12 +348,13 @@ Expect<void> outputWasmLibrary(LLVM::Context LLContext,
       spdlog::error("so file creation failed:{}", SOPath.u8string());
       return Unexpect(ErrCode::Value::IllegalPath);
     }
+    // Reserve the file name until the linker writes it.
     std::ofstream OS(SharedObjectName, std::ios_base::binary);
-    OS.write(OSVec.data(), static_cast<std::streamsize>(OSVec.size()));
     OS.close();
   }
 
-  if (auto Res = outputNativeLibrary(SharedObjectName, OSVec); unlikely(!Res)) {
+  if (auto Res = outputNativeLibrary(SharedObjectName, Objects);
+      unlikely(!Res)) {
     return Unexpect(Res);
   }
 
@@ -342,6 +377,10 @@ Expect<void> outputWasmLibrary(LLVM::Context LLContext,
     ObjFile = std::move(Res);
   }
 
+  // The largest text section is aligned to its address in the pages of the
+  // output file, so the loader can map it from the file.
+  uint64_t AlignAddress = 0;
+  uint64_t AlignPos = 0;
   std::string OSCustomSecVec;
   {
     std::ostringstream OS;
@@ -450,6 +489,16 @@ Expect<void> outputWasmLibrary(LLVM::Context LLContext,
     }
     WriteU32(OS, SectionCount);
 
+    uint64_t AlignSize = kFileAlignment - 1;
+    for (auto Section = ObjFile.sections(); !ObjFile.isSectionEnd(Section);
+         Section.next()) {
+      if (Section.isText() && !Section.isEHFrame() && !Section.isPData() &&
+          Section.getSize() > AlignSize) {
+        AlignAddress = Section.getAddress();
+        AlignSize = Section.getSize();
+      }
+    }
+
     for (auto Section = ObjFile.sections(); !ObjFile.isSectionEnd(Section);
          Section.next()) {
       if (Section.getSize() == 0) {
@@ -476,10 +525,37 @@ Expect<void> outputWasmLibrary(LLVM::Context LLContext,
       WriteU64(OS, Section.getAddress());
       WriteU64(OS, Content.size());
       WriteName(OS, std::string_view(Content.data(), Content.size()));
+      if (Section.isText() && Section.getAddress() == AlignAddress &&
+          Content.size() == AlignSize) {
+        AlignPos = static_cast<uint64_t>(OS.tellp()) - Content.size();
+      }
     }
     OSCustomSecVec = OS.str();
   }
 
+  // Find the padding bytes of the custom section before the AOT section, which
+  // aligns the content of the largest text section.
+  std::optional<uint64_t> PaddingSize;
+  if (AlignPos != 0) {
+    const uint64_t Pos = Data.size() + 1 +
+                         SizeOfU32(static_cast<uint32_t>(OSCustomSecVec.size())) +
+                         AlignPos;
+    const auto Aligned = [&](uint64_t Padding) {
+      return (Pos + Padding) % kFileAlignment == AlignAddress % kFileAlignment;
+    };
+    if (!Aligned(0)) {
+      const uint64_t NameSize =
+          SizeOfU32(static_cast<uint32_t>(kPaddingName.size())) +
+          kPaddingName.size();
+      for (uint64_t Size = NameSize;; ++Size) {
+        if (Aligned(1 + SizeOfU32(static_cast<uint32_t>(Size)) + Size)) {
+          PaddingSize = Size - NameSize;
+          break;
+        }
+      }
+    }
+  }
+
   spdlog::info("output start");
 
   std::filesystem::path OutputPathTmp(OutputPath);
@@ -495,6 +571,14 @@ Expect<void> outputWasmLibrary(LLVM::Context LLContext,
   }
   OS.write(reinterpret_cast<const char *>(Data.data()),
            static_cast<std::streamsize>(Data.size()));
+  if (PaddingSize) {
+    std::ostringstream PaddingOS;
+    WriteName(PaddingOS, kPaddingName);
+    PaddingOS << std::string(*PaddingSize, '\0');
+    // Custom section id
+    WriteByte(OS, UINT8_C(0x00));
+    WriteName(OS, PaddingOS.str());
+  }
   // Custom section id
   WriteByte(OS, UINT8_C(0x00));
   WriteName(OS, std::string_view(OSCustomSecVec.data(), OSCustomSecVec.size()));
@@ -507,6 +591,38 @@ Expect<void> outputWasmLibrary(LLVM::Context LLContext,
   return {};
 }
 
+// Split the module and emit the partitions into objects on threads.
+Expect<std::vector<LLVM::MemoryBuffer>>
+emitParallel(LLVM::Module &LLModule, LLVM::TargetMachine &TM,
+             uint32_t Threads) noexcept {
+  // Splitting externalizes the local symbols. Keep them away from the names
+  // of the exported symbols.
+  LLVM::prefixLocalSymbols(LLModule, "wasmedge.local."sv);
+  auto Parts = LLVM::splitModule(LLModule, Threads);
+  std::vector<LLVM::MemoryBuffer> Objects(Parts.size());
+  parallelFor(
+      static_cast<uint32_t>(Parts.size()), Threads, [&](uint32_t I) {
+        LLVM::OrcThreadSafeContext TSContext;
+        auto Part = LLVM::parseBitcode(TSContext.getContext(), Parts[I]);
+        if (!Part) {
+          return;
+        }
+        auto PartTM = LLVM::cloneTargetMachine(TM);
+        auto [OSVec, ErrorMessage] =
+            PartTM.emitToMemoryBuffer(Part, LLVMObjectFile);
+        if (!ErrorMessage) {
+          Objects[I] = std::move(OSVec);
+        }
+      });
+  for (const auto &OSVec : Objects) {
+    if (!OSVec) {
+      spdlog::error("addPassesToEmitFile failed");
+      return Unexpect(ErrCode::Value::IllegalPath);
+    }
+  }
+  return Objects;
+}
+
 } // namespace
 
 namespace WasmEdge::LLVM {
@@ -612,22 +728,35 @@ Expect<void> CodeGen::codegen(Span<const Byte> WasmData, Data D,
       }
     }
 
-    auto [OSVec, ErrorMessage] =
-        TM.emitToMemoryBuffer(LLModule, LLVMObjectFile);
-    if (ErrorMessage) {
-      // TODO:return error
-      spdlog::error("addPassesToEmitFile failed");
-      return Unexpect(ErrCode::Value::IllegalPath);
+    std::vector<LLVM::MemoryBuffer> Objects;
+    if (const auto Threads = Conf.getCompilerConfigure().getThreads();
+        Threads > 1) {
+      if (auto Res = emitParallel(LLModule, TM, Threads); unlikely(!Res)) {
+        return Unexpect(Res);
+      } else {
+        Objects = std::move(*Res);
+      }
+    } else {
+      auto [OSVec, ErrorMessage] =
+          TM.emitToMemoryBuffer(LLModule, LLVMObjectFile);
+      if (ErrorMessage) {
+        // TODO:return error
+        spdlog::error("addPassesToEmitFile failed");
+        return Unexpect(ErrCode::Value::IllegalPath);
+      }
+      Objects.push_back(std::move(OSVec));
     }
 
     if (Conf.getCompilerConfigure().getOutputFormat() ==
         CompilerConfigure::OutputFormat::Wasm) {
-      if (auto Res = outputWasmLibrary(LLContext, OutputPath, WasmData, OSVec);
+      if (auto Res =
+              outputWasmLibrary(LLContext, OutputPath, WasmData, Objects);
           unlikely(!Res)) {
         return Unexpect(Res);
       }
     } else {
-      if (auto Res = outputNativeLibrary(OutputPath, OSVec); unlikely(!Res)) {
+      if (auto Res = outputNativeLibrary(OutputPath, Objects);
+          unlikely(!Res)) {
         return Unexpect(Res);
       }
     }
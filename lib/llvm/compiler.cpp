@@ -9,6 +9,12 @@
 #include "common/spdlog.h"
 #include "data.h"
 #include "llvm.h"
+#include "optimizer.h"
+#include "parallel.h"
+#include "runtime/instance/array.h"
+#include "runtime/instance/struct.h"
+
+#include <llvm-c/Linker.h>
 
 #include <algorithm>
 #include <array>
@@ -16,11 +22,15 @@
 #include <cstdint>
 #include <cstdlib>
 #include <limits>
+#include <map>
 #include <memory>
 #include <numeric>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <system_error>
+#include <utility>
+#include <vector>
 
 namespace LLVM = WasmEdge::LLVM;
 using namespace std::literals;
@@ -57,50 +67,13 @@ static inline constexpr const bool kForceDivCheck = true;
 // Size of a ValVariant
 static inline constexpr const uint32_t kValSize = sizeof(WasmEdge::ValVariant);
 
-// Translate Compiler::OptimizationLevel to llvm::PassBuilder version
-#if LLVM_VERSION_MAJOR >= 13
-static inline const char *
-toLLVMLevel(WasmEdge::CompilerConfigure::OptimizationLevel Level) noexcept {
-  using OL = WasmEdge::CompilerConfigure::OptimizationLevel;
-  switch (Level) {
-  case OL::O0:
-    return "default<O0>,function(tailcallelim)";
-  case OL::O1:
-    return "default<O1>,function(tailcallelim)";
-  case OL::O2:
-    return "default<O2>";
-  case OL::O3:
-    return "default<O3>";
-  case OL::Os:
-    return "default<Os>";
-  case OL::Oz:
-    return "default<Oz>";
-  default:
-    assumingUnreachable();
-  }
-}
-#else
-static inline std::pair<unsigned int, unsigned int>
-toLLVMLevel(WasmEdge::CompilerConfigure::OptimizationLevel Level) noexcept {
-  using OL = WasmEdge::CompilerConfigure::OptimizationLevel;
-  switch (Level) {
-  case OL::O0:
-    return {0, 0};
-  case OL::O1:
-    return {1, 0};
-  case OL::O2:
-    return {2, 0};
-  case OL::O3:
-    return {3, 0};
-  case OL::Os:
-    return {2, 1};
-  case OL::Oz:
-    return {2, 2};
-  default:
-    assumingUnreachable();
-  }
-}
-#endif
+// Externalized flag in the tags of the references
+static inline constexpr const uint64_t kExternalizedTag = UINT64_C(0x100);
+static inline constexpr const uint64_t kExternalizedMask = UINT64_C(0xFF00);
+
+// Externalized flag and heap type code in the tags of the references, which
+// are cleared for the defined types
+static inline constexpr const uint64_t kDefTypeTagMask = UINT64_C(0xFF00FF00);
 
 static inline LLVMCodeGenOptLevel toLLVMCodeGenLevel(
     WasmEdge::CompilerConfigure::OptimizationLevel Level) noexcept {
@@ -122,6 +95,72 @@ static inline LLVMCodeGenOptLevel toLLVMCodeGenLevel(
     assumingUnreachable();
   }
 }
+
+// Split the module into partitions, optimize them in parallel, and link them
+// back into LLModule.
+static WasmEdge::Expect<void>
+optimizeParallel(const WasmEdge::Configure &Conf, LLVM::Context LLContext,
+                 LLVM::Module &LLModule, LLVM::TargetMachine &TM,
+                 uint32_t Threads) noexcept {
+  // Splitting externalizes the local symbols. Record them to restore the
+  // linkage after linking back.
+  std::vector<std::pair<std::string, LLVMLinkage>> Functions, Globals;
+  for (auto Fn = LLModule.getFirstFunction(); Fn; Fn = Fn.getNextFunction()) {
+    if (const auto Linkage = Fn.getLinkage();
+        Linkage == LLVMInternalLinkage || Linkage == LLVMPrivateLinkage) {
+      Functions.emplace_back(Fn.getName(), Linkage);
+    }
+  }
+  for (auto GV = LLModule.getFirstGlobal(); GV; GV = GV.getNextGlobal()) {
+    if (const auto Linkage = GV.getLinkage();
+        Linkage == LLVMInternalLinkage || Linkage == LLVMPrivateLinkage) {
+      Globals.emplace_back(GV.getName(), Linkage);
+    }
+  }
+
+  auto Parts = LLVM::splitModule(LLModule, Threads);
+  std::vector<LLVM::MemoryBuffer> Results(Parts.size());
+  WasmEdge::parallelFor(
+      static_cast<uint32_t>(Parts.size()), Threads, [&](uint32_t I) {
+        LLVM::OrcThreadSafeContext TSContext;
+        auto Part = LLVM::parseBitcode(TSContext.getContext(), Parts[I]);
+        if (!Part) {
+          return;
+        }
+        auto PartTM = LLVM::cloneTargetMachine(TM);
+        LLVM::optimize(Conf, Part, PartTM);
+        Results[I] = LLVM::writeBitcode(Part);
+      });
+
+  LLVM::Module Linked(LLContext, "wasm");
+  Linked.setTarget(LLModule.getTarget());
+  for (auto &Result : Results) {
+    auto Part = Result ? LLVM::parseBitcode(LLContext, Result) : LLVM::Module();
+    if (!Part) {
+      spdlog::error("parallel optimization failed"sv);
+      return WasmEdge::Unexpect(WasmEdge::ErrCode::Value::IllegalGrammar);
+    }
+    // The source module is destroyed by the linker.
+    if (LLVMLinkModules2(Linked.unwrap(), Part.release())) {
+      spdlog::error("linking partitions failed"sv);
+      return WasmEdge::Unexpect(WasmEdge::ErrCode::Value::IllegalGrammar);
+    }
+  }
+  for (const auto &[Name, Linkage] : Functions) {
+    if (auto Fn = Linked.getNamedFunction(Name.c_str())) {
+      Fn.setLinkage(Linkage);
+      Fn.setVisibility(LLVMDefaultVisibility);
+    }
+  }
+  for (const auto &[Name, Linkage] : Globals) {
+    if (auto GV = Linked.getNamedGlobal(Name.c_str())) {
+      GV.setLinkage(Linkage);
+      GV.setVisibility(LLVMDefaultVisibility);
+    }
+  }
+  LLModule = std::move(Linked);
+  return {};
+}
 } // namespace
 
 struct LLVM::Compiler::CompileContext {
@@ -194,12 +233,37 @@ struct LLVM::Compiler::CompileContext {
 #endif
 #endif
 
+  std::vector<const AST::SubType *> SubTypes;
   std::vector<const AST::FunctionType *> FunctionTypes;
   std::vector<LLVM::Value> FunctionWrappers;
+  /// Offsets of the fields of the struct types, which are placed the same as
+  /// the struct instances.
+  std::vector<std::vector<uint32_t>> FieldOffsets;
+  /// Type depth tables of the defined types for the inlined subtype checks.
+  /// The display lists the canonical indices of the supertypes of each type
+  /// from the root, and a type at depth D matches the type T at depth DT iff
+  /// D >= DT and the entry DT of its display is the canonical index of T.
+  struct TypeDisplay {
+    /// Index of the first equivalent type of each type.
+    std::vector<uint32_t> Canonical;
+    /// Number of the supertypes of each type.
+    std::vector<uint32_t> Depth;
+    /// Start of the display of each type.
+    std::vector<uint32_t> Offset;
+    std::vector<uint32_t> Display;
+    /// Whether the display check agrees with the type matcher on the casts to
+    /// each type, which is checked at the first cast to the type.
+    std::vector<std::optional<bool>> Checkable;
+    LLVM::Value DepthTable;
+    LLVM::Value OffsetTable;
+    LLVM::Value DisplayTable;
+  };
+  std::unique_ptr<TypeDisplay> TypeDisplays;
   std::vector<std::tuple<uint32_t, LLVM::FunctionCallee,
                          const WasmEdge::AST::CodeSegment *>>
       Functions;
   std::vector<LLVM::Type> Globals;
+  std::vector<AST::MemoryType> Memories;
   LLVM::Value IntrinsicsTable;
   LLVM::FunctionCallee Trap;
   CompileContext(LLVM::Context C, LLVM::Module &M,
@@ -247,6 +311,16 @@ struct LLVM::Compiler::CompileContext {
                 Int64Ty,
                 // StopToken
                 Int32PtrTy,
+                // Module
+                Int8PtrTy,
+                // MemorySizes
+                Int64PtrTy.getPointerTo(),
+                // HostFuncs
+                Int8PtrTy.getPointerTo(),
+                // HostFrame
+                LLVM::Type::getArrayType(Int8PtrTy, 2),
+                // GCRequested
+                Int8PtrTy,
             })),
         ExecCtxPtrTy(ExecCtxTy.getPointerTo()),
         IntrinsicsTableTy(LLVM::Type::getArrayType(
@@ -362,6 +436,122 @@ struct LLVM::Compiler::CompileContext {
                            LLVM::Value ExecCtx) noexcept {
     return Builder.createExtractValue(ExecCtx, 6);
   }
+  LLVM::Value getModule(LLVM::Builder &Builder, LLVM::Value ExecCtx) noexcept {
+    return Builder.createExtractValue(ExecCtx, 7);
+  }
+  LLVM::Value getGCRequested(LLVM::Builder &Builder,
+                             LLVM::Value ExecCtx) noexcept {
+    return Builder.createExtractValue(ExecCtx, 11);
+  }
+  LLVM::Value getMemorySizePtr(LLVM::Builder &Builder, LLVM::Value ExecCtx,
+                               uint32_t Index) noexcept {
+    auto Array = Builder.createExtractValue(ExecCtx, 8);
+    auto VPtr = Builder.createLoad(
+        Int64PtrTy, Builder.createInBoundsGEP1(Int64PtrTy, Array,
+                                               LLContext.getInt64(Index)));
+    VPtr.setMetadata(LLContext, LLVM::Core::InvariantGroup,
+                     LLVM::Metadata(LLContext, {}));
+    return VPtr;
+  }
+  bool isMemory64(uint32_t Index) const noexcept {
+    return Memories[Index].getLimit().is64();
+  }
+  const std::vector<uint32_t> &getFieldOffsets(uint32_t TypeIdx) noexcept {
+    if (FieldOffsets.size() != SubTypes.size()) {
+      FieldOffsets.resize(SubTypes.size());
+    }
+    auto &Offsets = FieldOffsets[TypeIdx];
+    if (Offsets.empty()) {
+      std::vector<ValType> Types;
+      for (const auto &FType :
+           SubTypes[TypeIdx]->getCompositeType().getFieldTypes()) {
+        Types.push_back(FType.getStorageType());
+      }
+      Runtime::Instance::StructInstance::placeFields(Types, Offsets);
+    }
+    return Offsets;
+  }
+  /// Get the type depth tables for the casts to the defined type. nullptr if
+  /// the casts to the type should call the type matcher instead.
+  const TypeDisplay *getTypeDisplay(uint32_t TypeIdx) noexcept {
+    if (!TypeDisplays) {
+      buildTypeDisplay();
+    }
+    auto &Checkable = TypeDisplays->Checkable[TypeIdx];
+    if (!Checkable) {
+      Checkable = checkTypeDisplay(TypeIdx);
+    }
+    return *Checkable ? TypeDisplays.get() : nullptr;
+  }
+  void buildTypeDisplay() noexcept {
+    const auto Size = static_cast<uint32_t>(SubTypes.size());
+    auto D = std::make_unique<TypeDisplay>();
+    D->Canonical.resize(Size);
+    D->Depth.resize(Size);
+    D->Offset.resize(Size);
+    D->Checkable.resize(Size);
+    // The equivalent types are of the same kinds and depths.
+    std::map<std::pair<TypeCode, uint32_t>, std::vector<uint32_t>> Groups;
+    std::vector<uint32_t> Supers;
+    for (uint32_t I = 0; I < Size; ++I) {
+      Supers.clear();
+      for (uint32_t J = I;; J = SubTypes[J]->getSuperTypeIndices()[0]) {
+        Supers.push_back(J);
+        if (SubTypes[J]->getSuperTypeIndices().empty()) {
+          break;
+        }
+      }
+      D->Depth[I] = static_cast<uint32_t>(Supers.size() - 1);
+      D->Canonical[I] = I;
+      auto &Group =
+          Groups[{SubTypes[I]->getCompositeType().getContentTypeCode(),
+                  D->Depth[I]}];
+      for (const uint32_t J : Group) {
+        if (AST::TypeMatcher::matchType(SubTypes, J, I) &&
+            AST::TypeMatcher::matchType(SubTypes, I, J)) {
+          D->Canonical[I] = J;
+          break;
+        }
+      }
+      if (D->Canonical[I] == I) {
+        Group.push_back(I);
+      }
+      D->Offset[I] = static_cast<uint32_t>(D->Display.size());
+      for (auto It = Supers.rbegin(); It != Supers.rend(); ++It) {
+        D->Display.push_back(D->Canonical[*It]);
+      }
+    }
+
+    auto CreateTable = [this](Span<const uint32_t> Values, const char *Name) {
+      std::vector<LLVM::Value> Elements;
+      Elements.reserve(Values.size());
+      for (const uint32_t V : Values) {
+        Elements.push_back(LLContext.getInt32(V));
+      }
+      auto Ty = LLVM::Type::getArrayType(Int32Ty,
+                                         static_cast<uint32_t>(Values.size()));
+      return LLModule.addGlobal(Ty, true, LLVMPrivateLinkage,
+                                LLVM::Value::getConstArray(Int32Ty, Elements),
+                                Name);
+    };
+    D->DepthTable = CreateTable(D->Depth, "types.depth");
+    D->OffsetTable = CreateTable(D->Offset, "types.offset");
+    D->DisplayTable = CreateTable(D->Display, "types.display");
+    TypeDisplays = std::move(D);
+  }
+  bool checkTypeDisplay(uint32_t TypeIdx) const noexcept {
+    const auto &D = *TypeDisplays;
+    const uint32_t Depth = D.Depth[TypeIdx];
+    for (uint32_t I = 0; I < SubTypes.size(); ++I) {
+      const bool IsMatch =
+          D.Depth[I] >= Depth &&
+          D.Display[D.Offset[I] + Depth] == D.Canonical[TypeIdx];
+      if (IsMatch != AST::TypeMatcher::matchType(SubTypes, TypeIdx, I)) {
+        return false;
+      }
+    }
+    return true;
+  }
   LLVM::FunctionCallee getIntrinsic(LLVM::Builder &Builder,
                                     Executable::Intrinsics Index,
                                     LLVM::Type Ty) noexcept {
@@ -496,13 +686,27 @@ public:
   FunctionCompiler(LLVM::Compiler::CompileContext &Context,
                    LLVM::FunctionCallee F, Span<const ValType> Locals,
                    bool Interruptible, bool InstructionCounting,
-                   bool GasMeasuring) noexcept
+                   bool GasMeasuring, bool BatchedMetering) noexcept
       : Context(Context), LLContext(Context.LLContext),
-        Interruptible(Interruptible), F(F), Builder(LLContext) {
+        Interruptible(Interruptible), BatchedMetering(BatchedMetering), F(F),
+        Builder(LLContext) {
     if (F.Fn) {
       Builder.positionAtEnd(LLVM::BasicBlock::create(LLContext, F.Fn, "entry"));
       ExecCtx = Builder.createLoad(Context.ExecCtxTy, F.Fn.getFirstParam());
 
+      // Cache the sizes of the unshared 64-bit memories for the bound checks,
+      // so the checks can be hoisted out of the loops. The caches are
+      // reloaded after the calls and memory.grow. The sizes of the shared
+      // ones are loaded at every access for the growing in other threads.
+      MemorySizes.resize(Context.Memories.size());
+      for (uint32_t I = 0; I < Context.Memories.size(); ++I) {
+        if (Context.isMemory64(I) &&
+            !Context.Memories[I].getLimit().isShared()) {
+          MemorySizes[I] = Builder.createAlloca(Context.Int64Ty);
+        }
+      }
+      reloadMemorySizes();
+
       if (InstructionCounting) {
         LocalInstrCount = Builder.createAlloca(Context.Int64Ty);
         Builder.createStore(LLContext.getInt64(0), LocalInstrCount);
@@ -539,12 +743,82 @@ public:
     return BB;
   }
 
+  /// Reload the cached sizes of the 64-bit memories.
+  void reloadMemorySizes() noexcept {
+    for (uint32_t I = 0; I < MemorySizes.size(); ++I) {
+      if (MemorySizes[I]) {
+        Builder.createStore(
+            Builder.createLoad(Context.Int64Ty,
+                               Context.getMemorySizePtr(Builder, ExecCtx, I)),
+            MemorySizes[I]);
+      }
+    }
+  }
+
+  /// Get the byte size of the 64-bit memory.
+  LLVM::Value getMemorySize(uint32_t Index) noexcept {
+    if (MemorySizes[Index]) {
+      return Builder.createLoad(Context.Int64Ty, MemorySizes[Index]);
+    }
+    auto Size = Builder.createLoad(
+        Context.Int64Ty, Context.getMemorySizePtr(Builder, ExecCtx, Index));
+    Size.setOrdering(LLVMAtomicOrderingMonotonic);
+    Size.setAlignment(8);
+    return Size;
+  }
+
+  /// Get the byte offset in the memory of the access of Size bytes at the
+  /// address Addr with the offset immediate. The accesses of the 32-bit
+  /// memories are covered by the guard regions. The ones of the 64-bit
+  /// memories are checked against the memory size explicitly.
+  LLVM::Value compileMemoryOffset(uint32_t MemoryIndex, LLVM::Value Addr,
+                                  uint64_t Offset, uint64_t Size) noexcept {
+    if (!Context.isMemory64(MemoryIndex)) {
+      auto Off = Builder.createZExt(Addr, Context.Int64Ty);
+      if (Offset != 0) {
+        Off = Builder.createAdd(Off, LLContext.getInt64(Offset));
+      }
+      return Off;
+    }
+    auto OkBB = LLVM::BasicBlock::create(LLContext, F.Fn, "mem64.ok");
+    if (Offset > std::numeric_limits<uint64_t>::max() - Size) {
+      // The access always overflows.
+      Builder.createBr(getTrapBB(ErrCode::Value::MemoryOutOfBounds));
+      Builder.positionAtEnd(OkBB);
+      return LLContext.getInt64(0);
+    }
+    // Addr + Offset + Size <= MemSize without overflow.
+    const auto End = LLContext.getInt64(Offset + Size);
+    auto MemSize = getMemorySize(MemoryIndex);
+    auto InBound = Builder.createAnd(
+        Builder.createICmpUGE(MemSize, End),
+        Builder.createICmpULE(Addr, Builder.createSub(MemSize, End)));
+    Builder.createCondBr(Builder.createLikely(InBound), OkBB,
+                         getTrapBB(ErrCode::Value::MemoryOutOfBounds));
+    Builder.positionAtEnd(OkBB);
+    if (Offset != 0) {
+      return Builder.createAdd(Addr, LLContext.getInt64(Offset));
+    }
+    return Addr;
+  }
+
+  /// Extend the address or length operand of the memory to i64 for the
+  /// intrinsics.
+  LLVM::Value toMemoryAddress(uint32_t MemoryIndex,
+                              LLVM::Value Addr) noexcept {
+    if (Context.isMemory64(MemoryIndex)) {
+      return Addr;
+    }
+    return Builder.createZExt(Addr, Context.Int64Ty);
+  }
+
   void
   compile(const AST::CodeSegment &Code,
           std::pair<std::vector<ValType>, std::vector<ValType>> Type) noexcept {
     auto RetBB = LLVM::BasicBlock::create(LLContext, F.Fn, "ret");
     Type.first.clear();
     enterBlock(RetBB, {}, {}, {}, std::move(Type));
+    checkSafepoint();
     compile(Code.getExpr().getInstrs());
     assuming(ControlStack.empty());
     compileReturn();
@@ -585,7 +859,9 @@ public:
         }
         enterBlock(EndBlock, {}, {}, std::move(Args), std::move(Type));
         checkStop();
-        updateGas();
+        if (!BatchedMetering) {
+          updateGas();
+        }
         return;
       }
       case OpCode::Loop: {
@@ -617,6 +893,7 @@ public:
         }
         enterBlock(Loop, EndLoop, {}, std::move(Args), std::move(Type));
         checkStop();
+        checkSafepoint();
         updateGas();
         return;
       }
@@ -758,15 +1035,31 @@ public:
         stackPop();
         break;
       }
+      case OpCode::Br_on_cast:
+      case OpCode::Br_on_cast_fail: {
+        const auto &BrCast = Instr.getBrCast();
+        const auto Label = BrCast.Jump.TargetIndex;
+        auto Cond = compileRefTest(Stack.back(), BrCast.RType2);
+        if (Instr.getOpCode() == OpCode::Br_on_cast_fail) {
+          Cond = Builder.createNot(Cond);
+        }
+        setLableJumpPHI(Label);
+        auto Next = LLVM::BasicBlock::create(LLContext, F.Fn, "br_on_cast.end");
+        Builder.createCondBr(Cond, getLabel(Label), Next);
+        Builder.positionAtEnd(Next);
+        break;
+      }
       case OpCode::Call:
         updateInstrCount();
         updateGas();
         compileCallOp(Instr.getTargetIndex());
+        reloadMemorySizes();
         break;
       case OpCode::Call_indirect:
         updateInstrCount();
         updateGas();
         compileIndirectCallOp(Instr.getSourceIndex(), Instr.getTargetIndex());
+        reloadMemorySizes();
         break;
       case OpCode::Return_call:
         updateInstrCount();
@@ -789,6 +1082,7 @@ public:
         updateInstrCount();
         updateGas();
         compileCallRefOp(Instr.getTargetIndex());
+        reloadMemorySizes();
         break;
       case OpCode::Return_call_ref:
         updateInstrCount();
@@ -823,9 +1117,10 @@ public:
           default:
             assumingUnreachable();
           }
-        } else {
-          // TODO: GC - AOT: support other composite here.
+        } else if (Context.FunctionTypes[Instr.getValType().getTypeIndex()]) {
           VType = TypeCode::NullFuncRef;
+        } else {
+          VType = TypeCode::NullRef;
         }
         std::copy_n(VType.getRawData().cbegin(), 8, Val.begin());
         auto Vector = LLVM::Value::getConstVector8(LLContext, Val);
@@ -861,6 +1156,245 @@ public:
         Builder.positionAtEnd(Next);
         break;
       }
+      case OpCode::Ref__eq: {
+        auto RHS = Builder.createBitCast(stackPop(), Context.Int64x2Ty);
+        auto LHS = Builder.createBitCast(stackPop(), Context.Int64x2Ty);
+        stackPush(Builder.createZExt(
+            Builder.createICmpEQ(
+                Builder.createExtractElement(LHS, LLContext.getInt64(1)),
+                Builder.createExtractElement(RHS, LLContext.getInt64(1))),
+            Context.Int32Ty));
+        break;
+      }
+      case OpCode::Struct__new:
+        compileStructNewOp(Instr.getTargetIndex(), false);
+        break;
+      case OpCode::Struct__new_default:
+        compileStructNewOp(Instr.getTargetIndex(), true);
+        break;
+      case OpCode::Struct__get:
+      case OpCode::Struct__get_u:
+        compileStructGetOp(Instr.getTargetIndex(), Instr.getSourceIndex(),
+                           false);
+        break;
+      case OpCode::Struct__get_s:
+        compileStructGetOp(Instr.getTargetIndex(), Instr.getSourceIndex(),
+                           true);
+        break;
+      case OpCode::Struct__set:
+        compileStructSetOp(Instr.getTargetIndex(), Instr.getSourceIndex());
+        break;
+      case OpCode::Array__new: {
+        auto Length = stackPop();
+        auto Buffer = createValueBuffer(1);
+        storeValueBuffer(Buffer, 0, stackPop());
+        compileArrayNewOp(Instr.getTargetIndex(), Length, Buffer, 1);
+        break;
+      }
+      case OpCode::Array__new_default:
+        compileArrayNewOp(Instr.getTargetIndex(), stackPop(),
+                          LLVM::Value::getConstPointerNull(Context.Int8PtrTy),
+                          0);
+        break;
+      case OpCode::Array__new_fixed: {
+        const uint32_t Count = Instr.getSourceIndex();
+        LLVM::Value Buffer =
+            LLVM::Value::getConstPointerNull(Context.Int8PtrTy);
+        if (Count > 0) {
+          Buffer = createValueBuffer(Count);
+          for (uint32_t I = 0; I < Count; ++I) {
+            storeValueBuffer(Buffer, Count - 1 - I, stackPop());
+          }
+        }
+        compileArrayNewOp(Instr.getTargetIndex(), LLContext.getInt32(Count),
+                          Buffer, Count);
+        break;
+      }
+      case OpCode::Array__new_data:
+      case OpCode::Array__new_elem: {
+        auto Len = stackPop();
+        auto Off = stackPop();
+        stackPush(Builder.createCall(
+            Context.getIntrinsic(
+                Builder,
+                Instr.getOpCode() == OpCode::Array__new_data
+                    ? Executable::Intrinsics::kArrayNewData
+                    : Executable::Intrinsics::kArrayNewElem,
+                LLVM::Type::getFunctionType(Context.Int64x2Ty,
+                                            {Context.Int32Ty, Context.Int32Ty,
+                                             Context.Int32Ty, Context.Int32Ty},
+                                            false)),
+            {LLContext.getInt32(Instr.getTargetIndex()),
+             LLContext.getInt32(Instr.getSourceIndex()), Off, Len}));
+        break;
+      }
+      case OpCode::Array__get:
+      case OpCode::Array__get_u:
+        compileArrayGetOp(Instr.getTargetIndex(), false);
+        break;
+      case OpCode::Array__get_s:
+        compileArrayGetOp(Instr.getTargetIndex(), true);
+        break;
+      case OpCode::Array__set:
+        compileArraySetOp(Instr.getTargetIndex());
+        break;
+      case OpCode::Array__len: {
+        auto ObjPtr =
+            compileGCObjectPtr(stackPop(), ErrCode::Value::AccessNullArray);
+        stackPush(compileArrayLength(ObjPtr));
+        break;
+      }
+      case OpCode::Array__fill: {
+        auto Len = stackPop();
+        auto Buffer = createValueBuffer(1);
+        storeValueBuffer(Buffer, 0, stackPop());
+        auto Off = stackPop();
+        auto Ref = Builder.createBitCast(stackPop(), Context.Int64x2Ty);
+        Builder.createCall(
+            Context.getIntrinsic(
+                Builder, Executable::Intrinsics::kArrayFill,
+                LLVM::Type::getFunctionType(
+                    Context.VoidTy,
+                    {Context.Int64x2Ty, Context.Int32Ty, Context.Int8PtrTy,
+                     Context.Int32Ty},
+                    false)),
+            {Ref, Off, Buffer, Len});
+        break;
+      }
+      case OpCode::Array__copy: {
+        auto Len = stackPop();
+        auto SrcOff = stackPop();
+        auto SrcRef = Builder.createBitCast(stackPop(), Context.Int64x2Ty);
+        auto DstOff = stackPop();
+        auto DstRef = Builder.createBitCast(stackPop(), Context.Int64x2Ty);
+        Builder.createCall(
+            Context.getIntrinsic(
+                Builder, Executable::Intrinsics::kArrayCopy,
+                LLVM::Type::getFunctionType(
+                    Context.VoidTy,
+                    {Context.Int64x2Ty, Context.Int32Ty, Context.Int64x2Ty,
+                     Context.Int32Ty, Context.Int32Ty},
+                    false)),
+            {DstRef, DstOff, SrcRef, SrcOff, Len});
+        break;
+      }
+      case OpCode::Array__init_data:
+      case OpCode::Array__init_elem: {
+        auto Len = stackPop();
+        auto SrcOff = stackPop();
+        auto DstOff = stackPop();
+        auto Ref = Builder.createBitCast(stackPop(), Context.Int64x2Ty);
+        Builder.createCall(
+            Context.getIntrinsic(
+                Builder,
+                Instr.getOpCode() == OpCode::Array__init_data
+                    ? Executable::Intrinsics::kArrayInitData
+                    : Executable::Intrinsics::kArrayInitElem,
+                LLVM::Type::getFunctionType(
+                    Context.VoidTy,
+                    {Context.Int32Ty, Context.Int64x2Ty, Context.Int32Ty,
+                     Context.Int32Ty, Context.Int32Ty},
+                    false)),
+            {LLContext.getInt32(Instr.getSourceIndex()), Ref, DstOff, SrcOff,
+             Len});
+        break;
+      }
+      case OpCode::Ref__test:
+      case OpCode::Ref__test_null:
+        stackPush(Builder.createZExt(
+            compileRefTest(stackPop(), Instr.getValType()), Context.Int32Ty));
+        break;
+      case OpCode::Ref__cast:
+      case OpCode::Ref__cast_null: {
+        auto IsMatch = compileRefTest(Stack.back(), Instr.getValType());
+        auto Next = LLVM::BasicBlock::create(LLContext, F.Fn, "ref_cast.ok");
+        Builder.createCondBr(Builder.createLikely(IsMatch), Next,
+                             getTrapBB(ErrCode::Value::CastFailed));
+        Builder.positionAtEnd(Next);
+        break;
+      }
+      case OpCode::Any__convert_extern: {
+        // Internalize. The external references are retyped to the any
+        // references.
+        auto Ref = Builder.createBitCast(stackPop(), Context.Int64x2Ty);
+        auto Tag = Builder.createAnd(
+            Builder.createExtractElement(Ref, LLContext.getInt64(0)),
+            LLContext.getInt64(~kExternalizedMask));
+        auto HTCode = Builder.createAnd(
+            Builder.createLShr(Tag, LLContext.getInt64(24)),
+            LLContext.getInt64(0xFFU));
+        auto IsExtern = Builder.createOr(
+            Builder.createICmpEQ(
+                HTCode,
+                LLContext.getInt64(static_cast<uint8_t>(TypeCode::ExternRef))),
+            Builder.createICmpEQ(HTCode,
+                                 LLContext.getInt64(static_cast<uint8_t>(
+                                     TypeCode::NullExternRef))));
+        Tag = Builder.createSelect(
+            IsExtern, getRefTag(ValType(TypeCode::Ref, TypeCode::AnyRef)),
+            Tag);
+        auto IsNull = Builder.createICmpEQ(
+            Builder.createExtractElement(Ref, LLContext.getInt64(1)),
+            LLContext.getInt64(0));
+        Tag = Builder.createSelect(
+            IsNull, getRefTag(ValType(TypeCode::RefNull, TypeCode::NullRef)),
+            Tag);
+        stackPush(Builder.createInsertElement(Ref, Tag, LLContext.getInt64(0)));
+        break;
+      }
+      case OpCode::Extern__convert_any: {
+        // Externalize. The externalized flag reserves the type of the
+        // reference for internalizing.
+        auto Ref = Builder.createBitCast(stackPop(), Context.Int64x2Ty);
+        auto Tag = Builder.createOr(
+            Builder.createExtractElement(Ref, LLContext.getInt64(0)),
+            LLContext.getInt64(kExternalizedTag));
+        auto IsNull = Builder.createICmpEQ(
+            Builder.createExtractElement(Ref, LLContext.getInt64(1)),
+            LLContext.getInt64(0));
+        Tag = Builder.createSelect(
+            IsNull,
+            getRefTag(ValType(TypeCode::RefNull, TypeCode::NullExternRef)),
+            Tag);
+        stackPush(Builder.createInsertElement(Ref, Tag, LLContext.getInt64(0)));
+        break;
+      }
+      case OpCode::Ref__i31: {
+        auto Num = Builder.createZExt(
+            Builder.createOr(
+                Builder.createAnd(stackPop(), LLContext.getInt32(0x7FFFFFFFU)),
+                LLContext.getInt32(0x80000000U)),
+            Context.Int64Ty);
+        const std::array<LLVM::Value, 2> Ref = {
+            getRefTag(ValType(TypeCode::Ref, TypeCode::I31Ref)),
+            LLContext.getInt64(0)};
+        stackPush(Builder.createInsertElement(LLVM::Value::getConstVector(Ref),
+                                              Num, LLContext.getInt64(1)));
+        break;
+      }
+      case OpCode::I31__get_s:
+      case OpCode::I31__get_u: {
+        auto Num = Builder.createTrunc(
+            Builder.createExtractElement(
+                Builder.createBitCast(stackPop(), Context.Int64x2Ty),
+                LLContext.getInt64(1)),
+            Context.Int32Ty);
+        // The i31 references have the bit 31 set.
+        auto Next = LLVM::BasicBlock::create(LLContext, F.Fn, "i31.not_null");
+        Builder.createCondBr(
+            Builder.createLikely(
+                Builder.createICmpSLT(Num, LLContext.getInt32(0))),
+            Next, getTrapBB(ErrCode::Value::AccessNullI31));
+        Builder.positionAtEnd(Next);
+        if (Instr.getOpCode() == OpCode::I31__get_s) {
+          stackPush(Builder.createAShr(
+              Builder.createShl(Num, LLContext.getInt32(1)),
+              LLContext.getInt32(1)));
+        } else {
+          stackPush(Builder.createAnd(Num, LLContext.getInt32(0x7FFFFFFFU)));
+        }
+        break;
+      }
       case OpCode::Drop:
         stackPop();
         break;
@@ -1091,35 +1625,43 @@ public:
         compileStoreOp(Instr.getTargetIndex(), Instr.getMemoryOffset(),
                        Instr.getMemoryAlign(), Context.Int32Ty, true);
         break;
-      case OpCode::Memory__size:
-        stackPush(Builder.createCall(
+      case OpCode::Memory__size: {
+        auto Size = Builder.createCall(
             Context.getIntrinsic(Builder, Executable::Intrinsics::kMemSize,
-                                 LLVM::Type::getFunctionType(Context.Int32Ty,
+                                 LLVM::Type::getFunctionType(Context.Int64Ty,
                                                              {Context.Int32Ty},
                                                              false)),
-            {LLContext.getInt32(Instr.getTargetIndex())}));
+            {LLContext.getInt32(Instr.getTargetIndex())});
+        stackPush(Context.isMemory64(Instr.getTargetIndex())
+                      ? Size
+                      : Builder.createTrunc(Size, Context.Int32Ty));
         break;
+      }
       case OpCode::Memory__grow: {
-        auto Diff = stackPop();
-        stackPush(Builder.createCall(
+        auto Diff = toMemoryAddress(Instr.getTargetIndex(), stackPop());
+        auto Old = Builder.createCall(
             Context.getIntrinsic(
                 Builder, Executable::Intrinsics::kMemGrow,
-                LLVM::Type::getFunctionType(Context.Int32Ty,
-                                            {Context.Int32Ty, Context.Int32Ty},
+                LLVM::Type::getFunctionType(Context.Int64Ty,
+                                            {Context.Int32Ty, Context.Int64Ty},
                                             false)),
-            {LLContext.getInt32(Instr.getTargetIndex()), Diff}));
+            {LLContext.getInt32(Instr.getTargetIndex()), Diff});
+        stackPush(Context.isMemory64(Instr.getTargetIndex())
+                      ? Old
+                      : Builder.createTrunc(Old, Context.Int32Ty));
+        reloadMemorySizes();
         break;
       }
       case OpCode::Memory__init: {
         auto Len = stackPop();
         auto Src = stackPop();
-        auto Dst = stackPop();
+        auto Dst = toMemoryAddress(Instr.getTargetIndex(), stackPop());
         Builder.createCall(
             Context.getIntrinsic(
                 Builder, Executable::Intrinsics::kMemInit,
                 LLVM::Type::getFunctionType(Context.VoidTy,
                                             {Context.Int32Ty, Context.Int32Ty,
-                                             Context.Int32Ty, Context.Int32Ty,
+                                             Context.Int64Ty, Context.Int32Ty,
                                              Context.Int32Ty},
                                             false)),
             {LLContext.getInt32(Instr.getTargetIndex()),
@@ -1135,31 +1677,36 @@ public:
         break;
       }
       case OpCode::Memory__copy: {
+        // The length is i64 only when both memories are 64-bit.
         auto Len = stackPop();
-        auto Src = stackPop();
-        auto Dst = stackPop();
+        if (!Context.isMemory64(Instr.getTargetIndex()) ||
+            !Context.isMemory64(Instr.getSourceIndex())) {
+          Len = Builder.createZExt(Len, Context.Int64Ty);
+        }
+        auto Src = toMemoryAddress(Instr.getSourceIndex(), stackPop());
+        auto Dst = toMemoryAddress(Instr.getTargetIndex(), stackPop());
         Builder.createCall(
             Context.getIntrinsic(
                 Builder, Executable::Intrinsics::kMemCopy,
                 LLVM::Type::getFunctionType(Context.VoidTy,
                                             {Context.Int32Ty, Context.Int32Ty,
-                                             Context.Int32Ty, Context.Int32Ty,
-                                             Context.Int32Ty},
+                                             Context.Int64Ty, Context.Int64Ty,
+                                             Context.Int64Ty},
                                             false)),
             {LLContext.getInt32(Instr.getTargetIndex()),
              LLContext.getInt32(Instr.getSourceIndex()), Dst, Src, Len});
         break;
       }
       case OpCode::Memory__fill: {
-        auto Len = stackPop();
+        auto Len = toMemoryAddress(Instr.getTargetIndex(), stackPop());
         auto Val = Builder.createTrunc(stackPop(), Context.Int8Ty);
-        auto Off = stackPop();
+        auto Off = toMemoryAddress(Instr.getTargetIndex(), stackPop());
         Builder.createCall(
             Context.getIntrinsic(
                 Builder, Executable::Intrinsics::kMemFill,
                 LLVM::Type::getFunctionType(Context.VoidTy,
-                                            {Context.Int32Ty, Context.Int32Ty,
-                                             Context.Int8Ty, Context.Int32Ty},
+                                            {Context.Int32Ty, Context.Int64Ty,
+                                             Context.Int8Ty, Context.Int64Ty},
                                             false)),
             {LLContext.getInt32(Instr.getTargetIndex()), Off, Val, Len});
         break;
@@ -3046,7 +3593,19 @@ public:
       }
       return;
     };
-    for (const auto &Instr : Instrs) {
+    bool BlockStart = true;
+    for (size_t I = 0; I < Instrs.size(); ++I) {
+      const auto &Instr = Instrs[I];
+      if (BatchedMetering) {
+        // Charge the whole basic block at its first instruction.
+        if (BlockStart) {
+          chargeBlock(Instrs.subspan(I));
+        }
+        BlockStart = isBlockBoundary(Instr.getOpCode());
+        Dispatch(Instr);
+        continue;
+      }
+
       // Update instruction count
       if (LocalInstrCount) {
         Builder.createStore(
@@ -3298,53 +3857,46 @@ public:
     Builder.createFence(LLVMAtomicOrderingSequentiallyConsistent);
   }
   void compileAtomicNotify(unsigned MemoryIndex,
-                           unsigned MemoryOffset) noexcept {
+                           uint64_t MemoryOffset) noexcept {
     auto Count = stackPop();
-    auto Addr = Builder.createZExt(Stack.back(), Context.Int64Ty);
-    if (MemoryOffset != 0) {
-      Addr = Builder.createAdd(Addr, LLContext.getInt64(MemoryOffset));
-    }
+    auto Addr =
+        compileMemoryOffset(MemoryIndex, stackPop(), MemoryOffset, 4);
     compileAtomicCheckOffsetAlignment(Addr, Context.Int32Ty);
-    auto Offset = stackPop();
 
     stackPush(Builder.createCall(
         Context.getIntrinsic(
             Builder, Executable::Intrinsics::kMemoryAtomicNotify,
             LLVM::Type::getFunctionType(
                 Context.Int32Ty,
-                {Context.Int32Ty, Context.Int32Ty, Context.Int32Ty}, false)),
-        {LLContext.getInt32(MemoryIndex), Offset, Count}));
+                {Context.Int32Ty, Context.Int64Ty, Context.Int32Ty}, false)),
+        {LLContext.getInt32(MemoryIndex), Addr, Count}));
   }
-  void compileAtomicWait(unsigned MemoryIndex, unsigned MemoryOffset,
+  void compileAtomicWait(unsigned MemoryIndex, uint64_t MemoryOffset,
                          LLVM::Type TargetType, uint32_t BitWidth) noexcept {
     auto Timeout = stackPop();
     auto ExpectedValue = Builder.createZExtOrTrunc(stackPop(), Context.Int64Ty);
-    auto Addr = Builder.createZExt(Stack.back(), Context.Int64Ty);
-    if (MemoryOffset != 0) {
-      Addr = Builder.createAdd(Addr, LLContext.getInt64(MemoryOffset));
-    }
+    auto Addr = compileMemoryOffset(MemoryIndex, stackPop(), MemoryOffset,
+                                    BitWidth / 8);
     compileAtomicCheckOffsetAlignment(Addr, TargetType);
-    auto Offset = stackPop();
 
     stackPush(Builder.createCall(
         Context.getIntrinsic(
             Builder, Executable::Intrinsics::kMemoryAtomicWait,
             LLVM::Type::getFunctionType(Context.Int32Ty,
-                                        {Context.Int32Ty, Context.Int32Ty,
+                                        {Context.Int32Ty, Context.Int64Ty,
                                          Context.Int64Ty, Context.Int64Ty,
                                          Context.Int32Ty},
                                         false)),
-        {LLContext.getInt32(MemoryIndex), Offset, ExpectedValue, Timeout,
+        {LLContext.getInt32(MemoryIndex), Addr, ExpectedValue, Timeout,
          LLContext.getInt32(BitWidth)}));
   }
-  void compileAtomicLoad(unsigned MemoryIndex, unsigned MemoryOffset,
+  void compileAtomicLoad(unsigned MemoryIndex, uint64_t MemoryOffset,
                          unsigned Alignment, LLVM::Type IntType,
                          LLVM::Type TargetType, bool Signed = false) noexcept {
 
-    auto Offset = Builder.createZExt(Stack.back(), Context.Int64Ty);
-    if (MemoryOffset != 0) {
-      Offset = Builder.createAdd(Offset, LLContext.getInt64(MemoryOffset));
-    }
+    auto Offset =
+        compileMemoryOffset(MemoryIndex, Stack.back(), MemoryOffset,
+                            TargetType.getPrimitiveSizeInBits() / 8);
     compileAtomicCheckOffsetAlignment(Offset, TargetType);
     auto VPtr = Builder.createInBoundsGEP1(
         Context.Int8Ty, Context.getMemory(Builder, ExecCtx, MemoryIndex),
@@ -3361,7 +3913,7 @@ public:
       Stack.back() = Builder.createZExt(Load, IntType);
     }
   }
-  void compileAtomicStore(unsigned MemoryIndex, unsigned MemoryOffset,
+  void compileAtomicStore(unsigned MemoryIndex, uint64_t MemoryOffset,
                           unsigned Alignment, LLVM::Type, LLVM::Type TargetType,
                           bool Signed = false) noexcept {
     auto V = stackPop();
@@ -3371,10 +3923,9 @@ public:
     } else {
       V = Builder.createZExtOrTrunc(V, TargetType);
     }
-    auto Offset = Builder.createZExt(Stack.back(), Context.Int64Ty);
-    if (MemoryOffset != 0) {
-      Offset = Builder.createAdd(Offset, LLContext.getInt64(MemoryOffset));
-    }
+    auto Offset =
+        compileMemoryOffset(MemoryIndex, Stack.back(), MemoryOffset,
+                            TargetType.getPrimitiveSizeInBits() / 8);
     compileAtomicCheckOffsetAlignment(Offset, TargetType);
     auto VPtr = Builder.createInBoundsGEP1(
         Context.Int8Ty, Context.getMemory(Builder, ExecCtx, MemoryIndex),
@@ -3385,15 +3936,14 @@ public:
     Store.setOrdering(LLVMAtomicOrderingSequentiallyConsistent);
   }
 
-  void compileAtomicRMWOp(unsigned MemoryIndex, unsigned MemoryOffset,
+  void compileAtomicRMWOp(unsigned MemoryIndex, uint64_t MemoryOffset,
                           [[maybe_unused]] unsigned Alignment,
                           LLVMAtomicRMWBinOp BinOp, LLVM::Type IntType,
                           LLVM::Type TargetType, bool Signed = false) noexcept {
     auto Value = Builder.createSExtOrTrunc(stackPop(), TargetType);
-    auto Offset = Builder.createZExt(Stack.back(), Context.Int64Ty);
-    if (MemoryOffset != 0) {
-      Offset = Builder.createAdd(Offset, LLContext.getInt64(MemoryOffset));
-    }
+    auto Offset =
+        compileMemoryOffset(MemoryIndex, Stack.back(), MemoryOffset,
+                            TargetType.getPrimitiveSizeInBits() / 8);
     compileAtomicCheckOffsetAlignment(Offset, TargetType);
     auto VPtr = Builder.createInBoundsGEP1(
         Context.Int8Ty, Context.getMemory(Builder, ExecCtx, MemoryIndex),
@@ -3411,17 +3961,16 @@ public:
       Stack.back() = Builder.createZExt(Ret, IntType);
     }
   }
-  void compileAtomicCompareExchange(unsigned MemoryIndex, unsigned MemoryOffset,
+  void compileAtomicCompareExchange(unsigned MemoryIndex, uint64_t MemoryOffset,
                                     [[maybe_unused]] unsigned Alignment,
                                     LLVM::Type IntType, LLVM::Type TargetType,
                                     bool Signed = false) noexcept {
 
     auto Replacement = Builder.createSExtOrTrunc(stackPop(), TargetType);
     auto Expected = Builder.createSExtOrTrunc(stackPop(), TargetType);
-    auto Offset = Builder.createZExt(Stack.back(), Context.Int64Ty);
-    if (MemoryOffset != 0) {
-      Offset = Builder.createAdd(Offset, LLContext.getInt64(MemoryOffset));
-    }
+    auto Offset =
+        compileMemoryOffset(MemoryIndex, Stack.back(), MemoryOffset,
+                            TargetType.getPrimitiveSizeInBits() / 8);
     compileAtomicCheckOffsetAlignment(Offset, TargetType);
     auto VPtr = Builder.createInBoundsGEP1(
         Context.Int8Ty, Context.getMemory(Builder, ExecCtx, MemoryIndex),
@@ -3474,11 +4023,88 @@ public:
     }
   }
 
+  /// Returns true if the instruction ends a basic block of the batched
+  /// metering, i.e. the control flow may leave the straight-line code after it.
+  static bool isBlockBoundary(OpCode Code) noexcept {
+    switch (Code) {
+    case OpCode::Unreachable:
+    case OpCode::Block:
+    case OpCode::Loop:
+    case OpCode::If:
+    case OpCode::Else:
+    case OpCode::Try:
+    case OpCode::Catch:
+    case OpCode::Throw:
+    case OpCode::Rethrow:
+    case OpCode::Throw_ref:
+    case OpCode::End:
+    case OpCode::Br:
+    case OpCode::Br_if:
+    case OpCode::Br_table:
+    case OpCode::Return:
+    case OpCode::Call:
+    case OpCode::Call_indirect:
+    case OpCode::Return_call:
+    case OpCode::Return_call_indirect:
+    case OpCode::Call_ref:
+    case OpCode::Return_call_ref:
+    case OpCode::Delegate:
+    case OpCode::Catch_all:
+    case OpCode::Try_table:
+    case OpCode::Br_on_null:
+    case OpCode::Br_on_non_null:
+    case OpCode::Br_on_cast:
+    case OpCode::Br_on_cast_fail:
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  /// Add the instruction count and the cost of the basic block starting at
+  /// the front of Instrs to the local counters. The costs are summarized per
+  /// opcode, so each distinct opcode loads the cost table once.
+  void chargeBlock(AST::InstrView Instrs) noexcept {
+    std::map<OpCode, uint64_t> Counts;
+    uint64_t Total = 0;
+    for (const auto &Instr : Instrs) {
+      ++Counts[Instr.getOpCode()];
+      ++Total;
+      if (isBlockBoundary(Instr.getOpCode())) {
+        break;
+      }
+    }
+    if (LocalInstrCount) {
+      Builder.createStore(
+          Builder.createAdd(
+              Builder.createLoad(Context.Int64Ty, LocalInstrCount),
+              LLContext.getInt64(Total)),
+          LocalInstrCount);
+    }
+    if (LocalGas) {
+      auto CostTable = Context.getCostTable(Builder, ExecCtx);
+      auto NewGas = Builder.createLoad(Context.Int64Ty, LocalGas);
+      for (const auto &[Code, Count] : Counts) {
+        LLVM::Value Cost = Builder.createLoad(
+            Context.Int64Ty,
+            Builder.createConstInBoundsGEP2_64(
+                LLVM::Type::getArrayType(Context.Int64Ty, UINT16_MAX + 1),
+                CostTable, 0, uint16_t(Code)));
+        if (Count > 1) {
+          Cost = Builder.createMul(Cost, LLContext.getInt64(Count));
+        }
+        NewGas = Builder.createAdd(NewGas, Cost);
+      }
+      Builder.createStore(NewGas, LocalGas);
+    }
+  }
+
   void updateGas() noexcept {
     if (LocalGas) {
       auto CurrBB = Builder.getInsertBlock();
       auto CheckBB = LLVM::BasicBlock::create(LLContext, F.Fn, "gas_check");
       auto OkBB = LLVM::BasicBlock::create(LLContext, F.Fn, "gas_ok");
+      auto FailBB = LLVM::BasicBlock::create(LLContext, F.Fn, "gas_fail");
       auto EndBB = LLVM::BasicBlock::create(LLContext, F.Fn, "gas_end");
 
       auto Cost = Builder.createLoad(Context.Int64Ty, LocalGas);
@@ -3495,10 +4121,18 @@ public:
       auto NewGas = Builder.createAdd(PHIOldGas, Cost);
       auto IsGasRemain =
           Builder.createLikely(Builder.createICmpULE(NewGas, GasLimit));
-      Builder.createCondBr(IsGasRemain, OkBB,
-                           getTrapBB(ErrCode::Value::CostLimitExceeded));
-      Builder.positionAtEnd(OkBB);
+      Builder.createCondBr(IsGasRemain, OkBB, FailBB);
+
+      // Trap without the shared trap block, which commits the pending cost.
+      Builder.positionAtEnd(FailBB);
+      updateInstrCount();
+      auto CallTrap = Builder.createCall(
+          Context.Trap, {LLContext.getInt32(static_cast<uint32_t>(
+                            ErrCode::Value::CostLimitExceeded))});
+      CallTrap.addCallSiteAttribute(Context.NoReturn);
+      Builder.createUnreachable();
 
+      Builder.positionAtEnd(OkBB);
       auto RGasAndSucceed = Builder.createAtomicCmpXchg(
           GasPtr, PHIOldGas, NewGas, LLVMAtomicOrderingMonotonic,
           LLVMAtomicOrderingMonotonic);
@@ -4037,15 +4671,363 @@ private:
     }
   }
 
-  void compileLoadOp(unsigned MemoryIndex, unsigned Offset, unsigned Alignment,
+  /// Raw data of the value type in the tags of the references, where the
+  /// reserved padding byte is cleared.
+  LLVM::Value getRefTag(const ValType &Type) noexcept {
+    auto Raw = Type.getRawData();
+    Raw[0] = 0;
+    uint64_t Tag;
+    std::memcpy(&Tag, Raw.data(), sizeof(Tag));
+    return LLContext.getInt64(Tag);
+  }
+
+  /// Create the buffer of values in the entry block, which is reused in
+  /// loops.
+  LLVM::Value createValueBuffer(uint32_t Count) noexcept {
+    LLVM::Builder EntryBuilder(LLContext);
+    EntryBuilder.positionBefore(ExecCtx);
+    auto Alloca = EntryBuilder.createArrayAlloca(
+        Context.Int8Ty, LLContext.getInt64(uint64_t(Count) * kValSize));
+    Alloca.setAlignment(kValSize);
+    return Alloca;
+  }
+  void storeValueBuffer(LLVM::Value Buffer, uint32_t Index,
+                        LLVM::Value Val) noexcept {
+    auto Ptr = Builder.createConstInBoundsGEP1_64(Context.Int8Ty, Buffer,
+                                                  uint64_t(Index) * kValSize);
+    Builder.createStore(
+        Val, Builder.createBitCast(Ptr, Val.getType().getPointerTo()));
+  }
+
+  /// LLVM type of the storage type in the struct and array instances.
+  LLVM::Type toStorageType(const ValType &SType) noexcept {
+    switch (SType.getCode()) {
+    case TypeCode::I8:
+      return Context.Int8Ty;
+    case TypeCode::I16:
+      return Context.Int16Ty;
+    default:
+      return toLLVMType(LLContext, SType);
+    }
+  }
+  LLVM::Value compileLoadStorage(LLVM::Value Ptr, const ValType &SType,
+                                 bool IsSigned) noexcept {
+    auto Ty = toStorageType(SType);
+    auto Val = Builder.createLoad(Ty, Builder.createBitCast(Ptr, Ty.getPointerTo()));
+    Val.setAlignment(
+        std::min(Runtime::Instance::GCObject::getStorageSize(SType), 8U));
+    if (SType.isPackType()) {
+      return IsSigned ? Builder.createSExt(Val, Context.Int32Ty)
+                      : Builder.createZExt(Val, Context.Int32Ty);
+    }
+    return Val;
+  }
+  void compileStoreStorage(LLVM::Value Ptr, const ValType &SType,
+                           LLVM::Value Val) noexcept {
+    auto Ty = toStorageType(SType);
+    if (SType.isPackType()) {
+      Val = Builder.createTrunc(Val, Ty);
+    } else {
+      Val = Builder.createBitCast(Val, Ty);
+    }
+    auto Store =
+        Builder.createStore(Val, Builder.createBitCast(Ptr, Ty.getPointerTo()));
+    Store.setAlignment(
+        std::min(Runtime::Instance::GCObject::getStorageSize(SType), 8U));
+  }
+
+  /// Get the address of the object in the reference, which traps on null.
+  LLVM::Value compileGCObjectPtr(LLVM::Value Ref,
+                                 ErrCode::Value Error) noexcept {
+    auto Ptr = Builder.createExtractElement(
+        Builder.createBitCast(Ref, Context.Int64x2Ty), LLContext.getInt64(1));
+    auto Next = LLVM::BasicBlock::create(LLContext, F.Fn, "gc.not_null");
+    Builder.createCondBr(Builder.createLikely(Builder.createICmpNE(
+                             Ptr, LLContext.getInt64(0))),
+                         Next, getTrapBB(Error));
+    Builder.positionAtEnd(Next);
+    return Builder.createIntToPtr(Ptr, Context.Int8PtrTy);
+  }
+
+  /// Record the object before storing the references into it. The collector
+  /// is called only if the object is old and not recorded yet.
+  void compileWriteBarrier(LLVM::Value ObjPtr) noexcept {
+    using Runtime::Instance::GCObject;
+    auto Flags = Builder.createLoad(
+        Context.Int8Ty, Builder.createConstInBoundsGEP1_64(
+                            Context.Int8Ty, ObjPtr, GCObject::kFlagsOffset));
+    Flags.setAlignment(1);
+    Flags.setOrdering(LLVMAtomicOrderingMonotonic);
+    auto NoBarrier = Builder.createICmpNE(
+        Builder.createAnd(Flags, LLContext.getInt8(GCObject::kMarked |
+                                                   GCObject::kRemembered)),
+        LLContext.getInt8(GCObject::kMarked));
+    auto BarrierBB = LLVM::BasicBlock::create(LLContext, F.Fn, "gc.barrier");
+    auto EndBB = LLVM::BasicBlock::create(LLContext, F.Fn, "gc.barrier.end");
+    Builder.createCondBr(Builder.createLikely(NoBarrier), EndBB, BarrierBB);
+    Builder.positionAtEnd(BarrierBB);
+    Builder.createCall(
+        Context.getIntrinsic(Builder, Executable::Intrinsics::kWriteBarrier,
+                             LLVM::Type::getFunctionType(
+                                 Context.VoidTy, {Context.Int8PtrTy}, false)),
+        {ObjPtr});
+    Builder.createBr(EndBB);
+    Builder.positionAtEnd(EndBB);
+  }
+
+  void compileStructNewOp(uint32_t TypeIdx, bool IsDefault) noexcept {
+    const auto &FieldTypes =
+        Context.SubTypes[TypeIdx]->getCompositeType().getFieldTypes();
+    std::vector<LLVM::Value> Vals;
+    if (!IsDefault) {
+      Vals.resize(FieldTypes.size());
+      for (size_t I = 0; I < Vals.size(); ++I) {
+        Vals[Vals.size() - 1 - I] = stackPop();
+      }
+    }
+    // The fields are the default values in the allocated object.
+    auto Ref = Builder.createCall(
+        Context.getIntrinsic(
+            Builder, Executable::Intrinsics::kStructNew,
+            LLVM::Type::getFunctionType(Context.Int64x2Ty, {Context.Int32Ty},
+                                        false)),
+        {LLContext.getInt32(TypeIdx)});
+    if (!IsDefault && !Vals.empty()) {
+      // The new object is not marked, so the write barriers are not needed.
+      auto ObjPtr = Builder.createIntToPtr(
+          Builder.createExtractElement(Ref, LLContext.getInt64(1)),
+          Context.Int8PtrTy);
+      const auto &Offsets = Context.getFieldOffsets(TypeIdx);
+      for (size_t I = 0; I < Vals.size(); ++I) {
+        compileStoreStorage(Builder.createConstInBoundsGEP1_64(
+                                Context.Int8Ty, ObjPtr, Offsets[I]),
+                            FieldTypes[I].getStorageType(), Vals[I]);
+      }
+    }
+    stackPush(Ref);
+  }
+  void compileStructGetOp(uint32_t TypeIdx, uint32_t FieldIdx,
+                          bool IsSigned) noexcept {
+    const auto &FieldType =
+        Context.SubTypes[TypeIdx]->getCompositeType().getFieldTypes()[FieldIdx];
+    auto ObjPtr =
+        compileGCObjectPtr(stackPop(), ErrCode::Value::AccessNullStruct);
+    stackPush(compileLoadStorage(
+        Builder.createConstInBoundsGEP1_64(
+            Context.Int8Ty, ObjPtr, Context.getFieldOffsets(TypeIdx)[FieldIdx]),
+        FieldType.getStorageType(), IsSigned));
+  }
+  void compileStructSetOp(uint32_t TypeIdx, uint32_t FieldIdx) noexcept {
+    const auto &FieldType =
+        Context.SubTypes[TypeIdx]->getCompositeType().getFieldTypes()[FieldIdx];
+    auto Val = stackPop();
+    auto ObjPtr =
+        compileGCObjectPtr(stackPop(), ErrCode::Value::AccessNullStruct);
+    if (FieldType.getStorageType().isRefType()) {
+      compileWriteBarrier(ObjPtr);
+    }
+    compileStoreStorage(
+        Builder.createConstInBoundsGEP1_64(
+            Context.Int8Ty, ObjPtr, Context.getFieldOffsets(TypeIdx)[FieldIdx]),
+        FieldType.getStorageType(), Val);
+  }
+
+  void compileArrayNewOp(uint32_t TypeIdx, LLVM::Value Length,
+                         LLVM::Value InitVals, uint32_t InitCnt) noexcept {
+    stackPush(Builder.createCall(
+        Context.getIntrinsic(
+            Builder, Executable::Intrinsics::kArrayNew,
+            LLVM::Type::getFunctionType(Context.Int64x2Ty,
+                                        {Context.Int32Ty, Context.Int32Ty,
+                                         Context.Int8PtrTy, Context.Int32Ty},
+                                        false)),
+        {LLContext.getInt32(TypeIdx), Length, InitVals,
+         LLContext.getInt32(InitCnt)}));
+  }
+  LLVM::Value compileArrayLength(LLVM::Value ObjPtr) noexcept {
+    using Runtime::Instance::ArrayInstance;
+    auto Length = Builder.createLoad(
+        Context.Int32Ty,
+        Builder.createBitCast(
+            Builder.createConstInBoundsGEP1_64(Context.Int8Ty, ObjPtr,
+                                               ArrayInstance::kLengthOffset),
+            Context.Int32PtrTy));
+    Length.setAlignment(4);
+    return Length;
+  }
+  /// Get the address of the element in the array instance, which traps on
+  /// null or out of bounds.
+  std::pair<LLVM::Value, LLVM::Value>
+  compileArrayElemPtr(LLVM::Value Ref, LLVM::Value Idx,
+                      const ValType &SType) noexcept {
+    using Runtime::Instance::ArrayInstance;
+    auto ObjPtr = compileGCObjectPtr(Ref, ErrCode::Value::AccessNullArray);
+    auto Next = LLVM::BasicBlock::create(LLContext, F.Fn, "array.in_bounds");
+    Builder.createCondBr(Builder.createLikely(Builder.createICmpULT(
+                             Idx, compileArrayLength(ObjPtr))),
+                         Next, getTrapBB(ErrCode::Value::ArrayOutOfBounds));
+    Builder.positionAtEnd(Next);
+    auto Offset = Builder.createAdd(
+        Builder.createMul(
+            Builder.createZExt(Idx, Context.Int64Ty),
+            LLContext.getInt64(
+                Runtime::Instance::GCObject::getStorageSize(SType))),
+        LLContext.getInt64(ArrayInstance::getDataOffset()));
+    return {ObjPtr,
+            Builder.createInBoundsGEP1(Context.Int8Ty, ObjPtr, Offset)};
+  }
+  void compileArrayGetOp(uint32_t TypeIdx, bool IsSigned) noexcept {
+    const auto &SType = Context.SubTypes[TypeIdx]
+                            ->getCompositeType()
+                            .getFieldTypes()[0]
+                            .getStorageType();
+    auto Idx = stackPop();
+    auto Ref = stackPop();
+    auto ElemPtr = compileArrayElemPtr(Ref, Idx, SType).second;
+    stackPush(compileLoadStorage(ElemPtr, SType, IsSigned));
+  }
+  void compileArraySetOp(uint32_t TypeIdx) noexcept {
+    const auto &SType = Context.SubTypes[TypeIdx]
+                            ->getCompositeType()
+                            .getFieldTypes()[0]
+                            .getStorageType();
+    auto Val = stackPop();
+    auto Idx = stackPop();
+    auto Ref = stackPop();
+    auto [ObjPtr, ElemPtr] = compileArrayElemPtr(Ref, Idx, SType);
+    if (SType.isRefType()) {
+      compileWriteBarrier(ObjPtr);
+    }
+    compileStoreStorage(ElemPtr, SType, Val);
+  }
+
+  /// Test the reference with the type. The casts of the objects in this
+  /// module to the defined types are checked with the type depth tables, and
+  /// the others call the type matcher.
+  LLVM::Value compileRefTest(LLVM::Value Ref, const ValType &Type) noexcept {
+    Ref = Builder.createBitCast(Ref, Context.Int64x2Ty);
+    auto Tag = Builder.createExtractElement(Ref, LLContext.getInt64(0));
+    auto Ptr = Builder.createExtractElement(Ref, LLContext.getInt64(1));
+    auto NotNullBB = LLVM::BasicBlock::create(LLContext, F.Fn, "ref_test.ref");
+    auto EndBB = LLVM::BasicBlock::create(LLContext, F.Fn, "ref_test.end");
+    std::vector<LLVM::Value> Results;
+    std::vector<LLVM::BasicBlock> Blocks;
+
+    // The null references match the nullable types.
+    Results.push_back(Type.isNullableRefType() ? LLContext.getTrue()
+                                               : LLContext.getFalse());
+    Blocks.push_back(Builder.getInsertBlock());
+    Builder.createCondBr(Builder.createICmpEQ(Ptr, LLContext.getInt64(0)),
+                         EndBB, NotNullBB);
+    Builder.positionAtEnd(NotNullBB);
+
+    bool NeedSlowPath = true;
+    if (Type.isAbsHeapType()) {
+      switch (Type.getHeapTypeCode()) {
+      case TypeCode::AnyRef:
+      case TypeCode::FuncRef:
+      case TypeCode::ExternRef:
+        // The references are validated in the hierarchies of the top types.
+        Results.push_back(LLContext.getTrue());
+        Blocks.push_back(Builder.getInsertBlock());
+        Builder.createBr(EndBB);
+        NeedSlowPath = false;
+        break;
+      case TypeCode::NullRef:
+      case TypeCode::NullFuncRef:
+      case TypeCode::NullExternRef:
+        Results.push_back(LLContext.getFalse());
+        Blocks.push_back(Builder.getInsertBlock());
+        Builder.createBr(EndBB);
+        NeedSlowPath = false;
+        break;
+      default:
+        break;
+      }
+    } else if (const auto *Display =
+                   Context.getTypeDisplay(Type.getTypeIndex())) {
+      auto SlowBB = LLVM::BasicBlock::create(LLContext, F.Fn, "ref_test.slow");
+      auto ObjBB = LLVM::BasicBlock::create(LLContext, F.Fn, "ref_test.obj");
+      auto FastBB = LLVM::BasicBlock::create(LLContext, F.Fn, "ref_test.fast");
+      // The references of the defined types are neither externalized nor
+      // typed with the abstract heap types.
+      Builder.createCondBr(
+          Builder.createICmpEQ(
+              Builder.createAnd(Tag, LLContext.getInt64(kDefTypeTagMask)),
+              LLContext.getInt64(0)),
+          ObjBB, SlowBB);
+      Builder.positionAtEnd(ObjBB);
+      auto ObjModule = Builder.createLoad(
+          Context.Int8PtrTy,
+          Builder.createIntToPtr(Ptr, Context.Int8PtrTy.getPointerTo()));
+      ObjModule.setAlignment(8);
+      Builder.createCondBr(
+          Builder.createLikely(Builder.createICmpEQ(
+              ObjModule, Context.getModule(Builder, ExecCtx))),
+          FastBB, SlowBB);
+
+      Builder.positionAtEnd(FastBB);
+      const uint32_t Depth = Display->Depth[Type.getTypeIndex()];
+      auto LoadTable = [this](LLVM::Value Table, LLVM::Value Idx) {
+        auto Ptr = Builder.createInBoundsGEP1(
+            Context.Int32Ty,
+            Builder.createBitCast(Table, Context.Int32PtrTy), Idx);
+        auto Val = Builder.createLoad(Context.Int32Ty, Ptr);
+        Val.setAlignment(4);
+        return Val;
+      };
+      auto TypeIdx = Builder.createLShr(Tag, LLContext.getInt64(32));
+      auto IsDeep = Builder.createICmpUGE(
+          LoadTable(Display->DepthTable, TypeIdx), LLContext.getInt32(Depth));
+      // Load the root entry for the shallower types, which is in bounds.
+      auto Offset = Builder.createZExt(
+          LoadTable(Display->OffsetTable, TypeIdx), Context.Int64Ty);
+      auto Entry = LoadTable(
+          Display->DisplayTable,
+          Builder.createAdd(Offset,
+                            Builder.createSelect(IsDeep,
+                                                 LLContext.getInt64(Depth),
+                                                 LLContext.getInt64(0))));
+      Results.push_back(Builder.createAnd(
+          IsDeep,
+          Builder.createICmpEQ(
+              Entry, LLContext.getInt32(
+                         Display->Canonical[Type.getTypeIndex()]))));
+      Blocks.push_back(Builder.getInsertBlock());
+      Builder.createBr(EndBB);
+      Builder.positionAtEnd(SlowBB);
+    }
+
+    if (NeedSlowPath) {
+      auto Res = Builder.createCall(
+          Context.getIntrinsic(
+              Builder, Executable::Intrinsics::kRefTest,
+              LLVM::Type::getFunctionType(
+                  Context.Int32Ty,
+                  {Context.Int64x2Ty, Context.Int32Ty, Context.Int32Ty},
+                  false)),
+          {Ref,
+           LLContext.getInt32(static_cast<uint8_t>(Type.getHeapTypeCode())),
+           LLContext.getInt32(Type.isAbsHeapType() ? 0U
+                                                   : Type.getTypeIndex())});
+      Results.push_back(Builder.createICmpNE(Res, LLContext.getInt32(0)));
+      Blocks.push_back(Builder.getInsertBlock());
+      Builder.createBr(EndBB);
+    }
+
+    Builder.positionAtEnd(EndBB);
+    auto PHI = Builder.createPHI(LLContext.getInt1Ty());
+    PHI.addIncoming(Results, Blocks);
+    return PHI;
+  }
+
+  void compileLoadOp(unsigned MemoryIndex, uint64_t Offset, unsigned Alignment,
                      LLVM::Type LoadTy) noexcept {
     if constexpr (kForceUnalignment) {
       Alignment = 0;
     }
-    auto Off = Builder.createZExt(stackPop(), Context.Int64Ty);
-    if (Offset != 0) {
-      Off = Builder.createAdd(Off, LLContext.getInt64(Offset));
-    }
+    auto Off = compileMemoryOffset(MemoryIndex, stackPop(), Offset,
+                                   LoadTy.getPrimitiveSizeInBits() / 8);
 
     auto VPtr = Builder.createInBoundsGEP1(
         Context.Int8Ty, Context.getMemory(Builder, ExecCtx, MemoryIndex), Off);
@@ -4054,7 +5036,7 @@ private:
     LoadInst.setAlignment(1 << Alignment);
     stackPush(LoadInst);
   }
-  void compileLoadOp(unsigned MemoryIndex, unsigned Offset, unsigned Alignment,
+  void compileLoadOp(unsigned MemoryIndex, uint64_t Offset, unsigned Alignment,
                      LLVM::Type LoadTy, LLVM::Type ExtendTy,
                      bool Signed) noexcept {
     compileLoadOp(MemoryIndex, Offset, Alignment, LoadTy);
@@ -4064,24 +5046,24 @@ private:
       Stack.back() = Builder.createZExt(Stack.back(), ExtendTy);
     }
   }
-  void compileVectorLoadOp(unsigned MemoryIndex, unsigned Offset,
+  void compileVectorLoadOp(unsigned MemoryIndex, uint64_t Offset,
                            unsigned Alignment, LLVM::Type LoadTy) noexcept {
     compileLoadOp(MemoryIndex, Offset, Alignment, LoadTy);
     Stack.back() = Builder.createBitCast(Stack.back(), Context.Int64x2Ty);
   }
-  void compileVectorLoadOp(unsigned MemoryIndex, unsigned Offset,
+  void compileVectorLoadOp(unsigned MemoryIndex, uint64_t Offset,
                            unsigned Alignment, LLVM::Type LoadTy,
                            LLVM::Type ExtendTy, bool Signed) noexcept {
     compileLoadOp(MemoryIndex, Offset, Alignment, LoadTy, ExtendTy, Signed);
     Stack.back() = Builder.createBitCast(Stack.back(), Context.Int64x2Ty);
   }
-  void compileSplatLoadOp(unsigned MemoryIndex, unsigned Offset,
+  void compileSplatLoadOp(unsigned MemoryIndex, uint64_t Offset,
                           unsigned Alignment, LLVM::Type LoadTy,
                           LLVM::Type VectorTy) noexcept {
     compileLoadOp(MemoryIndex, Offset, Alignment, LoadTy);
     compileSplatOp(VectorTy);
   }
-  void compileLoadLaneOp(unsigned MemoryIndex, unsigned Offset,
+  void compileLoadLaneOp(unsigned MemoryIndex, uint64_t Offset,
                          unsigned Alignment, unsigned Index, LLVM::Type LoadTy,
                          LLVM::Type VectorTy) noexcept {
     auto Vector = stackPop();
@@ -4092,7 +5074,7 @@ private:
                                     Value, LLContext.getInt64(Index)),
         Context.Int64x2Ty);
   }
-  void compileStoreLaneOp(unsigned MemoryIndex, unsigned Offset,
+  void compileStoreLaneOp(unsigned MemoryIndex, uint64_t Offset,
                           unsigned Alignment, unsigned Index, LLVM::Type LoadTy,
                           LLVM::Type VectorTy) noexcept {
     auto Vector = Stack.back();
@@ -4100,17 +5082,15 @@ private:
         Builder.createBitCast(Vector, VectorTy), LLContext.getInt64(Index));
     compileStoreOp(MemoryIndex, Offset, Alignment, LoadTy);
   }
-  void compileStoreOp(unsigned MemoryIndex, unsigned Offset, unsigned Alignment,
+  void compileStoreOp(unsigned MemoryIndex, uint64_t Offset, unsigned Alignment,
                       LLVM::Type LoadTy, bool Trunc = false,
                       bool BitCast = false) noexcept {
     if constexpr (kForceUnalignment) {
       Alignment = 0;
     }
     auto V = stackPop();
-    auto Off = Builder.createZExt(stackPop(), Context.Int64Ty);
-    if (Offset != 0) {
-      Off = Builder.createAdd(Off, LLContext.getInt64(Offset));
-    }
+    auto Off = compileMemoryOffset(MemoryIndex, stackPop(), Offset,
+                                   LoadTy.getPrimitiveSizeInBits() / 8);
 
     if (Trunc) {
       V = Builder.createTrunc(V, LoadTy);
@@ -4889,6 +5869,31 @@ private:
     Builder.positionAtEnd(NotStopBB);
   }
 
+  /// Stop at the function entries and the loop headers for the collection
+  /// requested by another thread, so the loops without calls do not block it.
+  void checkSafepoint() noexcept {
+    auto Requested = Builder.createLoad(
+        Context.Int8Ty, Context.getGCRequested(Builder, ExecCtx));
+    Requested.setOrdering(LLVMAtomicOrderingMonotonic);
+    Requested.setAlignment(1);
+    auto SafepointBB =
+        LLVM::BasicBlock::create(LLContext, F.Fn, "gc.safepoint");
+    auto EndBB =
+        LLVM::BasicBlock::create(LLContext, F.Fn, "gc.safepoint.end");
+    Builder.createCondBr(
+        Builder.createLikely(
+            Builder.createICmpEQ(Requested, LLContext.getInt8(0))),
+        EndBB, SafepointBB);
+    Builder.positionAtEnd(SafepointBB);
+    Builder.createCall(
+        Context.getIntrinsic(
+            Builder, Executable::Intrinsics::kSafepoint,
+            LLVM::Type::getFunctionType(Context.VoidTy, {}, false)),
+        {});
+    Builder.createBr(EndBB);
+    Builder.positionAtEnd(EndBB);
+  }
+
   void setUnreachable() noexcept {
     if (ControlStack.empty()) {
       IsUnreachable = true;
@@ -4983,10 +5988,12 @@ private:
   std::vector<std::pair<LLVM::Type, LLVM::Value>> Local;
   std::vector<LLVM::Value> Stack;
   LLVM::Value LocalInstrCount = nullptr;
+  std::vector<LLVM::Value> MemorySizes;
   LLVM::Value LocalGas = nullptr;
   std::unordered_map<ErrCode::Value, LLVM::BasicBlock> TrapBB;
   bool IsUnreachable = false;
   bool Interruptible = false;
+  bool BatchedMetering = false;
   struct Control {
     size_t StackSize;
     bool Unreachable;
@@ -5033,6 +6040,15 @@ namespace WasmEdge {
 namespace LLVM {
 
 Expect<Data> Compiler::compile(const AST::Module &Module) noexcept {
+  return compile(Module, true);
+}
+
+Expect<Data> Compiler::translate(const AST::Module &Module) noexcept {
+  return compile(Module, false);
+}
+
+Expect<Data> Compiler::compile(const AST::Module &Module,
+                               bool Optimize) noexcept {
   // Check the module is validated.
   if (unlikely(!Module.getIsValidated())) {
     spdlog::error(ErrCode::Value::NotValidated);
@@ -5109,45 +6125,18 @@ Expect<Data> Compiler::compile(const AST::Module &Module) noexcept {
           LLVMRelocPIC, LLVMCodeModelDefault);
     }
 
-#if LLVM_VERSION_MAJOR >= 13
-    auto PBO = LLVM::PassBuilderOptions::create();
-    if (auto Error = PBO.runPasses(
-            LLModule,
-            toLLVMLevel(Conf.getCompilerConfigure().getOptimizationLevel()),
-            TM)) {
-      spdlog::error("{}"sv, Error.message().string_view());
-    }
-#else
-    auto FP = LLVM::PassManager::createForModule(LLModule);
-    auto MP = LLVM::PassManager::create();
-
-    TM.addAnalysisPasses(MP);
-    TM.addAnalysisPasses(FP);
-    {
-      auto PMB = LLVM::PassManagerBuilder::create();
-      auto [OptLevel, SizeLevel] =
-          toLLVMLevel(Conf.getCompilerConfigure().getOptimizationLevel());
-      PMB.setOptLevel(OptLevel);
-      PMB.setSizeLevel(SizeLevel);
-      PMB.populateFunctionPassManager(FP);
-      PMB.populateModulePassManager(MP);
-    }
-    switch (Conf.getCompilerConfigure().getOptimizationLevel()) {
-    case CompilerConfigure::OptimizationLevel::O0:
-    case CompilerConfigure::OptimizationLevel::O1:
-      FP.addTailCallEliminationPass();
-      break;
-    default:
-      break;
-    }
-
-    FP.initializeFunctionPassManager();
-    for (auto Fn = LLModule.getFirstFunction(); Fn; Fn = Fn.getNextFunction()) {
-      FP.runFunctionPassManager(Fn);
+    if (Optimize) {
+      if (const uint32_t Threads = Conf.getCompilerConfigure().getThreads();
+          Threads > 1) {
+        if (auto Res =
+                optimizeParallel(Conf, LLContext, LLModule, TM, Threads);
+            !Res) {
+          return Unexpect(Res);
+        }
+      } else {
+        LLVM::optimize(Conf, LLModule, TM);
+      }
     }
-    FP.finalizeFunctionPassManager();
-    MP.runPassManager(LLModule);
-#endif
   }
 
   // Set initializer for constant value
@@ -5168,6 +6157,39 @@ Expect<Data> Compiler::compile(const AST::Module &Module) noexcept {
   return Expect<Data>{std::move(D)};
 }
 
+std::string Compiler::fingerprint() const noexcept {
+  // Collect everything changing the generated code: the binary version, the
+  // target, the proposals, and the compiler and statistics options.
+  std::string Result;
+  Result += std::to_string(AOT::kBinaryVersion);
+  Result += ';';
+  Result += LLVM::getDefaultTargetTriple().string_view();
+  Result += ';';
+#if defined(__riscv) && __riscv_xlen == 64
+  Result += "generic-rv64"sv;
+#else
+  if (!Conf.getCompilerConfigure().isGenericBinary()) {
+    Result += LLVM::getHostCPUName().string_view();
+  } else {
+    Result += "generic"sv;
+  }
+#endif
+  Result += ';';
+  Result += LLVM::getHostCPUFeatures().string_view();
+  Result += ';';
+  for (uint8_t I = 0; I < static_cast<uint8_t>(Proposal::Max); ++I) {
+    Result += Conf.hasProposal(static_cast<Proposal>(I)) ? '1' : '0';
+  }
+  Result += ';';
+  Result += std::to_string(
+      static_cast<uint32_t>(Conf.getCompilerConfigure().getOptimizationLevel()));
+  Result += Conf.getCompilerConfigure().isInterruptible() ? '1' : '0';
+  Result += Conf.getStatisticsConfigure().isInstructionCounting() ? '1' : '0';
+  Result += Conf.getStatisticsConfigure().isCostMeasuring() ? '1' : '0';
+  Result += Conf.getStatisticsConfigure().isBatchedMetering() ? '1' : '0';
+  return Result;
+}
+
 void Compiler::compile(const AST::TypeSection &TypeSec) noexcept {
   auto WrapperTy =
       LLVM::Type::getFunctionType(Context->VoidTy,
@@ -5181,6 +6203,13 @@ void Compiler::compile(const AST::TypeSection &TypeSec) noexcept {
   }
   Context->FunctionTypes.reserve(Size);
   Context->FunctionWrappers.reserve(Size);
+  Context->SubTypes.reserve(Size);
+  for (const auto &SubType : SubTypes) {
+    Context->SubTypes.push_back(&SubType);
+  }
+  // The struct and array types have no wrappers. Their symbols are exported
+  // with an empty placeholder for looking up the symbols of all types.
+  LLVM::Value Placeholder;
 
   // Iterate and compile types.
   for (size_t I = 0; I < Size; ++I) {
@@ -5285,6 +6314,27 @@ void Compiler::compile(const AST::TypeSection &TypeSec) noexcept {
       Context->FunctionTypes.push_back(&FuncType);
       Context->FunctionWrappers.push_back(F);
     } else {
+      const auto Name = fmt::format("t{}"sv, Context->FunctionTypes.size());
+      if (!Placeholder) {
+        Placeholder = Context->LLModule.addFunction(
+            WrapperTy, LLVMExternalLinkage, Name.c_str());
+        Placeholder.setVisibility(LLVMProtectedVisibility);
+        Placeholder.setDSOLocal(true);
+        Placeholder.setDLLStorageClass(LLVMDLLExportStorageClass);
+        Placeholder.addFnAttr(Context->NoStackArgProbe);
+        Placeholder.addFnAttr(Context->UWTable);
+        LLVM::Builder Builder(Context->LLContext);
+        Builder.positionAtEnd(
+            LLVM::BasicBlock::create(Context->LLContext, Placeholder, "entry"));
+        Builder.createRetVoid();
+      } else {
+        auto A =
+            Context->LLModule.addAlias(WrapperTy, Placeholder, Name.c_str());
+        A.setLinkage(LLVMExternalLinkage);
+        A.setVisibility(LLVMProtectedVisibility);
+        A.setDSOLocal(true);
+        A.setDLLStorageClass(LLVMDLLExportStorageClass);
+      }
       Context->FunctionTypes.push_back(nullptr);
       Context->FunctionWrappers.push_back(LLVM::Value());
     }
@@ -5357,6 +6407,76 @@ void Compiler::compile(const AST::ImportSection &ImportSec) noexcept {
             Arg, Builder.createBitCast(Ptr, Arg.getType().getPointerTo()));
       }
 
+      // Call the native entry of the bound host function directly. Call
+      // through the executor if not bound, or to handle the stop token.
+      auto ExecCtxPtr = F.Fn.getFirstParam();
+      auto DirectBB =
+          LLVM::BasicBlock::create(Context->LLContext, F.Fn, "call.direct");
+      auto CheckBB =
+          LLVM::BasicBlock::create(Context->LLContext, F.Fn, "call.check");
+      auto TrapBB = LLVM::BasicBlock::create(Context->LLContext, F.Fn, "trap");
+      auto ProxyBB =
+          LLVM::BasicBlock::create(Context->LLContext, F.Fn, "call.proxy");
+      auto RetBB = LLVM::BasicBlock::create(Context->LLContext, F.Fn, "ret");
+      auto HostFuncs = Builder.createLoad(
+          Context->Int8PtrTy.getPointerTo(),
+          Builder.createInBoundsGEP2(Context->ExecCtxTy, ExecCtxPtr,
+                                     Context->LLContext.getInt64(0),
+                                     Context->LLContext.getInt32(9)));
+      Builder.createCondBr(Builder.createIsNull(HostFuncs), ProxyBB, CheckBB);
+
+      Builder.positionAtEnd(CheckBB);
+      auto Entry = Builder.createLoad(
+          Context->Int8PtrTy, Builder.createConstInBoundsGEP1_64(
+                                  Context->Int8PtrTy, HostFuncs, FuncID * 2));
+      auto Host = Builder.createLoad(
+          Context->Int8PtrTy,
+          Builder.createConstInBoundsGEP1_64(Context->Int8PtrTy, HostFuncs,
+                                             FuncID * 2 + 1));
+      auto StopToken = Builder.createLoad(
+          Context->Int32Ty,
+          Builder.createLoad(
+              Context->Int32PtrTy,
+              Builder.createInBoundsGEP2(Context->ExecCtxTy, ExecCtxPtr,
+                                         Context->LLContext.getInt64(0),
+                                         Context->LLContext.getInt32(6))));
+      StopToken.setOrdering(LLVMAtomicOrderingMonotonic);
+#if LLVM_VERSION_MAJOR >= 13
+      StopToken.setAlignment(32);
+#endif
+      Builder.createCondBr(
+          Builder.createLikely(Builder.createAnd(
+              Builder.createIsNotNull(Entry),
+              Builder.createICmpEQ(StopToken,
+                                   Context->LLContext.getInt32(0)))),
+          DirectBB, ProxyBB);
+
+      Builder.positionAtEnd(DirectBB);
+      auto EntryTy = LLVM::Type::getFunctionType(
+          Context->Int32Ty,
+          {Context->Int8PtrTy, Context->Int8PtrTy, Context->Int8PtrTy,
+           Context->Int8PtrTy},
+          false);
+      auto HostFrame = Builder.createBitCast(
+          Builder.createInBoundsGEP2(Context->ExecCtxTy, ExecCtxPtr,
+                                     Context->LLContext.getInt64(0),
+                                     Context->LLContext.getInt32(10)),
+          Context->Int8PtrTy);
+      auto Code = Builder.createCall(
+          LLVM::FunctionCallee{
+              EntryTy,
+              Builder.createBitCast(Entry, EntryTy.getPointerTo())},
+          {Host, HostFrame, Args, Rets});
+      Builder.createCondBr(
+          Builder.createLikely(
+              Builder.createICmpEQ(Code, Context->LLContext.getInt32(0))),
+          RetBB, TrapBB);
+
+      Builder.positionAtEnd(TrapBB);
+      Builder.createCall(Context->Trap, {Code});
+      Builder.createUnreachable();
+
+      Builder.positionAtEnd(ProxyBB);
       Builder.createCall(
           Context->getIntrinsic(
               Builder, Executable::Intrinsics::kCall,
@@ -5365,7 +6485,9 @@ void Compiler::compile(const AST::ImportSection &ImportSec) noexcept {
                   {Context->Int32Ty, Context->Int8PtrTy, Context->Int8PtrTy},
                   false)),
           {Context->LLContext.getInt32(FuncID), Args, Rets});
+      Builder.createBr(RetBB);
 
+      Builder.positionAtEnd(RetBB);
       if (RetSize == 0) {
         Builder.createRetVoid();
       } else if (RetSize == 1) {
@@ -5396,7 +6518,7 @@ void Compiler::compile(const AST::ImportSection &ImportSec) noexcept {
     }
     case ExternalType::Memory: // Memory type
     {
-      // Nothing to do.
+      Context->Memories.push_back(ImpDesc.getExternalMemoryType());
       break;
     }
     case ExternalType::Global: // Global type
@@ -5424,8 +6546,12 @@ void Compiler::compile(const AST::GlobalSection &GlobalSec) noexcept {
   }
 }
 
-void Compiler::compile(const AST::MemorySection &,
-                       const AST::DataSection &) noexcept {}
+void Compiler::compile(const AST::MemorySection &MemorySec,
+                       const AST::DataSection &) noexcept {
+  for (const auto &MemType : MemorySec.getContent()) {
+    Context->Memories.push_back(MemType);
+  }
+}
 
 void Compiler::compile(const AST::TableSection &,
                        const AST::ElementSection &) noexcept {}
@@ -5474,7 +6600,8 @@ void Compiler::compile(const AST::FunctionSection &FuncSec,
     FunctionCompiler FC(*Context, F, Locals,
                         Conf.getCompilerConfigure().isInterruptible(),
                         Conf.getStatisticsConfigure().isInstructionCounting(),
-                        Conf.getStatisticsConfigure().isCostMeasuring());
+                        Conf.getStatisticsConfigure().isCostMeasuring(),
+                        Conf.getStatisticsConfigure().isBatchedMetering());
     auto Type = Context->resolveBlockType(T);
     FC.compile(*Code, std::move(Type));
     F.Fn.eliminateUnreachableBlocks();
@@ -6,14 +6,31 @@
 
 #include "data.h"
 #include "llvm.h"
+#include "optimizer.h"
+#include "parallel.h"
+
+#include <llvm/ExecutionEngine/Orc/CompileUtils.h>
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
 
 namespace LLVM = WasmEdge::LLVM;
 using namespace std::literals;
 
 namespace WasmEdge::LLVM {
 
-JITLibrary::JITLibrary(OrcLLJIT JIT) noexcept
-    : J(std::make_unique<OrcLLJIT>(std::move(JIT)).release()) {}
+struct JITLibrary::CompiledFunctions {
+  std::mutex Mutex;
+  std::unordered_set<std::string> Names;
+};
+
+JITLibrary::JITLibrary(OrcLLJIT JIT,
+                       std::shared_ptr<CompiledFunctions> Compiled) noexcept
+    : J(std::make_unique<OrcLLJIT>(std::move(JIT)).release()),
+      Compiled(std::move(Compiled)) {}
 
 JITLibrary::~JITLibrary() noexcept {
   std::unique_ptr<OrcLLJIT> JIT(std::exchange(J, nullptr));
@@ -63,6 +80,44 @@ std::vector<Symbol<void>> JITLibrary::getCodes(size_t Offset,
   return Result;
 }
 
+Symbol<void> JITLibrary::getCompiledCode(size_t Index) noexcept {
+  // The lookup of the stub emits the module into the implementation dylib of
+  // the compile-on-demand layer at the first time.
+  auto Codes = getCodes(Index, 1);
+  if (!Compiled || !Codes[0]) {
+    return std::move(Codes[0]);
+  }
+
+  // Look up the function body in the implementation dylib, which compiles
+  // the partition of the function only.
+  auto &LLJIT = *reinterpret_cast<llvm::orc::LLJIT *>(J->unwrap());
+  auto &ES = LLJIT.getExecutionSession();
+  auto *ImplD =
+      ES.getJITDylibByName(LLJIT.getMainJITDylib().getName() + ".impl");
+  if (!ImplD) {
+    return std::move(Codes[0]);
+  }
+  const std::string Name = fmt::format("f{}"sv, Index);
+  if (auto Symbol = ES.lookup({ImplD}, LLJIT.mangleAndIntern(Name))) {
+#if LLVM_VERSION_MAJOR >= 17
+    return createSymbol<void>(Symbol->getAddress().toPtr<void *>());
+#else
+    return createSymbol<void>(reinterpret_cast<void *>(Symbol->getAddress()));
+#endif
+  } else {
+    spdlog::error("{}"sv, llvm::toString(Symbol.takeError()));
+    return {};
+  }
+}
+
+bool JITLibrary::isCompiled(std::string_view Name) const noexcept {
+  if (!Compiled) {
+    return true;
+  }
+  std::unique_lock Lock(Compiled->Mutex);
+  return Compiled->Names.count(std::string(Name)) > 0;
+}
+
 Expect<std::shared_ptr<Executable>> JIT::load(Data D) noexcept {
   spdlog::info("jit load start");
 
@@ -94,4 +149,97 @@ Expect<std::shared_ptr<Executable>> JIT::load(Data D) noexcept {
 
   return std::make_shared<JITLibrary>(std::move(J));
 }
+
+Expect<std::shared_ptr<Executable>> JIT::loadLazy(Data D) noexcept {
+  spdlog::info("lazy jit load start");
+
+  auto &LLModule = D.extract().LLModule;
+  auto &TM = D.extract().TM;
+
+  llvm::orc::LLLazyJITBuilder Builder;
+  // The partitions are cloned into their own contexts, and may be compiled on
+  // the calling threads of the stubs concurrently. Create a target machine
+  // for each compilation instead of sharing one.
+  Builder.setCompileFunctionCreator(
+      [](llvm::orc::JITTargetMachineBuilder JTMB)
+          -> llvm::Expected<
+              std::unique_ptr<llvm::orc::IRCompileLayer::IRCompiler>> {
+        return std::make_unique<llvm::orc::ConcurrentIRCompiler>(
+            std::move(JTMB));
+      });
+#if WASMEDGE_OS_WINDOWS
+  Builder.setObjectLinkingLayerCreator(
+      [](llvm::orc::ExecutionSession &ES, const llvm::Triple &) {
+        auto Layer = std::make_unique<llvm::orc::RTDyldObjectLinkingLayer>(
+            ES, []() { return std::make_unique<Win64EHManager>(); });
+        Layer->setOverrideObjectFlagsWithResponsibilityFlags(true);
+        Layer->setAutoClaimResponsibilityForObjectSymbols(true);
+        return std::unique_ptr<llvm::orc::ObjectLayer>(std::move(Layer));
+      });
+#endif
+  auto LazyJIT = Builder.create();
+  if (!LazyJIT) {
+    // The lazy compilation stubs are not supported on every target. Fall
+    // back to compile the whole module.
+    spdlog::warn("lazy jit unsupported: {}, load the whole module instead."sv,
+                 llvm::toString(LazyJIT.takeError()));
+    optimize(Conf, LLModule, TM);
+    return load(std::move(D));
+  }
+
+  if (Conf.getCompilerConfigure().isDumpIR()) {
+    if (auto ErrorMessage = LLModule.printModuleToFile("wasm-jit.ll")) {
+      spdlog::error("printModuleToFile failed");
+    }
+  }
+
+  // The compile-on-demand layer splits out the requested function into its
+  // own module, and the partitions are optimized here before emitted. The
+  // partitions may be materialized on different threads, so each of them
+  // uses its own target machine.
+  auto SharedTM = std::make_shared<TargetMachine>(std::move(TM));
+  auto Compiled = std::make_shared<JITLibrary::CompiledFunctions>();
+  (*LazyJIT)->getIRTransformLayer().setTransform(
+      [Conf = Conf, SharedTM,
+       Compiled](llvm::orc::ThreadSafeModule TSM,
+                 llvm::orc::MaterializationResponsibility &)
+          -> llvm::Expected<llvm::orc::ThreadSafeModule> {
+        TSM.withModuleDo([&](llvm::Module &M) {
+          {
+            std::unique_lock Lock(Compiled->Mutex);
+            for (const auto &F : M) {
+              if (!F.isDeclaration()) {
+                Compiled->Names.emplace(F.getName().str());
+              }
+            }
+          }
+          Module Part(llvm::wrap(&M));
+          auto PartTM = cloneTargetMachine(*SharedTM);
+          optimize(Conf, Part, PartTM);
+          // Not owned.
+          Part.release();
+        });
+        return TSM;
+      });
+
+  // The C API handles are the plain pointers of the C++ objects.
+  const auto &TSContext = *reinterpret_cast<llvm::orc::ThreadSafeContext *>(
+      D.extract().TSContext.unwrap());
+  llvm::orc::ThreadSafeModule TSM(
+      std::unique_ptr<llvm::Module>(llvm::unwrap(LLModule.release())),
+      TSContext);
+  if (auto Err = (*LazyJIT)->addLazyIRModule(std::move(TSM))) {
+    spdlog::error("{}"sv, llvm::toString(std::move(Err)));
+    return Unexpect(ErrCode::Value::HostFuncError);
+  }
+
+  // The lookups return the lazy compilation stubs of the functions, which
+  // compile them at the first calls.
+  OrcLLJIT J(reinterpret_cast<LLVMOrcLLJITRef>(
+      static_cast<llvm::orc::LLJIT *>(LazyJIT->release())));
+
+  spdlog::info("lazy jit load end");
+
+  return std::make_shared<JITLibrary>(std::move(J), std::move(Compiled));
+}
 } // namespace WasmEdge::LLVM
@@ -745,6 +745,13 @@ public:
         [&C](const uint64_t Element) { return C.getInt64(Element).unwrap(); });
     return LLVMConstVector(Data.data(), static_cast<unsigned int>(Data.size()));
   }
+  static Value getConstArray(Type ElementTy,
+                             Span<const Value> ConstantVals) noexcept {
+    const auto Data = const_cast<LLVMValueRef *>(
+        reinterpret_cast<const LLVMValueRef *>(ConstantVals.data()));
+    const auto Size = static_cast<unsigned int>(ConstantVals.size());
+    return LLVMConstArray(ElementTy.unwrap(), Data, Size);
+  }
 
 #define DECLARE_VALUE_CHECK(name)                                              \
   bool isA##name() const noexcept { return LLVMIsA##name(Ref) != nullptr; }
@@ -1106,6 +1113,9 @@ public:
   void positionAtEnd(BasicBlock B) noexcept {
     LLVMPositionBuilderAtEnd(Ref, B.unwrap());
   }
+  void positionBefore(Value Instr) noexcept {
+    LLVMPositionBuilderBefore(Ref, Instr.unwrap());
+  }
   BasicBlock getInsertBlock() noexcept { return LLVMGetInsertBlock(Ref); }
 
   Value createRetVoid() noexcept { return LLVMBuildRetVoid(Ref); }
@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "optimizer.h"
+
+#include "common/spdlog.h"
+
+#include <utility>
+
+using namespace std::literals;
+
+namespace {
+
+// Translate Compiler::OptimizationLevel to llvm::PassBuilder version
+#if LLVM_VERSION_MAJOR >= 13
+const char *
+toLLVMLevel(WasmEdge::CompilerConfigure::OptimizationLevel Level) noexcept {
+  using OL = WasmEdge::CompilerConfigure::OptimizationLevel;
+  switch (Level) {
+  case OL::O0:
+    return "default<O0>,function(tailcallelim)";
+  case OL::O1:
+    return "default<O1>,function(tailcallelim)";
+  case OL::O2:
+    return "default<O2>";
+  case OL::O3:
+    return "default<O3>";
+  case OL::Os:
+    return "default<Os>";
+  case OL::Oz:
+    return "default<Oz>";
+  default:
+    assumingUnreachable();
+  }
+}
+#else
+std::pair<unsigned int, unsigned int>
+toLLVMLevel(WasmEdge::CompilerConfigure::OptimizationLevel Level) noexcept {
+  using OL = WasmEdge::CompilerConfigure::OptimizationLevel;
+  switch (Level) {
+  case OL::O0:
+    return {0, 0};
+  case OL::O1:
+    return {1, 0};
+  case OL::O2:
+    return {2, 0};
+  case OL::O3:
+    return {3, 0};
+  case OL::Os:
+    return {2, 1};
+  case OL::Oz:
+    return {2, 2};
+  default:
+    assumingUnreachable();
+  }
+}
+#endif
+
+} // namespace
+
+namespace WasmEdge::LLVM {
+
+void optimize(const Configure &Conf, Module &LLModule,
+              TargetMachine &TM) noexcept {
+#if LLVM_VERSION_MAJOR >= 13
+  auto PBO = PassBuilderOptions::create();
+  if (auto Error = PBO.runPasses(
+          LLModule,
+          toLLVMLevel(Conf.getCompilerConfigure().getOptimizationLevel()),
+          TM)) {
+    spdlog::error("{}"sv, Error.message().string_view());
+  }
+#else
+  auto FP = PassManager::createForModule(LLModule);
+  auto MP = PassManager::create();
+
+  TM.addAnalysisPasses(MP);
+  TM.addAnalysisPasses(FP);
+  {
+    auto PMB = PassManagerBuilder::create();
+    auto [OptLevel, SizeLevel] =
+        toLLVMLevel(Conf.getCompilerConfigure().getOptimizationLevel());
+    PMB.setOptLevel(OptLevel);
+    PMB.setSizeLevel(SizeLevel);
+    PMB.populateFunctionPassManager(FP);
+    PMB.populateModulePassManager(MP);
+  }
+  switch (Conf.getCompilerConfigure().getOptimizationLevel()) {
+  case CompilerConfigure::OptimizationLevel::O0:
+  case CompilerConfigure::OptimizationLevel::O1:
+    FP.addTailCallEliminationPass();
+    break;
+  default:
+    break;
+  }
+
+  FP.initializeFunctionPassManager();
+  for (auto Fn = LLModule.getFirstFunction(); Fn; Fn = Fn.getNextFunction()) {
+    FP.runFunctionPassManager(Fn);
+  }
+  FP.finalizeFunctionPassManager();
+  MP.runPassManager(LLModule);
+#endif
+}
+
+} // namespace WasmEdge::LLVM
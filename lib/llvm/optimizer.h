@@ -0,0 +1,14 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+#pragma once
+
+#include "common/configure.h"
+#include "llvm.h"
+
+namespace WasmEdge::LLVM {
+
+/// Run the optimization passes of the configured level on the module.
+void optimize(const Configure &Conf, Module &LLModule,
+              TargetMachine &TM) noexcept;
+
+} // namespace WasmEdge::LLVM
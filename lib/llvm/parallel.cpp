@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "parallel.h"
+
+#include <llvm-c/BitReader.h>
+#include <llvm-c/BitWriter.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/CBindingWrapping.h>
+#include <llvm/Target/TargetMachine.h>
+#include <llvm/Transforms/Utils/SplitModule.h>
+
+#include <memory>
+#include <string>
+
+namespace llvm {
+DEFINE_SIMPLE_CONVERSION_FUNCTIONS(TargetMachine, LLVMTargetMachineRef)
+} // namespace llvm
+
+namespace WasmEdge::LLVM {
+
+std::vector<MemoryBuffer> splitModule(Module &LLModule,
+                                      uint32_t Count) noexcept {
+  std::vector<MemoryBuffer> Parts;
+  Parts.reserve(Count);
+  llvm::SplitModule(
+      *llvm::unwrap(LLModule.unwrap()), Count,
+      [&Parts](std::unique_ptr<llvm::Module> Part) {
+        Parts.emplace_back(
+            LLVMWriteBitcodeToMemoryBuffer(llvm::wrap(Part.get())));
+      });
+  return Parts;
+}
+
+Module parseBitcode(Context LLContext, const MemoryBuffer &Buffer) noexcept {
+  LLVMModuleRef Result = nullptr;
+  if (LLVMParseBitcodeInContext2(LLContext.unwrap(), Buffer.unwrap(),
+                                 &Result)) {
+    return {};
+  }
+  return Result;
+}
+
+MemoryBuffer writeBitcode(Module &LLModule) noexcept {
+  return LLVMWriteBitcodeToMemoryBuffer(LLModule.unwrap());
+}
+
+TargetMachine cloneTargetMachine(TargetMachine &TM) noexcept {
+  // The C API has no getter of the optimization level. The enumerations are
+  // the same in both APIs.
+  const auto Level = static_cast<LLVMCodeGenOptLevel>(
+      llvm::unwrap(TM.unwrap())->getOptLevel());
+  Message Triple = LLVMGetTargetMachineTriple(TM.unwrap());
+  Message CPU = LLVMGetTargetMachineCPU(TM.unwrap());
+  Message Features = LLVMGetTargetMachineFeatureString(TM.unwrap());
+  return LLVMCreateTargetMachine(LLVMGetTargetMachineTarget(TM.unwrap()),
+                                 Triple.unwrap(), CPU.unwrap(),
+                                 Features.unwrap(), Level, LLVMRelocPIC,
+                                 LLVMCodeModelDefault);
+}
+
+void prefixLocalSymbols(Module &LLModule, std::string_view Prefix) noexcept {
+  auto Rename = [Prefix](Value GV) {
+    const auto Linkage = GV.getLinkage();
+    if (Linkage != LLVMInternalLinkage && Linkage != LLVMPrivateLinkage) {
+      return;
+    }
+    std::string Name(Prefix);
+    Name += GV.getName();
+    LLVMSetValueName2(GV.unwrap(), Name.data(), Name.size());
+  };
+  for (auto Fn = LLModule.getFirstFunction(); Fn; Fn = Fn.getNextFunction()) {
+    Rename(Fn);
+  }
+  for (auto GV = LLModule.getFirstGlobal(); GV; GV = GV.getNextGlobal()) {
+    Rename(GV);
+  }
+}
+
+} // namespace WasmEdge::LLVM
@@ -0,0 +1,33 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+#pragma once
+
+#include "common/parallel.h"
+#include "llvm.h"
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace WasmEdge::LLVM {
+
+/// Split the module into Count linkable partitions in bitcode. The local
+/// symbols of the module are externalized with the hidden visibility.
+std::vector<MemoryBuffer> splitModule(Module &LLModule,
+                                      uint32_t Count) noexcept;
+
+/// Parse the bitcode into a module in the context. Returns an empty module if
+/// failed.
+Module parseBitcode(Context LLContext, const MemoryBuffer &Buffer) noexcept;
+
+/// Serialize the module into bitcode.
+MemoryBuffer writeBitcode(Module &LLModule) noexcept;
+
+/// Create a target machine with the same target and options as TM, for the
+/// use in another thread.
+TargetMachine cloneTargetMachine(TargetMachine &TM) noexcept;
+
+/// Rename the local symbols in the module with Prefix.
+void prefixLocalSymbols(Module &LLModule, std::string_view Prefix) noexcept;
+
+} // namespace WasmEdge::LLVM
@@ -33,7 +33,8 @@ inline constexpr uint64_t roundUpPageBoundary(const uint64_t Value) {
 
 namespace WasmEdge::Loader {
 
-Expect<void> AOTSection::load(const AST::AOTSection &AOTSec) noexcept {
+Expect<void> AOTSection::load(const AST::AOTSection &AOTSec,
+                              const MMap *File) noexcept {
   BinarySize = 0;
   for (const auto &Section : AOTSec.getSections()) {
     const auto Offset = std::get<1>(Section);
@@ -49,15 +50,46 @@ Expect<void> AOTSection::load(const AST::AOTSection &AOTSec) noexcept {
   }
 
   std::vector<std::pair<uint8_t *, uint64_t>> ExecutableRanges;
-  for (const auto &Section : AOTSec.getSections()) {
+  const auto &Sections = AOTSec.getSections();
+  const auto &FileRanges = AOTSec.getFileRanges();
+  for (size_t I = 0; I < Sections.size(); ++I) {
+    const auto &Section = Sections[I];
     const auto Offset = std::get<1>(Section);
     const auto Size = std::get<2>(Section);
     const auto &Content = std::get<3>(Section);
+    const auto [FileOffset, FileSize] =
+        I < FileRanges.size() ? FileRanges[I]
+                              : std::pair<uint64_t, uint64_t>(0, 0);
     if (Size > BinarySize || Offset > BinarySize ||
-        Offset + Size > BinarySize || Content.size() > Size) {
+        Offset + Size > BinarySize || Content.size() > Size ||
+        FileSize > Size) {
+      return Unexpect(ErrCode::Value::IntegerTooLarge);
+    }
+    if (FileSize == 0) {
+      std::copy(Content.begin(), Content.end(), Binary + Offset);
+    } else if (unlikely(File == nullptr)) {
+      return Unexpect(ErrCode::Value::IllegalPath);
+    } else if (unlikely(FileOffset > File->size() ||
+                        FileSize > File->size() - FileOffset)) {
+      // The content left in the file must be in the file.
       return Unexpect(ErrCode::Value::IntegerTooLarge);
+    } else {
+      // Map the whole pages of the content, and copy the partial pages at
+      // both ends. Copy all if failed to map.
+      const auto *Source =
+          reinterpret_cast<const uint8_t *>(File->address()) + FileOffset;
+      const uint64_t PageSize = MMap::pageSize();
+      const uint64_t Begin = (Offset + PageSize - 1) / PageSize * PageSize;
+      const uint64_t End = (Offset + FileSize) / PageSize * PageSize;
+      if (Begin < End &&
+          File->mapPrivate(Binary + Begin, FileOffset + (Begin - Offset),
+                           End - Begin, std::get<0>(Section) == 1)) {
+        std::copy(Source, Source + (Begin - Offset), Binary + Offset);
+        std::copy(Source + (End - Offset), Source + FileSize, Binary + End);
+      } else {
+        std::copy(Source, Source + FileSize, Binary + Offset);
+      }
     }
-    std::copy(Content.begin(), Content.end(), Binary + Offset);
     switch (std::get<0>(Section)) {
     case 1: { // Text
       const auto O = roundDownPageBoundary(Offset);
@@ -3,6 +3,7 @@
 
 #include "loader/loader.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <utility>
 #include <vector>
@@ -133,10 +134,16 @@ Expect<OpCode> Loader::loadOpCode() {
 }
 
 // Load instruction sequence. See "include/loader/loader.h".
-Expect<AST::InstrVec> Loader::loadInstrSeq(std::optional<uint64_t> SizeBound) {
+Expect<AST::Expression>
+Loader::loadInstrSeq(std::optional<uint64_t> SizeBound) {
   OpCode Code;
-  AST::InstrVec Instrs;
+  AST::Expression Expr;
+  AST::InstrVec &Instrs = Expr.getInstrs();
   std::vector<std::pair<OpCode, uint32_t>> BlockStack;
+  // LEGACY-EH: remove this after deprecating legacy EH.
+  // The catch clauses of the legacy try blocks, moved into the side buffer at
+  // the end of the blocks.
+  std::vector<std::vector<AST::Instruction::CatchDescriptor>> LegacyCatches;
   uint32_t Cnt = 0;
   bool IsReachEnd = false;
   // Read opcode until the End code of the top block.
@@ -176,6 +183,9 @@ Expect<AST::InstrVec> Loader::loadInstrSeq(std::optional<uint64_t> SizeBound) {
     case OpCode::Try:
     case OpCode::Try_table:
       BlockStack.emplace_back(Code, Cnt);
+      if (Code == OpCode::Try) {
+        LegacyCatches.emplace_back();
+      }
       break;
     case OpCode::Else: {
       if (BlockStack.size() == 0 || BlockStack.back().first != OpCode::If) {
@@ -197,8 +207,7 @@ Expect<AST::InstrVec> Loader::loadInstrSeq(std::optional<uint64_t> SizeBound) {
         // A Catch/Catch_all instruction appeared outside a try-block.
         return logIllegalOpCode();
       }
-      auto Pos = BlockStack.back().second;
-      auto &CatchClause = Instrs[Pos].getTryCatch().Catch;
+      const auto &CatchClause = LegacyCatches.back();
       if (CatchClause.size() > 0 && CatchClause.back().IsAll) {
         // A Catch shouldn't behind a Catch_all in the same block.
         // And also a try block may contain only one Catch_all instruction.
@@ -212,7 +221,8 @@ Expect<AST::InstrVec> Loader::loadInstrSeq(std::optional<uint64_t> SizeBound) {
 
     // Create the instruction node and load contents.
     Instrs.emplace_back(Code, static_cast<uint32_t>(Offset));
-    if (auto Res = loadInstruction(Instrs.back()); !Res) {
+    if (auto Res = loadInstruction(Instrs.back(), Expr.getImmediates());
+        !Res) {
       return Unexpect(Res);
     }
 
@@ -246,6 +256,16 @@ Expect<AST::InstrVec> Loader::loadInstrSeq(std::optional<uint64_t> SizeBound) {
           Instrs.back().setTryBlockLast(false);
           Instrs.back().setLegacyTryBlockLast(true);
           Instrs[Pos].getTryCatch().JumpEnd = Cnt - Pos;
+          const auto &CatchClause = LegacyCatches.back();
+          if (!CatchClause.empty()) {
+            const uint32_t Size = static_cast<uint32_t>(CatchClause.size());
+            auto *Catch = Expr.getImmediates()
+                              .allocate<AST::Instruction::CatchDescriptor>(Size);
+            std::copy(CatchClause.begin(), CatchClause.end(), Catch);
+            Instrs[Pos].getTryCatch().Catch =
+                Span<AST::Instruction::CatchDescriptor>(Catch, Size);
+          }
+          LegacyCatches.pop_back();
         }
         BlockStack.pop_back();
       } else {
@@ -255,7 +275,7 @@ Expect<AST::InstrVec> Loader::loadInstrSeq(std::optional<uint64_t> SizeBound) {
     } else if (Code == OpCode::Catch || Code == OpCode::Catch_all) {
       // LEGACY-EH: remove these cases after deprecating legacy EH.
       uint32_t Pos = BlockStack.back().second;
-      auto &CatchClause = Instrs[Pos].getTryCatch().Catch;
+      auto &CatchClause = LegacyCatches.back();
       auto &CatchDesc = Instrs.back().getCatchLegacy();
       CatchDesc.CatchPCOffset = Cnt - Pos;
       CatchDesc.CatchIndex = static_cast<uint32_t>(CatchClause.size());
@@ -280,11 +300,12 @@ Expect<AST::InstrVec> Loader::loadInstrSeq(std::optional<uint64_t> SizeBound) {
                           ASTNodeAttr::Instruction);
     }
   }
-  return Instrs;
+  return Expr;
 }
 
 // Load instruction node. See "include/loader/loader.h".
-Expect<void> Loader::loadInstruction(AST::Instruction &Instr) {
+Expect<void> Loader::loadInstruction(AST::Instruction &Instr,
+                                     AST::ImmediateBuffer &Buffer) {
   // Node: The instruction has checked for the proposals. Need to check their
   // immediates.
 
@@ -310,18 +331,30 @@ Expect<void> Loader::loadInstruction(AST::Instruction &Instr) {
 
   auto readMemImmediate = [this, readU32, &Instr]() -> Expect<void> {
     Instr.getTargetIndex() = 0;
-    if (auto Res = readU32(Instr.getMemoryAlign()); unlikely(!Res)) {
+    uint32_t Align = 0;
+    if (auto Res = readU32(Align); unlikely(!Res)) {
       return Unexpect(Res);
     }
-    if (Conf.hasProposal(Proposal::MultiMemories) &&
-        Instr.getMemoryAlign() >= 64) {
-      Instr.getMemoryAlign() -= 64;
+    if (Conf.hasProposal(Proposal::MultiMemories) && Align >= 64) {
+      Align -= 64;
       if (auto Res = readU32(Instr.getTargetIndex()); unlikely(!Res)) {
         return Unexpect(Res);
       }
     }
-    if (auto Res = readU32(Instr.getMemoryOffset()); unlikely(!Res)) {
-      return Unexpect(Res);
+    Instr.getMemoryAlign() = Align;
+    if (Conf.hasProposal(Proposal::Memory64)) {
+      if (auto Res = FMgr.readU64()) {
+        Instr.getMemoryOffset() = *Res;
+      } else {
+        return logLoadError(Res.error(), FMgr.getLastOffset(),
+                            ASTNodeAttr::Instruction);
+      }
+    } else {
+      uint32_t Offset = 0;
+      if (auto Res = readU32(Offset); unlikely(!Res)) {
+        return Unexpect(Res);
+      }
+      Instr.getMemoryOffset() = Offset;
     }
     return {};
   };
@@ -393,7 +426,7 @@ Expect<void> Loader::loadInstruction(AST::Instruction &Instr) {
     return readBlockType(Instr.getBlockType());
 
   case OpCode::Try_table: {
-    Instr.setTryCatch();
+    Instr.setTryCatch(Buffer);
     // Read the result type.
     if (auto Res = readBlockType(Instr.getTryCatch().ResType); !Res) {
       return Unexpect(Res);
@@ -406,7 +439,8 @@ Expect<void> Loader::loadInstruction(AST::Instruction &Instr) {
       return logLoadError(Res.error(), FMgr.getLastOffset(),
                           ASTNodeAttr::Instruction);
     }
-    Instr.getTryCatch().Catch.resize(VecCnt);
+    Instr.getTryCatch().Catch = Span<AST::Instruction::CatchDescriptor>(
+        Buffer.allocate<AST::Instruction::CatchDescriptor>(VecCnt), VecCnt);
     for (uint32_t I = 0; I < VecCnt; ++I) {
       auto &Desc = Instr.getTryCatch().Catch[I];
       // Read the catch flag.
@@ -435,7 +469,7 @@ Expect<void> Loader::loadInstruction(AST::Instruction &Instr) {
 
   // LEGACY-EH: remove the `Try` case after deprecating legacy EH.
   case OpCode::Try:
-    Instr.setTryCatch();
+    Instr.setTryCatch(Buffer);
     return readBlockType(Instr.getTryCatch().ResType);
 
   // LEGACY-EH: remove the `Catch` case after deprecating legacy EH.
@@ -472,7 +506,7 @@ Expect<void> Loader::loadInstruction(AST::Instruction &Instr) {
       return logLoadError(Res.error(), FMgr.getLastOffset(),
                           ASTNodeAttr::Instruction);
     }
-    Instr.setLabelListSize(VecCnt + 1);
+    Instr.setLabelListSize(VecCnt + 1, Buffer);
     for (uint32_t I = 0; I < VecCnt; ++I) {
       if (auto Res = readU32(Instr.getLabelList()[I].TargetIndex);
           unlikely(!Res)) {
@@ -573,7 +607,7 @@ Expect<void> Loader::loadInstruction(AST::Instruction &Instr) {
                           ASTNodeAttr::Instruction);
     }
     // Read the heap types.
-    Instr.setBrCast(LabelIdx);
+    Instr.setBrCast(LabelIdx, Buffer);
     if (auto Res =
             loadHeapType(((Flag & 0x01U) ? TypeCode::RefNull : TypeCode::Ref),
                          ASTNodeAttr::Instruction)) {
@@ -613,7 +647,7 @@ Expect<void> Loader::loadInstruction(AST::Instruction &Instr) {
       return logLoadError(Res.error(), FMgr.getLastOffset(),
                           ASTNodeAttr::Instruction);
     }
-    Instr.setValTypeListSize(VecCnt);
+    Instr.setValTypeListSize(VecCnt, Buffer);
     for (uint32_t I = 0; I < VecCnt; ++I) {
       if (auto Res = loadValType(ASTNodeAttr::Instruction)) {
         Instr.getValTypeList()[I] = *Res;
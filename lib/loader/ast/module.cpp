@@ -42,134 +42,154 @@ Expect<void> Loader::loadModuleInBound(AST::Module &Mod,
       }
     }
 
-    // Sections except the custom section should be unique.
-    if (NewSectionId > 0x00U && NewSectionId < 0x0DU &&
-        Secs.test(NewSectionId)) {
-      return logLoadError(ErrCode::Value::JunkSection, FMgr.getLastOffset(),
-                          ASTNodeAttr::Module);
-    }
-
-    switch (NewSectionId) {
-    case 0x00:
-      Mod.getCustomSections().emplace_back();
-      if (auto Res = loadSection(Mod.getCustomSections().back()); !Res) {
-        spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
-        return Unexpect(Res);
-      }
-      break;
-    case 0x01:
-      if (auto Res = loadSection(Mod.getTypeSection()); !Res) {
-        spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
-        return Unexpect(Res);
-      }
-      Secs.set(NewSectionId);
-      break;
-    case 0x02:
-      if (auto Res = loadSection(Mod.getImportSection()); !Res) {
-        spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
-        return Unexpect(Res);
-      }
-      Secs.set(NewSectionId);
-      break;
-    case 0x03:
-      if (auto Res = loadSection(Mod.getFunctionSection()); !Res) {
-        spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
-        return Unexpect(Res);
-      }
-      Secs.set(NewSectionId);
-      break;
-    case 0x04:
-      if (auto Res = loadSection(Mod.getTableSection()); !Res) {
-        spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
-        return Unexpect(Res);
-      }
-      Secs.set(NewSectionId);
-      break;
-    case 0x05:
-      if (auto Res = loadSection(Mod.getMemorySection()); !Res) {
-        spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
-        return Unexpect(Res);
-      }
-      Secs.set(NewSectionId);
-      break;
-    case 0x06:
-      if (auto Res = loadSection(Mod.getGlobalSection()); !Res) {
-        spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
-        return Unexpect(Res);
-      }
-      Secs.set(NewSectionId);
-      break;
-    case 0x07:
-      if (auto Res = loadSection(Mod.getExportSection()); !Res) {
-        spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
-        return Unexpect(Res);
-      }
-      Secs.set(NewSectionId);
-      break;
-    case 0x08:
-      if (auto Res = loadSection(Mod.getStartSection()); !Res) {
-        spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
-        return Unexpect(Res);
-      }
-      Secs.set(NewSectionId);
-      break;
-    case 0x09:
-      if (auto Res = loadSection(Mod.getElementSection()); !Res) {
-        spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
-        return Unexpect(Res);
-      }
-      Secs.set(NewSectionId);
-      break;
-    case 0x0A:
-      if (auto Res = loadSection(Mod.getCodeSection()); !Res) {
-        spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
-        return Unexpect(Res);
-      }
-      Secs.set(NewSectionId);
-      break;
-    case 0x0B:
-      if (auto Res = loadSection(Mod.getDataSection()); !Res) {
-        spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
-        return Unexpect(Res);
-      }
-      Secs.set(NewSectionId);
-      break;
-    case 0x0C:
-      // This section is for BulkMemoryOperations or ReferenceTypes proposal.
-      if (!Conf.hasProposal(Proposal::BulkMemoryOperations) &&
-          !Conf.hasProposal(Proposal::ReferenceTypes)) {
-        return logNeedProposal(ErrCode::Value::MalformedSection,
-                               Proposal::BulkMemoryOperations,
-                               FMgr.getLastOffset(), ASTNodeAttr::Module);
-      }
-      if (auto Res = loadSection(Mod.getDataCountSection()); !Res) {
-        spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
-        return Unexpect(Res);
-      }
-      HasDataSection = true;
-      Secs.set(NewSectionId);
-      break;
-    case 0x0D:
-      // This section is for ExceptionHandling proposal.
-      if (!Conf.hasProposal(Proposal::ExceptionHandling)) {
-        return logNeedProposal(ErrCode::Value::MalformedSection,
-                               Proposal::ExceptionHandling,
-                               FMgr.getLastOffset(), ASTNodeAttr::Module);
-      }
-      if (auto Res = loadSection(Mod.getTagSection()); !Res) {
-        spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
-        return Unexpect(Res);
-      }
-      Secs.set(NewSectionId);
-      break;
-    default:
-      return logLoadError(ErrCode::Value::MalformedSection,
-                          FMgr.getLastOffset(), ASTNodeAttr::Module);
+    if (auto Res = loadModuleSection(Mod, NewSectionId, Secs); !Res) {
+      return Unexpect(Res);
     }
 
     Offset = FMgr.getOffset();
   }
 
+  return checkModule(Mod);
+}
+
+// Load the section after the section ID. See "include/loader/loader.h".
+Expect<void> Loader::loadModuleSection(AST::Module &Mod, uint8_t NewSectionId,
+                                       std::bitset<0x0EU> &Secs) {
+  // Sections except the custom section should be unique.
+  if (NewSectionId > 0x00U && NewSectionId < 0x0DU &&
+      Secs.test(NewSectionId)) {
+    return logLoadError(ErrCode::Value::JunkSection, FMgr.getLastOffset(),
+                        ASTNodeAttr::Module);
+  }
+
+  switch (NewSectionId) {
+  case 0x00:
+    Mod.getCustomSections().emplace_back();
+    if (auto Res = loadSection(Mod.getCustomSections().back()); !Res) {
+      spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+      return Unexpect(Res);
+    }
+    if (WASMType == InputType::UniversalWASM &&
+        Mod.getCustomSections().back().getName() == "wasmedge") {
+      // The loaded AOT section is not kept in the module.
+      Mod.getCustomSections().pop_back();
+    }
+    break;
+  case 0x01:
+    if (auto Res = loadSection(Mod.getTypeSection()); !Res) {
+      spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+      return Unexpect(Res);
+    }
+    Secs.set(NewSectionId);
+    break;
+  case 0x02:
+    if (auto Res = loadSection(Mod.getImportSection()); !Res) {
+      spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+      return Unexpect(Res);
+    }
+    Secs.set(NewSectionId);
+    break;
+  case 0x03:
+    if (auto Res = loadSection(Mod.getFunctionSection()); !Res) {
+      spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+      return Unexpect(Res);
+    }
+    Secs.set(NewSectionId);
+    break;
+  case 0x04:
+    if (auto Res = loadSection(Mod.getTableSection()); !Res) {
+      spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+      return Unexpect(Res);
+    }
+    Secs.set(NewSectionId);
+    break;
+  case 0x05:
+    if (auto Res = loadSection(Mod.getMemorySection()); !Res) {
+      spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+      return Unexpect(Res);
+    }
+    Secs.set(NewSectionId);
+    break;
+  case 0x06:
+    if (auto Res = loadSection(Mod.getGlobalSection()); !Res) {
+      spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+      return Unexpect(Res);
+    }
+    Secs.set(NewSectionId);
+    break;
+  case 0x07:
+    if (auto Res = loadSection(Mod.getExportSection()); !Res) {
+      spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+      return Unexpect(Res);
+    }
+    Secs.set(NewSectionId);
+    break;
+  case 0x08:
+    if (auto Res = loadSection(Mod.getStartSection()); !Res) {
+      spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+      return Unexpect(Res);
+    }
+    Secs.set(NewSectionId);
+    break;
+  case 0x09:
+    if (auto Res = loadSection(Mod.getElementSection()); !Res) {
+      spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+      return Unexpect(Res);
+    }
+    Secs.set(NewSectionId);
+    break;
+  case 0x0A:
+    if (auto Res = loadSection(Mod.getCodeSection()); !Res) {
+      spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+      return Unexpect(Res);
+    }
+    Secs.set(NewSectionId);
+    break;
+  case 0x0B:
+    if (auto Res = loadSection(Mod.getDataSection()); !Res) {
+      spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+      return Unexpect(Res);
+    }
+    Secs.set(NewSectionId);
+    break;
+  case 0x0C:
+    // This section is for BulkMemoryOperations or ReferenceTypes proposal.
+    if (!Conf.hasProposal(Proposal::BulkMemoryOperations) &&
+        !Conf.hasProposal(Proposal::ReferenceTypes)) {
+      return logNeedProposal(ErrCode::Value::MalformedSection,
+                             Proposal::BulkMemoryOperations,
+                             FMgr.getLastOffset(), ASTNodeAttr::Module);
+    }
+    if (auto Res = loadSection(Mod.getDataCountSection()); !Res) {
+      spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+      return Unexpect(Res);
+    }
+    HasDataSection = true;
+    Secs.set(NewSectionId);
+    break;
+  case 0x0D:
+    // This section is for ExceptionHandling proposal.
+    if (!Conf.hasProposal(Proposal::ExceptionHandling)) {
+      return logNeedProposal(ErrCode::Value::MalformedSection,
+                             Proposal::ExceptionHandling,
+                             FMgr.getLastOffset(), ASTNodeAttr::Module);
+    }
+    if (auto Res = loadSection(Mod.getTagSection()); !Res) {
+      spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+      return Unexpect(Res);
+    }
+    Secs.set(NewSectionId);
+    break;
+  default:
+    return logLoadError(ErrCode::Value::MalformedSection,
+                        FMgr.getLastOffset(), ASTNodeAttr::Module);
+  }
+
+  return {};
+}
+
+// Check the loaded sections of the module. See "include/loader/loader.h".
+Expect<void> Loader::checkModule(AST::Module &Mod) {
   setTagFunctionType(Mod.getTagSection(), Mod.getImportSection(),
                      Mod.getTypeSection());
 
@@ -204,15 +224,6 @@ Expect<void> Loader::loadExecutable(AST::Module &Mod,
                                     std::shared_ptr<Executable> Exec) {
   spdlog::info("load executable start");
   auto &SubTypes = Mod.getTypeSection().getContent();
-  for (auto &SubType : SubTypes) {
-    if (unlikely(!SubType.getCompositeType().isFunc())) {
-      // TODO: GC - AOT: implement other composite types.
-      spdlog::error(ErrCode::Value::MalformedSection);
-      spdlog::error("    Currently AOT not support GC proposal yet.");
-      spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
-      return Unexpect(ErrCode::Value::MalformedSection);
-    }
-  }
 
   size_t Offset = 0;
   for (const auto &ImpDesc : Mod.getImportSection().getContent()) {
@@ -246,8 +257,12 @@ Expect<void> Loader::loadExecutable(AST::Module &Mod,
 
   // Set the symbols into the module.
   for (size_t I = 0; I < SubTypes.size(); ++I) {
-    SubTypes[I].getCompositeType().getFuncType().setSymbol(
-        std::move(FuncTypeSymbols[I]));
+    // Only the function types have the wrappers. The symbols of the struct and
+    // array types are placeholders.
+    if (SubTypes[I].getCompositeType().isFunc()) {
+      SubTypes[I].getCompositeType().getFuncType().setSymbol(
+          std::move(FuncTypeSymbols[I]));
+    }
   }
   for (size_t I = 0; I < CodeSegs.size(); ++I) {
     CodeSegs[I].setSymbol(std::move(CodeSymbols[I]));
@@ -268,7 +283,8 @@ Expect<void> Loader::loadExecutable(AST::Module &Mod,
 Expect<void> Loader::loadUniversalWASM(AST::Module &Mod) {
   if (!Conf.getRuntimeConfigure().isForceInterpreter()) {
     auto Exec = std::make_shared<AOTSection>();
-    if (auto Res = Exec->load(Mod.getAOTSection()); unlikely(!Res)) {
+    if (auto Res = Exec->load(Mod.getAOTSection(), FMgr.getFileMap());
+        unlikely(!Res)) {
       spdlog::error("    AOT section -- library load failed:{} , use "
                     "interpreter mode instead.",
                     Res.error());
@@ -333,20 +349,22 @@ Expect<void> Loader::loadModuleAOT(AST::AOTSection &AOTSection) {
       }
 
       if (Name == "wasmedge") {
-        // Found the AOT section in universal WASM. Load the AOT code.
-        // Read the content.
-        std::vector<uint8_t> Content;
-        if (auto Res = FMgr.readBytes(ContentSize - ReadSize)) {
-          Content = std::move(*Res);
-        } else {
-          break;
-        }
+        // Found the AOT section in universal WASM. Load the AOT code from the
+        // content in place. The contents of the sections are copied or left
+        // in the file if the input is a mapped file.
+        const uint64_t ContentOffset = FMgr.getOffset();
+        const uint64_t Size = ContentSize - ReadSize;
+        FMgr.seek(ContentOffset + Size);
 
         // Load the AOT section.
         FileMgr VecMgr;
         AST::AOTSection NewAOTSection;
-        VecMgr.setCode(Content);
-        if (auto Res = loadSection(VecMgr, NewAOTSection)) {
+        VecMgr.setCode(FMgr.getCode().subspan(ContentOffset, Size));
+        std::optional<uint64_t> FileOffset;
+        if (FMgr.getFileMap() != nullptr) {
+          FileOffset = ContentOffset;
+        }
+        if (auto Res = loadSection(VecMgr, NewAOTSection, FileOffset)) {
           // Also handle the duplicated AOT sections case.
           // If the new AOT section discovered, use the new one.
           WASMType = InputType::UniversalWASM;
@@ -5,9 +5,14 @@
 
 #include "aot/version.h"
 #include "common/defines.h"
+#include "common/parallel.h"
+
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 namespace WasmEdge {
 namespace Loader {
@@ -29,6 +34,11 @@ Expect<void> Loader::loadSection(AST::CustomSection &Sec) {
       return logLoadError(ErrCode::Value::UnexpectedEnd, FMgr.getLastOffset(),
                           ASTNodeAttr::Sec_Custom);
     }
+    if (WASMType == InputType::UniversalWASM && Sec.getName() == "wasmedge") {
+      // The AOT section is already loaded. Not to copy the code.
+      FMgr.seek(StartOffset + Sec.getContentSize());
+      return {};
+    }
     if (auto Res = FMgr.readBytes(Sec.getContentSize() - ReadSize)) {
       Sec.getContent().insert(Sec.getContent().end(), (*Res).begin(),
                               (*Res).end());
@@ -180,12 +190,122 @@ Expect<void> Loader::loadSection(AST::ElementSection &Sec) {
 // Load vector of code section. See "include/loader/loader.h".
 Expect<void> Loader::loadSection(AST::CodeSection &Sec) {
   return loadSectionContent(Sec, [this, &Sec]() {
+    if (isLazyLoading()) {
+      // Keep the bytes of the section, and the function bodies are decoded at
+      // their first calls.
+      const auto Code = FMgr.getCode().subspan(FMgr.getOffset(),
+                                               Sec.getContentSize());
+      LazyCodeSec = std::make_shared<const LazyCode>(
+          LazyCode{Conf, {Code.begin(), Code.end()}, HasDataSection});
+      LazyCodeOffset = FMgr.getOffset();
+      auto Res =
+          loadSectionContentVec(Sec, [this](AST::CodeSegment &CodeSeg) {
+            return loadSegment(CodeSeg);
+          });
+      LazyCodeSec.reset();
+      return Res;
+    }
+    // The function bodies are skipped in the AOT mode, so only the loading of
+    // the bodies is parallelized.
+    const uint32_t Threads = Conf.getRuntimeConfigure().getLoadThreads();
+    if (Threads > 1 && (Conf.getRuntimeConfigure().isForceInterpreter() ||
+                        WASMType == InputType::WASM)) {
+      return loadSectionParallel(Sec, Threads);
+    }
     return loadSectionContentVec(Sec, [this](AST::CodeSegment &CodeSeg) {
       return loadSegment(CodeSeg);
     });
   });
 }
 
+// Load vector of code section in parallel. See "include/loader/loader.h".
+Expect<void> Loader::loadSectionParallel(AST::CodeSection &Sec,
+                                         uint32_t Threads) {
+  const uint64_t StartOffset = FMgr.getOffset();
+  auto LoadSerial = [this, &Sec, StartOffset]() {
+    FMgr.seek(StartOffset);
+    return loadSectionContentVec(Sec, [this](AST::CodeSegment &CodeSeg) {
+      return loadSegment(CodeSeg);
+    });
+  };
+
+  // Scan the segment sizes for the offsets of the segments. The malformed
+  // sizes are left to the serial loading to report the same errors.
+  uint32_t VecCnt = 0;
+  if (auto Res = loadVecCnt()) {
+    VecCnt = *Res;
+  } else {
+    return LoadSerial();
+  }
+  std::vector<uint64_t> Offsets;
+  Offsets.reserve(VecCnt + 1);
+  for (uint32_t I = 0; I < VecCnt; ++I) {
+    Offsets.push_back(FMgr.getOffset());
+    auto Res = FMgr.readU32();
+    if (!Res || *Res > FMgr.getRemainSize()) {
+      return LoadSerial();
+    }
+    FMgr.seek(FMgr.getOffset() + *Res);
+  }
+  Offsets.push_back(FMgr.getOffset());
+
+  // Split the segments into the contiguous chunks of similar byte sizes. More
+  // chunks than the threads balance the workers for the uneven functions.
+  const uint64_t ChunkSize = std::max(
+      (Offsets.back() - StartOffset) / (UINT64_C(4) * Threads), UINT64_C(1));
+  std::vector<uint32_t> Bounds = {0};
+  for (uint32_t I = 1; I < VecCnt; ++I) {
+    if (Offsets[I] - Offsets[Bounds.back()] >= ChunkSize) {
+      Bounds.push_back(I);
+    }
+  }
+  Bounds.push_back(VecCnt);
+
+  // Every chunk is loaded by a loader of its own on the same data. A chunk
+  // stops at its first error, or at the segments after any failed one. The
+  // first failed segment is always loaded, so the reported error is the same
+  // as the serial loading.
+  auto &CodeSegs = Sec.getContent();
+  CodeSegs.clear();
+  CodeSegs.resize(VecCnt);
+  const uint32_t ChunkNum = static_cast<uint32_t>(Bounds.size() - 1);
+  std::atomic<uint32_t> FailedIdx = VecCnt;
+  parallelFor(ChunkNum, Threads, [&](uint32_t C) {
+    // The chunks may fail in any order, so the errors are logged only by the
+    // loading again below.
+    Log::ScopedThreadLogOff LogOff;
+    Loader ChunkLoader(Conf, IntrinsicsTable);
+    ChunkLoader.FMgr.setCode(FMgr.getCode());
+    ChunkLoader.WASMType = WASMType;
+    ChunkLoader.HasDataSection = HasDataSection;
+    for (uint32_t I = Bounds[C]; I < Bounds[C + 1]; ++I) {
+      uint32_t Failed = FailedIdx.load(std::memory_order_relaxed);
+      if (I > Failed) {
+        return;
+      }
+      ChunkLoader.FMgr.seek(Offsets[I]);
+      if (auto Res = ChunkLoader.loadSegment(CodeSegs[I]); unlikely(!Res)) {
+        while (I < Failed && !FailedIdx.compare_exchange_weak(Failed, I)) {
+        }
+        return;
+      }
+    }
+  });
+
+  const uint32_t Failed = FailedIdx.load(std::memory_order_relaxed);
+  if (Failed < VecCnt) {
+    // Load the first failed segment again on this thread to log the same
+    // error messages as the serial loading.
+    FMgr.seek(Offsets[Failed]);
+    AST::CodeSegment CodeSeg;
+    auto Res = loadSegment(CodeSeg);
+    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Sec_Code));
+    return Unexpect(Res);
+  }
+  FMgr.seek(Offsets.back());
+  return {};
+}
+
 // Load vector of data section. See "include/loader/loader.h".
 Expect<void> Loader::loadSection(AST::DataSection &Sec) {
   return loadSectionContent(Sec, [this, &Sec]() {
@@ -383,7 +503,8 @@ inline constexpr uint8_t HostArchType() noexcept {
 
 // If there is any loader error occurs in the loadSection, then fallback
 // to the interpreter mode with info level log.
-Expect<void> Loader::loadSection(FileMgr &VecMgr, AST::AOTSection &Sec) {
+Expect<void> Loader::loadSection(FileMgr &VecMgr, AST::AOTSection &Sec,
+                                 std::optional<uint64_t> FileOffset) {
   if (auto Res = VecMgr.readU32(); unlikely(!Res)) {
     spdlog::info(Res.error());
     spdlog::info("    AOT binary version read error:{}", Res.error());
@@ -495,9 +616,12 @@ Expect<void> Loader::loadSection(FileMgr &VecMgr, AST::AOTSection &Sec) {
       return Unexpect(ErrCode::Value::IntegerTooLong);
     }
     Sec.getSections().resize(Size);
+    Sec.getFileRanges().assign(Size, {0, 0});
   }
 
-  for (auto &Section : Sec.getSections()) {
+  const uint64_t PageSize = FileOffset ? MMap::pageSize() : 0;
+  for (size_t I = 0; I < Sec.getSections().size(); ++I) {
+    auto &Section = Sec.getSections()[I];
     if (auto Res = VecMgr.readByte(); unlikely(!Res)) {
       spdlog::info(Res.error());
       spdlog::info("    AOT section type read error:{}", Res.error());
@@ -537,6 +661,16 @@ Expect<void> Loader::loadSection(FileMgr &VecMgr, AST::AOTSection &Sec) {
         return Unexpect(ErrCode::Value::IntegerTooLong);
       }
     }
+    // Leave the text and data contents in the file if they are aligned to the
+    // section addresses in pages, and map them at loading instead.
+    if (PageSize != 0 && ContentSize >= PageSize &&
+        (std::get<0>(Section) == 1 || std::get<0>(Section) == 2) &&
+        (*FileOffset + VecMgr.getOffset()) % PageSize ==
+            std::get<1>(Section) % PageSize) {
+      Sec.getFileRanges()[I] = {*FileOffset + VecMgr.getOffset(), ContentSize};
+      VecMgr.seek(VecMgr.getOffset() + ContentSize);
+      continue;
+    }
     if (auto Res = VecMgr.readBytes(ContentSize); unlikely(!Res)) {
       spdlog::info(Res.error());
       spdlog::info("    AOT section data read error:{}", Res.error());
@@ -203,7 +203,9 @@ Expect<void> Loader::loadSegment(AST::ElementSegment &ElemSeg) {
       ElemSeg.getInitExprs().emplace_back();
       AST::Instruction RefFunc(OpCode::Ref__func);
       AST::Instruction End(OpCode::End);
-      if (auto Res = loadInstruction(RefFunc); unlikely(!Res)) {
+      if (auto Res = loadInstruction(
+              RefFunc, ElemSeg.getInitExprs().back().getImmediates());
+          unlikely(!Res)) {
         spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Seg_Element));
         return Unexpect(Res);
       }
@@ -295,6 +297,17 @@ Expect<void> Loader::loadSegment(AST::CodeSegment &CodeSeg) {
     // For the AOT mode and not force interpreter in configure, skip the
     // function body.
     FMgr.seek(ExprSizeBound);
+  } else if (LazyCodeSec &&
+             ExprSizeBound <= LazyCodeOffset + LazyCodeSec->Code.size()) {
+    // For the lazy loading, keep the range of the function body in the code
+    // section. The body out of the section is loaded for the error.
+    CodeSeg.getExpr().getInstrs().clear();
+    CodeSeg.setLazyBody([Code = LazyCodeSec,
+                         Begin = FMgr.getOffset() - LazyCodeOffset,
+                         End = ExprSizeBound - LazyCodeOffset]() {
+      return loadLazyBody(*Code, Begin, End);
+    });
+    FMgr.seek(ExprSizeBound);
   } else {
     // Read function body with expected expression size.
     if (auto Res = loadExpression(CodeSeg.getExpr(), ExprSizeBound);
@@ -307,6 +320,31 @@ Expect<void> Loader::loadSegment(AST::CodeSegment &CodeSeg) {
   return {};
 }
 
+// Check the function bodies are lazy loaded. See "include/loader/loader.h".
+bool Loader::isLazyLoading() const noexcept {
+  // The JIT and the tiered execution compile the whole module.
+  const auto &RtConf = Conf.getRuntimeConfigure();
+  return RtConf.isEnableLazyLoading() && !RtConf.isEnableJIT() &&
+         RtConf.getTierUpThreshold() == 0 &&
+         (RtConf.isForceInterpreter() || WASMType == InputType::WASM);
+}
+
+// Decode the lazy loaded function body. See "include/loader/loader.h".
+Expect<AST::Expression> Loader::loadLazyBody(const LazyCode &Code,
+                                             uint64_t Begin, uint64_t End) {
+  // The offsets of the instructions are counted from the code section.
+  Loader Load(Code.Conf);
+  Load.FMgr.setCode(Span<const Byte>(Code.Code));
+  Load.FMgr.seek(Begin);
+  Load.HasDataSection = Code.HasDataSection;
+  auto Res = Load.loadInstrSeq(End);
+  if (!Res) {
+    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Expression));
+    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Seg_Code));
+  }
+  return Res;
+}
+
 // Load binary of DataSegment node. See "include/loader/loader.h".
 Expect<void> Loader::loadSegment(AST::DataSegment &DataSeg) {
   DataSeg.setMode(AST::DataSegment::DataMode::Passive);
@@ -278,12 +278,22 @@ Expect<void> Loader::loadLimit(AST::Limit &Lim) {
   if (auto Res = FMgr.readByte()) {
     switch (static_cast<AST::Limit::LimitType>(*Res)) {
     case AST::Limit::LimitType::HasMin:
-      Lim.setType(AST::Limit::LimitType::HasMin);
-      break;
     case AST::Limit::LimitType::HasMinMax:
-      Lim.setType(AST::Limit::LimitType::HasMinMax);
+    case AST::Limit::LimitType::Shared:
+      Lim.setType(static_cast<AST::Limit::LimitType>(*Res));
+      break;
+    case AST::Limit::LimitType::I64HasMin:
+    case AST::Limit::LimitType::I64HasMinMax:
+    case AST::Limit::LimitType::I64Shared:
+      if (!Conf.hasProposal(Proposal::Memory64)) {
+        return logNeedProposal(ErrCode::Value::IntegerTooLarge,
+                               Proposal::Memory64, FMgr.getLastOffset(),
+                               ASTNodeAttr::Type_Limit);
+      }
+      Lim.setType(static_cast<AST::Limit::LimitType>(*Res));
       break;
     case AST::Limit::LimitType::SharedNoMax:
+    case AST::Limit::LimitType::I64SharedNoMax:
       if (Conf.hasProposal(Proposal::Threads)) {
         return logLoadError(ErrCode::Value::SharedMemoryNoMax,
                             FMgr.getLastOffset(), ASTNodeAttr::Type_Limit);
@@ -291,9 +301,6 @@ Expect<void> Loader::loadLimit(AST::Limit &Lim) {
         return logLoadError(ErrCode::Value::IntegerTooLarge,
                             FMgr.getLastOffset(), ASTNodeAttr::Type_Limit);
       }
-    case AST::Limit::LimitType::Shared:
-      Lim.setType(AST::Limit::LimitType::Shared);
-      break;
     default:
       if (*Res == 0x80 || *Res == 0x81) {
         // LEB128 cases will fail.
@@ -309,8 +316,14 @@ Expect<void> Loader::loadLimit(AST::Limit &Lim) {
                         ASTNodeAttr::Type_Limit);
   }
 
-  // Read min and max number.
-  if (auto Res = FMgr.readU32()) {
+  // Read min and max number. The numbers are u64 for the 64-bit limits.
+  auto ReadNum = [this, &Lim]() -> Expect<uint64_t> {
+    if (Lim.is64()) {
+      return FMgr.readU64();
+    }
+    return FMgr.readU32();
+  };
+  if (auto Res = ReadNum()) {
     Lim.setMin(*Res);
     Lim.setMax(*Res);
   } else {
@@ -318,7 +331,7 @@ Expect<void> Loader::loadLimit(AST::Limit &Lim) {
                         ASTNodeAttr::Type_Limit);
   }
   if (Lim.hasMax()) {
-    if (auto Res = FMgr.readU32()) {
+    if (auto Res = ReadNum()) {
       Lim.setMax(*Res);
     } else {
       return logLoadError(Res.error(), FMgr.getLastOffset(),
@@ -427,6 +440,11 @@ Expect<void> Loader::loadType(AST::TableType &TabType) {
     spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Type_Table));
     return Unexpect(Res);
   }
+  // The tables are indexed by i32 only.
+  if (unlikely(TabType.getLimit().is64())) {
+    return logLoadError(ErrCode::Value::IntegerTooLarge, FMgr.getLastOffset(),
+                        ASTNodeAttr::Type_Table);
+  }
   return {};
 }
 
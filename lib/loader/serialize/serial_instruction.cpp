@@ -18,7 +18,11 @@ Serializer::serializeInstruction(const AST::Instruction &Instr,
     } else {
       serializeU32(Instr.getMemoryAlign(), OutVec);
     }
-    serializeU32(Instr.getMemoryOffset(), OutVec);
+    if (Conf.hasProposal(Proposal::Memory64)) {
+      serializeU64(Instr.getMemoryOffset(), OutVec);
+    } else {
+      serializeU32(static_cast<uint32_t>(Instr.getMemoryOffset()), OutVec);
+    }
     return {};
   };
 
@@ -99,6 +99,7 @@ Serializer::serializeLimit(const AST::Limit &Lim,
   //       |0x01 + min:u32 + max:u32
   //       |0x02 + min:u32 (shared)
   //       |0x03 + min:u32 + max:u32 (shared)
+  //       |0x04~0x07 + min:u64 (+ max:u64) (64-bit)
   uint8_t Flag = 0;
   if (Lim.isShared()) {
     Flag = 0x02U;
@@ -106,8 +107,14 @@ Serializer::serializeLimit(const AST::Limit &Lim,
   if (Lim.hasMax()) {
     Flag |= 0x01U;
   }
-  if (unlikely(static_cast<AST::Limit::LimitType>(Flag) ==
-               AST::Limit::LimitType::SharedNoMax)) {
+  if (Lim.is64()) {
+    if (unlikely(!Conf.hasProposal(Proposal::Memory64))) {
+      return logNeedProposal(ErrCode::Value::IntegerTooLarge,
+                             Proposal::Memory64, ASTNodeAttr::Type_Limit);
+    }
+    Flag |= 0x04U;
+  }
+  if (unlikely((Flag & 0x03U) == 0x02U)) {
     if (Conf.hasProposal(Proposal::Threads)) {
       return logSerializeError(ErrCode::Value::SharedMemoryNoMax,
                                ASTNodeAttr::Type_Limit);
@@ -116,9 +123,16 @@ Serializer::serializeLimit(const AST::Limit &Lim,
                              ASTNodeAttr::Type_Limit);
   }
   OutVec.push_back(Flag);
-  serializeU32(Lim.getMin(), OutVec);
-  if (Lim.hasMax()) {
-    serializeU32(Lim.getMax(), OutVec);
+  if (Lim.is64()) {
+    serializeU64(Lim.getMin(), OutVec);
+    if (Lim.hasMax()) {
+      serializeU64(Lim.getMax(), OutVec);
+    }
+  } else {
+    serializeU32(static_cast<uint32_t>(Lim.getMin()), OutVec);
+    if (Lim.hasMax()) {
+      serializeU32(static_cast<uint32_t>(Lim.getMax()), OutVec);
+    }
   }
   return {};
 }
@@ -0,0 +1,238 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "loader/stream.h"
+
+#include "common/errinfo.h"
+#include "common/spdlog.h"
+
+#include <cstddef>
+#include <utility>
+
+namespace WasmEdge {
+namespace Loader {
+
+StreamLoader::StreamLoader(const Configure &Conf) noexcept
+    : Load(Conf), Mod(std::make_unique<AST::Module>()) {
+  Load.HasDataSection = false;
+  Load.WASMType = Loader::InputType::WASM;
+}
+
+// Append the chunk and load. See "include/loader/stream.h".
+Expect<void> StreamLoader::feed(Span<const Byte> Chunk) {
+  if (Error) {
+    return Unexpect(*Error);
+  }
+  if (CurrStage == Stage::Finished) {
+    return Unexpect(ErrCode::Value::WrongVMWorkflow);
+  }
+  Buffer.insert(Buffer.end(), Chunk.begin(), Chunk.end());
+  if (CurrStage == Stage::Malformed) {
+    return {};
+  }
+  // The buffer may be reallocated, so set the code again.
+  Load.FMgr.setCode(Span<const Byte>(Buffer));
+  if (auto Res = load(); !Res) {
+    // The loader checks the sizes with the remaining bytes, so the error may
+    // be different from the one of the whole binary. Report it at the end.
+    CurrStage = Stage::Malformed;
+  }
+  return {};
+}
+
+// End the binary and get the module. See "include/loader/stream.h".
+Expect<std::unique_ptr<AST::Module>> StreamLoader::finish() {
+  if (Error) {
+    return Unexpect(*Error);
+  }
+  if (CurrStage == Stage::Finished) {
+    return Unexpect(ErrCode::Value::WrongVMWorkflow);
+  }
+  const auto LastStage = std::exchange(CurrStage, Stage::Finished);
+  Load.FMgr.setCode(Span<const Byte>(Buffer));
+
+  // Load the incomplete part as the whole binary, for the errors to be
+  // reported as the other loaders.
+  if (LastStage == Stage::Malformed) {
+    auto Res = Load.parseModule(Buffer);
+    if (!Res) {
+      Error = Res.error();
+    }
+    Buffer.clear();
+    Buffer.shrink_to_fit();
+    return Res;
+  }
+  Expect<void> Res;
+  switch (LastStage) {
+  case Stage::Preamble:
+    if (auto ResPreamble = Load.loadPreamble(); !ResPreamble) {
+      Res = Unexpect(ResPreamble);
+    }
+    break;
+  case Stage::Section:
+    if (Offset < Buffer.size()) {
+      Load.FMgr.seek(Offset + 1);
+      Res = Load.loadModuleSection(*Mod, Buffer[Offset], Secs);
+    }
+    break;
+  case Stage::CodeCount:
+  case Stage::CodeSegment:
+    Mod->getCodeSection().getContent().clear();
+    Load.FMgr.seek(CodeOffset + 1);
+    Res = Load.loadModuleSection(*Mod, Buffer[CodeOffset], Secs);
+    break;
+  default:
+    break;
+  }
+  if (Res) {
+    Res = Load.checkModule(*Mod);
+  }
+  if (!Res) {
+    Error = Res.error();
+    return Unexpect(Res);
+  }
+  Buffer.clear();
+  Buffer.shrink_to_fit();
+  Load.reset();
+  return std::move(Mod);
+}
+
+// Load the completed parts. See "include/loader/stream.h".
+Expect<void> StreamLoader::load() {
+  auto &FMgr = Load.FMgr;
+  while (true) {
+    FMgr.seek(Offset);
+    switch (CurrStage) {
+    case Stage::Preamble: {
+      if (Buffer.size() < 8) {
+        return {};
+      }
+      auto ResPreamble = Load.loadPreamble();
+      if (!ResPreamble) {
+        return Unexpect(ResPreamble);
+      }
+      if (ResPreamble->second != Load.ModuleVersion) {
+        return Load.logLoadError(ErrCode::Value::MalformedVersion,
+                                 FMgr.getLastOffset(), ASTNodeAttr::Module);
+      }
+      Mod->getMagic() = std::move(ResPreamble->first);
+      Mod->getVersion() = std::move(ResPreamble->second);
+      Offset = FMgr.getOffset();
+      CurrStage = Stage::Section;
+      break;
+    }
+    case Stage::Section: {
+      if (Offset >= Buffer.size()) {
+        return {};
+      }
+      const uint8_t SectionId = Buffer[Offset];
+      FMgr.seek(Offset + 1);
+      auto ResSize = FMgr.readU32();
+      if (!ResSize && ResSize.error() == ErrCode::Value::UnexpectedEnd) {
+        return {};
+      }
+      if (ResSize && FMgr.getRemainSize() < *ResSize) {
+        // Load the function bodies while the code section is arriving, unless
+        // it is waited as a whole.
+        if (SectionId == 0x0AU && !Secs.test(SectionId) &&
+            CodeOffset != Offset) {
+          CodeOffset = Offset;
+          CodeEnd = FMgr.getOffset() + *ResSize;
+          auto &Sec = Mod->getCodeSection();
+          Sec.setStartOffset(Offset + 1);
+          Sec.setContentSize(*ResSize);
+          Offset = FMgr.getOffset();
+          CurrStage = Stage::CodeCount;
+          break;
+        }
+        return {};
+      }
+      // The section is complete or malformed.
+      FMgr.seek(Offset + 1);
+      if (auto Res = Load.loadModuleSection(*Mod, SectionId, Secs); !Res) {
+        return Unexpect(Res);
+      }
+      Offset = FMgr.getOffset();
+      break;
+    }
+    case Stage::CodeCount: {
+      auto ResCount = FMgr.readU32();
+      if (!ResCount && ResCount.error() == ErrCode::Value::UnexpectedEnd) {
+        return {};
+      }
+      if (!ResCount || *ResCount / 2 > CodeEnd - FMgr.getOffset()) {
+        waitCodeSection();
+        break;
+      }
+      Mod->getCodeSection().getContent().clear();
+      Mod->getCodeSection().getContent().resize(*ResCount);
+      Loaded = 0;
+      Offset = FMgr.getOffset();
+      CurrStage = Stage::CodeSegment;
+      break;
+    }
+    case Stage::CodeSegment:
+      if (auto Res = loadCodeSegments(); !Res) {
+        return Unexpect(Res);
+      }
+      if (CurrStage == Stage::CodeSegment) {
+        return {};
+      }
+      break;
+    default:
+      return {};
+    }
+  }
+}
+
+// Load the function bodies. See "include/loader/stream.h".
+Expect<void> StreamLoader::loadCodeSegments() {
+  auto &FMgr = Load.FMgr;
+  auto &CodeSegs = Mod->getCodeSection().getContent();
+  for (auto It = CodeSegs.begin() + static_cast<std::ptrdiff_t>(Loaded);
+       It != CodeSegs.end(); ++It) {
+    FMgr.seek(Offset);
+    auto ResSize = FMgr.readU32();
+    if (!ResSize && ResSize.error() == ErrCode::Value::UnexpectedEnd) {
+      return {};
+    }
+    if (!ResSize || FMgr.getOffset() + *ResSize > CodeEnd) {
+      waitCodeSection();
+      return {};
+    }
+    if (FMgr.getRemainSize() < *ResSize) {
+      return {};
+    }
+    FMgr.seek(Offset);
+    if (auto Res = Load.loadSegment(*It); !Res) {
+      spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Sec_Code));
+      spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+      return Unexpect(Res);
+    }
+    Offset = FMgr.getOffset();
+    if (CodeSegCallback) {
+      CodeSegCallback(*Mod, Loaded);
+    }
+    ++Loaded;
+  }
+  if (Offset != CodeEnd) {
+    spdlog::error(ErrCode::Value::SectionSizeMismatch);
+    spdlog::error(ErrInfo::InfoLoading(Offset));
+    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Sec_Code));
+    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+    return Unexpect(ErrCode::Value::SectionSizeMismatch);
+  }
+  Secs.set(0x0AU);
+  CurrStage = Stage::Section;
+  return {};
+}
+
+// Wait for the whole code section. See "include/loader/stream.h".
+void StreamLoader::waitCodeSection() noexcept {
+  Mod->getCodeSection().getContent().clear();
+  Offset = CodeOffset;
+  CurrStage = Stage::Section;
+}
+
+} // namespace Loader
+} // namespace WasmEdge
@@ -7,11 +7,22 @@
 #include "common/defines.h"
 #include "common/errcode.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <utility>
+#include <vector>
+
 #if WASMEDGE_OS_WINDOWS
 #include "system/winapi.h"
 #elif defined(HAVE_MMAP) && defined(__x86_64__) || defined(__aarch64__) ||     \
     defined(__arm__) || (defined(__riscv) && __riscv_xlen == 64)
 #include <sys/mman.h>
+#if WASMEDGE_OS_LINUX
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 #else
 #include <cctype>
 #include <cstdlib>
@@ -23,6 +34,9 @@ namespace WasmEdge {
 namespace {
 static inline constexpr const uint64_t kPageSize = UINT64_C(65536);
 
+/// Increased before the pages of a linear memory are released or replaced.
+std::atomic<uint64_t> MappingGeneration = 0;
+
 #if WASMEDGE_OS_WINDOWS || defined(HAVE_MMAP) && defined(__x86_64__) ||        \
     defined(__aarch64__) || (defined(__riscv) && __riscv_xlen == 64)
 // Only define these two constants on the supported platform to avoid
@@ -31,8 +45,142 @@ static inline constexpr const uint64_t k4G = UINT64_C(0x100000000);
 static inline constexpr const uint64_t k12G = UINT64_C(0x300000000);
 #endif
 
+#if WASMEDGE_OS_LINUX && defined(HAVE_MMAP) &&                                 \
+    (defined(__x86_64__) || defined(__aarch64__) ||                            \
+     (defined(__riscv) && __riscv_xlen == 64))
+// The MFD_CLOEXEC flag of memfd_create.
+static inline constexpr const unsigned int kMemfdCloexec = 0x0001U;
+#endif
+
+#if !WASMEDGE_OS_WINDOWS &&                                                    \
+    (defined(HAVE_MMAP) && defined(__x86_64__) || defined(__aarch64__) ||      \
+     (defined(__riscv) && __riscv_xlen == 64))
+/// Pool of the pre-reserved linear memory slots. Each slot has the same 12G
+/// layout as the individual reservation, so the guard regions are kept. The
+/// slots stay mapped for the lifetime of the process, and only the protection
+/// of their pages is changed when they are grown and recycled.
+class MemoryPool {
+public:
+  /// Reserve the slots at the first call. The later calls only check the
+  /// result without taking the lock of the free slots, and fail if the pool
+  /// has fewer slots than requested.
+  bool reserve(uint32_t Count) noexcept {
+    std::call_once(ReserveOnce, [this, Count]() noexcept {
+      auto Reserved = reinterpret_cast<uint8_t *>(
+          mmap(nullptr, Count * k12G, PROT_NONE,
+               MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0));
+      if (Reserved == MAP_FAILED) {
+        return;
+      }
+      std::unique_lock Lock(Mutex);
+      FreeSlots.reserve(Count);
+      for (uint32_t I = Count; I > 0; --I) {
+        FreeSlots.push_back(I - 1);
+      }
+      Remapped.assign(Count, false);
+      Size.store(Count * k12G, std::memory_order_relaxed);
+      Base.store(Reserved, std::memory_order_release);
+    });
+    return Base.load(std::memory_order_acquire) != nullptr &&
+           uint64_t(Count) * k12G <= Size.load(std::memory_order_relaxed);
+  }
+
+  /// Take a free slot. Returns the memory pointer of the slot, or nullptr if
+  /// the pool is exhausted or not reserved.
+  uint8_t *acquire() noexcept {
+    uint8_t *Reserved = Base.load(std::memory_order_acquire);
+    if (Reserved == nullptr) {
+      return nullptr;
+    }
+    std::unique_lock Lock(Mutex);
+    if (FreeSlots.empty()) {
+      return nullptr;
+    }
+    const uint64_t Index = FreeSlots.back();
+    FreeSlots.pop_back();
+    return Reserved + Index * k12G + k4G;
+  }
+
+  bool contains(const uint8_t *Pointer) const noexcept {
+    const uint8_t *Reserved = Base.load(std::memory_order_acquire);
+    return Reserved != nullptr && Pointer >= Reserved &&
+           Pointer < Reserved + Size.load(std::memory_order_relaxed);
+  }
+
+  /// Record that the pages of the memory are replaced by another mapping,
+  /// which is dropped when the slot is recycled.
+  void markRemapped(const uint8_t *Pointer) noexcept {
+    const uint64_t Index = getIndex(Pointer);
+    std::unique_lock Lock(Mutex);
+    Remapped[Index] = true;
+  }
+
+  /// Discard the pages of the memory and return the slot to the pool.
+  void recycle(uint8_t *Pointer, uint64_t PageCount) noexcept {
+    const uint64_t Index = getIndex(Pointer);
+    bool WasRemapped;
+    {
+      std::unique_lock Lock(Mutex);
+      WasRemapped = Remapped[Index];
+      Remapped[Index] = false;
+    }
+    if (PageCount > 0) {
+      if (unlikely(WasRemapped)) {
+        // The pages of the restored snapshots are file backed, and would be
+        // read back from the file after discarded. Map the anonymous pages
+        // back into the slot.
+        mmap(Pointer, PageCount * kPageSize, PROT_NONE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0);
+      } else {
+        // Drop the pages to zeros first to avoid the kernel keeping them
+        // alive through the protection change, then restore the guard of the
+        // slot. The mapping is kept, and `resize` only changes the protection
+        // when the slot is handed out again.
+        madvise(Pointer, PageCount * kPageSize, MADV_DONTNEED);
+        mprotect(Pointer, PageCount * kPageSize, PROT_NONE);
+      }
+    }
+    std::unique_lock Lock(Mutex);
+    FreeSlots.push_back(static_cast<uint32_t>(Index));
+  }
+
+private:
+  uint64_t getIndex(const uint8_t *Pointer) const noexcept {
+    const uint8_t *Reserved = Base.load(std::memory_order_acquire);
+    return static_cast<uint64_t>(Pointer - k4G - Reserved) / k12G;
+  }
+
+  std::once_flag ReserveOnce;
+  std::mutex Mutex;
+  std::atomic<uint8_t *> Base = nullptr;
+  std::atomic<uint64_t> Size = 0;
+  std::vector<uint32_t> FreeSlots;
+  /// Whether the pages of the slots are replaced by `Snapshot::restore`.
+  std::vector<bool> Remapped;
+};
+
+MemoryPool &getMemoryPool() noexcept {
+  static MemoryPool Pool;
+  return Pool;
+}
+#endif
+
 } // namespace
 
+WASMEDGE_EXPORT bool Allocator::reservePool(uint32_t SlotCount
+                                            [[maybe_unused]]) noexcept {
+#if !WASMEDGE_OS_WINDOWS &&                                                    \
+    (defined(HAVE_MMAP) && defined(__x86_64__) || defined(__aarch64__) ||      \
+     (defined(__riscv) && __riscv_xlen == 64))
+  if (SlotCount == 0) {
+    return false;
+  }
+  return getMemoryPool().reserve(SlotCount);
+#else
+  return false;
+#endif
+}
+
 WASMEDGE_EXPORT uint8_t *Allocator::allocate(uint32_t PageCount) noexcept {
 #if WASMEDGE_OS_WINDOWS
   auto Reserved = reinterpret_cast<uint8_t *>(winapi::VirtualAlloc(
@@ -50,6 +198,16 @@ WASMEDGE_EXPORT uint8_t *Allocator::allocate(uint32_t PageCount) noexcept {
   return Pointer;
 #elif defined(HAVE_MMAP) && defined(__x86_64__) || defined(__aarch64__) ||     \
     (defined(__riscv) && __riscv_xlen == 64)
+  if (auto Slot = getMemoryPool().acquire(); Slot != nullptr) {
+    if (PageCount == 0) {
+      return Slot;
+    }
+    if (auto Pointer = resize(Slot, 0, PageCount); Pointer != nullptr) {
+      return Pointer;
+    }
+    getMemoryPool().recycle(Slot, 0);
+    return nullptr;
+  }
   auto Reserved = reinterpret_cast<uint8_t *>(
       mmap(nullptr, k12G, PROT_NONE,
            MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0));
@@ -75,8 +233,8 @@ WASMEDGE_EXPORT uint8_t *Allocator::allocate(uint32_t PageCount) noexcept {
 }
 
 WASMEDGE_EXPORT uint8_t *Allocator::resize(uint8_t *Pointer,
-                                           uint32_t OldPageCount,
-                                           uint32_t NewPageCount) noexcept {
+                                           uint64_t OldPageCount,
+                                           uint64_t NewPageCount) noexcept {
   assuming(NewPageCount > OldPageCount);
 #if WASMEDGE_OS_WINDOWS
   if (winapi::VirtualAlloc(Pointer + OldPageCount * kPageSize,
@@ -88,6 +246,16 @@ WASMEDGE_EXPORT uint8_t *Allocator::resize(uint8_t *Pointer,
   return Pointer;
 #elif defined(HAVE_MMAP) && defined(__x86_64__) || defined(__aarch64__) ||     \
     (defined(__riscv) && __riscv_xlen == 64)
+  if (getMemoryPool().contains(Pointer)) {
+    // The pages in the pool slots are kept mapped and zeroed when recycled,
+    // so only the protection is changed.
+    if (mprotect(Pointer + OldPageCount * kPageSize,
+                 (NewPageCount - OldPageCount) * kPageSize,
+                 PROT_READ | PROT_WRITE) != 0) {
+      return nullptr;
+    }
+    return Pointer;
+  }
   if (mmap(Pointer + OldPageCount * kPageSize,
            (NewPageCount - OldPageCount) * kPageSize, PROT_READ | PROT_WRITE,
            MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) == MAP_FAILED) {
@@ -106,7 +274,10 @@ WASMEDGE_EXPORT uint8_t *Allocator::resize(uint8_t *Pointer,
 #endif
 }
 
-WASMEDGE_EXPORT void Allocator::release(uint8_t *Pointer, uint32_t) noexcept {
+WASMEDGE_EXPORT void Allocator::release(uint8_t *Pointer,
+                                        uint64_t PageCount
+                                        [[maybe_unused]]) noexcept {
+  MappingGeneration.fetch_add(1, std::memory_order_release);
 #if WASMEDGE_OS_WINDOWS
   winapi::VirtualFree(Pointer - k4G, 0, winapi::MEM_RELEASE_);
 #elif defined(HAVE_MMAP) && defined(__x86_64__) || defined(__aarch64__) ||     \
@@ -114,12 +285,81 @@ WASMEDGE_EXPORT void Allocator::release(uint8_t *Pointer, uint32_t) noexcept {
   if (Pointer == nullptr) {
     return;
   }
+  if (getMemoryPool().contains(Pointer)) {
+    getMemoryPool().recycle(Pointer, PageCount);
+    return;
+  }
   munmap(Pointer - k4G, k12G);
 #else
   return std::free(Pointer);
 #endif
 }
 
+WASMEDGE_EXPORT uint8_t *
+Allocator::allocate_reserved(uint64_t PageCount,
+                             uint64_t ReservedPageCount) noexcept {
+  assuming(PageCount <= ReservedPageCount);
+  // Reserve at least one page for the empty memories to get a valid address.
+  const uint64_t ReservedSize =
+      std::max(ReservedPageCount, UINT64_C(1)) * kPageSize;
+#if WASMEDGE_OS_WINDOWS
+  auto Reserved = reinterpret_cast<uint8_t *>(winapi::VirtualAlloc(
+      nullptr, ReservedSize, winapi::MEM_RESERVE_, winapi::PAGE_NOACCESS_));
+  if (Reserved == nullptr) {
+    return nullptr;
+  }
+#elif defined(HAVE_MMAP) && defined(__x86_64__) || defined(__aarch64__) ||     \
+    (defined(__riscv) && __riscv_xlen == 64)
+  auto Reserved = reinterpret_cast<uint8_t *>(
+      mmap(nullptr, ReservedSize, PROT_NONE,
+           MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0));
+  if (Reserved == MAP_FAILED) {
+    return nullptr;
+  }
+#else
+  static_cast<void>(ReservedSize);
+  auto Result = reinterpret_cast<uint8_t *>(std::malloc(kPageSize * PageCount));
+  if (Result == nullptr) {
+    return nullptr;
+  }
+  std::memset(Result, 0, kPageSize * PageCount);
+  return Result;
+#endif
+#if WASMEDGE_OS_WINDOWS || defined(HAVE_MMAP) && defined(__x86_64__) ||        \
+    defined(__aarch64__) || (defined(__riscv) && __riscv_xlen == 64)
+  if (PageCount == 0) {
+    return Reserved;
+  }
+  if (auto Pointer = resize(Reserved, 0, PageCount); Pointer != nullptr) {
+    return Pointer;
+  }
+  release_reserved(Reserved, ReservedPageCount);
+  return nullptr;
+#endif
+}
+
+WASMEDGE_EXPORT void
+Allocator::release_reserved(uint8_t *Pointer,
+                            uint64_t ReservedPageCount
+                            [[maybe_unused]]) noexcept {
+  if (Pointer == nullptr) {
+    return;
+  }
+  MappingGeneration.fetch_add(1, std::memory_order_release);
+#if WASMEDGE_OS_WINDOWS
+  winapi::VirtualFree(Pointer, 0, winapi::MEM_RELEASE_);
+#elif defined(HAVE_MMAP) && defined(__x86_64__) || defined(__aarch64__) ||     \
+    (defined(__riscv) && __riscv_xlen == 64)
+  munmap(Pointer, std::max(ReservedPageCount, UINT64_C(1)) * kPageSize);
+#else
+  std::free(Pointer);
+#endif
+}
+
+WASMEDGE_EXPORT uint64_t Allocator::getMappingGeneration() noexcept {
+  return MappingGeneration.load(std::memory_order_acquire);
+}
+
 uint8_t *Allocator::allocate_chunk(uint64_t Size) noexcept {
 #if WASMEDGE_OS_WINDOWS
   if (auto Pointer = winapi::VirtualAlloc(nullptr, Size, winapi::MEM_COMMIT_,
@@ -190,4 +430,169 @@ bool Allocator::set_chunk_readable_writable(uint8_t *Pointer,
 #endif
 }
 
+namespace {
+/// Inaccessible region after the stacks, which covers the page sizes of the
+/// supported platforms.
+static inline constexpr const uint64_t kStackGuardSize = kPageSize;
+
+/// Stack released last in the thread, which is reused by the next allocation
+/// of the same size instead of mapping a new one.
+struct CachedStack {
+  ~CachedStack() noexcept {
+    if (Pointer != nullptr) {
+      Allocator::release_chunk(Pointer, Size + kStackGuardSize);
+    }
+  }
+  uint8_t *Pointer = nullptr;
+  uint64_t Size = 0;
+};
+thread_local CachedStack StackCache;
+} // namespace
+
+uint8_t *Allocator::allocate_stack(uint64_t Size) noexcept {
+  if (StackCache.Pointer != nullptr && StackCache.Size == Size) {
+    return std::exchange(StackCache.Pointer, nullptr);
+  }
+  uint8_t *Pointer = allocate_chunk(Size + kStackGuardSize);
+  if (unlikely(Pointer == nullptr)) {
+    return nullptr;
+  }
+#if WASMEDGE_OS_WINDOWS
+  winapi::DWORD_ OldPerm;
+  winapi::VirtualProtect(Pointer + Size, kStackGuardSize,
+                         winapi::PAGE_NOACCESS_, &OldPerm);
+#elif defined(HAVE_MMAP)
+  mprotect(Pointer + Size, kStackGuardSize, PROT_NONE);
+#endif
+  return Pointer;
+}
+
+void Allocator::release_stack(uint8_t *Pointer, uint64_t Size) noexcept {
+  if (StackCache.Pointer == nullptr) {
+    StackCache.Pointer = Pointer;
+    StackCache.Size = Size;
+    return;
+  }
+  release_chunk(Pointer, Size + kStackGuardSize);
+}
+
+Allocator::Snapshot::~Snapshot() noexcept {
+#if WASMEDGE_OS_LINUX && defined(HAVE_MMAP)
+  if (Fd >= 0) {
+    close(Fd);
+  }
+#endif
+}
+
+bool Allocator::Snapshot::capture(const uint8_t *Pointer,
+                                  uint64_t Count) noexcept {
+  const uint64_t Size = Count * kPageSize;
+#if WASMEDGE_OS_LINUX && defined(HAVE_MMAP) &&                                 \
+    (defined(__x86_64__) || defined(__aarch64__) ||                            \
+     (defined(__riscv) && __riscv_xlen == 64))
+  // Call memfd_create through syscall for the old glibc without the wrapper.
+  int NewFd = static_cast<int>(
+      syscall(SYS_memfd_create, "wasmedge-memory-snapshot", kMemfdCloexec));
+  if (NewFd < 0) {
+    return false;
+  }
+  if (ftruncate(NewFd, static_cast<off_t>(Size)) != 0) {
+    close(NewFd);
+    return false;
+  }
+  if (Size > 0) {
+    auto *Target = reinterpret_cast<uint8_t *>(
+        mmap(nullptr, Size, PROT_WRITE, MAP_SHARED, NewFd, 0));
+    if (Target == MAP_FAILED) {
+      close(NewFd);
+      return false;
+    }
+    // Only copy the non-zero system pages to keep the memfd sparse.
+    const uint64_t SysPageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    for (uint64_t Off = 0; Off < Size; Off += SysPageSize) {
+      const uint8_t *Page = Pointer + Off;
+      if (std::any_of(Page, Page + SysPageSize,
+                      [](uint8_t B) { return B != 0; })) {
+        std::memcpy(Target + Off, Page, SysPageSize);
+      }
+    }
+    munmap(Target, Size);
+  }
+  if (Fd >= 0) {
+    close(Fd);
+  }
+  Fd = NewFd;
+#else
+  Image.assign(Pointer, Pointer + Size);
+#endif
+  PageCount = Count;
+  return true;
+}
+
+uint8_t *Allocator::Snapshot::restore(uint8_t *Pointer,
+                                      uint64_t Count) const noexcept {
+  MappingGeneration.fetch_add(1, std::memory_order_release);
+#if WASMEDGE_OS_LINUX && defined(HAVE_MMAP) &&                                 \
+    (defined(__x86_64__) || defined(__aarch64__) ||                            \
+     (defined(__riscv) && __riscv_xlen == 64))
+  if (Fd < 0) {
+    return nullptr;
+  }
+  if (Count > PageCount) {
+    // Return the pages grown after the capture to the reserved region.
+    if (mmap(Pointer + PageCount * kPageSize, (Count - PageCount) * kPageSize,
+             PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED,
+             -1, 0) == MAP_FAILED) {
+      return nullptr;
+    }
+  }
+  // Map the image privately over the memory. The dirty pages are dropped and
+  // the clean ones are shared with the page cache of the memfd.
+  if (PageCount > 0) {
+    if (getMemoryPool().contains(Pointer)) {
+      getMemoryPool().markRemapped(Pointer);
+    }
+    if (mmap(Pointer, PageCount * kPageSize, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_FIXED, Fd, 0) == MAP_FAILED) {
+      return nullptr;
+    }
+  }
+  return Pointer;
+#else
+  if (Count < PageCount) {
+    Pointer = resize(Pointer, Count, PageCount);
+    if (Pointer == nullptr) {
+      return nullptr;
+    }
+  } else if (Count > PageCount) {
+    // Release the pages grown after the capture.
+#if WASMEDGE_OS_WINDOWS
+    if (winapi::VirtualFree(Pointer + PageCount * kPageSize,
+                            (Count - PageCount) * kPageSize,
+                            winapi::MEM_DECOMMIT_) == 0) {
+      return nullptr;
+    }
+#elif defined(HAVE_MMAP) && defined(__x86_64__) || defined(__aarch64__) ||     \
+    (defined(__riscv) && __riscv_xlen == 64)
+    if (mmap(Pointer + PageCount * kPageSize, (Count - PageCount) * kPageSize,
+             PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED,
+             -1, 0) == MAP_FAILED) {
+      return nullptr;
+    }
+#else
+    if (PageCount > 0) {
+      auto Result = reinterpret_cast<uint8_t *>(
+          std::realloc(Pointer, PageCount * kPageSize));
+      if (Result == nullptr) {
+        return nullptr;
+      }
+      Pointer = Result;
+    }
+#endif
+  }
+  std::copy(Image.begin(), Image.end(), Pointer);
+  return Pointer;
+#endif
+}
+
 } // namespace WasmEdge
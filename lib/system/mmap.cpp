@@ -60,6 +60,7 @@ struct Implement {
   void *Address = nullptr;
   winapi::HANDLE_ File = nullptr;
   winapi::HANDLE_ Map = nullptr;
+  uint64_t Size = 0;
   Implement(const std::filesystem::path &Path) noexcept {
 
 #if NTDDI_VERSION >= NTDDI_WIN8
@@ -84,17 +85,19 @@ struct Implement {
       return;
     }
 
-    winapi::LARGE_INTEGER_ Size;
-    winapi::GetFileSizeEx(File, &Size);
+    winapi::LARGE_INTEGER_ FileSize;
+    winapi::GetFileSizeEx(File, &FileSize);
+    Size = static_cast<uint64_t>(FileSize.QuadPart);
 
 #if NTDDI_VERSION >= NTDDI_WIN8
     Map = winapi::CreateFileMappingFromApp(
         File, nullptr, winapi::PAGE_READONLY_,
-        static_cast<WasmEdge::winapi::ULONG64_>(Size.QuadPart), nullptr);
+        static_cast<WasmEdge::winapi::ULONG64_>(FileSize.QuadPart), nullptr);
 #else
-    Map = winapi::CreateFileMappingW(File, nullptr, winapi::PAGE_READONLY_,
-                                     static_cast<winapi::ULONG_>(Size.HighPart),
-                                     Size.LowPart, nullptr);
+    Map = winapi::CreateFileMappingW(
+        File, nullptr, winapi::PAGE_READONLY_,
+        static_cast<winapi::ULONG_>(FileSize.HighPart), FileSize.LowPart,
+        nullptr);
 #endif
     if (Map == nullptr) {
       return;
@@ -156,6 +159,48 @@ void *MMap::address() const noexcept {
   return reinterpret_cast<const Implement *>(Handle)->Address;
 }
 
+uint64_t MMap::size() const noexcept {
+#if defined(HAVE_MMAP) || WASMEDGE_OS_WINDOWS
+  if (!Handle) {
+    return 0;
+  }
+  return reinterpret_cast<const Implement *>(Handle)->Size;
+#else
+  return 0;
+#endif
+}
+
 bool MMap::supported() noexcept { return kSupported; }
 
+bool MMap::mapPrivate(void *Address [[maybe_unused]],
+                      uint64_t Offset [[maybe_unused]],
+                      uint64_t Size [[maybe_unused]],
+                      bool Executable [[maybe_unused]]) const noexcept {
+#if defined(HAVE_MMAP) && WASMEDGE_OS_LINUX
+  if (!Handle) {
+    return false;
+  }
+  const auto &Native = *reinterpret_cast<const Implement *>(Handle);
+  if (Offset > Native.Size || Size > Native.Size - Offset) {
+    return false;
+  }
+  // The executable mapping fails on the noexec mounts, and the caller falls
+  // back to copying.
+  const int Prot = PROT_READ | (Executable ? PROT_EXEC : PROT_WRITE);
+  return mmap(Address, Size, Prot, MAP_PRIVATE | MAP_FIXED, Native.File,
+              static_cast<off_t>(Offset)) != MAP_FAILED;
+#else
+  return false;
+#endif
+}
+
+uint64_t MMap::pageSize() noexcept {
+#if defined(HAVE_MMAP) && WASMEDGE_OS_LINUX
+  static const uint64_t Size = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+  return Size;
+#else
+  return 0;
+#endif
+}
+
 } // namespace WasmEdge
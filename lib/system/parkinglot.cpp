@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "system/parkinglot.h"
+
+#if WASMEDGE_OS_LINUX
+#include <cerrno>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace WasmEdge {
+
+#if WASMEDGE_OS_LINUX
+ParkingLot::ParkResult
+ParkingLot::wait(Bucket &B, Waiter &W,
+                 std::optional<Clock::time_point> Until) noexcept {
+  // The steady clock is the monotonic clock, which is used for the absolute
+  // timeout of FUTEX_WAIT_BITSET.
+  struct timespec Timeout;
+  if (Until) {
+    const auto Time = Until->time_since_epoch();
+    const auto Sec = std::chrono::duration_cast<std::chrono::seconds>(Time);
+    Timeout.tv_sec = static_cast<time_t>(Sec.count());
+    Timeout.tv_nsec = static_cast<long>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Time - Sec)
+            .count());
+  }
+  while (W.Word.load(std::memory_order_acquire) == 0) {
+    const long Res = syscall(SYS_futex, reinterpret_cast<uint32_t *>(&W.Word),
+                             FUTEX_WAIT_BITSET_PRIVATE, UINT32_C(0),
+                             Until ? &Timeout : nullptr, nullptr,
+                             FUTEX_BITSET_MATCH_ANY);
+    if (Res != 0 && errno == ETIMEDOUT) {
+      std::unique_lock<std::mutex> Lock(B.Mutex);
+      if (W.Word.load(std::memory_order_relaxed) == 0) {
+        B.dequeue(W);
+        return ParkResult::TimedOut;
+      }
+      break;
+    }
+  }
+  return ParkResult::Unparked;
+}
+
+void ParkingLot::wake(Waiter &W) noexcept {
+  // The waiter may return as soon as the word is set, while its stack is
+  // still mapped. A stale wake is only a spurious one for the futex waiters.
+  W.Word.store(1, std::memory_order_release);
+  syscall(SYS_futex, reinterpret_cast<uint32_t *>(&W.Word), FUTEX_WAKE_PRIVATE,
+          1);
+}
+#else
+ParkingLot::ParkResult
+ParkingLot::wait(Bucket &B, Waiter &W,
+                 std::optional<Clock::time_point> Until) noexcept {
+  std::unique_lock<std::mutex> Lock(B.Mutex);
+  while (!W.Unparked) {
+    if (!Until) {
+      W.Cond.wait(Lock);
+    } else if (W.Cond.wait_until(Lock, *Until) == std::cv_status::timeout &&
+               !W.Unparked) {
+      B.dequeue(W);
+      return ParkResult::TimedOut;
+    }
+  }
+  return ParkResult::Unparked;
+}
+
+void ParkingLot::wake(Waiter &W) noexcept {
+  // The waiter returns after the lock of the bucket is released.
+  W.Unparked = true;
+  W.Cond.notify_one();
+}
+#endif
+
+uint32_t ParkingLot::unpark(const void *Key, uint32_t Count) noexcept {
+  Bucket &B = getBucket(Key);
+  std::unique_lock<std::mutex> Lock(B.Mutex);
+  uint32_t Total = 0;
+  for (Waiter *W = B.Head; W != nullptr && Total < Count;) {
+    Waiter *Next = W->Next;
+    if (W->Key == Key) {
+      B.dequeue(*W);
+      wake(*W);
+      ++Total;
+    }
+    W = Next;
+  }
+  return Total;
+}
+
+void ParkingLot::unparkAll() noexcept {
+  for (auto &B : Buckets) {
+    std::unique_lock<std::mutex> Lock(B.Mutex);
+    while (B.Head != nullptr) {
+      Waiter *W = B.Head;
+      B.dequeue(*W);
+      wake(*W);
+    }
+  }
+}
+
+} // namespace WasmEdge
@@ -0,0 +1,149 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "system/threadpool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+namespace WasmEdge {
+
+thread_local ThreadPool *ThreadPool::CurrentPool = nullptr;
+thread_local uint32_t ThreadPool::CurrentIndex = 0;
+
+ThreadPool::ThreadPool(uint32_t Threads) : Queues(std::max(Threads, 1U)) {
+  Workers.reserve(Queues.size());
+  for (uint32_t I = 0; I < Queues.size(); ++I) {
+    Workers.emplace_back([this, I]() { work(I); });
+  }
+}
+
+ThreadPool::~ThreadPool() noexcept { stop(nullptr); }
+
+void ThreadPool::stop(const std::function<void()> &Interrupt) noexcept {
+  {
+    std::unique_lock<std::mutex> Lock(SleepMutex);
+    Stopped = true;
+  }
+  SleepCond.notify_all();
+  if (Interrupt) {
+    std::unique_lock<std::mutex> Lock(SleepMutex);
+    while (Unfinished > 0) {
+      Lock.unlock();
+      Interrupt();
+      Lock.lock();
+      IdleCond.wait_for(Lock, std::chrono::milliseconds(1),
+                        [this]() { return Unfinished == 0; });
+    }
+  }
+  for (auto &Worker : Workers) {
+    Worker.join();
+  }
+  Workers.clear();
+}
+
+void ThreadPool::submit(Task &&T) {
+  auto &Q = Queues[Next.fetch_add(1, std::memory_order_relaxed) %
+                   Queues.size()];
+  {
+    std::unique_lock<std::mutex> Lock(Q.Mutex);
+    Q.Tasks.push_back(std::move(T));
+  }
+  {
+    // Count under the sleep lock, so the sleeping workers are not missed.
+    std::unique_lock<std::mutex> Lock(SleepMutex);
+    Pending.fetch_add(1, std::memory_order_release);
+    ++Unfinished;
+  }
+  SleepCond.notify_one();
+}
+
+void ThreadPool::submit(std::vector<Task> &&Tasks) {
+  if (Tasks.empty()) {
+    return;
+  }
+  // Spread the tasks over the queues with one lock of each queue.
+  const auto Size = static_cast<uint32_t>(Queues.size());
+  const uint32_t Start =
+      Next.fetch_add(static_cast<uint32_t>(Tasks.size()),
+                     std::memory_order_relaxed);
+  for (uint32_t I = 0; I < std::min(Size, static_cast<uint32_t>(Tasks.size()));
+       ++I) {
+    auto &Q = Queues[(Start + I) % Size];
+    std::unique_lock<std::mutex> Lock(Q.Mutex);
+    for (size_t J = I; J < Tasks.size(); J += Size) {
+      Q.Tasks.push_back(std::move(Tasks[J]));
+    }
+  }
+  {
+    std::unique_lock<std::mutex> Lock(SleepMutex);
+    Pending.fetch_add(static_cast<int64_t>(Tasks.size()),
+                      std::memory_order_release);
+    Unfinished += Tasks.size();
+  }
+  SleepCond.notify_all();
+}
+
+std::optional<ThreadPool::Task> ThreadPool::take(uint32_t Index) noexcept {
+  // Take from the front of the own queue, and steal from the back of the
+  // others.
+  const auto Size = static_cast<uint32_t>(Queues.size());
+  for (uint32_t I = 0; I < Size; ++I) {
+    auto &Q = Queues[(Index + I) % Size];
+    std::unique_lock<std::mutex> Lock(Q.Mutex);
+    if (Q.Tasks.empty()) {
+      continue;
+    }
+    Task T;
+    if (I == 0) {
+      T = std::move(Q.Tasks.front());
+      Q.Tasks.pop_front();
+    } else {
+      T = std::move(Q.Tasks.back());
+      Q.Tasks.pop_back();
+    }
+    Pending.fetch_sub(1, std::memory_order_relaxed);
+    return T;
+  }
+  return std::nullopt;
+}
+
+void ThreadPool::run(Task &T) noexcept {
+  T();
+  std::unique_lock<std::mutex> Lock(SleepMutex);
+  if (--Unfinished == 0) {
+    IdleCond.notify_all();
+  }
+}
+
+bool ThreadPool::runQueuedTask() noexcept {
+  if (CurrentPool == nullptr) {
+    return false;
+  }
+  if (auto T = CurrentPool->take(CurrentIndex)) {
+    CurrentPool->run(*T);
+    return true;
+  }
+  return false;
+}
+
+void ThreadPool::work(uint32_t Index) noexcept {
+  CurrentPool = this;
+  CurrentIndex = Index;
+  while (true) {
+    if (auto T = take(Index)) {
+      run(*T);
+      continue;
+    }
+    std::unique_lock<std::mutex> Lock(SleepMutex);
+    SleepCond.wait(Lock, [this]() {
+      return Stopped || Pending.load(std::memory_order_acquire) > 0;
+    });
+    if (Stopped && Pending.load(std::memory_order_acquire) <= 0) {
+      return;
+    }
+  }
+}
+
+} // namespace WasmEdge
@@ -9,6 +9,7 @@
 #include <algorithm>
 #include <array>
 #include <cstdint>
+#include <limits>
 #include <tuple>
 
 namespace WasmEdge {
@@ -28,6 +29,7 @@ auto logOutOfRange(ErrCode Code, ErrInfo::IndexCategory Cate, uint32_t Idx,
 
 void FormChecker::reset(bool CleanGlobal) {
   ValStack.clear();
+  MaxHeight = 0;
   CtrlStack.clear();
   Locals.clear();
   Returns.clear();
@@ -36,7 +38,7 @@ void FormChecker::reset(bool CleanGlobal) {
     Types.clear();
     Funcs.clear();
     Tables.clear();
-    Mems = 0;
+    Mems.clear();
     Globals.clear();
     Datas.clear();
     Elems.clear();
@@ -84,7 +86,9 @@ void FormChecker::addTable(const AST::TableType &Tab) {
   Tables.push_back(Tab.getRefType());
 }
 
-void FormChecker::addMemory(const AST::MemoryType &) { Mems++; }
+void FormChecker::addMemory(const AST::MemoryType &Mem) {
+  Mems.push_back(Mem.getAddrType());
+}
 
 void FormChecker::addGlobal(const AST::GlobalType &Glob, const bool IsImport) {
   // Type in global is confirmed in loading phase.
@@ -202,16 +206,32 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
     return static_cast<uint32_t>(CtrlStack.size()) - UINT32_C(1) - N;
   };
 
-  // Helper lambda for checking memory index and perform transformation.
-  auto checkMemAndTrans = [this,
-                           &Instr](Span<const ValType> Take,
-                                   Span<const ValType> Put) -> Expect<void> {
-    if (Instr.getTargetIndex() >= Mems) {
+  // Helper lambda for checking memory index and perform transformation. The
+  // first `AddrNum` operands and the `AddrRes` result are the addresses, which
+  // are replaced by the address type of the memory.
+  auto checkMemAndTrans =
+      [this, &Instr](Span<const ValType> Take, Span<const ValType> Put,
+                     size_t AddrNum = 1, bool AddrRes = false) -> Expect<void> {
+    if (Instr.getTargetIndex() >= Mems.size()) {
       return logOutOfRange(ErrCode::Value::InvalidMemoryIdx,
                            ErrInfo::IndexCategory::Memory,
-                           Instr.getTargetIndex(), Mems);
-    }
-    return StackTrans(Take, Put);
+                           Instr.getTargetIndex(),
+                           static_cast<uint32_t>(Mems.size()));
+    }
+    const ValType AddrType = Mems[Instr.getTargetIndex()];
+    if (AddrType == TypeCode::I32) {
+      return StackTrans(Take, Put);
+    }
+    std::array<ValType, 4> TakeAddr, PutAddr;
+    assuming(Take.size() <= TakeAddr.size() && Put.size() <= PutAddr.size());
+    std::copy(Take.begin(), Take.end(), TakeAddr.begin());
+    std::copy(Put.begin(), Put.end(), PutAddr.begin());
+    std::fill_n(TakeAddr.begin(), std::min(AddrNum, Take.size()), AddrType);
+    if (AddrRes) {
+      PutAddr[0] = AddrType;
+    }
+    return StackTrans(Span<const ValType>(TakeAddr.data(), Take.size()),
+                      Span<const ValType>(PutAddr.data(), Put.size()));
   };
 
   // Helper lambda for checking lane index and perform transformation.
@@ -227,14 +247,15 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
   };
 
   // Helper lambda for checking memory alignment and perform transformation.
-  auto checkAlignAndTrans = [this, checkLaneAndTrans,
+  auto checkAlignAndTrans = [this, checkMemAndTrans,
                              &Instr](uint32_t N, Span<const ValType> Take,
                                      Span<const ValType> Put,
                                      bool CheckLane = false) -> Expect<void> {
-    if (Instr.getTargetIndex() >= Mems) {
+    if (Instr.getTargetIndex() >= Mems.size()) {
       return logOutOfRange(ErrCode::Value::InvalidMemoryIdx,
                            ErrInfo::IndexCategory::Memory,
-                           Instr.getTargetIndex(), Mems);
+                           Instr.getTargetIndex(),
+                           static_cast<uint32_t>(Mems.size()));
     }
     if (Instr.getMemoryAlign() > 31 ||
         (1UL << Instr.getMemoryAlign()) > (N >> 3UL)) {
@@ -244,10 +265,19 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
                                           Instr.getMemoryAlign()));
       return Unexpect(ErrCode::Value::InvalidAlignment);
     }
-    if (CheckLane) {
-      return checkLaneAndTrans(128 / N, Take, Put);
+    // The offset of the 32-bit memories is in the u32 range.
+    if (Mems[Instr.getTargetIndex()] == TypeCode::I32 &&
+        Instr.getMemoryOffset() > std::numeric_limits<uint32_t>::max()) {
+      spdlog::error(ErrCode::Value::InvalidMemOffset);
+      spdlog::error(ErrInfo::InfoBoundary(Instr.getMemoryOffset()));
+      return Unexpect(ErrCode::Value::InvalidMemOffset);
     }
-    return StackTrans(Take, Put);
+    if (CheckLane && Instr.getMemoryLane() >= 128 / N) {
+      return logOutOfRange(ErrCode::Value::InvalidLaneIdx,
+                           ErrInfo::IndexCategory::Lane, Instr.getMemoryLane(),
+                           128 / N);
+    }
+    return checkMemAndTrans(Take, Put);
   };
 
   // Helper lambda for checking value types matching.
@@ -1429,15 +1459,17 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
     return checkAlignAndTrans(
         32, {ValType(TypeCode::I32), ValType(TypeCode::I64)}, {});
   case OpCode::Memory__size:
-    return checkMemAndTrans({}, {ValType(TypeCode::I32)});
+    return checkMemAndTrans({}, {ValType(TypeCode::I32)}, 0, true);
   case OpCode::Memory__grow:
-    return checkMemAndTrans({ValType(TypeCode::I32)}, {ValType(TypeCode::I32)});
+    return checkMemAndTrans({ValType(TypeCode::I32)}, {ValType(TypeCode::I32)},
+                            1, true);
   case OpCode::Memory__init:
     // Check the target memory index. Memory index should be checked first.
-    if (Instr.getTargetIndex() >= Mems) {
+    if (Instr.getTargetIndex() >= Mems.size()) {
       return logOutOfRange(ErrCode::Value::InvalidMemoryIdx,
                            ErrInfo::IndexCategory::Memory,
-                           Instr.getTargetIndex(), Mems);
+                           Instr.getTargetIndex(),
+                           static_cast<uint32_t>(Mems.size()));
     }
     // Check the source data index.
     if (Instr.getSourceIndex() >= Datas.size()) {
@@ -1445,21 +1477,43 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
                            ErrInfo::IndexCategory::Data, Instr.getSourceIndex(),
                            static_cast<uint32_t>(Datas.size()));
     }
-    return StackTrans({ValType(TypeCode::I32), ValType(TypeCode::I32),
-                       ValType(TypeCode::I32)},
-                      {});
-  case OpCode::Memory__copy:
+    // The destination address is of the address type. The data offset and the
+    // length are i32.
+    return checkMemAndTrans({ValType(TypeCode::I32), ValType(TypeCode::I32),
+                             ValType(TypeCode::I32)},
+                            {});
+  case OpCode::Memory__copy: {
     /// Check the source memory index.
-    if (Instr.getSourceIndex() >= Mems) {
+    if (Instr.getSourceIndex() >= Mems.size()) {
       return logOutOfRange(ErrCode::Value::InvalidMemoryIdx,
                            ErrInfo::IndexCategory::Memory,
-                           Instr.getSourceIndex(), Mems);
+                           Instr.getSourceIndex(),
+                           static_cast<uint32_t>(Mems.size()));
     }
-    [[fallthrough]];
-  case OpCode::Memory__fill:
-    return checkMemAndTrans({ValType(TypeCode::I32), ValType(TypeCode::I32),
-                             ValType(TypeCode::I32)},
-                            {});
+    if (Instr.getTargetIndex() >= Mems.size()) {
+      return logOutOfRange(ErrCode::Value::InvalidMemoryIdx,
+                           ErrInfo::IndexCategory::Memory,
+                           Instr.getTargetIndex(),
+                           static_cast<uint32_t>(Mems.size()));
+    }
+    // The length is i64 only when both memories are 64-bit.
+    const ValType DstT = Mems[Instr.getTargetIndex()];
+    const ValType SrcT = Mems[Instr.getSourceIndex()];
+    const ValType LenT = (DstT == TypeCode::I64 && SrcT == TypeCode::I64)
+                             ? TypeCode::I64
+                             : TypeCode::I32;
+    return StackTrans({DstT, SrcT, LenT}, {});
+  }
+  case OpCode::Memory__fill: {
+    if (Instr.getTargetIndex() >= Mems.size()) {
+      return logOutOfRange(ErrCode::Value::InvalidMemoryIdx,
+                           ErrInfo::IndexCategory::Memory,
+                           Instr.getTargetIndex(),
+                           static_cast<uint32_t>(Mems.size()));
+    }
+    const ValType AddrT = Mems[Instr.getTargetIndex()];
+    return StackTrans({AddrT, ValType(TypeCode::I32), AddrT}, {});
+  }
   case OpCode::Data__drop:
     // Check the target data index.
     if (Instr.getTargetIndex() >= Datas.size()) {
@@ -2274,7 +2328,10 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
   }
 }
 
-void FormChecker::pushType(VType V) { ValStack.emplace_back(V); }
+void FormChecker::pushType(VType V) {
+  ValStack.emplace_back(V);
+  MaxHeight = std::max(MaxHeight, static_cast<uint32_t>(ValStack.size()));
+}
 
 void FormChecker::pushTypes(Span<const VType> Input) {
   for (auto Val : Input) {
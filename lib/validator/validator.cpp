@@ -4,16 +4,240 @@
 #include "validator/validator.h"
 
 #include "common/errinfo.h"
+#include "common/parallel.h"
+#include "common/spdlog.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <numeric>
 #include <string>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace WasmEdge {
 namespace Validator {
 
+namespace {
+
+// Binary numeric operators which cannot trap and can be fused.
+bool isFusibleBinOp(OpCode Code) noexcept {
+  switch (Code) {
+  case OpCode::I32__add:
+  case OpCode::I32__sub:
+  case OpCode::I32__mul:
+  case OpCode::I32__and:
+  case OpCode::I32__or:
+  case OpCode::I32__xor:
+  case OpCode::I32__shl:
+  case OpCode::I32__shr_s:
+  case OpCode::I32__shr_u:
+  case OpCode::I64__add:
+  case OpCode::I64__sub:
+  case OpCode::I64__mul:
+  case OpCode::I64__and:
+  case OpCode::I64__or:
+  case OpCode::I64__xor:
+  case OpCode::I64__shl:
+  case OpCode::I64__shr_s:
+  case OpCode::I64__shr_u:
+    return true;
+  default:
+    return false;
+  }
+}
+
+// Integer comparison operators which can be fused with the following br_if.
+bool isFusibleCompare(OpCode Code) noexcept {
+  switch (Code) {
+  case OpCode::I32__eqz:
+  case OpCode::I32__eq:
+  case OpCode::I32__ne:
+  case OpCode::I32__lt_s:
+  case OpCode::I32__lt_u:
+  case OpCode::I32__gt_s:
+  case OpCode::I32__gt_u:
+  case OpCode::I32__le_s:
+  case OpCode::I32__le_u:
+  case OpCode::I32__ge_s:
+  case OpCode::I32__ge_u:
+  case OpCode::I64__eqz:
+  case OpCode::I64__eq:
+  case OpCode::I64__ne:
+  case OpCode::I64__lt_s:
+  case OpCode::I64__lt_u:
+  case OpCode::I64__gt_s:
+  case OpCode::I64__gt_u:
+  case OpCode::I64__le_s:
+  case OpCode::I64__le_u:
+  case OpCode::I64__ge_s:
+  case OpCode::I64__ge_u:
+    return true;
+  default:
+    return false;
+  }
+}
+
+// Tag the superinstructions of a validated function body. The fused
+// sequences contain no control instructions except the trailing br_if, so no
+// branch or call can land in the middle of them.
+void fuseInstrs(AST::InstrView Instrs) noexcept {
+  using FusedKind = AST::Instruction::FusedKind;
+  auto Code = [&Instrs](size_t I) {
+    return I < Instrs.size() ? Instrs[I].getOpCode() : OpCode::End;
+  };
+  size_t I = 0;
+  while (I < Instrs.size()) {
+    auto &Instr = const_cast<AST::Instruction &>(Instrs[I]);
+    const OpCode Next = Code(I + 1);
+    if (Instr.getOpCode() == OpCode::Local__get &&
+        isFusibleBinOp(Code(I + 2))) {
+      if (Next == OpCode::Local__get) {
+        Instr.setFusedKind(FusedKind::LocalLocalBinOp);
+        I += 3;
+        continue;
+      }
+      if (Next == OpCode::I32__const || Next == OpCode::I64__const) {
+        if (Code(I + 3) == OpCode::Local__set ||
+            Code(I + 3) == OpCode::Local__tee) {
+          Instr.setFusedKind(FusedKind::LocalConstBinOpSet);
+          I += 4;
+        } else {
+          Instr.setFusedKind(FusedKind::LocalConstBinOp);
+          I += 3;
+        }
+        continue;
+      }
+    }
+    if (isFusibleCompare(Instr.getOpCode()) && Next == OpCode::Br_if) {
+      Instr.setFusedKind(FusedKind::CompareBrIf);
+      I += 2;
+      continue;
+    }
+    I++;
+  }
+}
+
+// Check the instruction can be a branch target or a landing of the handlers.
+bool isBranchTarget(OpCode Code) noexcept {
+  switch (Code) {
+  case OpCode::Loop:
+  case OpCode::Else:
+  case OpCode::End:
+  case OpCode::Catch:
+  case OpCode::Catch_all:
+  case OpCode::Delegate:
+    return true;
+  default:
+    return false;
+  }
+}
+
+// Check the instruction may not continue to the next one, or may change the
+// executing function.
+bool isBlockTerminator(OpCode Code) noexcept {
+  switch (Code) {
+  case OpCode::Unreachable:
+  case OpCode::If:
+  case OpCode::Else:
+  case OpCode::Try:
+  case OpCode::Catch:
+  case OpCode::Throw:
+  case OpCode::Rethrow:
+  case OpCode::Throw_ref:
+  case OpCode::End:
+  case OpCode::Br:
+  case OpCode::Br_if:
+  case OpCode::Br_table:
+  case OpCode::Return:
+  case OpCode::Call:
+  case OpCode::Call_indirect:
+  case OpCode::Return_call:
+  case OpCode::Return_call_indirect:
+  case OpCode::Call_ref:
+  case OpCode::Return_call_ref:
+  case OpCode::Delegate:
+  case OpCode::Catch_all:
+  case OpCode::Try_table:
+  case OpCode::Br_on_null:
+  case OpCode::Br_on_non_null:
+  case OpCode::Br_on_cast:
+  case OpCode::Br_on_cast_fail:
+    return true;
+  default:
+    return false;
+  }
+}
+
+// Mark the leaders of the basic blocks of a validated function body. The
+// branches only land on the structured instructions or on the ones following
+// a terminator, so every jump, call, and return continues at a leader.
+void markBlockLeaders(AST::InstrView Instrs) noexcept {
+  bool Leader = true;
+  for (auto &Instr : Instrs) {
+    const OpCode Code = Instr.getOpCode();
+    const_cast<AST::Instruction &>(Instr).setBlockLeader(Leader ||
+                                                         isBranchTarget(Code));
+    Leader = isBlockTerminator(Code);
+  }
+}
+
+// Validate the function body with the form checker of the module contexts.
+Expect<void>
+validateFunction(FormChecker &FuncChecker,
+                 Span<const std::pair<uint32_t, ValType>> Locals,
+                 AST::InstrView Instrs, const uint32_t TypeIdx) {
+  // Due to the validation of the function section, the type of index bust be a
+  // function type.
+  const auto &FuncType =
+      FuncChecker.getTypes()[TypeIdx]->getCompositeType().getFuncType();
+  // Reset stack in FormFuncChecker.
+  FuncChecker.reset();
+  // Add parameters into this frame.
+  for (auto &Type : FuncType.getParamTypes()) {
+    // Local passed as function parameters should be initialized.
+    FuncChecker.addLocal(Type, true);
+  }
+  // Add locals into this frame.
+  for (auto Val : Locals) {
+    for (uint32_t Cnt = 0; Cnt < Val.first; ++Cnt) {
+      // The local value type should be valid.
+      if (auto Res = FuncChecker.validate(Val.second); !Res) {
+        return Unexpect(Res);
+      }
+      FuncChecker.addLocal(Val.second, false);
+    }
+  }
+  // Validate function body expression.
+  if (auto Res = FuncChecker.validate(Instrs, FuncType.getReturnTypes());
+      !Res) {
+    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Expression));
+    return Unexpect(Res);
+  }
+  // Record the max operand stack height for the stack capacity check.
+  if (!Instrs.empty()) {
+    const_cast<AST::Instruction &>(Instrs.back())
+        .setStackHeight(FuncChecker.getMaxStackHeight());
+  }
+  // Tag the superinstructions and the basic blocks for the interpreter.
+  fuseInstrs(Instrs);
+  markBlockLeaders(Instrs);
+  return {};
+}
+
+} // namespace
+
+Validator::LazyContext::LazyContext(const FormChecker &ModChecker)
+    : Checker(ModChecker) {
+  auto &TypeVec = Checker.getTypes();
+  Types.reserve(TypeVec.size());
+  for (auto &Type : TypeVec) {
+    Types.push_back(std::make_unique<AST::SubType>(*Type));
+    Type = Types.back().get();
+  }
+}
+
 Expect<void> Validator::validate(const AST::Component::Component &Comp) {
   using namespace AST::Component;
 
@@ -37,8 +261,102 @@ Expect<void> Validator::validate(const AST::Component::Component &Comp) {
 // Validate Module. See "include/validator/validator.h".
 Expect<void> Validator::validate(const AST::Module &Mod) {
   // https://webassembly.github.io/spec/core/valid/modules.html
+  StreamMod = nullptr;
   Checker.reset(true);
 
+  // Validate the sections before the code section.
+  if (auto Res = validateSections(Mod); !Res) {
+    return Unexpect(Res);
+  }
+
+  // Validate data section which initialize memories.
+  if (auto Res = validate(Mod.getDataSection()); !Res) {
+    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Sec_Data));
+    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+    return Unexpect(Res);
+  }
+
+  // Validate code section and expressions.
+  if (auto Res = validate(Mod.getCodeSection()); !Res) {
+    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Sec_Code));
+    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+    return Unexpect(Res);
+  }
+
+  // Multiple tables is for the ReferenceTypes proposal.
+  if (Checker.getTables().size() > 1 &&
+      !Conf.hasProposal(Proposal::ReferenceTypes)) {
+    spdlog::error(ErrCode::Value::MultiTables);
+    spdlog::error(ErrInfo::InfoProposal(Proposal::ReferenceTypes));
+    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+    return Unexpect(ErrCode::Value::MultiTables);
+  }
+
+  // Multiple memories is for the MultiMemories proposal.
+  if (Checker.getMemories().size() > 1 &&
+      !Conf.hasProposal(Proposal::MultiMemories)) {
+    spdlog::error(ErrCode::Value::MultiMemories);
+    spdlog::error(ErrInfo::InfoProposal(Proposal::MultiMemories));
+    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+    return Unexpect(ErrCode::Value::MultiMemories);
+  }
+
+  // Set the validated flag.
+  const_cast<AST::Module &>(Mod).setIsValidated();
+  return {};
+}
+
+// Validate body while loading. See "include/validator/validator.h".
+Expect<void> Validator::validateCodeSegment(const AST::Module &Mod,
+                                            uint32_t Idx) {
+  // The errors are logged by the validation of the module instead.
+  Log::ScopedThreadLogOff LogOff;
+  if (Idx == 0) {
+    StreamMod = nullptr;
+    Checker.reset(true);
+    if (auto Res = validateSections(Mod); !Res) {
+      return Unexpect(Res);
+    }
+    // The data section comes after the code section, and the function bodies
+    // only need the count of the data segments.
+    if (const auto Count = Mod.getDataCountSection().getContent()) {
+      const AST::DataSegment DataSeg;
+      for (uint32_t I = 0; I < *Count; ++I) {
+        Checker.addData(DataSeg);
+      }
+    }
+    StreamMod = &Mod;
+    StreamIdx = 0;
+  }
+  if (StreamMod != &Mod || StreamIdx != Idx) {
+    return Unexpect(ErrCode::Value::WrongVMWorkflow);
+  }
+
+  // Stop at the first failed body. The validation of the module reports it.
+  StreamMod = nullptr;
+  const auto &CodeVec = Mod.getCodeSection().getContent();
+  const auto &FuncVec = Checker.getFunctions();
+  const uint32_t TId = Idx + Checker.getNumImportFuncs();
+  if (Idx >= CodeVec.size() || TId >= FuncVec.size()) {
+    return Unexpect(ErrCode::Value::InvalidFuncIdx);
+  }
+  const auto &CodeSeg = CodeVec[Idx];
+  if (CodeSeg.getLazyBody()) {
+    // The lazy loaded bodies are validated with the module contexts copied by
+    // the validation of the module.
+    return {};
+  }
+  if (auto Res = validate(Checker, CodeSeg, FuncVec[TId]); !Res) {
+    return Unexpect(Res);
+  }
+  const_cast<AST::CodeSegment &>(CodeSeg).setIsValidated();
+  StreamMod = &Mod;
+  ++StreamIdx;
+  return {};
+}
+
+// Validate sections before code. See "include/validator/validator.h".
+Expect<void> Validator::validateSections(const AST::Module &Mod) {
   // Validate and register type section.
   if (auto Res = validate(Mod.getTypeSection()); !Res) {
     spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Sec_Type));
@@ -108,40 +426,6 @@ Expect<void> Validator::validate(const AST::Module &Mod) {
     spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
     return Unexpect(Res);
   }
-
-  // Validate data section which initialize memories.
-  if (auto Res = validate(Mod.getDataSection()); !Res) {
-    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Sec_Data));
-    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
-    return Unexpect(Res);
-  }
-
-  // Validate code section and expressions.
-  if (auto Res = validate(Mod.getCodeSection()); !Res) {
-    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Sec_Code));
-    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
-    return Unexpect(Res);
-  }
-
-  // Multiple tables is for the ReferenceTypes proposal.
-  if (Checker.getTables().size() > 1 &&
-      !Conf.hasProposal(Proposal::ReferenceTypes)) {
-    spdlog::error(ErrCode::Value::MultiTables);
-    spdlog::error(ErrInfo::InfoProposal(Proposal::ReferenceTypes));
-    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
-    return Unexpect(ErrCode::Value::MultiTables);
-  }
-
-  // Multiple memories is for the MultiMemories proposal.
-  if (Checker.getMemories() > 1 && !Conf.hasProposal(Proposal::MultiMemories)) {
-    spdlog::error(ErrCode::Value::MultiMemories);
-    spdlog::error(ErrInfo::InfoProposal(Proposal::MultiMemories));
-    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
-    return Unexpect(ErrCode::Value::MultiMemories);
-  }
-
-  // Set the validated flag.
-  const_cast<AST::Module &>(Mod).setIsValidated();
   return {};
 }
 
@@ -235,11 +519,14 @@ Expect<void> Validator::validate(const AST::MemoryType &Mem) {
     spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Type_Limit));
     return Unexpect(Res);
   }
-  if (Lim.getMin() > LIMIT_MEMORYTYPE ||
-      (Lim.hasMax() && Lim.getMax() > LIMIT_MEMORYTYPE)) {
-    spdlog::error(ErrCode::Value::InvalidMemPages);
+  const uint64_t PageLimit = Lim.is64() ? LIMIT_MEMORY64TYPE : LIMIT_MEMORYTYPE;
+  if (Lim.getMin() > PageLimit ||
+      (Lim.hasMax() && Lim.getMax() > PageLimit)) {
+    const auto Code = Lim.is64() ? ErrCode::Value::InvalidMem64Pages
+                                 : ErrCode::Value::InvalidMemPages;
+    spdlog::error(Code);
     spdlog::error(ErrInfo::InfoLimit(Lim.hasMax(), Lim.getMin(), Lim.getMax()));
-    return Unexpect(ErrCode::Value::InvalidMemPages);
+    return Unexpect(Code);
   }
   return {};
 }
@@ -355,36 +642,43 @@ Expect<void> Validator::validate(const AST::ElementSegment &ElemSeg) {
 }
 
 // Validate Code segment. See "include/validator/validator.h".
-Expect<void> Validator::validate(const AST::CodeSegment &CodeSeg,
+Expect<void> Validator::validate(FormChecker &FuncChecker,
+                                 const AST::CodeSegment &CodeSeg,
                                  const uint32_t TypeIdx) {
-  // Due to the validation of the function section, the type of index bust be a
-  // function type.
-  const auto &FuncType =
-      Checker.getTypes()[TypeIdx]->getCompositeType().getFuncType();
-  // Reset stack in FormChecker.
-  Checker.reset();
-  // Add parameters into this frame.
-  for (auto &Type : FuncType.getParamTypes()) {
-    // Local passed as function parameters should be initialized.
-    Checker.addLocal(Type, true);
+  const auto &Lazy = CodeSeg.getLazyBody();
+  if (!Lazy) {
+    return validateFunction(FuncChecker, CodeSeg.getLocals(),
+                            CodeSeg.getExpr().getInstrs(), TypeIdx);
   }
-  // Add locals into this frame.
+
+  // For the lazy loaded body, validate the local types here, and the body
+  // after decoded at the first call.
   for (auto Val : CodeSeg.getLocals()) {
-    for (uint32_t Cnt = 0; Cnt < Val.first; ++Cnt) {
-      // The local value type should be valid.
-      if (auto Res = Checker.validate(Val.second); !Res) {
-        return Unexpect(Res);
-      }
-      Checker.addLocal(Val.second, false);
+    if (Val.first == 0) {
+      continue;
+    }
+    if (auto Res = FuncChecker.validate(Val.second); !Res) {
+      return Unexpect(Res);
     }
   }
-  // Validate function body expression.
-  if (auto Res = Checker.validate(CodeSeg.getExpr().getInstrs(),
-                                  FuncType.getReturnTypes());
-      !Res) {
-    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Expression));
-    return Unexpect(Res);
-  }
+  const_cast<AST::CodeSegment &>(CodeSeg).setLazyBody(
+      [Ctx = LazyCtx, Decode = Lazy,
+       Locals = std::vector(CodeSeg.getLocals().begin(),
+                            CodeSeg.getLocals().end()),
+       TypeIdx]() -> Expect<AST::Expression> {
+        auto Expr = Decode();
+        if (!Expr) {
+          return Unexpect(Expr);
+        }
+        std::unique_lock Lock(Ctx->Mutex);
+        if (auto Res = validateFunction(Ctx->Checker, Locals,
+                                        Expr->getInstrs(), TypeIdx);
+            !Res) {
+          spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Seg_Code));
+          return Unexpect(Res);
+        }
+        return Expr;
+      });
   return {};
 }
 
@@ -392,16 +686,17 @@ Expect<void> Validator::validate(const AST::CodeSegment &CodeSeg,
 Expect<void> Validator::validate(const AST::DataSegment &DataSeg) {
   if (DataSeg.getMode() == AST::DataSegment::DataMode::Active) {
     // Check memory index in context.
-    const auto &MemNum = Checker.getMemories();
+    const auto &MemVec = Checker.getMemories();
+    const uint32_t MemNum = static_cast<uint32_t>(MemVec.size());
     if (DataSeg.getIdx() >= MemNum) {
       spdlog::error(ErrCode::Value::InvalidMemoryIdx);
       spdlog::error(ErrInfo::InfoForbidIndex(ErrInfo::IndexCategory::Memory,
                                              DataSeg.getIdx(), MemNum));
       return Unexpect(ErrCode::Value::InvalidMemoryIdx);
     }
-    // Check memory initialization is a const expression.
+    // Check memory initialization is a const expression of the address type.
     if (auto Res = validateConstExpr(DataSeg.getExpr().getInstrs(),
-                                     {ValType(TypeCode::I32)});
+                                     {MemVec[DataSeg.getIdx()]});
         !Res) {
       spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Expression));
       return Unexpect(Res);
@@ -509,10 +804,11 @@ Expect<void> Validator::validate(const AST::ExportDesc &ExpDesc) {
     }
     return {};
   case ExternalType::Memory:
-    if (Id >= Checker.getMemories()) {
+    if (Id >= Checker.getMemories().size()) {
       spdlog::error(ErrCode::Value::InvalidMemoryIdx);
-      spdlog::error(ErrInfo::InfoForbidIndex(ErrInfo::IndexCategory::Memory, Id,
-                                             Checker.getMemories()));
+      spdlog::error(ErrInfo::InfoForbidIndex(
+          ErrInfo::IndexCategory::Memory, Id,
+          static_cast<uint32_t>(Checker.getMemories().size())));
       return Unexpect(ErrCode::Value::InvalidMemoryIdx);
     }
     return {};
@@ -672,6 +968,20 @@ Expect<void> Validator::validate(const AST::CodeSection &CodeSec) {
   const auto &CodeVec = CodeSec.getContent();
   const auto &FuncVec = Checker.getFunctions();
 
+  // The lazy loaded bodies share the copy of the module contexts. Only their
+  // local types are validated here.
+  LazyCtx.reset();
+  if (std::any_of(CodeVec.begin(), CodeVec.end(),
+                  [](const AST::CodeSegment &CodeSeg) {
+                    return static_cast<bool>(CodeSeg.getLazyBody());
+                  })) {
+    LazyCtx = std::make_shared<LazyContext>(Checker);
+  } else if (const uint32_t Threads =
+                 Conf.getRuntimeConfigure().getLoadThreads();
+             Threads > 1 && CodeVec.size() > 1) {
+    return validateParallel(CodeSec, Threads);
+  }
+
   // Validate function body.
   for (uint32_t Id = 0; Id < static_cast<uint32_t>(CodeVec.size()); ++Id) {
     // Added functions contains imported functions.
@@ -683,7 +993,10 @@ Expect<void> Validator::validate(const AST::CodeSection &CodeSec) {
                                    static_cast<uint32_t>(FuncVec.size())));
       return Unexpect(ErrCode::Value::InvalidFuncIdx);
     }
-    if (auto Res = validate(CodeVec[Id], FuncVec[TId]); !Res) {
+    if (CodeVec[Id].getIsValidated()) {
+      continue;
+    }
+    if (auto Res = validate(Checker, CodeVec[Id], FuncVec[TId]); !Res) {
       spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Seg_Code));
       return Unexpect(Res);
     }
@@ -691,6 +1004,87 @@ Expect<void> Validator::validate(const AST::CodeSection &CodeSec) {
   return {};
 }
 
+// Validate Code section in parallel. See "include/validator/validator.h".
+Expect<void> Validator::validateParallel(const AST::CodeSection &CodeSec,
+                                         uint32_t Threads) {
+  const auto &CodeVec = CodeSec.getContent();
+  const auto &FuncVec = Checker.getFunctions();
+  // Added functions contains imported functions. The segments without the
+  // function index are reported after the valid ones as the serial loop.
+  const uint32_t NumImportFuncs =
+      static_cast<uint32_t>(Checker.getNumImportFuncs());
+  const uint32_t FuncNum = static_cast<uint32_t>(FuncVec.size());
+  const uint32_t CodeNum =
+      std::min(static_cast<uint32_t>(CodeVec.size()),
+               FuncNum - std::min(FuncNum, NumImportFuncs));
+
+  // Split the segments into the contiguous chunks of similar byte sizes. More
+  // chunks than the threads balance the workers for the uneven functions.
+  uint64_t TotalSize = 0;
+  for (uint32_t Id = 0; Id < CodeNum; ++Id) {
+    TotalSize += CodeVec[Id].getSegSize();
+  }
+  const uint64_t ChunkSize =
+      std::max(TotalSize / (UINT64_C(4) * Threads), UINT64_C(1));
+  std::vector<uint32_t> Bounds = {0};
+  uint64_t Size = 0;
+  for (uint32_t Id = 0; Id < CodeNum; ++Id) {
+    if (Size >= ChunkSize) {
+      Bounds.push_back(Id);
+      Size = 0;
+    }
+    Size += CodeVec[Id].getSegSize();
+  }
+  Bounds.push_back(CodeNum);
+
+  // Every chunk is validated by a copy of the form checker with the module
+  // contexts. A chunk stops at its first error, or at the segments after any
+  // failed one. The first failed segment is always validated, so the reported
+  // error is the same as the serial validation.
+  const uint32_t ChunkNum = static_cast<uint32_t>(Bounds.size() - 1);
+  std::atomic<uint32_t> FailedIdx = CodeNum;
+  parallelFor(ChunkNum, Threads, [&](uint32_t C) {
+    // The chunks may fail in any order, so the errors are logged only by the
+    // validation again below.
+    Log::ScopedThreadLogOff LogOff;
+    FormChecker FuncChecker = Checker;
+    for (uint32_t Id = Bounds[C]; Id < Bounds[C + 1]; ++Id) {
+      uint32_t Failed = FailedIdx.load(std::memory_order_relaxed);
+      if (Id > Failed) {
+        return;
+      }
+      if (CodeVec[Id].getIsValidated()) {
+        continue;
+      }
+      if (auto Res =
+              validate(FuncChecker, CodeVec[Id], FuncVec[Id + NumImportFuncs]);
+          !Res) {
+        while (Id < Failed && !FailedIdx.compare_exchange_weak(Failed, Id)) {
+        }
+        return;
+      }
+    }
+  });
+
+  if (const uint32_t Failed = FailedIdx.load(std::memory_order_relaxed);
+      Failed < CodeNum) {
+    // Validate the first failed segment again on this thread to log the same
+    // error messages as the serial validation.
+    auto Res =
+        validate(Checker, CodeVec[Failed], FuncVec[Failed + NumImportFuncs]);
+    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Seg_Code));
+    return Unexpect(Res);
+  }
+  if (CodeNum < CodeVec.size()) {
+    const uint32_t TId = CodeNum + NumImportFuncs;
+    spdlog::error(ErrCode::Value::InvalidFuncIdx);
+    spdlog::error(ErrInfo::InfoForbidIndex(ErrInfo::IndexCategory::Function,
+                                           TId, FuncNum));
+    return Unexpect(ErrCode::Value::InvalidFuncIdx);
+  }
+  return {};
+}
+
 // Validate Data section. See "include/validator/validator.h".
 Expect<void> Validator::validate(const AST::DataSection &DataSec) {
   for (auto &DataSeg : DataSec.getContent()) {
@@ -0,0 +1,137 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "tierup.h"
+
+#include "common/spdlog.h"
+#include "llvm/compiler.h"
+#include "llvm/jit.h"
+
+namespace WasmEdge {
+namespace VM {
+
+using namespace std::literals;
+
+TierUpCompiler::TierUpCompiler(
+    const Configure &C, Executor::Executor &E, const AST::Module &M,
+    const Runtime::Instance::ModuleInstance &ModInst) noexcept
+    : Conf(C), ExecEngine(E), Mod(M), Requests(std::make_shared<Queue>()) {
+  for (const auto &ImpDesc : Mod.getImportSection().getContent()) {
+    if (ImpDesc.getExternalType() == ExternalType::Function) {
+      ++CodeOffset;
+    }
+  }
+  ModInst.getFuncInstances([this](auto Funcs) {
+    for (uint32_t I = CodeOffset; I < Funcs.size(); ++I) {
+      Requests->CodeIdx.emplace(Funcs[I], I - CodeOffset);
+    }
+  });
+  Worker = std::thread(&TierUpCompiler::run, this);
+  ExecEngine.registerTierUpFunction(
+      [Requests = Requests](const Runtime::Instance::FunctionInstance &Func) {
+        Requests->request(Func);
+      });
+}
+
+TierUpCompiler::~TierUpCompiler() noexcept {
+  ExecEngine.registerTierUpFunction({});
+  {
+    std::unique_lock Lock(Requests->Mutex);
+    Requests->Stopped = true;
+  }
+  Requests->Cond.notify_one();
+  Worker.join();
+}
+
+void TierUpCompiler::Queue::request(
+    const Runtime::Instance::FunctionInstance &Func) noexcept {
+  if (CodeIdx.find(&Func) == CodeIdx.end()) {
+    // The functions of the other modules are not handled.
+    return;
+  }
+  {
+    std::unique_lock Lock(Mutex);
+    if (Stopped) {
+      return;
+    }
+    Pending.push_back(&Func);
+  }
+  Cond.notify_one();
+}
+
+void TierUpCompiler::run() noexcept {
+  auto &Q = *Requests;
+  std::unique_lock Lock(Q.Mutex);
+  while (true) {
+    Q.Cond.wait(Lock, [&Q]() { return Q.Stopped || !Q.Pending.empty(); });
+    if (Q.Stopped) {
+      return;
+    }
+    auto Funcs = std::move(Q.Pending);
+    Q.Pending.clear();
+    Lock.unlock();
+    publish(Funcs);
+    Lock.lock();
+  }
+}
+
+void TierUpCompiler::publish(
+    Span<const Runtime::Instance::FunctionInstance *const> Funcs) noexcept {
+  if (Failed) {
+    return;
+  }
+  if (!Lib) {
+    // Only translate the module here. The functions are optimized and
+    // compiled one by one when requested.
+    spdlog::info("tier-up translation start"sv);
+    LLVM::Compiler Compiler(Conf);
+    LLVM::JIT JIT(Conf);
+    std::shared_ptr<Executable> Exec;
+    if (auto Res = Compiler.translate(Mod); !Res) {
+      const auto Err = static_cast<uint32_t>(Res.error());
+      spdlog::warn("Tier-up compilation failed. Error code: {}, keep "
+                   "interpreter mode."sv,
+                   Err);
+      Failed = true;
+      return;
+    } else if (auto Res2 = JIT.loadLazy(std::move(*Res)); !Res2) {
+      const auto Err = static_cast<uint32_t>(Res2.error());
+      spdlog::warn("Tier-up JIT failed. Error code: {}, keep interpreter "
+                   "mode."sv,
+                   Err);
+      Failed = true;
+      return;
+    } else {
+      Exec = std::move(*Res2);
+    }
+
+    // The compiled functions call into the runtime through the intrinsics
+    // table of the executor.
+    auto Intrinsics = Exec->getIntrinsics();
+    Wrappers = Exec->getTypes(Mod.getTypeSection().getContent().size());
+    if (unlikely(!Intrinsics)) {
+      spdlog::warn("Tier-up intrinsics table symbol not found, keep "
+                   "interpreter mode."sv);
+      Failed = true;
+      return;
+    }
+    *Intrinsics = &Executor::Executor::Intrinsics;
+    Lib = std::static_pointer_cast<LLVM::JITLibrary>(std::move(Exec));
+    spdlog::info("tier-up translation end"sv);
+  }
+
+  for (const auto *Func : Funcs) {
+    // Compile the requested functions one by one. Their callees are compiled
+    // through the lazy stubs at their first calls.
+    const uint32_t Idx = Requests->CodeIdx.at(Func);
+    auto Code = Lib->getCompiledCode(CodeOffset + Idx);
+    const uint32_t TypeIdx = Func->getTypeIndex();
+    if (!Code || TypeIdx >= Wrappers.size() || !Wrappers[TypeIdx]) {
+      continue;
+    }
+    Func->setTieredSymbol(std::move(Code), Wrappers[TypeIdx]);
+  }
+}
+
+} // namespace VM
+} // namespace WasmEdge
@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+#pragma once
+
+#include "ast/module.h"
+#include "common/configure.h"
+#include "common/executable.h"
+#include "executor/executor.h"
+#include "llvm/jit.h"
+#include "runtime/instance/module.h"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace WasmEdge {
+namespace VM {
+
+/// Tier-up compiler class. The hot functions reported by the executor are
+/// queued to a background thread. The module is translated and loaded by the
+/// lazy JIT at the first request, and only the partition of every requested
+/// function is compiled and published afterward. The executor callback is
+/// registered in the constructor and unregistered in the destructor, which
+/// waits for the running compilation.
+class TierUpCompiler {
+public:
+  TierUpCompiler(const Configure &Conf, Executor::Executor &ExecEngine,
+                 const AST::Module &Mod,
+                 const Runtime::Instance::ModuleInstance &ModInst) noexcept;
+  ~TierUpCompiler() noexcept;
+
+private:
+  /// Request queue shared with the executor callback, which may be invoked
+  /// after unregistered by the executing threads.
+  struct Queue {
+    /// Code indices of the functions defined in the module instance.
+    std::unordered_map<const Runtime::Instance::FunctionInstance *, uint32_t>
+        CodeIdx;
+    std::mutex Mutex;
+    std::condition_variable Cond;
+    std::vector<const Runtime::Instance::FunctionInstance *> Pending;
+    bool Stopped = false;
+
+    /// Queue the hot function. Invoked from the executing threads.
+    void request(const Runtime::Instance::FunctionInstance &Func) noexcept;
+  };
+
+  /// Background thread loop.
+  void run() noexcept;
+
+  /// Load the module and publish the queued functions.
+  void publish(
+      Span<const Runtime::Instance::FunctionInstance *const> Funcs) noexcept;
+
+  const Configure Conf;
+  Executor::Executor &ExecEngine;
+  const AST::Module &Mod;
+  /// Index of the first defined function, i.e. the imported function number.
+  uint32_t CodeOffset = 0;
+
+  /// \name Compilation results. Only accessed in the background thread.
+  /// @{
+  std::shared_ptr<LLVM::JITLibrary> Lib;
+  std::vector<Symbol<Executable::Wrapper>> Wrappers;
+  bool Failed = false;
+  /// @}
+
+  std::shared_ptr<Queue> Requests;
+  std::thread Worker;
+};
+
+} // namespace VM
+} // namespace WasmEdge
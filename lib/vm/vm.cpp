@@ -5,9 +5,19 @@
 
 #include "host/wasi/wasimodule.h"
 #include "plugin/plugin.h"
+#include "llvm/codegen.h"
 #include "llvm/compiler.h"
 #include "llvm/jit.h"
 
+#ifdef WASMEDGE_USE_LLVM
+#include "aot/blake3.h"
+#include "aot/cache.h"
+#include "aot/version.h"
+#include "loader/shared_library.h"
+#include "system/mmap.h"
+#include "tierup.h"
+#endif
+
 #include "host/mock/wasi_crypto_module.h"
 #include "host/mock/wasi_logging_module.h"
 #include "host/mock/wasi_nn_module.h"
@@ -15,6 +25,9 @@
 #include "host/mock/wasmedge_process_module.h"
 #include "host/mock/wasmedge_tensorflow_module.h"
 #include "host/mock/wasmedge_tensorflowlite_module.h"
+#include <algorithm>
+#include <array>
+#include <random>
 #include <variant>
 
 namespace WasmEdge {
@@ -34,6 +47,21 @@ createPluginModule(std::string_view PName, std::string_view MName) {
                 PName, MName);
   return std::make_unique<T>();
 }
+
+/// Prepare the asynchronous execution of the VM function, and submit it to
+/// the thread pool of the executor.
+template <typename... FArgsT, typename... ArgsT>
+Async<Expect<std::vector<std::pair<ValVariant, ValType>>>>
+submitAsync(Executor::Executor &ExecutorEngine, VM &TargetVM,
+            Expect<std::vector<std::pair<ValVariant, ValType>>> (VM::*FPtr)(
+                FArgsT...),
+            ArgsT &&...Args) {
+  ThreadPool::Task Task;
+  Async<Expect<std::vector<std::pair<ValVariant, ValType>>>> Result(
+      Task, FPtr, TargetVM, std::forward<ArgsT>(Args)...);
+  ExecutorEngine.submitAsync(std::move(Task));
+  return Result;
+}
 } // namespace
 
 VM::VM(const Configure &Conf)
@@ -300,12 +328,10 @@ VM::asyncRunWasmFile(const std::filesystem::path &Path, std::string_view Func,
   Expect<std::vector<std::pair<ValVariant, ValType>>> (VM::*FPtr)(
       const std::filesystem::path &, std::string_view, Span<const ValVariant>,
       Span<const ValType>) = &VM::runWasmFile;
-  return {FPtr,
-          *this,
-          std::filesystem::path(Path),
-          std::string(Func),
-          std::vector(Params.begin(), Params.end()),
-          std::vector(ParamTypes.begin(), ParamTypes.end())};
+  return submitAsync(ExecutorEngine, *this, FPtr, std::filesystem::path(Path),
+                     std::string(Func),
+                     std::vector(Params.begin(), Params.end()),
+                     std::vector(ParamTypes.begin(), ParamTypes.end()));
 }
 
 Async<Expect<std::vector<std::pair<ValVariant, ValType>>>>
@@ -315,12 +341,9 @@ VM::asyncRunWasmFile(Span<const Byte> Code, std::string_view Func,
   Expect<std::vector<std::pair<ValVariant, ValType>>> (VM::*FPtr)(
       Span<const Byte>, std::string_view, Span<const ValVariant>,
       Span<const ValType>) = &VM::runWasmFile;
-  return {FPtr,
-          *this,
-          Code,
-          std::string(Func),
-          std::vector(Params.begin(), Params.end()),
-          std::vector(ParamTypes.begin(), ParamTypes.end())};
+  return submitAsync(ExecutorEngine, *this, FPtr, Code, std::string(Func),
+                     std::vector(Params.begin(), Params.end()),
+                     std::vector(ParamTypes.begin(), ParamTypes.end()));
 }
 
 Async<Expect<std::vector<std::pair<ValVariant, ValType>>>>
@@ -330,19 +353,40 @@ VM::asyncRunWasmFile(const AST::Module &Module, std::string_view Func,
   Expect<std::vector<std::pair<ValVariant, ValType>>> (VM::*FPtr)(
       const AST::Module &, std::string_view, Span<const ValVariant>,
       Span<const ValType>) = &VM::runWasmFile;
-  return {FPtr,
-          *this,
-          Module,
-          std::string(Func),
-          std::vector(Params.begin(), Params.end()),
-          std::vector(ParamTypes.begin(), ParamTypes.end())};
+  return submitAsync(ExecutorEngine, *this, FPtr, Module, std::string(Func),
+                     std::vector(Params.begin(), Params.end()),
+                     std::vector(ParamTypes.begin(), ParamTypes.end()));
 }
 
 Expect<void> VM::unsafeLoadWasm(const std::filesystem::path &Path) {
+#ifdef WASMEDGE_USE_LLVM
+  if (Conf.getRuntimeConfigure().isEnableJIT() &&
+      Conf.getRuntimeConfigure().isEnableJITCache() && MMap::supported()) {
+    // Parse the WASM from the same mapped bytes hashed as the cache key, so
+    // that the key always describes the loaded module. The AOT compiled shared
+    // libraries are not compiled again and are loaded from the file below.
+    constexpr std::array<Byte, 4> WasmMagic = {0x00, 0x61, 0x73, 0x6D};
+    std::error_code Error;
+    const auto Size = std::filesystem::file_size(Path, Error);
+    if (!Error && Size >= WasmMagic.size()) {
+      MMap Map(Path);
+      const auto *Code = reinterpret_cast<const Byte *>(Map.address());
+      if (Code && std::equal(WasmMagic.begin(), WasmMagic.end(), Code)) {
+        auto Res = unsafeLoadWasm(Span<const Byte>(Code, Size));
+        if (!Res) {
+          spdlog::error(ErrInfo::InfoFile(Path));
+        }
+        return Res;
+      }
+    }
+  }
+#endif
   // If not load successfully, the previous status will be reserved.
   if (auto Res = LoaderEngine.parseWasmUnit(Path)) {
     if (std::holds_alternative<std::unique_ptr<AST::Module>>(*Res)) {
+      TierUp.reset();
       Mod = std::move(std::get<std::unique_ptr<AST::Module>>(*Res));
+      ModHash.reset();
     } else if (std::holds_alternative<
                    std::unique_ptr<AST::Component::Component>>(*Res)) {
       spdlog::error("component execution is not done yet.");
@@ -360,7 +404,17 @@ Expect<void> VM::unsafeLoadWasm(Span<const Byte> Code) {
   // If not load successfully, the previous status will be reserved.
   if (auto Res = LoaderEngine.parseWasmUnit(Code)) {
     if (std::holds_alternative<std::unique_ptr<AST::Module>>(*Res)) {
+      TierUp.reset();
       Mod = std::move(std::get<std::unique_ptr<AST::Module>>(*Res));
+      ModHash.reset();
+#ifdef WASMEDGE_USE_LLVM
+      if (Conf.getRuntimeConfigure().isEnableJIT() &&
+          Conf.getRuntimeConfigure().isEnableJITCache() && !Mod->getSymbol()) {
+        AOT::Blake3 Hasher;
+        Hasher.update(Code);
+        Hasher.finalize(ModHash.emplace());
+      }
+#endif
     } else if (std::holds_alternative<
                    std::unique_ptr<AST::Component::Component>>(*Res)) {
       spdlog::error("component execution is not done yet.");
@@ -375,7 +429,9 @@ Expect<void> VM::unsafeLoadWasm(Span<const Byte> Code) {
 }
 
 Expect<void> VM::unsafeLoadWasm(const AST::Module &Module) {
+  TierUp.reset();
   Mod = std::make_unique<AST::Module>(Module);
+  ModHash.reset();
   Stage = VMStage::Loaded;
   return {};
 }
@@ -401,17 +457,36 @@ Expect<void> VM::unsafeInstantiate() {
     return Unexpect(ErrCode::Value::WrongVMWorkflow);
   }
 
-  if (Mod) {
+  // The tier-up compiler refers to the functions of the active module
+  // instance which will be replaced.
+  TierUp.reset();
+  const bool Tiered = Mod &&
+                      Conf.getRuntimeConfigure().getTierUpThreshold() > 0 &&
+                      !Mod->getSymbol();
+#ifndef WASMEDGE_USE_LLVM
+  if (Tiered) {
+    spdlog::error("LLVM disabled, tiered execution is unsupported!");
+  }
+#endif
+
+  if (Mod && !Tiered) {
     if (Conf.getRuntimeConfigure().isEnableJIT() && !Mod->getSymbol()) {
 #ifdef WASMEDGE_USE_LLVM
       LLVM::Compiler Compiler(Conf);
       LLVM::JIT JIT(Conf);
-      if (auto Res = Compiler.compile(*Mod); !Res) {
+      const bool Lazy = Conf.getRuntimeConfigure().isEnableLazyJIT();
+      if (!Lazy && ModHash && unsafeLoadCachedExecutable()) {
+        // Loaded from the compiled module cache.
+      } else if (auto Res =
+                     Lazy ? Compiler.translate(*Mod) : Compiler.compile(*Mod);
+                 !Res) {
         const auto Err = static_cast<uint32_t>(Res.error());
         spdlog::error(
             "Compilation failed. Error code: {}, use interpreter mode instead."sv,
             Err);
-      } else if (auto Res2 = JIT.load(std::move(*Res)); !Res2) {
+      } else if (auto Res2 = Lazy ? JIT.loadLazy(std::move(*Res))
+                                  : JIT.load(std::move(*Res));
+                 !Res2) {
         const auto Err = static_cast<uint32_t>(Res2.error());
         spdlog::warn(
             "JIT failed. Error code: {}, use interpreter mode instead."sv, Err);
@@ -427,12 +502,89 @@ Expect<void> VM::unsafeInstantiate() {
   if (auto Res = ExecutorEngine.instantiateModule(StoreRef, *Mod.get())) {
     Stage = VMStage::Instantiated;
     ActiveModInst = std::move(*Res);
+#ifdef WASMEDGE_USE_LLVM
+    if (Tiered) {
+      // Start in the interpreter, and compile the hot functions in the
+      // background.
+      TierUp = std::make_shared<TierUpCompiler>(Conf, ExecutorEngine, *Mod,
+                                                *ActiveModInst);
+    }
+#endif
     return {};
   } else {
     return Unexpect(Res);
   }
 }
 
+#ifdef WASMEDGE_USE_LLVM
+Expect<void> VM::unsafeLoadCachedExecutable() {
+  LLVM::Compiler Compiler(Conf);
+  std::filesystem::path Path;
+  if (auto Res = AOT::Cache::getPath(*ModHash, AOT::Cache::StorageScope::Local,
+                                     "jit"sv, Compiler.fingerprint())) {
+    Path = std::move(*Res);
+    Path += WASMEDGE_LIB_EXTENSION;
+  } else {
+    return Unexpect(Res);
+  }
+
+  std::error_code Error;
+  const bool Cached = std::filesystem::exists(Path, Error);
+  std::filesystem::path LoadPath = Path;
+  if (!Cached) {
+    // Compile into a temporary file and publish it by renaming, so that the
+    // other processes sharing the cache never load a partial library. The
+    // WASM is not embedded, because the cached libraries are only loaded for
+    // the parsed modules.
+    std::filesystem::create_directories(Path.parent_path(), Error);
+    std::filesystem::path TmpPath = Path;
+    TmpPath.replace_extension(
+        fmt::format(".{:08x}{}"sv, std::random_device{}(),
+                    WASMEDGE_LIB_EXTENSION));
+    Configure CacheConf = Conf;
+    CacheConf.getCompilerConfigure().setOutputFormat(
+        CompilerConfigure::OutputFormat::Native);
+    LLVM::CodeGen CodeGen(CacheConf);
+    if (auto Res = Compiler.compile(*Mod); !Res) {
+      return Unexpect(Res);
+    } else if (auto Res2 = CodeGen.codegen({}, std::move(*Res), TmpPath);
+               !Res2) {
+      std::filesystem::remove(TmpPath, Error);
+      return Unexpect(Res2);
+    }
+    std::filesystem::rename(TmpPath, Path, Error);
+    if (Error) {
+      // Not to compile again, load the library from the temporary file.
+      spdlog::warn("Failed to publish the compiled module cache {}."sv,
+                   Path.u8string());
+      LoadPath = TmpPath;
+    }
+  }
+
+  auto Library = std::make_shared<Loader::SharedLibrary>();
+  auto Res = Library->load(LoadPath).and_then([&]() -> Expect<void> {
+    if (auto Version = Library->getVersion(); !Version) {
+      return Unexpect(Version);
+    } else if (*Version != AOT::kBinaryVersion) {
+      return Unexpect(ErrCode::Value::MalformedVersion);
+    }
+    return LoaderEngine.loadExecutable(*Mod, Library);
+  });
+  if (!Res && Cached) {
+    // Drop the broken cache entry to recompile it next time.
+    spdlog::warn("Invalid compiled module cache {}, removed."sv,
+                 Path.u8string());
+    Library.reset();
+    std::filesystem::remove(Path, Error);
+  }
+  if (LoadPath != Path) {
+    // The loaded library is kept after removing the temporary file.
+    std::filesystem::remove(LoadPath, Error);
+  }
+  return Res;
+}
+#endif
+
 Expect<std::vector<std::pair<ValVariant, ValType>>>
 VM::unsafeExecute(std::string_view Func, Span<const ValVariant> Params,
                   Span<const ValType> ParamTypes) {
@@ -488,9 +640,9 @@ VM::asyncExecute(std::string_view Func, Span<const ValVariant> Params,
   Expect<std::vector<std::pair<ValVariant, ValType>>> (VM::*FPtr)(
       std::string_view, Span<const ValVariant>, Span<const ValType>) =
       &VM::execute;
-  return {FPtr, *this, std::string(Func),
-          std::vector(Params.begin(), Params.end()),
-          std::vector(ParamTypes.begin(), ParamTypes.end())};
+  return submitAsync(ExecutorEngine, *this, FPtr, std::string(Func),
+                     std::vector(Params.begin(), Params.end()),
+                     std::vector(ParamTypes.begin(), ParamTypes.end()));
 }
 
 Async<Expect<std::vector<std::pair<ValVariant, ValType>>>>
@@ -500,16 +652,36 @@ VM::asyncExecute(std::string_view ModName, std::string_view Func,
   Expect<std::vector<std::pair<ValVariant, ValType>>> (VM::*FPtr)(
       std::string_view, std::string_view, Span<const ValVariant>,
       Span<const ValType>) = &VM::execute;
-  return {FPtr,
-          *this,
-          std::string(ModName),
-          std::string(Func),
-          std::vector(Params.begin(), Params.end()),
-          std::vector(ParamTypes.begin(), ParamTypes.end())};
+  return submitAsync(ExecutorEngine, *this, FPtr, std::string(ModName),
+                     std::string(Func),
+                     std::vector(Params.begin(), Params.end()),
+                     std::vector(ParamTypes.begin(), ParamTypes.end()));
+}
+
+std::vector<Async<Expect<std::vector<std::pair<ValVariant, ValType>>>>>
+VM::asyncExecuteBatch(Span<const AsyncInvocation> Invocations) {
+  Expect<std::vector<std::pair<ValVariant, ValType>>> (VM::*FPtr)(
+      std::string_view, Span<const ValVariant>, Span<const ValType>) =
+      &VM::execute;
+  std::vector<Async<Expect<std::vector<std::pair<ValVariant, ValType>>>>>
+      Results;
+  std::vector<ThreadPool::Task> Tasks(Invocations.size());
+  Results.reserve(Invocations.size());
+  for (size_t I = 0; I < Invocations.size(); ++I) {
+    const auto &Inv = Invocations[I];
+    Results.emplace_back(
+        Tasks[I], FPtr, *this, std::string(Inv.Func),
+        std::vector(Inv.Params.begin(), Inv.Params.end()),
+        std::vector(Inv.ParamTypes.begin(), Inv.ParamTypes.end()));
+  }
+  ExecutorEngine.submitAsync(std::move(Tasks));
+  return Results;
 }
 
 void VM::unsafeCleanup() {
+  TierUp.reset();
   Mod.reset();
+  ModHash.reset();
   ActiveModInst.reset();
   StoreRef.reset();
   RegModInsts.clear();
@@ -99,6 +99,21 @@ TEST(CacheTest, LocalKey) {
   EXPECT_EQ(Part.parent_path().filename().u8string(), "key"s);
 }
 
+TEST(CacheTest, Salt) {
+  const auto Path = WasmEdge::AOT::Cache::getPath(
+      {}, WasmEdge::AOT::Cache::StorageScope::Global, "key"s);
+  const auto SaltPath = WasmEdge::AOT::Cache::getPath(
+      {}, WasmEdge::AOT::Cache::StorageScope::Global, "key"s, "salt"sv);
+  const auto OtherSaltPath = WasmEdge::AOT::Cache::getPath(
+      {}, WasmEdge::AOT::Cache::StorageScope::Global, "key"s, "other"sv);
+  ASSERT_TRUE(Path);
+  ASSERT_TRUE(SaltPath);
+  ASSERT_TRUE(OtherSaltPath);
+  EXPECT_EQ(SaltPath->parent_path(), Path->parent_path());
+  EXPECT_NE(SaltPath->filename(), Path->filename());
+  EXPECT_NE(SaltPath->filename(), OtherSaltPath->filename());
+}
+
 } // namespace
 
 GTEST_API_ int main(int argc, char **argv) {
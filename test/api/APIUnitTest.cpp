@@ -6,6 +6,7 @@
 #include "wasmedge/wasmedge.h"
 
 #include <algorithm>
+#include <array>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
@@ -13,6 +14,8 @@
 #include <gtest/gtest.h>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #if WASMEDGE_OS_WINDOWS
@@ -665,12 +668,67 @@ TEST(APICoreTest, Configure) {
   WasmEdge_ConfigureSetMaxMemoryPage(Conf, 1234U);
   EXPECT_NE(WasmEdge_ConfigureGetMaxMemoryPage(ConfNull), 1234U);
   EXPECT_EQ(WasmEdge_ConfigureGetMaxMemoryPage(Conf), 1234U);
+  WasmEdge_ConfigureSetMemoryPoolSize(ConfNull, 16U);
+  WasmEdge_ConfigureSetMemoryPoolSize(Conf, 16U);
+  EXPECT_NE(WasmEdge_ConfigureGetMemoryPoolSize(ConfNull), 16U);
+  EXPECT_EQ(WasmEdge_ConfigureGetMemoryPoolSize(Conf), 16U);
+  WasmEdge_ConfigureSetTierUpThreshold(ConfNull, 100U);
+  WasmEdge_ConfigureSetTierUpThreshold(Conf, 100U);
+  EXPECT_NE(WasmEdge_ConfigureGetTierUpThreshold(ConfNull), 100U);
+  EXPECT_EQ(WasmEdge_ConfigureGetTierUpThreshold(Conf), 100U);
+  WasmEdge_ConfigureSetLoadThreads(ConfNull, 4U);
+  WasmEdge_ConfigureSetLoadThreads(Conf, 4U);
+  EXPECT_NE(WasmEdge_ConfigureGetLoadThreads(ConfNull), 4U);
+  EXPECT_EQ(WasmEdge_ConfigureGetLoadThreads(Conf), 4U);
+  WasmEdge_ConfigureSetAsyncThreads(ConfNull, 2U);
+  WasmEdge_ConfigureSetAsyncThreads(Conf, 2U);
+  EXPECT_NE(WasmEdge_ConfigureGetAsyncThreads(ConfNull), 2U);
+  EXPECT_EQ(WasmEdge_ConfigureGetAsyncThreads(Conf), 2U);
+  WasmEdge_ConfigureSetStackSize(ConfNull, UINT64_C(1) << 20);
+  WasmEdge_ConfigureSetStackSize(Conf, UINT64_C(1) << 20);
+  EXPECT_NE(WasmEdge_ConfigureGetStackSize(ConfNull), UINT64_C(1) << 20);
+  EXPECT_EQ(WasmEdge_ConfigureGetStackSize(Conf), UINT64_C(1) << 20);
+  WasmEdge_ConfigureSetEnableLazyJIT(ConfNull, true);
+  EXPECT_FALSE(WasmEdge_ConfigureIsEnableLazyJIT(Conf));
+  WasmEdge_ConfigureSetEnableLazyJIT(Conf, true);
+  EXPECT_FALSE(WasmEdge_ConfigureIsEnableLazyJIT(ConfNull));
+  EXPECT_TRUE(WasmEdge_ConfigureIsEnableLazyJIT(Conf));
+  WasmEdge_ConfigureSetEnableLazyJIT(Conf, false);
+  EXPECT_FALSE(WasmEdge_ConfigureIsEnableLazyJIT(Conf));
+  WasmEdge_ConfigureSetEnableLazyLoading(ConfNull, true);
+  EXPECT_FALSE(WasmEdge_ConfigureIsEnableLazyLoading(Conf));
+  WasmEdge_ConfigureSetEnableLazyLoading(Conf, true);
+  EXPECT_FALSE(WasmEdge_ConfigureIsEnableLazyLoading(ConfNull));
+  EXPECT_TRUE(WasmEdge_ConfigureIsEnableLazyLoading(Conf));
+  WasmEdge_ConfigureSetEnableIOUring(ConfNull, true);
+  EXPECT_FALSE(WasmEdge_ConfigureIsEnableIOUring(Conf));
+  WasmEdge_ConfigureSetEnableIOUring(Conf, true);
+  EXPECT_FALSE(WasmEdge_ConfigureIsEnableIOUring(ConfNull));
+  EXPECT_TRUE(WasmEdge_ConfigureIsEnableIOUring(Conf));
+  WasmEdge_ConfigureSetMaxIOUringBufferSize(ConfNull, 4096U);
+  WasmEdge_ConfigureSetMaxIOUringBufferSize(Conf, 4096U);
+  EXPECT_NE(WasmEdge_ConfigureGetMaxIOUringBufferSize(ConfNull), 4096U);
+  EXPECT_EQ(WasmEdge_ConfigureGetMaxIOUringBufferSize(Conf), 4096U);
   // Tests for force interpreter.
   WasmEdge_ConfigureSetForceInterpreter(ConfNull, true);
   EXPECT_EQ(WasmEdge_ConfigureIsForceInterpreter(Conf), false);
   WasmEdge_ConfigureSetForceInterpreter(Conf, true);
   EXPECT_NE(WasmEdge_ConfigureIsForceInterpreter(ConfNull), true);
   EXPECT_EQ(WasmEdge_ConfigureIsForceInterpreter(Conf), true);
+  // Tests for threaded interpreter.
+  WasmEdge_ConfigureSetEnableThreadedInterpreter(ConfNull, false);
+  EXPECT_EQ(WasmEdge_ConfigureIsEnableThreadedInterpreter(Conf), true);
+  WasmEdge_ConfigureSetEnableThreadedInterpreter(Conf, false);
+  EXPECT_EQ(WasmEdge_ConfigureIsEnableThreadedInterpreter(ConfNull), false);
+  EXPECT_EQ(WasmEdge_ConfigureIsEnableThreadedInterpreter(Conf), false);
+  WasmEdge_ConfigureSetEnableThreadedInterpreter(Conf, true);
+  // Tests for register interpreter.
+  WasmEdge_ConfigureSetEnableRegisterInterpreter(ConfNull, false);
+  EXPECT_EQ(WasmEdge_ConfigureIsEnableRegisterInterpreter(Conf), true);
+  WasmEdge_ConfigureSetEnableRegisterInterpreter(Conf, false);
+  EXPECT_EQ(WasmEdge_ConfigureIsEnableRegisterInterpreter(ConfNull), false);
+  EXPECT_EQ(WasmEdge_ConfigureIsEnableRegisterInterpreter(Conf), false);
+  WasmEdge_ConfigureSetEnableRegisterInterpreter(Conf, true);
   // Tests for AOT compiler configurations.
   WasmEdge_ConfigureCompilerSetOptimizationLevel(
       ConfNull, WasmEdge_CompilerOptimizationLevel_Os);
@@ -700,6 +758,13 @@ TEST(APICoreTest, Configure) {
   WasmEdge_ConfigureCompilerSetInterruptible(Conf, true);
   EXPECT_NE(WasmEdge_ConfigureCompilerIsInterruptible(ConfNull), true);
   EXPECT_EQ(WasmEdge_ConfigureCompilerIsInterruptible(Conf), true);
+  WasmEdge_ConfigureCompilerSetThreads(ConfNull, 4U);
+  WasmEdge_ConfigureCompilerSetThreads(Conf, 4U);
+  EXPECT_NE(WasmEdge_ConfigureCompilerGetThreads(ConfNull), 4U);
+  EXPECT_EQ(WasmEdge_ConfigureCompilerGetThreads(Conf), 4U);
+  WasmEdge_ConfigureCompilerSetThreads(Conf, 0U);
+  EXPECT_EQ(WasmEdge_ConfigureCompilerGetThreads(Conf),
+            std::max(std::thread::hardware_concurrency(), 1U));
   // Tests for Statistics configurations.
   WasmEdge_ConfigureStatisticsSetInstructionCounting(ConfNull, true);
   WasmEdge_ConfigureStatisticsSetInstructionCounting(Conf, true);
@@ -713,6 +778,10 @@ TEST(APICoreTest, Configure) {
   WasmEdge_ConfigureStatisticsSetTimeMeasuring(Conf, true);
   EXPECT_NE(WasmEdge_ConfigureStatisticsIsTimeMeasuring(ConfNull), true);
   EXPECT_EQ(WasmEdge_ConfigureStatisticsIsTimeMeasuring(Conf), true);
+  WasmEdge_ConfigureStatisticsSetBatchedMetering(ConfNull, true);
+  WasmEdge_ConfigureStatisticsSetBatchedMetering(Conf, true);
+  EXPECT_NE(WasmEdge_ConfigureStatisticsIsBatchedMetering(ConfNull), true);
+  EXPECT_EQ(WasmEdge_ConfigureStatisticsIsBatchedMetering(Conf), true);
   // Test to delete nullptr.
   WasmEdge_ConfigureDelete(ConfNull);
   EXPECT_TRUE(true);
@@ -1458,6 +1527,133 @@ TEST(APICoreTest, Validator) {
   WasmEdge_ConfigureDelete(Conf);
 }
 
+TEST(APICoreTest, LoaderAndValidatorWithThreads) {
+  WasmEdge_ConfigureContext *Conf = WasmEdge_ConfigureCreate();
+  WasmEdge_ConfigureContext *ThreadsConf = WasmEdge_ConfigureCreate();
+  WasmEdge_ConfigureSetLoadThreads(ThreadsConf, 4U);
+  WasmEdge_LoaderContext *Loader = WasmEdge_LoaderCreate(Conf);
+  WasmEdge_LoaderContext *ThreadsLoader = WasmEdge_LoaderCreate(ThreadsConf);
+  WasmEdge_ValidatorContext *Validator = WasmEdge_ValidatorCreate(Conf);
+  WasmEdge_ValidatorContext *ThreadsValidator =
+      WasmEdge_ValidatorCreate(ThreadsConf);
+
+  // Load, validate, and serialize the module with the loader and validator.
+  auto Run = [](WasmEdge_LoaderContext *L, WasmEdge_ValidatorContext *V,
+                const std::vector<uint8_t> &Buf) {
+    WasmEdge_ASTModuleContext *Mod = nullptr;
+    std::vector<uint8_t> Out;
+    WasmEdge_Result Res = WasmEdge_LoaderParseFromBuffer(
+        L, &Mod, Buf.data(), static_cast<uint32_t>(Buf.size()));
+    if (WasmEdge_ResultOK(Res)) {
+      Res = WasmEdge_ValidatorValidate(V, Mod);
+      WasmEdge_Bytes Bytes;
+      if (WasmEdge_ResultOK(
+              WasmEdge_LoaderSerializeASTModule(L, Mod, &Bytes))) {
+        Out.assign(Bytes.Buf, Bytes.Buf + Bytes.Length);
+        WasmEdge_BytesDelete(Bytes);
+      }
+      WasmEdge_ASTModuleDelete(Mod);
+    }
+    return std::make_pair(WasmEdge_ResultGetCode(Res), Out);
+  };
+
+  // The results should be the same as the serial loading and validation.
+  auto Expected = Run(Loader, Validator, TestWasm);
+  EXPECT_EQ(Expected.first, 0U);
+  EXPECT_EQ(Run(ThreadsLoader, ThreadsValidator, TestWasm), Expected);
+
+  // Run and capture the error logs without the timestamps.
+  auto RunWithLog = [&Run](WasmEdge_LoaderContext *L,
+                           WasmEdge_ValidatorContext *V,
+                           const std::vector<uint8_t> &Buf) {
+    testing::internal::CaptureStdout();
+    auto Res = Run(L, V, Buf);
+    const std::string Log = testing::internal::GetCapturedStdout();
+    std::string Msgs;
+    for (size_t Pos = 0; Pos < Log.size();) {
+      const size_t End = std::min(Log.find('\n', Pos), Log.size());
+      const size_t Begin = std::min(Log.find("] ", Pos), End);
+      Msgs.append(Log, Begin, End - Begin).push_back('\n');
+      Pos = End + 1;
+    }
+    return std::make_pair(Res, Msgs);
+  };
+
+  // The errors and the logs should be the same for the malformed and invalid
+  // modules, whichever chunks fail first.
+  std::vector<uint8_t> Buf = TestWasm;
+  for (size_t I = 8; I < Buf.size(); ++I) {
+    const uint8_t Byte = Buf[I];
+    const std::array<uint8_t, 4> Replaces = {
+        0x00U, 0x0BU, 0xFFU, static_cast<uint8_t>(Byte + 1U)};
+    for (const uint8_t Replaced : Replaces) {
+      Buf[I] = Replaced;
+      EXPECT_EQ(RunWithLog(ThreadsLoader, ThreadsValidator, Buf),
+                RunWithLog(Loader, Validator, Buf));
+    }
+    Buf[I] = Byte;
+  }
+
+  WasmEdge_ValidatorDelete(ThreadsValidator);
+  WasmEdge_ValidatorDelete(Validator);
+  WasmEdge_LoaderDelete(ThreadsLoader);
+  WasmEdge_LoaderDelete(Loader);
+  WasmEdge_ConfigureDelete(ThreadsConf);
+  WasmEdge_ConfigureDelete(Conf);
+}
+
+TEST(APICoreTest, VMWithLazyLoading) {
+  WasmEdge_ConfigureContext *Conf = WasmEdge_ConfigureCreate();
+  WasmEdge_ConfigureContext *LazyConf = WasmEdge_ConfigureCreate();
+  WasmEdge_ConfigureSetEnableLazyLoading(LazyConf, true);
+  WasmEdge_VMContext *VM = WasmEdge_VMCreate(Conf, nullptr);
+  WasmEdge_VMContext *LazyVM = WasmEdge_VMCreate(LazyConf, nullptr);
+  WasmEdge_String FuncName = WasmEdge_StringCreateByCString("fib");
+
+  // Call the function twice, and get the result codes and the returns.
+  auto Run = [&FuncName](WasmEdge_VMContext *V,
+                         const std::vector<uint8_t> &Buf) {
+    WasmEdge_Value P[1], R[1];
+    P[0] = WasmEdge_ValueGenI32(20);
+    R[0] = WasmEdge_ValueGenI32(0);
+    std::array<uint32_t, 2> Codes;
+    for (auto &Code : Codes) {
+      Code = WasmEdge_ResultGetCode(WasmEdge_VMRunWasmFromBuffer(
+          V, Buf.data(), static_cast<uint32_t>(Buf.size()), FuncName, P, 1, R,
+          1));
+    }
+    return std::make_pair(Codes, WasmEdge_ValueGetI32(R[0]));
+  };
+
+  // The valid function should be the same as the eager loading.
+  auto Expected = Run(VM, FibonacciWasm);
+  EXPECT_EQ(Expected.first[0], 0U);
+  EXPECT_EQ(Run(LazyVM, FibonacciWasm), Expected);
+
+  // The invalid or malformed body should be reported at the calls.
+  WasmEdge_LogOff();
+  std::vector<uint8_t> Buf = FibonacciWasm;
+  for (const uint8_t Replaced : {UINT8_C(0x92), UINT8_C(0x27)}) {
+    // Replace the i32.add instruction.
+    Buf[59] = Replaced;
+    EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMLoadWasmFromBuffer(
+        LazyVM, Buf.data(), static_cast<uint32_t>(Buf.size()))));
+    EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMValidate(LazyVM)));
+    EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMInstantiate(LazyVM)));
+    const auto Res = Run(LazyVM, Buf);
+    EXPECT_EQ(Res.first[0], Run(VM, Buf).first[0]);
+    EXPECT_NE(Res.first[0], 0U);
+    EXPECT_EQ(Res.first[1], Res.first[0]);
+  }
+  WasmEdge_LogSetErrorLevel();
+
+  WasmEdge_StringDelete(FuncName);
+  WasmEdge_VMDelete(LazyVM);
+  WasmEdge_VMDelete(VM);
+  WasmEdge_ConfigureDelete(LazyConf);
+  WasmEdge_ConfigureDelete(Conf);
+}
+
 TEST(APICoreTest, ExecutorWithStatistics) {
   // Create contexts
   WasmEdge_ConfigureContext *Conf = WasmEdge_ConfigureCreate();
@@ -1812,6 +2008,61 @@ TEST(APICoreTest, ExecutorWithStatistics) {
   WasmEdge_ModuleInstanceDelete(HostModWrap);
 }
 
+TEST(APICoreTest, ExecutorWithBatchedMetering) {
+  uint64_t Counts[2], Costs[2];
+  HexToFile(TestWasm, TPath);
+  for (uint32_t I = 0; I < 2; I++) {
+    WasmEdge_ConfigureContext *Conf = WasmEdge_ConfigureCreate();
+    WasmEdge_ConfigureStatisticsSetInstructionCounting(Conf, true);
+    WasmEdge_ConfigureStatisticsSetCostMeasuring(Conf, true);
+    WasmEdge_ConfigureStatisticsSetBatchedMetering(Conf, I == 1);
+    WasmEdge_StoreContext *Store = WasmEdge_StoreCreate();
+    WasmEdge_StatisticsContext *Stat = WasmEdge_StatisticsCreate();
+    WasmEdge_ExecutorContext *ExecCxt = WasmEdge_ExecutorCreate(Conf, Stat);
+    WasmEdge_ModuleInstanceContext *HostMod = createExternModule("extern");
+    WasmEdge_ModuleInstanceContext *HostModWrap =
+        createExternModule("extern-wrap", true);
+    EXPECT_TRUE(WasmEdge_ResultOK(
+        WasmEdge_ExecutorRegisterImport(ExecCxt, Store, HostMod)));
+    EXPECT_TRUE(WasmEdge_ResultOK(
+        WasmEdge_ExecutorRegisterImport(ExecCxt, Store, HostModWrap)));
+    WasmEdge_ASTModuleContext *Mod = loadModule(Conf, TPath);
+    EXPECT_TRUE(validateModule(Conf, Mod));
+    WasmEdge_ModuleInstanceContext *ModCxt = nullptr;
+    EXPECT_TRUE(WasmEdge_ResultOK(
+        WasmEdge_ExecutorInstantiate(ExecCxt, &ModCxt, Store, Mod)));
+    WasmEdge_ASTModuleDelete(Mod);
+
+    // Invoke functions
+    WasmEdge_String FuncName = WasmEdge_StringCreateByCString("func-mul-2");
+    WasmEdge_FunctionInstanceContext *FuncCxt =
+        WasmEdge_ModuleInstanceFindFunction(ModCxt, FuncName);
+    WasmEdge_StringDelete(FuncName);
+    WasmEdge_Value P[2], R[2];
+    P[0] = WasmEdge_ValueGenI32(123);
+    P[1] = WasmEdge_ValueGenI32(456);
+    EXPECT_TRUE(WasmEdge_ResultOK(
+        WasmEdge_ExecutorInvoke(ExecCxt, FuncCxt, P, 2, R, 2)));
+    EXPECT_EQ(246, WasmEdge_ValueGetI32(R[0]));
+    EXPECT_EQ(912, WasmEdge_ValueGetI32(R[1]));
+    Counts[I] = WasmEdge_StatisticsGetInstrCount(Stat);
+    Costs[I] = WasmEdge_StatisticsGetTotalCost(Stat);
+
+    WasmEdge_ConfigureDelete(Conf);
+    WasmEdge_ExecutorDelete(ExecCxt);
+    WasmEdge_StoreDelete(Store);
+    WasmEdge_StatisticsDelete(Stat);
+    WasmEdge_ModuleInstanceDelete(ModCxt);
+    WasmEdge_ModuleInstanceDelete(HostMod);
+    WasmEdge_ModuleInstanceDelete(HostModWrap);
+  }
+  // The batched metering charges the same on the completed executions.
+  EXPECT_GT(Counts[0], 0ULL);
+  EXPECT_EQ(Counts[0], Counts[1]);
+  EXPECT_GT(Costs[0], 0ULL);
+  EXPECT_EQ(Costs[0], Costs[1]);
+}
+
 TEST(APICoreTest, Store) {
   // Create contexts
   WasmEdge_ConfigureContext *Conf = WasmEdge_ConfigureCreate();
@@ -2249,12 +2500,58 @@ TEST(APICoreTest, Instance) {
       WasmEdge_MemoryInstanceGetData(MemCxt, DataGet.data(), 70000, 10)));
   EXPECT_EQ(DataGet, DataSet);
 
+  // Memory instance snapshot and reset
+  EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_WrongVMWorkflow,
+                         WasmEdge_MemoryInstanceSnapshot(nullptr)));
+  EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_WrongVMWorkflow,
+                         WasmEdge_MemoryInstanceResetToSnapshot(nullptr)));
+  EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_RuntimeError,
+                         WasmEdge_MemoryInstanceResetToSnapshot(MemCxt)));
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_MemoryInstanceSnapshot(MemCxt)));
+  std::vector<uint8_t> DataDirty(10, 0xFFU);
+  EXPECT_TRUE(WasmEdge_ResultOK(
+      WasmEdge_MemoryInstanceSetData(MemCxt, DataDirty.data(), 70000, 10)));
+  EXPECT_TRUE(WasmEdge_ResultOK(
+      WasmEdge_MemoryInstanceSetData(MemCxt, DataDirty.data(), 5000, 10)));
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_MemoryInstanceGrowPage(MemCxt, 1)));
+  EXPECT_EQ(WasmEdge_MemoryInstanceGetPageSize(MemCxt), 3U);
+  EXPECT_TRUE(
+      WasmEdge_ResultOK(WasmEdge_MemoryInstanceResetToSnapshot(MemCxt)));
+  EXPECT_EQ(WasmEdge_MemoryInstanceGetPageSize(MemCxt), 2U);
+  EXPECT_EQ(nullptr, WasmEdge_MemoryInstanceGetPointer(MemCxt, 140000, 10));
+  EXPECT_TRUE(WasmEdge_ResultOK(
+      WasmEdge_MemoryInstanceGetData(MemCxt, DataGet.data(), 70000, 10)));
+  EXPECT_EQ(DataGet, DataSet);
+  EXPECT_TRUE(WasmEdge_ResultOK(
+      WasmEdge_MemoryInstanceGetData(MemCxt, DataGet.data(), 5000, 10)));
+  EXPECT_EQ(DataGet, std::vector<uint8_t>(10, 0U));
+  EXPECT_TRUE(WasmEdge_ResultOK(
+      WasmEdge_MemoryInstanceGetData(MemCxt, DataGet.data(), 100, 10)));
+  EXPECT_EQ(DataGet, DataSet);
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_MemoryInstanceGrowPage(MemCxt, 1)));
+  EXPECT_TRUE(WasmEdge_ResultOK(
+      WasmEdge_MemoryInstanceGetData(MemCxt, DataGet.data(), 140000, 10)));
+  EXPECT_EQ(DataGet, std::vector<uint8_t>(10, 0U));
+
   // Memory instance deletion
   WasmEdge_MemoryInstanceDelete(nullptr);
   EXPECT_TRUE(true);
   WasmEdge_MemoryInstanceDelete(MemCxt);
   EXPECT_TRUE(true);
 
+  // Memory instance snapshot and reset of shared memory
+  MemType = WasmEdge_MemoryTypeCreate(WasmEdge_Limit{
+      /* HasMax */ true, /* Shared */ true, /* Min */ 1, /* Max */ 3});
+  MemCxt = WasmEdge_MemoryInstanceCreate(MemType);
+  WasmEdge_MemoryTypeDelete(MemType);
+  EXPECT_NE(MemCxt, nullptr);
+  EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_RuntimeError,
+                         WasmEdge_MemoryInstanceSnapshot(MemCxt)));
+  EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_RuntimeError,
+                         WasmEdge_MemoryInstanceResetToSnapshot(MemCxt)));
+  WasmEdge_MemoryInstanceDelete(MemCxt);
+  EXPECT_TRUE(true);
+
   // Global instance
   WasmEdge_GlobalInstanceContext *GlobCCxt, *GlobVCxt;
   WasmEdge_GlobalTypeContext *GlobCType, *GlobVType;
@@ -2920,6 +3217,26 @@ TEST(APICoreTest, Async) {
   EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_FuncNotFound,
                          WasmEdge_AsyncGet(Async, R, 2)));
   WasmEdge_AsyncDelete(Async);
+  // Batch of invocations
+  {
+    const WasmEdge_AsyncInvocation Invocations[2] = {{FuncName, P, 2},
+                                                     {FuncName2, P, 2}};
+    WasmEdge_Async *Asyncs[2] = {nullptr, nullptr};
+    WasmEdge_VMAsyncExecuteBatch(VM, Invocations, 2, Asyncs);
+    EXPECT_NE(Asyncs[0], nullptr);
+    EXPECT_NE(Asyncs[1], nullptr);
+    EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_AsyncGet(Asyncs[0], R, 2)));
+    EXPECT_EQ(246, WasmEdge_ValueGetI32(R[0]));
+    EXPECT_EQ(912, WasmEdge_ValueGetI32(R[1]));
+    EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_FuncNotFound,
+                           WasmEdge_AsyncGet(Asyncs[1], R, 2)));
+    WasmEdge_AsyncDelete(Asyncs[0]);
+    WasmEdge_AsyncDelete(Asyncs[1]);
+    // VM nullptr case
+    WasmEdge_VMAsyncExecuteBatch(nullptr, Invocations, 2, Asyncs);
+    EXPECT_EQ(Asyncs[0], nullptr);
+    EXPECT_EQ(Asyncs[1], nullptr);
+  }
   // Discard result
   R[0] = WasmEdge_ValueGenI32(0);
   R[1] = WasmEdge_ValueGenI32(0);
@@ -29,6 +29,7 @@
 #include <map>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -227,6 +228,847 @@ TEST(VM, MultipleVM) {
   EXPECT_TRUE(Result2);
 }
 
+// Module of the superinstructions:
+//   "add":   local.get 0, local.get 1, i32.add
+//   "sub5":  local.get 0, i32.const 5, i32.sub, local.set 1, local.get 1
+//   "shl3":  local.get 0, i32.const 3, i32.shl, local.tee 1, local.get 1,
+//            i32.add
+//   "sum":   sum the counter from 0 to n - 1 in a loop ended by
+//            local.get 0, i32.lt_u, br_if 0
+//   "clamp": return 1 if n < 10 else 2 by i32.lt_s, br_if out of a block
+//            with a result
+//   "step":  local.get 0, then add local 1 in a loop with a parameter until
+//            the value reaches 100, where the loop start is a branch target
+//            between the local.get and the i32.add
+//   "div":   local.get 0, local.get 1, i32.div_u, which may trap
+std::array<WasmEdge::Byte, 198> FusedWasm{
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x0c, 0x02, 0x60,
+    0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x60, 0x01, 0x7f, 0x01, 0x7f, 0x03, 0x08,
+    0x07, 0x00, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x07, 0x30, 0x07, 0x03,
+    0x61, 0x64, 0x64, 0x00, 0x00, 0x04, 0x73, 0x75, 0x62, 0x35, 0x00, 0x01,
+    0x04, 0x73, 0x68, 0x6c, 0x33, 0x00, 0x02, 0x03, 0x73, 0x75, 0x6d, 0x00,
+    0x03, 0x05, 0x63, 0x6c, 0x61, 0x6d, 0x70, 0x00, 0x04, 0x04, 0x73, 0x74,
+    0x65, 0x70, 0x00, 0x05, 0x03, 0x64, 0x69, 0x76, 0x00, 0x06, 0x0a, 0x72,
+    0x07, 0x07, 0x00, 0x20, 0x00, 0x20, 0x01, 0x6a, 0x0b, 0x0d, 0x01, 0x01,
+    0x7f, 0x20, 0x00, 0x41, 0x05, 0x6b, 0x21, 0x01, 0x20, 0x01, 0x0b, 0x0e,
+    0x01, 0x01, 0x7f, 0x20, 0x00, 0x41, 0x03, 0x74, 0x22, 0x01, 0x20, 0x01,
+    0x6a, 0x0b, 0x1c, 0x01, 0x02, 0x7f, 0x03, 0x40, 0x20, 0x02, 0x20, 0x01,
+    0x6a, 0x21, 0x02, 0x20, 0x01, 0x41, 0x01, 0x6a, 0x22, 0x01, 0x20, 0x00,
+    0x49, 0x0d, 0x00, 0x0b, 0x20, 0x02, 0x0b, 0x11, 0x00, 0x02, 0x7f, 0x41,
+    0x01, 0x20, 0x00, 0x41, 0x0a, 0x48, 0x0d, 0x00, 0x1a, 0x41, 0x02, 0x0b,
+    0x0b, 0x14, 0x00, 0x20, 0x00, 0x03, 0x01, 0x20, 0x01, 0x6a, 0x22, 0x00,
+    0x20, 0x00, 0x41, 0xe4, 0x00, 0x49, 0x0d, 0x00, 0x0b, 0x0b, 0x07, 0x00,
+    0x20, 0x00, 0x20, 0x01, 0x6e, 0x0b};
+
+TEST(Superinstruction, FuseTest) {
+  using FusedKind = WasmEdge::AST::Instruction::FusedKind;
+  WasmEdge::Configure Conf;
+  WasmEdge::Loader::Loader LoadEngine(Conf);
+  WasmEdge::Validator::Validator ValidEngine(Conf);
+  auto AST = LoadEngine.parseModule(FusedWasm);
+  ASSERT_TRUE(AST);
+  ASSERT_TRUE(ValidEngine.validate(**AST));
+  const auto &Codes = (*AST)->getCodeSection().getContent();
+  ASSERT_EQ(Codes.size(), 7U);
+  auto Kind = [&Codes](uint32_t Func, uint32_t Idx) {
+    return Codes[Func].getExpr().getInstrs()[Idx].getFusedKind();
+  };
+
+  // add
+  EXPECT_EQ(Kind(0, 0), FusedKind::LocalLocalBinOp);
+  // sub5, shl3
+  EXPECT_EQ(Kind(1, 0), FusedKind::LocalConstBinOpSet);
+  EXPECT_EQ(Kind(2, 0), FusedKind::LocalConstBinOpSet);
+  EXPECT_EQ(Kind(2, 4), FusedKind::None);
+  // sum
+  EXPECT_EQ(Kind(3, 1), FusedKind::LocalLocalBinOp);
+  EXPECT_EQ(Kind(3, 5), FusedKind::LocalConstBinOpSet);
+  EXPECT_EQ(Kind(3, 9), FusedKind::None);
+  EXPECT_EQ(Kind(3, 10), FusedKind::CompareBrIf);
+  // clamp
+  EXPECT_EQ(Kind(4, 2), FusedKind::None);
+  EXPECT_EQ(Kind(4, 4), FusedKind::CompareBrIf);
+  // step: the loop start inside the sequence prevents the fusion.
+  EXPECT_EQ(Kind(5, 0), FusedKind::None);
+  EXPECT_EQ(Kind(5, 2), FusedKind::None);
+  EXPECT_EQ(Kind(5, 7), FusedKind::CompareBrIf);
+  // div: the trapping operator is not fused.
+  EXPECT_EQ(Kind(6, 0), FusedKind::None);
+
+  // The branch targets of the fused br_if are resolved by the validator: the
+  // end of the block in clamp, and the start of the loop in step.
+  {
+    auto Instrs = Codes[4].getExpr().getInstrs();
+    const auto &BrIf = Instrs[5];
+    ASSERT_EQ(BrIf.getOpCode(), WasmEdge::OpCode::Br_if);
+    EXPECT_EQ((&BrIf + BrIf.getJump().PCOffset)->getOpCode(),
+              WasmEdge::OpCode::End);
+    EXPECT_EQ(&BrIf + BrIf.getJump().PCOffset, &Instrs[8]);
+  }
+  {
+    auto Instrs = Codes[5].getExpr().getInstrs();
+    const auto &BrIf = Instrs[8];
+    ASSERT_EQ(BrIf.getOpCode(), WasmEdge::OpCode::Br_if);
+    EXPECT_EQ(&BrIf + BrIf.getJump().PCOffset, &Instrs[1]);
+    EXPECT_EQ(Instrs[1].getOpCode(), WasmEdge::OpCode::Loop);
+  }
+}
+
+TEST(Superinstruction, ExecuteTest) {
+  // The instruction counting runs every instruction without the fusion, which
+  // is compared with the fused results.
+  WasmEdge::Configure FusedConf;
+  WasmEdge::Configure PlainConf;
+  PlainConf.getStatisticsConfigure().setInstructionCounting(true);
+  WasmEdge::VM::VM FusedVM(FusedConf);
+  WasmEdge::VM::VM PlainVM(PlainConf);
+  for (auto *VM : {&FusedVM, &PlainVM}) {
+    ASSERT_TRUE(VM->loadWasm(FusedWasm));
+    ASSERT_TRUE(VM->validate());
+    ASSERT_TRUE(VM->instantiate());
+  }
+
+  const std::vector<WasmEdge::ValType> I32x1 = {
+      WasmEdge::ValType(WasmEdge::TypeCode::I32)};
+  const std::vector<WasmEdge::ValType> I32x2 = {
+      WasmEdge::ValType(WasmEdge::TypeCode::I32),
+      WasmEdge::ValType(WasmEdge::TypeCode::I32)};
+  struct Case {
+    std::string_view Name;
+    std::vector<uint32_t> Params;
+    uint32_t Result;
+  };
+  const std::array<Case, 10> Cases = {{
+      {"add"sv, {3, 4}, 7},
+      {"add"sv, {UINT32_MAX, 2}, 1},
+      {"sub5"sv, {12}, 7},
+      {"shl3"sv, {5}, 80},
+      {"sum"sv, {10}, 45},
+      {"sum"sv, {1}, 0},
+      {"clamp"sv, {3}, 1},
+      {"clamp"sv, {30}, 2},
+      {"step"sv, {1, 7}, 106},
+      {"div"sv, {7, 2}, 3},
+  }};
+  for (const auto &C : Cases) {
+    std::vector<WasmEdge::ValVariant> Params(C.Params.begin(),
+                                             C.Params.end());
+    const auto &Types = C.Params.size() == 1 ? I32x1 : I32x2;
+    for (auto *VM : {&FusedVM, &PlainVM}) {
+      auto Res = VM->execute(C.Name, Params, Types);
+      ASSERT_TRUE(Res) << C.Name;
+      EXPECT_EQ((*Res)[0].first.get<uint32_t>(), C.Result) << C.Name;
+    }
+  }
+  for (auto *VM : {&FusedVM, &PlainVM}) {
+    auto Res = VM->execute(
+        "div",
+        {WasmEdge::ValVariant(UINT32_C(7)), WasmEdge::ValVariant(UINT32_C(0))},
+        I32x2);
+    ASSERT_FALSE(Res);
+    EXPECT_EQ(Res.error(), WasmEdge::ErrCode::Value::DivideByZero);
+  }
+}
+
+// Module of the memory64 proposal:
+//   (memory i64 1)
+//   "store":    (param i64 i32) i32.store at the i64 address
+//   "load":     (param i64) (result i32) i32.load at the i64 address
+//   "load_off": (param i64) (result i32) i32.load offset=0xFFFFFFFFFFFFFFF0
+//   "size":     (result i64) memory.size
+//   "grow":     (param i64) (result i64) memory.grow
+std::array<WasmEdge::Byte, 136> Memory64Wasm{
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x14, 0x04, 0x60,
+    0x02, 0x7e, 0x7f, 0x00, 0x60, 0x01, 0x7e, 0x01, 0x7f, 0x60, 0x00, 0x01,
+    0x7e, 0x60, 0x01, 0x7e, 0x01, 0x7e, 0x03, 0x06, 0x05, 0x00, 0x01, 0x01,
+    0x02, 0x03, 0x05, 0x03, 0x01, 0x04, 0x01, 0x07, 0x29, 0x05, 0x05, 0x73,
+    0x74, 0x6f, 0x72, 0x65, 0x00, 0x00, 0x04, 0x6c, 0x6f, 0x61, 0x64, 0x00,
+    0x01, 0x08, 0x6c, 0x6f, 0x61, 0x64, 0x5f, 0x6f, 0x66, 0x66, 0x00, 0x02,
+    0x04, 0x73, 0x69, 0x7a, 0x65, 0x00, 0x03, 0x04, 0x67, 0x72, 0x6f, 0x77,
+    0x00, 0x04, 0x0a, 0x30, 0x05, 0x09, 0x00, 0x20, 0x00, 0x20, 0x01, 0x36,
+    0x02, 0x00, 0x0b, 0x07, 0x00, 0x20, 0x00, 0x28, 0x02, 0x00, 0x0b, 0x10,
+    0x00, 0x20, 0x00, 0x28, 0x02, 0xf0, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0x01, 0x0b, 0x04, 0x00, 0x3f, 0x00, 0x0b, 0x06, 0x00, 0x20,
+    0x00, 0x40, 0x00, 0x0b};
+
+// Module loading with the i32 address from the 64-bit memory.
+std::array<WasmEdge::Byte, 38> Memory64InvalidWasm{
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x04, 0x01, 0x60,
+    0x00, 0x00, 0x03, 0x02, 0x01, 0x00, 0x05, 0x03, 0x01, 0x04, 0x01, 0x07,
+    0x01, 0x00, 0x0a, 0x0a, 0x01, 0x08, 0x00, 0x41, 0x00, 0x28, 0x02, 0x00,
+    0x1a, 0x0b};
+
+TEST(Memory64, AddressTest) {
+  // The 64-bit memory is malformed without the proposal.
+  {
+    WasmEdge::Configure Conf;
+    WasmEdge::VM::VM VM(Conf);
+    EXPECT_FALSE(VM.loadWasm(Memory64Wasm));
+  }
+
+  WasmEdge::Configure Conf;
+  Conf.addProposal(WasmEdge::Proposal::Memory64);
+  // The addresses of the 64-bit memory are i64.
+  {
+    WasmEdge::VM::VM VM(Conf);
+    ASSERT_TRUE(VM.loadWasm(Memory64InvalidWasm));
+    auto Res = VM.validate();
+    ASSERT_FALSE(Res);
+    EXPECT_EQ(Res.error(), WasmEdge::ErrCode::Value::TypeCheckFailed);
+  }
+
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(Memory64Wasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  const WasmEdge::ValType I32(WasmEdge::TypeCode::I32);
+  const WasmEdge::ValType I64(WasmEdge::TypeCode::I64);
+  auto Load = [&](std::string_view Func, uint64_t Addr) {
+    return VM.execute(Func, {WasmEdge::ValVariant(Addr)}, {I64});
+  };
+  auto Size = [&]() {
+    auto Res = VM.execute("size");
+    EXPECT_TRUE(Res);
+    return (*Res)[0].first.get<uint64_t>();
+  };
+
+  // Store and load at the end of the memory.
+  ASSERT_TRUE(VM.execute("store",
+                         {WasmEdge::ValVariant(UINT64_C(65532)),
+                          WasmEdge::ValVariant(UINT32_C(0x12345678))},
+                         {I64, I32}));
+  auto Res = Load("load", 65532);
+  ASSERT_TRUE(Res);
+  EXPECT_EQ((*Res)[0].first.get<uint32_t>(), UINT32_C(0x12345678));
+
+  // The out of bounds addresses trap, and are not truncated to 32 bits.
+  Res = Load("load", 65533);
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), WasmEdge::ErrCode::Value::MemoryOutOfBounds);
+  Res = Load("load", UINT64_C(0x100000000));
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), WasmEdge::ErrCode::Value::MemoryOutOfBounds);
+  Res = Load("load", UINT64_MAX);
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), WasmEdge::ErrCode::Value::MemoryOutOfBounds);
+
+  // The effective address overflowing 64 bits traps.
+  Res = Load("load_off", 0x10);
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), WasmEdge::ErrCode::Value::MemoryOutOfBounds);
+  Res = Load("load_off", 0x20);
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), WasmEdge::ErrCode::Value::MemoryOutOfBounds);
+
+  // The page counts are i64.
+  EXPECT_EQ(Size(), 1U);
+  Res = VM.execute("grow", {WasmEdge::ValVariant(UINT64_C(1))}, {I64});
+  ASSERT_TRUE(Res);
+  EXPECT_EQ((*Res)[0].first.get<uint64_t>(), 1U);
+  EXPECT_EQ(Size(), 2U);
+  Res = Load("load", 65536);
+  ASSERT_TRUE(Res);
+  EXPECT_EQ((*Res)[0].first.get<uint32_t>(), 0U);
+  Res = VM.execute("grow", {WasmEdge::ValVariant(UINT64_C(1) << 48)}, {I64});
+  ASSERT_TRUE(Res);
+  EXPECT_EQ((*Res)[0].first.get<uint64_t>(), UINT64_MAX);
+}
+
+// Module of the gas metering:
+//   (global $counter (export "counter") (mut i32) (i32.const 0))
+//   "spin":  loop { global.set $counter (global.get $counter + 1); br 0 }
+//   "count": (param $n i32) increase $counter for $n iterations of a loop
+std::array<WasmEdge::Byte, 107> GasWasm{
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x08, 0x02, 0x60,
+    0x00, 0x00, 0x60, 0x01, 0x7f, 0x00, 0x03, 0x03, 0x02, 0x00, 0x01, 0x06,
+    0x06, 0x01, 0x7f, 0x01, 0x41, 0x00, 0x0b, 0x07, 0x1a, 0x03, 0x04, 0x73,
+    0x70, 0x69, 0x6e, 0x00, 0x00, 0x05, 0x63, 0x6f, 0x75, 0x6e, 0x74, 0x00,
+    0x01, 0x07, 0x63, 0x6f, 0x75, 0x6e, 0x74, 0x65, 0x72, 0x03, 0x00, 0x0a,
+    0x2e, 0x02, 0x0e, 0x00, 0x03, 0x40, 0x23, 0x00, 0x41, 0x01, 0x6a, 0x24,
+    0x00, 0x0c, 0x00, 0x0b, 0x0b, 0x1d, 0x00, 0x02, 0x40, 0x03, 0x40, 0x20,
+    0x00, 0x45, 0x0d, 0x01, 0x23, 0x00, 0x41, 0x01, 0x6a, 0x24, 0x00, 0x20,
+    0x00, 0x41, 0x01, 0x6b, 0x21, 0x00, 0x0c, 0x00, 0x0b, 0x0b, 0x0b};
+
+TEST(Metering, CostLimitTest) {
+  // The cost of every instruction is 1 by default. Check the loops under the
+  // per-instruction and the batched metering with the same limit.
+  std::array<uint32_t, 2> Counters;
+  for (uint32_t Batched = 0; Batched < 2; ++Batched) {
+    WasmEdge::Configure Conf;
+    Conf.getStatisticsConfigure().setCostMeasuring(true);
+    Conf.getStatisticsConfigure().setBatchedMetering(Batched == 1);
+    Conf.getStatisticsConfigure().setCostLimit(1000);
+    WasmEdge::VM::VM VM(Conf);
+    ASSERT_TRUE(VM.loadWasm(GasWasm));
+    ASSERT_TRUE(VM.validate());
+    ASSERT_TRUE(VM.instantiate());
+    const auto *Counter = VM.getActiveModule()->findGlobalExports("counter");
+    ASSERT_NE(Counter, nullptr);
+
+    // The loop in the limit finishes with the same cost in both modes.
+    auto Res = VM.execute("count", {WasmEdge::ValVariant(UINT32_C(10))},
+                          {WasmEdge::ValType(WasmEdge::TypeCode::I32)});
+    ASSERT_TRUE(Res);
+    EXPECT_EQ(Counter->getValue().get<uint32_t>(), 10U);
+    EXPECT_EQ(VM.getStatistics().getTotalCost(), 139U);
+
+    // The endless loop traps when the limit is reached.
+    VM.getStatistics().clear();
+    Res = VM.execute("spin");
+    ASSERT_FALSE(Res);
+    EXPECT_EQ(Res.error(), WasmEdge::ErrCode::Value::CostLimitExceeded);
+    EXPECT_LE(VM.getStatistics().getTotalCost(), 1000U);
+    Counters[Batched] = Counter->getValue().get<uint32_t>() - 10U;
+  }
+  // Each iteration costs 6. The per-instruction metering traps at the
+  // instruction exceeding the limit, and the batched metering traps at the
+  // next loop header, which runs at most the rest of the iteration more.
+  EXPECT_EQ(Counters[0], 166U);
+  EXPECT_GE(Counters[1], Counters[0]);
+  EXPECT_LE(Counters[1], Counters[0] + 1);
+}
+
+TEST(Metering, BlockCostTest) {
+  // The batched metering charges the basic blocks with the costs resolved from
+  // the cost table, and resolves them again after the table is replaced by a
+  // different one.
+  WasmEdge::Configure Conf;
+  Conf.getStatisticsConfigure().setInstructionCounting(true);
+  Conf.getStatisticsConfigure().setCostMeasuring(true);
+  Conf.getStatisticsConfigure().setBatchedMetering(true);
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(GasWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+
+  auto Res = VM.execute("count", {WasmEdge::ValVariant(UINT32_C(10))},
+                        {WasmEdge::ValType(WasmEdge::TypeCode::I32)});
+  ASSERT_TRUE(Res);
+  // The constant expression of the global initialization costs 2 more.
+  EXPECT_EQ(VM.getStatistics().getInstrCount(), 139U);
+  EXPECT_EQ(VM.getStatistics().getTotalCost(), 139U);
+
+  std::vector<uint64_t> CostTab(UINT16_MAX + 1, 2);
+  CostTab[uint16_t(WasmEdge::OpCode::Br)] = 10;
+  VM.getStatistics().setCostTable(CostTab);
+  VM.getStatistics().clear();
+  Res = VM.execute("count", {WasmEdge::ValVariant(UINT32_C(10))},
+                   {WasmEdge::ValType(WasmEdge::TypeCode::I32)});
+  ASSERT_TRUE(Res);
+  // The 10 iterations run the br once each.
+  EXPECT_EQ(VM.getStatistics().getInstrCount(), 137U);
+  EXPECT_EQ(VM.getStatistics().getTotalCost(), 137U * 2 + 10 * 8);
+
+  // The identical tables share the resolved costs, and the tables beyond the
+  // resolved ones are charged per instruction with the same results.
+  for (uint64_t Round = 0; Round < 2; ++Round) {
+    for (uint64_t Cost = 1; Cost <= 8; ++Cost) {
+      VM.getStatistics().setCostTable(
+          std::vector<uint64_t>(UINT16_MAX + 1, Cost));
+      VM.getStatistics().clear();
+      Res = VM.execute("count", {WasmEdge::ValVariant(UINT32_C(10))},
+                       {WasmEdge::ValType(WasmEdge::TypeCode::I32)});
+      ASSERT_TRUE(Res);
+      EXPECT_EQ(VM.getStatistics().getInstrCount(), 137U);
+      EXPECT_EQ(VM.getStatistics().getTotalCost(), 137U * Cost);
+    }
+  }
+}
+
+// Module of the GC objects:
+//   (type $node (struct (field (mut i32)) (field (mut (ref null $node)))))
+//   (type $bytes (array (mut i8)))
+//   (global $kept (mut (ref null $node)) (ref.null $node))
+//   "build": build a list of the nodes with the values from n to 1.
+//   "churn": allocate n garbage byte arrays and nodes while holding a node in
+//            a local, and return the value of the held node, which is 7.
+//   "keep": build the list of n nodes into the global $kept.
+//   "sumg": sum the values of the list in the global $kept.
+std::array<WasmEdge::Byte, 256> GCWasm{
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x20, 0x06, 0x5f,
+    0x02, 0x7f, 0x01, 0x63, 0x00, 0x01, 0x60, 0x01, 0x7f, 0x01, 0x63, 0x00,
+    0x60, 0x01, 0x7f, 0x01, 0x7f, 0x5e, 0x78, 0x01, 0x60, 0x01, 0x63, 0x6b,
+    0x01, 0x7f, 0x60, 0x00, 0x01, 0x7f, 0x03, 0x06, 0x05, 0x01, 0x02, 0x04,
+    0x02, 0x05, 0x06, 0x07, 0x01, 0x63, 0x00, 0x01, 0xd0, 0x00, 0x0b, 0x07,
+    0x1f, 0x04, 0x05, 0x62, 0x75, 0x69, 0x6c, 0x64, 0x00, 0x00, 0x05, 0x63,
+    0x68, 0x75, 0x72, 0x6e, 0x00, 0x01, 0x04, 0x6b, 0x65, 0x65, 0x70, 0x00,
+    0x03, 0x04, 0x73, 0x75, 0x6d, 0x67, 0x00, 0x04, 0x0a, 0xa1, 0x01, 0x05,
+    0x24, 0x01, 0x01, 0x63, 0x00, 0x02, 0x40, 0x03, 0x40, 0x20, 0x00, 0x45,
+    0x0d, 0x01, 0x20, 0x00, 0x20, 0x01, 0xfb, 0x00, 0x00, 0x21, 0x01, 0x20,
+    0x00, 0x41, 0x01, 0x6b, 0x21, 0x00, 0x0c, 0x00, 0x0b, 0x0b, 0x20, 0x01,
+    0x0b, 0x37, 0x01, 0x01, 0x63, 0x00, 0x41, 0x07, 0xd0, 0x00, 0xfb, 0x00,
+    0x00, 0x21, 0x01, 0x02, 0x40, 0x03, 0x40, 0x20, 0x00, 0x45, 0x0d, 0x01,
+    0x41, 0xe4, 0x00, 0xfb, 0x07, 0x03, 0x1a, 0x41, 0x01, 0xd0, 0x00, 0xfb,
+    0x00, 0x00, 0x1a, 0x20, 0x00, 0x41, 0x01, 0x6b, 0x21, 0x00, 0x0c, 0x00,
+    0x0b, 0x0b, 0x20, 0x01, 0xfb, 0x02, 0x00, 0x00, 0x0b, 0x30, 0x02, 0x01,
+    0x63, 0x00, 0x01, 0x7f, 0x20, 0x00, 0xfb, 0x17, 0x00, 0x21, 0x01, 0x02,
+    0x40, 0x03, 0x40, 0x20, 0x01, 0xd1, 0x0d, 0x01, 0x20, 0x02, 0x20, 0x01,
+    0xfb, 0x02, 0x00, 0x00, 0x6a, 0x21, 0x02, 0x20, 0x01, 0xfb, 0x02, 0x00,
+    0x01, 0x21, 0x01, 0x0c, 0x00, 0x0b, 0x0b, 0x20, 0x02, 0x0b, 0x0a, 0x00,
+    0x20, 0x00, 0x10, 0x00, 0x24, 0x00, 0x41, 0x00, 0x0b, 0x06, 0x00, 0x23,
+    0x00, 0x10, 0x02, 0x0b};
+
+TEST(GC, CollectTest) {
+  WasmEdge::Configure Conf;
+  Conf.addProposal(WasmEdge::Proposal::GC);
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(GCWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  auto &GC = WasmEdge::Executor::Collector::getInstance();
+  const auto Before = GC.getStatistics();
+
+  ASSERT_TRUE(VM.execute("keep", {WasmEdge::ValVariant(UINT32_C(1000))},
+                         {WasmEdge::ValType(WasmEdge::TypeCode::I32)}));
+  // The returned list is kept by the host in a root.
+  auto List = VM.execute("build", {WasmEdge::ValVariant(UINT32_C(1000))},
+                         {WasmEdge::ValType(WasmEdge::TypeCode::I32)});
+  ASSERT_TRUE(List);
+  ASSERT_EQ(List->size(), 1U);
+  WasmEdge::Executor::Collector::Root ListRoot(
+      (*List)[0].first.get<WasmEdge::RefVariant>());
+  auto Churn = VM.execute("churn", {WasmEdge::ValVariant(UINT32_C(200000))},
+                          {WasmEdge::ValType(WasmEdge::TypeCode::I32)});
+  ASSERT_TRUE(Churn);
+  EXPECT_EQ((*Churn)[0].first.get<uint32_t>(), 7U);
+
+  const auto After = GC.getStatistics();
+  EXPECT_GT(After.MinorCount + After.FullCount,
+            Before.MinorCount + Before.FullCount);
+  EXPECT_GT(After.FreedBytes, Before.FreedBytes);
+  EXPECT_LT(After.LiveBytes, UINT64_C(16) << 20);
+
+  // The lists in the global and in the host survive the collections.
+  auto SumG = VM.execute("sumg");
+  ASSERT_TRUE(SumG);
+  EXPECT_EQ((*SumG)[0].first.get<uint32_t>(), 500500U);
+  uint32_t Sum = 0;
+  const auto *Node = (*List)[0]
+                         .first.get<WasmEdge::RefVariant>()
+                         .getPtr<WasmEdge::Runtime::Instance::StructInstance>();
+  while (Node != nullptr) {
+    Sum += Node->getField(0).get<uint32_t>();
+    Node = Node->getField(1)
+               .get<WasmEdge::RefVariant>()
+               .getPtr<WasmEdge::Runtime::Instance::StructInstance>();
+  }
+  EXPECT_EQ(Sum, 500500U);
+}
+
+// Module of the GC object passed to the host:
+//   (type $node (struct (field (mut i32))))
+//   (import "env" "take" (func $take (param structref)))
+//   "pass": pass a new node to $take.
+std::array<WasmEdge::Byte, 63> GCHostWasm{
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x0c, 0x03, 0x5f,
+    0x01, 0x7f, 0x01, 0x60, 0x01, 0x6b, 0x00, 0x60, 0x00, 0x00, 0x02, 0x0c,
+    0x01, 0x03, 0x65, 0x6e, 0x76, 0x04, 0x74, 0x61, 0x6b, 0x65, 0x00, 0x01,
+    0x03, 0x02, 0x01, 0x02, 0x07, 0x08, 0x01, 0x04, 0x70, 0x61, 0x73, 0x73,
+    0x00, 0x01, 0x0a, 0x0b, 0x01, 0x09, 0x00, 0x41, 0x2a, 0xfb, 0x00, 0x00,
+    0x10, 0x00, 0x0b};
+
+// Host function collecting the heaps with the passed object.
+class GCTake : public WasmEdge::Runtime::HostFunctionBase {
+public:
+  GCTake() : HostFunctionBase(0) {
+    DefType.getCompositeType().getFuncType().getParamTypes().push_back(
+        WasmEdge::ValType(WasmEdge::TypeCode::RefNull,
+                          WasmEdge::TypeCode::StructRef));
+  }
+  WasmEdge::Expect<void> run(const WasmEdge::Runtime::CallingFrame &,
+                             WasmEdge::Span<const WasmEdge::ValVariant> Args,
+                             WasmEdge::Span<WasmEdge::ValVariant>) override {
+    auto &GC = WasmEdge::Executor::Collector::getInstance();
+    Ptr = Args[0].get<WasmEdge::RefVariant>().getPtr<void>();
+    Collected = GC.collect(true);
+    LiveInCall = GC.isLive(Ptr);
+    return {};
+  }
+
+  const void *Ptr = nullptr;
+  bool Collected = false;
+  bool LiveInCall = false;
+};
+
+TEST(GC, HostCallTest) {
+  WasmEdge::Runtime::Instance::ModuleInstance Env("env");
+  auto Take = std::make_unique<GCTake>();
+  const auto &TakeRef = *Take;
+  Env.addHostFunc("take"sv, std::move(Take));
+
+  WasmEdge::Configure Conf;
+  Conf.addProposal(WasmEdge::Proposal::GC);
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.registerModule(Env));
+  ASSERT_TRUE(VM.loadWasm(GCHostWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  ASSERT_TRUE(VM.execute("pass"));
+
+  // The argument is pinned in the call, and collected after it returns.
+  auto &GC = WasmEdge::Executor::Collector::getInstance();
+  ASSERT_NE(TakeRef.Ptr, nullptr);
+  EXPECT_TRUE(TakeRef.Collected);
+  EXPECT_TRUE(TakeRef.LiveInCall);
+  EXPECT_TRUE(GC.collect(true));
+  EXPECT_FALSE(GC.isLive(TakeRef.Ptr));
+}
+
+TEST(GC, EscapeTest) {
+  WasmEdge::Configure Conf;
+  Conf.addProposal(WasmEdge::Proposal::GC);
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(GCWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  auto &GC = WasmEdge::Executor::Collector::getInstance();
+  auto SumList = [](const WasmEdge::RefVariant &Ref) {
+    uint32_t Sum = 0;
+    const auto *Node =
+        Ref.getPtr<WasmEdge::Runtime::Instance::StructInstance>();
+    while (Node != nullptr) {
+      Sum += Node->getField(0).get<uint32_t>();
+      Node = Node->getField(1)
+                 .get<WasmEdge::RefVariant>()
+                 .getPtr<WasmEdge::Runtime::Instance::StructInstance>();
+    }
+    return Sum;
+  };
+
+  // The returned list escapes to the host without any root.
+  auto List = VM.execute("build", {WasmEdge::ValVariant(UINT32_C(100))},
+                         {WasmEdge::ValType(WasmEdge::TypeCode::I32)});
+  ASSERT_TRUE(List);
+  const auto Ref = (*List)[0].first.get<WasmEdge::RefVariant>();
+
+  // The list survives the following invocations and the full collections.
+  auto Churn = VM.execute("churn", {WasmEdge::ValVariant(UINT32_C(1000))},
+                          {WasmEdge::ValType(WasmEdge::TypeCode::I32)});
+  ASSERT_TRUE(Churn);
+  ASSERT_TRUE(GC.collect(true));
+  EXPECT_TRUE(GC.isLive(Ref.getPtr<void>()));
+  EXPECT_EQ(SumList(Ref), 5050U);
+
+  // The list is collected after the host releases it.
+  GC.unroot(Ref);
+  ASSERT_TRUE(GC.collect(true));
+  EXPECT_FALSE(GC.isLive(Ref.getPtr<void>()));
+
+  // The roots are dropped with the module instance.
+  List = VM.execute("build", {WasmEdge::ValVariant(UINT32_C(10))},
+                    {WasmEdge::ValType(WasmEdge::TypeCode::I32)});
+  ASSERT_TRUE(List);
+  const auto Kept = (*List)[0].first.get<WasmEdge::RefVariant>();
+  VM.cleanup();
+  EXPECT_FALSE(GC.isLive(Kept.getPtr<void>()));
+  GC.unroot(Kept);
+}
+
+TEST(GC, ThreadTest) {
+  // The collections stop the other running thread, whose objects survive.
+  auto Churn = []() {
+    WasmEdge::Configure Conf;
+    Conf.addProposal(WasmEdge::Proposal::GC);
+    WasmEdge::VM::VM VM(Conf);
+    if (!VM.loadWasm(GCWasm) || !VM.validate() || !VM.instantiate()) {
+      return UINT32_C(0);
+    }
+    auto Res = VM.execute("churn", {WasmEdge::ValVariant(UINT32_C(200000))},
+                          {WasmEdge::ValType(WasmEdge::TypeCode::I32)});
+    return Res ? (*Res)[0].first.get<uint32_t>() : UINT32_C(0);
+  };
+  auto &GC = WasmEdge::Executor::Collector::getInstance();
+  const auto Before = GC.getStatistics();
+  uint32_t Result = 0;
+  std::thread Thread([&]() { Result = Churn(); });
+  EXPECT_EQ(Churn(), 7U);
+  Thread.join();
+  EXPECT_EQ(Result, 7U);
+  const auto After = GC.getStatistics();
+  EXPECT_GT(After.MinorCount + After.FullCount,
+            Before.MinorCount + Before.FullCount);
+}
+
+// Module of the recursion:
+//   "rec": return n by calling itself recursively n times.
+std::array<WasmEdge::Byte, 54> RecursionWasm{
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x06, 0x01,
+    0x60, 0x01, 0x7f, 0x01, 0x7f, 0x03, 0x02, 0x01, 0x00, 0x07, 0x07,
+    0x01, 0x03, 0x72, 0x65, 0x63, 0x00, 0x00, 0x0a, 0x17, 0x01, 0x15,
+    0x00, 0x20, 0x00, 0x45, 0x04, 0x7f, 0x41, 0x00, 0x05, 0x20, 0x00,
+    0x41, 0x01, 0x6b, 0x10, 0x00, 0x41, 0x01, 0x6a, 0x0b, 0x0b};
+
+TEST(Interpreter, ThreadedTest) {
+  // The threaded code and the switch loop run the same instructions with the
+  // same results, including the superinstructions, the calls, and the traps.
+  WasmEdge::Configure ThreadedConf;
+  WasmEdge::Configure SwitchConf;
+  ThreadedConf.getRuntimeConfigure().setEnableRegisterInterpreter(false);
+  SwitchConf.getRuntimeConfigure().setEnableRegisterInterpreter(false);
+  SwitchConf.getRuntimeConfigure().setEnableThreadedInterpreter(false);
+  EXPECT_TRUE(ThreadedConf.getRuntimeConfigure().isEnableThreadedInterpreter());
+  const std::vector<WasmEdge::ValType> I32x1 = {
+      WasmEdge::ValType(WasmEdge::TypeCode::I32)};
+  const std::vector<WasmEdge::ValType> I32x2 = {
+      WasmEdge::ValType(WasmEdge::TypeCode::I32),
+      WasmEdge::ValType(WasmEdge::TypeCode::I32)};
+  for (const auto *Conf : {&ThreadedConf, &SwitchConf}) {
+    WasmEdge::VM::VM FusedVM(*Conf);
+    ASSERT_TRUE(FusedVM.loadWasm(FusedWasm));
+    ASSERT_TRUE(FusedVM.validate());
+    ASSERT_TRUE(FusedVM.instantiate());
+    auto Res = FusedVM.execute("sum", {WasmEdge::ValVariant(UINT32_C(100))},
+                               I32x1);
+    ASSERT_TRUE(Res);
+    EXPECT_EQ((*Res)[0].first.get<uint32_t>(), 4950U);
+    Res = FusedVM.execute("step",
+                          {WasmEdge::ValVariant(UINT32_C(1)),
+                           WasmEdge::ValVariant(UINT32_C(7))},
+                          I32x2);
+    ASSERT_TRUE(Res);
+    EXPECT_EQ((*Res)[0].first.get<uint32_t>(), 106U);
+    Res = FusedVM.execute("div",
+                          {WasmEdge::ValVariant(UINT32_C(7)),
+                           WasmEdge::ValVariant(UINT32_C(0))},
+                          I32x2);
+    ASSERT_FALSE(Res);
+    EXPECT_EQ(Res.error(), WasmEdge::ErrCode::Value::DivideByZero);
+
+    WasmEdge::VM::VM GasVM(*Conf);
+    ASSERT_TRUE(GasVM.loadWasm(GasWasm));
+    ASSERT_TRUE(GasVM.validate());
+    ASSERT_TRUE(GasVM.instantiate());
+    ASSERT_TRUE(
+        GasVM.execute("count", {WasmEdge::ValVariant(UINT32_C(1000))}, I32x1));
+    const auto *Counter = GasVM.getActiveModule()->findGlobalExports("counter");
+    ASSERT_NE(Counter, nullptr);
+    EXPECT_EQ(Counter->getValue().get<uint32_t>(), 1000U);
+
+    WasmEdge::VM::VM RecVM(*Conf);
+    ASSERT_TRUE(RecVM.loadWasm(RecursionWasm));
+    ASSERT_TRUE(RecVM.validate());
+    ASSERT_TRUE(RecVM.instantiate());
+    Res = RecVM.execute("rec", {WasmEdge::ValVariant(UINT32_C(1000))}, I32x1);
+    ASSERT_TRUE(Res);
+    EXPECT_EQ((*Res)[0].first.get<uint32_t>(), 1000U);
+  }
+}
+
+// Module of the register code:
+//   (memory 1) (global (mut i32) (i32.const 5))
+//   "fib":    (param i32) (result i64) the n-th Fibonacci number in a loop,
+//             which overwrites the local on the operand stack
+//   "switch": (param i32 i32) (result i32) br_table to the cases of 100, 200,
+//             and 300, plus br_table carrying the second param to the blocks
+//             of the results, adding 1000 for the index 0
+//   "mem":    (param i32 i64) (result i64) i64.store the value, and sum the
+//             loads of i64.load8_s, i64.load16_u offset=2, i64.load, and
+//             i32.load8_s offset=8 after i32.store8 offset=8 of 127
+//   "flt":    (param f64 f64) (result f64) select min(a, b) * sqrt(b) if
+//             a < b, or a + b, rounded to f32, plus 0.5
+//   "trunc":  (param f64) (result i32) i32.trunc_f64_s
+//   "glob":   (param i32) (result i32) add the param to the global if not
+//             zero, or subtract 1, and return the global
+//   "loop":   (param i32) (result i32) a loop of a param incrementing the
+//             value until 50 by local.tee, returning 7 if the param is over
+//             1000 and trapping if the param is 500
+std::array<WasmEdge::Byte, 372> RegisterWasm{
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x22, 0x06, 0x60,
+    0x01, 0x7f, 0x01, 0x7e, 0x60, 0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x60, 0x02,
+    0x7f, 0x7e, 0x01, 0x7e, 0x60, 0x02, 0x7c, 0x7c, 0x01, 0x7c, 0x60, 0x01,
+    0x7c, 0x01, 0x7f, 0x60, 0x01, 0x7f, 0x01, 0x7f, 0x03, 0x08, 0x07, 0x00,
+    0x01, 0x02, 0x03, 0x04, 0x05, 0x05, 0x05, 0x03, 0x01, 0x00, 0x01, 0x06,
+    0x06, 0x01, 0x7f, 0x01, 0x41, 0x05, 0x0b, 0x07, 0x32, 0x07, 0x03, 0x66,
+    0x69, 0x62, 0x00, 0x00, 0x06, 0x73, 0x77, 0x69, 0x74, 0x63, 0x68, 0x00,
+    0x01, 0x03, 0x6d, 0x65, 0x6d, 0x00, 0x02, 0x03, 0x66, 0x6c, 0x74, 0x00,
+    0x03, 0x05, 0x74, 0x72, 0x75, 0x6e, 0x63, 0x00, 0x04, 0x04, 0x67, 0x6c,
+    0x6f, 0x62, 0x00, 0x05, 0x04, 0x6c, 0x6f, 0x6f, 0x70, 0x00, 0x06, 0x0a,
+    0xfa, 0x01, 0x07, 0x29, 0x01, 0x02, 0x7e, 0x42, 0x01, 0x21, 0x02, 0x02,
+    0x40, 0x03, 0x40, 0x20, 0x00, 0x45, 0x0d, 0x01, 0x20, 0x01, 0x20, 0x02,
+    0x20, 0x02, 0x21, 0x01, 0x7c, 0x21, 0x02, 0x20, 0x00, 0x41, 0x01, 0x6b,
+    0x21, 0x00, 0x0c, 0x00, 0x0b, 0x0b, 0x20, 0x01, 0x0b, 0x36, 0x00, 0x02,
+    0x7f, 0x02, 0x40, 0x02, 0x40, 0x02, 0x40, 0x20, 0x00, 0x0e, 0x03, 0x00,
+    0x01, 0x02, 0x02, 0x0b, 0x41, 0xe4, 0x00, 0x0c, 0x02, 0x0b, 0x41, 0xc8,
+    0x01, 0x0c, 0x01, 0x0b, 0x41, 0xac, 0x02, 0x0b, 0x02, 0x7f, 0x02, 0x7f,
+    0x20, 0x01, 0x20, 0x00, 0x0e, 0x01, 0x00, 0x01, 0x0b, 0x41, 0xe8, 0x07,
+    0x6a, 0x0b, 0x6a, 0x0b, 0x29, 0x00, 0x20, 0x00, 0x20, 0x01, 0x37, 0x03,
+    0x00, 0x20, 0x00, 0x30, 0x00, 0x00, 0x20, 0x00, 0x33, 0x01, 0x02, 0x7c,
+    0x20, 0x00, 0x29, 0x03, 0x00, 0x7c, 0x20, 0x00, 0x41, 0xff, 0x00, 0x3a,
+    0x00, 0x08, 0x20, 0x00, 0x2c, 0x00, 0x08, 0xac, 0x7c, 0x0b, 0x22, 0x00,
+    0x20, 0x00, 0x20, 0x01, 0xa4, 0x20, 0x01, 0x9f, 0xa2, 0x20, 0x00, 0x20,
+    0x01, 0xa0, 0x20, 0x00, 0x20, 0x01, 0x63, 0x1b, 0xb6, 0xbb, 0x44, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0xe0, 0x3f, 0xa0, 0x0b, 0x05, 0x00, 0x20,
+    0x00, 0xaa, 0x0b, 0x18, 0x00, 0x20, 0x00, 0x04, 0x40, 0x23, 0x00, 0x20,
+    0x00, 0x6a, 0x24, 0x00, 0x05, 0x23, 0x00, 0x41, 0x01, 0x6b, 0x24, 0x00,
+    0x0b, 0x23, 0x00, 0x0b, 0x2b, 0x01, 0x01, 0x7f, 0x20, 0x00, 0x03, 0x05,
+    0x41, 0x01, 0x6a, 0x22, 0x01, 0x20, 0x01, 0x41, 0x32, 0x49, 0x0d, 0x00,
+    0x0b, 0x20, 0x00, 0x41, 0xe8, 0x07, 0x4b, 0x04, 0x40, 0x41, 0x07, 0x0f,
+    0x0b, 0x20, 0x00, 0x41, 0xf4, 0x03, 0x46, 0x04, 0x40, 0x00, 0x0b, 0x0b};
+
+TEST(Interpreter, RegisterTest) {
+  // The register code and the stack machine run the same functions with the
+  // same results and traps. The functions with the calls fall back to the
+  // stack machine.
+  WasmEdge::Configure RegisterConf;
+  WasmEdge::Configure StackConf;
+  StackConf.getRuntimeConfigure().setEnableRegisterInterpreter(false);
+  EXPECT_TRUE(RegisterConf.getRuntimeConfigure().isEnableRegisterInterpreter());
+  const WasmEdge::ValType I32(WasmEdge::TypeCode::I32);
+  const WasmEdge::ValType I64(WasmEdge::TypeCode::I64);
+  const WasmEdge::ValType F64(WasmEdge::TypeCode::F64);
+  for (const auto *Conf : {&RegisterConf, &StackConf}) {
+    WasmEdge::VM::VM VM(*Conf);
+    ASSERT_TRUE(VM.loadWasm(RegisterWasm));
+    ASSERT_TRUE(VM.validate());
+    ASSERT_TRUE(VM.instantiate());
+
+    auto Res = VM.execute("fib", {WasmEdge::ValVariant(UINT32_C(10))}, {I32});
+    ASSERT_TRUE(Res);
+    EXPECT_EQ((*Res)[0].first.get<uint64_t>(), 55U);
+    Res = VM.execute("fib", {WasmEdge::ValVariant(UINT32_C(90))}, {I32});
+    ASSERT_TRUE(Res);
+    EXPECT_EQ((*Res)[0].first.get<uint64_t>(), UINT64_C(2880067194370816120));
+
+    const std::array<std::array<uint32_t, 3>, 4> SwitchCases = {{
+        {0, 5, 1105},
+        {1, 5, 205},
+        {2, 5, 305},
+        {UINT32_MAX, 5, 305},
+    }};
+    for (const auto &C : SwitchCases) {
+      Res = VM.execute(
+          "switch", {WasmEdge::ValVariant(C[0]), WasmEdge::ValVariant(C[1])},
+          {I32, I32});
+      ASSERT_TRUE(Res);
+      EXPECT_EQ((*Res)[0].first.get<uint32_t>(), C[2]);
+    }
+
+    const uint64_t Value = UINT64_C(0x0123456789ABCDEF);
+    Res = VM.execute(
+        "mem",
+        {WasmEdge::ValVariant(UINT32_C(16)), WasmEdge::ValVariant(Value)},
+        {I32, I64});
+    ASSERT_TRUE(Res);
+    EXPECT_EQ((*Res)[0].first.get<uint64_t>(), Value - 0x11 + 0x89AB + 0x7F);
+    Res = VM.execute(
+        "mem",
+        {WasmEdge::ValVariant(UINT32_C(65535)), WasmEdge::ValVariant(Value)},
+        {I32, I64});
+    ASSERT_FALSE(Res);
+    EXPECT_EQ(Res.error(), WasmEdge::ErrCode::Value::MemoryOutOfBounds);
+
+    Res = VM.execute("flt",
+                     {WasmEdge::ValVariant(1.0), WasmEdge::ValVariant(4.0)},
+                     {F64, F64});
+    ASSERT_TRUE(Res);
+    EXPECT_EQ((*Res)[0].first.get<double>(), 2.5);
+    Res = VM.execute("flt",
+                     {WasmEdge::ValVariant(9.0), WasmEdge::ValVariant(4.0)},
+                     {F64, F64});
+    ASSERT_TRUE(Res);
+    EXPECT_EQ((*Res)[0].first.get<double>(), 13.5);
+
+    Res = VM.execute("trunc", {WasmEdge::ValVariant(-3.7)}, {F64});
+    ASSERT_TRUE(Res);
+    EXPECT_EQ((*Res)[0].first.get<int32_t>(), -3);
+    Res = VM.execute("trunc", {WasmEdge::ValVariant(1e10)}, {F64});
+    ASSERT_FALSE(Res);
+    EXPECT_EQ(Res.error(), WasmEdge::ErrCode::Value::IntegerOverflow);
+
+    Res = VM.execute("glob", {WasmEdge::ValVariant(UINT32_C(3))}, {I32});
+    ASSERT_TRUE(Res);
+    EXPECT_EQ((*Res)[0].first.get<uint32_t>(), 8U);
+    Res = VM.execute("glob", {WasmEdge::ValVariant(UINT32_C(0))}, {I32});
+    ASSERT_TRUE(Res);
+    EXPECT_EQ((*Res)[0].first.get<uint32_t>(), 7U);
+
+    const std::array<std::array<uint32_t, 2>, 3> LoopCases = {{
+        {0, 50},
+        {100, 101},
+        {2000, 7},
+    }};
+    for (const auto &C : LoopCases) {
+      Res = VM.execute("loop", {WasmEdge::ValVariant(C[0])}, {I32});
+      ASSERT_TRUE(Res);
+      EXPECT_EQ((*Res)[0].first.get<uint32_t>(), C[1]);
+    }
+    Res = VM.execute("loop", {WasmEdge::ValVariant(UINT32_C(500))}, {I32});
+    ASSERT_FALSE(Res);
+    EXPECT_EQ(Res.error(), WasmEdge::ErrCode::Value::Unreachable);
+
+    // Every function is lowered at the first call, and never lowered again.
+    const auto *ModInst = VM.getActiveModule();
+    for (const auto Name : {"fib"sv, "switch"sv, "mem"sv, "flt"sv, "trunc"sv,
+                            "glob"sv, "loop"sv}) {
+      const auto *Func = ModInst->findFuncExports(Name);
+      ASSERT_NE(Func, nullptr);
+      EXPECT_EQ(Func->getRegisterCode([](const auto &) {
+        return std::unique_ptr<WasmEdge::Runtime::RegisterCode>();
+      }) != nullptr,
+                Conf == &RegisterConf)
+          << Name;
+    }
+
+    WasmEdge::VM::VM RecVM(*Conf);
+    ASSERT_TRUE(RecVM.loadWasm(RecursionWasm));
+    ASSERT_TRUE(RecVM.validate());
+    ASSERT_TRUE(RecVM.instantiate());
+    Res = RecVM.execute("rec", {WasmEdge::ValVariant(UINT32_C(1000))}, {I32});
+    ASSERT_TRUE(Res);
+    EXPECT_EQ((*Res)[0].first.get<uint32_t>(), 1000U);
+    EXPECT_EQ(RecVM.getActiveModule()->findFuncExports("rec")->getRegisterCode(
+                  [](const auto &) {
+                    return std::unique_ptr<WasmEdge::Runtime::RegisterCode>();
+                  }),
+              nullptr);
+  }
+
+  // The fused and the threaded results of the stack machine are kept.
+  WasmEdge::VM::VM FusedVM(RegisterConf);
+  ASSERT_TRUE(FusedVM.loadWasm(FusedWasm));
+  ASSERT_TRUE(FusedVM.validate());
+  ASSERT_TRUE(FusedVM.instantiate());
+  auto Res = FusedVM.execute("sum", {WasmEdge::ValVariant(UINT32_C(100))},
+                             {I32});
+  ASSERT_TRUE(Res);
+  EXPECT_EQ((*Res)[0].first.get<uint32_t>(), 4950U);
+  Res = FusedVM.execute("step",
+                        {WasmEdge::ValVariant(UINT32_C(1)),
+                         WasmEdge::ValVariant(UINT32_C(7))},
+                        {I32, I32});
+  ASSERT_TRUE(Res);
+  EXPECT_EQ((*Res)[0].first.get<uint32_t>(), 106U);
+  Res = FusedVM.execute("clamp", {WasmEdge::ValVariant(UINT32_C(30))}, {I32});
+  ASSERT_TRUE(Res);
+  EXPECT_EQ((*Res)[0].first.get<uint32_t>(), 2U);
+}
+
+TEST(Stack, ExhaustionTest) {
+  WasmEdge::Configure Conf;
+  Conf.getRuntimeConfigure().setStackSize(UINT64_C(1) << 20);
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(RecursionWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+
+  auto Res = VM.execute("rec", {WasmEdge::ValVariant(UINT32_C(1000))},
+                        {WasmEdge::ValType(WasmEdge::TypeCode::I32)});
+  ASSERT_TRUE(Res);
+  EXPECT_EQ((*Res)[0].first.get<uint32_t>(), 1000U);
+
+  // The runaway recursion traps instead of growing the stack.
+  Res = VM.execute("rec", {WasmEdge::ValVariant(UINT32_C(100000000))},
+                   {WasmEdge::ValType(WasmEdge::TypeCode::I32)});
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), WasmEdge::ErrCode::Value::StackOverflow);
+
+  // The following executions run on a clean stack.
+  Res = VM.execute("rec", {WasmEdge::ValVariant(UINT32_C(1000))},
+                   {WasmEdge::ValType(WasmEdge::TypeCode::I32)});
+  ASSERT_TRUE(Res);
+  EXPECT_EQ((*Res)[0].first.get<uint32_t>(), 1000U);
+}
+
 } // namespace
 
 GTEST_API_ int main(int argc, char **argv) {
@@ -1,7 +1,9 @@
 // SPDX-License-Identifier: Apache-2.0
 // SPDX-FileCopyrightText: 2019-2022 Second State INC
 
+#include "common/configure.h"
 #include "common/defines.h"
+#include "executor/executor.h"
 #include "host/wasi/wasibase.h"
 #include "host/wasi/wasifunc.h"
 #include "runtime/instance/module.h"
@@ -2997,6 +2999,399 @@ TEST(WasiTest, SymbolicLink) {
 }
 #endif
 
+#if WASMEDGE_OS_LINUX
+TEST(WasiTest, PollOneoffInterest) {
+  // The fds stay registered across the polls, which must not leak the events
+  // of an fd into the polls not subscribing it, nor into the reused fd.
+  WasmEdge::Host::WASI::Environ Env;
+  WasmEdge::Runtime::Instance::ModuleInstance Mod("");
+  Mod.addHostMemory(
+      "memory", std::make_unique<WasmEdge::Runtime::Instance::MemoryInstance>(
+                    WasmEdge::AST::MemoryType(1)));
+  auto *MemInstPtr = Mod.findMemoryExports("memory");
+  ASSERT_TRUE(MemInstPtr != nullptr);
+  auto &MemInst = *MemInstPtr;
+  WasmEdge::Runtime::CallingFrame CallFrame(nullptr, &Mod);
+
+  WasmEdge::Host::WasiFdClose WasiFdClose(Env);
+  WasmEdge::Host::WasiPollOneoff<WasmEdge::Host::WASI::TriggerType::Level>
+      WasiPollOneoff(Env);
+  WasmEdge::Host::WasiSockAcceptV2 WasiSockAccept(Env);
+  WasmEdge::Host::WasiSockBindV2 WasiSockBind(Env);
+  WasmEdge::Host::WasiSockConnectV2 WasiSockConnect(Env);
+  WasmEdge::Host::WasiSockListenV2 WasiSockListen(Env);
+  WasmEdge::Host::WasiSockOpenV2 WasiSockOpen(Env);
+  WasmEdge::Host::WasiSockSendV2 WasiSockSend(Env);
+  WasmEdge::Host::WasiSockSetOpt WasiSockSetOpt(Env);
+
+  std::array<WasmEdge::ValVariant, 1> Errno;
+  const std::array<uint8_t, 128> Address{1, 0, 127, 0, 0, 1};
+  const uint32_t Port = 18001;
+  const uint32_t FdPtr = 0;
+  const uint32_t AddressPtr = 4;
+  const uint32_t DataPtr = 512;
+  const uint32_t InPtr = 1024;
+  const uint32_t OutPtr = 2048;
+
+  Env.init({}, "test"s, {}, {});
+  auto Open = [&]() {
+    EXPECT_TRUE(WasiSockOpen.run(
+        CallFrame,
+        std::initializer_list<WasmEdge::ValVariant>{
+            static_cast<uint32_t>(__WASI_ADDRESS_FAMILY_INET4),
+            static_cast<uint32_t>(__WASI_SOCK_TYPE_SOCK_STREAM), FdPtr},
+        Errno));
+    EXPECT_EQ(Errno[0].get<int32_t>(), __WASI_ERRNO_SUCCESS);
+    int32_t Fd = -1;
+    EXPECT_TRUE((MemInst.loadValue(Fd, FdPtr)));
+    return Fd;
+  };
+  auto Connect = [&](int32_t ListenFd) {
+    const int32_t Fd = Open();
+    EXPECT_TRUE(WasiSockConnect.run(
+        CallFrame,
+        std::initializer_list<WasmEdge::ValVariant>{Fd, AddressPtr, Port},
+        Errno));
+    EXPECT_EQ(Errno[0].get<int32_t>(), __WASI_ERRNO_SUCCESS);
+    EXPECT_TRUE(
+        WasiSockAccept.run(CallFrame,
+                           std::initializer_list<WasmEdge::ValVariant>{
+                               ListenFd, UINT32_C(0), FdPtr},
+                           Errno));
+    EXPECT_EQ(Errno[0].get<int32_t>(), __WASI_ERRNO_SUCCESS);
+    int32_t ConnectionFd = -1;
+    EXPECT_TRUE((MemInst.loadValue(ConnectionFd, FdPtr)));
+    return std::pair{Fd, ConnectionFd};
+  };
+  auto Send = [&](int32_t Fd) {
+    writeString(MemInst, "ping"sv, DataPtr + 8);
+    auto IOVec = MemInst.getSpan<__wasi_ciovec_t>(DataPtr, 1);
+    IOVec[0].buf = DataPtr + 8;
+    IOVec[0].buf_len = 4;
+    EXPECT_TRUE(WasiSockSend.run(CallFrame,
+                                 std::initializer_list<WasmEdge::ValVariant>{
+                                     Fd, DataPtr, UINT32_C(1), UINT32_C(0),
+                                     DataPtr + 4},
+                                 Errno));
+    EXPECT_EQ(Errno[0].get<int32_t>(), __WASI_ERRNO_SUCCESS);
+  };
+  // Poll reading the fd with a 10ms timeout, and return the type of the
+  // first event.
+  auto PollRead = [&](int32_t Fd) {
+    auto Subscriptions = MemInst.getSpan<__wasi_subscription_t>(InPtr, 2);
+    std::memset(Subscriptions.data(), 0, Subscriptions.size_bytes());
+    Subscriptions[0].userdata = 1;
+    Subscriptions[0].u.tag = __WASI_EVENTTYPE_FD_READ;
+    Subscriptions[0].u.u.fd_read.file_descriptor = Fd;
+    Subscriptions[1].userdata = 2;
+    Subscriptions[1].u.tag = __WASI_EVENTTYPE_CLOCK;
+    Subscriptions[1].u.u.clock.id = __WASI_CLOCKID_MONOTONIC;
+    Subscriptions[1].u.u.clock.timeout =
+        std::chrono::nanoseconds(std::chrono::milliseconds(10)).count();
+    EXPECT_TRUE(WasiPollOneoff.run(
+        CallFrame,
+        std::initializer_list<WasmEdge::ValVariant>{InPtr, OutPtr, UINT32_C(2),
+                                                    FdPtr},
+        Errno));
+    EXPECT_EQ(Errno[0].get<int32_t>(), __WASI_ERRNO_SUCCESS);
+    __wasi_size_t NEvents;
+    EXPECT_TRUE((MemInst.loadValue(NEvents, FdPtr)));
+    EXPECT_EQ(NEvents, 1U);
+    const auto &Event = *MemInst.getPointer<const __wasi_event_t *>(OutPtr);
+    EXPECT_EQ(Event.error, __WASI_ERRNO_SUCCESS);
+    return Event.type;
+  };
+
+  const int32_t ListenFd = Open();
+  const uint32_t One = 1;
+  MemInst.storeValue(One, DataPtr);
+  EXPECT_TRUE(WasiSockSetOpt.run(
+      CallFrame,
+      std::initializer_list<WasmEdge::ValVariant>{
+          ListenFd, static_cast<uint32_t>(__WASI_SOCK_OPT_LEVEL_SOL_SOCKET),
+          static_cast<uint32_t>(__WASI_SOCK_OPT_SO_REUSEADDR), DataPtr,
+          static_cast<uint32_t>(sizeof(One))},
+      Errno));
+  EXPECT_EQ(Errno[0].get<int32_t>(), __WASI_ERRNO_SUCCESS);
+  writeAddress(MemInst, Address, AddressPtr);
+  EXPECT_TRUE(WasiSockBind.run(
+      CallFrame,
+      std::initializer_list<WasmEdge::ValVariant>{ListenFd, AddressPtr, Port},
+      Errno));
+  EXPECT_EQ(Errno[0].get<int32_t>(), __WASI_ERRNO_SUCCESS);
+  EXPECT_TRUE(WasiSockListen.run(
+      CallFrame,
+      std::initializer_list<WasmEdge::ValVariant>{ListenFd, UINT32_C(2)},
+      Errno));
+  EXPECT_EQ(Errno[0].get<int32_t>(), __WASI_ERRNO_SUCCESS);
+
+  auto [ClientFd, ConnectionFd] = Connect(ListenFd);
+  Send(ClientFd);
+  EXPECT_EQ(PollRead(ConnectionFd), __WASI_EVENTTYPE_FD_READ);
+  // The readable connection is still registered but not subscribed.
+  EXPECT_EQ(PollRead(ClientFd), __WASI_EVENTTYPE_CLOCK);
+  EXPECT_EQ(PollRead(ConnectionFd), __WASI_EVENTTYPE_FD_READ);
+
+  // The new connection may reuse the number of the closed one.
+  EXPECT_TRUE(WasiFdClose.run(
+      CallFrame, std::initializer_list<WasmEdge::ValVariant>{ConnectionFd},
+      Errno));
+  EXPECT_EQ(Errno[0].get<int32_t>(), __WASI_ERRNO_SUCCESS);
+  auto [NewClientFd, NewConnectionFd] = Connect(ListenFd);
+  EXPECT_EQ(PollRead(NewConnectionFd), __WASI_EVENTTYPE_CLOCK);
+  Send(NewClientFd);
+  EXPECT_EQ(PollRead(NewConnectionFd), __WASI_EVENTTYPE_FD_READ);
+
+  for (const int32_t Fd : {ClientFd, NewClientFd, NewConnectionFd, ListenFd}) {
+    EXPECT_TRUE(WasiFdClose.run(
+        CallFrame, std::initializer_list<WasmEdge::ValVariant>{Fd}, Errno));
+    EXPECT_EQ(Errno[0].get<int32_t>(), __WASI_ERRNO_SUCCESS);
+  }
+  Env.fini();
+}
+#endif
+
+#if WASMEDGE_OS_LINUX
+TEST(WasiTest, SockAcceptNonBlock) {
+  // The nonblocking flag of sock_accept is set on the accepted socket, not
+  // on the listening one.
+  WasmEdge::Host::WASI::Environ Env;
+  WasmEdge::Runtime::Instance::ModuleInstance Mod("");
+  Mod.addHostMemory(
+      "memory", std::make_unique<WasmEdge::Runtime::Instance::MemoryInstance>(
+                    WasmEdge::AST::MemoryType(1)));
+  auto *MemInstPtr = Mod.findMemoryExports("memory");
+  ASSERT_TRUE(MemInstPtr != nullptr);
+  auto &MemInst = *MemInstPtr;
+  WasmEdge::Runtime::CallingFrame CallFrame(nullptr, &Mod);
+
+  WasmEdge::Host::WasiFdClose WasiFdClose(Env);
+  WasmEdge::Host::WasiFdFdstatGet WasiFdFdstatGet(Env);
+  WasmEdge::Host::WasiSockAcceptV2 WasiSockAccept(Env);
+  WasmEdge::Host::WasiSockBindV2 WasiSockBind(Env);
+  WasmEdge::Host::WasiSockConnectV2 WasiSockConnect(Env);
+  WasmEdge::Host::WasiSockListenV2 WasiSockListen(Env);
+  WasmEdge::Host::WasiSockOpenV2 WasiSockOpen(Env);
+  WasmEdge::Host::WasiSockSetOpt WasiSockSetOpt(Env);
+
+  std::array<WasmEdge::ValVariant, 1> Errno;
+  const std::array<uint8_t, 128> Address{1, 0, 127, 0, 0, 1};
+  const uint32_t Port = 18002;
+  const uint32_t FdPtr = 0;
+  const uint32_t AddressPtr = 4;
+  const uint32_t DataPtr = 512;
+
+  Env.init({}, "test"s, {}, {});
+  auto Open = [&]() {
+    EXPECT_TRUE(WasiSockOpen.run(
+        CallFrame,
+        std::initializer_list<WasmEdge::ValVariant>{
+            static_cast<uint32_t>(__WASI_ADDRESS_FAMILY_INET4),
+            static_cast<uint32_t>(__WASI_SOCK_TYPE_SOCK_STREAM), FdPtr},
+        Errno));
+    EXPECT_EQ(Errno[0].get<int32_t>(), __WASI_ERRNO_SUCCESS);
+    int32_t Fd = -1;
+    EXPECT_TRUE((MemInst.loadValue(Fd, FdPtr)));
+    return Fd;
+  };
+  auto IsNonBlock = [&](int32_t Fd) {
+    EXPECT_TRUE(WasiFdFdstatGet.run(
+        CallFrame, std::initializer_list<WasmEdge::ValVariant>{Fd, DataPtr},
+        Errno));
+    EXPECT_EQ(Errno[0].get<int32_t>(), __WASI_ERRNO_SUCCESS);
+    const auto &FdStat = *MemInst.getPointer<const __wasi_fdstat_t *>(DataPtr);
+    return (FdStat.fs_flags & __WASI_FDFLAGS_NONBLOCK) != 0;
+  };
+
+  const int32_t ListenFd = Open();
+  const uint32_t One = 1;
+  MemInst.storeValue(One, DataPtr);
+  EXPECT_TRUE(WasiSockSetOpt.run(
+      CallFrame,
+      std::initializer_list<WasmEdge::ValVariant>{
+          ListenFd, static_cast<uint32_t>(__WASI_SOCK_OPT_LEVEL_SOL_SOCKET),
+          static_cast<uint32_t>(__WASI_SOCK_OPT_SO_REUSEADDR), DataPtr,
+          static_cast<uint32_t>(sizeof(One))},
+      Errno));
+  EXPECT_EQ(Errno[0].get<int32_t>(), __WASI_ERRNO_SUCCESS);
+  writeAddress(MemInst, Address, AddressPtr);
+  EXPECT_TRUE(WasiSockBind.run(
+      CallFrame,
+      std::initializer_list<WasmEdge::ValVariant>{ListenFd, AddressPtr, Port},
+      Errno));
+  EXPECT_EQ(Errno[0].get<int32_t>(), __WASI_ERRNO_SUCCESS);
+  EXPECT_TRUE(WasiSockListen.run(
+      CallFrame,
+      std::initializer_list<WasmEdge::ValVariant>{ListenFd, UINT32_C(1)},
+      Errno));
+  EXPECT_EQ(Errno[0].get<int32_t>(), __WASI_ERRNO_SUCCESS);
+
+  const int32_t ClientFd = Open();
+  EXPECT_TRUE(WasiSockConnect.run(
+      CallFrame,
+      std::initializer_list<WasmEdge::ValVariant>{ClientFd, AddressPtr, Port},
+      Errno));
+  EXPECT_EQ(Errno[0].get<int32_t>(), __WASI_ERRNO_SUCCESS);
+  EXPECT_TRUE(WasiSockAccept.run(
+      CallFrame,
+      std::initializer_list<WasmEdge::ValVariant>{
+          ListenFd, static_cast<uint32_t>(__WASI_FDFLAGS_NONBLOCK), FdPtr},
+      Errno));
+  EXPECT_EQ(Errno[0].get<int32_t>(), __WASI_ERRNO_SUCCESS);
+  int32_t ConnectionFd = -1;
+  EXPECT_TRUE((MemInst.loadValue(ConnectionFd, FdPtr)));
+
+  EXPECT_TRUE(IsNonBlock(ConnectionFd));
+  EXPECT_FALSE(IsNonBlock(ListenFd));
+
+  for (const int32_t Fd : {ClientFd, ConnectionFd, ListenFd}) {
+    EXPECT_TRUE(WasiFdClose.run(
+        CallFrame, std::initializer_list<WasmEdge::ValVariant>{Fd}, Errno));
+    EXPECT_EQ(Errno[0].get<int32_t>(), __WASI_ERRNO_SUCCESS);
+  }
+  Env.fini();
+}
+#endif
+
+#if WASMEDGE_OS_LINUX
+TEST(WasiTest, IOUring) {
+  // Falls back to the epoll backend if io_uring is unsupported. The memory is
+  // registered to test the requests on the fixed buffer.
+  WasmEdge::Configure Conf;
+  Conf.getRuntimeConfigure().setEnableIOUring(true);
+  Conf.getRuntimeConfigure().setMaxIOUringBufferSize(UINT64_C(1) << 20);
+  WasmEdge::Executor::Executor Executor(Conf);
+  WasmEdge::Host::WASI::Environ Env;
+  WasmEdge::Runtime::Instance::ModuleInstance Mod("");
+  Mod.addHostMemory(
+      "memory", std::make_unique<WasmEdge::Runtime::Instance::MemoryInstance>(
+                    WasmEdge::AST::MemoryType(1)));
+  auto *MemInstPtr = Mod.findMemoryExports("memory");
+  ASSERT_TRUE(MemInstPtr != nullptr);
+  auto &MemInst = *MemInstPtr;
+  WasmEdge::Runtime::CallingFrame CallFrame(&Executor, &Mod);
+
+  WasmEdge::Host::WasiPathOpen WasiPathOpen(Env);
+  WasmEdge::Host::WasiPathUnlinkFile WasiPathUnlinkFile(Env);
+  WasmEdge::Host::WasiFdWrite WasiFdWrite(Env);
+  WasmEdge::Host::WasiFdPread WasiFdPread(Env);
+  WasmEdge::Host::WasiFdClose WasiFdClose(Env);
+  WasmEdge::Host::WasiPollOneoff<WasmEdge::Host::WASI::TriggerType::Level>
+      WasiPollOneoff(Env);
+  std::array<WasmEdge::ValVariant, 1> Errno = {UINT32_C(0)};
+
+  const uint32_t Fd = 3;
+  const uint32_t FdPtr = 0;
+  const uint32_t SizePtr = 4;
+  const uint32_t IOVecPtr = 8;
+  const uint32_t PathPtr = 64;
+  const uint32_t DataPtr = 128;
+  const uint32_t SubscriptionPtr = 256;
+  const uint32_t EventPtr = 512;
+  const auto Path = "iouring.dat"sv;
+  const uint32_t PathSize = static_cast<uint32_t>(Path.size());
+
+  Env.init({"/:."s}, "test"s, {}, {});
+  writeString(MemInst, Path, PathPtr);
+  const uint64_t Rights = static_cast<uint64_t>(__WASI_RIGHTS_FD_READ) |
+                          static_cast<uint64_t>(__WASI_RIGHTS_FD_WRITE) |
+                          static_cast<uint64_t>(__WASI_RIGHTS_FD_SEEK) |
+                          static_cast<uint64_t>(__WASI_RIGHTS_POLL_FD_READWRITE);
+  EXPECT_TRUE(WasiPathOpen.run(
+      CallFrame,
+      std::initializer_list<WasmEdge::ValVariant>{
+          Fd, UINT32_C(0), PathPtr, PathSize,
+          static_cast<uint32_t>(__WASI_OFLAGS_CREAT | __WASI_OFLAGS_TRUNC),
+          Rights, Rights, UINT32_C(0), FdPtr},
+      Errno));
+  ASSERT_EQ(Errno[0].get<int32_t>(), __WASI_ERRNO_SUCCESS);
+  int32_t FileFd = -1;
+  EXPECT_TRUE((MemInst.loadValue(FileFd, FdPtr)));
+
+  // write in two iovecs
+  {
+    writeString(MemInst, "hello world"sv, DataPtr);
+    auto IOVec = MemInst.getSpan<__wasi_ciovec_t>(IOVecPtr, 2);
+    IOVec[0].buf = DataPtr;
+    IOVec[0].buf_len = 6;
+    IOVec[1].buf = DataPtr + 6;
+    IOVec[1].buf_len = 5;
+    EXPECT_TRUE(WasiFdWrite.run(CallFrame,
+                                std::initializer_list<WasmEdge::ValVariant>{
+                                    FileFd, IOVecPtr, UINT32_C(2), SizePtr},
+                                Errno));
+    EXPECT_EQ(Errno[0].get<int32_t>(), __WASI_ERRNO_SUCCESS);
+    EXPECT_EQ(*MemInst.getPointer<const __wasi_size_t *>(SizePtr), 11U);
+  }
+
+  // read from the offset, stopping at the end of file
+  {
+    std::fill_n(MemInst.getPointer<uint8_t *>(DataPtr), 16, UINT8_C(0));
+    auto IOVec = MemInst.getSpan<__wasi_iovec_t>(IOVecPtr, 2);
+    IOVec[0].buf = DataPtr;
+    IOVec[0].buf_len = 3;
+    IOVec[1].buf = DataPtr + 3;
+    IOVec[1].buf_len = 8;
+    EXPECT_TRUE(WasiFdPread.run(
+        CallFrame,
+        std::initializer_list<WasmEdge::ValVariant>{
+            FileFd, IOVecPtr, UINT32_C(2), UINT64_C(6), SizePtr},
+        Errno));
+    EXPECT_EQ(Errno[0].get<int32_t>(), __WASI_ERRNO_SUCCESS);
+    EXPECT_EQ(*MemInst.getPointer<const __wasi_size_t *>(SizePtr), 5U);
+    EXPECT_EQ(std::string_view(MemInst.getPointer<const char *>(DataPtr), 5),
+              "world"sv);
+  }
+
+  // poll a timeout and the readable file
+  {
+    auto Subscriptions =
+        MemInst.getSpan<__wasi_subscription_t>(SubscriptionPtr, 2);
+    std::memset(Subscriptions.data(), 0, Subscriptions.size_bytes());
+    Subscriptions[0].userdata = 1;
+    Subscriptions[0].u.tag = __WASI_EVENTTYPE_CLOCK;
+    Subscriptions[0].u.u.clock.id = __WASI_CLOCKID_MONOTONIC;
+    Subscriptions[0].u.u.clock.timeout = UINT64_C(1000000);
+    EXPECT_TRUE(WasiPollOneoff.run(
+        CallFrame,
+        std::initializer_list<WasmEdge::ValVariant>{SubscriptionPtr, EventPtr,
+                                                    UINT32_C(1), SizePtr},
+        Errno));
+    EXPECT_EQ(Errno[0].get<int32_t>(), __WASI_ERRNO_SUCCESS);
+    EXPECT_EQ(*MemInst.getPointer<const __wasi_size_t *>(SizePtr), 1U);
+    const auto &Event = *MemInst.getPointer<const __wasi_event_t *>(EventPtr);
+    EXPECT_EQ(Event.userdata, 1U);
+    EXPECT_EQ(Event.error, __WASI_ERRNO_SUCCESS);
+    EXPECT_EQ(Event.type, __WASI_EVENTTYPE_CLOCK);
+
+    Subscriptions[0].u.u.clock.timeout = UINT64_C(10000000000);
+    Subscriptions[1].userdata = 2;
+    Subscriptions[1].u.tag = __WASI_EVENTTYPE_FD_READ;
+    Subscriptions[1].u.u.fd_read.file_descriptor = FileFd;
+    EXPECT_TRUE(WasiPollOneoff.run(
+        CallFrame,
+        std::initializer_list<WasmEdge::ValVariant>{SubscriptionPtr, EventPtr,
+                                                    UINT32_C(2), SizePtr},
+        Errno));
+    EXPECT_EQ(Errno[0].get<int32_t>(), __WASI_ERRNO_SUCCESS);
+    EXPECT_EQ(*MemInst.getPointer<const __wasi_size_t *>(SizePtr), 1U);
+    EXPECT_EQ(Event.userdata, 2U);
+    EXPECT_EQ(Event.error, __WASI_ERRNO_SUCCESS);
+    EXPECT_EQ(Event.type, __WASI_EVENTTYPE_FD_READ);
+  }
+
+  EXPECT_TRUE(WasiFdClose.run(
+      CallFrame, std::initializer_list<WasmEdge::ValVariant>{FileFd}, Errno));
+  EXPECT_EQ(Errno[0].get<int32_t>(), __WASI_ERRNO_SUCCESS);
+  EXPECT_TRUE(WasiPathUnlinkFile.run(
+      CallFrame,
+      std::initializer_list<WasmEdge::ValVariant>{Fd, PathPtr, PathSize},
+      Errno));
+  EXPECT_EQ(Errno[0].get<int32_t>(), __WASI_ERRNO_SUCCESS);
+  Env.fini();
+}
+#endif
+
 GTEST_API_ int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -14,24 +14,29 @@
 ///
 //===----------------------------------------------------------------------===//
 
+#include "aot/cache.h"
 #include "common/defines.h"
 #include "common/spdlog.h"
 #include "vm/vm.h"
 #include "llvm/codegen.h"
 #include "llvm/compiler.h"
+#include "llvm/jit.h"
 
 #include "../spec/hostfunc.h"
 #include "../spec/spectest.h"
 
 #include <array>
+#include <atomic>
 #include <chrono>
 #include <cstdint>
+#include <fstream>
 #include <functional>
 #include <gtest/gtest.h>
 #include <map>
 #include <memory>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -527,6 +532,535 @@ TEST(AsyncExecute, CustomWasmInterruptTest) {
   EXPECT_NO_THROW(std::filesystem::remove(Path));
 }
 
+// Module of the functions calling each other across the partitions of the
+// parallel compilation:
+//   "fib":   recursive fibonacci number
+//   "sumsq": sum of sq(i) for i from 0 to n - 1, where sq is not exported
+//   "mix":   fib(a) + sumsq(b)
+//   "g4":    ((n ^ 0x55) - 3) * 2 + 1 by a chain of the unexported functions
+std::array<WasmEdge::Byte, 190> ParallelWasm{
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x0c, 0x02, 0x60,
+    0x01, 0x7f, 0x01, 0x7f, 0x60, 0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x03, 0x09,
+    0x08, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x07, 0x1a, 0x04,
+    0x03, 0x66, 0x69, 0x62, 0x00, 0x00, 0x05, 0x73, 0x75, 0x6d, 0x73, 0x71,
+    0x00, 0x02, 0x03, 0x6d, 0x69, 0x78, 0x00, 0x03, 0x02, 0x67, 0x34, 0x00,
+    0x04, 0x0a, 0x7f, 0x08, 0x1c, 0x00, 0x20, 0x00, 0x41, 0x02, 0x49, 0x04,
+    0x7f, 0x20, 0x00, 0x05, 0x20, 0x00, 0x41, 0x01, 0x6b, 0x10, 0x00, 0x20,
+    0x00, 0x41, 0x02, 0x6b, 0x10, 0x00, 0x6a, 0x0b, 0x0b, 0x07, 0x00, 0x20,
+    0x00, 0x20, 0x00, 0x6c, 0x0b, 0x25, 0x01, 0x02, 0x7f, 0x02, 0x40, 0x03,
+    0x40, 0x20, 0x01, 0x20, 0x00, 0x4f, 0x0d, 0x01, 0x20, 0x02, 0x20, 0x01,
+    0x10, 0x01, 0x6a, 0x21, 0x02, 0x20, 0x01, 0x41, 0x01, 0x6a, 0x21, 0x01,
+    0x0c, 0x00, 0x0b, 0x0b, 0x20, 0x02, 0x0b, 0x0b, 0x00, 0x20, 0x00, 0x10,
+    0x00, 0x20, 0x01, 0x10, 0x02, 0x6a, 0x0b, 0x09, 0x00, 0x20, 0x00, 0x10,
+    0x05, 0x41, 0x01, 0x6a, 0x0b, 0x09, 0x00, 0x20, 0x00, 0x10, 0x06, 0x41,
+    0x01, 0x74, 0x0b, 0x09, 0x00, 0x20, 0x00, 0x10, 0x07, 0x41, 0x03, 0x6b,
+    0x0b, 0x08, 0x00, 0x20, 0x00, 0x41, 0xd5, 0x00, 0x73, 0x0b};
+
+TEST(ParallelCompile, ThreadsTest) {
+  struct Case {
+    std::string_view Name;
+    std::vector<uint32_t> Params;
+    uint32_t Result;
+  };
+  const std::array<Case, 5> Cases = {{
+      {"fib"sv, {20}, 6765},
+      {"sumsq"sv, {10}, 285},
+      {"mix"sv, {15, 4}, 624},
+      {"g4"sv, {0}, 165},
+      {"g4"sv, {100}, 93},
+  }};
+
+  // Compile the module with 1 and 4 threads, and check the results of the
+  // parallel compiled library against the single-threaded one.
+  std::array<std::vector<uint32_t>, 2> Results;
+  const std::array<uint32_t, 2> ThreadCounts = {1, 4};
+  for (size_t I = 0; I < ThreadCounts.size(); ++I) {
+    WasmEdge::Configure Conf;
+    Conf.getCompilerConfigure().setThreads(ThreadCounts[I]);
+    Conf.getCompilerConfigure().setOutputFormat(
+        CompilerConfigure::OutputFormat::Native);
+    WasmEdge::Loader::Loader Loader(Conf);
+    WasmEdge::Validator::Validator ValidatorEngine(Conf);
+    WasmEdge::LLVM::Compiler Compiler(Conf);
+    WasmEdge::LLVM::CodeGen CodeGen(Conf);
+    auto Path = std::filesystem::temp_directory_path() /
+                std::filesystem::u8path("AOTparallelTest" +
+                                        std::to_string(ThreadCounts[I]) +
+                                        WASMEDGE_LIB_EXTENSION);
+    auto Module = *Loader.parseModule(ParallelWasm);
+    ASSERT_TRUE(ValidatorEngine.validate(*Module));
+    auto Data = Compiler.compile(*Module);
+    ASSERT_TRUE(Data);
+    ASSERT_TRUE(CodeGen.codegen(ParallelWasm, std::move(*Data), Path));
+
+    WasmEdge::VM::VM VM(Conf);
+    ASSERT_TRUE(VM.loadWasm(Path));
+    ASSERT_TRUE(VM.validate());
+    ASSERT_TRUE(VM.instantiate());
+    for (const auto &C : Cases) {
+      std::vector<WasmEdge::ValVariant> Params(C.Params.begin(),
+                                               C.Params.end());
+      std::vector<WasmEdge::ValType> Types(
+          C.Params.size(), WasmEdge::ValType(WasmEdge::TypeCode::I32));
+      auto Res = VM.execute(C.Name, Params, Types);
+      ASSERT_TRUE(Res) << C.Name;
+      Results[I].push_back((*Res)[0].first.get<uint32_t>());
+      EXPECT_EQ(Results[I].back(), C.Result) << C.Name;
+    }
+    VM.cleanup();
+    EXPECT_NO_THROW(std::filesystem::remove(Path));
+  }
+  EXPECT_EQ(Results[0], Results[1]);
+}
+
+TEST(TieredExecution, PromoteTest) {
+  WasmEdge::Configure Conf;
+  Conf.getRuntimeConfigure().setTierUpThreshold(16);
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(ParallelWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  const auto *ModInst = VM.getActiveModule();
+  ASSERT_NE(ModInst, nullptr);
+  const auto *Fib = ModInst->findFuncExports("fib");
+  const auto *G4 = ModInst->findFuncExports("g4");
+  const auto *SumSq = ModInst->findFuncExports("sumsq");
+  ASSERT_NE(Fib, nullptr);
+  ASSERT_NE(G4, nullptr);
+  ASSERT_NE(SumSq, nullptr);
+  EXPECT_FALSE(Fib->isTieredFunction());
+  EXPECT_FALSE(G4->isTieredFunction());
+
+  // Keep calling the functions on several threads while the background
+  // compiler swaps their entries, and check every result.
+  const std::vector<WasmEdge::ValType> Types = {
+      WasmEdge::ValType(WasmEdge::TypeCode::I32)};
+  std::atomic<bool> Stopped = false;
+  std::atomic<uint32_t> Calls = 0;
+  std::atomic<uint32_t> Wrong = 0;
+  std::vector<std::thread> Threads;
+  for (uint32_t I = 0; I < 4; ++I) {
+    Threads.emplace_back([&, I]() {
+      while (!Stopped.load()) {
+        const bool IsFib = I % 2 == 0;
+        auto Res = VM.execute(IsFib ? "fib"sv : "g4"sv,
+                              {WasmEdge::ValVariant(UINT32_C(10))}, Types);
+        if (!Res || (*Res)[0].first.get<uint32_t>() != (IsFib ? 55U : 185U)) {
+          Wrong.fetch_add(1);
+        }
+        Calls.fetch_add(1);
+      }
+    });
+  }
+  const auto Deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(60);
+  while ((!Fib->isTieredFunction() || !G4->isTieredFunction()) &&
+         std::chrono::steady_clock::now() < Deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  // Keep the calls running on the compiled code for a while.
+  const uint32_t Promoted = Calls.load();
+  while (Calls.load() < Promoted + 64 &&
+         std::chrono::steady_clock::now() < Deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  Stopped.store(true);
+  for (auto &Thread : Threads) {
+    Thread.join();
+  }
+  EXPECT_TRUE(Fib->isTieredFunction());
+  EXPECT_TRUE(G4->isTieredFunction());
+  EXPECT_TRUE(Fib->isCompiledFunction());
+  EXPECT_EQ(Wrong.load(), 0U);
+
+  // The promoted functions keep returning the correct results, and the
+  // uncalled function stays in the interpreter.
+  auto Res = VM.execute("fib", {WasmEdge::ValVariant(UINT32_C(20))}, Types);
+  ASSERT_TRUE(Res);
+  EXPECT_EQ((*Res)[0].first.get<uint32_t>(), 6765U);
+  EXPECT_FALSE(SumSq->isTieredFunction());
+  Res = VM.execute("sumsq", {WasmEdge::ValVariant(UINT32_C(10))}, Types);
+  ASSERT_TRUE(Res);
+  EXPECT_EQ((*Res)[0].first.get<uint32_t>(), 285U);
+  VM.cleanup();
+}
+
+TEST(LazyJIT, CompileOnCallTest) {
+  WasmEdge::Configure Conf;
+  Conf.getRuntimeConfigure().setEnableJIT(true);
+  Conf.getRuntimeConfigure().setEnableLazyJIT(true);
+  WasmEdge::Loader::Loader Loader(Conf);
+  WasmEdge::Validator::Validator ValidatorEngine(Conf);
+  WasmEdge::Executor::Executor ExecEngine(Conf);
+  WasmEdge::Runtime::StoreManager Store;
+  WasmEdge::LLVM::Compiler Compiler(Conf);
+  WasmEdge::LLVM::JIT JIT(Conf);
+  auto Module = *Loader.parseModule(ParallelWasm);
+  ASSERT_TRUE(ValidatorEngine.validate(*Module));
+  auto Data = Compiler.translate(*Module);
+  ASSERT_TRUE(Data);
+  auto Exec = JIT.loadLazy(std::move(*Data));
+  ASSERT_TRUE(Exec);
+  const auto *Lib = dynamic_cast<WasmEdge::LLVM::JITLibrary *>(Exec->get());
+  ASSERT_NE(Lib, nullptr);
+  if (Lib->isCompiled("f0")) {
+    GTEST_SKIP() << "lazy compilation stubs are not supported";
+  }
+  ASSERT_TRUE(Loader.loadExecutable(*Module, *Exec));
+  auto ModInst = ExecEngine.instantiateModule(Store, *Module);
+  ASSERT_TRUE(ModInst);
+
+  // Nothing is compiled before the calls. The functions are "fib", "sq",
+  // "sumsq", "mix", "g4", and the 3 functions called by "g4" in order.
+  for (uint32_t I = 0; I < 8; ++I) {
+    EXPECT_FALSE(Lib->isCompiled("f" + std::to_string(I))) << I;
+  }
+
+  const std::vector<WasmEdge::ValType> Types = {
+      WasmEdge::ValType(WasmEdge::TypeCode::I32)};
+  auto Invoke = [&](std::string_view Name, uint32_t Param) -> uint32_t {
+    const auto *Func = (*ModInst)->findFuncExports(Name);
+    EXPECT_NE(Func, nullptr);
+    auto Res = ExecEngine.invoke(Func, {WasmEdge::ValVariant(Param)}, Types);
+    EXPECT_TRUE(Res);
+    return Res ? (*Res)[0].first.get<uint32_t>() : 0;
+  };
+  EXPECT_EQ(Invoke("g4"sv, 10), 185U);
+  EXPECT_EQ(Invoke("g4"sv, 100), 93U);
+  for (uint32_t I = 4; I < 8; ++I) {
+    EXPECT_TRUE(Lib->isCompiled("f" + std::to_string(I))) << I;
+  }
+  for (uint32_t I = 0; I < 4; ++I) {
+    EXPECT_FALSE(Lib->isCompiled("f" + std::to_string(I))) << I;
+  }
+
+  // The next called function is compiled on its own, and the uncalled ones
+  // are still never compiled.
+  EXPECT_EQ(Invoke("fib"sv, 20), 6765U);
+  EXPECT_TRUE(Lib->isCompiled("f0"));
+  EXPECT_FALSE(Lib->isCompiled("f1"));
+  EXPECT_FALSE(Lib->isCompiled("f2"));
+  EXPECT_FALSE(Lib->isCompiled("f3"));
+}
+
+TEST(LazyJIT, CompiledCodeTest) {
+  WasmEdge::Configure Conf;
+  WasmEdge::Loader::Loader Loader(Conf);
+  WasmEdge::Validator::Validator ValidatorEngine(Conf);
+  WasmEdge::LLVM::Compiler Compiler(Conf);
+  WasmEdge::LLVM::JIT JIT(Conf);
+  auto Module = *Loader.parseModule(ParallelWasm);
+  ASSERT_TRUE(ValidatorEngine.validate(*Module));
+  auto Data = Compiler.translate(*Module);
+  ASSERT_TRUE(Data);
+  auto Exec = JIT.loadLazy(std::move(*Data));
+  ASSERT_TRUE(Exec);
+  auto *Lib = dynamic_cast<WasmEdge::LLVM::JITLibrary *>(Exec->get());
+  ASSERT_NE(Lib, nullptr);
+  if (Lib->isCompiled("f0")) {
+    GTEST_SKIP() << "lazy compilation stubs are not supported";
+  }
+
+  // Only the requested function is compiled without calling it, and its
+  // callees stay behind the stubs.
+  auto Code = Lib->getCompiledCode(2);
+  EXPECT_TRUE(Code);
+  EXPECT_NE(Code.get(), Lib->getCodes(2, 1)[0].get());
+  EXPECT_TRUE(Lib->isCompiled("f2"));
+  for (uint32_t I = 0; I < 8; ++I) {
+    if (I != 2) {
+      EXPECT_FALSE(Lib->isCompiled("f" + std::to_string(I))) << I;
+    }
+  }
+}
+
+TEST(LazyJIT, VMTest) {
+  WasmEdge::Configure Conf;
+  Conf.getRuntimeConfigure().setEnableJIT(true);
+  Conf.getRuntimeConfigure().setEnableLazyJIT(true);
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(ParallelWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  const std::vector<WasmEdge::ValType> Types = {
+      WasmEdge::ValType(WasmEdge::TypeCode::I32),
+      WasmEdge::ValType(WasmEdge::TypeCode::I32)};
+  auto Res = VM.execute("mix", {WasmEdge::ValVariant(UINT32_C(15)),
+                                WasmEdge::ValVariant(UINT32_C(4))},
+                        Types);
+  ASSERT_TRUE(Res);
+  EXPECT_EQ((*Res)[0].first.get<uint32_t>(), 624U);
+  Res = VM.execute("sumsq", {WasmEdge::ValVariant(UINT32_C(10))},
+                   Span<const WasmEdge::ValType>(Types).first(1));
+  ASSERT_TRUE(Res);
+  EXPECT_EQ((*Res)[0].first.get<uint32_t>(), 285U);
+  VM.cleanup();
+}
+
+TEST(JITCache, VMTest) {
+  // The libraries in the cache directory of the JIT compiled modules, and
+  // their modification times.
+  const auto Dir = WasmEdge::AOT::Cache::getPath(
+                       {}, WasmEdge::AOT::Cache::StorageScope::Local, "jit"sv)
+                       ->parent_path();
+  auto List = [&Dir]() {
+    std::map<std::filesystem::path, std::filesystem::file_time_type> Files;
+    std::error_code Error;
+    for (const auto &Entry :
+         std::filesystem::directory_iterator(Dir, Error)) {
+      Files.emplace(Entry.path(), Entry.last_write_time());
+    }
+    return Files;
+  };
+  auto Added = [](const auto &Before, const auto &After) {
+    std::vector<std::filesystem::path> Paths;
+    for (const auto &[Path, Time] : After) {
+      if (Before.count(Path) == 0) {
+        Paths.push_back(Path);
+      }
+    }
+    return Paths;
+  };
+  auto Run = [](const WasmEdge::Configure &Conf) -> uint32_t {
+    WasmEdge::VM::VM VM(Conf);
+    EXPECT_TRUE(VM.loadWasm(ParallelWasm));
+    EXPECT_TRUE(VM.validate());
+    EXPECT_TRUE(VM.instantiate());
+    auto Res = VM.execute("sumsq", {WasmEdge::ValVariant(UINT32_C(10))},
+                          {WasmEdge::ValType(WasmEdge::TypeCode::I32)});
+    EXPECT_TRUE(Res);
+    return Res ? (*Res)[0].first.get<uint32_t>() : 0;
+  };
+
+  WasmEdge::Configure Conf;
+  EXPECT_FALSE(Conf.getRuntimeConfigure().isEnableJITCache());
+  Conf.getRuntimeConfigure().setEnableJIT(true);
+  Conf.getRuntimeConfigure().setEnableJITCache(true);
+  const auto Before = List();
+
+  // Miss: the module is compiled into a new cache entry.
+  EXPECT_EQ(Run(Conf), 285U);
+  const auto Cached = List();
+  const auto Paths = Added(Before, Cached);
+  ASSERT_EQ(Paths.size(), 1U);
+  const auto Path = Paths[0];
+
+  // Hit: the entry is loaded and not written again.
+  EXPECT_EQ(Run(Conf), 285U);
+  EXPECT_EQ(List(), Cached);
+
+  // The key is invalidated by the compiler options and the module bytes.
+  std::vector<std::filesystem::path> Created = Paths;
+  {
+    WasmEdge::Configure Conf2 = Conf;
+    Conf2.getCompilerConfigure().setInterruptible(true);
+    EXPECT_EQ(Run(Conf2), 285U);
+    const auto Paths2 = Added(Cached, List());
+    EXPECT_EQ(Paths2.size(), 1U);
+    Created.insert(Created.end(), Paths2.begin(), Paths2.end());
+  }
+  {
+    const auto Current = List();
+    WasmEdge::VM::VM VM(Conf);
+    EXPECT_TRUE(VM.loadWasm(AsyncWasm));
+    EXPECT_TRUE(VM.validate());
+    EXPECT_TRUE(VM.instantiate());
+    const auto Paths3 = Added(Current, List());
+    EXPECT_EQ(Paths3.size(), 1U);
+    Created.insert(Created.end(), Paths3.begin(), Paths3.end());
+  }
+
+  // The broken entry is removed, and compiled again at the next miss.
+  {
+    std::ofstream File(Path, std::ios::binary | std::ios::trunc);
+    File << "broken";
+  }
+  EXPECT_EQ(Run(Conf), 285U);
+  EXPECT_FALSE(std::filesystem::exists(Path));
+  EXPECT_EQ(Run(Conf), 285U);
+  EXPECT_TRUE(std::filesystem::exists(Path));
+
+  for (const auto &P : Created) {
+    EXPECT_NO_THROW(std::filesystem::remove(P));
+  }
+}
+
+// Module of the gas metering:
+//   (global $counter (export "counter") (mut i32) (i32.const 0))
+//   "spin":  loop { global.set $counter (global.get $counter + 1); br 0 }
+//   "count": (param $n i32) increase $counter for $n iterations of a loop
+std::array<WasmEdge::Byte, 107> GasWasm{
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x08, 0x02, 0x60,
+    0x00, 0x00, 0x60, 0x01, 0x7f, 0x00, 0x03, 0x03, 0x02, 0x00, 0x01, 0x06,
+    0x06, 0x01, 0x7f, 0x01, 0x41, 0x00, 0x0b, 0x07, 0x1a, 0x03, 0x04, 0x73,
+    0x70, 0x69, 0x6e, 0x00, 0x00, 0x05, 0x63, 0x6f, 0x75, 0x6e, 0x74, 0x00,
+    0x01, 0x07, 0x63, 0x6f, 0x75, 0x6e, 0x74, 0x65, 0x72, 0x03, 0x00, 0x0a,
+    0x2e, 0x02, 0x0e, 0x00, 0x03, 0x40, 0x23, 0x00, 0x41, 0x01, 0x6a, 0x24,
+    0x00, 0x0c, 0x00, 0x0b, 0x0b, 0x1d, 0x00, 0x02, 0x40, 0x03, 0x40, 0x20,
+    0x00, 0x45, 0x0d, 0x01, 0x23, 0x00, 0x41, 0x01, 0x6a, 0x24, 0x00, 0x20,
+    0x00, 0x41, 0x01, 0x6b, 0x21, 0x00, 0x0c, 0x00, 0x0b, 0x0b, 0x0b};
+
+TEST(Metering, NativeCostLimitTest) {
+  // Compile the module with the per-instruction and the batched metering, and
+  // check that the compiled loops trap at the same limit.
+  std::array<uint32_t, 2> Counters;
+  std::array<uint64_t, 2> Costs;
+  for (uint32_t Batched = 0; Batched < 2; ++Batched) {
+    WasmEdge::Configure Conf;
+    Conf.getCompilerConfigure().setOutputFormat(
+        CompilerConfigure::OutputFormat::Native);
+    Conf.getStatisticsConfigure().setCostMeasuring(true);
+    Conf.getStatisticsConfigure().setBatchedMetering(Batched == 1);
+    Conf.getStatisticsConfigure().setCostLimit(1000);
+
+    WasmEdge::Loader::Loader Loader(Conf);
+    WasmEdge::Validator::Validator ValidatorEngine(Conf);
+    WasmEdge::LLVM::Compiler Compiler(Conf);
+    WasmEdge::LLVM::CodeGen CodeGen(Conf);
+    auto Path =
+        std::filesystem::temp_directory_path() /
+        std::filesystem::u8path("AOTmeteringTest" WASMEDGE_LIB_EXTENSION);
+    auto Module = *Loader.parseModule(GasWasm);
+    ASSERT_TRUE(ValidatorEngine.validate(*Module));
+    auto Data = Compiler.compile(*Module);
+    ASSERT_TRUE(Data);
+    ASSERT_TRUE(CodeGen.codegen(GasWasm, std::move(*Data), Path));
+
+    WasmEdge::VM::VM VM(Conf);
+    ASSERT_TRUE(VM.loadWasm(Path));
+    ASSERT_TRUE(VM.validate());
+    ASSERT_TRUE(VM.instantiate());
+    const auto *Counter = VM.getActiveModule()->findGlobalExports("counter");
+    ASSERT_NE(Counter, nullptr);
+
+    // The loop in the limit finishes in both modes.
+    auto Res = VM.execute("count", {WasmEdge::ValVariant(UINT32_C(10))},
+                          {WasmEdge::ValType(WasmEdge::TypeCode::I32)});
+    ASSERT_TRUE(Res);
+    EXPECT_EQ(Counter->getValue().get<uint32_t>(), 10U);
+    Costs[Batched] = VM.getStatistics().getTotalCost();
+
+    // The endless loop traps when the limit is reached.
+    VM.getStatistics().clear();
+    Res = VM.execute("spin");
+    ASSERT_FALSE(Res);
+    EXPECT_EQ(Res.error(), WasmEdge::ErrCode::Value::CostLimitExceeded);
+    EXPECT_LE(VM.getStatistics().getTotalCost(), 1000U);
+    Counters[Batched] = Counter->getValue().get<uint32_t>() - 10U;
+
+    VM.cleanup();
+    EXPECT_NO_THROW(std::filesystem::remove(Path));
+  }
+  // The batched metering charges the same cost, and traps at most one loop
+  // iteration later than the per-instruction metering.
+  EXPECT_EQ(Costs[0], Costs[1]);
+  EXPECT_GT(Counters[0], 0U);
+  EXPECT_GE(Counters[1], Counters[0]);
+  EXPECT_LE(Counters[1], Counters[0] + 1);
+}
+
+TEST(GC, CompiledLoopSafepointTest) {
+  // The compiled loop without calls stops at the loop header for the
+  // collection requested by this thread.
+  WasmEdge::Configure Conf;
+  Conf.getRuntimeConfigure().setEnableJIT(true);
+  Conf.getCompilerConfigure().setInterruptible(true);
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(GasWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  const auto *Counter = VM.getActiveModule()->findGlobalExports("counter");
+  ASSERT_NE(Counter, nullptr);
+
+  auto AsyncResult = VM.asyncExecute("spin");
+  const auto Deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (Counter->getValue().get<uint32_t>() == 0 &&
+         std::chrono::steady_clock::now() < Deadline) {
+    std::this_thread::yield();
+  }
+  ASSERT_NE(Counter->getValue().get<uint32_t>(), 0U);
+  auto &Collector = WasmEdge::Executor::Collector::getInstance();
+  const auto FullCount = Collector.getStatistics().FullCount;
+  EXPECT_TRUE(Collector.collect(true));
+  EXPECT_EQ(Collector.getStatistics().FullCount, FullCount + 1);
+
+  AsyncResult.cancel();
+  auto Result = AsyncResult.get();
+  ASSERT_FALSE(Result);
+  EXPECT_EQ(Result.error(), WasmEdge::ErrCode::Value::Interrupted);
+  VM.cleanup();
+}
+
+// Module calling the imported host function:
+//   (import "env" "add" (func $add (param i32 i32) (result i32)))
+//   "call": (param i32 i32) (result i32) call $add with the params
+std::array<WasmEdge::Byte, 56> HostCallWasm{
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x07, 0x01, 0x60,
+    0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x02, 0x0b, 0x01, 0x03, 0x65, 0x6e, 0x76,
+    0x03, 0x61, 0x64, 0x64, 0x00, 0x00, 0x03, 0x02, 0x01, 0x00, 0x07, 0x08,
+    0x01, 0x04, 0x63, 0x61, 0x6c, 0x6c, 0x00, 0x01, 0x0a, 0x0a, 0x01, 0x08,
+    0x00, 0x20, 0x00, 0x20, 0x01, 0x10, 0x00, 0x0b};
+
+class HostAdd : public WasmEdge::Runtime::HostFunction<HostAdd> {
+public:
+  HostAdd(uint32_t &C) : Calls(C) {}
+  WasmEdge::Expect<uint32_t> body(const WasmEdge::Runtime::CallingFrame &Frame,
+                                  uint32_t A, uint32_t B) {
+    ++Calls;
+    if (Frame.getModule() == nullptr || B == 0) {
+      return WasmEdge::Unexpect(WasmEdge::ErrCode::Value::HostFuncError);
+    }
+    return A + B;
+  }
+
+private:
+  uint32_t &Calls;
+};
+
+TEST(HostCall, NativeEntryTest) {
+  // The import stubs call the host function directly without the pre host
+  // function, and call through the executor with it.
+  for (uint32_t Hooked = 0; Hooked < 2; ++Hooked) {
+    WasmEdge::Configure Conf;
+    Conf.getRuntimeConfigure().setEnableJIT(true);
+    uint32_t Calls = 0, PreCalls = 0;
+    WasmEdge::Runtime::Instance::ModuleInstance Env("env");
+    Env.addHostFunc("add"sv, std::make_unique<HostAdd>(Calls));
+    ASSERT_NE(Env.findFuncExports("add"sv)->getHostFunc().getNativeEntry(),
+              nullptr);
+
+    WasmEdge::VM::VM VM(Conf);
+    ASSERT_TRUE(VM.registerModule(Env));
+    if (Hooked == 1) {
+      VM.getExecutor().registerPreHostFunction(
+          &PreCalls, [](void *Data) { ++*static_cast<uint32_t *>(Data); });
+    }
+    ASSERT_TRUE(VM.loadWasm(HostCallWasm));
+    ASSERT_TRUE(VM.validate());
+    ASSERT_TRUE(VM.instantiate());
+    const std::vector<WasmEdge::ValType> Types = {
+        WasmEdge::ValType(WasmEdge::TypeCode::I32),
+        WasmEdge::ValType(WasmEdge::TypeCode::I32)};
+
+    auto Res = VM.execute("call", {WasmEdge::ValVariant(UINT32_C(20)),
+                                   WasmEdge::ValVariant(UINT32_C(22))},
+                          Types);
+    ASSERT_TRUE(Res);
+    EXPECT_EQ((*Res)[0].first.get<uint32_t>(), 42U);
+
+    // The errors of the host function trap in both paths.
+    Res = VM.execute("call", {WasmEdge::ValVariant(UINT32_C(1)),
+                              WasmEdge::ValVariant(UINT32_C(0))},
+                     Types);
+    ASSERT_FALSE(Res);
+    EXPECT_EQ(Res.error(), WasmEdge::ErrCode::Value::HostFuncError);
+    EXPECT_EQ(Calls, 2U);
+    EXPECT_EQ(PreCalls, Hooked * 2U);
+    VM.cleanup();
+  }
+}
+
 } // namespace
 
 GTEST_API_ int main(int argc, char **argv) {
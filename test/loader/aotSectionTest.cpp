@@ -0,0 +1,265 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/test/loader/aotSectionTest.cpp - AOT section unit tests --===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of loading the AOT sections of the universal
+/// wasm files, whose contents are mapped from or copied out of the file.
+///
+//===----------------------------------------------------------------------===//
+
+#include "aot/version.h"
+#include "loader/aot_section.h"
+#include "loader/loader.h"
+#include "system/mmap.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using namespace std::literals;
+
+WasmEdge::Configure Conf;
+WasmEdge::Loader::Loader Ldr(Conf);
+
+uint64_t getPageSize() {
+  const uint64_t PageSize = WasmEdge::MMap::pageSize();
+  return PageSize ? PageSize : 4096;
+}
+
+uint8_t contentByte(uint64_t I) { return static_cast<uint8_t>(I * 7 + 3); }
+
+void writeLEB(std::vector<uint8_t> &Out, uint64_t Value) {
+  do {
+    uint8_t Byte = Value & 0x7F;
+    Value >>= 7;
+    if (Value != 0) {
+      Byte |= 0x80;
+    }
+    Out.push_back(Byte);
+  } while (Value != 0);
+}
+
+void writeName(std::vector<uint8_t> &Out, std::string_view Name) {
+  writeLEB(Out, Name.size());
+  Out.insert(Out.end(), Name.begin(), Name.end());
+}
+
+std::filesystem::path writeFile(const std::vector<uint8_t> &Bytes,
+                                std::string_view Name = "aot_section"sv) {
+  const auto Path = std::filesystem::temp_directory_path() /
+                    ("wasmedge_test_"s + std::string(Name) + ".bin");
+  std::ofstream OS(Path, std::ios_base::binary | std::ios_base::trunc);
+  OS.write(reinterpret_cast<const char *>(Bytes.data()),
+           static_cast<std::streamsize>(Bytes.size()));
+  return Path;
+}
+
+// Universal wasm of an empty module with a data section of DataSize bytes at
+// address 0 in the AOT section. The data content is aligned to the page size
+// in the file if Aligned is set. The declared data size is TruncatedBy bytes
+// larger than the content left in the custom section.
+std::vector<uint8_t> makeUniversal(uint64_t DataSize, bool Aligned,
+                                   uint64_t TruncatedBy = 0) {
+  std::vector<uint8_t> Content;
+  writeName(Content, "wasmedge"sv);
+  // Binary version, OS type, and arch type.
+  writeLEB(Content, WasmEdge::AOT::kBinaryVersion);
+#if defined(__linux__)
+  Content.push_back(1);
+#elif defined(__APPLE__)
+  Content.push_back(2);
+#elif defined(_WIN32)
+  Content.push_back(3);
+#else
+  Content.push_back(0xFF);
+#endif
+#if defined(__x86_64__) || defined(_M_X64)
+  Content.push_back(1);
+#elif defined(__aarch64__)
+  Content.push_back(2);
+#else
+  Content.push_back(0xFF);
+#endif
+  // Version and intrinsics addresses, and no types and codes.
+  writeLEB(Content, 8);
+  writeLEB(Content, 0);
+  writeLEB(Content, 0);
+  writeLEB(Content, 0);
+  writeLEB(Content, 1);
+  Content.push_back(2);
+  writeLEB(Content, 0);
+  writeLEB(Content, DataSize + TruncatedBy);
+  writeLEB(Content, DataSize + TruncatedBy);
+  const uint64_t DataPos = Content.size();
+  for (uint64_t I = 0; I < DataSize; ++I) {
+    Content.push_back(contentByte(I));
+  }
+
+  std::vector<uint8_t> Out = {0x00, 0x61, 0x73, 0x6D, 0x01, 0x00, 0x00, 0x00};
+  std::vector<uint8_t> Header;
+  writeLEB(Header, Content.size());
+  const uint64_t PageSize = getPageSize();
+  const uint64_t Pos = Out.size() + 1 + Header.size() + DataPos;
+  // Pad by a custom section before the AOT section.
+  std::vector<uint8_t> Padding;
+  writeName(Padding, "wasmedge.padding"sv);
+  for (uint64_t Size = Padding.size();; ++Size) {
+    std::vector<uint8_t> SizeBytes;
+    writeLEB(SizeBytes, Size);
+    const bool IsAligned = (Pos + 1 + SizeBytes.size() + Size) % PageSize == 0;
+    if (IsAligned == Aligned) {
+      Padding.resize(Size, 0);
+      Out.push_back(0x00);
+      Out.insert(Out.end(), SizeBytes.begin(), SizeBytes.end());
+      Out.insert(Out.end(), Padding.begin(), Padding.end());
+      break;
+    }
+  }
+  Out.push_back(0x00);
+  Out.insert(Out.end(), Header.begin(), Header.end());
+  Out.insert(Out.end(), Content.begin(), Content.end());
+  return Out;
+}
+
+// The AOT section of a data section at Address, whose content is at
+// FileOffset in the file.
+WasmEdge::AST::AOTSection makeSection(uint64_t Address, uint64_t Size,
+                                      uint64_t FileOffset) {
+  WasmEdge::AST::AOTSection Sec;
+  Sec.setIntrinsicsAddress(0);
+  Sec.getSections().emplace_back(2, Address, Size,
+                                 std::vector<WasmEdge::Byte>());
+  Sec.getFileRanges().emplace_back(FileOffset, Size);
+  return Sec;
+}
+
+bool checkContent(const uint8_t *Data, uint64_t Size, uint64_t Begin = 0) {
+  for (uint64_t I = Begin; I < Size; ++I) {
+    if (Data[I] != contentByte(I)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+TEST(AOTSectionTest, LoadFromFile) {
+  const uint64_t PageSize = getPageSize();
+  // The content is at the file offset of PageSize + Address in both cases.
+  const uint64_t Address = 100;
+  const uint64_t Size = PageSize * 3 + 200;
+  std::vector<uint8_t> Bytes(PageSize + Address + Size + 1, 0);
+  for (uint64_t I = 0; I < Size; ++I) {
+    Bytes[PageSize + Address + I] = contentByte(I);
+  }
+  const auto Path = writeFile(Bytes);
+  WasmEdge::MMap File(Path);
+  ASSERT_NE(File.address(), nullptr);
+  ASSERT_EQ(File.size(), Bytes.size());
+
+  // 1. The content congruent to the address maps the whole pages, and copies
+  //    the partial pages at both ends.
+  {
+    auto Sec = std::make_shared<WasmEdge::Loader::AOTSection>();
+    ASSERT_TRUE(Sec->load(makeSection(Address, Size, PageSize + Address),
+                          &File));
+    const auto *Binary =
+        reinterpret_cast<const uint8_t *>(Sec->getIntrinsics().get());
+    EXPECT_TRUE(checkContent(Binary + Address, Size));
+  }
+
+  // 2. The content not congruent to the address fails to map, and is copied.
+  {
+    std::vector<uint8_t> Shifted(Bytes.begin() + 1, Bytes.end());
+    const auto ShiftedPath = writeFile(Shifted, "aot_section_shifted"sv);
+    WasmEdge::MMap ShiftedFile(ShiftedPath);
+    ASSERT_NE(ShiftedFile.address(), nullptr);
+    auto Sec = std::make_shared<WasmEdge::Loader::AOTSection>();
+    ASSERT_TRUE(Sec->load(makeSection(Address, Size, PageSize + Address - 1),
+                          &ShiftedFile));
+    const auto *Binary =
+        reinterpret_cast<const uint8_t *>(Sec->getIntrinsics().get());
+    EXPECT_TRUE(checkContent(Binary + Address, Size));
+    std::filesystem::remove(ShiftedPath);
+  }
+
+  // 3. The content out of the file is rejected before mapping or copying.
+  {
+    auto Sec = std::make_shared<WasmEdge::Loader::AOTSection>();
+    auto Res =
+        Sec->load(makeSection(Address, Size, PageSize + Address + 2), &File);
+    ASSERT_FALSE(Res);
+    EXPECT_EQ(Res.error(), WasmEdge::ErrCode::Value::IntegerTooLarge);
+    Sec = std::make_shared<WasmEdge::Loader::AOTSection>();
+    Res = Sec->load(makeSection(Address, Size, UINT64_MAX - 1), &File);
+    ASSERT_FALSE(Res);
+    EXPECT_EQ(Res.error(), WasmEdge::ErrCode::Value::IntegerTooLarge);
+  }
+  std::filesystem::remove(Path);
+}
+
+TEST(AOTSectionTest, ParseUniversal) {
+  // The intrinsics table pointer is stored at the address 0 when loading.
+  constexpr uint64_t kIntrinsicsSize = sizeof(void *);
+  const uint64_t DataSize = getPageSize() * 2 + 300;
+
+  // 1. The aligned content is left in the file, and mapped at loading.
+  {
+    const auto Path = writeFile(makeUniversal(DataSize, true));
+    auto Mod = Ldr.parseModule(Path);
+    ASSERT_TRUE(Mod);
+    ASSERT_TRUE((*Mod)->getSymbol());
+    const auto &Ranges = (*Mod)->getAOTSection().getFileRanges();
+    ASSERT_EQ(Ranges.size(), 1U);
+    EXPECT_EQ(Ranges[0].second, DataSize);
+    EXPECT_TRUE(checkContent(
+        reinterpret_cast<const uint8_t *>((*Mod)->getSymbol().get()),
+        DataSize, kIntrinsicsSize));
+    std::filesystem::remove(Path);
+  }
+
+  // 2. The unaligned content and the content in memory are copied.
+  {
+    const auto Wasm = makeUniversal(DataSize, false);
+    const auto Path = writeFile(Wasm);
+    auto Mod = Ldr.parseModule(Path);
+    ASSERT_TRUE(Mod);
+    ASSERT_TRUE((*Mod)->getSymbol());
+    EXPECT_EQ((*Mod)->getAOTSection().getFileRanges()[0].second, 0U);
+    EXPECT_TRUE(checkContent(
+        reinterpret_cast<const uint8_t *>((*Mod)->getSymbol().get()),
+        DataSize, kIntrinsicsSize));
+    std::filesystem::remove(Path);
+
+    Mod = Ldr.parseModule(makeUniversal(DataSize, true));
+    ASSERT_TRUE(Mod);
+    ASSERT_TRUE((*Mod)->getSymbol());
+    EXPECT_TRUE(checkContent(
+        reinterpret_cast<const uint8_t *>((*Mod)->getSymbol().get()),
+        DataSize, kIntrinsicsSize));
+  }
+
+  // 3. The truncated section is never mapped or read past the end, and the
+  //    module falls back to the interpreter mode.
+  for (const bool Aligned : {true, false}) {
+    const auto Path = writeFile(makeUniversal(DataSize, Aligned, 1));
+    auto Mod = Ldr.parseModule(Path);
+    ASSERT_TRUE(Mod);
+    EXPECT_FALSE((*Mod)->getSymbol());
+    std::filesystem::remove(Path);
+  }
+}
+
+} // namespace
@@ -392,6 +392,75 @@ TEST(InstructionTest, LoadBrTableControlInstruction) {
   EXPECT_FALSE(Ldr.parseModule(prefixedVec(Vec)));
 }
 
+TEST(InstructionTest, LoadImmediatesInSideBuffer) {
+  // 5. Test the variable-length immediates in the side buffer of expression.
+  //
+  //   1.  The label list and the catch clauses are loaded into the buffer.
+  //   2.  The copied expression keeps them after the module is released.
+
+  WasmEdge::Configure ConfEH;
+  ConfEH.addProposal(WasmEdge::Proposal::ExceptionHandling);
+  WasmEdge::Loader::Loader LdrEH(ConfEH);
+  std::vector<uint8_t> Vec = {
+      0x0AU,                   // Code section
+      0x1EU,                   // Content size = 30
+      0x01U,                   // Vector length = 1
+      0x1CU,                   // Code segment size = 28
+      0x00U,                   // Local vec(0)
+      0x02U, 0x40U,            // Block
+      0x06U, 0x40U,            // Try
+      0x07U, 0x00U,            // Catch tag 0
+      0x19U,                   // Catch_all
+      0x0BU,                   // End of Try
+      0x1FU, 0x40U, 0x02U,     // Try_table with 2 catches
+      0x00U, 0x00U, 0x00U,     // Catch tag 0 to label 0
+      0x02U, 0x01U,            // Catch_all to label 1
+      0x0BU,                   // End of Try_table
+      0x41U, 0x00U,            // I32.const 0
+      0x0EU, 0x03U,            // Br_table with 3 labels
+      0x00U, 0x01U, 0x00U,     // Labels
+      0x01U,                   // Default label
+      0x0BU,                   // End of Block
+      0x0BU                    // Expression End.
+  };
+
+  WasmEdge::AST::Expression Expr;
+  {
+    auto Mod = LdrEH.parseModule(prefixedVec(Vec));
+    ASSERT_TRUE(Mod);
+    const auto &Segs = (*Mod)->getCodeSection().getContent();
+    ASSERT_EQ(Segs.size(), 1U);
+    Expr = Segs[0].getExpr();
+    EXPECT_GT(Expr.getImmediates().size(), 0U);
+  }
+
+  const auto &Instrs = Expr.getInstrs();
+  ASSERT_EQ(Instrs.size(), 11U);
+  ASSERT_EQ(Instrs[1].getOpCode(), WasmEdge::OpCode::Try);
+  const auto Legacy = Instrs[1].getTryCatch().Catch;
+  ASSERT_EQ(Legacy.size(), 2U);
+  EXPECT_TRUE(Legacy[0].IsLegacy);
+  EXPECT_FALSE(Legacy[0].IsAll);
+  EXPECT_TRUE(Legacy[1].IsAll);
+  EXPECT_EQ(Instrs[1].getTryCatch().JumpEnd, 3U);
+
+  ASSERT_EQ(Instrs[5].getOpCode(), WasmEdge::OpCode::Try_table);
+  const auto Catch = Instrs[5].getTryCatch().Catch;
+  ASSERT_EQ(Catch.size(), 2U);
+  EXPECT_FALSE(Catch[0].IsAll);
+  EXPECT_EQ(Catch[0].LabelIndex, 0U);
+  EXPECT_TRUE(Catch[1].IsAll);
+  EXPECT_EQ(Catch[1].LabelIndex, 1U);
+
+  ASSERT_EQ(Instrs[8].getOpCode(), WasmEdge::OpCode::Br_table);
+  const auto Labels = Instrs[8].getLabelList();
+  ASSERT_EQ(Labels.size(), 4U);
+  EXPECT_EQ(Labels[0].TargetIndex, 0U);
+  EXPECT_EQ(Labels[1].TargetIndex, 1U);
+  EXPECT_EQ(Labels[2].TargetIndex, 0U);
+  EXPECT_EQ(Labels[3].TargetIndex, 1U);
+}
+
 TEST(InstructionTest, LoadCallControlInstruction) {
   std::vector<uint8_t> Vec;
 
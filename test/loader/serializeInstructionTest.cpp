@@ -256,8 +256,9 @@ TEST(SerializeInstructionTest, SerializeBrTableControlInstruction) {
 
   WasmEdge::AST::Instruction BrTable(WasmEdge::OpCode::Br_table);
   WasmEdge::AST::Instruction End(WasmEdge::OpCode::End);
+  WasmEdge::AST::ImmediateBuffer Buffer;
 
-  BrTable.setLabelListSize(1);
+  BrTable.setLabelListSize(1, Buffer);
   BrTable.getLabelList()[0].TargetIndex = 0xFFFFFFFFU;
   Instructions = {BrTable, End};
   Output = {};
@@ -275,7 +276,7 @@ TEST(SerializeInstructionTest, SerializeBrTableControlInstruction) {
   };
   EXPECT_EQ(Output, Expected);
 
-  BrTable.setLabelListSize(4);
+  BrTable.setLabelListSize(4, Buffer);
   BrTable.getLabelList()[0].TargetIndex = 0xFFFFFFF1U;
   BrTable.getLabelList()[1].TargetIndex = 0xFFFFFFF2U;
   BrTable.getLabelList()[2].TargetIndex = 0xFFFFFFF3U;
@@ -413,8 +414,9 @@ TEST(SerializeInstructionTest, SerializeParametricInstruction) {
 
   WasmEdge::AST::Instruction SelectT(WasmEdge::OpCode::Select_t);
   WasmEdge::AST::Instruction End(WasmEdge::OpCode::End);
+  WasmEdge::AST::ImmediateBuffer Buffer;
 
-  SelectT.setValTypeListSize(2);
+  SelectT.setValTypeListSize(2, Buffer);
   SelectT.getValTypeList()[0] = WasmEdge::TypeCode::I32;
   SelectT.getValTypeList()[1] = WasmEdge::TypeCode::I64;
   Instructions = {SelectT, End};
@@ -241,6 +241,56 @@ TEST(serializeTypeTest, SerializeMemoryType) {
   EXPECT_EQ(Output, Expected);
 }
 
+TEST(serializeTypeTest, SerializeMemory64Type) {
+  std::vector<uint8_t> Expected;
+  std::vector<uint8_t> Output;
+
+  // 4. Test serialize 64-bit memory type of the memory64 proposal.
+  //
+  //   1.  Serialize limit with only min over 32 bits.
+  //   2.  Serialize limit with min and max of the page limit.
+  //   3.  Serialize 64-bit limit without the proposal.
+
+  WasmEdge::Configure Conf64;
+  Conf64.addProposal(WasmEdge::Proposal::Memory64);
+  WasmEdge::Loader::Serializer Ser64(Conf64);
+  WasmEdge::AST::MemoryType MemoryType;
+
+  MemoryType.getLimit().setMin(UINT64_C(4294967296));
+  MemoryType.getLimit().setType(WasmEdge::AST::Limit::LimitType::I64HasMin);
+
+  Output = {};
+  EXPECT_TRUE(Ser64.serializeSection(createMemorySec(MemoryType), Output));
+  Expected = {
+      0x05U,                            // Memory section
+      0x07U,                            // Content size = 7
+      0x01U,                            // Vector length = 1
+      0x04U,                            // 64-bit, only has min
+      0x80U, 0x80U, 0x80U, 0x80U, 0x10U // Min = 4294967296
+  };
+  EXPECT_EQ(Output, Expected);
+
+  MemoryType.getLimit().setMin(1);
+  MemoryType.getLimit().setMax(UINT64_C(1) << 48);
+  MemoryType.getLimit().setType(
+      WasmEdge::AST::Limit::LimitType::I64HasMinMax);
+
+  Output = {};
+  EXPECT_TRUE(Ser64.serializeSection(createMemorySec(MemoryType), Output));
+  Expected = {
+      0x05U,               // Memory section
+      0x0AU,               // Content size = 10
+      0x01U,               // Vector length = 1
+      0x05U,               // 64-bit, has min and max
+      0x01U,               // Min = 1
+      0x80U, 0x80U, 0x80U, // Max = 281474976710656
+      0x80U, 0x80U, 0x80U, 0x40U};
+  EXPECT_EQ(Output, Expected);
+
+  Output = {};
+  EXPECT_FALSE(Ser.serializeSection(createMemorySec(MemoryType), Output));
+}
+
 TEST(serializeTypeTest, SerializeGlobalType) {
   WasmEdge::Configure ConfNoRefType;
   ConfNoRefType.removeProposal(WasmEdge::Proposal::BulkMemoryOperations);
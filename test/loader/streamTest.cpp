@@ -0,0 +1,224 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+//===-- wasmedge/test/loader/streamTest.cpp - Streaming loader unit tests -===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of loading AST module node from the chunks of
+/// the binary.
+///
+//===----------------------------------------------------------------------===//
+
+#include "loader/loader.h"
+#include "loader/stream.h"
+#include "validator/validator.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <utility>
+#include <vector>
+
+namespace {
+
+WasmEdge::Configure Conf;
+WasmEdge::Loader::Loader Ldr(Conf);
+
+const std::vector<uint8_t> Wasm = {
+    0x00U, 0x61U, 0x73U, 0x6DU, // Magic
+    0x01U, 0x00U, 0x00U, 0x00U, // Version
+    // Type section: (i32) -> (i32)
+    0x01U, 0x06U, 0x01U, 0x60U, 0x01U, 0x7FU, 0x01U, 0x7FU,
+    // Function section: 3 functions
+    0x03U, 0x04U, 0x03U, 0x00U, 0x00U, 0x00U,
+    // Export section: "f"
+    0x07U, 0x05U, 0x01U, 0x01U, 0x66U, 0x00U, 0x00U,
+    // Code section: 3 function bodies
+    0x0AU, 0x15U, 0x03U,
+    // local.get 0, i32.const 1, i32.add
+    0x07U, 0x00U, 0x20U, 0x00U, 0x41U, 0x01U, 0x6AU, 0x0BU,
+    // 2 i32 locals, local.get 0
+    0x06U, 0x01U, 0x02U, 0x7FU, 0x20U, 0x00U, 0x0BU,
+    // local.get 0
+    0x04U, 0x00U, 0x20U, 0x00U, 0x0BU,
+    // Custom section: "x"
+    0x00U, 0x04U, 0x01U, 0x78U, 0x61U, 0x62U};
+
+// Load the binary with the chunks of the size, and serialize the module.
+WasmEdge::Expect<std::vector<uint8_t>>
+loadStream(const std::vector<uint8_t> &Vec, size_t ChunkSize) {
+  WasmEdge::Loader::StreamLoader Stream(Conf);
+  for (size_t I = 0; I < Vec.size(); I += ChunkSize) {
+    const size_t Size = std::min(ChunkSize, Vec.size() - I);
+    if (auto Res = Stream.feed(WasmEdge::Span<const uint8_t>(&Vec[I], Size));
+        !Res) {
+      return WasmEdge::Unexpect(Res);
+    }
+  }
+  auto Mod = Stream.finish();
+  if (!Mod) {
+    return WasmEdge::Unexpect(Mod);
+  }
+  return Ldr.serializeModule(**Mod);
+}
+
+// Load the whole binary, and serialize the module.
+WasmEdge::Expect<std::vector<uint8_t>>
+loadWhole(const std::vector<uint8_t> &Vec) {
+  auto Mod = Ldr.parseModule(Vec);
+  if (!Mod) {
+    return WasmEdge::Unexpect(Mod);
+  }
+  return Ldr.serializeModule(**Mod);
+}
+
+const std::vector<uint8_t> DataWasm = {
+    0x00U, 0x61U, 0x73U, 0x6DU, // Magic
+    0x01U, 0x00U, 0x00U, 0x00U, // Version
+    // Type section: (i32) -> (i32)
+    0x01U, 0x06U, 0x01U, 0x60U, 0x01U, 0x7FU, 0x01U, 0x7FU,
+    // Function section: 3 functions
+    0x03U, 0x04U, 0x03U, 0x00U, 0x00U, 0x00U,
+    // Memory section: 1 memory
+    0x05U, 0x03U, 0x01U, 0x00U, 0x01U,
+    // Data count section: 1 data segment
+    0x0CU, 0x01U, 0x01U,
+    // Code section: 3 function bodies
+    0x0AU, 0x16U, 0x03U,
+    // local.get 0, i32.const 1, i32.add
+    0x07U, 0x00U, 0x20U, 0x00U, 0x41U, 0x01U, 0x6AU, 0x0BU,
+    // data.drop 0, local.get 0
+    0x07U, 0x00U, 0xFCU, 0x09U, 0x00U, 0x20U, 0x00U, 0x0BU,
+    // local.get 0
+    0x04U, 0x00U, 0x20U, 0x00U, 0x0BU,
+    // Data section: 1 passive data segment "a"
+    0x0BU, 0x04U, 0x01U, 0x01U, 0x01U, 0x61U};
+
+// Load the binary with the chunks of the size, and validate the function
+// bodies while loading. Get the indices of the validated bodies.
+std::pair<std::vector<uint32_t>, WasmEdge::Expect<void>>
+validateStream(const std::vector<uint8_t> &Vec, size_t ChunkSize) {
+  WasmEdge::Validator::Validator Valid(Conf);
+  WasmEdge::Loader::StreamLoader Stream(Conf);
+  std::vector<uint32_t> Validated;
+  Stream.setCodeSegmentCallback(
+      [&](const WasmEdge::AST::Module &Mod, uint32_t Idx) {
+        if (Valid.validateCodeSegment(Mod, Idx)) {
+          Validated.push_back(Idx);
+        }
+      });
+  for (size_t I = 0; I < Vec.size(); I += ChunkSize) {
+    const size_t Size = std::min(ChunkSize, Vec.size() - I);
+    EXPECT_TRUE(Stream.feed(WasmEdge::Span<const uint8_t>(&Vec[I], Size)));
+  }
+  auto Mod = Stream.finish();
+  if (!Mod) {
+    return {Validated, WasmEdge::Unexpect(Mod)};
+  }
+  // Only the bodies validated while loading are marked.
+  const auto &CodeSegs = (*Mod)->getCodeSection().getContent();
+  for (uint32_t I = 0; I < CodeSegs.size(); ++I) {
+    EXPECT_EQ(CodeSegs[I].getIsValidated(),
+              std::count(Validated.begin(), Validated.end(), I) == 1);
+  }
+  return {Validated, Valid.validate(**Mod)};
+}
+
+TEST(StreamTest, LoadModule) {
+  auto Expected = loadWhole(Wasm);
+  ASSERT_TRUE(Expected);
+
+  // 1. Test load module with the chunks of various sizes
+  for (size_t ChunkSize = 1; ChunkSize <= Wasm.size(); ++ChunkSize) {
+    auto Res = loadStream(Wasm, ChunkSize);
+    ASSERT_TRUE(Res);
+    EXPECT_EQ(*Res, *Expected);
+  }
+
+  // 2. Test load module without feeding
+  WasmEdge::Loader::StreamLoader Empty(Conf);
+  EXPECT_FALSE(Empty.finish());
+
+  // 3. Test feed and finish after finished
+  WasmEdge::Loader::StreamLoader Stream(Conf);
+  EXPECT_TRUE(Stream.feed(Wasm));
+  EXPECT_TRUE(Stream.finish());
+  EXPECT_TRUE(Stream.feed(Wasm).error() ==
+              WasmEdge::ErrCode::Value::WrongVMWorkflow);
+  EXPECT_TRUE(Stream.finish().error() ==
+              WasmEdge::ErrCode::Value::WrongVMWorkflow);
+}
+
+TEST(StreamTest, LoadTruncatedModule) {
+  // The truncated binary at the section boundary is a valid module.
+  for (size_t Size = 0; Size < Wasm.size(); ++Size) {
+    const std::vector<uint8_t> Vec(Wasm.begin(), Wasm.begin() + Size);
+    auto Expected = loadWhole(Vec);
+    for (const size_t ChunkSize : {size_t(1), size_t(5), Vec.size() + 1}) {
+      auto Res = loadStream(Vec, ChunkSize);
+      ASSERT_EQ(static_cast<bool>(Res), static_cast<bool>(Expected));
+      if (Res) {
+        EXPECT_EQ(*Res, *Expected);
+      } else {
+        EXPECT_EQ(Res.error(), Expected.error());
+      }
+    }
+  }
+}
+
+TEST(StreamTest, LoadMalformedModule) {
+  // Change every byte of the binary.
+  for (size_t I = 8; I < Wasm.size(); ++I) {
+    std::vector<uint8_t> Vec = Wasm;
+    Vec[I] = 0xFFU;
+    auto Expected = loadWhole(Vec);
+    for (const size_t ChunkSize : {size_t(1), size_t(5), Vec.size()}) {
+      auto Res = loadStream(Vec, ChunkSize);
+      ASSERT_EQ(static_cast<bool>(Res), static_cast<bool>(Expected));
+      if (!Res) {
+        EXPECT_EQ(Res.error(), Expected.error());
+      }
+    }
+  }
+}
+
+TEST(StreamTest, ValidateModule) {
+  // 1. Test validate the function bodies while loading the valid module
+  for (size_t ChunkSize = 1; ChunkSize <= DataWasm.size(); ++ChunkSize) {
+    auto [Validated, Res] = validateStream(DataWasm, ChunkSize);
+    EXPECT_TRUE(Res);
+    // The code section in a single chunk is loaded as a whole.
+    if (ChunkSize == 1) {
+      EXPECT_EQ(Validated, std::vector<uint32_t>({0U, 1U, 2U}));
+    }
+  }
+
+  // 2. Test validate the invalid function body while loading
+  std::vector<uint8_t> Vec = DataWasm;
+  // Replace the local.get 0 of the second body with 2 nops.
+  Vec[46] = 0x01U;
+  Vec[47] = 0x01U;
+  WasmEdge::Validator::Validator Valid(Conf);
+  auto Mod = Ldr.parseModule(Vec);
+  ASSERT_TRUE(Mod);
+  auto Expected = Valid.validate(**Mod);
+  ASSERT_FALSE(Expected);
+  for (const size_t ChunkSize : {size_t(1), size_t(5), Vec.size()}) {
+    auto [Validated, Res] = validateStream(Vec, ChunkSize);
+    ASSERT_FALSE(Res);
+    EXPECT_EQ(Res.error(), Expected.error());
+    if (ChunkSize == 1) {
+      EXPECT_EQ(Validated, std::vector<uint32_t>({0U}));
+    }
+  }
+
+  // 3. Test validate the function bodies out of order
+  EXPECT_TRUE(Valid.validateCodeSegment(**Mod, 1).error() ==
+              WasmEdge::ErrCode::Value::WrongVMWorkflow);
+}
+
+} // namespace
@@ -390,6 +390,59 @@ TEST(TypeTest, LoadMemoryType) {
   EXPECT_TRUE(Ldr.parseModule(prefixedVec(Vec)));
 }
 
+TEST(TypeTest, LoadMemory64Type) {
+  std::vector<uint8_t> Vec;
+
+  // 3. Test load 64-bit memory type of the memory64 proposal.
+  //
+  //   1.  Load limit with only min over 32 bits.
+  //   2.  Load limit with min and max of the page limit.
+  //   3.  Load invalid limit of 64-bit min without the proposal.
+
+  WasmEdge::Configure Conf64;
+  Conf64.addProposal(WasmEdge::Proposal::Memory64);
+  WasmEdge::Loader::Loader Ldr64(Conf64);
+
+  Vec = {
+      0x05U,                            // Memory section
+      0x07U,                            // Content size = 7
+      0x01U,                            // Vector length = 1
+      0x04U,                            // 64-bit, only has min
+      0x80U, 0x80U, 0x80U, 0x80U, 0x10U // Min = 4294967296
+  };
+  auto Mod = Ldr64.parseModule(prefixedVec(Vec));
+  ASSERT_TRUE(Mod);
+  const auto &Lim1 = (*Mod)->getMemorySection().getContent()[0].getLimit();
+  EXPECT_TRUE(Lim1.is64());
+  EXPECT_FALSE(Lim1.hasMax());
+  EXPECT_EQ(Lim1.getMin(), UINT64_C(4294967296));
+
+  Vec = {
+      0x05U,               // Memory section
+      0x0AU,               // Content size = 10
+      0x01U,               // Vector length = 1
+      0x05U,               // 64-bit, has min and max
+      0x01U,               // Min = 1
+      0x80U, 0x80U, 0x80U, // Max = 281474976710656
+      0x80U, 0x80U, 0x80U, 0x40U};
+  Mod = Ldr64.parseModule(prefixedVec(Vec));
+  ASSERT_TRUE(Mod);
+  const auto &Lim2 = (*Mod)->getMemorySection().getContent()[0].getLimit();
+  EXPECT_TRUE(Lim2.is64());
+  EXPECT_TRUE(Lim2.hasMax());
+  EXPECT_EQ(Lim2.getMin(), UINT64_C(1));
+  EXPECT_EQ(Lim2.getMax(), UINT64_C(1) << 48);
+
+  Vec = {
+      0x05U,                            // Memory section
+      0x07U,                            // Content size = 7
+      0x01U,                            // Vector length = 1
+      0x04U,                            // 64-bit, only has min
+      0x80U, 0x80U, 0x80U, 0x80U, 0x10U // Min = 4294967296
+  };
+  EXPECT_FALSE(Ldr.parseModule(prefixedVec(Vec)));
+}
+
 TEST(TypeTest, LoadGlobalType) {
   std::vector<uint8_t> Vec;
 
@@ -0,0 +1,142 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2022 Second State INC
+
+#include "common/configure.h"
+#include "runtime/instance/memory.h"
+#include "system/allocator.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <memory>
+
+namespace {
+
+using WasmEdge::Allocator;
+
+// The pool is shared in the process and reserved once, so all the tests in
+// this executable use the same slots and release what they allocate.
+constexpr uint32_t kSlotCount = 2;
+constexpr uint64_t kPageSize = UINT64_C(65536);
+constexpr uint64_t kSlotSize = UINT64_C(0x300000000);
+
+TEST(MemPoolTest, Reserve) {
+  if (!Allocator::reservePool(kSlotCount)) {
+    GTEST_SKIP() << "memory pool is not supported";
+  }
+  // The later reservations keep the first pool, and fail if it is smaller
+  // than requested.
+  EXPECT_TRUE(Allocator::reservePool(kSlotCount));
+  EXPECT_TRUE(Allocator::reservePool(kSlotCount - 1));
+  EXPECT_FALSE(Allocator::reservePool(kSlotCount * 4));
+  EXPECT_FALSE(Allocator::reservePool(0));
+}
+
+TEST(MemPoolTest, SlotReuse) {
+  if (!Allocator::reservePool(kSlotCount)) {
+    GTEST_SKIP() << "memory pool is not supported";
+  }
+  uint8_t *Ptr1 = Allocator::allocate(1);
+  ASSERT_NE(Ptr1, nullptr);
+  Ptr1[0] = 0x01;
+  Ptr1[kPageSize - 1] = 0x02;
+  Allocator::release(Ptr1, 1);
+
+  // The released slot is handed out again with the pages discarded.
+  uint8_t *Ptr2 = Allocator::allocate(1);
+  ASSERT_EQ(Ptr2, Ptr1);
+  EXPECT_EQ(Ptr2[0], 0x00);
+  EXPECT_EQ(Ptr2[kPageSize - 1], 0x00);
+
+  // The grown pages are discarded as well.
+  ASSERT_EQ(Allocator::resize(Ptr2, 1, 3), Ptr2);
+  std::fill_n(Ptr2, 3 * kPageSize, UINT8_C(0xFF));
+  Allocator::release(Ptr2, 3);
+  uint8_t *Ptr3 = Allocator::allocate(3);
+  ASSERT_EQ(Ptr3, Ptr1);
+  EXPECT_TRUE(std::all_of(Ptr3, Ptr3 + 3 * kPageSize,
+                          [](uint8_t B) { return B == 0; }));
+  Allocator::release(Ptr3, 3);
+}
+
+TEST(MemPoolTest, SnapshotReuse) {
+  if (!Allocator::reservePool(kSlotCount)) {
+    GTEST_SKIP() << "memory pool is not supported";
+  }
+  uint8_t *Ptr1 = Allocator::allocate(2);
+  ASSERT_NE(Ptr1, nullptr);
+  Ptr1[0] = 0x01;
+  Allocator::Snapshot Image;
+  ASSERT_TRUE(Image.capture(Ptr1, 2));
+  Ptr1[0] = 0x02;
+  Ptr1[kPageSize] = 0x03;
+  ASSERT_EQ(Image.restore(Ptr1, 2), Ptr1);
+  EXPECT_EQ(Ptr1[0], 0x01);
+  EXPECT_EQ(Ptr1[kPageSize], 0x00);
+  Allocator::release(Ptr1, 2);
+
+  // The slot holding the restored image is handed out with the zeroed pages.
+  uint8_t *Ptr2 = Allocator::allocate(2);
+  ASSERT_EQ(Ptr2, Ptr1);
+  EXPECT_TRUE(std::all_of(Ptr2, Ptr2 + 2 * kPageSize,
+                          [](uint8_t B) { return B == 0; }));
+  ASSERT_EQ(Allocator::resize(Ptr2, 2, 3), Ptr2);
+  EXPECT_EQ(Ptr2[3 * kPageSize - 1], 0x00);
+  Allocator::release(Ptr2, 3);
+}
+
+TEST(MemPoolTest, Exhaustion) {
+  if (!Allocator::reservePool(kSlotCount)) {
+    GTEST_SKIP() << "memory pool is not supported";
+  }
+  uint8_t *Ptr1 = Allocator::allocate(1);
+  uint8_t *Ptr2 = Allocator::allocate(1);
+  ASSERT_NE(Ptr1, nullptr);
+  ASSERT_NE(Ptr2, nullptr);
+  // The slots are adjacent in the pool.
+  EXPECT_EQ(static_cast<uint64_t>(std::max(Ptr1, Ptr2) - std::min(Ptr1, Ptr2)),
+            kSlotSize);
+
+  // The exhausted pool falls back to the individual reservation.
+  uint8_t *Ptr3 = Allocator::allocate(1);
+  ASSERT_NE(Ptr3, nullptr);
+  EXPECT_NE(Ptr3, Ptr1);
+  EXPECT_NE(Ptr3, Ptr2);
+  Ptr3[kPageSize - 1] = 0x01;
+  EXPECT_EQ(Ptr3[0], 0x00);
+  Allocator::release(Ptr3, 1);
+
+  // The slots are available again after released.
+  Allocator::release(Ptr1, 1);
+  uint8_t *Ptr4 = Allocator::allocate(0);
+  EXPECT_EQ(Ptr4, Ptr1);
+  Allocator::release(Ptr4, 0);
+  Allocator::release(Ptr2, 1);
+}
+
+TEST(MemPoolTest, MemoryInstance) {
+  using MemInst = WasmEdge::Runtime::Instance::MemoryInstance;
+  if (!Allocator::reservePool(kSlotCount)) {
+    GTEST_SKIP() << "memory pool is not supported";
+  }
+  auto Inst1 = std::make_unique<MemInst>(WasmEdge::AST::MemoryType(1));
+  uint8_t *Ptr = Inst1->getDataPtr();
+  ASSERT_NE(Ptr, nullptr);
+  ASSERT_TRUE(Inst1->growPage(1));
+  Ptr[2 * kPageSize - 1] = 0x01;
+  Inst1.reset();
+
+  // A new instance takes the slot of the destroyed one, and starts from the
+  // zeroed pages with the guard of the released pages restored.
+  auto Inst2 = std::make_unique<MemInst>(WasmEdge::AST::MemoryType(2));
+  ASSERT_EQ(Inst2->getDataPtr(), Ptr);
+  EXPECT_EQ(Ptr[2 * kPageSize - 1], 0x00);
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  WasmEdge::Log::setErrorLoggingLevel();
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -256,10 +256,11 @@ static const TestsuiteProposal TestsuiteProposals[] = {
     {"multi-memory"sv, {Proposal::MultiMemories}},
     {"tail-call"sv, {Proposal::TailCall}},
     {"extended-const"sv, {Proposal::ExtendedConst}},
+    {"memory64"sv, {Proposal::Memory64}},
     {"threads"sv, {Proposal::Threads}},
     {"function-references"sv,
      {Proposal::FunctionReferences, Proposal::TailCall}},
-    {"gc"sv, {Proposal::GC}, WasmEdge::SpecTest::TestMode::Interpreter},
+    {"gc"sv, {Proposal::GC}},
     {"exception-handling"sv,
      {Proposal::ExceptionHandling, Proposal::TailCall},
      WasmEdge::SpecTest::TestMode::Interpreter},
@@ -13,6 +13,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "common/spdlog.h"
+#include "system/parkinglot.h"
 #include "vm/vm.h"
 
 #ifdef WASMEDGE_USE_LLVM
@@ -22,9 +23,11 @@
 
 #include "gtest/gtest.h"
 
+#include <atomic>
 #include <fstream>
 #include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace {
@@ -226,6 +229,167 @@ TEST(AsyncExecute, GasThreadTest) {
   }
 }
 
+TEST(AsyncExecute, PoolBatchTest) {
+  WasmEdge::Configure Conf;
+  Conf.getRuntimeConfigure().setAsyncThreads(2);
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(MersenneTwister19937));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  {
+    const std::array<WasmEdge::ValType, 3> ParamTypes{
+        WasmEdge::ValType(WasmEdge::TypeCode::I32),
+        WasmEdge::ValType(WasmEdge::TypeCode::I64),
+        WasmEdge::ValType(WasmEdge::TypeCode::I64)};
+    std::array<std::array<WasmEdge::ValVariant, 3>, 4> Params;
+    std::array<WasmEdge::VM::VM::AsyncInvocation, 4> Invocations;
+    for (uint64_t Index = 0; Index < Answers.size(); ++Index) {
+      Params[Index] = {UINT32_C(2504) * Index, UINT64_C(5489),
+                       UINT64_C(100000) + Index};
+      Invocations[Index] = {"mt19937", Params[Index], ParamTypes};
+    }
+    auto AsyncResults = VM.asyncExecuteBatch(Invocations);
+    ASSERT_EQ(AsyncResults.size(), Answers.size());
+    for (uint64_t Index = 0; Index < Answers.size(); ++Index) {
+      auto Result = AsyncResults[Index].get();
+      ASSERT_TRUE(Result);
+      ASSERT_EQ((*Result)[0].second.getCode(), WasmEdge::TypeCode::I64);
+      EXPECT_EQ((*Result)[0].first.get<uint64_t>(), Answers[Index]);
+    }
+  }
+}
+
+TEST(AsyncExecute, PoolDestroyTest) {
+  // (func (export "spin") (loop (br 0)))
+  const std::array<WasmEdge::Byte, 39> Spin{
+      0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x04, 0x01,
+      0x60, 0x00, 0x00, 0x03, 0x02, 0x01, 0x00, 0x07, 0x08, 0x01, 0x04,
+      0x73, 0x70, 0x69, 0x6e, 0x00, 0x00, 0x0a, 0x09, 0x01, 0x07, 0x00,
+      0x03, 0x40, 0x0c, 0x00, 0x0b, 0x0b};
+  WasmEdge::Configure Conf;
+  Conf.getRuntimeConfigure().setAsyncThreads(2);
+  auto VM = std::make_unique<WasmEdge::VM::VM>(Conf);
+  ASSERT_TRUE(VM->loadWasm(Spin));
+  ASSERT_TRUE(VM->validate());
+  ASSERT_TRUE(VM->instantiate());
+  std::array<WasmEdge::Async<WasmEdge::Expect<std::vector<
+                 std::pair<WasmEdge::ValVariant, WasmEdge::ValType>>>>,
+             3>
+      AsyncResults;
+  for (auto &Result : AsyncResults) {
+    Result = VM->asyncExecute("spin");
+  }
+  std::this_thread::sleep_for(10ms);
+  // Destroying the VM interrupts the running and the queued invocations.
+  VM.reset();
+  for (auto &Result : AsyncResults) {
+    auto Res = Result.get();
+    ASSERT_FALSE(Res);
+    EXPECT_EQ(Res.error(), WasmEdge::ErrCode::Value::Interrupted);
+  }
+}
+
+TEST(AsyncExecute, PoolCancelTest) {
+  // (func (export "spin") (loop (br 0)))
+  const std::array<WasmEdge::Byte, 39> Spin{
+      0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x04, 0x01,
+      0x60, 0x00, 0x00, 0x03, 0x02, 0x01, 0x00, 0x07, 0x08, 0x01, 0x04,
+      0x73, 0x70, 0x69, 0x6e, 0x00, 0x00, 0x0a, 0x09, 0x01, 0x07, 0x00,
+      0x03, 0x40, 0x0c, 0x00, 0x0b, 0x0b};
+  WasmEdge::Configure Conf;
+  Conf.getRuntimeConfigure().setAsyncThreads(2);
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(Spin));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  auto First = VM.asyncExecute("spin");
+  auto Second = VM.asyncExecute("spin");
+  EXPECT_FALSE(First.waitFor(10ms));
+
+  // Cancelling one invocation keeps the other running.
+  First.cancel();
+  auto Res = First.get();
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), WasmEdge::ErrCode::Value::Interrupted);
+  EXPECT_FALSE(Second.waitFor(20ms));
+  Second.cancel();
+  Res = Second.get();
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), WasmEdge::ErrCode::Value::Interrupted);
+}
+
+TEST(ThreadPool, NestedWaitTest) {
+  // The task waits for another task submitted to the same pool of one
+  // worker, which is run in place while waiting.
+  struct Nested {
+    struct StopScope {
+      StopScope(Nested &, std::atomic_uint32_t &) noexcept {}
+    };
+    void stop(std::atomic_uint32_t &) noexcept {}
+    uint32_t inner(uint32_t Value) { return Value + 1; }
+    uint32_t outer(uint32_t Value) {
+      WasmEdge::ThreadPool::Task Task;
+      WasmEdge::Async<uint32_t> Result(Task, &Nested::inner, *this, Value);
+      Pool->submit(std::move(Task));
+      return Result.get() * 2;
+    }
+    WasmEdge::ThreadPool *Pool;
+  };
+  WasmEdge::ThreadPool Pool(1);
+  Nested Inst{&Pool};
+  WasmEdge::ThreadPool::Task Task;
+  WasmEdge::Async<uint32_t> Result(Task, &Nested::outer, Inst, UINT32_C(20));
+  Pool.submit(std::move(Task));
+  ASSERT_TRUE(Result.waitFor(10s));
+  EXPECT_EQ(Result.get(), 42U);
+}
+
+TEST(ParkingLot, UnparkCount) {
+  WasmEdge::ParkingLot Lot;
+  std::array<uint32_t, 2> Keys = {0, 0};
+  std::atomic<uint32_t> Parked = 0;
+  std::vector<std::thread> Threads;
+  // 1. Park 4 threads on the first key and 1 thread on the second key.
+  for (uint32_t I = 0; I < 5; ++I) {
+    Threads.emplace_back([&, I]() {
+      auto Res = Lot.park(
+          &Keys[I / 4],
+          [&]() noexcept {
+            Parked.fetch_add(1);
+            return true;
+          },
+          std::nullopt);
+      EXPECT_EQ(Res, WasmEdge::ParkingLot::ParkResult::Unparked);
+    });
+  }
+  while (Parked.load() != 5) {
+    std::this_thread::yield();
+  }
+  // 2. Unpark the keys with the counts.
+  EXPECT_EQ(Lot.unpark(&Keys[0], 3), 3U);
+  EXPECT_EQ(Lot.unpark(&Keys[0], 3), 1U);
+  EXPECT_EQ(Lot.unpark(&Keys[0], 3), 0U);
+  EXPECT_EQ(Lot.unpark(&Keys[1], 0), 0U);
+  Lot.unparkAll();
+  for (auto &Thread : Threads) {
+    Thread.join();
+  }
+}
+
+TEST(ParkingLot, ValidateAndTimeout) {
+  WasmEdge::ParkingLot Lot;
+  uint32_t Key = 0;
+  EXPECT_EQ(Lot.park(
+                &Key, []() noexcept { return false; }, std::nullopt),
+            WasmEdge::ParkingLot::ParkResult::Invalid);
+  EXPECT_EQ(Lot.park(
+                &Key, []() noexcept { return true; },
+                WasmEdge::ParkingLot::Clock::now() + 10ms),
+            WasmEdge::ParkingLot::ParkResult::TimedOut);
+  // The timed out thread is not parked anymore.
+  EXPECT_EQ(Lot.unpark(&Key, 1), 0U);
+}
+
 #ifdef WASMEDGE_USE_LLVM
 
 TEST(AOTAsyncExecute, ThreadTest) {